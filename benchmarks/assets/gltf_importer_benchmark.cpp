@@ -0,0 +1,239 @@
+#include "mksv/assets/gltf_importer.hpp"
+
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#elif defined( __GLIBC__ )
+#include <malloc.h>
+#endif
+
+namespace mksv
+{
+namespace
+{
+// Sponza has about 262k triangles in 103 meshes, 100 grids of 36 x 36 quads come close with 259k. The larger scenes
+// have SCALES times as many grids.
+constexpr u32                MESH_COUNT = 100;
+constexpr u32                GRID_SIZE = 36;
+constexpr u32                GRID_VERTEX_COUNT = ( GRID_SIZE + 1 ) * ( GRID_SIZE + 1 );
+constexpr u32                GRID_INDEX_COUNT = GRID_SIZE * GRID_SIZE * 6;
+constexpr std::array<u32, 3> SCALES = { 1, 4, 16 };
+
+struct MemoryUsage {
+    u64 current;
+    u64 peak;
+};
+
+// Resident memory of the process, zero where it cannot be read
+auto get_memory_usage() -> MemoryUsage
+{
+#if defined( _WIN32 )
+    PROCESS_MEMORY_COUNTERS counters{};
+    if ( !K32GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) {
+        return {};
+    }
+    return { .current = counters.WorkingSetSize, .peak = counters.PeakWorkingSetSize };
+#elif defined( __linux__ )
+    MemoryUsage   usage{};
+    std::ifstream status{ "/proc/self/status" };
+    std::string   line;
+    while ( std::getline( status, line ) ) {
+        // Reported in KiB
+        if ( line.starts_with( "VmRSS:" ) ) {
+            usage.current = std::stoull( line.substr( 6 ) ) * 1024;
+        } else if ( line.starts_with( "VmHWM:" ) ) {
+            usage.peak = std::stoull( line.substr( 6 ) ) * 1024;
+        }
+    }
+    return usage;
+#else
+    return {};
+#endif
+}
+
+// Hands the memory freed by the previous import back to the OS, which would otherwise be reused without showing up
+// as a rise, and starts the peak over from the current usage. Windows cannot reset it, there the peak only moves once
+// the import goes beyond everything before it, which the scenes written mesh by mesh and run from small to large make
+// sure of.
+auto reset_peak_memory() -> void
+{
+#if defined( __GLIBC__ )
+    malloc_trim( 0 );
+#endif
+#if defined( __linux__ )
+    std::ofstream{ "/proc/self/clear_refs" } << "5";
+#endif
+}
+
+template <typename T>
+auto append( std::vector<u8>& data, const T value ) -> void
+{
+    const usize offset = data.size();
+    data.resize( offset + sizeof( value ) );
+    std::memcpy( data.data() + offset, &value, sizeof( value ) );
+}
+
+// A .glb of mesh_count grids with float positions and 32-bit indices, each placed by its own node. Every mesh gets its
+// own copy of the streams so that decoding reads as much memory as a real asset, they are written one after the other
+// to keep the writer from raising the peak memory of the process above that of the import.
+auto write_scene( const u32 mesh_count ) -> std::filesystem::path
+{
+    std::vector<u8> mesh_data;
+    for ( u32 y = 0; y <= GRID_SIZE; ++y ) {
+        for ( u32 x = 0; x <= GRID_SIZE; ++x ) {
+            append( mesh_data, static_cast<f32>( x ) );
+            append( mesh_data, static_cast<f32>( y ) );
+            append( mesh_data, static_cast<f32>( ( x * y ) % 5 ) * 0.1f );
+        }
+    }
+    for ( u32 y = 0; y < GRID_SIZE; ++y ) {
+        for ( u32 x = 0; x < GRID_SIZE; ++x ) {
+            const u32 corner = y * ( GRID_SIZE + 1 ) + x;
+            for ( const u32 index : { corner, corner + 1, corner + GRID_SIZE + 1, corner + 1, corner + GRID_SIZE + 2,
+                                      corner + GRID_SIZE + 1 } ) {
+                append( mesh_data, index );
+            }
+        }
+    }
+
+    const u64   mesh_size = mesh_data.size();
+    const u64   binary_size = mesh_size * mesh_count;
+    const u64   positions_size = u64{ GRID_VERTEX_COUNT } * 3 * sizeof( f32 );
+    std::string views;
+    std::string accessors;
+    std::string meshes;
+    std::string nodes;
+    std::string scene_nodes;
+    for ( u32 mesh = 0; mesh < mesh_count; ++mesh ) {
+        const std::string separator = mesh == 0 ? "" : ",";
+        const std::string index = std::to_string( mesh );
+        views += separator + R"({"buffer":0,"byteOffset":)" + std::to_string( mesh * mesh_size ) +
+                 R"(,"byteLength":)" + std::to_string( positions_size ) + R"(},{"buffer":0,"byteOffset":)" +
+                 std::to_string( mesh * mesh_size + positions_size ) + R"(,"byteLength":)" +
+                 std::to_string( mesh_size - positions_size ) + "}";
+        accessors += separator + R"({"bufferView":)" + std::to_string( mesh * 2 ) +
+                     R"(,"componentType":5126,"type":"VEC3","count":)" + std::to_string( GRID_VERTEX_COUNT ) +
+                     R"(},{"bufferView":)" + std::to_string( mesh * 2 + 1 ) +
+                     R"(,"componentType":5125,"type":"SCALAR","count":)" + std::to_string( GRID_INDEX_COUNT ) + "}";
+        meshes += separator + R"({"primitives":[{"attributes":{"POSITION":)" + std::to_string( mesh * 2 ) +
+                  R"(},"indices":)" + std::to_string( mesh * 2 + 1 ) + "}]}";
+        nodes += separator + R"({"mesh":)" + index + R"(,"translation":[)" + std::to_string( mesh % 10 * 40 ) +
+                 ",0," + std::to_string( mesh / 10 * 40 ) + "]}";
+        scene_nodes += separator + index;
+    }
+
+    std::string json = R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string( binary_size ) +
+                       R"(}],"bufferViews":[)" + views + R"(],"accessors":[)" + accessors + R"(],"meshes":[)" +
+                       meshes + R"(],"nodes":[)" + nodes + R"(],"scenes":[{"nodes":[)" + scene_nodes +
+                       R"(]}],"scene":0})";
+    json.resize( ( json.size() + 3 ) / 4 * 4, ' ' );
+
+    std::vector<u8> header;
+    append( header, 0x46546C67u );
+    append( header, 2u );
+    append( header, static_cast<u32>( 12 + 8 + json.size() + 8 + binary_size ) );
+    append( header, static_cast<u32>( json.size() ) );
+    append( header, 0x4E4F534Au );
+    header.insert( header.end(), json.begin(), json.end() );
+    append( header, static_cast<u32>( binary_size ) );
+    append( header, 0x004E4942u );
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / ( "mksv_gltf_benchmark_" + std::to_string( mesh_count ) + ".glb" );
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    file.write( reinterpret_cast<const char*>( header.data() ), static_cast<std::streamsize>( header.size() ) );
+    for ( u32 mesh = 0; mesh < mesh_count; ++mesh ) {
+        file.write( reinterpret_cast<const char*>( mesh_data.data() ), static_cast<std::streamsize>( mesh_size ) );
+    }
+    return file ? path : std::filesystem::path{};
+}
+
+// Every scene size from small to large with the threads taking part in decoding, the calling thread and
+// thread_count - 1 workers
+auto apply_arguments( benchmark::internal::Benchmark* const benchmark ) -> void
+{
+    const u32 max_thread_count = std::max( 2u, std::thread::hardware_concurrency() );
+    for ( const u32 scale : SCALES ) {
+        benchmark->Args( { scale, 2 } );
+        if ( max_thread_count > 2 ) {
+            benchmark->Args( { scale, max_thread_count } );
+        }
+    }
+    benchmark->ArgNames( { "scale", "threads" } );
+}
+
+// Opening, sizing and decoding a Sponza sized .glb, or one scale times as large, from the warm file cache into MeshData
+// sized buffers, as the mesh cooker does. The scene is written before measuring. peak_memory is the largest rise of
+// the resident memory over an import, the mapped file and the importer's tables on top of the output buffers, whose
+// size is output.
+auto BM_import_gltf( benchmark::State& state ) -> void
+{
+    const std::filesystem::path path = write_scene( MESH_COUNT * static_cast<u32>( state.range( 0 ) ) );
+    if ( path.empty() ) {
+        state.SkipWithError( "Failed to write the scene" );
+        return;
+    }
+
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( static_cast<u32>( state.range( 1 ) ) - 1 );
+    const u64                        file_size = std::filesystem::file_size( path );
+    const u32                        stride = get_vertex_stride( MeshVertexFormat::PositionColor );
+    u32                              triangle_count = 0;
+    u64                              output_size = 0;
+    u64                              peak_memory = 0;
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        reset_peak_memory();
+        const MemoryUsage before = get_memory_usage();
+        state.ResumeTiming();
+
+        const std::unique_ptr<GltfImporter> importer = GltfImporter::open( path );
+        if ( !importer ) {
+            state.SkipWithError( "Failed to open the scene" );
+            break;
+        }
+
+        std::vector<u8>          vertices( u64{ importer->get_vertex_count() } * stride );
+        std::vector<u32>         indices( importer->get_index_count() );
+        std::vector<MeshSubmesh> submeshes( importer->get_submesh_count() );
+        if ( !importer->decode( *jobs, vertices, indices, submeshes ) ) {
+            state.SkipWithError( "Failed to decode the scene" );
+            break;
+        }
+        triangle_count = importer->get_index_count() / 3;
+        benchmark::DoNotOptimize( vertices.data() );
+
+        state.PauseTiming();
+        const MemoryUsage after = get_memory_usage();
+        output_size = vertices.size() + indices.size() * sizeof( u32 ) + submeshes.size() * sizeof( MeshSubmesh );
+        peak_memory = std::max( peak_memory, after.peak > before.current ? after.peak - before.current : 0 );
+        state.ResumeTiming();
+    }
+
+    state.SetBytesProcessed( static_cast<i64>( state.iterations() * file_size ) );
+    state.counters["triangles"] = static_cast<f64>( triangle_count );
+    state.counters["output_mb"] = static_cast<f64>( output_size ) / ( 1024.0 * 1024.0 );
+    state.counters["peak_memory_mb"] = static_cast<f64>( peak_memory ) / ( 1024.0 * 1024.0 );
+    std::filesystem::remove( path );
+}
+
+BENCHMARK( BM_import_gltf )->Apply( apply_arguments )->UseRealTime()->Unit( benchmark::kMillisecond );
+} // namespace
+} // namespace mksv
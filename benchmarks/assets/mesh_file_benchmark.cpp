@@ -0,0 +1,105 @@
+#include "mksv/assets/mesh_file.hpp"
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// A PositionColor mesh of vertex_count vertices and as many indices, written once per size
+auto write_mesh_file( const u32 vertex_count ) -> std::filesystem::path
+{
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / ( "mksv_mesh_benchmark_" + std::to_string( vertex_count ) + ".mesh" );
+
+    MeshData mesh{};
+    mesh.vertex_format = MeshVertexFormat::PositionColor;
+    mesh.vertices.resize( u64{ vertex_count } * get_vertex_stride( mesh.vertex_format ) );
+    mesh.indices.resize( vertex_count );
+    for ( u32 i = 0; i < vertex_count; ++i ) {
+        mesh.vertices[u64{ i } * get_vertex_stride( mesh.vertex_format )] = static_cast<u8>( i );
+        mesh.indices[i] = i;
+    }
+    mesh.submeshes.push_back( {
+        .first_index = 0,
+        .index_count = vertex_count,
+        .first_vertex = 0,
+        .vertex_count = vertex_count,
+        .bounds = {},
+    } );
+
+    if ( !write_mesh( path, mesh ) ) {
+        return {};
+    }
+    return path;
+}
+
+// Reads one byte per page so that the whole stream is paged in
+auto touch( const std::span<const u8> data ) -> u64
+{
+    u64 sum = 0;
+    for ( usize i = 0; i < data.size(); i += 4096 ) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Mapping, validating and paging in a cooked mesh from the warm file cache, the streams are ready for upload
+auto BM_map_mesh( benchmark::State& state ) -> void
+{
+    const std::filesystem::path path = write_mesh_file( static_cast<u32>( state.range( 0 ) ) );
+    if ( path.empty() ) {
+        state.SkipWithError( "Failed to write the mesh" );
+        return;
+    }
+
+    const u64 file_size = std::filesystem::file_size( path );
+    for ( auto _ : state ) {
+        const std::unique_ptr<MeshFile> file = MeshFile::open( path );
+        if ( !file ) {
+            state.SkipWithError( "Failed to open the mesh" );
+            break;
+        }
+        benchmark::DoNotOptimize( touch( file->get_vertex_data() ) + touch( file->get_index_data() ) );
+    }
+
+    state.SetBytesProcessed( static_cast<i64>( state.iterations() * file_size ) );
+    std::filesystem::remove( path );
+}
+
+BENCHMARK( BM_map_mesh )->RangeMultiplier( 8 )->Range( 1 << 12, 1 << 21 )->Unit( benchmark::kMicrosecond );
+
+// The same file read into memory, what loading costs without the mapping
+auto BM_read_mesh( benchmark::State& state ) -> void
+{
+    const std::filesystem::path path = write_mesh_file( static_cast<u32>( state.range( 0 ) ) );
+    if ( path.empty() ) {
+        state.SkipWithError( "Failed to write the mesh" );
+        return;
+    }
+
+    const u64 file_size = std::filesystem::file_size( path );
+    for ( auto _ : state ) {
+        std::ifstream   file{ path, std::ios::binary };
+        std::vector<u8> data( file_size );
+        file.read( reinterpret_cast<char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+        benchmark::DoNotOptimize( touch( data ) );
+    }
+
+    state.SetBytesProcessed( static_cast<i64>( state.iterations() * file_size ) );
+    std::filesystem::remove( path );
+}
+
+BENCHMARK( BM_read_mesh )->RangeMultiplier( 8 )->Range( 1 << 12, 1 << 21 )->Unit( benchmark::kMicrosecond );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,125 @@
+#include "mksv/assets/mesh_optimizer.hpp"
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// grid_count grids of grid_size x grid_size quads, each one a submesh over its own vertices, with the triangles
+// shuffled inside every grid the way a scanner or a careless exporter leaves them
+auto make_grids( const u32 grid_count, const u32 grid_size ) -> MeshData
+{
+    MeshData mesh{};
+    mesh.vertex_format = MeshVertexFormat::PositionColor;
+
+    std::mt19937 random{ 42 };
+    const u32    row_size = grid_size + 1;
+    for ( u32 grid = 0; grid < grid_count; ++grid ) {
+        const u32 first_vertex = grid * row_size * row_size;
+        for ( u32 y = 0; y <= grid_size; ++y ) {
+            for ( u32 x = 0; x <= grid_size; ++x ) {
+                const f32 vertex[6] = {
+                    static_cast<f32>( x ), static_cast<f32>( y ), static_cast<f32>( grid ), 1.0f, 1.0f, 1.0f,
+                };
+                const u8* const bytes = reinterpret_cast<const u8*>( vertex );
+                mesh.vertices.insert( mesh.vertices.end(), bytes, bytes + sizeof( vertex ) );
+            }
+        }
+
+        std::vector<u32> quads( grid_size * grid_size );
+        for ( u32 quad = 0; quad < quads.size(); ++quad ) {
+            quads[quad] = quad;
+        }
+        std::ranges::shuffle( quads, random );
+
+        const u32 first_index = static_cast<u32>( mesh.indices.size() );
+        for ( const u32 quad : quads ) {
+            const u32 corner = first_vertex + quad / grid_size * row_size + quad % grid_size;
+            mesh.indices.insert(
+                mesh.indices.end(),
+                { corner, corner + 1, corner + row_size, corner + 1, corner + row_size + 1, corner + row_size }
+            );
+        }
+
+        mesh.submeshes.push_back( {
+            .first_index = first_index,
+            .index_count = static_cast<u32>( mesh.indices.size() ) - first_index,
+            .first_vertex = 0,
+            .vertex_count = 0,
+            .bounds = {},
+        } );
+    }
+
+    return mesh;
+}
+
+auto get_vertex_count( const MeshData& mesh ) -> u32
+{
+    return static_cast<u32>( mesh.vertices.size() / get_vertex_stride( mesh.vertex_format ) );
+}
+
+// Tipsify on a single shuffled grid, the counters are the simulated cache before and after
+auto BM_optimize_vertex_cache( benchmark::State& state ) -> void
+{
+    const MeshData mesh = make_grids( 1, static_cast<u32>( state.range( 0 ) ) );
+    const u32      vertex_count = get_vertex_count( mesh );
+
+    std::vector<u32> indices;
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        indices = mesh.indices;
+        state.ResumeTiming();
+
+        optimize_vertex_cache( indices, vertex_count );
+        benchmark::DoNotOptimize( indices.data() );
+    }
+
+    const VertexCacheStats before = analyze_vertex_cache( mesh.indices, vertex_count );
+    const VertexCacheStats after = analyze_vertex_cache( indices, vertex_count );
+    state.counters["acmr_before"] = before.acmr;
+    state.counters["acmr_after"] = after.acmr;
+    state.counters["atvr_before"] = before.atvr;
+    state.counters["atvr_after"] = after.atvr;
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * mesh.indices.size() / 3 ) );
+}
+
+BENCHMARK( BM_optimize_vertex_cache )->RangeMultiplier( 4 )->Range( 16, 1024 )->Unit( benchmark::kMillisecond );
+
+// The whole pipeline on about 1M triangles split into more and more submeshes, the time per triangle stays flat as
+// long as every submesh only pays for its own vertices
+auto BM_optimize_mesh( benchmark::State& state ) -> void
+{
+    const u32      grid_count = static_cast<u32>( state.range( 0 ) );
+    const u32      grid_size = static_cast<u32>( 724 / std::sqrt( static_cast<f64>( grid_count ) ) );
+    const MeshData source = make_grids( grid_count, grid_size );
+
+    MeshData mesh{};
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        mesh = source;
+        state.ResumeTiming();
+
+        optimize_mesh( mesh );
+        benchmark::DoNotOptimize( mesh.indices.data() );
+    }
+
+    const VertexCacheStats before = analyze_vertex_cache( source.indices, get_vertex_count( source ) );
+    const VertexCacheStats after = analyze_vertex_cache( mesh.indices, get_vertex_count( mesh ) );
+    state.counters["acmr_before"] = before.acmr;
+    state.counters["acmr_after"] = after.acmr;
+    state.counters["atvr_after"] = after.atvr;
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * source.indices.size() / 3 ) );
+}
+
+BENCHMARK( BM_optimize_mesh )->RangeMultiplier( 16 )->Range( 1, 4096 )->Unit( benchmark::kMillisecond );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,127 @@
+#include "mksv/assets/vertex_quantization.hpp"
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 VERTEX_COUNT = 1u << 20;
+constexpr u32 VERTEX_STRIDE = 6 * sizeof( f32 );
+
+using Encoder = auto ( * )( const u8*, const u32, u8*, const u32, const u32 ) -> void;
+
+// Interleaved PositionColor vertices, the normal encoder reads the colors as normals
+auto make_vertices() -> std::vector<u8>
+{
+    std::mt19937                        random{ 3 };
+    std::uniform_real_distribution<f32> distribution{ -1.0f, 1.0f };
+
+    std::vector<f32> values( u64{ VERTEX_COUNT } * 6 );
+    for ( f32& value : values ) {
+        value = distribution( random );
+    }
+
+    const u8* const bytes = reinterpret_cast<const u8*>( values.data() );
+    return { bytes, bytes + values.size() * sizeof( f32 ) };
+}
+
+auto get_bounds() -> MeshBounds
+{
+    return { .min = { -1.0f, -1.0f, -1.0f }, .max = { 1.0f, 1.0f, 1.0f } };
+}
+
+// One attribute out of interleaved vertices into a tightly packed stream
+auto BM_encode( benchmark::State& state, const Encoder encode, const u32 encoded_size ) -> void
+{
+    const std::vector<u8> vertices = make_vertices();
+    std::vector<u8>       encoded( u64{ VERTEX_COUNT } * encoded_size );
+
+    for ( auto _ : state ) {
+        encode( vertices.data(), VERTEX_STRIDE, encoded.data(), encoded_size, VERTEX_COUNT );
+        benchmark::DoNotOptimize( encoded.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * VERTEX_COUNT );
+}
+
+BENCHMARK_CAPTURE( BM_encode, positions_half, encode_positions_half, 8 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( BM_encode, colors_unorm8, encode_colors_unorm8, 4 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( BM_encode, normals_octahedral, encode_normals_octahedral, 4 )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( BM_encode, uvs_half, encode_uvs_half, 4 )->Unit( benchmark::kMicrosecond );
+
+auto BM_encode_positions_snorm16( benchmark::State& state ) -> void
+{
+    const std::vector<u8> vertices = make_vertices();
+    std::vector<u8>       encoded( u64{ VERTEX_COUNT } * 8 );
+
+    for ( auto _ : state ) {
+        encode_positions_snorm16( vertices.data(), VERTEX_STRIDE, encoded.data(), 8, VERTEX_COUNT, get_bounds() );
+        benchmark::DoNotOptimize( encoded.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * VERTEX_COUNT );
+}
+
+BENCHMARK( BM_encode_positions_snorm16 )->Unit( benchmark::kMicrosecond );
+
+// What the cooker does with --quantize, including the allocation of the new vertices
+auto BM_quantize_mesh( benchmark::State& state ) -> void
+{
+    MeshData source{};
+    source.vertex_format = MeshVertexFormat::PositionColor;
+    source.vertices = make_vertices();
+    source.bounds = get_bounds();
+
+    MeshData mesh{};
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        mesh = source;
+        state.ResumeTiming();
+
+        if ( !quantize_mesh( mesh, MeshVertexFormat::PositionColorQuantized ) ) {
+            state.SkipWithError( "Failed to quantize the mesh" );
+            break;
+        }
+        benchmark::DoNotOptimize( mesh.vertices.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * VERTEX_COUNT );
+}
+
+BENCHMARK( BM_quantize_mesh )->Unit( benchmark::kMicrosecond );
+
+// The scalar decoder back to PositionColor, used for validation rather than at runtime
+auto BM_dequantize_vertices( benchmark::State& state ) -> void
+{
+    MeshData mesh{};
+    mesh.vertex_format = MeshVertexFormat::PositionColor;
+    mesh.vertices = make_vertices();
+    mesh.bounds = get_bounds();
+    if ( !quantize_mesh( mesh, MeshVertexFormat::PositionColorQuantized ) ) {
+        state.SkipWithError( "Failed to quantize the mesh" );
+        return;
+    }
+
+    std::vector<u8> decoded( u64{ VERTEX_COUNT } * VERTEX_STRIDE );
+    for ( auto _ : state ) {
+        if ( !dequantize_vertices( mesh.vertex_format, mesh.bounds, mesh.vertices, decoded ) ) {
+            state.SkipWithError( "Failed to dequantize the vertices" );
+            break;
+        }
+        benchmark::DoNotOptimize( decoded.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * VERTEX_COUNT );
+}
+
+BENCHMARK( BM_dequantize_vertices )->Unit( benchmark::kMicrosecond );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,90 @@
+#include "mksv/graphics/frame_scheduler.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/mock_fence.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// Cost of the scheduling itself with a GPU that is always done, nothing ever waits
+auto BM_begin_end_frame( benchmark::State& state ) -> void
+{
+    MockFence      fence;
+    FrameScheduler scheduler{ fence, static_cast<u32>( state.range( 0 ) ) };
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize( scheduler.begin_frame() );
+        fence.complete_up_to( scheduler.end_frame() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) );
+    state.counters["stalls"] = static_cast<f64>( scheduler.get_stall_count() );
+}
+BENCHMARK( BM_begin_end_frame )->DenseRange( 1, 3 )->ArgName( "frames_in_flight" );
+
+// Frames on a simulated timeline: the CPU records a frame in CPU_FRAME_TIME units and submits it, the GPU runs the
+// submitted frames one after the other in gpu_frame_time units each. A frame's fence completes once the GPU has
+// finished it, begin_frame() waits on the mock fence when the context it reuses is still on the GPU, which moves the
+// CPU to the moment the GPU finishes that frame.
+//
+// Reports how busy both sides were over the simulated time, 1 for a side that never waited on the other. With a
+// single frame in flight the two never overlap, with more the slower side is busy all the time.
+constexpr u64 CPU_FRAME_TIME = 100;
+
+auto BM_frame_overlap( benchmark::State& state ) -> void
+{
+    const u32 frames_in_flight = static_cast<u32>( state.range( 0 ) );
+    const u64 gpu_frame_time = static_cast<u64>( state.range( 1 ) );
+
+    MockFence      fence;
+    FrameScheduler scheduler{ fence, frames_in_flight };
+
+    // GPU end times of the frames not yet completed, by fence value modulo its size
+    std::vector<u64> gpu_end_times( frames_in_flight + 1, 0 );
+    u64              cpu_time = 0;
+    u64              gpu_time = 0;
+    u64              cpu_busy_time = 0;
+    u64              gpu_busy_time = 0;
+
+    for ( auto _ : state ) {
+        // The GPU has finished everything that ended by now
+        u64 completed = fence.get_completed_value();
+        while ( completed < fence.get_signaled_value() &&
+                gpu_end_times[( completed + 1 ) % gpu_end_times.size()] <= cpu_time ) {
+            ++completed;
+        }
+        fence.complete_up_to( completed );
+
+        const u64 stalls = fence.get_stall_count();
+        const u32 index = scheduler.begin_frame();
+        if ( fence.get_stall_count() != stalls ) {
+            const u64 waited = scheduler.get_context_fence_value( index );
+            cpu_time = std::max( cpu_time, gpu_end_times[waited % gpu_end_times.size()] );
+        }
+
+        cpu_time += CPU_FRAME_TIME;
+        cpu_busy_time += CPU_FRAME_TIME;
+        const u64 fence_value = scheduler.end_frame();
+
+        gpu_time = std::max( gpu_time, cpu_time ) + gpu_frame_time;
+        gpu_busy_time += gpu_frame_time;
+        gpu_end_times[fence_value % gpu_end_times.size()] = gpu_time;
+    }
+
+    const f64 total_time = static_cast<f64>( std::max( cpu_time, gpu_time ) );
+    state.counters["cpu_busy"] = static_cast<f64>( cpu_busy_time ) / total_time;
+    state.counters["gpu_busy"] = static_cast<f64>( gpu_busy_time ) / total_time;
+    state.counters["stalls_per_frame"] =
+        static_cast<f64>( scheduler.get_stall_count() ) / static_cast<f64>( state.iterations() );
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) );
+}
+BENCHMARK( BM_frame_overlap )
+    ->ArgsProduct( { { 1, 2, 3 }, { 50, 100, 150 } } )
+    ->ArgNames( { "frames_in_flight", "gpu_frame_time" } );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,134 @@
+#include "mksv/graphics/frustum_culler.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+#include "mksv/math/mat.hpp"
+#include "mksv/math/quat.hpp"
+#include "mksv/scene/transform_hierarchy.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 OBJECT_COUNT = 1'000'000;
+
+const vec3 MESH_CENTER = { 0.0f, 0.5f, 0.0f };
+const vec3 MESH_EXTENT = { 0.5f, 0.5f, 0.5f };
+
+// A root with OBJECT_COUNT children spread over a cube of 200 units, like the sandbox scene, with its world matrices
+// up to date
+struct Scene {
+    TransformHierarchy       transforms;
+    std::vector<TransformId> objects;
+};
+
+auto make_scene() -> std::unique_ptr<Scene>
+{
+    auto              scene = std::make_unique<Scene>();
+    const vec3        unit_scale = { 1.0f, 1.0f, 1.0f };
+    const TransformId root = scene->transforms.create( INVALID_TRANSFORM, {}, quat_identity(), unit_scale );
+
+    scene->objects.reserve( OBJECT_COUNT );
+    for ( u32 i = 0; i < OBJECT_COUNT; ++i ) {
+        const vec3 translation = {
+            static_cast<f32>( i % 100 ) * 2.0f - 100.0f,
+            static_cast<f32>( i / 100 % 100 ) * 2.0f - 100.0f,
+            static_cast<f32>( i / 10000 ) * 2.0f - 100.0f,
+        };
+        const quat rotation = quat_from_axis_angle( { 0.0f, 1.0f, 1.0f }, static_cast<f32>( i ) * 0.01f );
+        scene->objects.push_back( scene->transforms.create( root, translation, rotation, unit_scale ) );
+    }
+
+    scene->transforms.update();
+    return scene;
+}
+
+// A camera in front of the cube looking into it, about 40% of the objects are visible
+auto get_frustum() -> Frustum
+{
+    const mat4 view = look_at_lh( { 0.0f, 0.0f, -150.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } );
+    return extract_frustum( view * perspective_fov_lh( 0.6f, 16.0f / 9.0f, 0.1f, 1000.0f ) );
+}
+
+// Threads taking part in the work, the calling thread and thread_count - 1 workers. A single thread runs without a
+// JobSystem.
+auto apply_thread_counts( benchmark::internal::Benchmark* const benchmark ) -> void
+{
+    const u32 max_thread_count = std::max( 2u, std::thread::hardware_concurrency() );
+    for ( u32 thread_count = 1; thread_count < max_thread_count; thread_count *= 2 ) {
+        benchmark->Arg( thread_count );
+    }
+    benchmark->Arg( max_thread_count );
+}
+
+auto create_jobs( const benchmark::State& state ) -> std::unique_ptr<JobSystem>
+{
+    const u32 thread_count = static_cast<u32>( state.range( 0 ) );
+    return thread_count > 1 ? JobSystem::create( thread_count - 1 ) : nullptr;
+}
+
+// Bounds from the world matrices, done every frame before culling
+auto BM_set_transformed( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Scene>     scene = make_scene();
+    const std::unique_ptr<JobSystem> jobs = create_jobs( state );
+
+    FrustumCuller culler;
+    for ( auto _ : state ) {
+        culler.set_transformed( scene->transforms, scene->objects, MESH_CENTER, MESH_EXTENT, jobs.get() );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * OBJECT_COUNT );
+}
+BENCHMARK( BM_set_transformed )->Apply( apply_thread_counts )->UseRealTime()->Unit( benchmark::kMicrosecond );
+
+template <CullShape shape>
+auto BM_cull( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Scene>     scene = make_scene();
+    const std::unique_ptr<JobSystem> jobs = create_jobs( state );
+    const Frustum                    frustum = get_frustum();
+
+    FrustumCuller culler;
+    culler.set_transformed( scene->transforms, scene->objects, MESH_CENTER, MESH_EXTENT );
+
+    std::vector<u32> visible;
+    for ( auto _ : state ) {
+        culler.cull( frustum, shape, visible, jobs.get() );
+        benchmark::DoNotOptimize( visible.data() );
+    }
+
+    state.counters["visible"] = static_cast<f64>( visible.size() );
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * OBJECT_COUNT );
+}
+BENCHMARK( BM_cull<CullShape::Box> )->Apply( apply_thread_counts )->UseRealTime()->Unit( benchmark::kMicrosecond );
+BENCHMARK( BM_cull<CullShape::Sphere> )->Apply( apply_thread_counts )->UseRealTime()->Unit( benchmark::kMicrosecond );
+
+// What the engine does every frame once the transforms are updated
+auto BM_bounds_and_cull( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Scene>     scene = make_scene();
+    const std::unique_ptr<JobSystem> jobs = create_jobs( state );
+    const Frustum                    frustum = get_frustum();
+
+    FrustumCuller    culler;
+    std::vector<u32> visible;
+    for ( auto _ : state ) {
+        culler.set_transformed( scene->transforms, scene->objects, MESH_CENTER, MESH_EXTENT, jobs.get() );
+        culler.cull( frustum, CullShape::Box, visible, jobs.get() );
+        benchmark::DoNotOptimize( visible.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * OBJECT_COUNT );
+}
+BENCHMARK( BM_bounds_and_cull )->Apply( apply_thread_counts )->UseRealTime()->Unit( benchmark::kMicrosecond );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,85 @@
+#include "mksv/graphics/index_free_list.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 CAPACITY = 4096;
+
+// A descriptor allocated and freed again, the churn DescriptorHeap sees for persistent descriptors
+auto BM_free_list_pop_push( benchmark::State& state ) -> void
+{
+    static IndexFreeList list{ CAPACITY, true };
+
+    for ( auto _ : state ) {
+        const std::optional<u32> index = list.pop();
+        benchmark::DoNotOptimize( index );
+        list.push( *index );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) );
+}
+BENCHMARK( BM_free_list_pop_push )->ThreadRange( 1, 8 )->UseRealTime();
+
+// The same churn on a vector behind a mutex, the baseline the lock-free list replaces
+auto BM_locked_vector_pop_push( benchmark::State& state ) -> void
+{
+    static std::mutex       mutex;
+    static std::vector<u32> free_indices = [] {
+        std::vector<u32> indices( CAPACITY );
+        std::iota( indices.rbegin(), indices.rend(), 0u );
+        return indices;
+    }();
+
+    for ( auto _ : state ) {
+        u32 index = 0;
+        {
+            std::scoped_lock lock{ mutex };
+            index = free_indices.back();
+            free_indices.pop_back();
+        }
+        benchmark::DoNotOptimize( index );
+        {
+            std::scoped_lock lock{ mutex };
+            free_indices.push_back( index );
+        }
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) );
+}
+BENCHMARK( BM_locked_vector_pop_push )->ThreadRange( 1, 8 )->UseRealTime();
+
+// Frees collected during a frame and handed back in one go once its fence completes
+auto BM_free_list_take_all( benchmark::State& state ) -> void
+{
+    const u32     batch_size = static_cast<u32>( state.range( 0 ) );
+    IndexFreeList free_list{ CAPACITY, true };
+    IndexFreeList pending{ CAPACITY, false };
+
+    for ( auto _ : state ) {
+        for ( u32 i = 0; i < batch_size; ++i ) {
+            pending.push( *free_list.pop() );
+        }
+
+        for ( u32 index = pending.take_all(); index != IndexFreeList::INVALID_INDEX; ) {
+            const u32 next = pending.get_next( index );
+            free_list.push( index );
+            index = next;
+        }
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * batch_size );
+}
+BENCHMARK( BM_free_list_take_all )->Arg( 16 )->Arg( 256 )->Arg( 4096 );
+
+} // namespace
+} // namespace mksv
@@ -0,0 +1,334 @@
+#include "mksv/graphics/pipeline_cache.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+#include "mksv/utils/d3d12_helpers.hpp"
+
+#include <benchmark/benchmark.h>
+#include <d3dcompiler.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace mksv
+{
+namespace
+{
+constexpr const char* SHADER_SOURCE = R"(
+float4 vs_main( float3 position : POSITION ) : SV_Position
+{
+    return float4( position * float( SALT ), 1.0 );
+}
+
+float4 ps_main() : SV_Target
+{
+    return float4( float( SALT ), 0.0, 0.0, 1.0 );
+}
+)";
+
+const D3D12_INPUT_ELEMENT_DESC INPUT_ELEMENTS[] = {
+    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+};
+
+struct Context {
+    ComPtr<D3D12Device> device;
+    ComPtr<DXGIAdapter> adapter;
+    ComPtr<ID3DBlob>    root_signature;
+};
+
+struct Shaders {
+    ComPtr<ID3DBlob> vs;
+    ComPtr<ID3DBlob> ps;
+};
+
+struct PipelineStateStream {
+    d3d12::PSSRootSignature       root_sig;
+    d3d12::PSSInputLayout         input_layout;
+    d3d12::PSSPrimitiveTopology   primitive_topology;
+    d3d12::PSSVertexShader        vs;
+    d3d12::PSSPixelShader         ps;
+    d3d12::PSSRenderTargetFormats rtv_formats;
+};
+
+auto create_context() -> std::optional<Context>
+{
+    Context context{};
+
+    ComPtr<DXGIFactory> factory{};
+    if ( FAILED( CreateDXGIFactory2( 0, IID_PPV_ARGS( &factory ) ) ) ) {
+        return std::nullopt;
+    }
+
+    HRESULT hr = factory->EnumAdapterByGpuPreference(
+        0, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS( &context.adapter )
+    );
+    if ( FAILED( hr ) ) {
+        return std::nullopt;
+    }
+
+    hr = D3D12CreateDevice( context.adapter.Get(), D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS( &context.device ) );
+    if ( FAILED( hr ) ) {
+        return std::nullopt;
+    }
+
+    const D3D12_ROOT_SIGNATURE_DESC root_signature_desc = {
+        .NumParameters = 0,
+        .pParameters = nullptr,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT,
+    };
+
+    ComPtr<ID3DBlob> error_blob;
+    hr = D3D12SerializeRootSignature(
+        &root_signature_desc, D3D_ROOT_SIGNATURE_VERSION_1, &context.root_signature, &error_blob
+    );
+    if ( FAILED( hr ) ) {
+        return std::nullopt;
+    }
+
+    return context;
+}
+
+auto compile_shader( const char* entry_point, const char* target, const u32 salt ) -> ComPtr<ID3DBlob>
+{
+    const std::string      salt_str = std::to_string( salt );
+    const D3D_SHADER_MACRO defines[] = { { "SALT", salt_str.c_str() }, { nullptr, nullptr } };
+    const std::string_view source = SHADER_SOURCE;
+
+    ComPtr<ID3DBlob> blob;
+    ComPtr<ID3DBlob> errors;
+    const HRESULT    hr = D3DCompile(
+        source.data(), source.size(), nullptr, defines, nullptr, entry_point, target, 0, 0, &blob, &errors
+    );
+    return SUCCEEDED( hr ) ? blob : nullptr;
+}
+
+// Shaders compiled with a different salt have different bytecode, so neither the cache nor the driver has seen them
+auto compile_shaders( const u32 salt ) -> std::optional<Shaders>
+{
+    Shaders shaders = {
+        .vs = compile_shader( "vs_main", "vs_5_0", salt ),
+        .ps = compile_shader( "ps_main", "ps_5_0", salt ),
+    };
+    if ( !shaders.vs || !shaders.ps ) {
+        return std::nullopt;
+    }
+
+    return shaders;
+}
+
+auto bytecode( const ComPtr<ID3DBlob>& blob ) -> D3D12_SHADER_BYTECODE
+{
+    return d3d12::shader_bytecode( { static_cast<const u8*>( blob->GetBufferPointer() ), blob->GetBufferSize() } );
+}
+
+auto make_stream( ID3D12RootSignature* root_signature, const Shaders& shaders ) -> PipelineStateStream
+{
+    PipelineStateStream pss;
+    pss.root_sig = root_signature;
+    pss.input_layout = D3D12_INPUT_LAYOUT_DESC{
+        .pInputElementDescs = INPUT_ELEMENTS,
+        .NumElements = static_cast<UINT>( std::size( INPUT_ELEMENTS ) ),
+    };
+    pss.primitive_topology = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    pss.vs = bytecode( shaders.vs );
+    pss.ps = bytecode( shaders.ps );
+    pss.rtv_formats = {
+        .RTFormats{ DXGI_FORMAT_R8G8B8A8_UNORM },
+        .NumRenderTargets = 1,
+    };
+    return pss;
+}
+
+auto stream_desc( PipelineStateStream& pss ) -> D3D12_PIPELINE_STATE_STREAM_DESC
+{
+    return {
+        .SizeInBytes = sizeof( pss ),
+        .pPipelineStateSubobjectStream = &pss,
+    };
+}
+
+// Salts start from the clock so that a second run does not find the first run's shaders in the driver's disk cache
+auto next_salt() -> u32
+{
+    static u32 salt =
+        static_cast<u32>( std::chrono::steady_clock::now().time_since_epoch().count() % ( 1u << 20 ) ) * 16;
+    return ++salt;
+}
+
+auto cache_path() -> std::filesystem::path
+{
+    return std::filesystem::temp_directory_path() / "mksv_pipeline_cache_benchmark.bin";
+}
+
+auto load_cache( const Context& context ) -> std::unique_ptr<PipelineCache>
+{
+    return PipelineCache::create( context.device, context.adapter, cache_path() );
+}
+
+// A fresh cache without a library on disk
+auto create_empty_cache( const Context& context ) -> std::unique_ptr<PipelineCache>
+{
+    std::error_code error;
+    std::filesystem::remove( cache_path(), error );
+    return load_cache( context );
+}
+
+// Null as well when the cache could not be created
+auto create_root_signature( PipelineCache* cache, const Context& context ) -> ComPtr<ID3D12RootSignature>
+{
+    if ( !cache ) {
+        return nullptr;
+    }
+
+    return cache->create_root_signature(
+        context.root_signature->GetBufferPointer(), context.root_signature->GetBufferSize()
+    );
+}
+
+// Cost of keying a stream, paid on every get_pipeline_state() call
+auto BM_hash_stream( benchmark::State& state ) -> void
+{
+    const std::optional<Context> context = create_context();
+    if ( !context ) {
+        state.SkipWithError( "No D3D12 device" );
+        return;
+    }
+
+    std::unique_ptr<PipelineCache>    cache = create_empty_cache( *context );
+    const ComPtr<ID3D12RootSignature> root_signature = create_root_signature( cache.get(), *context );
+    const std::optional<Shaders>      shaders = compile_shaders( next_salt() );
+    if ( !root_signature || !shaders ) {
+        state.SkipWithError( "Failed to create the pipeline inputs" );
+        return;
+    }
+
+    PipelineStateStream                    pss = make_stream( root_signature.Get(), *shaders );
+    const D3D12_PIPELINE_STATE_STREAM_DESC desc = stream_desc( pss );
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize( cache->hash_stream( desc ) );
+    }
+
+    state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( BM_hash_stream );
+
+// Neither the cache, its library nor the driver has seen the shaders, the pipeline is compiled and stored
+auto BM_create_cold( benchmark::State& state ) -> void
+{
+    const std::optional<Context> context = create_context();
+    if ( !context ) {
+        state.SkipWithError( "No D3D12 device" );
+        return;
+    }
+
+    std::unique_ptr<PipelineCache>    cache = create_empty_cache( *context );
+    const ComPtr<ID3D12RootSignature> root_signature = create_root_signature( cache.get(), *context );
+    if ( !root_signature ) {
+        state.SkipWithError( "Failed to create the root signature" );
+        return;
+    }
+
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        const std::optional<Shaders> shaders = compile_shaders( next_salt() );
+        if ( !shaders ) {
+            state.SkipWithError( "Failed to compile the shaders" );
+            break;
+        }
+        PipelineStateStream                    pss = make_stream( root_signature.Get(), *shaders );
+        const D3D12_PIPELINE_STATE_STREAM_DESC desc = stream_desc( pss );
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize( cache->get_pipeline_state( desc ) );
+    }
+
+    state.counters["compiles"] = static_cast<f64>( cache->get_compile_count() );
+}
+
+BENCHMARK( BM_create_cold )->Unit( benchmark::kMicrosecond );
+
+// A new cache on the saved library, as on the next start of the application
+auto BM_create_from_library( benchmark::State& state ) -> void
+{
+    const std::optional<Context> context = create_context();
+    const std::optional<Shaders> shaders = compile_shaders( next_salt() );
+    if ( !context || !shaders ) {
+        state.SkipWithError( "Failed to create the pipeline inputs" );
+        return;
+    }
+
+    {
+        std::unique_ptr<PipelineCache>    cache = create_empty_cache( *context );
+        const ComPtr<ID3D12RootSignature> root_signature = create_root_signature( cache.get(), *context );
+        PipelineStateStream               pss = make_stream( root_signature.Get(), *shaders );
+        if ( !root_signature || !cache->get_pipeline_state( stream_desc( pss ) ) || !cache->save() ) {
+            state.SkipWithError( "Failed to save the pipeline library" );
+            return;
+        }
+    }
+
+    u64 library_hits = 0;
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        std::unique_ptr<PipelineCache>         cache = load_cache( *context );
+        const ComPtr<ID3D12RootSignature>      root_signature = create_root_signature( cache.get(), *context );
+        PipelineStateStream                    pss = make_stream( root_signature.Get(), *shaders );
+        const D3D12_PIPELINE_STATE_STREAM_DESC desc = stream_desc( pss );
+        if ( !root_signature ) {
+            state.SkipWithError( "Failed to load the pipeline library" );
+            break;
+        }
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize( cache->get_pipeline_state( desc ) );
+
+        state.PauseTiming();
+        library_hits += cache->get_library_hit_count();
+        cache.reset();
+        state.ResumeTiming();
+    }
+
+    // Below the iteration count when the driver does not support libraries and every pipeline was compiled
+    state.counters["library_hits"] = static_cast<f64>( library_hits );
+}
+
+BENCHMARK( BM_create_from_library )->Unit( benchmark::kMicrosecond );
+
+// The pipeline was created earlier in the same run
+auto BM_create_from_memory( benchmark::State& state ) -> void
+{
+    const std::optional<Context> context = create_context();
+    const std::optional<Shaders> shaders = compile_shaders( next_salt() );
+    if ( !context || !shaders ) {
+        state.SkipWithError( "Failed to create the pipeline inputs" );
+        return;
+    }
+
+    std::unique_ptr<PipelineCache>         cache = create_empty_cache( *context );
+    const ComPtr<ID3D12RootSignature>      root_signature = create_root_signature( cache.get(), *context );
+    PipelineStateStream                    pss = make_stream( root_signature.Get(), *shaders );
+    const D3D12_PIPELINE_STATE_STREAM_DESC desc = stream_desc( pss );
+    if ( !root_signature || !cache->get_pipeline_state( desc ) ) {
+        state.SkipWithError( "Failed to create the pipeline state" );
+        return;
+    }
+
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize( cache->get_pipeline_state( desc ) );
+    }
+
+    state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK( BM_create_from_memory );
+} // namespace
+} // namespace mksv
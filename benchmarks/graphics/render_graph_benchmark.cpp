@@ -0,0 +1,91 @@
+#include "mksv/graphics/render_graph.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// The D3D12_RESOURCE_STATES values, the graph only sees them as bit masks
+constexpr u32 RENDER_TARGET = 0x4;
+constexpr u32 UNORDERED_ACCESS = 0x8;
+constexpr u32 NON_PIXEL_SHADER_RESOURCE = 0x40;
+constexpr u32 PIXEL_SHADER_RESOURCE = 0x80;
+constexpr u32 READ_ONLY_STATES = NON_PIXEL_SHADER_RESOURCE | PIXEL_SHADER_RESOURCE;
+
+// pass_count passes, each reading the last transient of the chain and, every other pass, the one four before it, and
+// writing a new one, every fourth one in the unordered access state. Every eighth pass is a dead end whose transient no
+// later pass reads, so it gets culled. size_salt changes the transient sizes so that the declarations differ from the
+// previous frame.
+auto declare_graph( RenderGraph& graph, const u32 pass_count, const u64 size_salt ) -> void
+{
+    graph.reset();
+
+    const RenderGraphResource back_buffer = graph.import_resource();
+
+    std::vector<RenderGraphResource> chain;
+    chain.reserve( pass_count );
+    for ( u32 i = 0; i < pass_count; ++i ) {
+        const RenderGraphResource output = graph.create_transient( ( 1 + i % 16 ) * 65536 + size_salt, 65536 );
+        const u32                 state = i % 4 == 3 ? UNORDERED_ACCESS : RENDER_TARGET;
+
+        RenderPassBuilder pass = graph.add_pass( "pass" );
+        if ( !chain.empty() ) {
+            pass.read( chain.back(), PIXEL_SHADER_RESOURCE );
+        }
+        if ( chain.size() >= 4 && i % 2 == 0 ) {
+            pass.read( chain[chain.size() - 4], NON_PIXEL_SHADER_RESOURCE );
+        }
+        pass.write( output, state );
+        if ( i % 8 != 7 ) {
+            chain.push_back( output );
+        }
+    }
+
+    graph.add_pass( "present" ).read( chain.back(), PIXEL_SHADER_RESOURCE ).write( back_buffer, RENDER_TARGET );
+    graph.export_resource( back_buffer, 0 );
+}
+
+// Declarations change every frame, so the whole graph is compiled again
+auto BM_compile( benchmark::State& state ) -> void
+{
+    const u32   pass_count = static_cast<u32>( state.range( 0 ) );
+    RenderGraph graph{ READ_ONLY_STATES, UNORDERED_ACCESS };
+
+    u64 frame = 0;
+    for ( auto _ : state ) {
+        declare_graph( graph, pass_count, 256 * ( frame++ % 2 ) );
+        benchmark::DoNotOptimize( graph.compile() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * pass_count );
+    state.counters["barriers"] = static_cast<f64>( graph.get_compiled().barriers.size() );
+    state.counters["transient_mb"] = static_cast<f64>( graph.get_compiled().transient_size ) / ( 1024.0 * 1024.0 );
+    state.counters["culled_passes"] = static_cast<f64>( graph.get_compiled().culled_pass_count );
+}
+BENCHMARK( BM_compile )->RangeMultiplier( 10 )->Range( 10, 10'000 )->Unit( benchmark::kMicrosecond );
+
+// The same declarations as the previous frame, compile() only compares them
+auto BM_compile_unchanged( benchmark::State& state ) -> void
+{
+    const u32   pass_count = static_cast<u32>( state.range( 0 ) );
+    RenderGraph graph{ READ_ONLY_STATES, UNORDERED_ACCESS };
+    declare_graph( graph, pass_count, 0 );
+    graph.compile();
+
+    for ( auto _ : state ) {
+        declare_graph( graph, pass_count, 0 );
+        benchmark::DoNotOptimize( graph.compile() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * pass_count );
+    state.counters["culled_passes"] = static_cast<f64>( graph.get_compiled().culled_pass_count );
+}
+BENCHMARK( BM_compile_unchanged )->RangeMultiplier( 10 )->Range( 10, 10'000 )->Unit( benchmark::kMicrosecond );
+
+} // namespace
+} // namespace mksv
@@ -0,0 +1,98 @@
+#include "mksv/graphics/tlsf_allocator.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u64 GRANULARITY = 64 * 1024;
+constexpr u64 CAPACITY = 1024 * 1024 * 1024;
+constexpr u32 OPERATION_COUNT = 4096;
+
+struct Operation {
+    u64 size;
+    u64 alignment;
+};
+
+// Buffer and texture sized requests as the heap allocator sees them, 64 KiB to 1 MiB with 64 KiB or 4 MiB alignment
+auto make_operations() -> std::vector<Operation>
+{
+    std::mt19937                       random{ 42 };
+    std::uniform_int_distribution<u64> size{ 1, 16 };
+    std::uniform_int_distribution<u32> alignment{ 0, 7 };
+
+    std::vector<Operation> operations( OPERATION_COUNT );
+    for ( Operation& operation : operations ) {
+        operation.size = size( random ) * GRANULARITY;
+        operation.alignment = alignment( random ) == 0 ? 64 * GRANULARITY : GRANULARITY;
+    }
+    return operations;
+}
+
+// An allocate immediately followed by its free, the cost of a single pair on an empty allocator
+auto BM_allocate_free( benchmark::State& state ) -> void
+{
+    const std::vector<Operation> operations = make_operations();
+    TlsfAllocator                allocator{ CAPACITY, GRANULARITY };
+
+    u32 next = 0;
+    for ( auto _ : state ) {
+        const Operation&                    operation = operations[next++ % OPERATION_COUNT];
+        const std::optional<TlsfAllocation> allocation = allocator.allocate( operation.size, operation.alignment );
+        benchmark::DoNotOptimize( allocation );
+        allocator.free( allocation->block );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) );
+}
+BENCHMARK( BM_allocate_free );
+
+// Keeps state.range( 0 ) allocations live and replaces a random one per iteration, splits and merges against a
+// fragmented free list
+auto BM_allocate_free_fragmented( benchmark::State& state ) -> void
+{
+    const std::vector<Operation> operations = make_operations();
+    const u32                    live_count = static_cast<u32>( state.range( 0 ) );
+    TlsfAllocator                allocator{ CAPACITY, GRANULARITY };
+
+    std::vector<u32> live;
+    for ( u32 index = 0; live.size() < live_count && index < OPERATION_COUNT; ++index ) {
+        if ( const std::optional<TlsfAllocation> allocation =
+                 allocator.allocate( operations[index].size, operations[index].alignment ) ) {
+            live.push_back( allocation->block );
+        }
+    }
+
+    std::mt19937 random{ 7 };
+    u32          next = 0;
+    u64          failures = 0;
+    for ( auto _ : state ) {
+        const usize index = random() % live.size();
+        allocator.free( live[index] );
+
+        const Operation&                    operation = operations[next++ % OPERATION_COUNT];
+        const std::optional<TlsfAllocation> allocation = allocator.allocate( operation.size, operation.alignment );
+        if ( allocation ) {
+            live[index] = allocation->block;
+        } else {
+            // Keeps the slot by taking the smallest size again, a failed search is part of the measured cost
+            live[index] = allocator.allocate( GRANULARITY, GRANULARITY )->block;
+            ++failures;
+        }
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * 2 );
+    state.counters["fragmentation"] = allocator.get_stats().fragmentation;
+    state.counters["failures"] = static_cast<f64>( failures );
+}
+BENCHMARK( BM_allocate_free_fragmented )->Arg( 64 )->Arg( 256 )->Arg( 1024 );
+
+} // namespace
+} // namespace mksv
@@ -0,0 +1,87 @@
+#include "mksv/jobs/job_system.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_counter.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 ITEM_COUNT = 1u << 20;
+
+// Threads taking part in the work, the calling thread and thread_count - 1 workers. JobSystem::create() takes 0 for
+// the default worker count, so a single thread is benchmarked without a JobSystem as the baseline.
+auto apply_thread_counts( benchmark::internal::Benchmark* const benchmark ) -> void
+{
+    const u32 max_thread_count = std::max( 2u, std::thread::hardware_concurrency() );
+    for ( u32 thread_count = 2; thread_count < max_thread_count; thread_count *= 2 ) {
+        benchmark->Arg( thread_count );
+    }
+    benchmark->Arg( max_thread_count );
+}
+
+auto update_values( std::vector<f32>& values, const u32 first, const u32 count ) -> void
+{
+    for ( u32 item = first; item < first + count; ++item ) {
+        values[item] = std::sqrt( values[item] * 1.0001f + 0.5f );
+    }
+}
+
+auto BM_serial_for( benchmark::State& state ) -> void
+{
+    std::vector<f32> values( ITEM_COUNT, 1.0f );
+    for ( auto _ : state ) {
+        update_values( values, 0, ITEM_COUNT );
+        benchmark::DoNotOptimize( values.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * ITEM_COUNT );
+}
+BENCHMARK( BM_serial_for )->UseRealTime()->Unit( benchmark::kMicrosecond );
+
+// The same work as BM_serial_for split into ranges, the speedup over it is the scaling of parallel_for
+auto BM_parallel_for( benchmark::State& state ) -> void
+{
+    const u32                        thread_count = static_cast<u32>( state.range( 0 ) );
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( thread_count - 1 );
+
+    std::vector<f32> values( ITEM_COUNT, 1.0f );
+    for ( auto _ : state ) {
+        jobs->parallel_for( ITEM_COUNT, JobSystem::DEFAULT_MIN_BATCH_SIZE, [&]( const u32 first, const u32 count ) {
+            update_values( values, first, count );
+        } );
+        benchmark::DoNotOptimize( values.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * ITEM_COUNT );
+}
+BENCHMARK( BM_parallel_for )->Apply( apply_thread_counts )->UseRealTime()->Unit( benchmark::kMicrosecond );
+
+// Many tiny jobs, measures the cost of scheduling and stealing rather than the work
+auto BM_small_jobs( benchmark::State& state ) -> void
+{
+    const u32                        thread_count = static_cast<u32>( state.range( 0 ) );
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( thread_count - 1 );
+
+    constexpr u32 job_count = 10'000;
+    for ( auto _ : state ) {
+        JobCounter counter;
+        for ( u32 job = 0; job < job_count; ++job ) {
+            jobs->run( [] { benchmark::ClobberMemory(); }, &counter );
+        }
+        jobs->wait( counter );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * job_count );
+}
+BENCHMARK( BM_small_jobs )->Apply( apply_thread_counts )->UseRealTime()->Unit( benchmark::kMicrosecond );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,100 @@
+#include "mksv/jobs/radix_sort.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+struct KeyValue {
+    u64 key;
+    u32 value;
+};
+
+// Random keys in the low key_bits bits, draw keys leave the top bits unused the same way
+auto make_keys( const u32 count, const u32 key_bits ) -> std::vector<u64>
+{
+    std::mt19937_64  random{ 11 };
+    const u64        mask = key_bits >= 64 ? ~0ull : ( 1ull << key_bits ) - 1;
+    std::vector<u64> keys( count );
+    for ( u64& key : keys ) {
+        key = random() & mask;
+    }
+    return keys;
+}
+
+// Key counts from 10k to 1M, with 32 and 64 bit keys
+auto apply_sizes( benchmark::internal::Benchmark* const benchmark ) -> void
+{
+    benchmark->ArgNames( { "keys", "bits" } );
+    benchmark->ArgsProduct( { { 10'000, 100'000, 1'000'000 }, { 32, 64 } } );
+}
+
+auto run_radix_sort( benchmark::State& state, JobSystem* const jobs ) -> void
+{
+    const u32              count = static_cast<u32>( state.range( 0 ) );
+    const std::vector<u64> source = make_keys( count, static_cast<u32>( state.range( 1 ) ) );
+
+    std::vector<u64> keys( count );
+    std::vector<u32> values( count );
+    std::vector<u64> key_scratch( count );
+    std::vector<u32> value_scratch( count );
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        keys = source;
+        for ( u32 i = 0; i < count; ++i ) {
+            values[i] = i;
+        }
+        state.ResumeTiming();
+
+        radix_sort( keys, values, key_scratch, value_scratch, jobs );
+        benchmark::DoNotOptimize( keys.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * count );
+}
+
+auto BM_radix_sort( benchmark::State& state ) -> void
+{
+    run_radix_sort( state, nullptr );
+}
+BENCHMARK( BM_radix_sort )->Apply( apply_sizes )->Unit( benchmark::kMicrosecond );
+
+auto BM_radix_sort_parallel( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create();
+    run_radix_sort( state, jobs.get() );
+}
+BENCHMARK( BM_radix_sort_parallel )->Apply( apply_sizes )->UseRealTime()->Unit( benchmark::kMicrosecond );
+
+// The comparison sort radix_sort() replaced, on the same key and value pairs
+auto BM_std_sort( benchmark::State& state ) -> void
+{
+    const u32              count = static_cast<u32>( state.range( 0 ) );
+    const std::vector<u64> source = make_keys( count, static_cast<u32>( state.range( 1 ) ) );
+
+    std::vector<KeyValue> pairs( count );
+    for ( auto _ : state ) {
+        state.PauseTiming();
+        for ( u32 i = 0; i < count; ++i ) {
+            pairs[i] = { .key = source[i], .value = i };
+        }
+        state.ResumeTiming();
+
+        std::sort( pairs.begin(), pairs.end(), []( const KeyValue& a, const KeyValue& b ) { return a.key < b.key; } );
+        benchmark::DoNotOptimize( pairs.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * count );
+}
+BENCHMARK( BM_std_sort )->Apply( apply_sizes )->Unit( benchmark::kMicrosecond );
+} // namespace
+} // namespace mksv
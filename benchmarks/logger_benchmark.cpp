@@ -0,0 +1,105 @@
+#include "mksv/logger.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/log.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// Calls per iteration, the logger is flushed between iterations with the timer paused so that the rings never fill
+// up and only the cost of the call itself is measured
+constexpr u32 BATCH_SIZE = 1000;
+
+// Counts the lines instead of writing them anywhere
+class NullLogSink final : public LogSink
+{
+public:
+    auto write( const LogLevel, const std::wstring& ) -> void override
+    {
+        line_count.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    auto flush() -> void override {}
+
+public:
+    static inline std::atomic<u64> line_count{ 0 };
+};
+
+// Shared by every benchmark and thread, it outlives the benchmark threads
+auto get_logger() -> Logger&
+{
+    static const std::unique_ptr<Logger> logger = [] {
+        std::vector<std::unique_ptr<LogSink>> sinks;
+        sinks.push_back( std::make_unique<NullLogSink>() );
+        return Logger::create( std::move( sinks ) );
+    }();
+    return *logger;
+}
+
+template <typename Log>
+auto run_batches( benchmark::State& state, const Log& log ) -> void
+{
+    Logger& logger = get_logger();
+    for ( auto _ : state ) {
+        for ( u32 i = 0; i < BATCH_SIZE; ++i ) {
+            log( i );
+        }
+
+        state.PauseTiming();
+        logger.flush();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * BATCH_SIZE );
+    state.counters["dropped"] = static_cast<f64>( logger.get_dropped_count() );
+}
+
+// Time per call is the reported time divided by BATCH_SIZE, or the inverse of items_per_second for a single thread
+auto BM_log_int_double( benchmark::State& state ) -> void
+{
+    run_batches( state, []( const u32 i ) { log_info( L"Frame {} took {} ms", i, 16.6 ); } );
+}
+BENCHMARK( BM_log_int_double )->ThreadRange( 1, 4 )->UseRealTime();
+
+auto BM_log_string_int( benchmark::State& state ) -> void
+{
+    const std::wstring name = L"upload_ring";
+    run_batches( state, [&]( const u32 i ) { log_info( L"Allocator {} has {} bytes in flight", name, i ); } );
+}
+BENCHMARK( BM_log_string_int )->ThreadRange( 1, 4 )->UseRealTime();
+
+auto BM_log_runtime_message( benchmark::State& state ) -> void
+{
+    const std::wstring_view message = L"A message only known at runtime";
+    run_batches( state, [&]( const u32 ) { log_info( message ); } );
+}
+BENCHMARK( BM_log_runtime_message )->ThreadRange( 1, 4 )->UseRealTime();
+
+// What the logger thread does per line, the cost moved off the calling thread
+auto BM_format_line( benchmark::State& state ) -> void
+{
+    std::wstring line;
+    u32          i = 0;
+    for ( auto _ : state ) {
+        line.clear();
+        std::format_to( std::back_inserter( line ), L"Frame {} took {} ms", ++i, 16.6 );
+        benchmark::DoNotOptimize( line.data() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) );
+}
+BENCHMARK( BM_format_line );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,175 @@
+#include "mksv/common/types.hpp"
+#include "mksv/math/batch.hpp"
+#include "mksv/math/mat.hpp"
+#include "mksv/math/quat.hpp"
+#include "mksv/math/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#if __has_include( <DirectXMath.h> )
+#include <DirectXMath.h>
+#define MKSV_HAS_DIRECTXMATH 1
+#endif
+
+namespace mksv
+{
+namespace
+{
+// Enough matrices to leave L1, like the transforms of a scene
+constexpr usize MATRIX_COUNT = 4096;
+
+auto make_matrices( const usize count ) -> std::vector<mat4>
+{
+    std::mt19937                        rng{ 1 };
+    std::uniform_real_distribution<f32> value{ -2.0f, 2.0f };
+
+    std::vector<mat4> matrices( count );
+    for ( mat4& m : matrices ) {
+        m = trs(
+            { value( rng ), value( rng ), value( rng ) },
+            quat_from_axis_angle( { value( rng ), 1.0f, value( rng ) }, value( rng ) ),
+            { 1.0f, 1.0f, 1.0f }
+        );
+    }
+    return matrices;
+}
+
+auto BM_mat4_multiply( benchmark::State& state ) -> void
+{
+    const std::vector<mat4> lhs = make_matrices( MATRIX_COUNT );
+    const mat4              rhs = lhs[7];
+    std::vector<mat4>       out( MATRIX_COUNT );
+    for ( auto _ : state ) {
+        for ( usize i = 0; i < MATRIX_COUNT; ++i ) {
+            out[i] = lhs[i] * rhs;
+        }
+        benchmark::DoNotOptimize( out.data() );
+    }
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * MATRIX_COUNT ) );
+}
+BENCHMARK( BM_mat4_multiply );
+
+auto BM_mat4_multiply_batch( benchmark::State& state ) -> void
+{
+    const std::vector<mat4> lhs = make_matrices( MATRIX_COUNT );
+    const mat4              rhs = lhs[7];
+    std::vector<mat4>       out( MATRIX_COUNT );
+    for ( auto _ : state ) {
+        mul_batch( lhs, rhs, out );
+        benchmark::DoNotOptimize( out.data() );
+    }
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * MATRIX_COUNT ) );
+}
+BENCHMARK( BM_mat4_multiply_batch );
+
+auto BM_mat4_multiply_batch_soa( benchmark::State& state ) -> void
+{
+    const std::vector<mat4> lhs = make_matrices( MATRIX_COUNT );
+    const mat4              rhs = lhs[7];
+
+    std::array<std::vector<f32>, 16> lhs_elements;
+    std::array<std::vector<f32>, 16> out_elements;
+    Mat4SoA                          lhs_soa{};
+    Mat4SoA                          out_soa{};
+    ConstMat4SoA                     const_lhs_soa{};
+    for ( usize element = 0; element < 16; ++element ) {
+        lhs_elements[element].resize( MATRIX_COUNT );
+        out_elements[element].resize( MATRIX_COUNT );
+        lhs_soa.elements[element] = lhs_elements[element].data();
+        out_soa.elements[element] = out_elements[element].data();
+        const_lhs_soa.elements[element] = lhs_elements[element].data();
+    }
+    to_soa( lhs, lhs_soa );
+
+    for ( auto _ : state ) {
+        mul_batch( const_lhs_soa, rhs, out_soa, MATRIX_COUNT );
+        benchmark::DoNotOptimize( out_elements[0].data() );
+    }
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * MATRIX_COUNT ) );
+}
+BENCHMARK( BM_mat4_multiply_batch_soa );
+
+auto BM_transform_point( benchmark::State& state ) -> void
+{
+    const std::vector<mat4> matrices = make_matrices( MATRIX_COUNT );
+    std::vector<vec3>       out( MATRIX_COUNT );
+    for ( auto _ : state ) {
+        for ( usize i = 0; i < MATRIX_COUNT; ++i ) {
+            out[i] = transform_point( { 1.0f, 2.0f, 3.0f }, matrices[i] );
+        }
+        benchmark::DoNotOptimize( out.data() );
+    }
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * MATRIX_COUNT ) );
+}
+BENCHMARK( BM_transform_point );
+
+auto BM_rotation_axis( benchmark::State& state ) -> void
+{
+    f32 angle = 0.0f;
+    for ( auto _ : state ) {
+        mat4 m = rotation_axis( { 0.2f, 1.0f, -0.4f }, angle );
+        benchmark::DoNotOptimize( m );
+        angle += 0.001f;
+    }
+}
+BENCHMARK( BM_rotation_axis );
+
+#if defined( MKSV_HAS_DIRECTXMATH )
+// The same work with DirectXMath, the baseline the mksv math replaced
+auto to_xm( const std::vector<mat4>& matrices ) -> std::vector<DirectX::XMMATRIX>
+{
+    std::vector<DirectX::XMMATRIX> xm( matrices.size() );
+    for ( usize i = 0; i < matrices.size(); ++i ) {
+        xm[i] = DirectX::XMLoadFloat4x4A( reinterpret_cast<const DirectX::XMFLOAT4X4A*>( &matrices[i] ) );
+    }
+    return xm;
+}
+
+auto BM_xm_matrix_multiply( benchmark::State& state ) -> void
+{
+    const std::vector<DirectX::XMMATRIX> lhs = to_xm( make_matrices( MATRIX_COUNT ) );
+    const DirectX::XMMATRIX              rhs = lhs[7];
+    std::vector<DirectX::XMMATRIX>       out( MATRIX_COUNT );
+    for ( auto _ : state ) {
+        for ( usize i = 0; i < MATRIX_COUNT; ++i ) {
+            out[i] = DirectX::XMMatrixMultiply( lhs[i], rhs );
+        }
+        benchmark::DoNotOptimize( out.data() );
+    }
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * MATRIX_COUNT ) );
+}
+BENCHMARK( BM_xm_matrix_multiply );
+
+auto BM_xm_transform_point( benchmark::State& state ) -> void
+{
+    const std::vector<DirectX::XMMATRIX> matrices = to_xm( make_matrices( MATRIX_COUNT ) );
+    std::vector<DirectX::XMVECTOR>       out( MATRIX_COUNT );
+    const DirectX::XMVECTOR              point = DirectX::XMVectorSet( 1.0f, 2.0f, 3.0f, 1.0f );
+    for ( auto _ : state ) {
+        for ( usize i = 0; i < MATRIX_COUNT; ++i ) {
+            out[i] = DirectX::XMVector3TransformCoord( point, matrices[i] );
+        }
+        benchmark::DoNotOptimize( out.data() );
+    }
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() * MATRIX_COUNT ) );
+}
+BENCHMARK( BM_xm_transform_point );
+
+auto BM_xm_rotation_axis( benchmark::State& state ) -> void
+{
+    const DirectX::XMVECTOR axis = DirectX::XMVectorSet( 0.2f, 1.0f, -0.4f, 0.0f );
+    f32                     angle = 0.0f;
+    for ( auto _ : state ) {
+        DirectX::XMMATRIX m = DirectX::XMMatrixRotationAxis( axis, angle );
+        benchmark::DoNotOptimize( m );
+        angle += 0.001f;
+    }
+}
+BENCHMARK( BM_xm_rotation_axis );
+#endif
+} // namespace
+} // namespace mksv
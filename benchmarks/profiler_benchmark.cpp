@@ -0,0 +1,100 @@
+#include "mksv/profiler.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+namespace mksv
+{
+namespace
+{
+// Zones per iteration, a capture holds Profiler::MAX_BLOCKS * Profiler::BLOCK_SIZE events per thread, so it is
+// restarted between iterations with the timer paused before anything is dropped
+constexpr u32 BATCH_SIZE = 10000;
+
+auto run_zones( const u32 count ) -> void
+{
+    for ( u32 i = 0; i < count; ++i ) {
+        MKSV_PROFILE_ZONE( "Zone" );
+        benchmark::ClobberMemory();
+    }
+}
+
+// The loop without a zone, also what a zone costs with MKSV_PROFILE set to 0
+auto BM_empty_loop( benchmark::State& state ) -> void
+{
+    for ( auto _ : state ) {
+        for ( u32 i = 0; i < BATCH_SIZE; ++i ) {
+            benchmark::ClobberMemory();
+        }
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * BATCH_SIZE );
+}
+BENCHMARK( BM_empty_loop );
+
+// A profiler that is not capturing, the cost of leaving the zones in a shipping build
+auto BM_zone_idle( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Profiler> profiler = Profiler::create();
+    for ( auto _ : state ) {
+        run_zones( BATCH_SIZE );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * BATCH_SIZE );
+}
+BENCHMARK( BM_zone_idle );
+
+auto BM_zone_capturing( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Profiler> profiler = Profiler::create();
+    profiler->begin_capture();
+    for ( auto _ : state ) {
+        run_zones( BATCH_SIZE );
+
+        state.PauseTiming();
+        profiler->end_capture();
+        profiler->begin_capture();
+        state.ResumeTiming();
+    }
+    profiler->end_capture();
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * BATCH_SIZE );
+    state.counters["dropped"] = static_cast<f64>( profiler->get_dropped_count() );
+}
+BENCHMARK( BM_zone_capturing );
+
+auto BM_counter_capturing( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Profiler> profiler = Profiler::create();
+    profiler->begin_capture();
+    for ( auto _ : state ) {
+        for ( u32 i = 0; i < BATCH_SIZE; ++i ) {
+            MKSV_PROFILE_COUNTER( "Counter", i );
+        }
+
+        state.PauseTiming();
+        profiler->end_capture();
+        profiler->begin_capture();
+        state.ResumeTiming();
+    }
+    profiler->end_capture();
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) * BATCH_SIZE );
+}
+BENCHMARK( BM_counter_capturing );
+
+// A zone reads the ticks twice, most of its cost where reading them is slow
+auto BM_read_profile_ticks( benchmark::State& state ) -> void
+{
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize( read_profile_ticks() );
+    }
+
+    state.SetItemsProcessed( static_cast<i64>( state.iterations() ) );
+}
+BENCHMARK( BM_read_profile_ticks );
+} // namespace
+} // namespace mksv
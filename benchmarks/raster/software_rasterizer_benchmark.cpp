@@ -0,0 +1,139 @@
+#include "mksv/raster/software_rasterizer.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+#include "mksv/math/mat.hpp"
+#include "mksv/math/types.hpp"
+#include "mksv/raster/raster_scene.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// The unit cube of the sandbox, clockwise front faces with a color per corner
+constexpr std::array<RasterVertex, 8> CUBE_VERTICES = { {
+    { .position = { -0.5f, 0.5f, 0.5f }, .color = { 1.0f, 0.0f, 0.0f } },
+    { .position = { 0.5f, 0.5f, 0.5f }, .color = { 1.0f, 1.0f, 0.0f } },
+    { .position = { 0.5f, -0.5f, 0.5f }, .color = { 0.0f, 0.0f, 1.0f } },
+    { .position = { -0.5f, -0.5f, 0.5f }, .color = { 0.0f, 1.0f, 0.0f } },
+    { .position = { -0.5f, 0.5f, -0.5f }, .color = { 0.0f, 1.0f, 1.0f } },
+    { .position = { 0.5f, 0.5f, -0.5f }, .color = { 0.0f, 1.0f, 0.0f } },
+    { .position = { 0.5f, -0.5f, -0.5f }, .color = { 1.0f, 0.0f, 0.0f } },
+    { .position = { -0.5f, -0.5f, -0.5f }, .color = { 1.0f, 1.0f, 0.0f } },
+} };
+
+constexpr std::array<u32, 36> CUBE_INDICES = {
+    0, 2, 1, 2, 0, 3, // front
+    0, 5, 4, 5, 0, 1, // top
+    3, 6, 2, 6, 3, 7, // bottom
+    4, 6, 7, 6, 4, 5, // back
+    0, 7, 3, 7, 0, 4, // left
+    1, 6, 5, 6, 1, 2, // right
+};
+
+// A grid of GRID_SIZE^3 cubes seen from above and in front, like the sandbox scene at a smaller size
+constexpr u32 GRID_SIZE = 20;
+constexpr f32 CUBE_SPACING = 2.0f;
+constexpr u32 TRIANGLE_COUNT = GRID_SIZE * GRID_SIZE * GRID_SIZE * static_cast<u32>( CUBE_INDICES.size() / 3 );
+
+constexpr std::array<std::array<u32, 2>, 3> RESOLUTIONS = { {
+    { 640, 360 },
+    { 1280, 720 },
+    { 1920, 1080 },
+} };
+
+auto to_raster_matrix( const mat4& m ) -> RasterMatrix
+{
+    RasterMatrix raster{};
+    for ( u32 row = 0; row < 4; ++row ) {
+        raster[row * 4 + 0] = m.r[row].x;
+        raster[row * 4 + 1] = m.r[row].y;
+        raster[row * 4 + 2] = m.r[row].z;
+        raster[row * 4 + 3] = m.r[row].w;
+    }
+    return raster;
+}
+
+auto make_scene( const f32 aspect_ratio ) -> RasterScene
+{
+    RasterScene scene{
+        .clear_color = { 0.1f, 0.2f, 0.3f, 1.0f },
+        .meshes = { { .vertices = CUBE_VERTICES, .indices = CUBE_INDICES } },
+        .draws = {},
+    };
+
+    const mat4 view = look_at_lh( { 0.0f, 30.0f, -60.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } );
+    const mat4 view_projection = view * perspective_fov_lh( 1.4f, aspect_ratio, 0.1f, 1000.0f );
+    const f32  origin = -0.5f * CUBE_SPACING * static_cast<f32>( GRID_SIZE - 1 );
+
+    scene.draws.reserve( GRID_SIZE * GRID_SIZE * GRID_SIZE );
+    for ( u32 z = 0; z < GRID_SIZE; ++z ) {
+        for ( u32 y = 0; y < GRID_SIZE; ++y ) {
+            for ( u32 x = 0; x < GRID_SIZE; ++x ) {
+                const mat4 world = translation( {
+                    origin + CUBE_SPACING * static_cast<f32>( x ),
+                    origin + CUBE_SPACING * static_cast<f32>( y ),
+                    origin + CUBE_SPACING * static_cast<f32>( z ),
+                } );
+                scene.draws.push_back( { .mesh = 0, .mvp = to_raster_matrix( world * view_projection ) } );
+            }
+        }
+    }
+
+    return scene;
+}
+
+// Every resolution with 1 to N threads, the calling thread and thread_count - 1 workers. A single thread runs without
+// a JobSystem.
+auto apply_arguments( benchmark::internal::Benchmark* const benchmark ) -> void
+{
+    const u32 max_thread_count = std::max( 2u, std::thread::hardware_concurrency() );
+    for ( u32 resolution = 0; resolution < RESOLUTIONS.size(); ++resolution ) {
+        for ( u32 thread_count = 1; thread_count < max_thread_count; thread_count *= 2 ) {
+            benchmark->Args( { resolution, thread_count } );
+        }
+        benchmark->Args( { resolution, max_thread_count } );
+    }
+    benchmark->ArgNames( { "resolution", "threads" } );
+}
+
+// A whole frame of the cube grid, binning, clipping and the tiles
+auto BM_render( benchmark::State& state ) -> void
+{
+    const std::array<u32, 2> resolution = RESOLUTIONS[static_cast<usize>( state.range( 0 ) )];
+    const u32                thread_count = static_cast<u32>( state.range( 1 ) );
+    const f32                aspect_ratio = static_cast<f32>( resolution[0] ) / static_cast<f32>( resolution[1] );
+    const RasterScene        scene = make_scene( aspect_ratio );
+
+    const std::unique_ptr<SoftwareRasterizer> rasterizer = SoftwareRasterizer::create( resolution[0], resolution[1] );
+    const std::unique_ptr<JobSystem>          jobs = thread_count > 1 ? JobSystem::create( thread_count - 1 ) : nullptr;
+    if ( !rasterizer ) {
+        state.SkipWithError( "Failed to create the rasterizer" );
+        return;
+    }
+
+    for ( auto _ : state ) {
+        rasterizer->render( scene, jobs.get() );
+        benchmark::DoNotOptimize( rasterizer->color_buffer().data() );
+    }
+
+    state.SetLabel( std::to_string( resolution[0] ) + "x" + std::to_string( resolution[1] ) );
+    state.counters["frames"] =
+        benchmark::Counter( static_cast<f64>( state.iterations() ), benchmark::Counter::kIsRate );
+    state.counters["triangles"] = benchmark::Counter(
+        static_cast<f64>( state.iterations() ) * TRIANGLE_COUNT,
+        benchmark::Counter::kIsRate
+    );
+}
+BENCHMARK( BM_render )->Apply( apply_arguments )->UseRealTime()->Unit( benchmark::kMillisecond );
+} // namespace
+} // namespace mksv
@@ -0,0 +1,105 @@
+#include "mksv/scene/transform_hierarchy.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+#include "mksv/math/quat.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 GROUP_COUNT = 1000;
+constexpr u32 LEAVES_PER_GROUP = 999;
+
+// A root over GROUP_COUNT group nodes with LEAVES_PER_GROUP leaves each, 1M nodes on three levels
+struct Scene {
+    TransformHierarchy       transforms;
+    std::vector<TransformId> leaves;
+};
+
+auto make_scene() -> std::unique_ptr<Scene>
+{
+    auto              scene = std::make_unique<Scene>();
+    const vec3        unit_scale = { 1.0f, 1.0f, 1.0f };
+    const TransformId root = scene->transforms.create( INVALID_TRANSFORM, {}, quat_identity(), unit_scale );
+
+    scene->leaves.reserve( GROUP_COUNT * LEAVES_PER_GROUP );
+    for ( u32 group = 0; group < GROUP_COUNT; ++group ) {
+        const vec3 group_translation = {
+            static_cast<f32>( group % 10 ) * 20.0f,
+            static_cast<f32>( group / 10 % 10 ) * 20.0f,
+            static_cast<f32>( group / 100 ) * 20.0f,
+        };
+        const TransformId group_node =
+            scene->transforms.create( root, group_translation, quat_identity(), unit_scale );
+
+        for ( u32 leaf = 0; leaf < LEAVES_PER_GROUP; ++leaf ) {
+            const vec3 translation = {
+                static_cast<f32>( leaf % 10 ),
+                static_cast<f32>( leaf / 10 % 10 ),
+                static_cast<f32>( leaf / 100 ),
+            };
+            scene->leaves.push_back( scene->transforms.create( group_node, translation, quat_identity(), unit_scale ) );
+        }
+    }
+
+    scene->transforms.update();
+    return scene;
+}
+
+// Threads taking part in the update, the calling thread and thread_count - 1 workers, a single thread runs without a
+// JobSystem. The second argument is the percentage of the leaves changed every frame.
+auto apply_arguments( benchmark::internal::Benchmark* const benchmark ) -> void
+{
+    const u32 max_thread_count = std::max( 2u, std::thread::hardware_concurrency() );
+    for ( const i64 dirty_percent : { 1, 100 } ) {
+        for ( u32 thread_count = 1; thread_count < max_thread_count; thread_count *= 2 ) {
+            benchmark->Args( { thread_count, dirty_percent } );
+        }
+        benchmark->Args( { max_thread_count, dirty_percent } );
+    }
+    benchmark->ArgNames( { "threads", "dirty_percent" } );
+}
+
+// A frame of the scene, the changed leaves are spread evenly over the groups and every one of them is rotated
+auto BM_update( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Scene>     scene = make_scene();
+    const u32                        thread_count = static_cast<u32>( state.range( 0 ) );
+    const u32                        dirty_interval = 100 / static_cast<u32>( state.range( 1 ) );
+    const std::unique_ptr<JobSystem> jobs = thread_count > 1 ? JobSystem::create( thread_count - 1 ) : nullptr;
+
+    f32 angle = 0.0f;
+    u64 updated_count = 0;
+    for ( auto _ : state ) {
+        angle += 0.01f;
+        const quat rotation = quat_from_axis_angle( { 0.0f, 1.0f, 1.0f }, angle );
+        for ( usize i = 0; i < scene->leaves.size(); i += dirty_interval ) {
+            scene->transforms.set_rotation( scene->leaves[i], rotation );
+        }
+        updated_count += scene->transforms.update( jobs.get() );
+    }
+
+    state.counters["updated"] = static_cast<f64>( updated_count ) / static_cast<f64>( state.iterations() );
+    state.SetItemsProcessed( static_cast<i64>( updated_count ) );
+}
+BENCHMARK( BM_update )->Apply( apply_arguments )->UseRealTime()->Unit( benchmark::kMicrosecond );
+
+// The clean frame, every level is skipped
+auto BM_update_clean( benchmark::State& state ) -> void
+{
+    const std::unique_ptr<Scene> scene = make_scene();
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize( scene->transforms.update() );
+    }
+}
+BENCHMARK( BM_update_clean );
+} // namespace
+} // namespace mksv
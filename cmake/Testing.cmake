@@ -0,0 +1,58 @@
+include(FetchContent)
+
+# Installed packages are used when found, otherwise they are fetched
+if(BUILD_TESTING)
+    FetchContent_Declare(googletest
+        URL https://github.com/google/googletest/archive/refs/tags/v1.14.0.tar.gz
+        FIND_PACKAGE_ARGS NAMES GTest
+    )
+    set(gtest_force_shared_crt ON CACHE BOOL "" FORCE)
+    FetchContent_MakeAvailable(googletest)
+    include(GoogleTest)
+endif()
+
+if(MKSV_BUILD_BENCHMARKS)
+    FetchContent_Declare(benchmark
+        URL https://github.com/google/benchmark/archive/refs/tags/v1.8.3.tar.gz
+        FIND_PACKAGE_ARGS
+    )
+    set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+    FetchContent_MakeAvailable(benchmark)
+endif()
+
+# Adds a test executable and registers every test case in it with CTest
+function(add_mksv_test target)
+    cmake_parse_arguments(TEST "" "" "SOURCES;LIBRARIES" ${ARGN})
+
+    add_clangformat_target(${target} ${TEST_SOURCES})
+
+    add_executable(${target}
+        ${TEST_SOURCES}
+    )
+
+    target_link_libraries(${target}
+        PRIVATE ${TEST_LIBRARIES}
+        PRIVATE GTest::gtest_main
+    )
+
+    gtest_discover_tests(${target}
+        DISCOVERY_TIMEOUT 60
+    )
+endfunction()
+
+# Adds a benchmark executable, benchmarks are run by hand and not registered with CTest
+function(add_mksv_benchmark target)
+    cmake_parse_arguments(BENCHMARK "" "" "SOURCES;LIBRARIES" ${ARGN})
+
+    add_clangformat_target(${target} ${BENCHMARK_SOURCES})
+
+    add_executable(${target}
+        ${BENCHMARK_SOURCES}
+    )
+
+    target_link_libraries(${target}
+        PRIVATE ${BENCHMARK_LIBRARIES}
+        PRIVATE benchmark::benchmark_main
+    )
+endfunction()
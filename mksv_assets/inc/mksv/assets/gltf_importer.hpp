@@ -0,0 +1,123 @@
+#pragma once
+
+#include "mksv/assets/mapped_file.hpp"
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace mksv
+{
+class JobSystem;
+
+// Imports the triangle geometry of a glTF 2.0 asset, .gltf with external or embedded buffers or .glb, as
+// MeshVertexFormat::PositionColor vertices and 32-bit indices.
+//
+// open() maps the file and its buffers and reads the JSON in a single pass without building a tree, keeping only the
+// buffers, buffer views, accessors and mesh primitives. That is enough to know the size of the output, which the
+// caller allocates and decode() fills: every triangle primitive becomes a submesh, the primitives are decoded in
+// parallel straight from the mapped buffers into the caller's memory.
+//
+// Meshes are placed by the nodes of the default scene, or of the first scene, or by all root nodes when there are no
+// scenes. A mesh used by several nodes is imported once per node, with its positions in world space. Assets without
+// nodes import every mesh once in its own space. Sparse accessors and primitives without positions are rejected and
+// primitives of other modes are skipped.
+class GltfImporter
+{
+public:
+    static inline constexpr u32 INVALID_INDEX = ~0u;
+
+public:
+    static auto open( const std::filesystem::path& path ) -> std::unique_ptr<GltfImporter>;
+
+public:
+    GltfImporter( const GltfImporter& ) = delete;
+    GltfImporter( GltfImporter&& ) = delete;
+    auto operator=( const GltfImporter& ) -> GltfImporter& = delete;
+    auto operator=( GltfImporter&& ) -> GltfImporter& = delete;
+    ~GltfImporter();
+
+public:
+    auto get_vertex_count() const -> u32;
+    auto get_index_count() const -> u32;
+    auto get_submesh_count() const -> u32;
+
+    // vertices holds get_vertex_count() vertices, indices get_index_count() indices and submeshes get_submesh_count()
+    // submeshes, whose bounds and vertex ranges are filled in as well. Fails if an index is out of range.
+    [[nodiscard]] auto decode(
+        JobSystem&                   jobs,
+        const std::span<u8>          vertices,
+        const std::span<u32>         indices,
+        const std::span<MeshSubmesh> submeshes
+    ) const -> bool;
+
+private:
+    struct BufferView {
+        u32 buffer;
+        u64 offset;
+        u64 size;
+        u32 stride;
+    };
+
+    struct Accessor {
+        u32  buffer_view;
+        u64  offset;
+        u32  component_type;
+        u32  component_count;
+        u32  count;
+        bool normalized;
+        bool sparse;
+    };
+
+    struct Primitive {
+        u32 positions;
+        u32 colors;
+        u32 indices;
+        u32 mode;
+        u32 first_vertex;
+        u32 vertex_count;
+        u32 first_index;
+        u32 index_count;
+        // Into transforms_
+        u32 transform;
+    };
+
+    struct Document;
+
+private:
+    explicit GltfImporter( std::unique_ptr<MappedFile> file );
+
+    auto parse( const std::string_view json, Document& document ) -> bool;
+    // Places the mesh primitives by the node hierarchy
+    auto instantiate( const Document& document ) -> bool;
+    auto load_buffers( const Document& document, const std::filesystem::path& directory ) -> bool;
+    auto validate() -> bool;
+
+    // The element at index of an accessor, nullptr for accessors without a buffer view
+    auto get_element( const Accessor& accessor, const u32 index ) const -> const u8*;
+    auto get_element_size( const Accessor& accessor ) const -> u32;
+    auto get_stride( const Accessor& accessor ) const -> u32;
+
+    auto decode_primitive( const Primitive& primitive, u8* const vertices, u32* const indices ) const -> bool;
+
+private:
+    std::unique_ptr<MappedFile>              file_;
+    std::vector<std::unique_ptr<MappedFile>> buffer_files_;
+    // Buffers embedded as data URIs, decoded from base64
+    std::vector<std::vector<u8>>             embedded_buffers_;
+    std::vector<std::span<const u8>>         buffers_;
+    std::vector<BufferView>                  buffer_views_;
+    std::vector<Accessor>                    accessors_;
+    std::vector<Primitive>                   primitives_;
+    // Node to world matrices, column major
+    std::vector<std::array<f32, 16>>         transforms_;
+    u32                                      vertex_count_;
+    u32                                      index_count_;
+};
+
+} // namespace mksv
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+namespace mksv
+{
+// 64-bit xxHash of size bytes. Stable across runs and platforms of the same endianness, so it can key data on disk.
+auto hash_bytes( const void* data, const usize size, const u64 seed = 0 ) -> u64;
+
+// Mixes value into seed, for hashing a sequence of hashes
+auto hash_combine( const u64 seed, const u64 value ) -> u64;
+} // namespace mksv
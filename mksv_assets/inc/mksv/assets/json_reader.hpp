@@ -0,0 +1,60 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace mksv
+{
+// Pull parser for JSON that reads values in document order without building a tree. The caller walks the document
+// with begin_object() / next_member() and begin_array() / next_element(), reads the values it wants and skips the
+// rest with skip_value().
+//
+// Errors are sticky: once the text turns out malformed every call returns false and has_error() is set. Separators are
+// checked loosely, so not every malformed document is rejected, but the reader never reads past the text.
+class JsonReader
+{
+public:
+    explicit JsonReader( const std::string_view text );
+
+public:
+    auto begin_object() -> bool;
+    // Reads the key of the next member, false once the object is closed
+    auto next_member( std::string_view& key ) -> bool;
+
+    auto begin_array() -> bool;
+    // False once the array is closed
+    auto next_element() -> bool;
+
+    // Keys and raw strings are returned as they appear in the text, escapes included
+    auto read_raw_string( std::string_view& value ) -> bool;
+    auto read_string( std::string& value ) -> bool;
+    auto read_number( f64& value ) -> bool;
+    // Fails for fractions, negative numbers and numbers that do not fit
+    auto read_u64( u64& value ) -> bool;
+    auto read_u32( u32& value ) -> bool;
+    auto read_bool( bool& value ) -> bool;
+    auto skip_value() -> bool;
+
+    auto has_error() const -> bool;
+
+private:
+    static inline constexpr u32 MAX_DEPTH = 256;
+
+    auto skip_whitespace() -> void;
+    // The number at the cursor, without consuming it
+    auto scan_number() -> std::string_view;
+    auto consume( const char c ) -> bool;
+    auto peek() const -> char;
+    auto fail() -> bool;
+
+    auto skip_value( const u32 depth ) -> bool;
+
+private:
+    std::string_view text_;
+    usize            position_;
+    bool             error_;
+};
+
+} // namespace mksv
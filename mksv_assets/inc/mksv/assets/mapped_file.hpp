@@ -0,0 +1,38 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace mksv
+{
+// Read-only view of a whole file mapped into memory. Pages are only read from disk when first touched, and stay
+// shared with the OS file cache instead of being copied into the process.
+class MappedFile
+{
+public:
+    static auto open( const std::filesystem::path& path ) -> std::unique_ptr<MappedFile>;
+
+public:
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile( MappedFile&& ) = delete;
+    auto operator=( const MappedFile& ) -> MappedFile& = delete;
+    auto operator=( MappedFile&& ) -> MappedFile& = delete;
+    ~MappedFile();
+
+public:
+    auto get_data() const -> std::span<const u8>;
+
+private:
+    MappedFile( void* const mapping, const u8* const data, const usize size );
+
+private:
+    // The file mapping object on Windows, unused elsewhere
+    void*     mapping_;
+    const u8* data_;
+    usize     size_;
+};
+
+} // namespace mksv
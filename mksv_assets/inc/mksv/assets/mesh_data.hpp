@@ -0,0 +1,31 @@
+#pragma once
+
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <filesystem>
+#include <vector>
+
+namespace mksv
+{
+// A mesh in memory, as built by importers and written by the cooker. vertices holds vertex_format vertices back to
+// back, submeshes have to cover the index stream in order.
+struct MeshData {
+    MeshVertexFormat         vertex_format;
+    std::vector<u8>          vertices;
+    std::vector<u32>         indices;
+    std::vector<MeshSubmesh> submeshes;
+    MeshBounds               bounds;
+};
+
+// Fills in the vertex ranges and bounds of the submeshes and the bounds of the whole mesh from the positions, which
+// have to be unquantized
+auto update_mesh_bounds( MeshData& mesh ) -> void;
+
+// Bytes per index in the serialized mesh, 2 for meshes with fewer than 65536 vertices and 4 otherwise
+auto get_mesh_index_size( const MeshData& mesh ) -> u32;
+
+auto serialize_mesh( const MeshData& mesh ) -> std::vector<u8>;
+[[nodiscard]] auto write_mesh( const std::filesystem::path& path, const MeshData& mesh ) -> bool;
+
+} // namespace mksv
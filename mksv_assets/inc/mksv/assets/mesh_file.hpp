@@ -0,0 +1,50 @@
+#pragma once
+
+#include "mksv/assets/mapped_file.hpp"
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace mksv
+{
+// A cooked mesh, mapped from disk. Opening checks the header and that every stream and submesh lies within the file,
+// the streams themselves are not read: the views point into the mapping and stay valid for as long as the MeshFile
+// lives, so they can be passed straight to the upload.
+class MeshFile
+{
+public:
+    static auto open( const std::filesystem::path& path ) -> std::unique_ptr<MeshFile>;
+
+public:
+    MeshFile( const MeshFile& ) = delete;
+    MeshFile( MeshFile&& ) = delete;
+    auto operator=( const MeshFile& ) -> MeshFile& = delete;
+    auto operator=( MeshFile&& ) -> MeshFile& = delete;
+    ~MeshFile() = default;
+
+public:
+    auto get_vertex_format() const -> MeshVertexFormat;
+    auto get_vertex_stride() const -> u32;
+    auto get_vertex_count() const -> u32;
+    auto get_index_size() const -> u32;
+    auto get_index_count() const -> u32;
+    auto get_bounds() const -> const MeshBounds&;
+
+    auto get_vertex_data() const -> std::span<const u8>;
+    auto get_index_data() const -> std::span<const u8>;
+    auto get_submeshes() const -> std::span<const MeshSubmesh>;
+
+private:
+    MeshFile( std::unique_ptr<MappedFile> file, const MeshHeader& header );
+
+    static auto validate( const std::span<const u8> data ) -> bool;
+
+private:
+    std::unique_ptr<MappedFile> file_;
+    MeshHeader                  header_;
+};
+
+} // namespace mksv
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+namespace mksv
+{
+// Layout of a cooked mesh file. Everything is little endian and addressed by offsets from the start of the file, so
+// the file can be mapped and its streams handed to the GPU upload as they are.
+//
+// The header is followed by the vertex stream, the index stream and the submesh table, each at MESH_STREAM_ALIGNMENT.
+// Submeshes are ranges of the index stream, their indices refer to the whole vertex stream.
+inline constexpr u32 MESH_FILE_MAGIC = 0x484D534D; // "MSMH"
+
+// Bump whenever the layout of any of the structs below or of a vertex format changes
+inline constexpr u32 MESH_FILE_VERSION = 1;
+
+inline constexpr u64 MESH_STREAM_ALIGNMENT = 64;
+
+enum class MeshVertexFormat : u32 {
+    // f32 position[3], f32 color[3]
+    PositionColor = 1,
+    // snorm16 position[4] within the mesh bounds, unorm8 color[4], see VertexLayout
+    PositionColorQuantized = 2,
+};
+
+// Axis aligned, an empty box has min above max
+struct MeshBounds {
+    f32 min[3];
+    f32 max[3];
+};
+
+struct MeshSubmesh {
+    u32        first_index;
+    u32        index_count;
+    // Range of the vertices the submesh's indices refer to
+    u32        first_vertex;
+    u32        vertex_count;
+    MeshBounds bounds;
+};
+
+struct MeshHeader {
+    u32              magic;
+    u32              version;
+    MeshVertexFormat vertex_format;
+    u32              vertex_stride;
+    u32              vertex_count;
+    u32              index_count;
+    // 2 or 4 bytes, the cooker writes 2 whenever the vertex count allows
+    u32              index_size;
+    u32              submesh_count;
+    MeshBounds       bounds;
+    u64              vertex_offset;
+    u64              index_offset;
+    u64              submesh_offset;
+    u64              file_size;
+};
+
+static_assert( sizeof( MeshBounds ) == 24 );
+static_assert( sizeof( MeshSubmesh ) == 40 );
+static_assert( sizeof( MeshHeader ) == 88 );
+
+// Size of one vertex in the given format, 0 for unknown formats
+auto get_vertex_stride( const MeshVertexFormat format ) -> u32;
+
+} // namespace mksv
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/common/types.hpp"
+
+#include <span>
+
+namespace mksv
+{
+// Offline reordering of triangle lists so that the GPU transforms fewer vertices, shades fewer hidden pixels and
+// fetches vertices in order. The index streams stay triangle lists of the same triangles, only their order and the
+// order of the vertices change.
+//
+// Every function takes indices that refer to vertices below vertex_count, positions are the leading f32[3] of every
+// vertex, so meshes are optimized before they are quantized.
+
+// Size of the simulated post-transform cache, a FIFO of this many vertices
+inline constexpr u32 VERTEX_CACHE_SIZE = 16;
+
+// How much worse than the vertex cache order a cluster may get when it is split up for overdraw sorting
+inline constexpr f32 OVERDRAW_THRESHOLD = 1.05f;
+
+struct VertexCacheStats {
+    // Average cache miss ratio, transformed vertices per triangle: 3 without any reuse, 0.5 at best on regular grids
+    f32 acmr;
+    // Average transform to vertex ratio, transformed vertices per referenced vertex: 1 at best
+    f32 atvr;
+};
+
+auto analyze_vertex_cache(
+    const std::span<const u32> indices,
+    const u32                  vertex_count,
+    const u32                  cache_size = VERTEX_CACHE_SIZE
+) -> VertexCacheStats;
+
+// Tipsify: fans around vertices that are still in the cache and jumps back to recent dead ends instead of restarting
+// from scratch, linear in the number of triangles
+auto optimize_vertex_cache(
+    const std::span<u32> indices,
+    const u32            vertex_count,
+    const u32            cache_size = VERTEX_CACHE_SIZE
+) -> void;
+
+// Splits a vertex cache optimized list into clusters at the points where the cache runs cold, or where that costs less
+// than threshold times the cluster's miss ratio, and sorts the clusters to face outward first so that they occlude the
+// ones behind them
+auto optimize_overdraw(
+    const std::span<u32>      indices,
+    const std::span<const u8> vertices,
+    const u32                 vertex_stride,
+    const f32                 threshold = OVERDRAW_THRESHOLD,
+    const u32                 cache_size = VERTEX_CACHE_SIZE
+) -> void;
+
+// Moves the vertices into the order the indices first refer to them and remaps the indices. Vertices no index refers
+// to end up past the returned vertex count.
+auto optimize_vertex_fetch( const std::span<u8> vertices, const u32 vertex_stride, const std::span<u32> indices )
+    -> u32;
+
+// Runs all of the above per submesh, drops unreferenced vertices and updates the vertex ranges and bounds
+auto optimize_mesh( MeshData& mesh ) -> void;
+
+} // namespace mksv
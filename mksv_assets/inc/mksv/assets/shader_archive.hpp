@@ -0,0 +1,90 @@
+#pragma once
+
+#include "mksv/assets/mapped_file.hpp"
+#include "mksv/common/types.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mksv
+{
+// Compiled shaders packed into a single file, looked up by name. The file is mapped and find() returns views into the
+// mapping, so loading the archive costs one mapping and no copies no matter how many shaders it holds.
+//
+// The file starts with a Header, followed by an open addressing hash table of Slots keyed by the xxHash of the name,
+// the names and the bytecode, each at DATA_ALIGNMENT. All offsets are relative to the start of the file and little
+// endian. open() checks that every slot stays within the file, so a corrupted archive is rejected up front.
+class ShaderArchive
+{
+public:
+    static inline constexpr u32 FILE_MAGIC = 0x4153534D; // "MSSA"
+    static inline constexpr u32 FILE_VERSION = 1;
+    static inline constexpr u64 DATA_ALIGNMENT = 16;
+
+    struct Header {
+        u32 magic;
+        u32 version;
+        u32 shader_count;
+        // Power of two, larger than shader_count so that every probe ends on an empty slot
+        u32 slot_count;
+        u64 slots_offset;
+        u64 file_size;
+    };
+
+    // Empty when name_size is zero
+    struct Slot {
+        u64 name_hash;
+        u64 data_offset;
+        u64 data_size;
+        u32 name_offset;
+        u32 name_size;
+    };
+
+public:
+    static auto open( const std::filesystem::path& path ) -> std::unique_ptr<ShaderArchive>;
+
+public:
+    ShaderArchive( const ShaderArchive& ) = delete;
+    ShaderArchive( ShaderArchive&& ) = delete;
+    auto operator=( const ShaderArchive& ) -> ShaderArchive& = delete;
+    auto operator=( ShaderArchive&& ) -> ShaderArchive& = delete;
+    ~ShaderArchive() = default;
+
+public:
+    // Empty if the archive holds no shader by that name. Views stay valid for as long as the archive lives.
+    auto find( const std::string_view name ) const -> std::span<const u8>;
+
+    auto get_shader_count() const -> u32;
+
+private:
+    ShaderArchive( std::unique_ptr<MappedFile> file, const Header& header, const Slot* const slots );
+
+    static auto validate( const std::span<const u8> data ) -> bool;
+
+private:
+    std::unique_ptr<MappedFile> file_;
+    Header                      header_;
+    const Slot*                 slots_;
+};
+
+// Builds the file read by ShaderArchive. The output only depends on the shaders added, not on their order.
+class ShaderArchiveWriter
+{
+public:
+    // Fails if name is empty or already taken
+    [[nodiscard]] auto add( const std::string_view name, const std::span<const u8> bytecode ) -> bool;
+
+    auto serialize() const -> std::vector<u8>;
+    [[nodiscard]] auto write( const std::filesystem::path& path ) const -> bool;
+
+private:
+    std::map<std::string, std::vector<u8>, std::less<>> shaders_;
+};
+
+} // namespace mksv
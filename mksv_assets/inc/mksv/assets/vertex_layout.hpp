@@ -0,0 +1,76 @@
+#pragma once
+
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <optional>
+
+namespace mksv
+{
+// How each attribute of a vertex is stored. Attributes are interleaved in the order of VertexAttribute, every one of
+// them a multiple of 4 bytes so that all stay aligned.
+//
+// All encodings reach the vertex shader as floats, the input assembler expands the normalized and half formats. Only
+// snorm16 positions, which are relative to the mesh bounds, and octahedral normals need decoding: the former by a
+// transform folded into the model matrix, the latter in the shader.
+//
+// No MeshVertexFormat has normals or UVs yet: the importers only produce positions and colors and the shaders do not
+// light or texture. Their encodings and encoders are there for the first format that does, until then quantize_mesh()
+// rejects layouts with them.
+enum class PositionEncoding : u32 {
+    // f32[3]
+    Float32,
+    // f16[4], w is 1
+    Half,
+    // snorm16[4] of ( position - bounds center ) / bounds half extent, w is 1
+    Snorm16,
+};
+
+enum class ColorEncoding : u32 {
+    // f32[3]
+    Float32,
+    // unorm8[4], alpha is 1
+    Unorm8,
+};
+
+enum class NormalEncoding : u32 {
+    None,
+    // f32[3]
+    Float32,
+    // snorm16[2], the unit normal mapped onto an octahedron unfolded into a square
+    Octahedral,
+};
+
+enum class UvEncoding : u32 {
+    None,
+    // f32[2]
+    Float32,
+    // f16[2]
+    Half,
+};
+
+enum class VertexAttribute : u32 {
+    Position,
+    Color,
+    Normal,
+    Uv,
+};
+
+inline constexpr u32 VERTEX_ATTRIBUTE_COUNT = 4;
+
+struct VertexLayout {
+    PositionEncoding position;
+    ColorEncoding    color;
+    NormalEncoding   normal;
+    UvEncoding       uv;
+};
+
+// Size in bytes, 0 for attributes the layout does not have
+auto get_attribute_size( const VertexLayout& layout, const VertexAttribute attribute ) -> u32;
+auto get_attribute_offset( const VertexLayout& layout, const VertexAttribute attribute ) -> u32;
+auto get_vertex_stride( const VertexLayout& layout ) -> u32;
+
+// nullopt for unknown formats
+auto get_vertex_layout( const MeshVertexFormat format ) -> std::optional<VertexLayout>;
+
+} // namespace mksv
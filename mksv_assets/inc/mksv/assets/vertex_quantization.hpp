@@ -0,0 +1,50 @@
+#pragma once
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <span>
+
+namespace mksv
+{
+// Encoders from f32 attributes to the quantized encodings of VertexLayout, and the quantization of whole meshes built
+// on them. Every kernel reads count elements starting at src, stride bytes apart, and writes them starting at dst,
+// dst_stride bytes apart, so they work on interleaved vertices and separate streams alike. The kernels use SSE2 where
+// available, the scalar code is the reference they match bit for bit for all inputs but NaNs.
+//
+// Rounding is to nearest, so a snorm16 position is off by about half extent / 65534 per axis, a half position by
+// 2^-11 of its magnitude and an unorm8 color by 1 / 510.
+auto encode_positions_half( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count )
+    -> void;
+auto encode_positions_snorm16(
+    const u8*         src,
+    const u32         stride,
+    u8*               dst,
+    const u32         dst_stride,
+    const u32         count,
+    const MeshBounds& bounds
+) -> void;
+auto encode_colors_unorm8( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count ) -> void;
+// The normals do not have to be normalized
+auto encode_normals_octahedral( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count )
+    -> void;
+auto encode_uvs_half( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count ) -> void;
+
+auto float_to_half( const f32 value ) -> u16;
+auto half_to_float( const u16 value ) -> f32;
+auto decode_octahedral( const i16 x, const i16 y, f32 ( &normal )[3] ) -> void;
+
+// Converts a MeshVertexFormat::PositionColor mesh to format in place, bounds have to be up to date. Fails for formats
+// other than PositionColor and PositionColorQuantized.
+[[nodiscard]] auto quantize_mesh( MeshData& mesh, const MeshVertexFormat format ) -> bool;
+
+// Decodes vertices of format back to MeshVertexFormat::PositionColor, output holds as many vertices as the input
+[[nodiscard]] auto dequantize_vertices(
+    const MeshVertexFormat    format,
+    const MeshBounds&         bounds,
+    const std::span<const u8> vertices,
+    const std::span<u8>       output
+) -> bool;
+
+} // namespace mksv
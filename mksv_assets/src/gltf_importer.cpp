@@ -0,0 +1,922 @@
+#include "mksv/assets/gltf_importer.hpp"
+
+#include "mksv/assets/json_reader.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 GLB_MAGIC = 0x46546C67;       // "glTF"
+constexpr u32 GLB_CHUNK_JSON = 0x4E4F534A;  // "JSON"
+constexpr u32 GLB_CHUNK_BINARY = 0x004E4942; // "BIN\0"
+constexpr u32 GLB_HEADER_SIZE = 12;
+constexpr u32 GLB_CHUNK_HEADER_SIZE = 8;
+
+constexpr u32 COMPONENT_BYTE = 5120;
+constexpr u32 COMPONENT_UNSIGNED_BYTE = 5121;
+constexpr u32 COMPONENT_SHORT = 5122;
+constexpr u32 COMPONENT_UNSIGNED_SHORT = 5123;
+constexpr u32 COMPONENT_UNSIGNED_INT = 5125;
+constexpr u32 COMPONENT_FLOAT = 5126;
+
+constexpr u32 MODE_TRIANGLES = 4;
+
+constexpr f32 MAX_BOUND = std::numeric_limits<f32>::max();
+
+// Column major, as glTF stores them
+using Matrix = std::array<f32, 16>;
+
+constexpr Matrix IDENTITY = {
+    1.0f, 0.0f, 0.0f, 0.0f, // x
+    0.0f, 1.0f, 0.0f, 0.0f, // y
+    0.0f, 0.0f, 1.0f, 0.0f, // z
+    0.0f, 0.0f, 0.0f, 1.0f, // translation
+};
+
+auto multiply( const Matrix& a, const Matrix& b ) -> Matrix
+{
+    Matrix result{};
+    for ( u32 column = 0; column < 4; ++column ) {
+        for ( u32 row = 0; row < 4; ++row ) {
+            f32 sum = 0.0f;
+            for ( u32 k = 0; k < 4; ++k ) {
+                sum += a[k * 4 + row] * b[column * 4 + k];
+            }
+            result[column * 4 + row] = sum;
+        }
+    }
+    return result;
+}
+
+// translation * rotation * scale, with the rotation as the unit quaternion x y z w
+auto compose(
+    const std::array<f32, 3>& translation,
+    const std::array<f32, 4>& rotation,
+    const std::array<f32, 3>& scale
+) -> Matrix
+{
+    const auto [x, y, z, w] = rotation;
+    return {
+        ( 1.0f - 2.0f * ( y * y + z * z ) ) * scale[0],
+        2.0f * ( x * y + z * w ) * scale[0],
+        2.0f * ( x * z - y * w ) * scale[0],
+        0.0f,
+        2.0f * ( x * y - z * w ) * scale[1],
+        ( 1.0f - 2.0f * ( x * x + z * z ) ) * scale[1],
+        2.0f * ( y * z + x * w ) * scale[1],
+        0.0f,
+        2.0f * ( x * z + y * w ) * scale[2],
+        2.0f * ( y * z - x * w ) * scale[2],
+        ( 1.0f - 2.0f * ( x * x + y * y ) ) * scale[2],
+        0.0f,
+        translation[0],
+        translation[1],
+        translation[2],
+        1.0f,
+    };
+}
+
+// A negative scale turns the triangles inside out, their winding has to be flipped to keep facing the same way
+auto is_mirroring( const Matrix& m ) -> bool
+{
+    const f32 determinant = m[0] * ( m[5] * m[10] - m[9] * m[6] ) - m[4] * ( m[1] * m[10] - m[9] * m[2] ) +
+                            m[8] * ( m[1] * m[6] - m[5] * m[2] );
+    return determinant < 0.0f;
+}
+
+auto read_u32( const u8* const data ) -> u32
+{
+    u32 value;
+    std::memcpy( &value, data, sizeof( value ) );
+    return value;
+}
+
+auto get_component_size( const u32 component_type ) -> u32
+{
+    switch ( component_type ) {
+        case COMPONENT_BYTE:
+        case COMPONENT_UNSIGNED_BYTE:
+            return 1;
+        case COMPONENT_SHORT:
+        case COMPONENT_UNSIGNED_SHORT:
+            return 2;
+        case COMPONENT_UNSIGNED_INT:
+        case COMPONENT_FLOAT:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+auto get_component_count( const std::string_view type ) -> u32
+{
+    if ( type == "SCALAR" ) {
+        return 1;
+    }
+    if ( type == "VEC2" ) {
+        return 2;
+    }
+    if ( type == "VEC3" ) {
+        return 3;
+    }
+    if ( type == "VEC4" || type == "MAT2" ) {
+        return 4;
+    }
+    if ( type == "MAT3" ) {
+        return 9;
+    }
+    if ( type == "MAT4" ) {
+        return 16;
+    }
+    return 0;
+}
+
+auto decode_base64( const std::string_view text, std::vector<u8>& out ) -> bool
+{
+    out.clear();
+    out.reserve( text.size() / 4 * 3 );
+
+    u32 bits = 0;
+    u32 bit_count = 0;
+    for ( const char c : text ) {
+        u32 value = 0;
+        if ( c >= 'A' && c <= 'Z' ) {
+            value = static_cast<u32>( c - 'A' );
+        } else if ( c >= 'a' && c <= 'z' ) {
+            value = static_cast<u32>( c - 'a' ) + 26;
+        } else if ( c >= '0' && c <= '9' ) {
+            value = static_cast<u32>( c - '0' ) + 52;
+        } else if ( c == '+' ) {
+            value = 62;
+        } else if ( c == '/' ) {
+            value = 63;
+        } else if ( c == '=' ) {
+            break;
+        } else {
+            return false;
+        }
+
+        bits = ( bits << 6 ) | value;
+        bit_count += 6;
+        if ( bit_count >= 8 ) {
+            bit_count -= 8;
+            out.push_back( static_cast<u8>( bits >> bit_count ) );
+        }
+    }
+
+    return true;
+}
+
+// URIs of external buffers are relative paths that may be percent encoded
+auto decode_uri( const std::string_view uri ) -> std::string
+{
+    std::string path;
+    path.reserve( uri.size() );
+
+    for ( usize i = 0; i < uri.size(); ++i ) {
+        u32 value = 0;
+        if ( uri[i] == '%' && i + 2 < uri.size() ) {
+            const auto [end, error] = std::from_chars( uri.data() + i + 1, uri.data() + i + 3, value, 16 );
+            if ( error == std::errc{} && end == uri.data() + i + 3 ) {
+                path += static_cast<char>( value );
+                i += 2;
+                continue;
+            }
+        }
+        path += uri[i];
+    }
+
+    return path;
+}
+
+auto read_normalized( const u8* const element, const u32 component_type, const u32 component ) -> f32
+{
+    switch ( component_type ) {
+        case COMPONENT_UNSIGNED_BYTE:
+            return static_cast<f32>( element[component] ) / 255.0f;
+        case COMPONENT_UNSIGNED_SHORT: {
+            u16 value;
+            std::memcpy( &value, element + component * sizeof( u16 ), sizeof( value ) );
+            return static_cast<f32>( value ) / 65535.0f;
+    }
+    default: {
+        f32 value;
+        std::memcpy( &value, element + component * sizeof( f32 ), sizeof( value ) );
+        return value;
+    }
+    }
+}
+
+auto read_index( const u8* const element, const u32 component_type ) -> u32
+{
+    switch ( component_type ) {
+        case COMPONENT_UNSIGNED_BYTE:
+            return element[0];
+        case COMPONENT_UNSIGNED_SHORT: {
+            u16 value;
+            std::memcpy( &value, element, sizeof( value ) );
+            return value;
+    }
+    default:
+        return read_u32( element );
+    }
+}
+} // namespace
+
+struct GltfImporter::Document {
+    struct Buffer {
+        std::string uri;
+        u64         size;
+    };
+
+    struct Node {
+        u32              mesh;
+        std::vector<u32> children;
+        Matrix           local;
+    };
+
+    std::vector<Buffer> buffers;
+    // BIN chunk of a .glb, backing the buffer without a URI
+    std::span<const u8> binary_chunk;
+    bool                has_version;
+
+    // The triangle primitives of all meshes, mesh i owns the range from mesh_first_primitive[i] up to the next one.
+    // Transforms are filled in by instantiate().
+    std::vector<Primitive>        mesh_primitives;
+    std::vector<u32>              mesh_first_primitive;
+    std::vector<Node>             nodes;
+    std::vector<std::vector<u32>> scenes;
+    u32                           scene = INVALID_INDEX;
+};
+
+auto GltfImporter::open( const std::filesystem::path& path ) -> std::unique_ptr<GltfImporter>
+{
+    auto file = MappedFile::open( path );
+    if ( !file ) {
+        return nullptr;
+    }
+
+    const std::span<const u8> data = file->get_data();
+
+    Document         document{};
+    std::string_view json{ reinterpret_cast<const char*>( data.data() ), data.size() };
+
+    if ( data.size() >= GLB_HEADER_SIZE && read_u32( data.data() ) == GLB_MAGIC ) {
+        if ( read_u32( data.data() + 4 ) != 2 || read_u32( data.data() + 8 ) > data.size() ) {
+            return nullptr;
+        }
+
+        // The JSON chunk comes first, an optional BIN chunk second and unknown chunks after that are ignored
+        u64 offset = GLB_HEADER_SIZE;
+        for ( u32 chunk = 0; chunk < 2 && offset + GLB_CHUNK_HEADER_SIZE <= data.size(); ++chunk ) {
+            const u64 size = read_u32( data.data() + offset );
+            const u32 type = read_u32( data.data() + offset + 4 );
+            offset += GLB_CHUNK_HEADER_SIZE;
+            if ( size > data.size() - offset ) {
+                return nullptr;
+            }
+
+            if ( chunk == 0 && type == GLB_CHUNK_JSON ) {
+                json = { reinterpret_cast<const char*>( data.data() + offset ), size };
+            } else if ( chunk == 1 && type == GLB_CHUNK_BINARY ) {
+                document.binary_chunk = data.subspan( offset, size );
+            } else if ( chunk == 0 ) {
+                return nullptr;
+            }
+            offset += size;
+        }
+    }
+
+    std::unique_ptr<GltfImporter> importer{ new GltfImporter( std::move( file ) ) };
+    if ( !importer->parse( json, document ) || !importer->instantiate( document ) ||
+         !importer->load_buffers( document, path.parent_path() ) || !importer->validate() ) {
+        return nullptr;
+    }
+
+    return importer;
+}
+
+GltfImporter::GltfImporter( std::unique_ptr<MappedFile> file )
+    : file_{ std::move( file ) },
+      vertex_count_{ 0 },
+      index_count_{ 0 }
+{
+}
+
+GltfImporter::~GltfImporter() = default;
+
+auto GltfImporter::parse( const std::string_view json, Document& document ) -> bool
+{
+    JsonReader       reader{ json };
+    std::string_view key;
+
+    const auto parse_buffer = [&] {
+        Document::Buffer buffer{ .uri = {}, .size = 0 };
+        reader.begin_object();
+        while ( reader.next_member( key ) ) {
+            if ( key == "uri" ) {
+                reader.read_string( buffer.uri );
+            } else if ( key == "byteLength" ) {
+                reader.read_u64( buffer.size );
+            } else {
+                reader.skip_value();
+            }
+        }
+        document.buffers.push_back( std::move( buffer ) );
+    };
+
+    const auto parse_buffer_view = [&] {
+        BufferView view{ .buffer = INVALID_INDEX, .offset = 0, .size = 0, .stride = 0 };
+        reader.begin_object();
+        while ( reader.next_member( key ) ) {
+            if ( key == "buffer" ) {
+                reader.read_u32( view.buffer );
+            } else if ( key == "byteOffset" ) {
+                reader.read_u64( view.offset );
+            } else if ( key == "byteLength" ) {
+                reader.read_u64( view.size );
+            } else if ( key == "byteStride" ) {
+                reader.read_u32( view.stride );
+            } else {
+                reader.skip_value();
+            }
+        }
+        buffer_views_.push_back( view );
+    };
+
+    const auto parse_accessor = [&] {
+        Accessor accessor{
+            .buffer_view = INVALID_INDEX,
+            .offset = 0,
+            .component_type = 0,
+            .component_count = 0,
+            .count = 0,
+            .normalized = false,
+            .sparse = false,
+        };
+        std::string_view type;
+
+        reader.begin_object();
+        while ( reader.next_member( key ) ) {
+            if ( key == "bufferView" ) {
+                reader.read_u32( accessor.buffer_view );
+            } else if ( key == "byteOffset" ) {
+                reader.read_u64( accessor.offset );
+            } else if ( key == "componentType" ) {
+                reader.read_u32( accessor.component_type );
+            } else if ( key == "normalized" ) {
+                reader.read_bool( accessor.normalized );
+            } else if ( key == "count" ) {
+                reader.read_u32( accessor.count );
+            } else if ( key == "type" ) {
+                reader.read_raw_string( type );
+            } else if ( key == "sparse" ) {
+                accessor.sparse = true;
+                reader.skip_value();
+            } else {
+                reader.skip_value();
+            }
+        }
+
+        accessor.component_count = get_component_count( type );
+        accessors_.push_back( accessor );
+    };
+
+    const auto parse_primitive = [&] {
+        Primitive primitive{
+            .positions = INVALID_INDEX,
+            .colors = INVALID_INDEX,
+            .indices = INVALID_INDEX,
+            .mode = MODE_TRIANGLES,
+            .first_vertex = 0,
+            .vertex_count = 0,
+            .first_index = 0,
+            .index_count = 0,
+            .transform = 0,
+        };
+
+        reader.begin_object();
+        while ( reader.next_member( key ) ) {
+            if ( key == "attributes" ) {
+                reader.begin_object();
+                while ( reader.next_member( key ) ) {
+                    if ( key == "POSITION" ) {
+                        reader.read_u32( primitive.positions );
+                    } else if ( key == "COLOR_0" ) {
+                        reader.read_u32( primitive.colors );
+                    } else {
+                        reader.skip_value();
+                    }
+                }
+            } else if ( key == "indices" ) {
+                reader.read_u32( primitive.indices );
+            } else if ( key == "mode" ) {
+                reader.read_u32( primitive.mode );
+            } else {
+                reader.skip_value();
+            }
+        }
+
+        if ( primitive.mode == MODE_TRIANGLES ) {
+            document.mesh_primitives.push_back( primitive );
+        }
+    };
+
+    const auto parse_mesh = [&] {
+        document.mesh_first_primitive.push_back( static_cast<u32>( document.mesh_primitives.size() ) );
+        reader.begin_object();
+        while ( reader.next_member( key ) ) {
+            if ( key == "primitives" ) {
+                reader.begin_array();
+                while ( reader.next_element() ) {
+                    parse_primitive();
+                }
+            } else {
+                reader.skip_value();
+            }
+        }
+    };
+
+    // Node indices of children and scenes
+    const auto read_indices = [&]( std::vector<u32>& indices ) {
+        reader.begin_array();
+        while ( reader.next_element() ) {
+            u32 index = INVALID_INDEX;
+            reader.read_u32( index );
+            indices.push_back( index );
+        }
+    };
+
+    // Fixed size arrays of numbers, a different size makes the document malformed
+    bool       malformed = false;
+    const auto read_numbers = [&]( const std::span<f32> values ) {
+        usize count = 0;
+        reader.begin_array();
+        while ( reader.next_element() ) {
+            f64 value = 0.0;
+            if ( count < values.size() && reader.read_number( value ) ) {
+                values[count] = static_cast<f32>( value );
+            } else {
+                reader.skip_value();
+            }
+            ++count;
+        }
+        malformed |= count != values.size();
+    };
+
+    const auto parse_node = [&] {
+        Document::Node     node{ .mesh = INVALID_INDEX, .children = {}, .local = IDENTITY };
+        std::array<f32, 3> translation = { 0.0f, 0.0f, 0.0f };
+        std::array<f32, 4> rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        std::array<f32, 3> scale = { 1.0f, 1.0f, 1.0f };
+        bool               has_matrix = false;
+
+        reader.begin_object();
+        while ( reader.next_member( key ) ) {
+            if ( key == "mesh" ) {
+                reader.read_u32( node.mesh );
+            } else if ( key == "children" ) {
+                read_indices( node.children );
+            } else if ( key == "matrix" ) {
+                read_numbers( node.local );
+                has_matrix = true;
+            } else if ( key == "translation" ) {
+                read_numbers( translation );
+            } else if ( key == "rotation" ) {
+                read_numbers( rotation );
+            } else if ( key == "scale" ) {
+                read_numbers( scale );
+            } else {
+                reader.skip_value();
+            }
+        }
+
+        if ( !has_matrix ) {
+            node.local = compose( translation, rotation, scale );
+        }
+        document.nodes.push_back( std::move( node ) );
+    };
+
+    const auto parse_scene = [&] {
+        std::vector<u32>& nodes = document.scenes.emplace_back();
+        reader.begin_object();
+        while ( reader.next_member( key ) ) {
+            if ( key == "nodes" ) {
+                read_indices( nodes );
+            } else {
+                reader.skip_value();
+            }
+        }
+    };
+
+    const auto parse_array = [&]( const auto& parse_element ) {
+        reader.begin_array();
+        while ( reader.next_element() ) {
+            parse_element();
+        }
+    };
+
+    reader.begin_object();
+    while ( reader.next_member( key ) ) {
+        if ( key == "asset" ) {
+            reader.begin_object();
+            while ( reader.next_member( key ) ) {
+                std::string_view version;
+                if ( key == "version" && reader.read_raw_string( version ) ) {
+                    document.has_version = version.starts_with( "2." );
+                } else if ( key != "version" ) {
+                    reader.skip_value();
+                }
+            }
+        } else if ( key == "buffers" ) {
+            parse_array( parse_buffer );
+        } else if ( key == "bufferViews" ) {
+            parse_array( parse_buffer_view );
+        } else if ( key == "accessors" ) {
+            parse_array( parse_accessor );
+        } else if ( key == "meshes" ) {
+            parse_array( parse_mesh );
+        } else if ( key == "nodes" ) {
+            parse_array( parse_node );
+        } else if ( key == "scenes" ) {
+            parse_array( parse_scene );
+        } else if ( key == "scene" ) {
+            reader.read_u32( document.scene );
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    document.mesh_first_primitive.push_back( static_cast<u32>( document.mesh_primitives.size() ) );
+    return !reader.has_error() && !malformed && document.has_version;
+}
+
+auto GltfImporter::instantiate( const Document& document ) -> bool
+{
+    const u32 mesh_count = static_cast<u32>( document.mesh_first_primitive.size() ) - 1;
+
+    const auto add_mesh = [&]( const u32 mesh, const Matrix& transform ) {
+        const u32 transform_index = static_cast<u32>( transforms_.size() );
+        transforms_.push_back( transform );
+
+        for ( u32 i = document.mesh_first_primitive[mesh]; i < document.mesh_first_primitive[mesh + 1]; ++i ) {
+            Primitive& primitive = primitives_.emplace_back( document.mesh_primitives[i] );
+            primitive.transform = transform_index;
+        }
+    };
+
+    if ( document.nodes.empty() ) {
+        for ( u32 mesh = 0; mesh < mesh_count; ++mesh ) {
+            add_mesh( mesh, IDENTITY );
+        }
+        return true;
+    }
+
+    std::vector<u32> roots;
+    if ( !document.scenes.empty() ) {
+        const u32 scene = document.scene != INVALID_INDEX ? document.scene : 0;
+        if ( scene >= document.scenes.size() ) {
+            return false;
+        }
+        roots = document.scenes[scene];
+    } else {
+        std::vector<bool> is_child( document.nodes.size(), false );
+        for ( const Document::Node& node : document.nodes ) {
+            for ( const u32 child : node.children ) {
+                if ( child < is_child.size() ) {
+                    is_child[child] = true;
+                }
+            }
+        }
+        for ( u32 node = 0; node < document.nodes.size(); ++node ) {
+            if ( !is_child[node] ) {
+                roots.push_back( node );
+            }
+        }
+    }
+
+    struct PendingNode {
+        u32    node;
+        Matrix parent;
+    };
+
+    // Depth first in document order. Nodes have at most one parent, so reaching one twice means the file is malformed
+    // and may contain a cycle.
+    std::vector<bool>        visited( document.nodes.size(), false );
+    std::vector<PendingNode> pending;
+    for ( auto root = roots.rbegin(); root != roots.rend(); ++root ) {
+        pending.push_back( { .node = *root, .parent = IDENTITY } );
+    }
+
+    while ( !pending.empty() ) {
+        const PendingNode current = pending.back();
+        pending.pop_back();
+        if ( current.node >= document.nodes.size() || visited[current.node] ) {
+            return false;
+        }
+        visited[current.node] = true;
+
+        const Document::Node& node = document.nodes[current.node];
+        const Matrix          world = multiply( current.parent, node.local );
+        if ( node.mesh != INVALID_INDEX ) {
+            if ( node.mesh >= mesh_count ) {
+                return false;
+            }
+            add_mesh( node.mesh, world );
+        }
+
+        for ( auto child = node.children.rbegin(); child != node.children.rend(); ++child ) {
+            pending.push_back( { .node = *child, .parent = world } );
+        }
+    }
+
+    return true;
+}
+
+auto GltfImporter::load_buffers( const Document& document, const std::filesystem::path& directory ) -> bool
+{
+    static constexpr std::string_view DATA_PREFIX = "data:";
+    static constexpr std::string_view BASE64_MARKER = ";base64,";
+
+    for ( const Document::Buffer& buffer : document.buffers ) {
+        std::span<const u8> data;
+
+        if ( buffer.uri.empty() ) {
+            data = document.binary_chunk;
+        } else if ( buffer.uri.starts_with( DATA_PREFIX ) ) {
+            const usize marker = buffer.uri.find( BASE64_MARKER );
+            if ( marker == std::string::npos ) {
+                return false;
+            }
+
+            std::vector<u8>& decoded = embedded_buffers_.emplace_back();
+            if ( !decode_base64( std::string_view{ buffer.uri }.substr( marker + BASE64_MARKER.size() ), decoded ) ) {
+                return false;
+            }
+            data = decoded;
+        } else {
+            const std::string uri = decode_uri( buffer.uri );
+            const auto        relative = std::u8string_view{
+                reinterpret_cast<const char8_t*>( uri.data() ),
+                uri.size(),
+            };
+
+            auto& mapped = buffer_files_.emplace_back( MappedFile::open( directory / relative ) );
+            if ( !mapped ) {
+                return false;
+            }
+            data = mapped->get_data();
+        }
+
+        // Buffers may be padded past their byteLength, never shorter
+        if ( data.size() < buffer.size ) {
+            return false;
+        }
+        buffers_.push_back( data.first( buffer.size ) );
+    }
+
+    return true;
+}
+
+auto GltfImporter::validate() -> bool
+{
+    for ( const BufferView& view : buffer_views_ ) {
+        if ( view.buffer >= buffers_.size() || view.offset > buffers_[view.buffer].size() ||
+             view.size > buffers_[view.buffer].size() - view.offset ) {
+            return false;
+        }
+    }
+
+    for ( const Accessor& accessor : accessors_ ) {
+        const u32 element_size = get_element_size( accessor );
+        if ( element_size == 0 || accessor.sparse ) {
+            return false;
+        }
+
+        if ( accessor.buffer_view == INVALID_INDEX || accessor.count == 0 ) {
+            continue;
+        }
+
+        if ( accessor.buffer_view >= buffer_views_.size() ) {
+            return false;
+        }
+
+        const BufferView& view = buffer_views_[accessor.buffer_view];
+        const u32         stride = get_stride( accessor );
+        const u64         last_element = accessor.offset + u64{ stride } * ( accessor.count - 1 );
+        if ( stride < element_size || last_element > view.size || element_size > view.size - last_element ) {
+            return false;
+        }
+    }
+
+    u64 vertex_count = 0;
+    u64 index_count = 0;
+    for ( Primitive& primitive : primitives_ ) {
+        if ( primitive.positions >= accessors_.size() ) {
+            return false;
+        }
+
+        const Accessor& positions = accessors_[primitive.positions];
+        if ( positions.component_type != COMPONENT_FLOAT || positions.component_count != 3 ) {
+            return false;
+        }
+
+        if ( primitive.colors != INVALID_INDEX ) {
+            if ( primitive.colors >= accessors_.size() ) {
+                return false;
+            }
+
+            const Accessor& colors = accessors_[primitive.colors];
+            const bool      is_float = colors.component_type == COMPONENT_FLOAT;
+            const bool      is_unorm = colors.normalized && ( colors.component_type == COMPONENT_UNSIGNED_BYTE ||
+                                                         colors.component_type == COMPONENT_UNSIGNED_SHORT );
+            if ( ( !is_float && !is_unorm ) || colors.component_count < 3 || colors.component_count > 4 ||
+                 colors.count != positions.count ) {
+                return false;
+            }
+        }
+
+        u32 primitive_index_count = positions.count;
+        if ( primitive.indices != INVALID_INDEX ) {
+            if ( primitive.indices >= accessors_.size() ) {
+                return false;
+            }
+
+            const Accessor& indices = accessors_[primitive.indices];
+            if ( indices.component_count != 1 || ( indices.component_type != COMPONENT_UNSIGNED_BYTE &&
+                                                   indices.component_type != COMPONENT_UNSIGNED_SHORT &&
+                                                   indices.component_type != COMPONENT_UNSIGNED_INT ) ) {
+                return false;
+            }
+            primitive_index_count = indices.count;
+        }
+
+        // Trailing indices that do not form a whole triangle are dropped
+        primitive.first_vertex = static_cast<u32>( vertex_count );
+        primitive.vertex_count = positions.count;
+        primitive.first_index = static_cast<u32>( index_count );
+        primitive.index_count = primitive_index_count - primitive_index_count % 3;
+
+        vertex_count += primitive.vertex_count;
+        index_count += primitive.index_count;
+        if ( vertex_count > std::numeric_limits<u32>::max() || index_count > std::numeric_limits<u32>::max() ) {
+            return false;
+        }
+    }
+
+    vertex_count_ = static_cast<u32>( vertex_count );
+    index_count_ = static_cast<u32>( index_count );
+    return true;
+}
+
+auto GltfImporter::get_vertex_count() const -> u32
+{
+    return vertex_count_;
+}
+
+auto GltfImporter::get_index_count() const -> u32
+{
+    return index_count_;
+}
+
+auto GltfImporter::get_submesh_count() const -> u32
+{
+    return static_cast<u32>( primitives_.size() );
+}
+
+auto GltfImporter::decode(
+    JobSystem&                   jobs,
+    const std::span<u8>          vertices,
+    const std::span<u32>         indices,
+    const std::span<MeshSubmesh> submeshes
+) const -> bool
+{
+    const u32 stride = get_vertex_stride( MeshVertexFormat::PositionColor );
+    if ( vertices.size() < u64{ vertex_count_ } * stride || indices.size() < index_count_ ||
+         submeshes.size() < primitives_.size() ) {
+        return false;
+    }
+
+    // Every primitive writes its own ranges of the output, which were laid out by validate()
+    std::atomic<bool> failed = false;
+    jobs.parallel_for( static_cast<u32>( primitives_.size() ), 1, [&]( const u32 first, const u32 count ) {
+        for ( u32 i = first; i < first + count; ++i ) {
+            const Primitive& primitive = primitives_[i];
+
+            MeshSubmesh& submesh = submeshes[i];
+            submesh = {
+                .first_index = primitive.first_index,
+                .index_count = primitive.index_count,
+                .first_vertex = primitive.first_vertex,
+                .vertex_count = primitive.vertex_count,
+                .bounds = { .min = { MAX_BOUND, MAX_BOUND, MAX_BOUND }, .max = { -MAX_BOUND, -MAX_BOUND, -MAX_BOUND } },
+            };
+
+            u8* const  primitive_vertices = vertices.data() + u64{ primitive.first_vertex } * stride;
+            u32* const primitive_indices = indices.data() + primitive.first_index;
+            if ( !decode_primitive( primitive, primitive_vertices, primitive_indices ) ) {
+                failed.store( true, std::memory_order_relaxed );
+                continue;
+            }
+
+            for ( u32 v = 0; v < primitive.vertex_count; ++v ) {
+                f32 position[3];
+                std::memcpy( position, primitive_vertices + u64{ v } * stride, sizeof( position ) );
+                for ( u32 axis = 0; axis < 3; ++axis ) {
+                    submesh.bounds.min[axis] = std::min( submesh.bounds.min[axis], position[axis] );
+                    submesh.bounds.max[axis] = std::max( submesh.bounds.max[axis], position[axis] );
+                }
+            }
+        }
+    } );
+
+    return !failed.load();
+}
+
+auto GltfImporter::decode_primitive( const Primitive& primitive, u8* const vertices, u32* const indices ) const
+    -> bool
+{
+    const u32       stride = get_vertex_stride( MeshVertexFormat::PositionColor );
+    const Accessor& positions = accessors_[primitive.positions];
+    const Accessor* colors = primitive.colors != INVALID_INDEX ? &accessors_[primitive.colors] : nullptr;
+    const Matrix&   m = transforms_[primitive.transform];
+
+    for ( u32 v = 0; v < primitive.vertex_count; ++v ) {
+        f32 vertex[6] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+
+        // Accessors without a buffer view are all zeros
+        f32 position[3] = { 0.0f, 0.0f, 0.0f };
+        if ( const u8* const element = get_element( positions, v ) ) {
+            std::memcpy( position, element, sizeof( position ) );
+        }
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            vertex[axis] = m[axis] * position[0] + m[4 + axis] * position[1] + m[8 + axis] * position[2] + m[12 + axis];
+        }
+
+        if ( colors ) {
+            const u8* const color = get_element( *colors, v );
+            for ( u32 component = 0; component < 3; ++component ) {
+                vertex[3 + component] = color ? read_normalized( color, colors->component_type, component ) : 0.0f;
+            }
+        }
+
+        std::memcpy( vertices + u64{ v } * stride, vertex, sizeof( vertex ) );
+    }
+
+    if ( primitive.indices == INVALID_INDEX ) {
+        for ( u32 i = 0; i < primitive.index_count; ++i ) {
+            indices[i] = primitive.first_vertex + i;
+        }
+    } else {
+        const Accessor& index_accessor = accessors_[primitive.indices];
+        for ( u32 i = 0; i < primitive.index_count; ++i ) {
+            const u8* const element = get_element( index_accessor, i );
+            const u32       index = element ? read_index( element, index_accessor.component_type ) : 0;
+            if ( index >= primitive.vertex_count ) {
+                return false;
+            }
+            indices[i] = primitive.first_vertex + index;
+        }
+    }
+
+    if ( is_mirroring( m ) ) {
+        for ( u32 i = 0; i < primitive.index_count; i += 3 ) {
+            std::swap( indices[i + 1], indices[i + 2] );
+        }
+    }
+
+    return true;
+}
+
+auto GltfImporter::get_element( const Accessor& accessor, const u32 index ) const -> const u8*
+{
+    if ( accessor.buffer_view == INVALID_INDEX ) {
+        return nullptr;
+    }
+
+    const BufferView& view = buffer_views_[accessor.buffer_view];
+    return buffers_[view.buffer].data() + view.offset + accessor.offset + u64{ get_stride( accessor ) } * index;
+}
+
+auto GltfImporter::get_element_size( const Accessor& accessor ) const -> u32
+{
+    return get_component_size( accessor.component_type ) * accessor.component_count;
+}
+
+auto GltfImporter::get_stride( const Accessor& accessor ) const -> u32
+{
+    const u32 view_stride = accessor.buffer_view != INVALID_INDEX ? buffer_views_[accessor.buffer_view].stride : 0;
+    return view_stride != 0 ? view_stride : get_element_size( accessor );
+}
+
+} // namespace mksv
@@ -0,0 +1,103 @@
+#include "mksv/assets/hash.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace mksv
+{
+namespace
+{
+constexpr u64 PRIME_1 = 0x9E3779B185EBCA87ull;
+constexpr u64 PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr u64 PRIME_3 = 0x165667B19E3779F9ull;
+constexpr u64 PRIME_4 = 0x85EBCA77C2B2AE63ull;
+constexpr u64 PRIME_5 = 0x27D4EB2F165667C5ull;
+
+auto read_u64( const u8* p ) -> u64
+{
+    u64 value;
+    std::memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+auto read_u32( const u8* p ) -> u32
+{
+    u32 value;
+    std::memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+auto round( u64 acc, const u64 input ) -> u64
+{
+    acc += input * PRIME_2;
+    acc = std::rotl( acc, 31 );
+    return acc * PRIME_1;
+}
+
+auto merge_round( u64 acc, const u64 value ) -> u64
+{
+    acc ^= round( 0, value );
+    return acc * PRIME_1 + PRIME_4;
+}
+} // namespace
+
+auto hash_bytes( const void* data, const usize size, const u64 seed ) -> u64
+{
+    const u8*       p = static_cast<const u8*>( data );
+    const u8* const end = p + size;
+
+    u64 h = 0;
+    if ( size >= 32 ) {
+        u64 v1 = seed + PRIME_1 + PRIME_2;
+        u64 v2 = seed + PRIME_2;
+        u64 v3 = seed;
+        u64 v4 = seed - PRIME_1;
+
+        for ( const u8* const limit = end - 32; p <= limit; p += 32 ) {
+            v1 = round( v1, read_u64( p ) );
+            v2 = round( v2, read_u64( p + 8 ) );
+            v3 = round( v3, read_u64( p + 16 ) );
+            v4 = round( v4, read_u64( p + 24 ) );
+        }
+
+        h = std::rotl( v1, 1 ) + std::rotl( v2, 7 ) + std::rotl( v3, 12 ) + std::rotl( v4, 18 );
+        h = merge_round( h, v1 );
+        h = merge_round( h, v2 );
+        h = merge_round( h, v3 );
+        h = merge_round( h, v4 );
+    } else {
+        h = seed + PRIME_5;
+    }
+
+    h += static_cast<u64>( size );
+
+    for ( ; p + 8 <= end; p += 8 ) {
+        h ^= round( 0, read_u64( p ) );
+        h = std::rotl( h, 27 ) * PRIME_1 + PRIME_4;
+    }
+
+    if ( p + 4 <= end ) {
+        h ^= static_cast<u64>( read_u32( p ) ) * PRIME_1;
+        h = std::rotl( h, 23 ) * PRIME_2 + PRIME_3;
+        p += 4;
+    }
+
+    for ( ; p < end; ++p ) {
+        h ^= static_cast<u64>( *p ) * PRIME_5;
+        h = std::rotl( h, 11 ) * PRIME_1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME_2;
+    h ^= h >> 29;
+    h *= PRIME_3;
+    h ^= h >> 32;
+    return h;
+}
+
+auto hash_combine( const u64 seed, const u64 value ) -> u64
+{
+    return hash_bytes( &value, sizeof( value ), seed );
+}
+
+} // namespace mksv
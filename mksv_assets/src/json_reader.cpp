@@ -0,0 +1,347 @@
+#include "mksv/assets/json_reader.hpp"
+
+#include <charconv>
+#include <limits>
+
+namespace mksv
+{
+namespace
+{
+auto is_number_char( const char c ) -> bool
+{
+    return ( c >= '0' && c <= '9' ) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+auto parse_hex( const std::string_view digits, u32& value ) -> bool
+{
+    const auto [end, error] = std::from_chars( digits.data(), digits.data() + digits.size(), value, 16 );
+    return error == std::errc{} && end == digits.data() + digits.size();
+}
+
+auto append_utf8( std::string& out, const u32 code_point ) -> void
+{
+    if ( code_point < 0x80 ) {
+        out += static_cast<char>( code_point );
+    } else if ( code_point < 0x800 ) {
+        out += static_cast<char>( 0xC0 | ( code_point >> 6 ) );
+        out += static_cast<char>( 0x80 | ( code_point & 0x3F ) );
+    } else if ( code_point < 0x10000 ) {
+        out += static_cast<char>( 0xE0 | ( code_point >> 12 ) );
+        out += static_cast<char>( 0x80 | ( ( code_point >> 6 ) & 0x3F ) );
+        out += static_cast<char>( 0x80 | ( code_point & 0x3F ) );
+    } else {
+        out += static_cast<char>( 0xF0 | ( code_point >> 18 ) );
+        out += static_cast<char>( 0x80 | ( ( code_point >> 12 ) & 0x3F ) );
+        out += static_cast<char>( 0x80 | ( ( code_point >> 6 ) & 0x3F ) );
+        out += static_cast<char>( 0x80 | ( code_point & 0x3F ) );
+    }
+}
+} // namespace
+
+JsonReader::JsonReader( const std::string_view text )
+    : text_{ text },
+      position_{ 0 },
+      error_{ false }
+{
+}
+
+auto JsonReader::begin_object() -> bool
+{
+    skip_whitespace();
+    return consume( '{' ) || fail();
+}
+
+auto JsonReader::next_member( std::string_view& key ) -> bool
+{
+    if ( error_ ) {
+        return false;
+    }
+
+    skip_whitespace();
+    if ( consume( ',' ) ) {
+        skip_whitespace();
+    }
+
+    if ( consume( '}' ) ) {
+        return false;
+    }
+
+    if ( !read_raw_string( key ) ) {
+        return false;
+    }
+
+    skip_whitespace();
+    return consume( ':' ) || fail();
+}
+
+auto JsonReader::begin_array() -> bool
+{
+    skip_whitespace();
+    return consume( '[' ) || fail();
+}
+
+auto JsonReader::next_element() -> bool
+{
+    if ( error_ ) {
+        return false;
+    }
+
+    skip_whitespace();
+    if ( consume( ',' ) ) {
+        skip_whitespace();
+    }
+
+    if ( consume( ']' ) ) {
+        return false;
+    }
+
+    return position_ < text_.size() || fail();
+}
+
+auto JsonReader::read_raw_string( std::string_view& value ) -> bool
+{
+    skip_whitespace();
+    if ( error_ || !consume( '"' ) ) {
+        return fail();
+    }
+
+    const usize start = position_;
+    while ( position_ < text_.size() && text_[position_] != '"' ) {
+        // The escaped character may be a quote
+        position_ += text_[position_] == '\\' ? 2 : 1;
+    }
+
+    if ( position_ >= text_.size() ) {
+        return fail();
+    }
+
+    value = text_.substr( start, position_ - start );
+    ++position_;
+    return true;
+}
+
+auto JsonReader::read_string( std::string& value ) -> bool
+{
+    std::string_view raw;
+    if ( !read_raw_string( raw ) ) {
+        return false;
+    }
+
+    value.clear();
+    value.reserve( raw.size() );
+    for ( usize i = 0; i < raw.size(); ++i ) {
+        if ( raw[i] != '\\' ) {
+            value += raw[i];
+            continue;
+        }
+
+        // read_raw_string() never ends a string on a backslash
+        switch ( raw[++i] ) {
+            case 'b':
+                value += '\b';
+                break;
+            case 'f':
+                value += '\f';
+                break;
+            case 'n':
+                value += '\n';
+                break;
+            case 'r':
+                value += '\r';
+                break;
+            case 't':
+                value += '\t';
+                break;
+            case 'u': {
+                u32 code_point = 0;
+                if ( i + 4 >= raw.size() || !parse_hex( raw.substr( i + 1, 4 ), code_point ) ) {
+                    return fail();
+                }
+                i += 4;
+
+                // Characters outside the basic plane come as a surrogate pair
+                u32 low = 0;
+                if ( code_point >= 0xD800 && code_point < 0xDC00 && i + 6 < raw.size() && raw[i + 1] == '\\' &&
+                     raw[i + 2] == 'u' && parse_hex( raw.substr( i + 3, 4 ), low ) && low >= 0xDC00 && low < 0xE000 ) {
+                    code_point = 0x10000 + ( ( code_point - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                    i += 6;
+                }
+
+                append_utf8( value, code_point );
+                break;
+        }
+        default:
+            value += raw[i];
+            break;
+        }
+    }
+
+    return true;
+}
+
+auto JsonReader::read_number( f64& value ) -> bool
+{
+    const std::string_view token = scan_number();
+
+    const auto [end, error] = std::from_chars( token.data(), token.data() + token.size(), value );
+    if ( token.empty() || error != std::errc{} || end != token.data() + token.size() ) {
+        return fail();
+    }
+
+    position_ += token.size();
+    return true;
+}
+
+auto JsonReader::read_u64( u64& value ) -> bool
+{
+    const std::string_view token = scan_number();
+
+    const auto [end, error] = std::from_chars( token.data(), token.data() + token.size(), value );
+    if ( token.empty() || error != std::errc{} || end != token.data() + token.size() ) {
+        return fail();
+    }
+
+    position_ += token.size();
+    return true;
+}
+
+auto JsonReader::read_u32( u32& value ) -> bool
+{
+    u64 wide = 0;
+    if ( !read_u64( wide ) ) {
+        return false;
+    }
+
+    if ( wide > std::numeric_limits<u32>::max() ) {
+        return fail();
+    }
+
+    value = static_cast<u32>( wide );
+    return true;
+}
+
+auto JsonReader::read_bool( bool& value ) -> bool
+{
+    skip_whitespace();
+    if ( error_ ) {
+        return false;
+    }
+
+    const std::string_view rest = text_.substr( position_ );
+    if ( rest.starts_with( "true" ) ) {
+        value = true;
+        position_ += 4;
+        return true;
+    }
+
+    if ( rest.starts_with( "false" ) ) {
+        value = false;
+        position_ += 5;
+        return true;
+    }
+
+    return fail();
+}
+
+auto JsonReader::skip_value() -> bool
+{
+    return skip_value( 0 );
+}
+
+auto JsonReader::skip_value( const u32 depth ) -> bool
+{
+    skip_whitespace();
+    if ( error_ || depth > MAX_DEPTH ) {
+        return fail();
+    }
+
+    std::string_view key;
+    switch ( peek() ) {
+        case '{':
+            begin_object();
+            while ( next_member( key ) ) {
+                if ( !skip_value( depth + 1 ) ) {
+                    return false;
+                }
+            }
+            return !error_;
+        case '[':
+            begin_array();
+            while ( next_element() ) {
+                if ( !skip_value( depth + 1 ) ) {
+                    return false;
+                }
+            }
+            return !error_;
+        case '"':
+            return read_raw_string( key );
+        case 't':
+        case 'f': {
+            bool value = false;
+            return read_bool( value );
+    }
+    case 'n':
+        if ( !text_.substr( position_ ).starts_with( "null" ) ) {
+            return fail();
+        }
+        position_ += 4;
+        return true;
+    default: {
+        f64 value = 0.0;
+        return read_number( value );
+    }
+    }
+}
+
+auto JsonReader::has_error() const -> bool
+{
+    return error_;
+}
+
+auto JsonReader::skip_whitespace() -> void
+{
+    while ( position_ < text_.size() ) {
+        const char c = text_[position_];
+        if ( c != ' ' && c != '\t' && c != '\n' && c != '\r' ) {
+            return;
+        }
+        ++position_;
+    }
+}
+
+auto JsonReader::scan_number() -> std::string_view
+{
+    skip_whitespace();
+    if ( error_ ) {
+        return {};
+    }
+
+    usize end = position_;
+    while ( end < text_.size() && is_number_char( text_[end] ) ) {
+        ++end;
+    }
+
+    return text_.substr( position_, end - position_ );
+}
+
+auto JsonReader::consume( const char c ) -> bool
+{
+    if ( position_ < text_.size() && text_[position_] == c ) {
+        ++position_;
+        return true;
+    }
+    return false;
+}
+
+auto JsonReader::peek() const -> char
+{
+    return position_ < text_.size() ? text_[position_] : '\0';
+}
+
+auto JsonReader::fail() -> bool
+{
+    error_ = true;
+    return false;
+}
+
+} // namespace mksv
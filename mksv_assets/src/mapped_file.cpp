@@ -0,0 +1,116 @@
+#include "mksv/assets/mapped_file.hpp"
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mksv
+{
+
+auto MappedFile::open( const std::filesystem::path& path ) -> std::unique_ptr<MappedFile>
+{
+#if defined( _WIN32 )
+    const HANDLE file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if ( file == INVALID_HANDLE_VALUE ) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER size{};
+    if ( !GetFileSizeEx( file, &size ) ) {
+        CloseHandle( file );
+        return nullptr;
+    }
+
+    // Empty files cannot be mapped
+    if ( size.QuadPart == 0 ) {
+        CloseHandle( file );
+        return std::unique_ptr<MappedFile>{ new MappedFile( nullptr, nullptr, 0 ) };
+    }
+
+    // The mapping keeps the file open on its own
+    const HANDLE mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    CloseHandle( file );
+    if ( !mapping ) {
+        return nullptr;
+    }
+
+    const void* const data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    if ( !data ) {
+        CloseHandle( mapping );
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedFile>{
+        new MappedFile( mapping, static_cast<const u8*>( data ), static_cast<usize>( size.QuadPart ) )
+    };
+#else
+    const int file = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( file < 0 ) {
+        return nullptr;
+    }
+
+    struct stat status{};
+    if ( fstat( file, &status ) != 0 ) {
+        close( file );
+        return nullptr;
+    }
+
+    const usize size = static_cast<usize>( status.st_size );
+    if ( size == 0 ) {
+        close( file );
+        return std::unique_ptr<MappedFile>{ new MappedFile( nullptr, nullptr, 0 ) };
+    }
+
+    // The mapping keeps the file open on its own
+    void* const data = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, file, 0 );
+    close( file );
+    if ( data == MAP_FAILED ) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedFile>{ new MappedFile( nullptr, static_cast<const u8*>( data ), size ) };
+#endif
+}
+
+MappedFile::MappedFile( void* const mapping, const u8* const data, const usize size )
+    : mapping_{ mapping },
+      data_{ data },
+      size_{ size }
+{
+}
+
+MappedFile::~MappedFile()
+{
+    if ( !data_ ) {
+        return;
+    }
+
+#if defined( _WIN32 )
+    UnmapViewOfFile( data_ );
+    CloseHandle( mapping_ );
+#else
+    munmap( const_cast<u8*>( data_ ), size_ );
+#endif
+}
+
+auto MappedFile::get_data() const -> std::span<const u8>
+{
+    return { data_, size_ };
+}
+
+} // namespace mksv
@@ -0,0 +1,140 @@
+#include "mksv/assets/mesh_data.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace mksv
+{
+namespace
+{
+constexpr auto align_up( const u64 value, const u64 alignment ) -> u64
+{
+    return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+constexpr f32 MAX = std::numeric_limits<f32>::max();
+
+constexpr MeshBounds EMPTY_BOUNDS = {
+    .min = { MAX, MAX, MAX },
+    .max = { -MAX, -MAX, -MAX },
+};
+
+// Unquantized vertex formats start with an f32 position
+auto grow_bounds( MeshBounds& bounds, const u8* const vertex ) -> void
+{
+    f32 position[3];
+    std::memcpy( position, vertex, sizeof( position ) );
+
+    for ( u32 axis = 0; axis < 3; ++axis ) {
+        bounds.min[axis] = std::min( bounds.min[axis], position[axis] );
+        bounds.max[axis] = std::max( bounds.max[axis], position[axis] );
+    }
+}
+
+// Empty streams may come with a null source
+auto copy_stream( std::vector<u8>& output, const u64 offset, const void* const data, const u64 size ) -> void
+{
+    if ( size > 0 ) {
+        std::memcpy( output.data() + offset, data, size );
+    }
+}
+
+auto grow_bounds( MeshBounds& bounds, const MeshBounds& other ) -> void
+{
+    for ( u32 axis = 0; axis < 3; ++axis ) {
+        bounds.min[axis] = std::min( bounds.min[axis], other.min[axis] );
+        bounds.max[axis] = std::max( bounds.max[axis], other.max[axis] );
+    }
+}
+} // namespace
+
+auto update_mesh_bounds( MeshData& mesh ) -> void
+{
+    const u32 stride = get_vertex_stride( mesh.vertex_format );
+
+    mesh.bounds = EMPTY_BOUNDS;
+    for ( MeshSubmesh& submesh : mesh.submeshes ) {
+        submesh.bounds = EMPTY_BOUNDS;
+
+        u32 first_vertex = std::numeric_limits<u32>::max();
+        u32 last_vertex = 0;
+        for ( u32 i = submesh.first_index; i < submesh.first_index + submesh.index_count; ++i ) {
+            const u32 index = mesh.indices[i];
+            first_vertex = std::min( first_vertex, index );
+            last_vertex = std::max( last_vertex, index );
+            grow_bounds( submesh.bounds, mesh.vertices.data() + u64{ index } * stride );
+        }
+
+        submesh.first_vertex = submesh.index_count > 0 ? first_vertex : 0;
+        submesh.vertex_count = submesh.index_count > 0 ? last_vertex - first_vertex + 1 : 0;
+        grow_bounds( mesh.bounds, submesh.bounds );
+    }
+}
+
+auto get_mesh_index_size( const MeshData& mesh ) -> u32
+{
+    // 16-bit indices halve the index stream and its bandwidth whenever every vertex can be addressed with them
+    const u32 stride = get_vertex_stride( mesh.vertex_format );
+    const u64 vertex_count = stride > 0 ? mesh.vertices.size() / stride : 0;
+    return vertex_count <= std::numeric_limits<u16>::max() ? sizeof( u16 ) : sizeof( u32 );
+}
+
+auto serialize_mesh( const MeshData& mesh ) -> std::vector<u8>
+{
+    const u32 stride = get_vertex_stride( mesh.vertex_format );
+    const u64 vertex_count = stride > 0 ? mesh.vertices.size() / stride : 0;
+    const u64 vertex_size = vertex_count * stride;
+    const u32 index_stride = get_mesh_index_size( mesh );
+    const u64 index_size = mesh.indices.size() * index_stride;
+    const u64 submesh_size = mesh.submeshes.size() * sizeof( MeshSubmesh );
+
+    const u64 vertex_offset = align_up( sizeof( MeshHeader ), MESH_STREAM_ALIGNMENT );
+    const u64 index_offset = align_up( vertex_offset + vertex_size, MESH_STREAM_ALIGNMENT );
+    const u64 submesh_offset = align_up( index_offset + index_size, MESH_STREAM_ALIGNMENT );
+    const u64 file_size = submesh_offset + submesh_size;
+
+    const MeshHeader header = {
+        .magic = MESH_FILE_MAGIC,
+        .version = MESH_FILE_VERSION,
+        .vertex_format = mesh.vertex_format,
+        .vertex_stride = stride,
+        .vertex_count = static_cast<u32>( vertex_count ),
+        .index_count = static_cast<u32>( mesh.indices.size() ),
+        .index_size = index_stride,
+        .submesh_count = static_cast<u32>( mesh.submeshes.size() ),
+        .bounds = mesh.bounds,
+        .vertex_offset = vertex_offset,
+        .index_offset = index_offset,
+        .submesh_offset = submesh_offset,
+        .file_size = file_size,
+    };
+
+    // Zeroed, so that the padding between streams is deterministic
+    std::vector<u8> output( file_size );
+    std::memcpy( output.data(), &header, sizeof( header ) );
+    copy_stream( output, vertex_offset, mesh.vertices.data(), vertex_size );
+    if ( index_stride == sizeof( u16 ) ) {
+        std::vector<u16> narrow_indices( mesh.indices.size() );
+        std::ranges::transform( mesh.indices, narrow_indices.begin(), []( const u32 index ) {
+            return static_cast<u16>( index );
+        } );
+        copy_stream( output, index_offset, narrow_indices.data(), index_size );
+    } else {
+        copy_stream( output, index_offset, mesh.indices.data(), index_size );
+    }
+    copy_stream( output, submesh_offset, mesh.submeshes.data(), submesh_size );
+    return output;
+}
+
+auto write_mesh( const std::filesystem::path& path, const MeshData& mesh ) -> bool
+{
+    const std::vector<u8> data = serialize_mesh( mesh );
+
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    file.write( reinterpret_cast<const char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+    return static_cast<bool>( file );
+}
+
+} // namespace mksv
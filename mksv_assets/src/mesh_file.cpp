@@ -0,0 +1,126 @@
+#include "mksv/assets/mesh_file.hpp"
+
+#include <bit>
+#include <cstring>
+#include <utility>
+
+namespace mksv
+{
+namespace
+{
+// Offsets come from the file, so they are checked without overflowing
+auto is_in_range( const u64 offset, const u64 size, const u64 file_size ) -> bool
+{
+    return offset <= file_size && size <= file_size - offset;
+}
+
+auto is_stream_valid( const u64 offset, const u64 size, const u64 file_size ) -> bool
+{
+    return offset % MESH_STREAM_ALIGNMENT == 0 && is_in_range( offset, size, file_size );
+}
+} // namespace
+
+static_assert( std::endian::native == std::endian::little, "Meshes are stored little endian" );
+
+auto MeshFile::open( const std::filesystem::path& path ) -> std::unique_ptr<MeshFile>
+{
+    auto file = MappedFile::open( path );
+    if ( !file || !validate( file->get_data() ) ) {
+        return nullptr;
+    }
+
+    MeshHeader header{};
+    std::memcpy( &header, file->get_data().data(), sizeof( header ) );
+    return std::unique_ptr<MeshFile>{ new MeshFile( std::move( file ), header ) };
+}
+
+auto MeshFile::validate( const std::span<const u8> data ) -> bool
+{
+    MeshHeader header{};
+    if ( data.size() < sizeof( header ) ) {
+        return false;
+    }
+    std::memcpy( &header, data.data(), sizeof( header ) );
+
+    if ( header.magic != MESH_FILE_MAGIC || header.version != MESH_FILE_VERSION || header.file_size != data.size() ) {
+        return false;
+    }
+
+    const u32 stride = mksv::get_vertex_stride( header.vertex_format );
+    if ( stride == 0 || stride != header.vertex_stride || ( header.index_size != 2 && header.index_size != 4 ) ) {
+        return false;
+    }
+
+    if ( !is_stream_valid( header.vertex_offset, u64{ header.vertex_count } * stride, data.size() ) ||
+         !is_stream_valid( header.index_offset, u64{ header.index_count } * header.index_size, data.size() ) ||
+         !is_stream_valid( header.submesh_offset, u64{ header.submesh_count } * sizeof( MeshSubmesh ), data.size() ) ) {
+        return false;
+    }
+
+    for ( u32 i = 0; i < header.submesh_count; ++i ) {
+        MeshSubmesh submesh{};
+        std::memcpy( &submesh, data.data() + header.submesh_offset + i * sizeof( MeshSubmesh ), sizeof( submesh ) );
+
+        if ( !is_in_range( submesh.first_index, submesh.index_count, header.index_count ) ||
+             !is_in_range( submesh.first_vertex, submesh.vertex_count, header.vertex_count ) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+MeshFile::MeshFile( std::unique_ptr<MappedFile> file, const MeshHeader& header )
+    : file_{ std::move( file ) },
+      header_{ header }
+{
+}
+
+auto MeshFile::get_vertex_format() const -> MeshVertexFormat
+{
+    return header_.vertex_format;
+}
+
+auto MeshFile::get_vertex_stride() const -> u32
+{
+    return header_.vertex_stride;
+}
+
+auto MeshFile::get_vertex_count() const -> u32
+{
+    return header_.vertex_count;
+}
+
+auto MeshFile::get_index_size() const -> u32
+{
+    return header_.index_size;
+}
+
+auto MeshFile::get_index_count() const -> u32
+{
+    return header_.index_count;
+}
+
+auto MeshFile::get_bounds() const -> const MeshBounds&
+{
+    return header_.bounds;
+}
+
+auto MeshFile::get_vertex_data() const -> std::span<const u8>
+{
+    return file_->get_data().subspan( header_.vertex_offset, u64{ header_.vertex_count } * header_.vertex_stride );
+}
+
+auto MeshFile::get_index_data() const -> std::span<const u8>
+{
+    return file_->get_data().subspan( header_.index_offset, u64{ header_.index_count } * header_.index_size );
+}
+
+auto MeshFile::get_submeshes() const -> std::span<const MeshSubmesh>
+{
+    // The mapping is page aligned and the table is at MESH_STREAM_ALIGNMENT within it
+    const u8* const table = file_->get_data().data() + header_.submesh_offset;
+    return { reinterpret_cast<const MeshSubmesh*>( table ), header_.submesh_count };
+}
+
+} // namespace mksv
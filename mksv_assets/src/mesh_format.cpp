@@ -0,0 +1,14 @@
+#include "mksv/assets/mesh_format.hpp"
+
+#include "mksv/assets/vertex_layout.hpp"
+
+namespace mksv
+{
+
+auto get_vertex_stride( const MeshVertexFormat format ) -> u32
+{
+    const std::optional<VertexLayout> layout = get_vertex_layout( format );
+    return layout ? get_vertex_stride( *layout ) : 0;
+}
+
+} // namespace mksv
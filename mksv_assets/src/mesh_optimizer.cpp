@@ -0,0 +1,432 @@
+#include "mksv/assets/mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 INVALID_VERTEX = std::numeric_limits<u32>::max();
+
+// FIFO post-transform cache: a vertex is cached while fewer than cache_size misses happened since its own miss
+class CacheSimulator
+{
+public:
+    CacheSimulator( const u32 vertex_count, const u32 cache_size )
+        : timestamps_( vertex_count, 0 ),
+          cache_size_{ cache_size },
+          time_{ cache_size + 1 }
+    {
+    }
+
+    // True on a miss
+    auto access( const u32 vertex ) -> bool
+    {
+        if ( time_ - timestamps_[vertex] <= cache_size_ ) {
+            return false;
+        }
+        timestamps_[vertex] = time_++;
+        return true;
+    }
+
+    auto flush() -> void
+    {
+        time_ += cache_size_ + 1;
+    }
+
+private:
+    std::vector<u32> timestamps_;
+    u32              cache_size_;
+    u32              time_;
+};
+
+struct Vec3 {
+    f32 x;
+    f32 y;
+    f32 z;
+};
+
+auto load_position( const std::span<const u8> vertices, const u32 stride, const u32 vertex ) -> Vec3
+{
+    Vec3 position;
+    std::memcpy( &position, vertices.data() + u64{ vertex } * stride, sizeof( position ) );
+    return position;
+}
+
+auto get_triangle_count( const std::span<const u32> indices ) -> u32
+{
+    return static_cast<u32>( indices.size() / 3 );
+}
+
+// Triangles around every vertex in compressed rows: the triangles of vertex v are triangles[offsets[v], offsets[v + 1])
+struct Adjacency {
+    std::vector<u32> offsets;
+    std::vector<u32> triangles;
+};
+
+auto build_adjacency( const std::span<const u32> indices, const u32 vertex_count ) -> Adjacency
+{
+    const u32 triangle_count = get_triangle_count( indices );
+
+    Adjacency adjacency{
+        .offsets = std::vector<u32>( vertex_count + 1, 0 ),
+        .triangles = std::vector<u32>( u64{ triangle_count } * 3 ),
+    };
+
+    for ( u32 i = 0; i < triangle_count * 3; ++i ) {
+        ++adjacency.offsets[indices[i] + 1];
+    }
+    for ( u32 v = 0; v < vertex_count; ++v ) {
+        adjacency.offsets[v + 1] += adjacency.offsets[v];
+    }
+
+    std::vector<u32> cursors{ adjacency.offsets.begin(), adjacency.offsets.end() - 1 };
+    for ( u32 i = 0; i < triangle_count * 3; ++i ) {
+        adjacency.triangles[cursors[indices[i]]++] = i / 3;
+    }
+
+    return adjacency;
+}
+} // namespace
+
+auto analyze_vertex_cache( const std::span<const u32> indices, const u32 vertex_count, const u32 cache_size )
+    -> VertexCacheStats
+{
+    const u32 triangle_count = get_triangle_count( indices );
+
+    CacheSimulator    cache{ vertex_count, cache_size };
+    std::vector<bool> referenced( vertex_count, false );
+    u32               transformed = 0;
+    u32               unique = 0;
+
+    for ( u32 i = 0; i < triangle_count * 3; ++i ) {
+        const u32 vertex = indices[i];
+        transformed += cache.access( vertex ) ? 1 : 0;
+        if ( !referenced[vertex] ) {
+            referenced[vertex] = true;
+            ++unique;
+        }
+    }
+
+    return {
+        .acmr = triangle_count > 0 ? static_cast<f32>( transformed ) / static_cast<f32>( triangle_count ) : 0.0f,
+        .atvr = unique > 0 ? static_cast<f32>( transformed ) / static_cast<f32>( unique ) : 0.0f,
+    };
+}
+
+auto optimize_vertex_cache( const std::span<u32> indices, const u32 vertex_count, const u32 cache_size ) -> void
+{
+    const u32 triangle_count = get_triangle_count( indices );
+    if ( triangle_count == 0 ) {
+        return;
+    }
+
+    const Adjacency adjacency = build_adjacency( indices, vertex_count );
+
+    // Triangles not emitted yet around every vertex
+    std::vector<u32> live( vertex_count );
+    for ( u32 v = 0; v < vertex_count; ++v ) {
+        live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+
+    // Same clock as CacheSimulator, kept by hand since the priority looks at the age of cached vertices
+    std::vector<u32>  timestamps( vertex_count, 0 );
+    std::vector<bool> emitted( triangle_count, false );
+    std::vector<u32>  dead_ends;
+    std::vector<u32>  candidates;
+    std::vector<u32>  output;
+    dead_ends.reserve( u64{ triangle_count } * 3 );
+    output.reserve( u64{ triangle_count } * 3 );
+
+    u32 time = cache_size + 1;
+    u32 cursor = 0;
+
+    const auto next_vertex = [&]() -> u32 {
+        // The candidate that stays in the cache while all of its triangles are emitted, the oldest one first
+        u32 best = INVALID_VERTEX;
+        i64 best_priority = -1;
+        for ( const u32 vertex : candidates ) {
+            if ( live[vertex] == 0 ) {
+                continue;
+            }
+
+            const u32 age = time - timestamps[vertex];
+            const i64 priority = u64{ age } + 2 * u64{ live[vertex] } <= cache_size ? i64{ age } : 0;
+            if ( priority > best_priority ) {
+                best = vertex;
+                best_priority = priority;
+            }
+        }
+
+        if ( best != INVALID_VERTEX ) {
+            return best;
+        }
+
+        while ( !dead_ends.empty() ) {
+            const u32 vertex = dead_ends.back();
+            dead_ends.pop_back();
+            if ( live[vertex] > 0 ) {
+                return vertex;
+            }
+        }
+
+        for ( ; cursor < vertex_count; ++cursor ) {
+            if ( live[cursor] > 0 ) {
+                return cursor;
+            }
+        }
+
+        return INVALID_VERTEX;
+    };
+
+    for ( u32 fanning = indices[0]; fanning != INVALID_VERTEX; fanning = next_vertex() ) {
+        candidates.clear();
+
+        for ( u32 i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; ++i ) {
+            const u32 triangle = adjacency.triangles[i];
+            if ( emitted[triangle] ) {
+                continue;
+            }
+            emitted[triangle] = true;
+
+            for ( u32 corner = 0; corner < 3; ++corner ) {
+                const u32 vertex = indices[triangle * 3 + corner];
+                output.push_back( vertex );
+                dead_ends.push_back( vertex );
+                candidates.push_back( vertex );
+                --live[vertex];
+
+                if ( time - timestamps[vertex] > cache_size ) {
+                    timestamps[vertex] = time++;
+                }
+            }
+        }
+    }
+
+    std::ranges::copy( output, indices.begin() );
+}
+
+auto optimize_overdraw(
+    const std::span<u32>      indices,
+    const std::span<const u8> vertices,
+    const u32                 vertex_stride,
+    const f32                 threshold,
+    const u32                 cache_size
+) -> void
+{
+    const u32 triangle_count = get_triangle_count( indices );
+    const u32 vertex_count = static_cast<u32>( vertices.size() / vertex_stride );
+    if ( triangle_count == 0 ) {
+        return;
+    }
+
+    // Hard boundaries are the triangles that miss with all three vertices, the order before them does not help them
+    std::vector<u32> misses( triangle_count );
+    std::vector<u32> hard_starts;
+    {
+        CacheSimulator cache{ vertex_count, cache_size };
+        for ( u32 t = 0; t < triangle_count; ++t ) {
+            for ( u32 corner = 0; corner < 3; ++corner ) {
+                misses[t] += cache.access( indices[t * 3 + corner] ) ? 1 : 0;
+            }
+            if ( t == 0 || misses[t] == 3 ) {
+                hard_starts.push_back( t );
+            }
+        }
+        hard_starts.push_back( triangle_count );
+    }
+
+    // Soft boundaries split hard clusters further wherever the part so far, starting from a cold cache, is within
+    // threshold of the whole cluster's miss ratio
+    std::vector<u32> cluster_starts;
+    {
+        CacheSimulator cache{ vertex_count, cache_size };
+        for ( usize h = 0; h + 1 < hard_starts.size(); ++h ) {
+            const u32 begin = hard_starts[h];
+            const u32 end = hard_starts[h + 1];
+
+            u32 cluster_misses = 0;
+            for ( u32 t = begin; t < end; ++t ) {
+                cluster_misses += misses[t];
+            }
+            const f32 cluster_threshold =
+                threshold * static_cast<f32>( cluster_misses ) / static_cast<f32>( end - begin );
+
+            cache.flush();
+            u32 start = begin;
+            u32 soft_misses = 0;
+            cluster_starts.push_back( begin );
+            for ( u32 t = begin; t + 1 < end; ++t ) {
+                for ( u32 corner = 0; corner < 3; ++corner ) {
+                    soft_misses += cache.access( indices[t * 3 + corner] ) ? 1 : 0;
+                }
+
+                if ( static_cast<f32>( soft_misses ) <= cluster_threshold * static_cast<f32>( t + 1 - start ) ) {
+                    cache.flush();
+                    start = t + 1;
+                    soft_misses = 0;
+                    cluster_starts.push_back( start );
+                }
+            }
+        }
+        cluster_starts.push_back( triangle_count );
+    }
+
+    const u32 cluster_count = static_cast<u32>( cluster_starts.size() - 1 );
+    if ( cluster_count < 2 ) {
+        return;
+    }
+
+    // Area weighted centroids and normals of the clusters and the centroid of the whole list
+    struct Cluster {
+        Vec3 centroid;
+        Vec3 normal;
+        f32  area;
+        f32  sort_key;
+        u32  index;
+    };
+
+    std::vector<Cluster> clusters( cluster_count );
+    Vec3                 mesh_centroid = {};
+    f32                  mesh_area = 0.0f;
+
+    for ( u32 c = 0; c < cluster_count; ++c ) {
+        Cluster& cluster = clusters[c];
+        cluster = { .centroid = {}, .normal = {}, .area = 0.0f, .sort_key = 0.0f, .index = c };
+
+        for ( u32 t = cluster_starts[c]; t < cluster_starts[c + 1]; ++t ) {
+            const Vec3 a = load_position( vertices, vertex_stride, indices[t * 3 + 0] );
+            const Vec3 b = load_position( vertices, vertex_stride, indices[t * 3 + 1] );
+            const Vec3 p = load_position( vertices, vertex_stride, indices[t * 3 + 2] );
+
+            const Vec3 ab = { b.x - a.x, b.y - a.y, b.z - a.z };
+            const Vec3 ap = { p.x - a.x, p.y - a.y, p.z - a.z };
+            const Vec3 normal = { ab.y * ap.z - ab.z * ap.y, ab.z * ap.x - ab.x * ap.z, ab.x * ap.y - ab.y * ap.x };
+            const f32  area = std::sqrt( normal.x * normal.x + normal.y * normal.y + normal.z * normal.z );
+
+            cluster.centroid.x += area * ( a.x + b.x + p.x ) / 3.0f;
+            cluster.centroid.y += area * ( a.y + b.y + p.y ) / 3.0f;
+            cluster.centroid.z += area * ( a.z + b.z + p.z ) / 3.0f;
+            cluster.normal.x += normal.x;
+            cluster.normal.y += normal.y;
+            cluster.normal.z += normal.z;
+            cluster.area += area;
+        }
+
+        mesh_centroid.x += cluster.centroid.x;
+        mesh_centroid.y += cluster.centroid.y;
+        mesh_centroid.z += cluster.centroid.z;
+        mesh_area += cluster.area;
+
+        if ( cluster.area > 0.0f ) {
+            cluster.centroid.x /= cluster.area;
+            cluster.centroid.y /= cluster.area;
+            cluster.centroid.z /= cluster.area;
+        }
+    }
+
+    if ( mesh_area <= 0.0f ) {
+        return;
+    }
+
+    mesh_centroid.x /= mesh_area;
+    mesh_centroid.y /= mesh_area;
+    mesh_centroid.z /= mesh_area;
+
+    // Clusters far out along their own normal are the likely occluders of the rest
+    for ( Cluster& cluster : clusters ) {
+        const Vec3& n = cluster.normal;
+        const f32   length = std::sqrt( n.x * n.x + n.y * n.y + n.z * n.z );
+        if ( length > 0.0f ) {
+            cluster.sort_key = ( ( cluster.centroid.x - mesh_centroid.x ) * n.x +
+                                 ( cluster.centroid.y - mesh_centroid.y ) * n.y +
+                                 ( cluster.centroid.z - mesh_centroid.z ) * n.z ) /
+                               length;
+        }
+    }
+
+    std::ranges::stable_sort( clusters, []( const Cluster& a, const Cluster& b ) { return a.sort_key > b.sort_key; } );
+
+    const std::vector<u32> source{ indices.begin(), indices.begin() + u64{ triangle_count } * 3 };
+    u32                    output = 0;
+    for ( const Cluster& cluster : clusters ) {
+        const u32 first = cluster_starts[cluster.index] * 3;
+        const u32 last = cluster_starts[cluster.index + 1] * 3;
+        std::copy( source.begin() + first, source.begin() + last, indices.begin() + output );
+        output += last - first;
+    }
+}
+
+auto optimize_vertex_fetch( const std::span<u8> vertices, const u32 vertex_stride, const std::span<u32> indices )
+    -> u32
+{
+    const u32 vertex_count = static_cast<u32>( vertices.size() / vertex_stride );
+
+    std::vector<u32> remap( vertex_count, INVALID_VERTEX );
+    u32              next = 0;
+    for ( u32& index : indices ) {
+        if ( remap[index] == INVALID_VERTEX ) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    const u32 referenced_count = next;
+
+    // Unreferenced vertices keep their relative order behind the referenced ones
+    for ( u32& target : remap ) {
+        if ( target == INVALID_VERTEX ) {
+            target = next++;
+        }
+    }
+
+    const std::vector<u8> source{ vertices.begin(), vertices.begin() + u64{ vertex_count } * vertex_stride };
+    for ( u32 v = 0; v < vertex_count; ++v ) {
+        std::memcpy(
+            vertices.data() + u64{ remap[v] } * vertex_stride, source.data() + u64{ v } * vertex_stride, vertex_stride
+        );
+    }
+
+    return referenced_count;
+}
+
+auto optimize_mesh( MeshData& mesh ) -> void
+{
+    const u32 stride = get_vertex_stride( mesh.vertex_format );
+    if ( stride == 0 ) {
+        return;
+    }
+
+    for ( const MeshSubmesh& submesh : mesh.submeshes ) {
+        const std::span<u32> indices = std::span{ mesh.indices }.subspan( submesh.first_index, submesh.index_count );
+        if ( indices.empty() ) {
+            continue;
+        }
+
+        // The passes size their tables by the vertex count, rebasing the indices onto the vertices this submesh refers
+        // to keeps the whole mesh linear in the vertex count instead of submeshes times vertices
+        const u32 min_vertex = std::ranges::min( indices );
+        const u32 range_count = std::ranges::max( indices ) - min_vertex + 1;
+        for ( u32& index : indices ) {
+            index -= min_vertex;
+        }
+
+        const std::span<const u8> vertices =
+            std::span{ mesh.vertices }.subspan( u64{ min_vertex } * stride, u64{ range_count } * stride );
+        optimize_vertex_cache( indices, range_count );
+        optimize_overdraw( indices, vertices, stride );
+
+        for ( u32& index : indices ) {
+            index += min_vertex;
+        }
+    }
+
+    const u32 used_vertex_count = optimize_vertex_fetch( mesh.vertices, stride, mesh.indices );
+    mesh.vertices.resize( u64{ used_vertex_count } * stride );
+    update_mesh_bounds( mesh );
+}
+
+} // namespace mksv
@@ -0,0 +1,204 @@
+#include "mksv/assets/shader_archive.hpp"
+
+#include "mksv/assets/hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace mksv
+{
+namespace
+{
+constexpr auto align_up( const u64 value, const u64 alignment ) -> u64
+{
+    return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+auto hash_name( const std::string_view name ) -> u64
+{
+    return hash_bytes( name.data(), name.size() );
+}
+
+// Offsets come from the file, so they are checked without overflowing
+auto is_in_range( const u64 offset, const u64 size, const u64 file_size ) -> bool
+{
+    return offset <= file_size && size <= file_size - offset;
+}
+} // namespace
+
+static_assert( std::endian::native == std::endian::little, "Shader archives are stored little endian" );
+static_assert( sizeof( ShaderArchive::Header ) == 32 );
+static_assert( sizeof( ShaderArchive::Slot ) == 32 );
+
+auto ShaderArchive::open( const std::filesystem::path& path ) -> std::unique_ptr<ShaderArchive>
+{
+    auto file = MappedFile::open( path );
+    if ( !file || !validate( file->get_data() ) ) {
+        return nullptr;
+    }
+
+    const std::span<const u8> data = file->get_data();
+
+    Header header{};
+    std::memcpy( &header, data.data(), sizeof( header ) );
+
+    // The mapping is page aligned and slots_offset is checked to be aligned as well
+    const Slot* const slots = reinterpret_cast<const Slot*>( data.data() + header.slots_offset );
+    return std::unique_ptr<ShaderArchive>{ new ShaderArchive( std::move( file ), header, slots ) };
+}
+
+auto ShaderArchive::validate( const std::span<const u8> data ) -> bool
+{
+    Header header{};
+    if ( data.size() < sizeof( header ) ) {
+        return false;
+    }
+    std::memcpy( &header, data.data(), sizeof( header ) );
+
+    if ( header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.file_size != data.size() ) {
+        return false;
+    }
+
+    if ( !std::has_single_bit( header.slot_count ) || header.shader_count >= header.slot_count ||
+         header.slots_offset % alignof( Slot ) != 0 ||
+         !is_in_range( header.slots_offset, u64{ header.slot_count } * sizeof( Slot ), data.size() ) ) {
+        return false;
+    }
+
+    u32 occupied = 0;
+    for ( u32 i = 0; i < header.slot_count; ++i ) {
+        Slot slot{};
+        std::memcpy( &slot, data.data() + header.slots_offset + i * sizeof( Slot ), sizeof( slot ) );
+        if ( slot.name_size == 0 ) {
+            continue;
+        }
+
+        if ( !is_in_range( slot.name_offset, slot.name_size, data.size() ) ||
+             !is_in_range( slot.data_offset, slot.data_size, data.size() ) ) {
+            return false;
+        }
+        ++occupied;
+    }
+
+    return occupied == header.shader_count;
+}
+
+ShaderArchive::ShaderArchive( std::unique_ptr<MappedFile> file, const Header& header, const Slot* const slots )
+    : file_{ std::move( file ) },
+      header_{ header },
+      slots_{ slots }
+{
+}
+
+auto ShaderArchive::find( const std::string_view name ) const -> std::span<const u8>
+{
+    if ( name.empty() ) {
+        return {};
+    }
+
+    const u8* const data = file_->get_data().data();
+    const u64       hash = hash_name( name );
+    const u32       mask = header_.slot_count - 1;
+
+    for ( u32 i = static_cast<u32>( hash ) & mask;; i = ( i + 1 ) & mask ) {
+        const Slot& slot = slots_[i];
+        if ( slot.name_size == 0 ) {
+            return {};
+        }
+
+        if ( slot.name_hash == hash && slot.name_size == name.size() &&
+             std::memcmp( data + slot.name_offset, name.data(), name.size() ) == 0 ) {
+            return { data + slot.data_offset, static_cast<usize>( slot.data_size ) };
+        }
+    }
+}
+
+auto ShaderArchive::get_shader_count() const -> u32
+{
+    return header_.shader_count;
+}
+
+auto ShaderArchiveWriter::add( const std::string_view name, const std::span<const u8> bytecode ) -> bool
+{
+    if ( name.empty() || shaders_.contains( name ) ) {
+        return false;
+    }
+
+    shaders_.emplace( std::string{ name }, std::vector<u8>{ bytecode.begin(), bytecode.end() } );
+    return true;
+}
+
+auto ShaderArchiveWriter::serialize() const -> std::vector<u8>
+{
+    using Header = ShaderArchive::Header;
+    using Slot = ShaderArchive::Slot;
+
+    // At most half full, which keeps probes short
+    const u32 shader_count = static_cast<u32>( shaders_.size() );
+    const u32 slot_count = std::bit_ceil( shader_count * 2 + 1 );
+
+    u64 names_size = 0;
+    for ( const auto& [name, bytecode] : shaders_ ) {
+        names_size += name.size();
+    }
+
+    const u64 slots_offset = align_up( sizeof( Header ), alignof( Slot ) );
+    const u64 names_offset = slots_offset + u64{ slot_count } * sizeof( Slot );
+    u64       data_offset = align_up( names_offset + names_size, ShaderArchive::DATA_ALIGNMENT );
+
+    std::vector<Slot> slots( slot_count );
+    std::vector<u8>   output;
+    output.resize( data_offset );
+
+    u64 name_offset = names_offset;
+    for ( const auto& [name, bytecode] : shaders_ ) {
+        const u64 hash = hash_name( name );
+
+        u32 i = static_cast<u32>( hash ) & ( slot_count - 1 );
+        while ( slots[i].name_size != 0 ) {
+            i = ( i + 1 ) & ( slot_count - 1 );
+        }
+
+        slots[i] = {
+            .name_hash = hash,
+            .data_offset = data_offset,
+            .data_size = bytecode.size(),
+            .name_offset = static_cast<u32>( name_offset ),
+            .name_size = static_cast<u32>( name.size() ),
+        };
+
+        std::ranges::copy( name, output.begin() + static_cast<isize>( name_offset ) );
+        name_offset += name.size();
+
+        output.resize( align_up( data_offset + bytecode.size(), ShaderArchive::DATA_ALIGNMENT ) );
+        std::ranges::copy( bytecode, output.begin() + static_cast<isize>( data_offset ) );
+        data_offset = output.size();
+    }
+
+    const Header header = {
+        .magic = ShaderArchive::FILE_MAGIC,
+        .version = ShaderArchive::FILE_VERSION,
+        .shader_count = shader_count,
+        .slot_count = slot_count,
+        .slots_offset = slots_offset,
+        .file_size = output.size(),
+    };
+
+    std::memcpy( output.data(), &header, sizeof( header ) );
+    std::memcpy( output.data() + slots_offset, slots.data(), slots.size() * sizeof( Slot ) );
+    return output;
+}
+
+auto ShaderArchiveWriter::write( const std::filesystem::path& path ) const -> bool
+{
+    const std::vector<u8> data = serialize();
+
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    file.write( reinterpret_cast<const char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+    return static_cast<bool>( file );
+}
+
+} // namespace mksv
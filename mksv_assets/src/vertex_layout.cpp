@@ -0,0 +1,113 @@
+#include "mksv/assets/vertex_layout.hpp"
+
+namespace mksv
+{
+namespace
+{
+auto get_position_size( const PositionEncoding encoding ) -> u32
+{
+    switch ( encoding ) {
+        case PositionEncoding::Float32:
+            return 3 * sizeof( f32 );
+        case PositionEncoding::Half:
+        case PositionEncoding::Snorm16:
+            return 4 * sizeof( u16 );
+    }
+
+    return 0;
+}
+
+auto get_color_size( const ColorEncoding encoding ) -> u32
+{
+    switch ( encoding ) {
+        case ColorEncoding::Float32:
+            return 3 * sizeof( f32 );
+        case ColorEncoding::Unorm8:
+            return 4 * sizeof( u8 );
+    }
+
+    return 0;
+}
+
+auto get_normal_size( const NormalEncoding encoding ) -> u32
+{
+    switch ( encoding ) {
+        case NormalEncoding::None:
+            return 0;
+        case NormalEncoding::Float32:
+            return 3 * sizeof( f32 );
+        case NormalEncoding::Octahedral:
+            return 2 * sizeof( u16 );
+    }
+
+    return 0;
+}
+
+auto get_uv_size( const UvEncoding encoding ) -> u32
+{
+    switch ( encoding ) {
+        case UvEncoding::None:
+            return 0;
+        case UvEncoding::Float32:
+            return 2 * sizeof( f32 );
+        case UvEncoding::Half:
+            return 2 * sizeof( u16 );
+    }
+
+    return 0;
+}
+} // namespace
+
+auto get_attribute_size( const VertexLayout& layout, const VertexAttribute attribute ) -> u32
+{
+    switch ( attribute ) {
+        case VertexAttribute::Position:
+            return get_position_size( layout.position );
+        case VertexAttribute::Color:
+            return get_color_size( layout.color );
+        case VertexAttribute::Normal:
+            return get_normal_size( layout.normal );
+        case VertexAttribute::Uv:
+            return get_uv_size( layout.uv );
+    }
+
+    return 0;
+}
+
+auto get_attribute_offset( const VertexLayout& layout, const VertexAttribute attribute ) -> u32
+{
+    u32 offset = 0;
+    for ( u32 i = 0; i < static_cast<u32>( attribute ); ++i ) {
+        offset += get_attribute_size( layout, static_cast<VertexAttribute>( i ) );
+    }
+    return offset;
+}
+
+auto get_vertex_stride( const VertexLayout& layout ) -> u32
+{
+    return get_attribute_offset( layout, VertexAttribute::Uv ) + get_attribute_size( layout, VertexAttribute::Uv );
+}
+
+auto get_vertex_layout( const MeshVertexFormat format ) -> std::optional<VertexLayout>
+{
+    switch ( format ) {
+        case MeshVertexFormat::PositionColor:
+            return VertexLayout{
+                .position = PositionEncoding::Float32,
+                .color = ColorEncoding::Float32,
+                .normal = NormalEncoding::None,
+                .uv = UvEncoding::None,
+            };
+        case MeshVertexFormat::PositionColorQuantized:
+            return VertexLayout{
+                .position = PositionEncoding::Snorm16,
+                .color = ColorEncoding::Unorm8,
+                .normal = NormalEncoding::None,
+                .uv = UvEncoding::None,
+            };
+    }
+
+    return std::nullopt;
+}
+
+} // namespace mksv
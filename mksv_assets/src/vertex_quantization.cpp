@@ -0,0 +1,468 @@
+#include "mksv/assets/vertex_quantization.hpp"
+
+#include "mksv/assets/vertex_layout.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#endif
+
+namespace mksv
+{
+namespace
+{
+constexpr f32 SNORM16_MAX = 32767.0f;
+constexpr f32 UNORM8_MAX = 255.0f;
+
+// Positions are encoded relative to the center of the bounds, scaled to [-1, 1] by the half extent. Flat axes get a
+// scale of 0 and decode to the center.
+struct BoundsFrame {
+    f32 center[3];
+    f32 scale[3];
+    f32 half_extent[3];
+};
+
+auto get_bounds_frame( const MeshBounds& bounds ) -> BoundsFrame
+{
+    BoundsFrame frame{};
+    for ( u32 axis = 0; axis < 3; ++axis ) {
+        const f32 min = bounds.min[axis] <= bounds.max[axis] ? bounds.min[axis] : 0.0f;
+        const f32 max = bounds.min[axis] <= bounds.max[axis] ? bounds.max[axis] : 0.0f;
+        frame.center[axis] = 0.5f * ( min + max );
+        frame.half_extent[axis] = 0.5f * ( max - min );
+        frame.scale[axis] = frame.half_extent[axis] > 0.0f ? 1.0f / frame.half_extent[axis] : 0.0f;
+    }
+    return frame;
+}
+
+auto load_f32( const u8* const p ) -> f32
+{
+    f32 value;
+    std::memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+template <typename T>
+auto store( u8* const p, const T value ) -> void
+{
+    std::memcpy( p, &value, sizeof( value ) );
+}
+
+template <typename T>
+auto load( const u8* const p ) -> T
+{
+    T value;
+    std::memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+// Round to nearest even, as the SIMD conversions do under the default rounding mode
+auto to_snorm16( const f32 value ) -> i16
+{
+    return static_cast<i16>( std::nearbyint( std::clamp( value, -1.0f, 1.0f ) * SNORM16_MAX ) );
+}
+
+auto to_unorm8( const f32 value ) -> u8
+{
+    return static_cast<u8>( std::nearbyint( std::clamp( value, 0.0f, 1.0f ) * UNORM8_MAX ) );
+}
+
+auto from_snorm16( const i16 value ) -> f32
+{
+    return std::max( static_cast<f32>( value ) / SNORM16_MAX, -1.0f );
+}
+
+auto copy_attribute( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count, const u32 size )
+    -> void
+{
+    for ( u32 i = 0; i < count; ++i, src += stride, dst += dst_stride ) {
+        std::memcpy( dst, src, size );
+    }
+}
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+auto load_xy00( const u8* const p ) -> __m128
+{
+    return _mm_castsi128_ps( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( p ) ) );
+}
+
+auto load_xyz1( const u8* const p ) -> __m128
+{
+    const __m128 z1 = _mm_unpacklo_ps( _mm_load_ss( reinterpret_cast<const f32*>( p + 2 * sizeof( f32 ) ) ),
+                                       _mm_set_ss( 1.0f ) );
+    return _mm_movelh_ps( load_xy00( p ), z1 );
+}
+
+auto store_4_bytes( u8* const p, const __m128i value ) -> void
+{
+    store( p, _mm_cvtsi128_si32( value ) );
+}
+
+auto store_8_bytes( u8* const p, const __m128i value ) -> void
+{
+    _mm_storel_epi64( reinterpret_cast<__m128i*>( p ), value );
+}
+
+// float_to_half() on four lanes, the halves come out sign extended to 32 bits so that _mm_packs_epi32 keeps them
+auto to_half( const __m128 value ) -> __m128i
+{
+    const __m128i sign_mask = _mm_set1_epi32( static_cast<i32>( 0x80000000u ) );
+    const __m128i infinity = _mm_set1_epi32( 0x7F800000 );
+    const __m128i half_max = _mm_set1_epi32( ( 127 + 16 ) << 23 );
+    const __m128i min_normal = _mm_set1_epi32( ( 127 - 14 ) << 23 );
+    const __m128i subnormal_magic = _mm_set1_epi32( ( ( 127 - 15 ) + ( 23 - 10 ) + 1 ) << 23 );
+    const __m128i normal_bias = _mm_set1_epi32( 0xFFF - ( ( 127 - 15 ) << 23 ) );
+
+    const __m128i bits = _mm_castps_si128( value );
+    const __m128i sign = _mm_and_si128( bits, sign_mask );
+    const __m128i magnitude = _mm_xor_si128( bits, sign );
+
+    const __m128i is_nan = _mm_cmpgt_epi32( magnitude, infinity );
+    const __m128i is_finite = _mm_cmpgt_epi32( half_max, magnitude );
+    const __m128i is_subnormal = _mm_cmpgt_epi32( min_normal, magnitude );
+    const __m128i special = _mm_or_si128( _mm_and_si128( is_nan, _mm_set1_epi32( 0x200 ) ), _mm_set1_epi32( 0x7C00 ) );
+
+    const __m128 subnormal_sum = _mm_add_ps( _mm_castsi128_ps( magnitude ), _mm_castsi128_ps( subnormal_magic ) );
+    const __m128i subnormal = _mm_sub_epi32( _mm_castps_si128( subnormal_sum ), subnormal_magic );
+
+    // Ties round to even: an odd half mantissa adds the missing 1 to the bias
+    const __m128i mantissa_odd = _mm_srai_epi32( _mm_slli_epi32( magnitude, 31 - 13 ), 31 );
+    const __m128i normal = _mm_srli_epi32( _mm_sub_epi32( _mm_add_epi32( magnitude, normal_bias ), mantissa_odd ), 13 );
+
+    const __m128i finite =
+        _mm_or_si128( _mm_and_si128( is_subnormal, subnormal ), _mm_andnot_si128( is_subnormal, normal ) );
+    const __m128i result = _mm_or_si128( _mm_and_si128( is_finite, finite ), _mm_andnot_si128( is_finite, special ) );
+    return _mm_or_si128( result, _mm_srai_epi32( sign, 16 ) );
+}
+
+auto clamp( const __m128 value, const f32 min, const f32 max ) -> __m128
+{
+    return _mm_min_ps( _mm_max_ps( value, _mm_set1_ps( min ) ), _mm_set1_ps( max ) );
+}
+#endif
+} // namespace
+
+auto float_to_half( const f32 value ) -> u16
+{
+    constexpr u32 INFINITY_BITS = 0xFFu << 23;
+    constexpr u32 HALF_MAX_BITS = ( 127u + 16 ) << 23;
+    constexpr u32 MIN_NORMAL_BITS = ( 127u - 14 ) << 23;
+    constexpr u32 SUBNORMAL_MAGIC_BITS = ( ( 127u - 15 ) + ( 23 - 10 ) + 1 ) << 23;
+
+    u32       bits = std::bit_cast<u32>( value );
+    const u32 sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    u32 half = 0;
+    if ( bits >= HALF_MAX_BITS ) {
+        // Infinity stays infinity, NaN becomes a quiet NaN
+        half = bits > INFINITY_BITS ? 0x7E00 : 0x7C00;
+    } else if ( bits < MIN_NORMAL_BITS ) {
+        // The addition shifts the mantissa into place and rounds it
+        const f32 sum = std::bit_cast<f32>( bits ) + std::bit_cast<f32>( SUBNORMAL_MAGIC_BITS );
+        half = std::bit_cast<u32>( sum ) - SUBNORMAL_MAGIC_BITS;
+    } else {
+        const u32 mantissa_odd = ( bits >> 13 ) & 1;
+        bits += ( ( 15u - 127 ) << 23 ) + 0xFFF + mantissa_odd;
+        half = bits >> 13;
+    }
+
+    return static_cast<u16>( half | ( sign >> 16 ) );
+}
+
+auto half_to_float( const u16 value ) -> f32
+{
+    constexpr u32 SHIFTED_EXPONENT = 0x7C00u << 13;
+
+    u32       bits = ( value & 0x7FFFu ) << 13;
+    const u32 exponent = bits & SHIFTED_EXPONENT;
+    bits += ( 127u - 15 ) << 23;
+
+    if ( exponent == SHIFTED_EXPONENT ) {
+        bits += ( 128u - 16 ) << 23;
+    } else if ( exponent == 0 ) {
+        // Subnormal, renormalized by the float unit
+        bits += 1u << 23;
+        bits = std::bit_cast<u32>( std::bit_cast<f32>( bits ) - std::bit_cast<f32>( 113u << 23 ) );
+    }
+
+    return std::bit_cast<f32>( bits | ( static_cast<u32>( value & 0x8000u ) << 16 ) );
+}
+
+auto decode_octahedral( const i16 x, const i16 y, f32 ( &normal )[3] ) -> void
+{
+    f32       px = from_snorm16( x );
+    f32       py = from_snorm16( y );
+    const f32 pz = 1.0f - std::abs( px ) - std::abs( py );
+
+    if ( pz < 0.0f ) {
+        const f32 fx = ( 1.0f - std::abs( py ) ) * std::copysign( 1.0f, px );
+        const f32 fy = ( 1.0f - std::abs( px ) ) * std::copysign( 1.0f, py );
+        px = fx;
+        py = fy;
+    }
+
+    const f32 length = std::sqrt( px * px + py * py + pz * pz );
+    normal[0] = px / length;
+    normal[1] = py / length;
+    normal[2] = pz / length;
+}
+
+auto encode_positions_half( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count ) -> void
+{
+    u32 i = 0;
+#if defined( __SSE2__ ) || defined( _M_X64 )
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        const __m128i half = to_half( load_xyz1( src ) );
+        store_8_bytes( dst, _mm_packs_epi32( half, half ) );
+    }
+#endif
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            store( dst + axis * sizeof( u16 ), float_to_half( load_f32( src + axis * sizeof( f32 ) ) ) );
+        }
+        store( dst + 3 * sizeof( u16 ), float_to_half( 1.0f ) );
+    }
+}
+
+auto encode_positions_snorm16(
+    const u8*         src,
+    const u32         stride,
+    u8*               dst,
+    const u32         dst_stride,
+    const u32         count,
+    const MeshBounds& bounds
+) -> void
+{
+    const BoundsFrame frame = get_bounds_frame( bounds );
+
+    u32 i = 0;
+#if defined( __SSE2__ ) || defined( _M_X64 )
+    // w is 1 and stays 1: its center is 0 and its scale 1
+    const __m128 center = _mm_setr_ps( frame.center[0], frame.center[1], frame.center[2], 0.0f );
+    const __m128 scale = _mm_setr_ps( frame.scale[0], frame.scale[1], frame.scale[2], 1.0f );
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        const __m128  normalized = clamp( _mm_mul_ps( _mm_sub_ps( load_xyz1( src ), center ), scale ), -1.0f, 1.0f );
+        const __m128i snorm = _mm_cvtps_epi32( _mm_mul_ps( normalized, _mm_set1_ps( SNORM16_MAX ) ) );
+        store_8_bytes( dst, _mm_packs_epi32( snorm, snorm ) );
+    }
+#endif
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            const f32 position = load_f32( src + axis * sizeof( f32 ) );
+            store( dst + axis * sizeof( i16 ), to_snorm16( ( position - frame.center[axis] ) * frame.scale[axis] ) );
+        }
+        store( dst + 3 * sizeof( i16 ), to_snorm16( 1.0f ) );
+    }
+}
+
+auto encode_colors_unorm8( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count ) -> void
+{
+    u32 i = 0;
+#if defined( __SSE2__ ) || defined( _M_X64 )
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        const __m128  scaled = _mm_mul_ps( clamp( load_xyz1( src ), 0.0f, 1.0f ), _mm_set1_ps( UNORM8_MAX ) );
+        const __m128i unorm = _mm_cvtps_epi32( scaled );
+        const __m128i words = _mm_packs_epi32( unorm, unorm );
+        store_4_bytes( dst, _mm_packus_epi16( words, words ) );
+    }
+#endif
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        for ( u32 channel = 0; channel < 3; ++channel ) {
+            dst[channel] = to_unorm8( load_f32( src + channel * sizeof( f32 ) ) );
+        }
+        dst[3] = to_unorm8( 1.0f );
+    }
+}
+
+auto encode_normals_octahedral( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count )
+    -> void
+{
+    u32 i = 0;
+#if defined( __SSE2__ ) || defined( _M_X64 )
+    // Four normals at a time, one component per register
+    const __m128 sign_mask = _mm_set1_ps( -0.0f );
+    const __m128 one = _mm_set1_ps( 1.0f );
+    for ( ; i + 4 <= count; i += 4, src += 4 * stride, dst += 4 * dst_stride ) {
+        alignas( 16 ) f32 xs[4];
+        alignas( 16 ) f32 ys[4];
+        alignas( 16 ) f32 zs[4];
+        for ( u32 lane = 0; lane < 4; ++lane ) {
+            xs[lane] = load_f32( src + lane * stride );
+            ys[lane] = load_f32( src + lane * stride + sizeof( f32 ) );
+            zs[lane] = load_f32( src + lane * stride + 2 * sizeof( f32 ) );
+        }
+        const __m128 x = _mm_load_ps( xs );
+        const __m128 y = _mm_load_ps( ys );
+        const __m128 z = _mm_load_ps( zs );
+
+        const __m128 l1 = _mm_add_ps( _mm_add_ps( _mm_andnot_ps( sign_mask, x ), _mm_andnot_ps( sign_mask, y ) ),
+                                      _mm_andnot_ps( sign_mask, z ) );
+        const __m128 inverse = _mm_and_ps( _mm_div_ps( one, l1 ), _mm_cmpgt_ps( l1, _mm_setzero_ps() ) );
+        const __m128 px = _mm_mul_ps( x, inverse );
+        const __m128 py = _mm_mul_ps( y, inverse );
+
+        // The lower half of the octahedron folds over the diagonals
+        const __m128 fx = _mm_mul_ps( _mm_sub_ps( one, _mm_andnot_ps( sign_mask, py ) ),
+                                      _mm_or_ps( _mm_and_ps( sign_mask, px ), one ) );
+        const __m128 fy = _mm_mul_ps( _mm_sub_ps( one, _mm_andnot_ps( sign_mask, px ) ),
+                                      _mm_or_ps( _mm_and_ps( sign_mask, py ), one ) );
+        const __m128 lower = _mm_cmplt_ps( z, _mm_setzero_ps() );
+        const __m128 ox = _mm_or_ps( _mm_and_ps( lower, fx ), _mm_andnot_ps( lower, px ) );
+        const __m128 oy = _mm_or_ps( _mm_and_ps( lower, fy ), _mm_andnot_ps( lower, py ) );
+
+        const __m128  snorm_max = _mm_set1_ps( SNORM16_MAX );
+        const __m128i sx = _mm_cvtps_epi32( _mm_mul_ps( clamp( ox, -1.0f, 1.0f ), snorm_max ) );
+        const __m128i sy = _mm_cvtps_epi32( _mm_mul_ps( clamp( oy, -1.0f, 1.0f ), snorm_max ) );
+        __m128i       packed = _mm_packs_epi32( _mm_unpacklo_epi32( sx, sy ), _mm_unpackhi_epi32( sx, sy ) );
+        for ( u32 lane = 0; lane < 4; ++lane ) {
+            store_4_bytes( dst + lane * dst_stride, packed );
+            packed = _mm_srli_si128( packed, 4 );
+        }
+    }
+#endif
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        const f32 x = load_f32( src );
+        const f32 y = load_f32( src + sizeof( f32 ) );
+        const f32 z = load_f32( src + 2 * sizeof( f32 ) );
+
+        const f32 l1 = std::abs( x ) + std::abs( y ) + std::abs( z );
+        const f32 inverse = l1 > 0.0f ? 1.0f / l1 : 0.0f;
+        f32       px = x * inverse;
+        f32       py = y * inverse;
+
+        if ( z < 0.0f ) {
+            const f32 fx = ( 1.0f - std::abs( py ) ) * std::copysign( 1.0f, px );
+            const f32 fy = ( 1.0f - std::abs( px ) ) * std::copysign( 1.0f, py );
+            px = fx;
+            py = fy;
+        }
+
+        store( dst, to_snorm16( px ) );
+        store( dst + sizeof( i16 ), to_snorm16( py ) );
+    }
+}
+
+auto encode_uvs_half( const u8* src, const u32 stride, u8* dst, const u32 dst_stride, const u32 count ) -> void
+{
+    u32 i = 0;
+#if defined( __SSE2__ ) || defined( _M_X64 )
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        const __m128i half = to_half( load_xy00( src ) );
+        store_4_bytes( dst, _mm_packs_epi32( half, half ) );
+    }
+#endif
+    for ( ; i < count; ++i, src += stride, dst += dst_stride ) {
+        store( dst, float_to_half( load_f32( src ) ) );
+        store( dst + sizeof( u16 ), float_to_half( load_f32( src + sizeof( f32 ) ) ) );
+    }
+}
+
+auto quantize_mesh( MeshData& mesh, const MeshVertexFormat format ) -> bool
+{
+    const std::optional<VertexLayout> layout = get_vertex_layout( format );
+    if ( mesh.vertex_format != MeshVertexFormat::PositionColor || !layout || layout->normal != NormalEncoding::None ||
+         layout->uv != UvEncoding::None ) {
+        return false;
+    }
+
+    const u32 stride = get_vertex_stride( mesh.vertex_format );
+    const u32 dst_stride = get_vertex_stride( *layout );
+    const u32 count = static_cast<u32>( mesh.vertices.size() / stride );
+    const u8* src = mesh.vertices.data();
+
+    std::vector<u8> vertices( u64{ count } * dst_stride );
+    u8* const       position = vertices.data() + get_attribute_offset( *layout, VertexAttribute::Position );
+    u8* const       color = vertices.data() + get_attribute_offset( *layout, VertexAttribute::Color );
+
+    switch ( layout->position ) {
+        case PositionEncoding::Float32:
+            copy_attribute( src, stride, position, dst_stride, count, 3 * sizeof( f32 ) );
+            break;
+        case PositionEncoding::Half:
+            encode_positions_half( src, stride, position, dst_stride, count );
+            break;
+        case PositionEncoding::Snorm16:
+            encode_positions_snorm16( src, stride, position, dst_stride, count, mesh.bounds );
+            break;
+    }
+
+    switch ( layout->color ) {
+        case ColorEncoding::Float32:
+            copy_attribute( src + 3 * sizeof( f32 ), stride, color, dst_stride, count, 3 * sizeof( f32 ) );
+            break;
+        case ColorEncoding::Unorm8:
+            encode_colors_unorm8( src + 3 * sizeof( f32 ), stride, color, dst_stride, count );
+            break;
+    }
+
+    mesh.vertex_format = format;
+    mesh.vertices = std::move( vertices );
+    return true;
+}
+
+auto dequantize_vertices(
+    const MeshVertexFormat    format,
+    const MeshBounds&         bounds,
+    const std::span<const u8> vertices,
+    const std::span<u8>       output
+) -> bool
+{
+    const std::optional<VertexLayout> layout = get_vertex_layout( format );
+    if ( !layout ) {
+        return false;
+    }
+
+    const u32 stride = get_vertex_stride( *layout );
+    const u32 output_stride = get_vertex_stride( MeshVertexFormat::PositionColor );
+    const u64 count = vertices.size() / stride;
+    if ( output.size() < count * output_stride ) {
+        return false;
+    }
+
+    const BoundsFrame frame = get_bounds_frame( bounds );
+    const u32         position_offset = get_attribute_offset( *layout, VertexAttribute::Position );
+    const u32         color_offset = get_attribute_offset( *layout, VertexAttribute::Color );
+
+    for ( u64 i = 0; i < count; ++i ) {
+        const u8* const src = vertices.data() + i * stride;
+        u8* const       dst = output.data() + i * output_stride;
+
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            const u8* const position = src + position_offset;
+            f32             value = 0.0f;
+            switch ( layout->position ) {
+                case PositionEncoding::Float32:
+                    value = load_f32( position + axis * sizeof( f32 ) );
+                    break;
+                case PositionEncoding::Half:
+                    value = half_to_float( load<u16>( position + axis * sizeof( u16 ) ) );
+                    break;
+                case PositionEncoding::Snorm16:
+                    value = frame.center[axis] +
+                            from_snorm16( load<i16>( position + axis * sizeof( i16 ) ) ) * frame.half_extent[axis];
+                    break;
+            }
+            store( dst + axis * sizeof( f32 ), value );
+        }
+
+        for ( u32 channel = 0; channel < 3; ++channel ) {
+            const u8* const color = src + color_offset;
+            const f32       value = layout->color == ColorEncoding::Float32
+                                        ? load_f32( color + channel * sizeof( f32 ) )
+                                        : static_cast<f32>( color[channel] ) / UNORM8_MAX;
+            store( dst + ( 3 + channel ) * sizeof( f32 ), value );
+        }
+    }
+
+    return true;
+}
+
+} // namespace mksv
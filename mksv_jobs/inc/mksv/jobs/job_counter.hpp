@@ -0,0 +1,53 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace mksv
+{
+struct Job;
+
+// Number of unfinished jobs that were started with this counter. JobSystem::wait() blocks on it, and jobs started with
+// it as their dependency are held back until it drops to zero. A counter can be reused once it is back at zero.
+//
+// A counter must outlive every job that refers to it, and may only be destroyed after a JobSystem::wait() on it has
+// returned: the job that finishes last still touches the counter after is_done() can already return true.
+class JobCounter
+{
+public:
+    JobCounter();
+    JobCounter( const JobCounter& ) = delete;
+    JobCounter( JobCounter&& ) = delete;
+    auto operator=( const JobCounter& ) -> JobCounter& = delete;
+    auto operator=( JobCounter&& ) -> JobCounter& = delete;
+    ~JobCounter();
+
+public:
+    auto is_done() const -> bool;
+    auto get_value() const -> u32;
+
+private:
+    friend class JobSystem;
+
+    auto increment( const u32 count ) -> void;
+
+    // Hands out the jobs that were waiting on the counter when this call brought it down to zero
+    [[nodiscard]] auto decrement() -> std::vector<Job*>;
+
+    // Returns false when the counter is already at zero, the job does not have to wait then
+    [[nodiscard]] auto add_waiter( Job* const job ) -> bool;
+
+    // Returns once the decrement() that brought the counter to zero has stopped touching it
+    auto synchronize() -> void;
+
+private:
+    std::atomic<u32> value_;
+
+    std::mutex        mutex_;
+    std::vector<Job*> waiters_;
+};
+
+} // namespace mksv
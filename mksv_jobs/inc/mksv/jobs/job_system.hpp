@@ -0,0 +1,103 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_counter.hpp"
+#include "mksv/jobs/work_stealing_deque.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+struct Job {
+    std::function<void()> function;
+    JobCounter*           counter;
+};
+
+// Work-stealing scheduler. Every worker thread owns a Chase-Lev deque: jobs started on a worker go to its own deque
+// and are run newest first, idle workers steal the oldest jobs of the others. Jobs started from any other thread go
+// through a shared queue. Workers that find nothing to run sleep until new jobs are started.
+//
+// Waiting never blocks a thread outright: wait() and parallel_for() run other jobs until what they wait for is done,
+// so jobs may start and wait for jobs of their own.
+class JobSystem
+{
+public:
+    using JobFunction = std::function<void()>;
+    using RangeFunction = std::function<void( const u32 first, const u32 count )>;
+
+    static inline constexpr u32 INVALID_WORKER = ~0u;
+    static inline constexpr u32 BATCHES_PER_WORKER = 4;
+    static inline constexpr u32 DEFAULT_MIN_BATCH_SIZE = 64;
+
+public:
+    // worker_count 0 uses one worker per hardware thread besides the calling one. Pinning puts worker i on logical
+    // core i + 1, leaving core 0 to the calling thread; it is best effort and ignored where unsupported.
+    static auto create( const u32 worker_count = 0, const bool pin_workers = false ) -> std::unique_ptr<JobSystem>;
+
+public:
+    JobSystem( const JobSystem& ) = delete;
+    JobSystem( JobSystem&& ) = delete;
+    auto operator=( const JobSystem& ) -> JobSystem& = delete;
+    auto operator=( JobSystem&& ) -> JobSystem& = delete;
+
+    // Jobs that have not started yet are dropped
+    ~JobSystem();
+
+public:
+    // counter is incremented right away and decremented once function has returned. With a dependency the job is
+    // only queued once dependency has dropped to zero.
+    auto run( JobFunction function, JobCounter* const counter = nullptr, JobCounter* const dependency = nullptr )
+        -> void;
+
+    // Runs queued jobs on the calling thread until counter drops to zero
+    auto wait( JobCounter& counter ) -> void;
+
+    // Calls function for consecutive ranges that cover [0, count) on the workers and the calling thread, and returns
+    // once all of them are done. Ranges hold at least min_batch_size items except for the last one.
+    auto parallel_for( const u32 count, const u32 min_batch_size, const RangeFunction& function ) -> void;
+
+    auto get_worker_count() const -> u32;
+
+    // Index of the calling thread among this system's workers, INVALID_WORKER for any other thread
+    auto get_worker_index() const -> u32;
+
+private:
+    JobSystem( const u32 worker_count, const bool pin_workers );
+
+    static auto pin_thread( const u32 core ) -> bool;
+
+    auto schedule( const std::span<Job* const> jobs ) -> void;
+    auto find_job( const u32 worker ) -> Job*;
+    auto execute( Job* const job ) -> void;
+    auto worker_main( const std::stop_token stop_token, const u32 worker ) -> void;
+
+private:
+    u32  worker_count_;
+    bool pin_workers_;
+
+    std::vector<std::unique_ptr<WorkStealingDeque<Job*>>> deques_;
+
+    // Jobs started outside of the workers
+    std::mutex       injected_mutex_;
+    std::deque<Job*> injected_;
+    std::atomic<u32> injected_count_;
+
+    // Jobs queued but not taken yet, and workers asleep waiting for them
+    std::atomic<u32> queued_;
+    std::atomic<u32> sleeping_;
+
+    std::mutex                  mutex_;
+    std::condition_variable_any work_cv_;
+    std::vector<std::jthread>   workers_;
+};
+
+} // namespace mksv
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <span>
+
+namespace mksv
+{
+// Fewest keys per block, fewer keys than that are sorted on the calling thread
+inline constexpr u32 RADIX_MIN_BLOCK_SIZE = 16 * 1024;
+
+// Stable LSD radix sort of 64-bit keys, each with a u32 value that is moved along with it. Keys are sorted 8 bits per
+// pass, and passes over digits that are the same for every key are skipped, so keys with unused bits only pay for the
+// digits that vary.
+//
+// With a job system every pass splits the keys into blocks that are counted and scattered in parallel, each block
+// into a range of every bucket of its own, which keeps the sort stable. values has to be as large as keys and the
+// scratch spans at least as large, the result ends up in keys and values.
+auto radix_sort(
+    const std::span<u64> keys,
+    const std::span<u32> values,
+    const std::span<u64> key_scratch,
+    const std::span<u32> value_scratch,
+    JobSystem* const     jobs = nullptr
+) -> void;
+
+} // namespace mksv
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace mksv
+{
+// Chase-Lev deque: the owning thread pushes and pops at the bottom, any other thread steals from the top. Both ends
+// are lock-free, and the owner only contends with thieves over the last remaining item.
+//
+// The buffer grows when the owner pushes into a full deque. Thieves may still be reading from the previous buffer,
+// so replaced buffers are only freed with the deque.
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert( std::is_trivially_copyable_v<T>, "Items are copied through atomics" );
+
+public:
+    static inline constexpr i64 DEFAULT_CAPACITY = 256;
+
+public:
+    // capacity must be a power of two
+    explicit WorkStealingDeque( const i64 capacity = DEFAULT_CAPACITY );
+    WorkStealingDeque( const WorkStealingDeque& ) = delete;
+    WorkStealingDeque( WorkStealingDeque&& ) = delete;
+    auto operator=( const WorkStealingDeque& ) -> WorkStealingDeque& = delete;
+    auto operator=( WorkStealingDeque&& ) -> WorkStealingDeque& = delete;
+    ~WorkStealingDeque() = default;
+
+public:
+    // Owner thread only
+    auto push( const T item ) -> void;
+    auto pop() -> std::optional<T>;
+
+    // Any thread. Returns nothing when the deque is empty or another thread took the item first.
+    auto steal() -> std::optional<T>;
+
+    // Only a snapshot when other threads are using the deque
+    auto get_size() const -> i64;
+
+private:
+    struct Buffer {
+        explicit Buffer( const i64 buffer_capacity )
+            : capacity{ buffer_capacity },
+              items{ std::make_unique<std::atomic<T>[]>( static_cast<usize>( buffer_capacity ) ) }
+        {
+        }
+
+        auto load( const i64 index ) const -> T
+        {
+            return items[static_cast<usize>( index & ( capacity - 1 ) )].load( std::memory_order_relaxed );
+        }
+
+        auto store( const i64 index, const T item ) -> void
+        {
+            items[static_cast<usize>( index & ( capacity - 1 ) )].store( item, std::memory_order_relaxed );
+        }
+
+        i64                               capacity;
+        std::unique_ptr<std::atomic<T>[]> items;
+    };
+
+private:
+    auto grow( Buffer* const buffer, const i64 bottom, const i64 top ) -> Buffer*;
+
+private:
+    // Kept on separate cache lines, thieves only write top_ and the owner mostly writes bottom_
+    alignas( 64 ) std::atomic<i64> top_;
+    alignas( 64 ) std::atomic<i64> bottom_;
+    std::atomic<Buffer*> buffer_;
+
+    // Owns the current buffer and every buffer it replaced
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque( const i64 capacity )
+    : top_{ 0 },
+      bottom_{ 0 },
+      buffer_{ nullptr }
+{
+    assert( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0 && "capacity must be a power of two" );
+
+    buffers_.push_back( std::make_unique<Buffer>( capacity ) );
+    buffer_.store( buffers_.back().get(), std::memory_order_relaxed );
+}
+
+template <typename T>
+auto WorkStealingDeque<T>::push( const T item ) -> void
+{
+    const i64 bottom = bottom_.load( std::memory_order_relaxed );
+    const i64 top = top_.load( std::memory_order_acquire );
+    Buffer*   buffer = buffer_.load( std::memory_order_relaxed );
+
+    if ( bottom - top > buffer->capacity - 1 ) {
+        buffer = grow( buffer, bottom, top );
+    }
+
+    buffer->store( bottom, item );
+    bottom_.store( bottom + 1, std::memory_order_release );
+}
+
+// The sequentially consistent accesses to top_ and bottom_ stand in for the fences of the original algorithm, they
+// make sure that pop() and steal() cannot both miss each other's update when one item is left
+template <typename T>
+auto WorkStealingDeque<T>::pop() -> std::optional<T>
+{
+    const i64     bottom = bottom_.load( std::memory_order_relaxed ) - 1;
+    Buffer* const buffer = buffer_.load( std::memory_order_relaxed );
+    bottom_.store( bottom, std::memory_order_seq_cst );
+
+    i64 top = top_.load( std::memory_order_seq_cst );
+    if ( top > bottom ) {
+        bottom_.store( bottom + 1, std::memory_order_relaxed );
+        return std::nullopt;
+    }
+
+    std::optional<T> item = buffer->load( bottom );
+    if ( top == bottom ) {
+        // Last item, race the thieves for it
+        if ( !top_.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+            item.reset();
+        }
+        bottom_.store( bottom + 1, std::memory_order_relaxed );
+    }
+
+    return item;
+}
+
+template <typename T>
+auto WorkStealingDeque<T>::steal() -> std::optional<T>
+{
+    i64       top = top_.load( std::memory_order_seq_cst );
+    const i64 bottom = bottom_.load( std::memory_order_seq_cst );
+    if ( top >= bottom ) {
+        return std::nullopt;
+    }
+
+    const Buffer* const buffer = buffer_.load( std::memory_order_acquire );
+    const T             item = buffer->load( top );
+    if ( !top_.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+        return std::nullopt;
+    }
+
+    return item;
+}
+
+template <typename T>
+auto WorkStealingDeque<T>::get_size() const -> i64
+{
+    const i64 bottom = bottom_.load( std::memory_order_relaxed );
+    const i64 top = top_.load( std::memory_order_relaxed );
+    return bottom > top ? bottom - top : 0;
+}
+
+template <typename T>
+auto WorkStealingDeque<T>::grow( Buffer* const buffer, const i64 bottom, const i64 top ) -> Buffer*
+{
+    buffers_.push_back( std::make_unique<Buffer>( buffer->capacity * 2 ) );
+    Buffer* const grown = buffers_.back().get();
+
+    for ( i64 i = top; i < bottom; ++i ) {
+        grown->store( i, buffer->load( i ) );
+    }
+
+    buffer_.store( grown, std::memory_order_release );
+    return grown;
+}
+
+} // namespace mksv
@@ -0,0 +1,72 @@
+#include "mksv/jobs/job_counter.hpp"
+
+#include <cassert>
+
+namespace mksv
+{
+
+JobCounter::JobCounter()
+    : value_{ 0 }
+{
+}
+
+JobCounter::~JobCounter()
+{
+    assert( value_.load() == 0 && waiters_.empty() && "Counter destroyed with unfinished jobs" );
+}
+
+auto JobCounter::is_done() const -> bool
+{
+    return value_.load( std::memory_order_acquire ) == 0;
+}
+
+auto JobCounter::get_value() const -> u32
+{
+    return value_.load( std::memory_order_acquire );
+}
+
+auto JobCounter::increment( const u32 count ) -> void
+{
+    value_.fetch_add( count, std::memory_order_relaxed );
+}
+
+auto JobCounter::decrement() -> std::vector<Job*>
+{
+    // Decrements that cannot reach zero skip the lock
+    u32 value = value_.load( std::memory_order_relaxed );
+    while ( value > 1 ) {
+        if ( value_.compare_exchange_weak( value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed ) ) {
+            return {};
+        }
+    }
+
+    // The last one holds the lock while the counter reaches zero, which synchronize() waits for
+    std::vector<Job*> ready;
+    {
+        std::lock_guard lock{ mutex_ };
+        assert( value_.load( std::memory_order_relaxed ) > 0 && "Counter decremented below zero" );
+        if ( value_.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+            ready.swap( waiters_ );
+        }
+    }
+
+    return ready;
+}
+
+auto JobCounter::add_waiter( Job* const job ) -> bool
+{
+    std::lock_guard lock{ mutex_ };
+    if ( value_.load( std::memory_order_acquire ) == 0 ) {
+        return false;
+    }
+
+    waiters_.push_back( job );
+    return true;
+}
+
+auto JobCounter::synchronize() -> void
+{
+    std::lock_guard lock{ mutex_ };
+}
+
+} // namespace mksv
@@ -0,0 +1,289 @@
+#include "mksv/jobs/job_system.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace mksv
+{
+namespace
+{
+// Rounds of looking for work before an idle worker goes to sleep
+constexpr u32 IDLE_SPIN_COUNT = 64;
+
+struct WorkerContext {
+    const JobSystem* system;
+    u32              worker;
+};
+
+thread_local WorkerContext current_worker = { nullptr, JobSystem::INVALID_WORKER };
+} // namespace
+
+auto JobSystem::create( const u32 worker_count, const bool pin_workers ) -> std::unique_ptr<JobSystem>
+{
+    u32 count = worker_count;
+    if ( count == 0 ) {
+        count = std::max( 1u, std::thread::hardware_concurrency() ) - 1;
+    }
+
+    return std::unique_ptr<JobSystem>{ new JobSystem( count, pin_workers ) };
+}
+
+JobSystem::JobSystem( const u32 worker_count, const bool pin_workers )
+    : worker_count_{ worker_count },
+      pin_workers_{ pin_workers },
+      injected_count_{ 0 },
+      queued_{ 0 },
+      sleeping_{ 0 }
+{
+    deques_.reserve( worker_count_ );
+    for ( u32 worker = 0; worker < worker_count_; ++worker ) {
+        deques_.push_back( std::make_unique<WorkStealingDeque<Job*>>() );
+    }
+
+    workers_.reserve( worker_count_ );
+    for ( u32 worker = 0; worker < worker_count_; ++worker ) {
+        workers_.emplace_back( [this, worker]( const std::stop_token stop_token ) {
+            worker_main( stop_token, worker );
+        } );
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    for ( auto& worker : workers_ ) {
+        worker.request_stop();
+    }
+    work_cv_.notify_all();
+
+    // Joins the workers, nothing else touches the queues afterwards
+    workers_.clear();
+
+    for ( auto& deque : deques_ ) {
+        while ( const std::optional<Job*> job = deque->pop() ) {
+            delete *job;
+        }
+    }
+
+    for ( Job* const job : injected_ ) {
+        delete job;
+    }
+}
+
+auto JobSystem::run( JobFunction function, JobCounter* const counter, JobCounter* const dependency ) -> void
+{
+    Job* const job = new Job{ .function = std::move( function ), .counter = counter };
+
+    if ( counter ) {
+        counter->increment( 1 );
+    }
+
+    // The job is queued by whichever job brings the dependency down to zero
+    if ( dependency && dependency->add_waiter( job ) ) {
+        return;
+    }
+
+    schedule( std::span{ &job, 1 } );
+}
+
+auto JobSystem::wait( JobCounter& counter ) -> void
+{
+    const u32 worker = get_worker_index();
+
+    while ( !counter.is_done() ) {
+        if ( Job* const job = find_job( worker ) ) {
+            execute( job );
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    counter.synchronize();
+}
+
+auto JobSystem::parallel_for( const u32 count, const u32 min_batch_size, const RangeFunction& function ) -> void
+{
+    if ( count == 0 ) {
+        return;
+    }
+
+    const u32 thread_count = worker_count_ + 1;
+    const u32 target_size = ( count + thread_count * BATCHES_PER_WORKER - 1 ) / ( thread_count * BATCHES_PER_WORKER );
+    const u32 batch_size = std::max( { 1u, min_batch_size, target_size } );
+    const u32 batch_count = ( count + batch_size - 1 ) / batch_size;
+
+    if ( batch_count == 1 || worker_count_ == 0 ) {
+        function( 0, count );
+        return;
+    }
+
+    // Batches are handed out dynamically, the helpers that start after the last one has been taken return right away
+    std::atomic<u32> next_batch{ 0 };
+    const auto       run_batches = [&]() {
+        for ( u32 batch = next_batch.fetch_add( 1, std::memory_order_relaxed ); batch < batch_count;
+              batch = next_batch.fetch_add( 1, std::memory_order_relaxed ) ) {
+            const u32 first = batch * batch_size;
+            function( first, std::min( batch_size, count - first ) );
+        }
+    };
+
+    JobCounter counter;
+
+    std::vector<Job*> helpers( std::min( batch_count - 1, worker_count_ ) );
+    for ( Job*& helper : helpers ) {
+        helper = new Job{ .function = run_batches, .counter = &counter };
+    }
+
+    counter.increment( static_cast<u32>( helpers.size() ) );
+    schedule( helpers );
+
+    run_batches();
+    wait( counter );
+}
+
+auto JobSystem::get_worker_count() const -> u32
+{
+    return worker_count_;
+}
+
+auto JobSystem::get_worker_index() const -> u32
+{
+    return current_worker.system == this ? current_worker.worker : INVALID_WORKER;
+}
+
+auto JobSystem::pin_thread( const u32 core ) -> bool
+{
+    const u32 core_count = std::max( 1u, std::thread::hardware_concurrency() );
+
+#if defined( _WIN32 )
+    const DWORD_PTR mask = DWORD_PTR{ 1 } << ( core % core_count % ( sizeof( DWORD_PTR ) * 8 ) );
+    return SetThreadAffinityMask( GetCurrentThread(), mask ) != 0;
+#elif defined( __linux__ )
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    CPU_SET( core % core_count % CPU_SETSIZE, &set );
+    return pthread_setaffinity_np( pthread_self(), sizeof( set ), &set ) == 0;
+#else
+    static_cast<void>( core );
+    static_cast<void>( core_count );
+    return false;
+#endif
+}
+
+auto JobSystem::schedule( const std::span<Job* const> jobs ) -> void
+{
+    if ( jobs.empty() ) {
+        return;
+    }
+
+    // Counted before they are visible so that a worker going to sleep cannot miss them
+    queued_.fetch_add( static_cast<u32>( jobs.size() ) );
+
+    const u32 worker = get_worker_index();
+    if ( worker != INVALID_WORKER ) {
+        for ( Job* const job : jobs ) {
+            deques_[worker]->push( job );
+        }
+    } else {
+        std::lock_guard lock{ injected_mutex_ };
+        injected_.insert( injected_.end(), jobs.begin(), jobs.end() );
+        injected_count_.fetch_add( static_cast<u32>( jobs.size() ), std::memory_order_release );
+    }
+
+    if ( sleeping_.load() > 0 ) {
+        std::lock_guard lock{ mutex_ };
+        if ( jobs.size() == 1 ) {
+            work_cv_.notify_one();
+        } else {
+            work_cv_.notify_all();
+        }
+    }
+}
+
+auto JobSystem::find_job( const u32 worker ) -> Job*
+{
+    Job* job = nullptr;
+
+    if ( worker != INVALID_WORKER ) {
+        job = deques_[worker]->pop().value_or( nullptr );
+    }
+
+    if ( !job && injected_count_.load( std::memory_order_acquire ) > 0 ) {
+        std::lock_guard lock{ injected_mutex_ };
+        if ( !injected_.empty() ) {
+            job = injected_.front();
+            injected_.pop_front();
+            injected_count_.fetch_sub( 1, std::memory_order_relaxed );
+        }
+    }
+
+    // Victims are visited starting from the next worker so that thieves spread out
+    const u32 start = worker == INVALID_WORKER ? 0 : worker + 1;
+    for ( u32 i = 0; !job && i < worker_count_; ++i ) {
+        const u32 victim = ( start + i ) % worker_count_;
+        if ( victim != worker ) {
+            job = deques_[victim]->steal().value_or( nullptr );
+        }
+    }
+
+    if ( job ) {
+        queued_.fetch_sub( 1 );
+    }
+
+    return job;
+}
+
+auto JobSystem::execute( Job* const job ) -> void
+{
+    // The function and whatever it captured is gone before the counter can let a waiter return
+    {
+        const JobFunction function = std::move( job->function );
+        function();
+    }
+
+    if ( job->counter ) {
+        const std::vector<Job*> ready = job->counter->decrement();
+        schedule( ready );
+    }
+
+    delete job;
+}
+
+auto JobSystem::worker_main( const std::stop_token stop_token, const u32 worker ) -> void
+{
+    current_worker = { this, worker };
+
+    if ( pin_workers_ ) {
+        pin_thread( worker + 1 );
+    }
+
+    u32 idle_rounds = 0;
+    while ( !stop_token.stop_requested() ) {
+        if ( Job* const job = find_job( worker ) ) {
+            execute( job );
+            idle_rounds = 0;
+            continue;
+        }
+
+        if ( ++idle_rounds < IDLE_SPIN_COUNT ) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock lock{ mutex_ };
+        sleeping_.fetch_add( 1 );
+        work_cv_.wait( lock, stop_token, [this] { return queued_.load() > 0; } );
+        sleeping_.fetch_sub( 1 );
+        idle_rounds = 0;
+    }
+}
+
+} // namespace mksv
@@ -0,0 +1,150 @@
+#include "mksv/jobs/radix_sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 RADIX_BITS = 8;
+constexpr u32 RADIX_BUCKETS = 1u << RADIX_BITS;
+constexpr u32 RADIX_PASSES = 64 / RADIX_BITS;
+
+using Histogram = std::array<u32, RADIX_BUCKETS>;
+
+auto get_digit( const u64 key, const u32 pass ) -> u32
+{
+    return static_cast<u32>( key >> ( pass * RADIX_BITS ) ) & ( RADIX_BUCKETS - 1 );
+}
+
+// Calls function( block ) for every block, on the job system when there is one
+template <typename Function>
+auto for_each_block( JobSystem* const jobs, const u32 block_count, const Function& function ) -> void
+{
+    if ( !jobs || block_count == 1 ) {
+        for ( u32 block = 0; block < block_count; ++block ) {
+            function( block );
+        }
+        return;
+    }
+
+    jobs->parallel_for( block_count, 1, [&function]( const u32 first, const u32 count ) {
+        for ( u32 block = first; block < first + count; ++block ) {
+            function( block );
+        }
+    } );
+}
+} // namespace
+
+auto radix_sort(
+    const std::span<u64> keys,
+    const std::span<u32> values,
+    const std::span<u64> key_scratch,
+    const std::span<u32> value_scratch,
+    JobSystem* const     jobs
+) -> void
+{
+    assert( values.size() == keys.size() );
+    assert( key_scratch.size() >= keys.size() && value_scratch.size() >= keys.size() );
+
+    const u32 count = static_cast<u32>( keys.size() );
+    if ( count < 2 ) {
+        return;
+    }
+
+    u32 block_count = 1;
+    if ( jobs ) {
+        const u32 max_block_count = ( jobs->get_worker_count() + 1 ) * JobSystem::BATCHES_PER_WORKER;
+        block_count = std::clamp( count / RADIX_MIN_BLOCK_SIZE, 1u, max_block_count );
+    }
+
+    // Rounding the size up can leave fewer blocks than asked for, but none of them empty
+    const u32 block_size = ( count + block_count - 1 ) / block_count;
+    block_count = ( count + block_size - 1 ) / block_size;
+
+    const auto get_block_first = [block_size]( const u32 block ) { return block * block_size; };
+    const auto get_block_end = [block_size, count]( const u32 block ) {
+        return std::min( count, ( block + 1 ) * block_size );
+    };
+
+    // Every digit of every block from one read of the keys. The totals stay valid whatever order the keys are in,
+    // the block histograms only until the first pass moves keys between blocks.
+    std::vector<std::array<Histogram, RADIX_PASSES>> histograms( block_count );
+    for_each_block( jobs, block_count, [&]( const u32 block ) {
+        std::array<Histogram, RADIX_PASSES>& block_histograms = histograms[block];
+        for ( u32 i = get_block_first( block ); i < get_block_end( block ); ++i ) {
+            const u64 key = keys[i];
+            for ( u32 pass = 0; pass < RADIX_PASSES; ++pass ) {
+                ++block_histograms[pass][get_digit( key, pass )];
+            }
+        }
+    } );
+
+    std::span<u64> source_keys = keys;
+    std::span<u32> source_values = values;
+    std::span<u64> target_keys = key_scratch.first( count );
+    std::span<u32> target_values = value_scratch.first( count );
+
+    std::vector<Histogram> offsets( block_count );
+    bool                   first_pass = true;
+
+    for ( u32 pass = 0; pass < RADIX_PASSES; ++pass ) {
+        const u32 shared_digit = get_digit( keys[0], pass );
+        u32       shared_count = 0;
+        for ( const std::array<Histogram, RADIX_PASSES>& block_histograms : histograms ) {
+            shared_count += block_histograms[pass][shared_digit];
+        }
+        if ( shared_count == count ) {
+            continue;
+        }
+
+        if ( !first_pass ) {
+            for_each_block( jobs, block_count, [&]( const u32 block ) {
+                Histogram& histogram = histograms[block][pass];
+                histogram.fill( 0 );
+                for ( u32 i = get_block_first( block ); i < get_block_end( block ); ++i ) {
+                    ++histogram[get_digit( source_keys[i], pass )];
+                }
+            } );
+        }
+        first_pass = false;
+
+        // Within every bucket the blocks follow each other in order
+        u32 offset = 0;
+        for ( u32 bucket = 0; bucket < RADIX_BUCKETS; ++bucket ) {
+            for ( u32 block = 0; block < block_count; ++block ) {
+                offsets[block][bucket] = offset;
+                offset += histograms[block][pass][bucket];
+            }
+        }
+
+        for_each_block( jobs, block_count, [&]( const u32 block ) {
+            Histogram& cursors = offsets[block];
+            for ( u32 i = get_block_first( block ); i < get_block_end( block ); ++i ) {
+                const u64 key = source_keys[i];
+                const u32 target = cursors[get_digit( key, pass )]++;
+                target_keys[target] = key;
+                target_values[target] = source_values[i];
+            }
+        } );
+
+        std::swap( source_keys, target_keys );
+        std::swap( source_values, target_values );
+    }
+
+    // An odd number of passes leaves the result in the scratch spans
+    if ( source_keys.data() != keys.data() ) {
+        for_each_block( jobs, block_count, [&]( const u32 block ) {
+            const u32 first = get_block_first( block );
+            const u32 end = get_block_end( block );
+            std::copy( source_keys.begin() + first, source_keys.begin() + end, keys.begin() + first );
+            std::copy( source_values.begin() + first, source_values.begin() + end, values.begin() + first );
+        } );
+    }
+}
+
+} // namespace mksv
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+// Row major with row vectors (v' = v * M), the layout of the renderer's mat4
+using RasterMatrix = std::array<f32, 16>;
+
+struct RasterVertex {
+    std::array<f32, 3> position;
+    std::array<f32, 3> color;
+};
+
+// Triangle list, the mesh data is not owned
+struct RasterMesh {
+    std::span<const RasterVertex> vertices;
+    std::span<const u32>          indices;
+};
+
+struct RasterDraw {
+    u32          mesh;
+    RasterMatrix mvp;
+};
+
+// Everything the rasterizer draws in a frame, independent of the engine so scenes can be built by tests and tools
+struct RasterScene {
+    std::array<f32, 4>      clear_color;
+    std::vector<RasterMesh> meshes;
+    std::vector<RasterDraw> draws;
+};
+} // namespace mksv
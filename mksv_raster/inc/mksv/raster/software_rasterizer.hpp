@@ -0,0 +1,96 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/raster/raster_scene.hpp"
+
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+class JobSystem;
+
+// CPU implementation of the engine draw path. It mirrors the pipeline state used by the engine: triangle lists,
+// back face culling with clockwise front faces, no depth target and an R8G8B8A8_UNORM color target.
+//
+// Draws are binned into screen tiles between begin_frame() and end_frame(). end_frame() rasterizes the tiles on the
+// job system, every tile by a single thread in draw order, so the result does not depend on the number of workers.
+class SoftwareRasterizer
+{
+public:
+    static inline constexpr u32 TILE_SIZE = 64;
+
+public:
+    static auto create( const u32 width, const u32 height ) -> std::unique_ptr<SoftwareRasterizer>;
+
+public:
+    SoftwareRasterizer( const SoftwareRasterizer& ) = delete;
+    SoftwareRasterizer( SoftwareRasterizer&& ) = delete;
+    auto operator=( const SoftwareRasterizer& ) -> SoftwareRasterizer& = delete;
+    auto operator=( SoftwareRasterizer&& ) -> SoftwareRasterizer& = delete;
+    ~SoftwareRasterizer() = default;
+
+public:
+    // Clears to the scene's clear color and draws its draws in order, a whole frame in one call
+    auto render( const RasterScene& scene, JobSystem* const jobs = nullptr ) -> void;
+
+    auto begin_frame( const std::array<f32, 4>& clear_color ) -> void;
+    auto draw_indexed( const RasterMesh& mesh, const RasterMatrix& mvp ) -> void;
+
+    // Without a job system the tiles are rasterized on the calling thread
+    auto end_frame( JobSystem* const jobs = nullptr ) -> void;
+
+    auto width() const -> u32;
+    auto height() const -> u32;
+    auto pitch() const -> u32;
+    auto color_buffer() const -> std::span<const u32>;
+    auto pixel( const u32 x, const u32 y ) const -> u32;
+
+private:
+    struct ClipVertex {
+        f32 x;
+        f32 y;
+        f32 z;
+        f32 w;
+        f32 r;
+        f32 g;
+        f32 b;
+    };
+
+    struct Triangle {
+        std::array<f32, 3>                edge_a;
+        std::array<f32, 3>                edge_b;
+        std::array<f32, 3>                edge_c;
+        std::array<bool, 3>               top_left;
+        std::array<f32, 3>                inv_w;
+        std::array<std::array<f32, 3>, 3> color_over_w;
+        i32                               min_x;
+        i32                               min_y;
+        i32                               max_x;
+        i32                               max_y;
+    };
+
+private:
+    SoftwareRasterizer( const u32 width, const u32 height );
+
+    auto clip_and_setup( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2 ) -> void;
+    auto setup_triangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2 ) -> void;
+    auto rasterize_tile( const u32 tile_index ) -> void;
+
+private:
+    u32 width_;
+    u32 height_;
+    u32 pitch_;
+    u32 tiles_x_;
+    u32 tiles_y_;
+    u32 clear_value_;
+
+    std::vector<u32>              color_buffer_;
+    std::vector<ClipVertex>       clip_vertices_;
+    std::vector<Triangle>         triangles_;
+    std::vector<std::vector<u32>> bins_;
+};
+
+} // namespace mksv
@@ -0,0 +1,568 @@
+#include "mksv/raster/software_rasterizer.hpp"
+
+#include "mksv/jobs/job_system.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#endif
+
+namespace mksv
+{
+namespace
+{
+#if defined( __AVX2__ )
+constexpr u32 LANE_COUNT = 8;
+
+using FloatLanes = __m256;
+using IntLanes = __m256i;
+using MaskLanes = __m256;
+
+auto splat( const f32 v ) -> FloatLanes
+{
+    return _mm256_set1_ps( v );
+}
+
+auto lane_offsets() -> FloatLanes
+{
+    return _mm256_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f );
+}
+
+auto add( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return _mm256_add_ps( a, b );
+}
+
+auto mul( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return _mm256_mul_ps( a, b );
+}
+
+auto div( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return _mm256_div_ps( a, b );
+}
+
+auto inside( const FloatLanes e, const bool top_left ) -> MaskLanes
+{
+    return top_left ? _mm256_cmp_ps( e, _mm256_setzero_ps(), _CMP_GE_OQ )
+                    : _mm256_cmp_ps( e, _mm256_setzero_ps(), _CMP_GT_OQ );
+}
+
+auto in_range( const FloatLanes x, const f32 lo, const f32 hi ) -> MaskLanes
+{
+    return _mm256_and_ps( _mm256_cmp_ps( x, splat( lo ), _CMP_GE_OQ ), _mm256_cmp_ps( x, splat( hi ), _CMP_LE_OQ ) );
+}
+
+auto mask_and( const MaskLanes a, const MaskLanes b ) -> MaskLanes
+{
+    return _mm256_and_ps( a, b );
+}
+
+auto mask_any( const MaskLanes m ) -> bool
+{
+    return _mm256_movemask_ps( m ) != 0;
+}
+
+auto to_unorm8( const FloatLanes v ) -> IntLanes
+{
+    const FloatLanes clamped = _mm256_min_ps( _mm256_max_ps( v, _mm256_setzero_ps() ), splat( 1.0f ) );
+    return _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps( clamped, splat( 255.0f ) ), splat( 0.5f ) ) );
+}
+
+auto pack_rgba8( const FloatLanes r, const FloatLanes g, const FloatLanes b ) -> IntLanes
+{
+    IntLanes rgba = _mm256_set1_epi32( static_cast<i32>( 0xFF000000u ) );
+    rgba = _mm256_or_si256( rgba, to_unorm8( r ) );
+    rgba = _mm256_or_si256( rgba, _mm256_slli_epi32( to_unorm8( g ), 8 ) );
+    rgba = _mm256_or_si256( rgba, _mm256_slli_epi32( to_unorm8( b ), 16 ) );
+    return rgba;
+}
+
+auto store_masked( u32* const dst, const IntLanes color, const MaskLanes mask ) -> void
+{
+    _mm256_maskstore_epi32( reinterpret_cast<int*>( dst ), _mm256_castps_si256( mask ), color );
+}
+#elif defined( __SSE2__ ) || defined( _M_X64 )
+constexpr u32 LANE_COUNT = 4;
+
+using FloatLanes = __m128;
+using IntLanes = __m128i;
+using MaskLanes = __m128;
+
+auto splat( const f32 v ) -> FloatLanes
+{
+    return _mm_set1_ps( v );
+}
+
+auto lane_offsets() -> FloatLanes
+{
+    return _mm_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f );
+}
+
+auto add( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return _mm_add_ps( a, b );
+}
+
+auto mul( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return _mm_mul_ps( a, b );
+}
+
+auto div( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return _mm_div_ps( a, b );
+}
+
+auto inside( const FloatLanes e, const bool top_left ) -> MaskLanes
+{
+    return top_left ? _mm_cmpge_ps( e, _mm_setzero_ps() ) : _mm_cmpgt_ps( e, _mm_setzero_ps() );
+}
+
+auto in_range( const FloatLanes x, const f32 lo, const f32 hi ) -> MaskLanes
+{
+    return _mm_and_ps( _mm_cmpge_ps( x, splat( lo ) ), _mm_cmple_ps( x, splat( hi ) ) );
+}
+
+auto mask_and( const MaskLanes a, const MaskLanes b ) -> MaskLanes
+{
+    return _mm_and_ps( a, b );
+}
+
+auto mask_any( const MaskLanes m ) -> bool
+{
+    return _mm_movemask_ps( m ) != 0;
+}
+
+auto to_unorm8( const FloatLanes v ) -> IntLanes
+{
+    const FloatLanes clamped = _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), splat( 1.0f ) );
+    return _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( clamped, splat( 255.0f ) ), splat( 0.5f ) ) );
+}
+
+auto pack_rgba8( const FloatLanes r, const FloatLanes g, const FloatLanes b ) -> IntLanes
+{
+    IntLanes rgba = _mm_set1_epi32( static_cast<i32>( 0xFF000000u ) );
+    rgba = _mm_or_si128( rgba, to_unorm8( r ) );
+    rgba = _mm_or_si128( rgba, _mm_slli_epi32( to_unorm8( g ), 8 ) );
+    rgba = _mm_or_si128( rgba, _mm_slli_epi32( to_unorm8( b ), 16 ) );
+    return rgba;
+}
+
+auto store_masked( u32* const dst, const IntLanes color, const MaskLanes mask ) -> void
+{
+    // The color buffer pitch is a multiple of the tile size, so a full lane group is always addressable
+    const IntLanes m = _mm_castps_si128( mask );
+    const IntLanes old = _mm_loadu_si128( reinterpret_cast<const IntLanes*>( dst ) );
+    const IntLanes blended = _mm_or_si128( _mm_and_si128( m, color ), _mm_andnot_si128( m, old ) );
+    _mm_storeu_si128( reinterpret_cast<IntLanes*>( dst ), blended );
+}
+#else
+constexpr u32 LANE_COUNT = 1;
+
+using FloatLanes = f32;
+using IntLanes = u32;
+using MaskLanes = bool;
+
+auto splat( const f32 v ) -> FloatLanes
+{
+    return v;
+}
+
+auto lane_offsets() -> FloatLanes
+{
+    return 0.0f;
+}
+
+auto add( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return a + b;
+}
+
+auto mul( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return a * b;
+}
+
+auto div( const FloatLanes a, const FloatLanes b ) -> FloatLanes
+{
+    return a / b;
+}
+
+auto inside( const FloatLanes e, const bool top_left ) -> MaskLanes
+{
+    return top_left ? e >= 0.0f : e > 0.0f;
+}
+
+auto in_range( const FloatLanes x, const f32 lo, const f32 hi ) -> MaskLanes
+{
+    return x >= lo && x <= hi;
+}
+
+auto mask_and( const MaskLanes a, const MaskLanes b ) -> MaskLanes
+{
+    return a && b;
+}
+
+auto mask_any( const MaskLanes m ) -> bool
+{
+    return m;
+}
+
+auto to_unorm8( const FloatLanes v ) -> IntLanes
+{
+    return static_cast<u32>( std::clamp( v, 0.0f, 1.0f ) * 255.0f + 0.5f );
+}
+
+auto pack_rgba8( const FloatLanes r, const FloatLanes g, const FloatLanes b ) -> IntLanes
+{
+    return 0xFF000000u | to_unorm8( r ) | ( to_unorm8( g ) << 8 ) | ( to_unorm8( b ) << 16 );
+}
+
+auto store_masked( u32* const dst, const IntLanes color, const MaskLanes mask ) -> void
+{
+    if ( mask ) {
+        *dst = color;
+    }
+}
+#endif
+
+static_assert( SoftwareRasterizer::TILE_SIZE % LANE_COUNT == 0 );
+
+auto pack_clear_color( const std::array<f32, 4>& color ) -> u32
+{
+    const auto unorm8 = []( const f32 v ) {
+        return static_cast<u32>( std::clamp( v, 0.0f, 1.0f ) * 255.0f + 0.5f );
+    };
+
+    return unorm8( color[0] ) | ( unorm8( color[1] ) << 8 ) | ( unorm8( color[2] ) << 16 ) |
+           ( unorm8( color[3] ) << 24 );
+}
+
+} // namespace
+
+auto SoftwareRasterizer::create( const u32 width, const u32 height ) -> std::unique_ptr<SoftwareRasterizer>
+{
+    if ( width == 0 || height == 0 ) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SoftwareRasterizer>{ new SoftwareRasterizer( width, height ) };
+}
+
+SoftwareRasterizer::SoftwareRasterizer( const u32 width, const u32 height )
+    : width_{ width },
+      height_{ height },
+      pitch_{ ( width + TILE_SIZE - 1 ) / TILE_SIZE * TILE_SIZE },
+      tiles_x_{ ( width + TILE_SIZE - 1 ) / TILE_SIZE },
+      tiles_y_{ ( height + TILE_SIZE - 1 ) / TILE_SIZE },
+      clear_value_{ 0 }
+{
+    color_buffer_.resize( static_cast<usize>( pitch_ ) * height_ );
+    bins_.resize( static_cast<usize>( tiles_x_ ) * tiles_y_ );
+}
+
+auto SoftwareRasterizer::render( const RasterScene& scene, JobSystem* const jobs ) -> void
+{
+    begin_frame( scene.clear_color );
+    for ( const RasterDraw& draw : scene.draws ) {
+        assert( draw.mesh < scene.meshes.size() );
+        draw_indexed( scene.meshes[draw.mesh], draw.mvp );
+    }
+    end_frame( jobs );
+}
+
+auto SoftwareRasterizer::begin_frame( const std::array<f32, 4>& clear_color ) -> void
+{
+    clear_value_ = pack_clear_color( clear_color );
+    triangles_.clear();
+    for ( auto& bin : bins_ ) {
+        bin.clear();
+    }
+}
+
+auto SoftwareRasterizer::draw_indexed( const RasterMesh& mesh, const RasterMatrix& mvp ) -> void
+{
+    clip_vertices_.clear();
+    clip_vertices_.reserve( mesh.vertices.size() );
+
+    for ( const RasterVertex& vertex : mesh.vertices ) {
+        const auto& [x, y, z] = vertex.position;
+
+        // Row vector times the row major matrix
+        std::array<f32, 4> clip{};
+        for ( usize column = 0; column < 4; ++column ) {
+            clip[column] = x * mvp[column] + y * mvp[4 + column] + z * mvp[8 + column] + mvp[12 + column];
+        }
+        clip_vertices_.push_back(
+            { clip[0], clip[1], clip[2], clip[3], vertex.color[0], vertex.color[1], vertex.color[2] }
+        );
+    }
+
+    const std::span<const u32> indices = mesh.indices;
+    for ( usize i = 0; i + 2 < indices.size(); i += 3 ) {
+        assert( indices[i] < clip_vertices_.size() );
+        assert( indices[i + 1] < clip_vertices_.size() );
+        assert( indices[i + 2] < clip_vertices_.size() );
+
+        clip_and_setup( clip_vertices_[indices[i]], clip_vertices_[indices[i + 1]], clip_vertices_[indices[i + 2]] );
+    }
+}
+
+auto SoftwareRasterizer::end_frame( JobSystem* const jobs ) -> void
+{
+    const u32  tile_count = tiles_x_ * tiles_y_;
+    const auto rasterize_tiles = [this]( const u32 first, const u32 count ) {
+        for ( u32 tile = first; tile < first + count; ++tile ) {
+            rasterize_tile( tile );
+        }
+    };
+
+    if ( jobs ) {
+        jobs->parallel_for( tile_count, 1, rasterize_tiles );
+    } else {
+        rasterize_tiles( 0, tile_count );
+    }
+}
+
+auto SoftwareRasterizer::width() const -> u32
+{
+    return width_;
+}
+
+auto SoftwareRasterizer::height() const -> u32
+{
+    return height_;
+}
+
+auto SoftwareRasterizer::pitch() const -> u32
+{
+    return pitch_;
+}
+
+auto SoftwareRasterizer::color_buffer() const -> std::span<const u32>
+{
+    return color_buffer_;
+}
+
+auto SoftwareRasterizer::pixel( const u32 x, const u32 y ) const -> u32
+{
+    assert( x < width_ && y < height_ );
+    return color_buffer_[static_cast<usize>( y ) * pitch_ + x];
+}
+
+auto SoftwareRasterizer::clip_and_setup( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2 ) -> void
+{
+    const auto outside = [&]( auto&& distance ) {
+        return distance( v0 ) < 0.0f && distance( v1 ) < 0.0f && distance( v2 ) < 0.0f;
+    };
+
+    if ( outside( []( const ClipVertex& v ) { return v.w + v.x; } ) ||
+         outside( []( const ClipVertex& v ) { return v.w - v.x; } ) ||
+         outside( []( const ClipVertex& v ) { return v.w + v.y; } ) ||
+         outside( []( const ClipVertex& v ) { return v.w - v.y; } ) ) {
+        return;
+    }
+
+    const auto near_distance = []( const ClipVertex& v ) { return v.z; };
+    const auto far_distance = []( const ClipVertex& v ) { return v.w - v.z; };
+
+    const bool needs_clipping = std::min( { near_distance( v0 ), near_distance( v1 ), near_distance( v2 ) } ) < 0.0f ||
+                                std::min( { far_distance( v0 ), far_distance( v1 ), far_distance( v2 ) } ) < 0.0f;
+    if ( !needs_clipping ) {
+        setup_triangle( v0, v1, v2 );
+        return;
+    }
+
+    // Sutherland-Hodgman against the near and far planes. X and Y are handled by the viewport clamp.
+    constexpr usize MAX_POLYGON_VERTICES = 5;
+
+    std::array<ClipVertex, MAX_POLYGON_VERTICES> polygon{ v0, v1, v2 };
+    usize                                        count = 3;
+
+    const auto clip_polygon = [&]( auto&& distance ) {
+        std::array<ClipVertex, MAX_POLYGON_VERTICES> result{};
+        usize                                        result_count = 0;
+
+        for ( usize i = 0; i < count; ++i ) {
+            const ClipVertex& a = polygon[i];
+            const ClipVertex& b = polygon[( i + 1 ) % count];
+            const f32         da = distance( a );
+            const f32         db = distance( b );
+
+            if ( da >= 0.0f ) {
+                result[result_count++] = a;
+            }
+
+            if ( ( da >= 0.0f ) != ( db >= 0.0f ) ) {
+                const f32 t = da / ( da - db );
+                result[result_count++] = {
+                    a.x + ( b.x - a.x ) * t,
+                    a.y + ( b.y - a.y ) * t,
+                    a.z + ( b.z - a.z ) * t,
+                    a.w + ( b.w - a.w ) * t,
+                    a.r + ( b.r - a.r ) * t,
+                    a.g + ( b.g - a.g ) * t,
+                    a.b + ( b.b - a.b ) * t,
+                };
+            }
+        }
+
+        polygon = result;
+        count = result_count;
+    };
+
+    clip_polygon( near_distance );
+    clip_polygon( far_distance );
+
+    for ( usize i = 1; i + 1 < count; ++i ) {
+        setup_triangle( polygon[0], polygon[i], polygon[i + 1] );
+    }
+}
+
+auto SoftwareRasterizer::setup_triangle( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2 ) -> void
+{
+    const std::array<const ClipVertex*, 3> verts = { &v0, &v1, &v2 };
+
+    std::array<f32, 3> sx{};
+    std::array<f32, 3> sy{};
+    Triangle           tri{};
+
+    for ( usize i = 0; i < 3; ++i ) {
+        const f32 inv_w = 1.0f / verts[i]->w;
+        sx[i] = ( verts[i]->x * inv_w * 0.5f + 0.5f ) * static_cast<f32>( width_ );
+        sy[i] = ( 0.5f - verts[i]->y * inv_w * 0.5f ) * static_cast<f32>( height_ );
+        tri.inv_w[i] = inv_w;
+        tri.color_over_w[i] = { verts[i]->r * inv_w, verts[i]->g * inv_w, verts[i]->b * inv_w };
+    }
+
+    // Screen space is y-down, so clockwise (front facing) triangles have a positive area
+    const f32 area = ( sx[1] - sx[0] ) * ( sy[2] - sy[0] ) - ( sy[1] - sy[0] ) * ( sx[2] - sx[0] );
+    if ( !( area > 0.0f ) ) {
+        return;
+    }
+
+    const f32 inv_area = 1.0f / area;
+    for ( usize i = 0; i < 3; ++i ) {
+        const usize a = ( i + 1 ) % 3;
+        const usize b = ( i + 2 ) % 3;
+        const f32   dx = sx[b] - sx[a];
+        const f32   dy = sy[b] - sy[a];
+
+        // Edge functions are pre-scaled so they evaluate directly to barycentric coordinates
+        tri.edge_a[i] = -dy * inv_area;
+        tri.edge_b[i] = dx * inv_area;
+        tri.edge_c[i] = ( sx[a] * sy[b] - sx[b] * sy[a] ) * inv_area;
+        tri.top_left[i] = dy < 0.0f || ( dy == 0.0f && dx > 0.0f );
+    }
+
+    const f32 min_sx = std::min( { sx[0], sx[1], sx[2] } );
+    const f32 max_sx = std::max( { sx[0], sx[1], sx[2] } );
+    const f32 min_sy = std::min( { sy[0], sy[1], sy[2] } );
+    const f32 max_sy = std::max( { sy[0], sy[1], sy[2] } );
+
+    const f32 last_x = static_cast<f32>( width_ - 1 );
+    const f32 last_y = static_cast<f32>( height_ - 1 );
+    if ( max_sx < 0.0f || max_sy < 0.0f || min_sx > last_x || min_sy > last_y ) {
+        return;
+    }
+
+    // Clamped while still in float, vertices close to w = 0 land far outside the range of i32
+    tri.min_x = static_cast<i32>( std::floor( std::max( min_sx, 0.0f ) ) );
+    tri.min_y = static_cast<i32>( std::floor( std::max( min_sy, 0.0f ) ) );
+    tri.max_x = static_cast<i32>( std::ceil( std::min( max_sx, last_x ) ) );
+    tri.max_y = static_cast<i32>( std::ceil( std::min( max_sy, last_y ) ) );
+
+    const u32 index = static_cast<u32>( triangles_.size() );
+    triangles_.push_back( tri );
+
+    const u32 tile_min_x = static_cast<u32>( tri.min_x ) / TILE_SIZE;
+    const u32 tile_max_x = static_cast<u32>( tri.max_x ) / TILE_SIZE;
+    const u32 tile_min_y = static_cast<u32>( tri.min_y ) / TILE_SIZE;
+    const u32 tile_max_y = static_cast<u32>( tri.max_y ) / TILE_SIZE;
+
+    for ( u32 ty = tile_min_y; ty <= tile_max_y; ++ty ) {
+        for ( u32 tx = tile_min_x; tx <= tile_max_x; ++tx ) {
+            bins_[ty * tiles_x_ + tx].push_back( index );
+        }
+    }
+}
+
+auto SoftwareRasterizer::rasterize_tile( const u32 tile_index ) -> void
+{
+    const i32 tile_x0 = static_cast<i32>( tile_index % tiles_x_ * TILE_SIZE );
+    const i32 tile_y0 = static_cast<i32>( tile_index / tiles_x_ * TILE_SIZE );
+    const i32 tile_x1 = std::min( tile_x0 + static_cast<i32>( TILE_SIZE ), static_cast<i32>( width_ ) ) - 1;
+    const i32 tile_y1 = std::min( tile_y0 + static_cast<i32>( TILE_SIZE ), static_cast<i32>( height_ ) ) - 1;
+
+    for ( i32 y = tile_y0; y <= tile_y1; ++y ) {
+        u32* const row = color_buffer_.data() + static_cast<usize>( y ) * pitch_;
+        std::fill( row + tile_x0, row + tile_x0 + TILE_SIZE, clear_value_ );
+    }
+
+    const FloatLanes offsets = lane_offsets();
+    const FloatLanes lane_step = splat( static_cast<f32>( LANE_COUNT ) );
+
+    for ( const u32 triangle_index : bins_[tile_index] ) {
+        const Triangle& tri = triangles_[triangle_index];
+
+        const i32 x_begin = std::max( tri.min_x, tile_x0 );
+        const i32 x_end = std::min( tri.max_x, tile_x1 );
+        const i32 y_begin = std::max( tri.min_y, tile_y0 );
+        const i32 y_end = std::min( tri.max_y, tile_y1 );
+        const i32 x_start = x_begin - ( x_begin - tile_x0 ) % static_cast<i32>( LANE_COUNT );
+
+        for ( i32 y = y_begin; y <= y_end; ++y ) {
+            u32* const row = color_buffer_.data() + static_cast<usize>( y ) * pitch_;
+            const f32  py = static_cast<f32>( y ) + 0.5f;
+
+            FloatLanes x = add( splat( static_cast<f32>( x_start ) ), offsets );
+            for ( i32 x_lane = x_start; x_lane <= x_end; x_lane += static_cast<i32>( LANE_COUNT ) ) {
+                const FloatLanes px = add( x, splat( 0.5f ) );
+
+                const FloatLanes e0 =
+                    add( mul( splat( tri.edge_a[0] ), px ), splat( tri.edge_b[0] * py + tri.edge_c[0] ) );
+                const FloatLanes e1 =
+                    add( mul( splat( tri.edge_a[1] ), px ), splat( tri.edge_b[1] * py + tri.edge_c[1] ) );
+                const FloatLanes e2 =
+                    add( mul( splat( tri.edge_a[2] ), px ), splat( tri.edge_b[2] * py + tri.edge_c[2] ) );
+
+                MaskLanes mask = in_range( x, static_cast<f32>( x_begin ), static_cast<f32>( x_end ) );
+                mask = mask_and( mask, inside( e0, tri.top_left[0] ) );
+                mask = mask_and( mask, inside( e1, tri.top_left[1] ) );
+                mask = mask_and( mask, inside( e2, tri.top_left[2] ) );
+
+                if ( mask_any( mask ) ) {
+                    const FloatLanes one_over_w = add(
+                        add( mul( e0, splat( tri.inv_w[0] ) ), mul( e1, splat( tri.inv_w[1] ) ) ),
+                        mul( e2, splat( tri.inv_w[2] ) )
+                    );
+
+                    FloatLanes color[3];
+                    for ( usize c = 0; c < 3; ++c ) {
+                        const FloatLanes color_over_w = add(
+                            add(
+                                mul( e0, splat( tri.color_over_w[0][c] ) ),
+                                mul( e1, splat( tri.color_over_w[1][c] ) )
+                            ),
+                            mul( e2, splat( tri.color_over_w[2][c] ) )
+                        );
+                        color[c] = div( color_over_w, one_over_w );
+                    }
+
+                    store_masked( row + x_lane, pack_rgba8( color[0], color[1], color[2] ), mask );
+                }
+
+                x = add( x, lane_step );
+            }
+        }
+    }
+}
+
+} // namespace mksv
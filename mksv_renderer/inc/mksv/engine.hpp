@@ -1,23 +1,61 @@
 #pragma once
 
+#include "mksv/assets/mesh_file.hpp"
+#include "mksv/assets/shader_archive.hpp"
+#include "mksv/frame_stats.hpp"
+#include "mksv/graphics/barrier_recorder.hpp"
 #include "mksv/graphics/command_queue.hpp"
+#include "mksv/graphics/descriptor_allocator.hpp"
+#include "mksv/graphics/draw_queue.hpp"
+#include "mksv/graphics/frame_graph.hpp"
+#include "mksv/graphics/frame_scheduler.hpp"
+#include "mksv/graphics/frustum_culler.hpp"
+#include "mksv/graphics/gpu_profiler.hpp"
+#include "mksv/graphics/graphics_command_list_pool.hpp"
+#include "mksv/graphics/graphics_timestamp_query_pool.hpp"
+#include "mksv/graphics/graphics_upload_queue.hpp"
+#include "mksv/graphics/heap_allocator.hpp"
+#include "mksv/graphics/instance_batcher.hpp"
+#include "mksv/graphics/parallel_recorder.hpp"
+#include "mksv/graphics/pipeline_cache.hpp"
+#include "mksv/graphics/streaming_uploader.hpp"
+#include "mksv/graphics/upload_ring.hpp"
+#include "mksv/jobs/job_system.hpp"
 #include "mksv/keyboard.hpp"
+#include "mksv/math/types.hpp"
 #include "mksv/mksv_d3d12.hpp"
 #include "mksv/mksv_win.hpp"
 #include "mksv/mksv_wrl.hpp"
+#include "mksv/scene/transform_hierarchy.hpp"
 #include "mksv/win/window.hpp"
 #include "mksv/win/window_class.hpp"
 
+#include <array>
 #include <memory>
+#include <string_view>
+#include <vector>
 
 namespace mksv
 {
+class SoftwareRasterizer;
+
 class Engine
 {
     friend auto CALLBACK WndProc( HWND h_wnd, UINT msg, WPARAM w_param, LPARAM l_param ) -> LRESULT;
 
 public:
-    static auto create() -> std::unique_ptr<Engine>;
+    static inline constexpr u32 DEFAULT_FRAMES_IN_FLIGHT = Window::BACK_BUFFER_COUNT;
+    static inline constexpr u64 UPLOAD_STAGING_CAPACITY = 16 * 1024 * 1024;
+    static inline constexpr u64 DEFRAGMENT_BYTES_PER_FRAME = 4 * 1024 * 1024;
+    static inline constexpr u64 INSTANCE_RING_CAPACITY = 32 * 1024 * 1024;
+    static inline constexpr u32 STATS_INTERVAL = 256;
+    static inline constexpr u32 GPU_ZONES_PER_FRAME = 16;
+    static inline constexpr std::wstring_view PIPELINE_CACHE_PATH = L"pipeline_cache.bin";
+    static inline constexpr std::wstring_view SHADER_ARCHIVE_PATH = L"shaders.pak";
+    static inline constexpr std::wstring_view MESH_PATH = L"cube.mesh";
+
+public:
+    static auto create( const u32 frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT ) -> std::unique_ptr<Engine>;
 
 public:
     Engine( const Engine& ) = delete;
@@ -30,38 +68,146 @@ public:
     [[nodiscard]] auto init() -> bool;
     [[nodiscard]] auto copy_data() -> bool;
     auto               update() -> void;
+    auto               render_reference( SoftwareRasterizer& rasterizer ) const -> void;
+
+    // The scene is a set of cubes, each a node of the transform hierarchy. Objects without a parent hang off a
+    // static root node.
+    auto add_object(
+        const vec3&       translation,
+        const quat&       rotation,
+        const vec3&       scale,
+        const TransformId parent = INVALID_TRANSFORM
+    ) -> TransformId;
+    // Spins the object around its own center every frame, on top of the rotation it was added with. Only spinning
+    // objects and the ones below them have their world matrices recomputed.
+    auto set_spinning( const TransformId object ) -> void;
+    auto set_camera( const vec3& eye, const vec3& focus ) -> void;
+
+    // Draws every group of objects sharing mesh and pipeline with one instanced draw when enabled, the default, and
+    // every object with a draw of its own otherwise
+    auto set_instancing( const bool enabled ) -> void;
+
+    // Frame times and pacing of the last FrameStats::WINDOW_SIZE frames, dumps are set up through it as well
+    auto get_frame_stats() -> FrameStats&;
+    auto get_frame_stats() const -> const FrameStats&;
 
 private:
     Engine(
-        const HINSTANCE               h_instance,
-        std::unique_ptr<WindowClass>  window_class,
-        std::unique_ptr<Window>       window,
-        ComPtr<DXGIAdapter>           adapter,
-        ComPtr<D3D12Device>           device,
-        std::unique_ptr<CommandQueue> command_queue
+        const HINSTANCE                      h_instance,
+        std::unique_ptr<WindowClass>         window_class,
+        std::unique_ptr<DescriptorAllocator> descriptor_allocator,
+        std::unique_ptr<Window>              window,
+        ComPtr<DXGIAdapter>                  adapter,
+        ComPtr<D3D12Device>                  device,
+        std::unique_ptr<CommandQueue>        command_queue,
+        const u32                            frames_in_flight
     );
 
 private:
     auto GetKeyboard() -> Keyboard&;
+    auto end_frame() -> void;
+    auto record_draw_state( D3D12GraphicsCommandList* command_list, const D3D12_CPU_DESCRIPTOR_HANDLE rtv ) const
+        -> void;
+    auto draw_batches(
+        D3D12GraphicsCommandList*         command_list,
+        const D3D12_CPU_DESCRIPTOR_HANDLE rtv,
+        const DrawChunk                   chunk
+    ) const -> void;
+    auto draw_objects(
+        D3D12GraphicsCommandList*         command_list,
+        const D3D12_CPU_DESCRIPTOR_HANDLE rtv,
+        const DrawChunk                   chunk
+    ) const -> void;
+    auto report_frame_stats() -> void;
+    auto update_mesh_views() -> void;
+    auto get_clear_color() const -> std::array<f32, 4>;
+    auto get_spin() const -> quat;
+    auto get_view() const -> mat4;
+    auto get_view_projection() const -> mat4;
+    // Maps quantized mesh positions back into model space, identity for float positions
+    auto get_position_dequantization() const -> mat4;
 
 private:
     static inline u32 instance_count = 0;
 
-    HINSTANCE                        h_instance_;
-    std::unique_ptr<WindowClass>     window_class_;
-    std::unique_ptr<Window>          window_;
-    Keyboard                         keyboard_;
-    ComPtr<DXGIAdapter>              adapter_;
-    ComPtr<D3D12Device>              device_;
-    std::unique_ptr<CommandQueue>    command_queue_;
-    ComPtr<ID3D12CommandAllocator>   command_allocator_;
-    ComPtr<D3D12GraphicsCommandList> command_list_;
-    ComPtr<ID3D12Resource>           vertex_buffer_;
-    D3D12_VERTEX_BUFFER_VIEW         vertex_buffer_view_;
-    ComPtr<ID3D12Resource>           index_buffer_;
-    D3D12_INDEX_BUFFER_VIEW          index_buffer_view_;
-    ComPtr<ID3D12RootSignature>      root_signature_;
-    ComPtr<ID3D12PipelineState>      pipeline_state_;
+    // Ids the batcher groups objects by, there is a single mesh and pipeline so far
+    static inline constexpr u32 CUBE_MESH_ID = 0;
+    static inline constexpr u32 CUBE_PIPELINE_ID = 0;
+    static inline constexpr u32 CUBE_MATERIAL_ID = 0;
+
+    // Root constants of the cube pipeline, the transposed view projection and position dequantization
+    static inline constexpr u32 DRAW_CONSTANT_COUNT = 2 * sizeof( mat4 ) / sizeof( u32 );
+
+    HINSTANCE                    h_instance_;
+    std::unique_ptr<WindowClass> window_class_;
+
+    // Declared before the window so that it outlives the render target views the window allocates from it
+    std::unique_ptr<DescriptorAllocator> descriptor_allocator_;
+    std::unique_ptr<Window>              window_;
+    Keyboard                             keyboard_;
+    ComPtr<DXGIAdapter>                  adapter_;
+    ComPtr<D3D12Device>                  device_;
+    std::unique_ptr<CommandQueue>        command_queue_;
+    FrameScheduler                       frame_scheduler_;
+
+    // Frames are recorded by the calling thread and the recorder's workers, each with allocators of its own
+    std::unique_ptr<ParallelRecorder>        recorder_;
+    std::unique_ptr<GraphicsCommandListPool> command_list_pool_;
+
+    // Times the frame graph's passes on the GPU
+    std::unique_ptr<GraphicsTimestampQueryPool> timestamp_queries_;
+    std::unique_ptr<GpuProfiler>                gpu_profiler_;
+
+    std::unique_ptr<GraphicsUploadQueue> upload_queue_;
+    std::unique_ptr<StreamingUploader>   uploader_;
+    std::unique_ptr<UploadRing>          upload_ring_;
+    std::unique_ptr<HeapAllocator>       heap_allocator_;
+    BarrierRecorder                      barriers_;
+    std::unique_ptr<FrameGraph>          frame_graph_;
+    std::unique_ptr<ShaderArchive>       shader_archive_;
+    std::unique_ptr<MeshFile>            mesh_;
+    std::unique_ptr<PipelineCache>       pipeline_cache_;
+    HeapAllocationId                     vertex_buffer_;
+    D3D12_VERTEX_BUFFER_VIEW             vertex_buffer_view_;
+    HeapAllocationId                     index_buffer_;
+    D3D12_INDEX_BUFFER_VIEW              index_buffer_view_;
+    ComPtr<ID3D12RootSignature>          root_signature_;
+    ComPtr<ID3D12PipelineState>          pipeline_state_;
+    f32                                  angle_;
+    vec3                                 eye_;
+    vec3                                 focus_;
+
+    // Culls and sorts the draws, the recorder has threads of its own
+    std::unique_ptr<JobSystem> jobs_;
+
+    TransformHierarchy       transforms_;
+    TransformId              scene_root_;
+    std::vector<TransformId> objects_;
+    std::vector<TransformId> spinning_;
+    std::vector<quat>        spinning_rotations_;
+    FrustumCuller            culler_;
+    std::vector<u32>         visible_;
+    DrawQueue                draw_queue_;
+    InstanceBatcher          batcher_;
+    bool                     instancing_;
+
+    // Box around the mesh in model space, transformed into every object's world bounds
+    vec3 mesh_center_;
+    vec3 mesh_extent_;
+
+    // Times every frame, the scene advances by its interval
+    FrameStats frame_stats_;
+
+    // Accumulated over STATS_INTERVAL frames
+    u64 stats_transform_count_;
+    u64 stats_visible_count_;
+    u64 stats_draw_count_;
+    u64 stats_state_changes_;
+    u64 stats_unsorted_state_changes_;
+    f64 stats_transform_milliseconds_;
+    f64 stats_cull_milliseconds_;
+    f64 stats_sort_milliseconds_;
+    u32 stats_frame_count_;
 };
 
 } // namespace mksv
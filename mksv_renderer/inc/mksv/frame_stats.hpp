@@ -0,0 +1,129 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/latency_histogram.hpp"
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+namespace mksv
+{
+// In milliseconds, 0 for a metric without any frames
+struct FrameTimeSummary {
+    f64 mean;
+    f64 p50;
+    f64 p95;
+    f64 p99;
+};
+
+// Of the frames in the window, except for the totals
+struct FrameStatsSummary {
+    FrameTimeSummary interval;
+    FrameTimeSummary cpu;
+    FrameTimeSummary latency;
+    FrameTimeSummary gpu;
+    u32              frame_count;
+    u32              stutter_count;
+    u64              total_frame_count;
+    u64              total_stutter_count;
+};
+
+// Pacing telemetry over a rolling window of the last WINDOW_SIZE frames. Every frame gives
+// - the interval from the previous frame's begin to its own, the time the scene advances by
+// - the CPU time from its begin until its work was submitted
+// - the latency from the submission until the swap chain took the frame
+// - the GPU time of a frame read back by the GpuProfiler, frames_in_flight frames older than the frame itself
+//
+// Every metric has a histogram of its window that the frame leaving the window is removed from again, so memory stays
+// constant and percentiles are a walk over the buckets. A frame stutters when its interval is more than
+// STUTTER_FACTOR times the median interval of the window before it.
+class FrameStats
+{
+public:
+    static inline constexpr u32 WINDOW_SIZE = 1024;
+    static inline constexpr f64 STUTTER_FACTOR = 2.0;
+
+    // Frames in the window before stutters are counted, the first ones are slow while everything warms up
+    static inline constexpr u32 STUTTER_MIN_FRAMES = 32;
+
+public:
+    FrameStats();
+    FrameStats( const FrameStats& ) = default;
+    FrameStats( FrameStats&& ) = default;
+    auto operator=( const FrameStats& ) -> FrameStats& = default;
+    auto operator=( FrameStats&& ) -> FrameStats& = default;
+    ~FrameStats() = default;
+
+public:
+    auto begin_frame() -> void;
+    auto submit() -> void;
+    auto present() -> void;
+
+    // The same at a given time instead of now, for replaying recorded frames
+    auto begin_frame( const std::chrono::steady_clock::time_point now ) -> void;
+    auto submit( const std::chrono::steady_clock::time_point now ) -> void;
+    auto present( const std::chrono::steady_clock::time_point now ) -> void;
+
+    auto set_gpu_milliseconds( const f64 milliseconds ) -> void;
+
+    // Adds the frame to the window with the metrics it got, a frame that was not begun is ignored
+    auto end_frame() -> void;
+
+    // Interval of the current frame, 0 for the first one
+    auto get_delta_seconds() const -> f64;
+    auto get_summary() const -> FrameStatsSummary;
+
+    // Every interval frames, appends a row with the summary to csv_path and rewrites json_path with it. Either path
+    // may be empty, an interval of 0 stops the dumps.
+    auto set_dumps( const u32 interval, std::filesystem::path csv_path, std::filesystem::path json_path ) -> void;
+
+    // Writes the header first if the file is new or empty
+    auto append_csv( const std::filesystem::path& path ) const -> bool;
+    auto write_json( const std::filesystem::path& path ) const -> bool;
+
+private:
+    enum Metric : u32 {
+        METRIC_INTERVAL,
+        METRIC_CPU,
+        METRIC_LATENCY,
+        METRIC_GPU,
+        METRIC_COUNT,
+    };
+
+    // Metrics the frame did not get are NO_VALUE
+    struct Sample {
+        std::array<u32, METRIC_COUNT> microseconds;
+        bool                          stutter;
+    };
+
+    static inline constexpr u32 NO_VALUE = ~0u;
+
+private:
+    static auto to_microseconds( const std::chrono::steady_clock::duration duration ) -> u32;
+
+    auto summarize( const Metric metric ) const -> FrameTimeSummary;
+    auto dump() const -> void;
+
+private:
+    std::array<LatencyHistogram, METRIC_COUNT> histograms_;
+    std::vector<Sample>                        window_;
+    u32                                        window_next_;
+    u32                                        stutter_count_;
+    u64                                        total_frame_count_;
+    u64                                        total_stutter_count_;
+
+    // Of the frame between begin_frame() and end_frame()
+    Sample                                pending_;
+    bool                                  in_frame_;
+    std::chrono::steady_clock::time_point begin_time_;
+    std::chrono::steady_clock::time_point submit_time_;
+    f64                                   delta_seconds_;
+
+    u32                   dump_interval_;
+    std::filesystem::path dump_csv_path_;
+    std::filesystem::path dump_json_path_;
+};
+
+} // namespace mksv
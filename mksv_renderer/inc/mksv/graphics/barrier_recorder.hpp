@@ -0,0 +1,66 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/resource_state_tracker.hpp"
+#include "mksv/mksv_d3d12.hpp"
+
+#include <vector>
+
+namespace mksv
+{
+// D3D12 front end of ResourceStateTracker. Resources are declared with the state they need, and every transition
+// gathered since the last flush() is submitted with a single ResourceBarrier call.
+class BarrierRecorder
+{
+public:
+    static inline constexpr u32 ALL_SUBRESOURCES = ResourceStateTracker::ALL_SUBRESOURCES;
+
+    // States that may be combined, GENERIC_READ plus the read states it does not include
+    static inline constexpr D3D12_RESOURCE_STATES READ_ONLY_STATES =
+        D3D12_RESOURCE_STATE_GENERIC_READ | D3D12_RESOURCE_STATE_DEPTH_READ | D3D12_RESOURCE_STATE_RESOLVE_SOURCE |
+        D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE;
+
+public:
+    BarrierRecorder();
+
+public:
+    auto track(
+        ID3D12Resource*             resource,
+        const D3D12_RESOURCE_STATES initial_state,
+        const u32                   subresource_count = 1
+    ) -> void;
+    auto untrack( ID3D12Resource* resource ) -> void;
+
+    auto transition(
+        ID3D12Resource*             resource,
+        const D3D12_RESOURCE_STATES state,
+        const u32                   subresource = ALL_SUBRESOURCES
+    ) -> void;
+
+    // Starts a split barrier towards state, the next transition() to it on this resource only ends it
+    auto prepare(
+        ID3D12Resource*             resource,
+        const D3D12_RESOURCE_STATES state,
+        const u32                   subresource = ALL_SUBRESOURCES
+    ) -> void;
+
+    // after starts using memory that before, or any other placed resource when null, used so far
+    auto alias( ID3D12Resource* before, ID3D12Resource* after ) -> void;
+
+    // Orders unordered access to resource before and after the flush, it stays in the UNORDERED_ACCESS state
+    auto uav( ID3D12Resource* resource ) -> void;
+
+    // Returns the number of barriers recorded, aliasing barriers go first
+    auto flush( D3D12GraphicsCommandList* command_list ) -> u32;
+
+    auto get_state( ID3D12Resource* resource, const u32 subresource = 0 ) const -> D3D12_RESOURCE_STATES;
+
+private:
+    ResourceStateTracker                tracker_;
+    std::vector<ResourceTransition>     transitions_;
+    std::vector<D3D12_RESOURCE_BARRIER> aliasing_;
+    std::vector<D3D12_RESOURCE_BARRIER> uav_;
+    std::vector<D3D12_RESOURCE_BARRIER> barriers_;
+};
+
+} // namespace mksv
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <span>
+
+namespace mksv
+{
+// Opaque command list, a D3D12GraphicsCommandList* for GraphicsCommandListPool and a MockCommandList* for
+// MockCommandListPool
+using CommandListHandle = void*;
+
+// Hands out command lists to recording threads. Every worker index has its own command allocator per frame context,
+// so open() and close() may only be called by the thread currently acting as that worker, and a worker has at most
+// one list open at a time. begin_frame() and submit() belong to the thread that submits the frame. Implemented by
+// GraphicsCommandListPool on top of D3D12 and by MockCommandListPool for device-less use.
+class CommandListPool
+{
+public:
+    virtual ~CommandListPool() = default;
+
+public:
+    // Recycles the allocators of frame_index, the GPU has to be done with the lists last recorded for it
+    [[nodiscard]] virtual auto begin_frame( const u32 frame_index ) -> bool = 0;
+
+    // Returns nullptr on failure
+    [[nodiscard]] virtual auto open( const u32 worker ) -> CommandListHandle = 0;
+    [[nodiscard]] virtual auto close( const u32 worker, const CommandListHandle list ) -> bool = 0;
+
+    // Executes the closed lists in order with a single submission
+    virtual auto submit( const std::span<const CommandListHandle> lists ) -> void = 0;
+
+    virtual auto get_worker_count() const -> u32 = 0;
+};
+
+} // namespace mksv
@@ -1,14 +1,16 @@
 #pragma once
 
 #include "mksv/common/types.hpp"
+#include "mksv/graphics/fence.hpp"
 #include "mksv/mksv_d3d12.hpp"
 #include "mksv/mksv_wrl.hpp"
 
 #include <memory>
+#include <span>
 
 namespace mksv
 {
-class CommandQueue
+class CommandQueue final : public Fence
 {
 public:
     static auto create( ComPtr<D3D12Device> device, const D3D12_COMMAND_LIST_TYPE type ) -> std::unique_ptr<CommandQueue>;
@@ -18,16 +20,22 @@ public:
     CommandQueue( CommandQueue&& ) = default;
     auto operator=( const CommandQueue& ) -> CommandQueue& = delete;
     auto operator=( CommandQueue&& ) -> CommandQueue& = default;
-    ~CommandQueue();
+    ~CommandQueue() override;
 
 public:
     auto get_ptr() const -> ComPtr<ID3D12CommandQueue>;
     auto execute( ID3D12CommandList* const command_list ) -> void;
-    auto signal() -> u64;
+    auto execute( const std::span<ID3D12CommandList* const> command_lists ) -> void;
+    auto signal() -> u64 override;
+    auto get_completed_value() const -> u64 override;
+    auto wait_for_value( const u64 value ) -> bool override;
     auto is_fence_complete( const u64 fence_value ) const -> bool;
     auto wait_for_fence_value( const u64 fence_value ) -> HRESULT;
     auto flush() -> HRESULT;
 
+    // Work submitted to this queue from now on waits on the GPU until producer has reached fence_value
+    auto wait_on_gpu( const CommandQueue& producer, const u64 fence_value ) -> void;
+
 private:
     CommandQueue( ComPtr<ID3D12CommandQueue> queue, ComPtr<ID3D12Fence> fence, const HANDLE event );
 
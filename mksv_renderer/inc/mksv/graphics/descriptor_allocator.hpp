@@ -0,0 +1,74 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/descriptor_heap.hpp"
+#include "mksv/graphics/fence.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <array>
+#include <memory>
+
+namespace mksv
+{
+// Owns a CPU only DescriptorHeap for each of the four heap types, used for persistent descriptors that are staged
+// and copied, and the two shader visible heaps (CBV_SRV_UAV and SAMPLER) bound with SetDescriptorHeaps.
+class DescriptorAllocator
+{
+public:
+    static inline constexpr u32 CBV_SRV_UAV_CAPACITY = 4096;
+    static inline constexpr u32 SAMPLER_CAPACITY = 256;
+    static inline constexpr u32 RTV_CAPACITY = 256;
+    static inline constexpr u32 DSV_CAPACITY = 64;
+
+    static inline constexpr u32 SHADER_VISIBLE_CBV_SRV_UAV_CAPACITY = 4096;
+    static inline constexpr u32 DYNAMIC_CBV_SRV_UAV_CAPACITY = 16384;
+    static inline constexpr u32 SHADER_VISIBLE_SAMPLER_CAPACITY = 256;
+    static inline constexpr u32 DYNAMIC_SAMPLER_CAPACITY = D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE - 256;
+
+public:
+    static auto create( ComPtr<D3D12Device> device, Fence& fence ) -> std::unique_ptr<DescriptorAllocator>;
+
+public:
+    DescriptorAllocator( const DescriptorAllocator& ) = delete;
+    DescriptorAllocator( DescriptorAllocator&& ) = delete;
+    auto operator=( const DescriptorAllocator& ) -> DescriptorAllocator& = delete;
+    auto operator=( DescriptorAllocator&& ) -> DescriptorAllocator& = delete;
+    ~DescriptorAllocator() = default;
+
+public:
+    auto get_cpu_heap( const D3D12_DESCRIPTOR_HEAP_TYPE type ) -> DescriptorHeap&;
+
+    // Only CBV_SRV_UAV and SAMPLER have a shader visible heap
+    auto get_shader_visible_heap( const D3D12_DESCRIPTOR_HEAP_TYPE type ) -> DescriptorHeap&;
+    auto set_shader_visible_heaps( D3D12GraphicsCommandList* command_list ) const -> void;
+
+    // Copies count CPU only descriptors starting at source into a dynamic range of the matching shader visible heap
+    [[nodiscard]] auto stage(
+        const D3D12_DESCRIPTOR_HEAP_TYPE  type,
+        const D3D12_CPU_DESCRIPTOR_HANDLE source,
+        const u32                         count
+    ) -> std::optional<DescriptorRange>;
+
+    auto submit( const u64 fence_value ) -> void;
+    auto retire() -> void;
+
+private:
+    using CpuHeaps = std::array<std::unique_ptr<DescriptorHeap>, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES>;
+
+private:
+    DescriptorAllocator(
+        ComPtr<D3D12Device>             device,
+        CpuHeaps                        cpu_heaps,
+        std::unique_ptr<DescriptorHeap> resource_heap,
+        std::unique_ptr<DescriptorHeap> sampler_heap
+    );
+
+private:
+    ComPtr<D3D12Device>             device_;
+    CpuHeaps                        cpu_heaps_;
+    std::unique_ptr<DescriptorHeap> resource_heap_;
+    std::unique_ptr<DescriptorHeap> sampler_heap_;
+};
+
+} // namespace mksv
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/fence.hpp"
+#include "mksv/graphics/index_free_list.hpp"
+#include "mksv/graphics/ring_allocator.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <deque>
+#include <memory>
+#include <optional>
+
+namespace mksv
+{
+struct Descriptor {
+    D3D12_CPU_DESCRIPTOR_HANDLE cpu;
+    D3D12_GPU_DESCRIPTOR_HANDLE gpu;
+    u32                         index;
+};
+
+// Contiguous descriptors for a descriptor table, gpu is zero for heaps that are not shader visible
+struct DescriptorRange {
+    D3D12_CPU_DESCRIPTOR_HANDLE cpu;
+    D3D12_GPU_DESCRIPTOR_HANDLE gpu;
+    u32                         first;
+    u32                         count;
+    u32                         descriptor_size;
+};
+
+// One ID3D12DescriptorHeap split into a persistent region, handed out one descriptor at a time from an
+// IndexFreeList, followed by an optional dynamic region that is a RingAllocator of descriptor ranges recycled by
+// fence value. allocate(), free() and allocate_dynamic() are lock-free and may be called from any thread, submit()
+// and retire() belong to the thread that submits the frame. A heap is shader visible exactly when it has a dynamic
+// region.
+//
+// Persistent descriptors of a shader visible heap may still be read by the GPU when freed, so they are only reused
+// once the fence value passed to the next submit() completes. CPU only descriptors are copied when recorded and are
+// reused immediately.
+class DescriptorHeap
+{
+public:
+    static auto create(
+        ComPtr<D3D12Device>              device,
+        Fence&                           fence,
+        const D3D12_DESCRIPTOR_HEAP_TYPE type,
+        const u32                        persistent_capacity,
+        const u32                        dynamic_capacity = 0
+    ) -> std::unique_ptr<DescriptorHeap>;
+
+public:
+    DescriptorHeap( const DescriptorHeap& ) = delete;
+    DescriptorHeap( DescriptorHeap&& ) = delete;
+    auto operator=( const DescriptorHeap& ) -> DescriptorHeap& = delete;
+    auto operator=( DescriptorHeap&& ) -> DescriptorHeap& = delete;
+    ~DescriptorHeap() = default;
+
+public:
+    [[nodiscard]] auto allocate() -> std::optional<Descriptor>;
+    auto               free( const Descriptor& descriptor ) -> void;
+
+    // Only valid for the frame that allocated it, the range is recycled once that frame's fence value completes
+    [[nodiscard]] auto allocate_dynamic( const u32 count ) -> std::optional<DescriptorRange>;
+
+    auto submit( const u64 fence_value ) -> void;
+    auto retire() -> void;
+
+    auto get_ptr() const -> ID3D12DescriptorHeap*;
+    auto get_type() const -> D3D12_DESCRIPTOR_HEAP_TYPE;
+    auto get_descriptor_size() const -> u32;
+    auto get_cpu_handle( const u32 index ) const -> D3D12_CPU_DESCRIPTOR_HANDLE;
+    auto get_gpu_handle( const u32 index ) const -> D3D12_GPU_DESCRIPTOR_HANDLE;
+    auto is_shader_visible() const -> bool;
+    auto get_persistent_free_count() const -> u32;
+
+private:
+    struct Batch {
+        u64 fence_value;
+        u32 first;
+    };
+
+private:
+    DescriptorHeap(
+        Fence&                           fence,
+        ComPtr<ID3D12DescriptorHeap>     heap,
+        const D3D12_DESCRIPTOR_HEAP_TYPE type,
+        const u32                        descriptor_size,
+        const u32                        persistent_capacity,
+        const u32                        dynamic_capacity
+    );
+
+private:
+    Fence*                       fence_;
+    ComPtr<ID3D12DescriptorHeap> heap_;
+    D3D12_DESCRIPTOR_HEAP_TYPE   type_;
+    u32                          descriptor_size_;
+    D3D12_CPU_DESCRIPTOR_HANDLE  cpu_start_;
+    D3D12_GPU_DESCRIPTOR_HANDLE  gpu_start_;
+    u32                          persistent_capacity_;
+
+    IndexFreeList                free_list_;
+    IndexFreeList                pending_frees_;
+    std::optional<RingAllocator> dynamic_;
+
+    // Touched only by the thread calling submit() and retire()
+    std::deque<Batch> batches_;
+};
+
+} // namespace mksv
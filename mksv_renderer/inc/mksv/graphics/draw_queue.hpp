@@ -0,0 +1,85 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+enum class DrawLayer : u8 {
+    Opaque = 0,
+    Transparent = 1,
+};
+
+// Changes between consecutive draws, the first draw counts as a change of everything
+struct DrawStateChanges {
+    u32 pipeline;
+    u32 material;
+    u32 mesh;
+};
+
+// Draws of a frame as 64-bit sort keys, each with a payload that identifies the draw to the caller. Keys are laid out
+// from the most significant bit down as
+//
+//     opaque       layer:1  pipeline:11  material:12  mesh:16  depth:24
+//     transparent  layer:1  ~depth:24  pipeline:11  material:12  mesh:16
+//
+// so that all opaque draws come first, grouped by state and front to back within a group, and the transparent ones
+// after them back to front, state only breaking ties. Depth is the view space distance, compared by its float bits.
+class DrawQueue
+{
+public:
+    static inline constexpr u32 PIPELINE_BITS = 11;
+    static inline constexpr u32 MATERIAL_BITS = 12;
+    static inline constexpr u32 MESH_BITS = 16;
+    static inline constexpr u32 DEPTH_BITS = 24;
+
+    static_assert( 1 + PIPELINE_BITS + MATERIAL_BITS + MESH_BITS + DEPTH_BITS == 64 );
+
+public:
+    // The ids have to fit their fields, negative depths are clamped to 0
+    static auto make_key(
+        const DrawLayer layer,
+        const u32       pipeline,
+        const u32       material,
+        const u32       mesh,
+        const f32       depth
+    ) -> u64;
+
+    static auto get_layer( const u64 key ) -> DrawLayer;
+    static auto get_pipeline( const u64 key ) -> u32;
+    static auto get_material( const u64 key ) -> u32;
+    static auto get_mesh( const u64 key ) -> u32;
+
+    static auto count_state_changes( const std::span<const u64> keys ) -> DrawStateChanges;
+
+public:
+    DrawQueue() = default;
+    DrawQueue( const DrawQueue& ) = delete;
+    DrawQueue( DrawQueue&& ) = default;
+    auto operator=( const DrawQueue& ) -> DrawQueue& = delete;
+    auto operator=( DrawQueue&& ) -> DrawQueue& = default;
+    ~DrawQueue() = default;
+
+public:
+    // Drops the draws of the previous frame but keeps their memory
+    auto reset() -> void;
+    auto push( const u64 key, const u32 payload ) -> void;
+
+    // Radix sorts the draws by key, on the job system if there is one. Draws with equal keys keep their push order.
+    auto sort( JobSystem* const jobs = nullptr ) -> void;
+
+    auto get_keys() const -> std::span<const u64>;
+    auto get_payloads() const -> std::span<const u32>;
+    auto get_count() const -> u32;
+
+private:
+    std::vector<u64> keys_;
+    std::vector<u32> payloads_;
+    std::vector<u64> key_scratch_;
+    std::vector<u32> payload_scratch_;
+};
+
+} // namespace mksv
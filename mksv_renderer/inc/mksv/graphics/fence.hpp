@@ -0,0 +1,20 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+namespace mksv
+{
+// Monotonic timeline shared between the CPU and a queue. Implemented by CommandQueue on top of an ID3D12Fence and
+// by MockFence for device-less use.
+class Fence
+{
+public:
+    virtual ~Fence() = default;
+
+public:
+    virtual auto signal() -> u64 = 0;
+    virtual auto get_completed_value() const -> u64 = 0;
+    virtual auto wait_for_value( const u64 value ) -> bool = 0;
+};
+
+} // namespace mksv
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/barrier_recorder.hpp"
+#include "mksv/graphics/fence.hpp"
+#include "mksv/graphics/gpu_profiler.hpp"
+#include "mksv/graphics/parallel_recorder.hpp"
+#include "mksv/graphics/render_graph.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace mksv
+{
+// D3D12 front end of RenderGraph. Every frame the passes are declared again with the callback that records them,
+// then execute() compiles the graph, places the transient textures in one shared heap and records the live passes
+// with their barriers. Parallel passes split their draws into chunks the ParallelRecorder records as jobs,
+// every other pass and all barriers go into its serial list.
+//
+// Transient textures are render targets or depth stencils (resource heap tier 1), their content is undefined when
+// their first pass starts so that pass has to clear or discard them. The heap and the placed resources are only
+// recreated when the transient layout changes, the previous ones are released once the fence value passed to the
+// next submit() completes.
+class FrameGraph
+{
+public:
+    using ExecuteCallback = std::function<void( D3D12GraphicsCommandList* command_list )>;
+
+    // Called concurrently for different chunks, each on a list without any state set
+    using ChunkCallback = std::function<void( D3D12GraphicsCommandList* command_list, const DrawChunk chunk )>;
+
+public:
+    static auto create( ComPtr<D3D12Device> device, Fence& fence ) -> std::unique_ptr<FrameGraph>;
+
+public:
+    FrameGraph( const FrameGraph& ) = delete;
+    FrameGraph( FrameGraph&& ) = delete;
+    auto operator=( const FrameGraph& ) -> FrameGraph& = delete;
+    auto operator=( FrameGraph&& ) -> FrameGraph& = delete;
+    ~FrameGraph() = default;
+
+public:
+    auto reset() -> void;
+
+    // The resource has to be tracked by the BarrierRecorder passed to execute()
+    auto import_resource( ID3D12Resource* resource ) -> RenderGraphResource;
+
+    [[nodiscard]] auto create_texture( const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clear_value = nullptr )
+        -> RenderGraphResource;
+
+    auto export_resource( const RenderGraphResource resource, const D3D12_RESOURCE_STATES final_state ) -> void;
+
+    // name has to outlive the frame, a string literal in practice
+    auto add_pass( const std::string_view name, ExecuteCallback execute ) -> RenderPassBuilder;
+    auto add_parallel_pass( const std::string_view name, const u32 draw_count, ChunkCallback record )
+        -> RenderPassBuilder;
+
+    // Only valid inside the pass callbacks, transient textures do not exist before execute()
+    auto get_resource( const RenderGraphResource resource ) const -> ID3D12Resource*;
+
+    // The recorder has to be between begin() and finish() on a GraphicsCommandListPool. With a GpuProfiler every pass
+    // is timed as a zone named after it, without the barriers before and after it.
+    [[nodiscard]] auto execute(
+        ParallelRecorder& recorder,
+        BarrierRecorder&  barriers,
+        GpuProfiler*      gpu_profiler = nullptr
+    ) -> bool;
+
+    auto submit( const u64 fence_value ) -> void;
+    auto retire() -> void;
+
+    auto get_graph() const -> const RenderGraph&;
+
+private:
+    struct Callback {
+        ExecuteCallback execute;
+        ChunkCallback   record;
+        u32             draw_count;
+    };
+
+    struct Texture {
+        D3D12_RESOURCE_DESC              desc;
+        std::optional<D3D12_CLEAR_VALUE> clear_value;
+        D3D12_RESOURCE_ALLOCATION_INFO   info;
+        u64                              offset;
+        ComPtr<ID3D12Resource>           resource;
+    };
+
+    struct PendingRelease {
+        ComPtr<ID3D12Heap>                  heap;
+        std::vector<ComPtr<ID3D12Resource>> resources;
+        u64                                 fence_value;
+    };
+
+private:
+    FrameGraph( ComPtr<D3D12Device> device, Fence& fence );
+
+    static auto is_same_texture( const Texture& a, const Texture& b ) -> bool;
+
+    auto is_realized() const -> bool;
+    auto realize_transients( BarrierRecorder& barriers ) -> bool;
+    auto release_transients( BarrierRecorder& barriers ) -> void;
+    auto record_barriers( BarrierRecorder& barriers, const u32 first, const u32 count ) const -> void;
+
+private:
+    static inline constexpr u64 OPEN_BATCH = ~0ull;
+
+    ComPtr<D3D12Device> device_;
+    Fence*              fence_;
+    RenderGraph         graph_;
+
+    // Indexed by RenderGraphPass
+    std::vector<Callback> callbacks_;
+
+    // Indexed by RenderGraphResource, the textures_ entries of imported resources are empty
+    std::vector<ID3D12Resource*> resources_;
+    std::vector<Texture>         textures_;
+
+    // What the current heap holds, compared against textures_ to detect a new transient layout
+    ComPtr<ID3D12Heap>   heap_;
+    u64                  heap_size_;
+    std::vector<Texture> realized_;
+
+    std::vector<PendingRelease> pending_releases_;
+};
+
+} // namespace mksv
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/fence.hpp"
+
+#include <vector>
+
+namespace mksv
+{
+// Round-robins over a fixed number of frame contexts. begin_frame() only blocks until the GPU is done with the
+// context being reused, so up to frames_in_flight frames can be queued at once.
+class FrameScheduler
+{
+public:
+    FrameScheduler( Fence& fence, const u32 frames_in_flight );
+    FrameScheduler( const FrameScheduler& ) = default;
+    FrameScheduler( FrameScheduler&& ) = default;
+    auto operator=( const FrameScheduler& ) -> FrameScheduler& = default;
+    auto operator=( FrameScheduler&& ) -> FrameScheduler& = default;
+    ~FrameScheduler() = default;
+
+public:
+    [[nodiscard]] auto begin_frame() -> u32;
+    auto               end_frame() -> u64;
+    auto               wait_idle() -> bool;
+
+    auto get_frames_in_flight() const -> u32;
+    auto get_current_index() const -> u32;
+    auto get_frame_number() const -> u64;
+    auto get_context_fence_value( const u32 index ) const -> u64;
+    auto get_stall_count() const -> u64;
+
+private:
+    Fence*           fence_;
+    std::vector<u64> fence_values_;
+    u32              current_index_;
+    u64              frame_number_;
+    u64              stall_count_;
+    bool             in_frame_;
+};
+
+} // namespace mksv
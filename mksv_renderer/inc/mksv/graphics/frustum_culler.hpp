@@ -0,0 +1,105 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+#include "mksv/math/types.hpp"
+#include "mksv/scene/transform_hierarchy.hpp"
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+// Planes as ( normal, distance ) with normalized normals pointing inside, in the order left, right, bottom, top,
+// near, far
+struct Frustum {
+    std::array<vec4, 6> planes;
+};
+
+// Planes of the clip volume of a row vector view projection matrix with D3D depth, 0 <= z <= w
+auto extract_frustum( const mat4& view_projection ) -> Frustum;
+
+enum class CullShape : u8 {
+    Sphere,
+    Box,
+};
+
+// Object bounds in structure of arrays form, tested against a frustum a full SIMD register of objects at a time:
+// 16 with AVX-512, 8 with AVX2 and 4 with SSE2, the scalar code handles the rest. Every object has an axis aligned
+// box and the sphere around it. The sphere test is cheaper, the box test culls more.
+//
+// Culling writes the indices of the visible objects, compacted and in ascending order. Objects are conservatively
+// kept when their bounds only intersect the planes outside of the frustum's corners.
+class FrustumCuller
+{
+public:
+    // Objects per block when culling on a job system
+    static inline constexpr u32 MIN_BLOCK_SIZE = 16 * 1024;
+
+public:
+    FrustumCuller() = default;
+    FrustumCuller( const FrustumCuller& ) = delete;
+    FrustumCuller( FrustumCuller&& ) = default;
+    auto operator=( const FrustumCuller& ) -> FrustumCuller& = delete;
+    auto operator=( FrustumCuller&& ) -> FrustumCuller& = default;
+    ~FrustumCuller() = default;
+
+public:
+    auto clear() -> void;
+    auto resize( const u32 count ) -> void;
+
+    // Box given by its center and half extent
+    auto add( const vec3& center, const vec3& extent ) -> u32;
+    auto set( const u32 index, const vec3& center, const vec3& extent ) -> void;
+
+    // Resizes to one object per node of objects, each bounded by the box around the local box ( center, extent ) in
+    // the node's world space. The world matrices are gathered a SIMD register of nodes at a time and transformed in
+    // structure of arrays form, in blocks on the job system if there is one.
+    auto set_transformed(
+        const TransformHierarchy&          transforms,
+        const std::span<const TransformId> objects,
+        const vec3&                        center,
+        const vec3&                        extent,
+        JobSystem* const                   jobs = nullptr
+    ) -> void;
+
+    auto get_count() const -> u32;
+    static auto get_lane_count() -> u32;
+
+    // Writes the visible objects among [first, first + count) to visible, which has to hold count indices, and returns
+    // how many there are
+    auto cull( const Frustum& frustum, const CullShape shape, const u32 first, const u32 count, u32* visible ) const
+        -> u32;
+
+    // Culls every object into visible, in blocks on the job system if there is one
+    auto cull(
+        const Frustum&    frustum,
+        const CullShape   shape,
+        std::vector<u32>& visible,
+        JobSystem* const  jobs = nullptr
+    ) const -> void;
+
+private:
+    auto set_transformed_range(
+        const TransformHierarchy&          transforms,
+        const std::span<const TransformId> objects,
+        const vec3&                        center,
+        const vec3&                        extent,
+        const u32                          first,
+        const u32                          end
+    ) -> void;
+
+private:
+    std::vector<f32> center_x_;
+    std::vector<f32> center_y_;
+    std::vector<f32> center_z_;
+    std::vector<f32> extent_x_;
+    std::vector<f32> extent_y_;
+    std::vector<f32> extent_z_;
+    std::vector<f32> radius_;
+    // Visible objects per block of the last cull() on a job system, kept so that culling does not allocate
+    mutable std::vector<u32> block_visible_;
+};
+
+} // namespace mksv
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_list_pool.hpp"
+#include "mksv/graphics/timestamp_query_pool.hpp"
+
+#include <chrono>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+struct GpuZoneTiming {
+    const char*                           name;
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::steady_clock::time_point end;
+};
+
+// Times GPU work with pairs of timestamp queries and puts the results on the Profiler's timeline. The queries of the
+// pool are split into a range per frame context, every zone of a frame takes the next two of its range and
+// end_frame() resolves the ones used into the readback memory at the same indices. begin_frame() reads back the frame
+// that last used the context, which the GPU is done with by then, so the timings arrive frames_in_flight frames late.
+//
+// Timestamps are converted to the steady clock with the pool's calibration, taken again for every frame read back so
+// that the two clocks cannot drift apart.
+class GpuProfiler
+{
+public:
+    static inline constexpr u32 INVALID_ZONE = ~0u;
+
+public:
+    GpuProfiler( TimestampQueryPool& pool, const u32 frames_in_flight );
+    GpuProfiler( const GpuProfiler& ) = default;
+    GpuProfiler( GpuProfiler&& ) = default;
+    auto operator=( const GpuProfiler& ) -> GpuProfiler& = default;
+    auto operator=( GpuProfiler&& ) -> GpuProfiler& = default;
+    ~GpuProfiler() = default;
+
+public:
+    // The GPU has to be done with the lists last recorded for frame_index
+    auto begin_frame( const u32 frame_index ) -> void;
+
+    // Zones may nest and span several lists as long as those are executed in order. Returns INVALID_ZONE once the
+    // frame's queries are used up. name has to outlive the Profiler, a string literal in practice.
+    [[nodiscard]] auto begin_zone( const CommandListHandle list, const char* name ) -> u32;
+    auto               end_zone( const CommandListHandle list, const u32 zone ) -> void;
+
+    // Ends the zones still open and resolves the frame's queries, list has to be executed after every zone's lists
+    auto end_frame( const CommandListHandle list ) -> void;
+
+    // Of the frame read back by the last begin_frame(), in the order the zones were begun
+    auto get_zones() const -> std::span<const GpuZoneTiming>;
+
+    // From the earliest begin to the latest end of the frame read back by the last begin_frame(), 0 without any zones
+    auto get_frame_milliseconds() const -> f64;
+
+    // Zones that did not get queries
+    auto get_dropped_count() const -> u64;
+
+private:
+    struct Zone {
+        const char* name;
+        bool        open;
+    };
+
+    struct Frame {
+        std::vector<Zone> zones;
+        bool              resolved;
+    };
+
+private:
+    auto get_first_query( const u32 frame_index ) const -> u32;
+    auto read_frame( const u32 frame_index ) -> void;
+
+private:
+    TimestampQueryPool* pool_;
+    u32                 zones_per_frame_;
+    std::vector<Frame>  frames_;
+    u32                 current_index_;
+
+    std::vector<u64>           timestamps_;
+    std::vector<GpuZoneTiming> zones_;
+    f64                        frame_milliseconds_;
+    u64                        dropped_count_;
+};
+
+} // namespace mksv
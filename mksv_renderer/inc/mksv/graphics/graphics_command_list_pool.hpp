@@ -0,0 +1,69 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_list_pool.hpp"
+#include "mksv/graphics/command_queue.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+// CommandListPool of D3D12 command lists for one queue. Every worker has a command allocator per frame context and
+// its own lists, which are created as needed and reused every frame, so recording never shares an allocator between
+// threads.
+class GraphicsCommandListPool final : public CommandListPool
+{
+public:
+    static auto create(
+        ComPtr<D3D12Device> device,
+        CommandQueue&       queue,
+        const u32           worker_count,
+        const u32           frames_in_flight
+    ) -> std::unique_ptr<GraphicsCommandListPool>;
+
+    static auto get_list( const CommandListHandle list ) -> D3D12GraphicsCommandList*;
+
+public:
+    GraphicsCommandListPool( const GraphicsCommandListPool& ) = delete;
+    GraphicsCommandListPool( GraphicsCommandListPool&& ) = delete;
+    auto operator=( const GraphicsCommandListPool& ) -> GraphicsCommandListPool& = delete;
+    auto operator=( GraphicsCommandListPool&& ) -> GraphicsCommandListPool& = delete;
+    ~GraphicsCommandListPool() override = default;
+
+public:
+    auto begin_frame( const u32 frame_index ) -> bool override;
+    auto open( const u32 worker ) -> CommandListHandle override;
+    auto close( const u32 worker, const CommandListHandle list ) -> bool override;
+    auto submit( const std::span<const CommandListHandle> lists ) -> void override;
+    auto get_worker_count() const -> u32 override;
+
+private:
+    // Padded so that workers recording at the same time do not share a cache line
+    struct alignas( 64 ) Worker {
+        std::vector<ComPtr<ID3D12CommandAllocator>>   allocators;
+        std::vector<ComPtr<D3D12GraphicsCommandList>> lists;
+        u32                                           used;
+    };
+
+private:
+    GraphicsCommandListPool(
+        ComPtr<D3D12Device>           device,
+        CommandQueue&                 queue,
+        const D3D12_COMMAND_LIST_TYPE type,
+        std::vector<Worker>           workers
+    );
+
+private:
+    ComPtr<D3D12Device>             device_;
+    CommandQueue*                   queue_;
+    D3D12_COMMAND_LIST_TYPE         type_;
+    std::vector<Worker>             workers_;
+    u32                             frame_index_;
+    std::vector<ID3D12CommandList*> submission_;
+};
+
+} // namespace mksv
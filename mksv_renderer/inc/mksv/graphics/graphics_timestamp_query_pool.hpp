@@ -0,0 +1,59 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_queue.hpp"
+#include "mksv/graphics/timestamp_query_pool.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace mksv
+{
+// TimestampQueryPool on a D3D12 timestamp query heap, resolved into a readback buffer. The timestamps are those of the
+// queue the lists are executed on, which gives their frequency and calibration.
+class GraphicsTimestampQueryPool final : public TimestampQueryPool
+{
+public:
+    static auto create( ComPtr<D3D12Device> device, CommandQueue& queue, const u32 query_count )
+        -> std::unique_ptr<GraphicsTimestampQueryPool>;
+
+public:
+    GraphicsTimestampQueryPool( const GraphicsTimestampQueryPool& ) = delete;
+    GraphicsTimestampQueryPool( GraphicsTimestampQueryPool&& ) = delete;
+    auto operator=( const GraphicsTimestampQueryPool& ) -> GraphicsTimestampQueryPool& = delete;
+    auto operator=( GraphicsTimestampQueryPool&& ) -> GraphicsTimestampQueryPool& = delete;
+    ~GraphicsTimestampQueryPool() override = default;
+
+public:
+    auto write( const CommandListHandle list, const u32 query ) -> void override;
+    auto resolve( const CommandListHandle list, const u32 first, const u32 count ) -> void override;
+    auto read( const u32 first, const std::span<u64> values ) -> bool override;
+    auto get_query_count() const -> u32 override;
+    auto get_frequency() const -> u64 override;
+    auto get_calibration() -> std::optional<GpuClockCalibration> override;
+
+private:
+    GraphicsTimestampQueryPool(
+        CommandQueue&           queue,
+        ComPtr<ID3D12QueryHeap> heap,
+        ComPtr<ID3D12Resource>  readback,
+        const u32               query_count,
+        const u64               frequency,
+        const u64               qpc_frequency
+    );
+
+private:
+    CommandQueue*           queue_;
+    ComPtr<ID3D12QueryHeap> heap_;
+    ComPtr<ID3D12Resource>  readback_;
+    u32                     query_count_;
+    u64                     frequency_;
+
+    // Of QueryPerformanceCounter, the CPU side of GetClockCalibration()
+    u64 qpc_frequency_;
+};
+
+} // namespace mksv
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_queue.hpp"
+#include "mksv/graphics/upload_queue.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace mksv
+{
+// Whole resource copy between two resources of the same description
+struct ResourceCopy {
+    ID3D12Resource* destination;
+    ID3D12Resource* source;
+};
+
+// UploadQueue on a dedicated D3D12 copy queue, with a persistently mapped upload buffer as staging memory. Each
+// submission gets a command allocator and list of its own, which are reused once the copy fence has passed it.
+//
+// Destinations have to be buffers in the common state: the copy queue promotes them to COPY_DEST and they decay back
+// when the copies are done, so the consumer queue can use them without any barrier.
+class GraphicsUploadQueue final : public UploadQueue
+{
+public:
+    static auto create( ComPtr<D3D12Device> device, CommandQueue& consumer, const u64 staging_capacity )
+        -> std::unique_ptr<GraphicsUploadQueue>;
+
+public:
+    GraphicsUploadQueue( const GraphicsUploadQueue& ) = delete;
+    GraphicsUploadQueue( GraphicsUploadQueue&& ) = delete;
+    auto operator=( const GraphicsUploadQueue& ) -> GraphicsUploadQueue& = delete;
+    auto operator=( GraphicsUploadQueue&& ) -> GraphicsUploadQueue& = delete;
+    ~GraphicsUploadQueue() override;
+
+public:
+    auto get_staging_memory() const -> std::span<u8> override;
+    auto submit( const std::span<const BufferCopy> copies ) -> u64 override;
+    auto wait_on_gpu( const u64 fence_value ) -> void override;
+    auto get_fence() -> Fence& override;
+
+    // Copies between resources instead of from the staging memory, used by HeapAllocator to move allocations without
+    // stalling the direct queue. Both resources have to be buffers in the common state and must not be written until
+    // the returned fence value, 0 on failure, has completed.
+    [[nodiscard]] auto submit_copies( const std::span<const ResourceCopy> copies ) -> u64;
+
+    auto get_queue() -> CommandQueue&;
+
+private:
+    struct Submission {
+        ComPtr<ID3D12CommandAllocator>   allocator;
+        ComPtr<D3D12GraphicsCommandList> command_list;
+        u64                              fence_value;
+    };
+
+private:
+    GraphicsUploadQueue(
+        ComPtr<D3D12Device>           device,
+        CommandQueue&                 consumer,
+        std::unique_ptr<CommandQueue> queue,
+        ComPtr<ID3D12Resource>        staging,
+        u8*                           mapped,
+        const u64                     staging_capacity
+    );
+
+    auto acquire_submission() -> std::optional<Submission>;
+    auto execute_submission( Submission&& submission ) -> u64;
+
+private:
+    ComPtr<D3D12Device>           device_;
+    CommandQueue*                 consumer_;
+    std::unique_ptr<CommandQueue> queue_;
+    ComPtr<ID3D12Resource>        staging_;
+    u8*                           mapped_;
+    u64                           staging_capacity_;
+
+    // In submission order, so the front is the first to be reusable
+    std::deque<Submission> submissions_;
+};
+
+} // namespace mksv
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/fence.hpp"
+#include "mksv/graphics/graphics_upload_queue.hpp"
+#include "mksv/graphics/tlsf_allocator.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace mksv
+{
+using HeapAllocationId = u32;
+
+struct HeapAllocatorStats {
+    u32 heap_count;
+    u64 reserved;
+    u64 used;
+    u64 largest_free_block;
+    u32 allocation_count;
+    u32 free_block_count;
+
+    // Free space weighted average of the per heap TlsfStats::fragmentation
+    f32 fragmentation;
+    u64 defragmented_bytes;
+};
+
+// Places DEFAULT heap resources in large ID3D12Heap blocks instead of giving each one its own committed heap. Every
+// heap is split with a TlsfAllocator. Buffers, non render target textures and render target / depth stencil textures
+// live in separate heaps (resource heap tier 1), each with a 64 KiB and a 4 MiB (MSAA) alignment class.
+//
+// Allocations are referenced by id because defragment() may move them to a different heap; fetch the resource again
+// after retire() reports completed moves. Released and moved-from memory is reused once the fence value passed to
+// submit() completes.
+class HeapAllocator
+{
+public:
+    static inline constexpr HeapAllocationId INVALID_ALLOCATION = ~0u;
+    static inline constexpr u64              DEFAULT_HEAP_SIZE = 64 * 1024 * 1024;
+
+public:
+    // fence is the one passed to submit(), copy_queue executes the defragmentation copies
+    static auto create(
+        ComPtr<D3D12Device>  device,
+        Fence&               fence,
+        GraphicsUploadQueue& copy_queue,
+        const u64            heap_size = DEFAULT_HEAP_SIZE
+    ) -> std::unique_ptr<HeapAllocator>;
+
+public:
+    HeapAllocator( const HeapAllocator& ) = delete;
+    HeapAllocator( HeapAllocator&& ) = delete;
+    auto operator=( const HeapAllocator& ) -> HeapAllocator& = delete;
+    auto operator=( HeapAllocator&& ) -> HeapAllocator& = delete;
+    ~HeapAllocator() = default;
+
+public:
+    [[nodiscard]] auto allocate(
+        const D3D12_RESOURCE_DESC&  desc,
+        const D3D12_RESOURCE_STATES initial_state,
+        const D3D12_CLEAR_VALUE*    clear_value = nullptr
+    ) -> std::optional<HeapAllocationId>;
+    auto release( const HeapAllocationId id ) -> void;
+
+    auto get_resource( const HeapAllocationId id ) const -> ID3D12Resource*;
+
+    // The state the resource is left in between command lists, only buffers left in the common state are moved
+    auto set_state( const HeapAllocationId id, const D3D12_RESOURCE_STATES state ) -> void;
+
+    // Starts moving up to max_bytes of buffers out of the least used buffer heap into the free space of the others, so
+    // that the emptied heap can be returned. The copies run on the copy queue and the allocation keeps its old
+    // resource until retire() sees them complete, writes made to it in the meantime are lost. Textures are never moved,
+    // their layout may differ between placements and the copy queue cannot transition them. Returns the number of
+    // moves started.
+    auto defragment( const u64 max_bytes ) -> u32;
+
+    // Ties every release and completed move since the last submit to fence_value
+    auto submit( const u64 fence_value ) -> void;
+
+    // Reuses memory whose fence has completed and swaps in the allocations whose copies have completed. Returns the
+    // number of allocations that changed resource.
+    auto retire() -> u32;
+
+    auto get_stats() const -> HeapAllocatorStats;
+
+private:
+    enum class HeapCategory : u32 {
+        Buffer,
+        Texture,
+        RenderTarget,
+        Count,
+    };
+
+    static inline constexpr u32 POOL_COUNT = static_cast<u32>( HeapCategory::Count ) * 2;
+
+    struct Page {
+        ComPtr<ID3D12Heap> heap;
+        TlsfAllocator      allocator;
+    };
+
+    struct Record {
+        ComPtr<ID3D12Resource>           resource;
+        D3D12_RESOURCE_DESC              desc;
+        std::optional<D3D12_CLEAR_VALUE> clear_value;
+        D3D12_RESOURCE_STATES            state;
+        u32                              pool;
+        u64                              alignment;
+        Page*                            page;
+        TlsfAllocation                   allocation;
+        bool                             moving;
+    };
+
+    // A copy in flight on the copy queue, id is INVALID_ALLOCATION once the allocation was released during the move.
+    // Holds on to the source as well, a release only waits for the direct queue.
+    struct PendingMove {
+        HeapAllocationId       id;
+        ComPtr<ID3D12Resource> source;
+        ComPtr<ID3D12Resource> resource;
+        Page*                  page;
+        TlsfAllocation         allocation;
+        u64                    copy_fence_value;
+    };
+
+    struct PendingRelease {
+        ComPtr<ID3D12Resource> resource;
+        Page*                  page;
+        u32                    block;
+        u64                    fence_value;
+    };
+
+private:
+    HeapAllocator(
+        ComPtr<D3D12Device>  device,
+        Fence&               fence,
+        GraphicsUploadQueue& copy_queue,
+        const u64            heap_size
+    );
+
+    static auto pool_index( const D3D12_RESOURCE_DESC& desc ) -> u32;
+    static auto pool_alignment( const u32 pool ) -> u64;
+    static auto pool_heap_flags( const u32 pool ) -> D3D12_HEAP_FLAGS;
+
+    auto create_page( const u32 pool, const u64 min_size ) -> Page*;
+    auto create_placed_resource(
+        Page&                       page,
+        const u64                   offset,
+        const D3D12_RESOURCE_DESC&  desc,
+        const D3D12_RESOURCE_STATES state,
+        const D3D12_CLEAR_VALUE*    clear_value
+    ) -> ComPtr<ID3D12Resource>;
+    auto release_empty_pages() -> void;
+
+private:
+    static inline constexpr u64 OPEN_BATCH = ~0ull;
+
+    ComPtr<D3D12Device>  device_;
+    Fence*               fence_;
+    GraphicsUploadQueue* copy_queue_;
+    u64                  heap_size_;
+    u64                  defragmented_bytes_;
+
+    mutable std::mutex                                         mutex_;
+    std::array<std::vector<std::unique_ptr<Page>>, POOL_COUNT> pools_;
+    std::vector<std::optional<Record>>                         records_;
+    std::vector<HeapAllocationId>                              free_ids_;
+    std::vector<PendingRelease>                                pending_releases_;
+    std::vector<PendingMove>                                   pending_moves_;
+};
+
+} // namespace mksv
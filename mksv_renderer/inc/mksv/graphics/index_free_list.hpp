@@ -0,0 +1,54 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace mksv
+{
+// Lock-free LIFO stack of indices in [0, capacity). Every index may be in the list at most once, which lets the links
+// live in a flat array indexed by the entry itself, so push and pop are O(1) and never allocate.
+//
+// The head carries a tag that is bumped on every change to rule out ABA when an index is popped and pushed back
+// between another thread's load and compare exchange.
+class IndexFreeList
+{
+public:
+    static inline constexpr u32 INVALID_INDEX = ~0u;
+
+public:
+    // When filled, the list starts out holding every index with 0 on top
+    IndexFreeList( const u32 capacity, const bool filled );
+    IndexFreeList( const IndexFreeList& ) = delete;
+    IndexFreeList( IndexFreeList&& ) = delete;
+    auto operator=( const IndexFreeList& ) -> IndexFreeList& = delete;
+    auto operator=( IndexFreeList&& ) -> IndexFreeList& = delete;
+    ~IndexFreeList() = default;
+
+public:
+    [[nodiscard]] auto pop() -> std::optional<u32>;
+    auto               push( const u32 index ) -> void;
+
+    // Detaches the whole list and returns its first index. Walk the chain with get_next() before pushing any of its
+    // indices back into this list.
+    [[nodiscard]] auto take_all() -> u32;
+    auto               get_next( const u32 index ) const -> u32;
+
+    auto get_capacity() const -> u32;
+    auto get_size() const -> u32;
+
+private:
+    static auto pack( const u32 tag, const u32 index ) -> u64;
+    static auto index_of( const u64 head ) -> u32;
+    static auto tag_of( const u64 head ) -> u32;
+
+private:
+    const u32                           capacity_;
+    std::unique_ptr<std::atomic<u32>[]> next_;
+    std::atomic<u64>                    head_;
+    std::atomic<u32>                    size_;
+};
+
+} // namespace mksv
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/upload_ring.hpp"
+#include "mksv/math/types.hpp"
+#include "mksv/mksv_d3d12.hpp"
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace mksv
+{
+// Objects sharing a mesh and pipeline, drawn with a single instanced draw
+struct InstanceBatch {
+    u32 mesh;
+    u32 pipeline;
+    u32 first_instance;
+    u32 instance_count;
+};
+
+// Groups the objects of a frame into instanced draws. Objects are added with the ids of their mesh and pipeline and
+// their world transform, build() then writes the transforms of every group contiguously into one upload ring
+// allocation, which the vertex shader reads as a structured buffer of row major float4x4 indexed by SV_InstanceID.
+//
+// Batches are ordered by pipeline, then mesh, so that consecutive draws change as little state as possible, and
+// objects keep the order they were added in within their batch. The ring allocation is only valid for the frame the
+// ring is next submitted with.
+class InstanceBatcher
+{
+public:
+    static inline constexpr u64 INSTANCE_STRIDE = sizeof( mat4 );
+
+public:
+    InstanceBatcher();
+    InstanceBatcher( const InstanceBatcher& ) = delete;
+    InstanceBatcher( InstanceBatcher&& ) = default;
+    auto operator=( const InstanceBatcher& ) -> InstanceBatcher& = delete;
+    auto operator=( InstanceBatcher&& ) -> InstanceBatcher& = default;
+    ~InstanceBatcher() = default;
+
+public:
+    // Drops the objects and batches of the previous frame but keeps their memory
+    auto reset() -> void;
+
+    auto add( const u32 mesh, const u32 pipeline, const mat4& transform ) -> void;
+    auto add( const u32 mesh, const u32 pipeline, const std::span<const mat4> transforms ) -> void;
+
+    // Fails if the ring could not provide the instance buffer, there are no batches then
+    [[nodiscard]] auto build( UploadRing& ring ) -> bool;
+
+    auto get_batches() const -> std::span<const InstanceBatch>;
+    auto get_instance_count() const -> u32;
+
+    // Address of the batch's first transform, to be bound as the instance buffer of its draw
+    auto get_instance_address( const InstanceBatch& batch ) const -> D3D12_GPU_VIRTUAL_ADDRESS;
+    auto get_instance_address( const u32 instance ) const -> D3D12_GPU_VIRTUAL_ADDRESS;
+
+private:
+    struct Group {
+        u32 mesh;
+        u32 pipeline;
+        u32 instance_count;
+        // Where build() writes the group's next transform
+        u32 next_instance;
+    };
+
+    // Consecutive transforms added to the same group
+    struct Run {
+        u32 group;
+        u32 first;
+        u32 count;
+    };
+
+private:
+    auto find_group( const u32 mesh, const u32 pipeline ) -> u32;
+    auto append_run( const u32 group, const u32 count ) -> void;
+
+private:
+    std::unordered_map<u64, u32> group_lookup_;
+    std::vector<Group>           groups_;
+    std::vector<Run>             runs_;
+    std::vector<mat4>            transforms_;
+    std::vector<InstanceBatch>   batches_;
+    D3D12_GPU_VIRTUAL_ADDRESS    instance_address_;
+};
+
+} // namespace mksv
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_list_pool.hpp"
+
+#include <atomic>
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+struct MockCommandList {
+    u32              worker;
+    u32              frame_index;
+    bool             open;
+    std::vector<u32> commands;
+};
+
+// CommandListPool that records instead of executing. Record callbacks append their draws to the list returned by
+// get_list(), and every submission keeps a copy of the lists it was given. Breaking the threading contract of
+// CommandListPool, such as opening a second list on a worker or submitting a list that is still open, is counted as
+// an error instead of asserting so that it can be checked for.
+class MockCommandListPool final : public CommandListPool
+{
+public:
+    explicit MockCommandListPool( const u32 worker_count );
+    MockCommandListPool( const MockCommandListPool& ) = delete;
+    MockCommandListPool( MockCommandListPool&& ) = delete;
+    auto operator=( const MockCommandListPool& ) -> MockCommandListPool& = delete;
+    auto operator=( MockCommandListPool&& ) -> MockCommandListPool& = delete;
+    ~MockCommandListPool() override = default;
+
+public:
+    static auto get_list( const CommandListHandle list ) -> MockCommandList&;
+
+    auto begin_frame( const u32 frame_index ) -> bool override;
+    auto open( const u32 worker ) -> CommandListHandle override;
+    auto close( const u32 worker, const CommandListHandle list ) -> bool override;
+    auto submit( const std::span<const CommandListHandle> lists ) -> void override;
+    auto get_worker_count() const -> u32 override;
+
+    auto get_submissions() const -> const std::vector<std::vector<MockCommandList>>&;
+    auto get_error_count() const -> u32;
+    auto get_list_count( const u32 worker ) const -> usize;
+
+private:
+    // Each worker's lists are only touched by the thread acting as that worker, deque keeps their addresses stable
+    struct alignas( 64 ) Worker {
+        std::deque<MockCommandList> lists;
+        u32                         used;
+        bool                        recording;
+    };
+
+private:
+    std::vector<Worker>                       workers_;
+    u32                                       frame_index_;
+    std::vector<std::vector<MockCommandList>> submissions_;
+    std::atomic<u32>                          error_count_;
+};
+
+} // namespace mksv
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/fence.hpp"
+
+namespace mksv
+{
+// Fence with a simulated GPU timeline. Signaled values complete only when complete_up_to() is called, or when the
+// CPU blocks on them in wait_for_value(), which is counted as a stall.
+class MockFence final : public Fence
+{
+public:
+    MockFence() = default;
+    MockFence( const MockFence& ) = default;
+    MockFence( MockFence&& ) = default;
+    auto operator=( const MockFence& ) -> MockFence& = default;
+    auto operator=( MockFence&& ) -> MockFence& = default;
+    ~MockFence() override = default;
+
+public:
+    auto signal() -> u64 override;
+    auto get_completed_value() const -> u64 override;
+    auto wait_for_value( const u64 value ) -> bool override;
+
+    auto complete_up_to( const u64 value ) -> void;
+    auto get_signaled_value() const -> u64;
+    auto get_wait_count() const -> u64;
+    auto get_stall_count() const -> u64;
+
+private:
+    u64 signaled_value_ = 0;
+    u64 completed_value_ = 0;
+    u64 wait_count_ = 0;
+    u64 stall_count_ = 0;
+};
+
+} // namespace mksv
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/timestamp_query_pool.hpp"
+
+#include <chrono>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+// TimestampQueryPool with a simulated GPU clock, which only moves when advance() is called. Queries are written and
+// resolved right away as if the GPU ran every list the moment it is recorded, so values only reach the readback memory
+// through resolve(). Out of range queries are counted as errors instead of asserting so that they can be checked for.
+class MockTimestampQueryPool final : public TimestampQueryPool
+{
+public:
+    MockTimestampQueryPool( const u32 query_count, const u64 frequency );
+    MockTimestampQueryPool( const MockTimestampQueryPool& ) = delete;
+    MockTimestampQueryPool( MockTimestampQueryPool&& ) = delete;
+    auto operator=( const MockTimestampQueryPool& ) -> MockTimestampQueryPool& = delete;
+    auto operator=( MockTimestampQueryPool&& ) -> MockTimestampQueryPool& = delete;
+    ~MockTimestampQueryPool() override = default;
+
+public:
+    auto write( const CommandListHandle list, const u32 query ) -> void override;
+    auto resolve( const CommandListHandle list, const u32 first, const u32 count ) -> void override;
+    auto read( const u32 first, const std::span<u64> values ) -> bool override;
+    auto get_query_count() const -> u32 override;
+    auto get_frequency() const -> u64 override;
+    auto get_calibration() -> std::optional<GpuClockCalibration> override;
+
+    auto advance( const u64 ticks ) -> void;
+    auto get_gpu_timestamp() const -> u64;
+
+    // GPU timestamp 0 is taken to be the moment the pool was created unless set otherwise
+    auto set_calibration( const GpuClockCalibration& calibration ) -> void;
+
+    auto get_error_count() const -> u32;
+
+private:
+    std::vector<u64>    queries_;
+    std::vector<u64>    readback_;
+    u64                 frequency_;
+    u64                 gpu_timestamp_;
+    GpuClockCalibration calibration_;
+    u32                 error_count_;
+};
+
+} // namespace mksv
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/mock_fence.hpp"
+#include "mksv/graphics/upload_queue.hpp"
+
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+struct MockBufferCopy {
+    BufferCopy      copy;
+    std::vector<u8> data;
+};
+
+struct MockUploadSubmission {
+    std::vector<MockBufferCopy> copies;
+    u64                         fence_value;
+};
+
+// UploadQueue that records instead of copying. Every submission keeps the copies together with the staged bytes they
+// read, and GPU waits are recorded in order. Submissions complete only when the MockFence is told so.
+class MockUploadQueue final : public UploadQueue
+{
+public:
+    explicit MockUploadQueue( const u64 staging_capacity );
+    MockUploadQueue( const MockUploadQueue& ) = delete;
+    MockUploadQueue( MockUploadQueue&& ) = delete;
+    auto operator=( const MockUploadQueue& ) -> MockUploadQueue& = delete;
+    auto operator=( MockUploadQueue&& ) -> MockUploadQueue& = delete;
+    ~MockUploadQueue() override = default;
+
+public:
+    auto get_staging_memory() const -> std::span<u8> override;
+    auto submit( const std::span<const BufferCopy> copies ) -> u64 override;
+    auto wait_on_gpu( const u64 fence_value ) -> void override;
+    auto get_fence() -> Fence& override;
+
+    auto get_mock_fence() -> MockFence&;
+    auto get_submissions() const -> const std::vector<MockUploadSubmission>&;
+    auto get_gpu_waits() const -> const std::vector<u64>&;
+
+private:
+    mutable std::vector<u8>           staging_;
+    MockFence                         fence_;
+    std::vector<MockUploadSubmission> submissions_;
+    std::vector<u64>                  gpu_waits_;
+};
+
+} // namespace mksv
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_list_pool.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+struct DrawChunk {
+    u32 first;
+    u32 count;
+};
+
+// Records a frame as an ordered batch of command lists. Serial work goes into the list returned by get_list(), and
+// record() splits a range of draws into chunks that are recorded into lists of their own as JobSystem jobs. The batch
+// keeps submission order: the serial list up to the record() call, the chunks in draw order, then a new serial list
+// for whatever comes next.
+//
+// The calling thread is worker 0 and JobSystem worker i is worker i + 1, matching the worker indices of the
+// CommandListPool. No other thread may run the JobSystem's jobs while recording. Chunks are picked up by whichever
+// thread gets to them first, so which worker records a chunk varies but the batch does not. A chunk list starts
+// without any state, the record callback has to set everything its draws need and must not wait on jobs.
+class ParallelRecorder
+{
+public:
+    using RecordChunk = std::function<void( const CommandListHandle list, const DrawChunk chunk )>;
+
+    static inline constexpr u32 CHUNKS_PER_WORKER = 4;
+    static inline constexpr u32 DEFAULT_MIN_CHUNK_SIZE = 256;
+
+public:
+    // worker_count is the calling thread plus the workers of the JobSystem passed to begin(), which bounds the chunk
+    // count. With 0 it is one per hardware thread.
+    static auto create( const u32 worker_count = 0, const u32 min_chunk_size = DEFAULT_MIN_CHUNK_SIZE )
+        -> std::unique_ptr<ParallelRecorder>;
+
+    // Splits draw_count draws into at most worker_count * CHUNKS_PER_WORKER chunks whose sizes differ by at most one.
+    // Only a single chunk may hold fewer than min_chunk_size draws.
+    static auto split(
+        const u32               draw_count,
+        const u32               worker_count,
+        const u32               min_chunk_size,
+        std::vector<DrawChunk>& out
+    ) -> void;
+
+public:
+    ParallelRecorder( const ParallelRecorder& ) = delete;
+    ParallelRecorder( ParallelRecorder&& ) = delete;
+    auto operator=( const ParallelRecorder& ) -> ParallelRecorder& = delete;
+    auto operator=( ParallelRecorder&& ) -> ParallelRecorder& = delete;
+    ~ParallelRecorder() = default;
+
+public:
+    // pool needs at least get_worker_count() workers and stays in use until finish(), as does jobs. Without jobs the
+    // chunks are recorded on the calling thread.
+    auto begin( CommandListPool& pool, JobSystem* const jobs = nullptr ) -> void;
+
+    // The serial list, opened on first use after begin() or record(). Returns nullptr if it could not be opened.
+    auto get_list() -> CommandListHandle;
+
+    // A range that fits in a single chunk is recorded straight into the serial list
+    [[nodiscard]] auto record( const u32 draw_count, const RecordChunk& record ) -> bool;
+
+    // Closes the serial list, get_batch() then holds every list of the frame in submission order
+    [[nodiscard]] auto finish() -> bool;
+    auto               get_batch() const -> std::span<const CommandListHandle>;
+
+    auto get_worker_count() const -> u32;
+    auto get_min_chunk_size() const -> u32;
+
+private:
+    ParallelRecorder( const u32 worker_count, const u32 min_chunk_size );
+
+    auto close_list() -> bool;
+    auto record_chunk( const u32 worker, const u32 chunk, const RecordChunk& record ) -> void;
+
+private:
+    u32 worker_count_;
+    u32 min_chunk_size_;
+
+    CommandListPool*               pool_;
+    JobSystem*                     jobs_;
+    CommandListHandle              list_;
+    std::vector<CommandListHandle> batch_;
+
+    // Shared with the jobs for the duration of one record() call
+    std::vector<DrawChunk>         chunks_;
+    std::vector<CommandListHandle> chunk_lists_;
+    std::atomic<bool>              failed_;
+};
+
+} // namespace mksv
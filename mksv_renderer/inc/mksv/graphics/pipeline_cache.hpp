@@ -0,0 +1,116 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace mksv
+{
+// Deduplicates pipeline states by the content of their stream and persists them through an ID3D12PipelineLibrary.
+//
+// Streams are hashed by what their subobjects describe rather than by their bytes: input layouts by their elements,
+// shaders by the digest of their container and root signatures by their serialized blob, which is why these have to
+// be created through create_root_signature(). The library is saved together with the adapter and driver it was built
+// with and discarded on load when either of them or the file version changed. All members may be called from any
+// thread, a request for a pipeline that is still being created waits for it.
+class PipelineCache
+{
+public:
+    // Bump whenever the stream hash or the file layout changes
+    static inline constexpr u32 FILE_VERSION = 1;
+
+public:
+    static auto create( ComPtr<D3D12Device> device, ComPtr<DXGIAdapter> adapter, std::filesystem::path path )
+        -> std::unique_ptr<PipelineCache>;
+
+public:
+    PipelineCache( const PipelineCache& ) = delete;
+    PipelineCache( PipelineCache&& ) = delete;
+    auto operator=( const PipelineCache& ) -> PipelineCache& = delete;
+    auto operator=( PipelineCache&& ) -> PipelineCache& = delete;
+    ~PipelineCache() = default;
+
+public:
+    // Returns the root signature created earlier from the same blob, if any. The cache keeps them alive.
+    [[nodiscard]] auto create_root_signature( const void* blob, const usize size ) -> ComPtr<ID3D12RootSignature>;
+
+    // Returns the pipeline from memory, loads it from the library or creates and stores it, in that order. Streams
+    // that cannot be hashed are created without caching.
+    [[nodiscard]] auto get_pipeline_state( const D3D12_PIPELINE_STATE_STREAM_DESC& desc )
+        -> ComPtr<ID3D12PipelineState>;
+
+    // Nothing if the stream holds a subobject type or a root signature this cache does not know
+    auto hash_stream( const D3D12_PIPELINE_STATE_STREAM_DESC& desc ) const -> std::optional<u64>;
+
+    // Writes the library to disk if pipelines were stored in it since it was loaded
+    [[nodiscard]] auto save() -> bool;
+
+    auto get_memory_hit_count() const -> u64;
+    auto get_library_hit_count() const -> u64;
+    auto get_compile_count() const -> u64;
+
+private:
+    // Written in front of the serialized library
+    struct FileHeader {
+        u32 magic;
+        u32 version;
+        u32 vendor_id;
+        u32 device_id;
+        u32 sub_sys_id;
+        u32 revision;
+        u64 driver_version;
+        u64 library_size;
+        u64 library_hash;
+    };
+
+    struct Entry {
+        ComPtr<ID3D12PipelineState> pipeline_state;
+        bool                        ready;
+    };
+
+private:
+    PipelineCache(
+        ComPtr<D3D12Device>            device,
+        std::vector<u8>                library_data,
+        ComPtr<ID3D12PipelineLibrary1> library,
+        const FileHeader&              header,
+        std::filesystem::path          path
+    );
+
+    static auto read_library_data( const std::filesystem::path& path, const FileHeader& expected ) -> std::vector<u8>;
+
+    auto load_or_compile( const D3D12_PIPELINE_STATE_STREAM_DESC& desc, const u64 hash )
+        -> ComPtr<ID3D12PipelineState>;
+
+private:
+    static inline constexpr u32 FILE_MAGIC = 0x4350534D; // "MSPC"
+
+    ComPtr<D3D12Device> device_;
+
+    // The library reads from the blob it was created from for as long as it lives. Null when the driver does not
+    // support libraries, pipelines are then only cached in memory.
+    std::vector<u8>                library_data_;
+    ComPtr<ID3D12PipelineLibrary1> library_;
+    FileHeader                     header_;
+    std::filesystem::path          path_;
+
+    mutable std::mutex                                   mutex_;
+    std::condition_variable                              ready_cv_;
+    std::unordered_map<u64, Entry>                       pipelines_;
+    std::unordered_map<u64, ComPtr<ID3D12RootSignature>> root_signatures_;
+    std::unordered_map<const ID3D12RootSignature*, u64>  root_signature_hashes_;
+    bool                                                 dirty_;
+    u64                                                  memory_hits_;
+    u64                                                  library_hits_;
+    u64                                                  compiles_;
+};
+
+} // namespace mksv
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/resource_state_tracker.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace mksv
+{
+using RenderGraphResource = u32;
+using RenderGraphPass = u32;
+
+enum class RenderGraphBarrierType : u8 {
+    Transition,
+    UnorderedAccess,
+};
+
+// A state a resource has to reach at a point between two compiled passes. A Begin barrier starts a split transition
+// that the next Full barrier to the same state on that resource completes. An UnorderedAccess barrier keeps the
+// resource in the unordered access state and orders the passes using it on either side.
+struct RenderGraphBarrier {
+    RenderGraphResource    resource;
+    u32                    state;
+    BarrierPhase           phase;
+    RenderGraphBarrierType type;
+};
+
+// Transient resource after starts using memory that before, or any resource when INVALID_RESOURCE, used last
+struct RenderGraphAliasing {
+    RenderGraphResource before;
+    RenderGraphResource after;
+};
+
+struct CompiledRenderPass {
+    RenderGraphPass pass;
+
+    // Recorded before the pass executes
+    u32 first_aliasing;
+    u32 aliasing_count;
+    u32 first_barrier_before;
+    u32 barrier_before_count;
+
+    // Recorded right after the pass executes
+    u32 first_barrier_after;
+    u32 barrier_after_count;
+};
+
+struct CompiledRenderGraph {
+    // Live passes in execution order, barriers and aliasing are ranges into the arrays below
+    std::vector<CompiledRenderPass>  passes;
+    std::vector<RenderGraphBarrier>  barriers;
+    std::vector<RenderGraphAliasing> aliasing;
+
+    // Offset of every transient resource in the shared transient memory, INVALID_OFFSET for imported resources and
+    // transients only used by culled passes
+    std::vector<u64> offsets;
+    u64              transient_size;
+    u32              culled_pass_count;
+};
+
+class RenderGraph;
+
+class RenderPassBuilder
+{
+public:
+    RenderPassBuilder( RenderGraph& graph, const RenderGraphPass pass );
+
+public:
+    auto read( const RenderGraphResource resource, const u32 state ) -> RenderPassBuilder&;
+    auto write( const RenderGraphResource resource, const u32 state ) -> RenderPassBuilder&;
+
+    // Keeps the pass even if nothing reads what it writes, for passes that work outside the graph
+    auto has_side_effects() -> RenderPassBuilder&;
+
+    auto get_pass() const -> RenderGraphPass;
+
+private:
+    RenderGraph*    graph_;
+    RenderGraphPass pass_;
+};
+
+// Frame graph built again every frame: passes declare the resources they read and write, and compile() turns that
+// into an execution order with the minimal set of state barriers. States are opaque bit masks as in
+// ResourceStateTracker, and nothing here touches the GPU.
+//
+// Passes that do not contribute to an exported resource or have side effects are culled. Transient resources only
+// live from their first to their last use, and those whose lifetimes do not overlap share memory. Consecutive read
+// states are combined into a single transition, and a transition whose resource is idle for at least one pass is
+// split so that it begins right after the previous use.
+//
+// Passes execute in declaration order, so a pass may only depend on passes declared before it. When a frame declares
+// exactly what the previous one did, compile() returns the previous result without redoing any work. Only the
+// topology counts: which imported resource a handle refers to may change from frame to frame.
+class RenderGraph
+{
+public:
+    static inline constexpr RenderGraphResource INVALID_RESOURCE = ~0u;
+    static inline constexpr u64                 INVALID_OFFSET = ~0ull;
+
+public:
+    // Any combination of read_only_states can be held at once, every other state is exclusive. Passes that write in
+    // unordered_access_state are separated by an UnorderedAccess barrier from other passes using it in that state.
+    RenderGraph( const u32 read_only_states, const u32 unordered_access_state );
+
+public:
+    // Drops the declarations of the previous frame but keeps its compiled graph for reuse
+    auto reset() -> void;
+
+    auto import_resource() -> RenderGraphResource;
+
+    // alignment must be a power of two
+    auto create_transient( const u64 size, const u64 alignment ) -> RenderGraphResource;
+
+    // The resource is needed after the graph and ends up in final_state
+    auto export_resource( const RenderGraphResource resource, const u32 final_state ) -> void;
+
+    // name has to outlive the graph's declarations, a string literal in practice
+    auto add_pass( const std::string_view name ) -> RenderPassBuilder;
+
+    // Returns true when the graph had to be compiled again, false when the previous result was reused
+    auto compile() -> bool;
+
+    auto get_compiled() const -> const CompiledRenderGraph&;
+    auto get_pass_name( const RenderGraphPass pass ) const -> std::string_view;
+    auto get_pass_count() const -> u32;
+    auto get_resource_count() const -> u32;
+    auto is_transient( const RenderGraphResource resource ) const -> bool;
+
+    // Accesses dropped since the last reset() because their pass already used the resource in a state that cannot be
+    // held together with the new one, such as reading a texture that it also renders to
+    auto get_rejected_access_count() const -> u32;
+
+private:
+    friend class RenderPassBuilder;
+
+    struct Access {
+        RenderGraphResource resource;
+        u32                 state;
+        bool                write;
+    };
+
+    struct Pass {
+        std::string_view name;
+        u32              first_access;
+        u32              access_count;
+        bool             side_effects;
+    };
+
+    struct Resource {
+        u64  size;
+        u64  alignment;
+        u32  final_state;
+        bool transient;
+        bool exported;
+    };
+
+    // A barrier waiting to be sorted into the slot before (2 * pass) or after (2 * pass + 1) a compiled pass
+    struct SlottedBarrier {
+        u32                slot;
+        RenderGraphBarrier barrier;
+    };
+
+    // Where the barriers of one resource stand while they are placed, indices are into slotted_
+    struct BarrierCursor {
+        u32  state;
+        u32  last_use;
+        u32  full;
+        u32  begin;
+        bool written;
+    };
+
+    // A transient that has been given memory, kept sorted by offset
+    struct Placement {
+        RenderGraphResource resource;
+        u32                 first_use;
+        u32                 last_use;
+        u64                 begin;
+        u64                 end;
+    };
+
+private:
+    auto add_access( const RenderGraphPass pass, const RenderGraphResource resource, const u32 state, const bool write )
+        -> void;
+
+    auto cull() -> void;
+    auto compute_lifetimes() -> void;
+    auto place_transients() -> void;
+    auto place_aliasing() -> void;
+    auto place_barriers() -> void;
+    auto emit(
+        const u32                    slot,
+        const RenderGraphResource    resource,
+        const u32                    state,
+        const BarrierPhase           phase,
+        const RenderGraphBarrierType type = RenderGraphBarrierType::Transition
+    ) -> u32;
+    auto writes( const Pass& pass, const RenderGraphResource resource ) const -> bool;
+    auto is_read_only( const u32 state ) const -> bool;
+
+private:
+    u32 read_only_states_;
+    u32 unordered_access_state_;
+    u32 rejected_access_count_;
+
+    std::vector<Pass>     passes_;
+    std::vector<Access>   accesses_;
+    std::vector<Resource> resources_;
+
+    // Every declaration of the frame encoded as integers, compared whole to detect an unchanged topology
+    std::vector<u64>    signature_;
+    std::vector<u64>    compiled_signature_;
+    bool                has_compiled_;
+    CompiledRenderGraph compiled_;
+
+    // Scratch memory kept between compiles so that large graphs do not allocate every time
+    std::vector<u8>             live_;
+    std::vector<u8>             needed_;
+    std::vector<u32>            first_use_;
+    std::vector<u32>            last_use_;
+    std::vector<BarrierCursor>  cursors_;
+    std::vector<SlottedBarrier> slotted_;
+    std::vector<u32>            slot_offsets_;
+    std::vector<u32>            placement_order_;
+    std::vector<Placement>      placements_;
+};
+
+} // namespace mksv
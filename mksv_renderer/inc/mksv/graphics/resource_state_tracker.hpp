@@ -0,0 +1,93 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace mksv
+{
+enum class BarrierPhase : u8 {
+    Full,
+    Begin,
+    End,
+};
+
+struct ResourceTransition {
+    const void*  resource;
+    u32          subresource;
+    u32          before;
+    u32          after;
+    BarrierPhase phase;
+};
+
+// Resolves declared resource usage into the minimal list of state transitions. States are opaque bit masks (the
+// D3D12_RESOURCE_STATES values in practice) and resources opaque keys, so this holds no API objects.
+//
+// Call require() for every resource a batch of commands uses, then flush() before recording those commands.
+// Transitions requested for the same subresource between two flushes are folded into one, read states that are
+// already covered by the current state are skipped and read-only states are combined instead of toggled. prepare()
+// starts a split transition that the next require() of the same state completes.
+class ResourceStateTracker
+{
+public:
+    static inline constexpr u32 ALL_SUBRESOURCES = ~0u;
+
+public:
+    // Any combination of read_only_states can be held at once, every other state is exclusive
+    explicit ResourceStateTracker( const u32 read_only_states );
+
+public:
+    auto track( const void* resource, const u32 initial_state, const u32 subresource_count = 1 ) -> void;
+    auto untrack( const void* resource ) -> void;
+    auto is_tracked( const void* resource ) const -> bool;
+
+    auto require( const void* resource, const u32 state, const u32 subresource = ALL_SUBRESOURCES ) -> void;
+    auto prepare( const void* resource, const u32 state, const u32 subresource = ALL_SUBRESOURCES ) -> void;
+
+    // Appends the pending transitions to out in the order they must execute, returns the number appended
+    auto flush( std::vector<ResourceTransition>& out ) -> u32;
+
+    auto get_state( const void* resource, const u32 subresource = 0 ) const -> u32;
+    auto has_pending() const -> bool;
+
+private:
+    static inline constexpr u32 NO_SPLIT = ~0u;
+
+    struct Subresource {
+        u32 state;
+        u32 split_target;
+    };
+
+    struct Resource {
+        std::vector<Subresource> subresources;
+
+        // A split begun for all subresources has to end for all of them as well
+        bool split_all;
+    };
+
+private:
+    static auto is_uniform( const Resource& resource ) -> bool;
+    static auto set_subresources( Resource& resource, const u32 subresource, const Subresource value ) -> void;
+
+    auto resolve( const void* key, Resource& resource, const u32 subresource, const u32 state ) -> void;
+    auto begin_split( const void* key, Resource& resource, const u32 subresource, const u32 state ) -> void;
+    auto end_split( const void* key, Resource& resource, const u32 subresource ) -> u32;
+    auto push( const ResourceTransition& transition ) -> void;
+    auto covers( const u32 current, const u32 state ) const -> bool;
+    auto is_read_only( const u32 state ) const -> bool;
+
+private:
+    u32 read_only_states_;
+
+    std::unordered_map<const void*, Resource> resources_;
+
+    // Transitions are dropped in place (before == after) rather than erased so the indices below stay valid
+    std::vector<ResourceTransition> pending_;
+
+    // Index of the last pending transition of each resource, only that one can absorb a new transition without
+    // reordering it past another one for the same resource
+    std::unordered_map<const void*, usize> last_pending_;
+};
+
+} // namespace mksv
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace mksv
+{
+// Offset bookkeeping for a circular buffer whose space is recycled when a fence value completes. Holds no memory
+// itself, so it can back any persistently mapped buffer.
+//
+// allocate() is lock-free and may be called from any number of producer threads. close_batch() and retire() are
+// expected to be called by the thread that submits the work referencing the allocations.
+class RingAllocator
+{
+public:
+    explicit RingAllocator( const u64 capacity );
+    RingAllocator( const RingAllocator& ) = delete;
+    RingAllocator( RingAllocator&& ) = delete;
+    auto operator=( const RingAllocator& ) -> RingAllocator& = delete;
+    auto operator=( RingAllocator&& ) -> RingAllocator& = delete;
+    ~RingAllocator() = default;
+
+public:
+    // Returns the offset of size bytes aligned to alignment (a power of two), or nothing if the ring is full
+    [[nodiscard]] auto allocate( const u64 size, const u64 alignment ) -> std::optional<u64>;
+
+    // Every allocation made since the previous call is released once fence_value has completed
+    auto close_batch( const u64 fence_value ) -> void;
+    auto retire( const u64 completed_fence_value ) -> void;
+
+    auto get_oldest_pending_fence() const -> std::optional<u64>;
+    auto has_open_allocations() const -> bool;
+    auto get_capacity() const -> u64;
+    auto get_used() const -> u64;
+
+private:
+    struct Batch {
+        u64 fence_value;
+        u64 end;
+    };
+
+private:
+    const u64 capacity_;
+
+    // Monotonic byte counters, the physical offset is counter % capacity
+    std::atomic<u64> head_;
+    std::atomic<u64> tail_;
+
+    mutable std::mutex mutex_;
+    std::deque<Batch>  batches_;
+    u64                closed_head_;
+};
+
+} // namespace mksv
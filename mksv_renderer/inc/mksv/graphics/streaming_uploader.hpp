@@ -0,0 +1,96 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/ring_allocator.hpp"
+#include "mksv/graphics/upload_queue.hpp"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace mksv
+{
+// Identifies the batch an upload went out with
+struct UploadTicket {
+    u64 batch;
+};
+
+// Streams buffer uploads through an UploadQueue. request() copies the data into staging memory right away and adds
+// the copy to the open batch, which is submitted once it holds batch_size bytes or when flush() is called. Uploads
+// larger than a batch are split across several.
+//
+// The consumer either polls is_complete() before first using a destination, or calls wait_on_gpu() to make its queue
+// wait for the upload on the GPU. The CPU only blocks when the staging memory is full, on the oldest batch still in
+// flight. All members may be called from any thread.
+class StreamingUploader
+{
+public:
+    static inline constexpr u64 DEFAULT_BATCH_SIZE = 4 * 1024 * 1024;
+    static inline constexpr u64 STAGING_ALIGNMENT = 16;
+
+public:
+    // batch_size is clamped to half of the staging memory so that a batch can be filled while another is in flight
+    static auto create( UploadQueue& queue, const u64 batch_size = DEFAULT_BATCH_SIZE )
+        -> std::unique_ptr<StreamingUploader>;
+
+public:
+    StreamingUploader( const StreamingUploader& ) = delete;
+    StreamingUploader( StreamingUploader&& ) = delete;
+    auto operator=( const StreamingUploader& ) -> StreamingUploader& = delete;
+    auto operator=( StreamingUploader&& ) -> StreamingUploader& = delete;
+    ~StreamingUploader() = default;
+
+public:
+    // Returns nullopt for empty uploads and when the data could not be staged or submitted
+    [[nodiscard]] auto request(
+        const UploadDestination destination,
+        const u64               destination_offset,
+        const void*             data,
+        const u64               size
+    ) -> std::optional<UploadTicket>;
+
+    // Submits the open batch, if it holds anything
+    [[nodiscard]] auto flush() -> bool;
+
+    auto is_complete( const UploadTicket ticket ) const -> bool;
+
+    // Submits the ticket's batch first if it is still open
+    [[nodiscard]] auto wait_on_gpu( const UploadTicket ticket ) -> bool;
+
+    // Recycles the staging memory of completed batches
+    auto retire() -> void;
+
+    auto get_batch_size() const -> u64;
+    auto get_submitted_batch_count() const -> u64;
+    auto get_stall_count() const -> u64;
+
+private:
+    StreamingUploader( UploadQueue& queue, const u64 batch_size );
+
+    // Callers hold mutex_
+    auto allocate( const u64 size ) -> std::optional<u64>;
+    auto submit_batch() -> bool;
+    auto retire_batches() -> void;
+
+private:
+    UploadQueue*  queue_;
+    std::span<u8> staging_;
+    RingAllocator ring_;
+    u64           batch_size_;
+
+    mutable std::mutex      mutex_;
+    std::vector<BufferCopy> copies_;
+    u64                     open_bytes_;
+
+    // Fence values of the submitted batches that have not been seen completing, starting at batch first_pending_
+    std::deque<u64> pending_;
+    u64             first_pending_;
+    u64             submitted_count_;
+    u64             gpu_waited_value_;
+    u64             stall_count_;
+};
+
+} // namespace mksv
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_list_pool.hpp"
+
+#include <chrono>
+#include <optional>
+#include <span>
+
+namespace mksv
+{
+// A GPU timestamp and the steady clock read at the same moment
+struct GpuClockCalibration {
+    u64                                   gpu_timestamp;
+    std::chrono::steady_clock::time_point cpu_time;
+};
+
+// Fixed number of GPU timestamp queries with readback memory holding a value per query. Implemented by
+// GraphicsTimestampQueryPool on top of a D3D12 query heap and by MockTimestampQueryPool for device-less use.
+class TimestampQueryPool
+{
+public:
+    virtual ~TimestampQueryPool() = default;
+
+public:
+    // Stores the GPU timestamp into the query when the list executes
+    virtual auto write( const CommandListHandle list, const u32 query ) -> void = 0;
+
+    // Copies the queries' values into the readback memory at the same indices when the list executes
+    virtual auto resolve( const CommandListHandle list, const u32 first, const u32 count ) -> void = 0;
+
+    // Reads values.size() values from the readback memory, the GPU has to be done with the list that resolved them
+    [[nodiscard]] virtual auto read( const u32 first, const std::span<u64> values ) -> bool = 0;
+
+    virtual auto get_query_count() const -> u32 = 0;
+
+    // Timestamp ticks per second
+    virtual auto get_frequency() const -> u64 = 0;
+
+    [[nodiscard]] virtual auto get_calibration() -> std::optional<GpuClockCalibration> = 0;
+};
+
+} // namespace mksv
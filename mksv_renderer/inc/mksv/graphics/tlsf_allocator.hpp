@@ -0,0 +1,103 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace mksv
+{
+struct TlsfAllocation {
+    u32 block;
+    u64 offset;
+    u64 size;
+};
+
+struct TlsfStats {
+    u64 capacity;
+    u64 used;
+    u64 largest_free_block;
+    u32 allocation_count;
+    u32 free_block_count;
+
+    // 0 when all free space is one contiguous block, approaching 1 as it is split into many small blocks
+    f32 fragmentation;
+};
+
+// Two-level segregated fit allocator over an abstract [0, capacity) range. Holds no memory itself, so it can place
+// resources in an ID3D12Heap or carve up any other linear resource. Allocation and free are O(1): the first level
+// splits sizes by power of two, the second level splits each power of two into SECOND_LEVEL_COUNT linear classes.
+//
+// Every size and offset is a multiple of the granularity. Not thread-safe.
+class TlsfAllocator
+{
+public:
+    static inline constexpr u32 SECOND_LEVEL_LOG2 = 4;
+    static inline constexpr u32 SECOND_LEVEL_COUNT = 1u << SECOND_LEVEL_LOG2;
+    static inline constexpr u32 FIRST_LEVEL_COUNT = 64 - SECOND_LEVEL_LOG2 + 1;
+    static inline constexpr u32 INVALID_BLOCK = ~0u;
+
+public:
+    TlsfAllocator( const u64 capacity, const u64 granularity );
+    TlsfAllocator( const TlsfAllocator& ) = delete;
+    TlsfAllocator( TlsfAllocator&& ) = default;
+    auto operator=( const TlsfAllocator& ) -> TlsfAllocator& = delete;
+    auto operator=( TlsfAllocator&& ) -> TlsfAllocator& = default;
+    ~TlsfAllocator() = default;
+
+public:
+    // alignment must be a power of two, it is raised to the granularity if smaller
+    [[nodiscard]] auto allocate( const u64 size, const u64 alignment ) -> std::optional<TlsfAllocation>;
+    auto               free( const u32 block ) -> void;
+
+    auto get_stats() const -> TlsfStats;
+    auto get_capacity() const -> u64;
+    auto get_granularity() const -> u64;
+    auto get_used() const -> u64;
+    auto get_allocation_count() const -> u32;
+    auto is_empty() const -> bool;
+
+private:
+    struct Block {
+        u64  offset;
+        u64  size;
+        u32  prev_physical;
+        u32  next_physical;
+        u32  prev_free;
+        u32  next_free;
+        bool is_free;
+    };
+
+    struct SizeClass {
+        u32 first_level;
+        u32 second_level;
+    };
+
+private:
+    static auto size_class( const u64 size ) -> SizeClass;
+
+    auto find_free_block( const u64 size ) const -> u32;
+    auto insert_free_block( const u32 block ) -> void;
+    auto remove_free_block( const u32 block ) -> void;
+    auto split_block( const u32 block, const u64 size ) -> u32;
+    auto merge_into_prev( const u32 block ) -> u32;
+    auto new_block() -> u32;
+    auto recycle_block( const u32 block ) -> void;
+
+private:
+    u64 capacity_;
+    u64 granularity_;
+    u64 used_;
+    u32 allocation_count_;
+    u32 free_block_count_;
+
+    std::vector<Block> blocks_;
+    std::vector<u32>   unused_blocks_;
+
+    u64                                                                first_level_bitmap_;
+    std::array<u32, FIRST_LEVEL_COUNT>                                 second_level_bitmaps_;
+    std::array<std::array<u32, SECOND_LEVEL_COUNT>, FIRST_LEVEL_COUNT> free_heads_;
+};
+
+} // namespace mksv
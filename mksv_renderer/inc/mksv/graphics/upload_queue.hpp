@@ -0,0 +1,42 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/fence.hpp"
+
+#include <span>
+
+namespace mksv
+{
+// Opaque copy destination, an ID3D12Resource* for GraphicsUploadQueue and any caller chosen value for
+// MockUploadQueue
+using UploadDestination = void*;
+
+struct BufferCopy {
+    UploadDestination destination;
+    u64               destination_offset;
+    u64               staging_offset;
+    u64               size;
+};
+
+// Queue that StreamingUploader submits its batches to. It owns the staging memory the copies read from and a fence
+// that only its own submissions signal. Implemented by GraphicsUploadQueue on a D3D12 copy queue and by
+// MockUploadQueue for device-less use.
+class UploadQueue
+{
+public:
+    virtual ~UploadQueue() = default;
+
+public:
+    // Persistently mapped, stays valid for the lifetime of the queue
+    virtual auto get_staging_memory() const -> std::span<u8> = 0;
+
+    // Executes the copies as one submission and returns the fence value signaled after them, 0 on failure
+    [[nodiscard]] virtual auto submit( const std::span<const BufferCopy> copies ) -> u64 = 0;
+
+    // Makes the queue consuming the uploads wait on the GPU until fence_value has completed, without blocking the CPU
+    virtual auto wait_on_gpu( const u64 fence_value ) -> void = 0;
+
+    virtual auto get_fence() -> Fence& = 0;
+};
+
+} // namespace mksv
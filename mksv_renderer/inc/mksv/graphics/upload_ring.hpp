@@ -0,0 +1,92 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/fence.hpp"
+#include "mksv/graphics/ring_allocator.hpp"
+#include "mksv/mksv_d3d12.hpp"
+#include "mksv/mksv_wrl.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace mksv
+{
+struct UploadAllocation {
+    ID3D12Resource*           resource;
+    u64                       offset;
+    u8*                       cpu_address;
+    D3D12_GPU_VIRTUAL_ADDRESS gpu_address;
+    u64                       size;
+};
+
+// Persistently mapped upload heap for data the GPU reads in place from the direct queue, such as the per-frame
+// instance data. Space is recycled once the fence value passed to submit() for the batch that used it has completed.
+//
+// Copies into default heap resources do not go through here: the StreamingUploader stages them in the
+// GraphicsUploadQueue's own buffer and copies them on the copy queue, whose fence runs independently of the one the
+// ring is retired against. Both share the RingAllocator bookkeeping.
+//
+// When the ring is full, allocate() first blocks on the oldest submitted batch. If that cannot free enough space
+// (request larger than the ring, or the ring filled up by the still open batch) it falls back to a dedicated upload
+// resource that is released with the batch.
+class UploadRing
+{
+public:
+    static inline constexpr u64 DEFAULT_ALIGNMENT = 16;
+    static inline constexpr u64 CONSTANT_ALIGNMENT = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+    static inline constexpr u64 TEXTURE_ALIGNMENT = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+
+public:
+    static auto create( ComPtr<D3D12Device> device, Fence& fence, const u64 capacity ) -> std::unique_ptr<UploadRing>;
+
+public:
+    UploadRing( const UploadRing& ) = delete;
+    UploadRing( UploadRing&& ) = delete;
+    auto operator=( const UploadRing& ) -> UploadRing& = delete;
+    auto operator=( UploadRing&& ) -> UploadRing& = delete;
+    ~UploadRing();
+
+public:
+    [[nodiscard]] auto allocate( const u64 size, const u64 alignment = DEFAULT_ALIGNMENT )
+        -> std::optional<UploadAllocation>;
+    [[nodiscard]] auto upload( const void* data, const u64 size, const u64 alignment = DEFAULT_ALIGNMENT )
+        -> std::optional<UploadAllocation>;
+
+    // Ties every allocation made since the last submit to fence_value
+    auto submit( const u64 fence_value ) -> void;
+    auto retire() -> void;
+
+    auto get_capacity() const -> u64;
+    auto get_used() const -> u64;
+    auto get_fallback_count() const -> u64;
+
+private:
+    struct Fallback {
+        ComPtr<ID3D12Resource> resource;
+        u64                    fence_value;
+    };
+
+private:
+    UploadRing( ComPtr<D3D12Device> device, Fence& fence, ComPtr<ID3D12Resource> buffer, u8* mapped, const u64 capacity );
+
+    auto allocate_fallback( const u64 size ) -> std::optional<UploadAllocation>;
+
+private:
+    static inline constexpr u64 OPEN_BATCH = ~0ull;
+
+    ComPtr<D3D12Device>    device_;
+    Fence*                 fence_;
+    ComPtr<ID3D12Resource> buffer_;
+    u8*                    mapped_;
+    RingAllocator          ring_;
+
+    // The count is read without the mutex while other threads allocate
+    std::mutex            fallback_mutex_;
+    std::vector<Fallback> fallbacks_;
+    std::atomic<u64>      fallback_count_;
+};
+
+} // namespace mksv
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "mksv/math/types.hpp"
+
+namespace mksv
+{
+struct Vertex {
+    vec3 pos;
+    vec3 col;
+};
+} // namespace mksv
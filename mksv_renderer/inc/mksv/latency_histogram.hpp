@@ -0,0 +1,55 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <array>
+#include <bit>
+
+namespace mksv
+{
+// Counts microsecond values in log-linear buckets, the layout of an HDR histogram. Values below SUB_BUCKET_COUNT get a
+// bucket each, every power of two above is split into SUB_BUCKET_COUNT / 2 buckets, so a bucket is never wider than
+// 1/32 of the values in it. Memory stays the same however many values are added, and values can be removed again to
+// keep a rolling window.
+class LatencyHistogram
+{
+public:
+    static inline constexpr u32 SUB_BUCKET_BITS = 6;
+    static inline constexpr u32 SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+
+    // Larger values are clamped, about 16.7 s
+    static inline constexpr u32 MAX_VALUE = ( 1u << 24 ) - 1;
+    static inline constexpr u32 BUCKET_COUNT =
+        ( static_cast<u32>( std::bit_width( MAX_VALUE ) ) - SUB_BUCKET_BITS + 2 ) * ( SUB_BUCKET_COUNT / 2 );
+
+public:
+    LatencyHistogram();
+    LatencyHistogram( const LatencyHistogram& ) = default;
+    LatencyHistogram( LatencyHistogram&& ) = default;
+    auto operator=( const LatencyHistogram& ) -> LatencyHistogram& = default;
+    auto operator=( LatencyHistogram&& ) -> LatencyHistogram& = default;
+    ~LatencyHistogram() = default;
+
+public:
+    auto add( const u32 microseconds ) -> void;
+
+    // microseconds has to have been added before
+    auto remove( const u32 microseconds ) -> void;
+    auto clear() -> void;
+
+    // Highest value of the bucket the percentile in [0, 100] falls into, 0 when empty
+    auto get_percentile( const f64 percentile ) const -> u32;
+    auto get_mean() const -> f64;
+    auto get_count() const -> u32;
+
+private:
+    static auto get_bucket( const u32 microseconds ) -> u32;
+    static auto get_bucket_max( const u32 bucket ) -> u32;
+
+private:
+    std::array<u32, BUCKET_COUNT> counts_;
+    u32                           count_;
+    u64                           sum_;
+};
+
+} // namespace mksv
@@ -2,30 +2,253 @@
 
 #include "mksv/common/types.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <format>
+#include <iterator>
 #include <source_location>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Log calls below this level compile to nothing: 0 keeps every level, 1 drops info and 2 drops warnings as well. The
+// arguments of a dropped call are still evaluated, only recording and formatting them is skipped.
+#if !defined( MKSV_LOG_MIN_LEVEL )
+#define MKSV_LOG_MIN_LEVEL 0
+#endif
 
 namespace mksv
 {
-enum class LogLevel {
+enum class LogLevel : u8 {
     Info,
     Warning,
     Error
 };
 
+inline constexpr LogLevel LOG_MIN_LEVEL = static_cast<LogLevel>( MKSV_LOG_MIN_LEVEL );
+
 auto log_level_str( const LogLevel level ) -> std::wstring_view;
 
-auto log_info( const std::wstring_view msg, const std::source_location location = std::source_location::current() )
-    -> void;
+namespace detail
+{
+// Appends the message of a record, the arguments as encoded after its header
+using LogDecoder = auto ( * )( const std::wstring_view format, const std::byte* arguments, std::wstring& out ) -> void;
+
+struct LogRecordHeader {
+    LogDecoder           decoder;
+    const wchar_t*       format;
+    std::source_location location;
+    u32                  format_size;
+    // Of the whole record including the header, a multiple of LOG_RECORD_ALIGNMENT
+    u32      size;
+    LogLevel level;
+};
+
+inline constexpr u32 LOG_RECORD_ALIGNMENT = 8;
 
-auto log_warning( const std::wstring_view msg, const std::source_location location = std::source_location::current() )
-    -> void;
+// Longer string arguments are cut off
+inline constexpr u32 LOG_MAX_STRING_LENGTH = 4096;
+
+constexpr auto align_log_size( const usize size ) -> u32
+{
+    return static_cast<u32>( ( size + LOG_RECORD_ALIGNMENT - 1 ) & ~usize{ LOG_RECORD_ALIGNMENT - 1 } );
+}
+
+// Strings of any kind are recorded by value and formatted as std::wstring_view, everything else as is
+template <typename T>
+struct LogStored {
+    using type = std::decay_t<T>;
+};
+
+template <typename T>
+    requires std::is_convertible_v<const T&, std::wstring_view>
+struct LogStored<T> {
+    using type = std::wstring_view;
+};
+
+template <typename T>
+using LogStoredType = typename LogStored<T>::type;
+
+template <typename T>
+struct LogArgument {
+    static_assert(
+        std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+        "Log arguments are recorded as bytes, format anything else into a string first"
+    );
+
+    static auto get_size( const T& ) -> u32
+    {
+        return align_log_size( sizeof( T ) );
+    }
+
+    static auto encode( const T& value, std::byte*& out ) -> void
+    {
+        std::memcpy( out, &value, sizeof( T ) );
+        out += get_size( value );
+    }
+
+    static auto decode( const std::byte*& in ) -> T
+    {
+        T value;
+        std::memcpy( &value, in, sizeof( T ) );
+        in += get_size( value );
+        return value;
+    }
+};
+
+template <>
+struct LogArgument<std::wstring_view> {
+    static auto get_length( const std::wstring_view value ) -> u32
+    {
+        return static_cast<u32>( std::min<usize>( value.size(), LOG_MAX_STRING_LENGTH ) );
+    }
+
+    static auto get_size( const std::wstring_view value ) -> u32
+    {
+        return align_log_size( sizeof( u32 ) + get_length( value ) * sizeof( wchar_t ) );
+    }
+
+    static auto encode( const std::wstring_view value, std::byte*& out ) -> void
+    {
+        const u32 length = get_length( value );
+        std::memcpy( out, &length, sizeof( u32 ) );
+        std::memcpy( out + sizeof( u32 ), value.data(), length * sizeof( wchar_t ) );
+        out += get_size( value );
+    }
+
+    // Points into the record, which outlives the formatting
+    static auto decode( const std::byte*& in ) -> std::wstring_view
+    {
+        u32 length = 0;
+        std::memcpy( &length, in, sizeof( u32 ) );
+        const std::wstring_view value{ reinterpret_cast<const wchar_t*>( in + sizeof( u32 ) ), length };
+        in += get_size( value );
+        return value;
+    }
+};
 
-auto log_error( const std::wstring_view msg, const std::source_location location = std::source_location::current() )
-    -> void;
+template <typename... Stored>
+auto decode_log_arguments( const std::wstring_view format, const std::byte* arguments, std::wstring& out ) -> void
+{
+    // Braced initialization decodes the arguments in order
+    const std::tuple<Stored...> values{ LogArgument<Stored>::decode( arguments )... };
+    std::apply(
+        [&]( const Stored&... v ) {
+            std::vformat_to( std::back_inserter( out ), format, std::make_wformat_args( v... ) );
+        },
+        values
+    );
+}
+
+// Space for a record of size bytes, nullptr if the record is dropped. Without a Logger the record is written out on
+// the calling thread by log_commit().
+auto log_reserve( const u32 size ) -> std::byte*;
+auto log_commit( const LogLevel level ) -> void;
+
+template <typename... Args>
+auto log_record(
+    const LogLevel                                      level,
+    const std::wformat_string<LogStoredType<Args>...>& format,
+    const std::source_location&                         location,
+    const Args&... args
+) -> void
+{
+    constexpr u32 header_size = align_log_size( sizeof( LogRecordHeader ) );
+    const u32     size = header_size + ( 0 + ... + LogArgument<LogStoredType<Args>>::get_size( args ) );
+
+    std::byte* const record = log_reserve( size );
+    if ( !record ) {
+        return;
+    }
+
+    const LogRecordHeader header = {
+        .decoder = &decode_log_arguments<LogStoredType<Args>...>,
+        .format = format.get().data(),
+        .location = location,
+        .format_size = static_cast<u32>( format.get().size() ),
+        .size = size,
+        .level = level,
+    };
+    std::memcpy( record, &header, sizeof( header ) );
+
+    std::byte* arguments = record + header_size;
+    ( LogArgument<LogStoredType<Args>>::encode( args, arguments ), ... );
+    log_commit( level );
+}
+} // namespace detail
+
+// Format string checked at compile time, along with the location of the log call it is written in
+template <typename... Args>
+struct LogFormat {
+    template <typename T>
+        requires std::is_convertible_v<const T&, std::wstring_view>
+    consteval LogFormat( const T& text, const std::source_location call_location = std::source_location::current() )
+        : format{ text },
+          location{ call_location }
+    {
+    }
+
+    std::wformat_string<Args...> format;
+    std::source_location         location;
+};
+
+// The log functions record the format string, the location and a copy of the arguments into a buffer of the calling
+// thread, a Logger formats and writes them out on its own thread. Arguments are strings or trivially copyable values.
+template <typename... Args>
+auto log_info( const LogFormat<detail::LogStoredType<Args>...> format, const Args&... args ) -> void
+{
+    if constexpr ( LogLevel::Info >= LOG_MIN_LEVEL ) {
+        detail::log_record( LogLevel::Info, format.format, format.location, args... );
+    }
+}
+
+template <typename... Args>
+auto log_warning( const LogFormat<detail::LogStoredType<Args>...> format, const Args&... args ) -> void
+{
+    if constexpr ( LogLevel::Warning >= LOG_MIN_LEVEL ) {
+        detail::log_record( LogLevel::Warning, format.format, format.location, args... );
+    }
+}
+
+template <typename... Args>
+auto log_error( const LogFormat<detail::LogStoredType<Args>...> format, const Args&... args ) -> void
+{
+    detail::log_record( LogLevel::Error, format.format, format.location, args... );
+}
+
+// Messages only known at runtime
+inline auto log_info(
+    const std::wstring_view    msg,
+    const std::source_location location = std::source_location::current()
+) -> void
+{
+    if constexpr ( LogLevel::Info >= LOG_MIN_LEVEL ) {
+        detail::log_record( LogLevel::Info, L"{}", location, msg );
+    }
+}
+
+inline auto log_warning(
+    const std::wstring_view    msg,
+    const std::source_location location = std::source_location::current()
+) -> void
+{
+    if constexpr ( LogLevel::Warning >= LOG_MIN_LEVEL ) {
+        detail::log_record( LogLevel::Warning, L"{}", location, msg );
+    }
+}
+
+inline auto log_error(
+    const std::wstring_view    msg,
+    const std::source_location location = std::source_location::current()
+) -> void
+{
+    detail::log_record( LogLevel::Error, L"{}", location, msg );
+}
 
+#if defined( _WIN32 )
 auto log_last_window_error( const std::source_location location = std::source_location::current() ) -> void;
 
 auto log_hresult( const u32 hr, const std::source_location location = std::source_location::current() ) -> void;
+#endif
 } // namespace mksv
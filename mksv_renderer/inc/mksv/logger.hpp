@@ -0,0 +1,169 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/log.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace detail
+{
+struct LogRing;
+}
+
+// Destination of the formatted log lines, called on the logger's thread only
+class LogSink
+{
+public:
+    virtual ~LogSink() = default;
+
+public:
+    // line ends with a line break
+    virtual auto write( const LogLevel level, const std::wstring& line ) -> void = 0;
+
+    // Called after every batch of lines
+    virtual auto flush() -> void = 0;
+};
+
+// Writes UTF-8 to a file, which is truncated when opened
+class FileLogSink final : public LogSink
+{
+public:
+    static auto create( const std::filesystem::path& path ) -> std::unique_ptr<FileLogSink>;
+
+public:
+    FileLogSink( const FileLogSink& ) = delete;
+    FileLogSink( FileLogSink&& ) = delete;
+    auto operator=( const FileLogSink& ) -> FileLogSink& = delete;
+    auto operator=( FileLogSink&& ) -> FileLogSink& = delete;
+    ~FileLogSink() override = default;
+
+public:
+    auto write( const LogLevel level, const std::wstring& line ) -> void override;
+    auto flush() -> void override;
+
+private:
+    explicit FileLogSink( std::ofstream file );
+
+private:
+    std::ofstream file_;
+    std::string   utf8_;
+};
+
+// Writes UTF-8 to stderr
+class StderrLogSink final : public LogSink
+{
+public:
+    StderrLogSink() = default;
+    StderrLogSink( const StderrLogSink& ) = delete;
+    StderrLogSink( StderrLogSink&& ) = delete;
+    auto operator=( const StderrLogSink& ) -> StderrLogSink& = delete;
+    auto operator=( StderrLogSink&& ) -> StderrLogSink& = delete;
+    ~StderrLogSink() override = default;
+
+public:
+    auto write( const LogLevel level, const std::wstring& line ) -> void override;
+    auto flush() -> void override;
+
+private:
+    std::string utf8_;
+};
+
+#if defined( _WIN32 )
+// Writes to the debugger's output window with OutputDebugString
+class DebuggerLogSink final : public LogSink
+{
+public:
+    DebuggerLogSink() = default;
+    DebuggerLogSink( const DebuggerLogSink& ) = delete;
+    DebuggerLogSink( DebuggerLogSink&& ) = delete;
+    auto operator=( const DebuggerLogSink& ) -> DebuggerLogSink& = delete;
+    auto operator=( DebuggerLogSink&& ) -> DebuggerLogSink& = delete;
+    ~DebuggerLogSink() override = default;
+
+public:
+    auto write( const LogLevel level, const std::wstring& line ) -> void override;
+    auto flush() -> void override;
+};
+#endif
+
+// Formats and writes out the records of the log functions on a thread of its own. Every thread that logs gets a
+// lock-free single producer, single consumer ring the first time it does, so a log call only copies its arguments
+// and never waits on other threads, unless its ring is full. Lines of one thread keep their order, lines of different
+// threads are not ordered among each other.
+//
+// The thread wakes up every FLUSH_INTERVAL, and right away for errors. There is one logger at a time, without one the
+// log functions format and write to the debugger, or stderr off Windows, on the calling thread. The logger has to
+// outlive every thread that logs while it exists.
+class Logger
+{
+public:
+    // Bytes of records a thread can have in flight
+    static inline constexpr u32 RING_CAPACITY = 256 * 1024;
+
+    static inline constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 5 };
+
+public:
+    // Fails if there already is a logger
+    static auto create( std::vector<std::unique_ptr<LogSink>> sinks ) -> std::unique_ptr<Logger>;
+
+public:
+    Logger( const Logger& ) = delete;
+    Logger( Logger&& ) = delete;
+    auto operator=( const Logger& ) -> Logger& = delete;
+    auto operator=( Logger&& ) -> Logger& = delete;
+
+    // Writes out every record still in the rings
+    ~Logger();
+
+public:
+    // Returns once every record logged before the call has been written and the sinks are flushed
+    auto flush() -> void;
+
+    // Records too large for a ring
+    auto get_dropped_count() const -> u64;
+
+private:
+    explicit Logger( std::vector<std::unique_ptr<LogSink>> sinks );
+
+    friend auto detail::log_reserve( const u32 size ) -> std::byte*;
+    friend auto detail::log_commit( const LogLevel level ) -> void;
+
+    auto get_thread_ring() -> detail::LogRing*;
+    auto wake() -> void;
+    auto thread_main( const std::stop_token stop_token ) -> void;
+    auto drain() -> void;
+
+private:
+    std::vector<std::unique_ptr<LogSink>> sinks_;
+
+    // Tells the rings of this logger apart from those of earlier ones in the threads' ring cache
+    u64 generation_;
+
+    std::mutex                                    rings_mutex_;
+    std::vector<std::unique_ptr<detail::LogRing>> rings_;
+
+    std::mutex              wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<bool>       wake_requested_;
+    std::condition_variable flushed_cv_;
+    u64                     flush_requests_;
+    u64                     flushes_done_;
+
+    std::atomic<u64> dropped_count_;
+    std::wstring     line_;
+    std::jthread     thread_;
+};
+
+} // namespace mksv
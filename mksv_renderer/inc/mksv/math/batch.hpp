@@ -0,0 +1,52 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/math/types.hpp"
+
+#include <array>
+#include <span>
+
+namespace mksv
+{
+// Structure of arrays views used to process many transforms with the native SIMD width.
+// Element streams of a matrix are laid out as elements[row * 4 + column][index].
+struct Mat4SoA {
+    std::array<f32*, 16> elements;
+};
+
+struct ConstMat4SoA {
+    std::array<const f32*, 16> elements;
+};
+
+struct Vec3SoA {
+    f32* x;
+    f32* y;
+    f32* z;
+};
+
+struct ConstVec3SoA {
+    const f32* x;
+    const f32* y;
+    const f32* z;
+};
+
+struct Vec4SoA {
+    f32* x;
+    f32* y;
+    f32* z;
+    f32* w;
+};
+
+// out[i] = lhs[i] * rhs
+auto mul_batch( const std::span<const mat4> lhs, const mat4& rhs, const std::span<mat4> out ) -> void;
+
+// out[i] = lhs[i] * rhs
+auto mul_batch( const ConstMat4SoA lhs, const mat4& rhs, const Mat4SoA out, const usize count ) -> void;
+
+// out[i] = float4( points[i], 1 ) * m
+auto transform_points_batch( const ConstVec3SoA points, const mat4& m, const Vec4SoA out, const usize count ) -> void;
+
+auto to_soa( const std::span<const mat4> matrices, const Mat4SoA out ) -> void;
+
+auto from_soa( const ConstMat4SoA matrices, const std::span<mat4> out ) -> void;
+} // namespace mksv
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "mksv/math/consts.hpp"
+#include "mksv/math/simd.hpp"
+#include "mksv/math/types.hpp"
+#include "mksv/math/vec.hpp"
+
+#include <cmath>
+
+namespace mksv
+{
+constexpr auto to_radians( const f32 degrees ) -> f32
+{
+    return degrees * ( PI / 180.0f );
+}
+
+constexpr auto mat4_identity() -> mat4
+{
+    return { {
+        { 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f },
+    } };
+}
+
+inline auto transform( const vec4& v, const mat4& m ) -> vec4
+{
+    const simd::f32x4 r0 = to_simd( m.r[0] );
+    const simd::f32x4 r1 = to_simd( m.r[1] );
+    const simd::f32x4 r2 = to_simd( m.r[2] );
+    const simd::f32x4 r3 = to_simd( m.r[3] );
+
+    simd::f32x4 result = simd::mul( simd::splat( v.x ), r0 );
+    result = simd::madd( simd::splat( v.y ), r1, result );
+    result = simd::madd( simd::splat( v.z ), r2, result );
+    result = simd::madd( simd::splat( v.w ), r3, result );
+
+    return from_simd( result );
+}
+
+inline auto transform_point( const vec3& p, const mat4& m ) -> vec3
+{
+    return to_vec3( transform( to_vec4( p, 1.0f ), m ) );
+}
+
+inline auto transform_direction( const vec3& d, const mat4& m ) -> vec3
+{
+    return to_vec3( transform( to_vec4( d, 0.0f ), m ) );
+}
+
+inline auto operator*( const mat4& a, const mat4& b ) -> mat4
+{
+    const simd::f32x4 b0 = to_simd( b.r[0] );
+    const simd::f32x4 b1 = to_simd( b.r[1] );
+    const simd::f32x4 b2 = to_simd( b.r[2] );
+    const simd::f32x4 b3 = to_simd( b.r[3] );
+
+    mat4 result;
+    for ( u32 i = 0; i < 4; ++i ) {
+        const simd::f32x4 row = to_simd( a.r[i] );
+
+        simd::f32x4 acc = simd::mul( simd::splat_lane<0>( row ), b0 );
+        acc = simd::madd( simd::splat_lane<1>( row ), b1, acc );
+        acc = simd::madd( simd::splat_lane<2>( row ), b2, acc );
+        acc = simd::madd( simd::splat_lane<3>( row ), b3, acc );
+        result.r[i] = from_simd( acc );
+    }
+
+    return result;
+}
+
+constexpr auto transpose( const mat4& m ) -> mat4
+{
+    return { {
+        { m.r[0].x, m.r[1].x, m.r[2].x, m.r[3].x },
+        { m.r[0].y, m.r[1].y, m.r[2].y, m.r[3].y },
+        { m.r[0].z, m.r[1].z, m.r[2].z, m.r[3].z },
+        { m.r[0].w, m.r[1].w, m.r[2].w, m.r[3].w },
+    } };
+}
+
+constexpr auto translation( const vec3& t ) -> mat4
+{
+    return { {
+        { 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+        { t.x, t.y, t.z, 1.0f },
+    } };
+}
+
+constexpr auto scaling( const vec3& s ) -> mat4
+{
+    return { {
+        { s.x, 0.0f, 0.0f, 0.0f },
+        { 0.0f, s.y, 0.0f, 0.0f },
+        { 0.0f, 0.0f, s.z, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f },
+    } };
+}
+
+// Same result as XMMatrixRotationAxis, the axis does not need to be normalized
+inline auto rotation_axis( const vec3& axis, const f32 angle ) -> mat4
+{
+    const vec3 n = normalize( axis );
+    const f32  s = std::sin( angle );
+    const f32  c = std::cos( angle );
+    const f32  t = 1.0f - c;
+
+    return { {
+        { c + n.x * n.x * t, n.x * n.y * t + n.z * s, n.x * n.z * t - n.y * s, 0.0f },
+        { n.x * n.y * t - n.z * s, c + n.y * n.y * t, n.y * n.z * t + n.x * s, 0.0f },
+        { n.x * n.z * t + n.y * s, n.y * n.z * t - n.x * s, c + n.z * n.z * t, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f },
+    } };
+}
+
+inline auto look_at_lh( const vec3& eye, const vec3& focus, const vec3& up ) -> mat4
+{
+    const vec3 z = normalize( focus - eye );
+    const vec3 x = normalize( cross( up, z ) );
+    const vec3 y = cross( z, x );
+
+    return { {
+        { x.x, y.x, z.x, 0.0f },
+        { x.y, y.y, z.y, 0.0f },
+        { x.z, y.z, z.z, 0.0f },
+        { -dot( x, eye ), -dot( y, eye ), -dot( z, eye ), 1.0f },
+    } };
+}
+
+inline auto perspective_fov_lh( const f32 fov_y, const f32 aspect_ratio, const f32 near_z, const f32 far_z ) -> mat4
+{
+    const f32 h = 1.0f / std::tan( fov_y * 0.5f );
+    const f32 w = h / aspect_ratio;
+    const f32 range = far_z / ( far_z - near_z );
+
+    return { {
+        { w, 0.0f, 0.0f, 0.0f },
+        { 0.0f, h, 0.0f, 0.0f },
+        { 0.0f, 0.0f, range, 1.0f },
+        { 0.0f, 0.0f, -range * near_z, 0.0f },
+    } };
+}
+
+// Inverse of a matrix made of rotation, uniform or non-uniform scale and translation only
+inline auto inverse_affine( const mat4& m ) -> mat4
+{
+    const vec3 r0 = to_vec3( m.r[0] );
+    const vec3 r1 = to_vec3( m.r[1] );
+    const vec3 r2 = to_vec3( m.r[2] );
+    const vec3 t = to_vec3( m.r[3] );
+
+    const vec3 c0 = cross( r1, r2 );
+    const vec3 c1 = cross( r2, r0 );
+    const vec3 c2 = cross( r0, r1 );
+    const f32  inv_det = 1.0f / dot( r0, c0 );
+
+    const vec3 i0 = { c0.x * inv_det, c1.x * inv_det, c2.x * inv_det };
+    const vec3 i1 = { c0.y * inv_det, c1.y * inv_det, c2.y * inv_det };
+    const vec3 i2 = { c0.z * inv_det, c1.z * inv_det, c2.z * inv_det };
+
+    return { {
+        to_vec4( i0, 0.0f ),
+        to_vec4( i1, 0.0f ),
+        to_vec4( i2, 0.0f ),
+        { -( t.x * i0.x + t.y * i1.x + t.z * i2.x ),
+         -( t.x * i0.y + t.y * i1.y + t.z * i2.y ),
+         -( t.x * i0.z + t.y * i1.z + t.z * i2.z ),
+         1.0f },
+    } };
+}
+} // namespace mksv
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "mksv/math/simd.hpp"
+#include "mksv/math/types.hpp"
+#include "mksv/math/vec.hpp"
+
+#include <cmath>
+
+namespace mksv
+{
+constexpr auto quat_identity() -> quat
+{
+    return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+inline auto quat_from_axis_angle( const vec3& axis, const f32 angle ) -> quat
+{
+    const vec3 n = normalize( axis );
+    const f32  s = std::sin( angle * 0.5f );
+
+    return { n.x * s, n.y * s, n.z * s, std::cos( angle * 0.5f ) };
+}
+
+constexpr auto conjugate( const quat& q ) -> quat
+{
+    return { -q.x, -q.y, -q.z, q.w };
+}
+
+inline auto dot( const quat& a, const quat& b ) -> f32
+{
+    return simd::dot4( simd::load( &a.x ), simd::load( &b.x ) );
+}
+
+inline auto normalize( const quat& q ) -> quat
+{
+    const f32 len = std::sqrt( dot( q, q ) );
+    if ( len <= 0.0f ) {
+        return quat_identity();
+    }
+
+    const f32 inv_len = 1.0f / len;
+    return { q.x * inv_len, q.y * inv_len, q.z * inv_len, q.w * inv_len };
+}
+
+// Rotation by a followed by rotation by b, matching the row vector matrix order (to_mat4( a ) * to_mat4( b ))
+constexpr auto operator*( const quat& a, const quat& b ) -> quat
+{
+    return {
+        b.w * a.x + a.w * b.x + ( b.y * a.z - b.z * a.y ),
+        b.w * a.y + a.w * b.y + ( b.z * a.x - b.x * a.z ),
+        b.w * a.z + a.w * b.z + ( b.x * a.y - b.y * a.x ),
+        b.w * a.w - ( b.x * a.x + b.y * a.y + b.z * a.z ),
+    };
+}
+
+constexpr auto rotate( const vec3& v, const quat& q ) -> vec3
+{
+    const vec3 u = { q.x, q.y, q.z };
+    const vec3 t = cross( u, v ) * 2.0f;
+
+    return v + t * q.w + cross( u, t );
+}
+
+inline auto slerp( const quat& a, const quat& b, const f32 t ) -> quat
+{
+    f32  cos_theta = dot( a, b );
+    quat end = b;
+    if ( cos_theta < 0.0f ) {
+        cos_theta = -cos_theta;
+        end = { -b.x, -b.y, -b.z, -b.w };
+    }
+
+    f32 wa = 1.0f - t;
+    f32 wb = t;
+    if ( cos_theta < 0.9995f ) {
+        const f32 theta = std::acos( cos_theta );
+        const f32 inv_sin = 1.0f / std::sin( theta );
+        wa = std::sin( ( 1.0f - t ) * theta ) * inv_sin;
+        wb = std::sin( t * theta ) * inv_sin;
+    }
+
+    return normalize( quat{
+        a.x * wa + end.x * wb,
+        a.y * wa + end.y * wb,
+        a.z * wa + end.z * wb,
+        a.w * wa + end.w * wb,
+    } );
+}
+
+constexpr auto to_mat4( const quat& q ) -> mat4
+{
+    const f32 xx = q.x * q.x;
+    const f32 yy = q.y * q.y;
+    const f32 zz = q.z * q.z;
+    const f32 xy = q.x * q.y;
+    const f32 xz = q.x * q.z;
+    const f32 yz = q.y * q.z;
+    const f32 wx = q.w * q.x;
+    const f32 wy = q.w * q.y;
+    const f32 wz = q.w * q.z;
+
+    return { {
+        { 1.0f - 2.0f * ( yy + zz ), 2.0f * ( xy + wz ), 2.0f * ( xz - wy ), 0.0f },
+        { 2.0f * ( xy - wz ), 1.0f - 2.0f * ( xx + zz ), 2.0f * ( yz + wx ), 0.0f },
+        { 2.0f * ( xz + wy ), 2.0f * ( yz - wx ), 1.0f - 2.0f * ( xx + yy ), 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f },
+    } };
+}
+
+// Scale, then rotate, then translate
+constexpr auto trs( const vec3& translation, const quat& rotation, const vec3& scale ) -> mat4
+{
+    mat4 m = to_mat4( rotation );
+    m.r[0] = { m.r[0].x * scale.x, m.r[0].y * scale.x, m.r[0].z * scale.x, 0.0f };
+    m.r[1] = { m.r[1].x * scale.y, m.r[1].y * scale.y, m.r[1].z * scale.y, 0.0f };
+    m.r[2] = { m.r[2].x * scale.z, m.r[2].y * scale.z, m.r[2].z * scale.z, 0.0f };
+    m.r[3] = { translation.x, translation.y, translation.z, 1.0f };
+    return m;
+}
+} // namespace mksv
@@ -0,0 +1,464 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <cmath>
+
+// Backend selection. Define MKSV_MATH_SCALAR to force the scalar reference implementation.
+#if !defined( MKSV_MATH_SCALAR )
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#define MKSV_SIMD_SSE 1
+#if defined( __AVX2__ )
+#define MKSV_SIMD_AVX2 1
+#include <immintrin.h>
+#if defined( __FMA__ ) || defined( _MSC_VER )
+#define MKSV_SIMD_FMA 1
+#endif
+#endif
+#if defined( __SSE4_1__ ) || defined( __AVX__ )
+#define MKSV_SIMD_SSE4_1 1
+#include <smmintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#elif defined( __ARM_NEON ) || defined( _M_ARM64 )
+#define MKSV_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace mksv::simd
+{
+#if defined( MKSV_SIMD_SSE )
+using f32x4 = __m128;
+
+inline auto load( const f32* const p ) -> f32x4
+{
+    return _mm_loadu_ps( p );
+}
+
+inline auto store( f32* const p, const f32x4 v ) -> void
+{
+    _mm_storeu_ps( p, v );
+}
+
+inline auto set( const f32 x, const f32 y, const f32 z, const f32 w ) -> f32x4
+{
+    return _mm_setr_ps( x, y, z, w );
+}
+
+inline auto splat( const f32 v ) -> f32x4
+{
+    return _mm_set1_ps( v );
+}
+
+template <u32 lane>
+inline auto splat_lane( const f32x4 v ) -> f32x4
+{
+    return _mm_shuffle_ps( v, v, _MM_SHUFFLE( lane, lane, lane, lane ) );
+}
+
+inline auto get_x( const f32x4 v ) -> f32
+{
+    return _mm_cvtss_f32( v );
+}
+
+inline auto add( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return _mm_add_ps( a, b );
+}
+
+inline auto sub( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return _mm_sub_ps( a, b );
+}
+
+inline auto mul( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return _mm_mul_ps( a, b );
+}
+
+inline auto div( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return _mm_div_ps( a, b );
+}
+
+inline auto madd( const f32x4 a, const f32x4 b, const f32x4 c ) -> f32x4
+{
+#if defined( MKSV_SIMD_FMA )
+    return _mm_fmadd_ps( a, b, c );
+#else
+    return _mm_add_ps( _mm_mul_ps( a, b ), c );
+#endif
+}
+
+inline auto min( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return _mm_min_ps( a, b );
+}
+
+inline auto max( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return _mm_max_ps( a, b );
+}
+
+inline auto sqrt( const f32x4 v ) -> f32x4
+{
+    return _mm_sqrt_ps( v );
+}
+
+inline auto dot4( const f32x4 a, const f32x4 b ) -> f32
+{
+#if defined( MKSV_SIMD_SSE4_1 )
+    return _mm_cvtss_f32( _mm_dp_ps( a, b, 0xF1 ) );
+#else
+    const f32x4 m = _mm_mul_ps( a, b );
+    const f32x4 s = _mm_add_ps( m, _mm_shuffle_ps( m, m, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    return _mm_cvtss_f32( _mm_add_ss( s, _mm_movehl_ps( s, s ) ) );
+#endif
+}
+
+// Bit i is set when lane i is greater than or equal to zero, NaNs are not
+inline auto ge_zero_mask( const f32x4 v ) -> u32
+{
+    return static_cast<u32>( _mm_movemask_ps( _mm_cmpge_ps( v, _mm_setzero_ps() ) ) );
+}
+#elif defined( MKSV_SIMD_NEON )
+using f32x4 = float32x4_t;
+
+inline auto load( const f32* const p ) -> f32x4
+{
+    return vld1q_f32( p );
+}
+
+inline auto store( f32* const p, const f32x4 v ) -> void
+{
+    vst1q_f32( p, v );
+}
+
+inline auto set( const f32 x, const f32 y, const f32 z, const f32 w ) -> f32x4
+{
+    const f32 values[4] = { x, y, z, w };
+    return vld1q_f32( values );
+}
+
+inline auto splat( const f32 v ) -> f32x4
+{
+    return vdupq_n_f32( v );
+}
+
+template <u32 lane>
+inline auto splat_lane( const f32x4 v ) -> f32x4
+{
+    return vdupq_laneq_f32( v, lane );
+}
+
+inline auto get_x( const f32x4 v ) -> f32
+{
+    return vgetq_lane_f32( v, 0 );
+}
+
+inline auto add( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return vaddq_f32( a, b );
+}
+
+inline auto sub( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return vsubq_f32( a, b );
+}
+
+inline auto mul( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return vmulq_f32( a, b );
+}
+
+inline auto div( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return vdivq_f32( a, b );
+}
+
+inline auto madd( const f32x4 a, const f32x4 b, const f32x4 c ) -> f32x4
+{
+    return vfmaq_f32( c, a, b );
+}
+
+inline auto min( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return vminq_f32( a, b );
+}
+
+inline auto max( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return vmaxq_f32( a, b );
+}
+
+inline auto sqrt( const f32x4 v ) -> f32x4
+{
+    return vsqrtq_f32( v );
+}
+
+inline auto dot4( const f32x4 a, const f32x4 b ) -> f32
+{
+    return vaddvq_f32( vmulq_f32( a, b ) );
+}
+
+inline auto ge_zero_mask( const f32x4 v ) -> u32
+{
+    static constexpr u32 lane_bits[4] = { 1, 2, 4, 8 };
+    return vaddvq_u32( vandq_u32( vcgeq_f32( v, vdupq_n_f32( 0.0f ) ), vld1q_u32( lane_bits ) ) );
+}
+#else
+struct f32x4 {
+    f32 v[4];
+};
+
+inline auto load( const f32* const p ) -> f32x4
+{
+    return { { p[0], p[1], p[2], p[3] } };
+}
+
+inline auto store( f32* const p, const f32x4 v ) -> void
+{
+    for ( u32 i = 0; i < 4; ++i ) {
+        p[i] = v.v[i];
+    }
+}
+
+inline auto set( const f32 x, const f32 y, const f32 z, const f32 w ) -> f32x4
+{
+    return { { x, y, z, w } };
+}
+
+inline auto splat( const f32 v ) -> f32x4
+{
+    return { { v, v, v, v } };
+}
+
+template <u32 lane>
+inline auto splat_lane( const f32x4 v ) -> f32x4
+{
+    return splat( v.v[lane] );
+}
+
+inline auto get_x( const f32x4 v ) -> f32
+{
+    return v.v[0];
+}
+
+template <typename Op>
+inline auto lanewise( const f32x4 a, const f32x4 b, Op op ) -> f32x4
+{
+    return { { op( a.v[0], b.v[0] ), op( a.v[1], b.v[1] ), op( a.v[2], b.v[2] ), op( a.v[3], b.v[3] ) } };
+}
+
+inline auto add( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return lanewise( a, b, []( const f32 x, const f32 y ) { return x + y; } );
+}
+
+inline auto sub( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return lanewise( a, b, []( const f32 x, const f32 y ) { return x - y; } );
+}
+
+inline auto mul( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return lanewise( a, b, []( const f32 x, const f32 y ) { return x * y; } );
+}
+
+inline auto div( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return lanewise( a, b, []( const f32 x, const f32 y ) { return x / y; } );
+}
+
+inline auto madd( const f32x4 a, const f32x4 b, const f32x4 c ) -> f32x4
+{
+    return add( mul( a, b ), c );
+}
+
+inline auto min( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return lanewise( a, b, []( const f32 x, const f32 y ) { return y < x ? y : x; } );
+}
+
+inline auto max( const f32x4 a, const f32x4 b ) -> f32x4
+{
+    return lanewise( a, b, []( const f32 x, const f32 y ) { return x < y ? y : x; } );
+}
+
+inline auto sqrt( const f32x4 v ) -> f32x4
+{
+    return { { std::sqrt( v.v[0] ), std::sqrt( v.v[1] ), std::sqrt( v.v[2] ), std::sqrt( v.v[3] ) } };
+}
+
+inline auto dot4( const f32x4 a, const f32x4 b ) -> f32
+{
+    return a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3];
+}
+
+inline auto ge_zero_mask( const f32x4 v ) -> u32
+{
+    u32 mask = 0;
+    for ( u32 i = 0; i < 4; ++i ) {
+        mask |= v.v[i] >= 0.0f ? 1u << i : 0u;
+    }
+    return mask;
+}
+#endif
+
+// Native-width lanes used by the batch (SoA) kernels.
+#if defined( MKSV_SIMD_AVX2 )
+inline constexpr usize WIDE_LANE_COUNT = 8;
+
+using f32xw = __m256;
+
+inline auto wide_load( const f32* const p ) -> f32xw
+{
+    return _mm256_loadu_ps( p );
+}
+
+inline auto wide_store( f32* const p, const f32xw v ) -> void
+{
+    _mm256_storeu_ps( p, v );
+}
+
+inline auto wide_splat( const f32 v ) -> f32xw
+{
+    return _mm256_set1_ps( v );
+}
+
+inline auto wide_mul( const f32xw a, const f32xw b ) -> f32xw
+{
+    return _mm256_mul_ps( a, b );
+}
+
+inline auto wide_add( const f32xw a, const f32xw b ) -> f32xw
+{
+    return _mm256_add_ps( a, b );
+}
+
+inline auto wide_sub( const f32xw a, const f32xw b ) -> f32xw
+{
+    return _mm256_sub_ps( a, b );
+}
+
+inline auto wide_madd( const f32xw a, const f32xw b, const f32xw c ) -> f32xw
+{
+#if defined( MKSV_SIMD_FMA )
+    return _mm256_fmadd_ps( a, b, c );
+#else
+    return _mm256_add_ps( _mm256_mul_ps( a, b ), c );
+#endif
+}
+
+inline auto wide_sqrt( const f32xw v ) -> f32xw
+{
+    return _mm256_sqrt_ps( v );
+}
+
+// Bit i is set when lane i is greater than or equal to zero, NaNs are not
+inline auto wide_ge_zero_mask( const f32xw v ) -> u32
+{
+    return static_cast<u32>( _mm256_movemask_ps( _mm256_cmp_ps( v, _mm256_setzero_ps(), _CMP_GE_OQ ) ) );
+}
+#elif defined( MKSV_SIMD_SSE ) || defined( MKSV_SIMD_NEON )
+inline constexpr usize WIDE_LANE_COUNT = 4;
+
+using f32xw = f32x4;
+
+inline auto wide_load( const f32* const p ) -> f32xw
+{
+    return load( p );
+}
+
+inline auto wide_store( f32* const p, const f32xw v ) -> void
+{
+    store( p, v );
+}
+
+inline auto wide_splat( const f32 v ) -> f32xw
+{
+    return splat( v );
+}
+
+inline auto wide_mul( const f32xw a, const f32xw b ) -> f32xw
+{
+    return mul( a, b );
+}
+
+inline auto wide_add( const f32xw a, const f32xw b ) -> f32xw
+{
+    return add( a, b );
+}
+
+inline auto wide_sub( const f32xw a, const f32xw b ) -> f32xw
+{
+    return sub( a, b );
+}
+
+inline auto wide_madd( const f32xw a, const f32xw b, const f32xw c ) -> f32xw
+{
+    return madd( a, b, c );
+}
+
+inline auto wide_sqrt( const f32xw v ) -> f32xw
+{
+    return sqrt( v );
+}
+
+inline auto wide_ge_zero_mask( const f32xw v ) -> u32
+{
+    return ge_zero_mask( v );
+}
+#else
+inline constexpr usize WIDE_LANE_COUNT = 1;
+
+using f32xw = f32;
+
+inline auto wide_load( const f32* const p ) -> f32xw
+{
+    return *p;
+}
+
+inline auto wide_store( f32* const p, const f32xw v ) -> void
+{
+    *p = v;
+}
+
+inline auto wide_splat( const f32 v ) -> f32xw
+{
+    return v;
+}
+
+inline auto wide_mul( const f32xw a, const f32xw b ) -> f32xw
+{
+    return a * b;
+}
+
+inline auto wide_add( const f32xw a, const f32xw b ) -> f32xw
+{
+    return a + b;
+}
+
+inline auto wide_sub( const f32xw a, const f32xw b ) -> f32xw
+{
+    return a - b;
+}
+
+inline auto wide_madd( const f32xw a, const f32xw b, const f32xw c ) -> f32xw
+{
+    return a * b + c;
+}
+
+inline auto wide_sqrt( const f32xw v ) -> f32xw
+{
+    return std::sqrt( v );
+}
+
+inline auto wide_ge_zero_mask( const f32xw v ) -> u32
+{
+    return v >= 0.0f ? 1u : 0u;
+}
+#endif
+} // namespace mksv::simd
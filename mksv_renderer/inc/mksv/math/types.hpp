@@ -1,13 +1,45 @@
 #pragma once
 
-#include <DirectXMath.h>
+#include "mksv/common/types.hpp"
 
 namespace mksv
 {
-using vec2 = DirectX::XMFLOAT2;
-using vec3 = DirectX::XMFLOAT3;
-using vec4 = DirectX::XMVECTOR;
+struct vec2 {
+    f32 x;
+    f32 y;
+};
 
-using mat3 = DirectX::XMFLOAT3X3;
-using mat4 = DirectX::XMMATRIX;
+struct vec3 {
+    f32 x;
+    f32 y;
+    f32 z;
+};
+
+struct alignas( 16 ) vec4 {
+    f32 x;
+    f32 y;
+    f32 z;
+    f32 w;
+};
+
+// Rotation quaternion, (x, y, z) is the vector part and w the scalar part
+struct alignas( 16 ) quat {
+    f32 x;
+    f32 y;
+    f32 z;
+    f32 w;
+};
+
+struct mat3 {
+    vec3 r[3];
+};
+
+// Row major, row vector convention (v' = v * M), same layout as DirectXMath
+struct alignas( 16 ) mat4 {
+    vec4 r[4];
+};
+
+static_assert( sizeof( vec3 ) == 12 );
+static_assert( sizeof( vec4 ) == 16 );
+static_assert( sizeof( mat4 ) == 64 );
 } // namespace mksv
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "mksv/math/simd.hpp"
+#include "mksv/math/types.hpp"
+
+#include <cmath>
+
+namespace mksv
+{
+inline auto to_simd( const vec4& v ) -> simd::f32x4
+{
+    return simd::load( &v.x );
+}
+
+inline auto from_simd( const simd::f32x4 v ) -> vec4
+{
+    vec4 result;
+    simd::store( &result.x, v );
+    return result;
+}
+
+constexpr auto operator+( const vec3& a, const vec3& b ) -> vec3
+{
+    return { a.x + b.x, a.y + b.y, a.z + b.z };
+}
+
+constexpr auto operator-( const vec3& a, const vec3& b ) -> vec3
+{
+    return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+constexpr auto operator-( const vec3& v ) -> vec3
+{
+    return { -v.x, -v.y, -v.z };
+}
+
+constexpr auto operator*( const vec3& v, const f32 s ) -> vec3
+{
+    return { v.x * s, v.y * s, v.z * s };
+}
+
+constexpr auto operator*( const vec3& a, const vec3& b ) -> vec3
+{
+    return { a.x * b.x, a.y * b.y, a.z * b.z };
+}
+
+constexpr auto dot( const vec3& a, const vec3& b ) -> f32
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+constexpr auto cross( const vec3& a, const vec3& b ) -> vec3
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline auto length( const vec3& v ) -> f32
+{
+    return std::sqrt( dot( v, v ) );
+}
+
+inline auto normalize( const vec3& v ) -> vec3
+{
+    const f32 len = length( v );
+    return len > 0.0f ? v * ( 1.0f / len ) : v;
+}
+
+inline auto operator+( const vec4& a, const vec4& b ) -> vec4
+{
+    return from_simd( simd::add( to_simd( a ), to_simd( b ) ) );
+}
+
+inline auto operator-( const vec4& a, const vec4& b ) -> vec4
+{
+    return from_simd( simd::sub( to_simd( a ), to_simd( b ) ) );
+}
+
+inline auto operator*( const vec4& v, const f32 s ) -> vec4
+{
+    return from_simd( simd::mul( to_simd( v ), simd::splat( s ) ) );
+}
+
+inline auto operator*( const vec4& a, const vec4& b ) -> vec4
+{
+    return from_simd( simd::mul( to_simd( a ), to_simd( b ) ) );
+}
+
+inline auto dot( const vec4& a, const vec4& b ) -> f32
+{
+    return simd::dot4( to_simd( a ), to_simd( b ) );
+}
+
+inline auto length( const vec4& v ) -> f32
+{
+    return std::sqrt( dot( v, v ) );
+}
+
+inline auto normalize( const vec4& v ) -> vec4
+{
+    const f32 len = length( v );
+    return len > 0.0f ? v * ( 1.0f / len ) : v;
+}
+
+inline auto min( const vec4& a, const vec4& b ) -> vec4
+{
+    return from_simd( simd::min( to_simd( a ), to_simd( b ) ) );
+}
+
+inline auto max( const vec4& a, const vec4& b ) -> vec4
+{
+    return from_simd( simd::max( to_simd( a ), to_simd( b ) ) );
+}
+
+constexpr auto to_vec4( const vec3& v, const f32 w ) -> vec4
+{
+    return { v.x, v.y, v.z, w };
+}
+
+constexpr auto to_vec3( const vec4& v ) -> vec3
+{
+    return { v.x, v.y, v.z };
+}
+
+constexpr auto lerp( const vec3& a, const vec3& b, const f32 t ) -> vec3
+{
+    return a + ( b - a ) * t;
+}
+} // namespace mksv
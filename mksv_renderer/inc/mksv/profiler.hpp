@@ -0,0 +1,249 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// The profiling macros compile to nothing with MKSV_PROFILE set to 0, the functions and the Profiler stay available
+#if !defined( MKSV_PROFILE )
+#define MKSV_PROFILE 1
+#endif
+
+namespace mksv
+{
+enum class ProfileEventType : u8 {
+    Zone,
+    Counter,
+    Frame,
+    GpuZone
+};
+
+// Names are string literals, or other strings that outlive the Profiler, and are only dereferenced when written out.
+// Times are in ticks, except for GPU zones which are already on the steady clock in nanoseconds.
+struct ProfileEvent {
+    const char* name;
+    u64         begin;
+    // The end of a zone, the value of a counter as the bits of an f64
+    u64              end;
+    ProfileEventType type;
+};
+
+namespace detail
+{
+struct ProfileBuffer;
+
+inline std::atomic<bool> profile_capturing{ false };
+
+// Appends to the buffer of the calling thread, only called while capturing
+auto profile_record( const ProfileEvent& event ) -> void;
+auto profile_frame() -> void;
+} // namespace detail
+
+// The time stamp counter where there is one, read without serializing the instruction stream. Ticks are converted to
+// the steady clock when a capture is written out.
+inline auto read_profile_ticks() -> u64
+{
+#if defined( _M_X64 ) || defined( __x86_64__ )
+    return __rdtsc();
+#else
+    return static_cast<u64>( std::chrono::steady_clock::now().time_since_epoch().count() );
+#endif
+}
+
+inline auto is_profile_capturing() -> bool
+{
+    return detail::profile_capturing.load( std::memory_order_relaxed );
+}
+
+// Times its scope if a capture was running when it was entered
+class ProfileZone
+{
+public:
+    explicit ProfileZone( const char* name )
+        : name_{ name },
+          begin_{ is_profile_capturing() ? read_profile_ticks() : 0 }
+    {
+    }
+
+    ProfileZone( const ProfileZone& ) = delete;
+    ProfileZone( ProfileZone&& ) = delete;
+    auto operator=( const ProfileZone& ) -> ProfileZone& = delete;
+    auto operator=( ProfileZone&& ) -> ProfileZone& = delete;
+
+    ~ProfileZone()
+    {
+        if ( begin_ != 0 ) {
+            detail::profile_record(
+                { .name = name_, .begin = begin_, .end = read_profile_ticks(), .type = ProfileEventType::Zone }
+            );
+        }
+    }
+
+private:
+    const char* name_;
+    u64         begin_;
+};
+
+inline auto profile_counter( const char* name, const f64 value ) -> void
+{
+    if ( is_profile_capturing() ) {
+        detail::profile_record( {
+            .name = name,
+            .begin = read_profile_ticks(),
+            .end = std::bit_cast<u64>( value ),
+            .type = ProfileEventType::Counter,
+        } );
+    }
+}
+
+// GPU work timed with queries and converted to the steady clock, shown on a track of its own
+inline auto profile_gpu_zone(
+    const char*                                 name,
+    const std::chrono::steady_clock::time_point begin,
+    const std::chrono::steady_clock::time_point end
+) -> void
+{
+    if ( is_profile_capturing() ) {
+        const auto to_nanoseconds = []( const std::chrono::steady_clock::time_point time ) {
+            return static_cast<u64>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>( time.time_since_epoch() ).count()
+            );
+        };
+
+        detail::profile_record( {
+            .name = name,
+            .begin = to_nanoseconds( begin ),
+            .end = to_nanoseconds( end ),
+            .type = ProfileEventType::GpuZone,
+        } );
+    }
+}
+
+// Marks the end of a frame, also drives the captures started by Profiler::capture_frames()
+inline auto profile_frame() -> void
+{
+    detail::profile_frame();
+}
+
+// Records zones, counters and frame markers of every thread while a capture runs and writes them out as a Chrome trace,
+// which chrome://tracing and Perfetto open. Every thread that records gets buffers of its own the first time it does,
+// appending to them takes no lock, and the buffers are kept for the next capture. Outside of a capture recording is a
+// single relaxed load.
+//
+// There is one profiler at a time, without one nothing is recorded. The profiler has to outlive every thread that
+// records while it exists.
+class Profiler
+{
+public:
+    // Events per buffer, a thread gets up to MAX_BLOCKS buffers per capture and drops the events past them
+    static inline constexpr u32 BLOCK_SIZE = 16 * 1024;
+    static inline constexpr u32 MAX_BLOCKS = 64;
+
+    // Trace thread id of the GPU zones, far from those of the threads
+    static inline constexpr u32 GPU_TRACK = 1000;
+
+public:
+    // Fails if there already is a profiler
+    static auto create() -> std::unique_ptr<Profiler>;
+
+public:
+    Profiler( const Profiler& ) = delete;
+    Profiler( Profiler&& ) = delete;
+    auto operator=( const Profiler& ) -> Profiler& = delete;
+    auto operator=( Profiler&& ) -> Profiler& = delete;
+    ~Profiler();
+
+public:
+    // Replaces the events of the previous capture once it is ended
+    auto begin_capture() -> void;
+    auto end_capture() -> void;
+
+    // Captures the next frame_count frames, from one frame marker to the frame_count-th one after it, and writes them
+    // to path when done
+    auto capture_frames( const u32 frame_count, std::filesystem::path path ) -> void;
+
+    // Writes the events of the last ended capture, timestamps are in microseconds since the capture began
+    auto write_chrome_trace( const std::filesystem::path& path ) const -> bool;
+
+    auto get_event_count() const -> usize;
+
+    // Events of the last capture that did not fit into the buffers
+    auto get_dropped_count() const -> u64;
+
+private:
+    struct CapturedEvent {
+        ProfileEvent event;
+        u32          thread;
+    };
+
+private:
+    Profiler();
+
+    friend auto detail::profile_record( const ProfileEvent& event ) -> void;
+    friend auto detail::profile_frame() -> void;
+
+    auto get_thread_buffer() -> detail::ProfileBuffer*;
+    auto on_frame() -> void;
+    auto begin_capture_locked() -> void;
+    auto end_capture_locked() -> void;
+    auto to_microseconds( const u64 ticks ) const -> f64;
+    auto to_microseconds( const std::chrono::nanoseconds time ) const -> f64;
+
+private:
+    // Tells the buffers of this profiler apart from those of earlier ones in the threads' buffer cache
+    u64 generation_;
+
+    std::mutex                                          buffers_mutex_;
+    std::vector<std::unique_ptr<detail::ProfileBuffer>> buffers_;
+
+    // Guards the captures, recording threads never take it
+    std::mutex                            capture_mutex_;
+    std::atomic<u64>                      capture_;
+    u64                                   capture_begin_ticks_;
+    u64                                   capture_end_ticks_;
+    std::chrono::steady_clock::time_point capture_begin_time_;
+
+    // Ticks and the steady clock read together when the profiler was created and when the capture ended, they give
+    // the rate of the ticks
+    u64                                   reference_ticks_;
+    std::chrono::steady_clock::time_point reference_time_;
+    f64                                   ticks_per_microsecond_;
+
+    std::vector<CapturedEvent> events_;
+    u64                        dropped_count_;
+
+    // Of capture_frames(), frame markers only take the capture mutex while a frame capture is pending
+    std::atomic<bool>     frame_capture_pending_;
+    u32                   frame_capture_count_;
+    u32                   frame_capture_frames_;
+    std::filesystem::path frame_capture_path_;
+};
+
+} // namespace mksv
+
+#define MKSV_PROFILE_CONCAT_INNER( a, b ) a##b
+#define MKSV_PROFILE_CONCAT( a, b ) MKSV_PROFILE_CONCAT_INNER( a, b )
+
+#if MKSV_PROFILE
+#define MKSV_PROFILE_ZONE( name ) const ::mksv::ProfileZone MKSV_PROFILE_CONCAT( mksv_profile_zone_, __LINE__ )( name )
+#define MKSV_PROFILE_COUNTER( name, value ) ::mksv::profile_counter( name, static_cast<f64>( value ) )
+#define MKSV_PROFILE_FRAME() ::mksv::profile_frame()
+#else
+#define MKSV_PROFILE_ZONE( name ) static_cast<void>( 0 )
+#define MKSV_PROFILE_COUNTER( name, value ) static_cast<void>( 0 )
+#define MKSV_PROFILE_FRAME() static_cast<void>( 0 )
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+#include "mksv/math/types.hpp"
+
+#include <vector>
+
+namespace mksv
+{
+using TransformId = u32;
+
+inline constexpr TransformId INVALID_TRANSFORM = ~0u;
+
+// Local translation, rotation and scale of every node in structure of arrays form, one level per depth in the
+// hierarchy, roots first. Nodes only reference parents on the level above, so a level is done once the one above is,
+// and update() walks the levels in order with every level's nodes computed a full SIMD register at a time, split
+// into blocks on a job system for large levels.
+//
+// Changing a local transform marks the node dirty. update() only recomputes the world matrices of dirty nodes and of
+// the nodes below them, a level with nothing dirty under an unchanged level is skipped outright. World matrices are
+// affine, scale, then rotate, then translate, followed by the parent's world matrix.
+class TransformHierarchy
+{
+public:
+    // Nodes per block when a level is updated on a job system
+    static inline constexpr u32 MIN_BLOCK_SIZE = 16 * 1024;
+
+public:
+    TransformHierarchy() = default;
+    TransformHierarchy( const TransformHierarchy& ) = delete;
+    TransformHierarchy( TransformHierarchy&& ) = default;
+    auto operator=( const TransformHierarchy& ) -> TransformHierarchy& = delete;
+    auto operator=( TransformHierarchy&& ) -> TransformHierarchy& = default;
+    ~TransformHierarchy() = default;
+
+public:
+    auto clear() -> void;
+
+    // Parents have to be created before their children, INVALID_TRANSFORM creates a root. The world matrix is the
+    // identity until the next update().
+    auto create( const TransformId parent, const vec3& translation, const quat& rotation, const vec3& scale )
+        -> TransformId;
+
+    auto set_local( const TransformId node, const vec3& translation, const quat& rotation, const vec3& scale ) -> void;
+    auto set_translation( const TransformId node, const vec3& translation ) -> void;
+    auto set_rotation( const TransformId node, const quat& rotation ) -> void;
+    auto set_scale( const TransformId node, const vec3& scale ) -> void;
+
+    // Recomputes the world matrices below every dirty node, returns how many were recomputed
+    auto update( JobSystem* const jobs = nullptr ) -> u32;
+
+    auto get_world( const TransformId node ) const -> const mat4&;
+    auto get_rotation( const TransformId node ) const -> quat;
+    auto get_parent( const TransformId node ) const -> TransformId;
+    auto get_depth( const TransformId node ) const -> u32;
+    auto get_count() const -> u32;
+    auto get_level_count() const -> u32;
+
+private:
+    struct Location {
+        u32 level;
+        u32 index;
+    };
+
+    struct Level {
+        std::vector<f32> translation_x;
+        std::vector<f32> translation_y;
+        std::vector<f32> translation_z;
+        std::vector<f32> rotation_x;
+        std::vector<f32> rotation_y;
+        std::vector<f32> rotation_z;
+        std::vector<f32> rotation_w;
+        std::vector<f32> scale_x;
+        std::vector<f32> scale_y;
+        std::vector<f32> scale_z;
+        // Index of the parent on the level above
+        std::vector<u32>         parents;
+        std::vector<TransformId> nodes;
+        std::vector<mat4>        world;
+        // dirty is set by the setters, changed by update() for every node whose world matrix it recomputed
+        std::vector<u8> dirty;
+        std::vector<u8> changed;
+        u32             dirty_count;
+        u32             changed_count;
+    };
+
+private:
+    auto mark_dirty( const Location& location ) -> void;
+
+    // Recomputes the nodes of [first, end) that are dirty or have a changed parent, returns how many
+    static auto update_range( Level& level, const Level* parent, const u32 first, const u32 end ) -> u32;
+
+private:
+    std::vector<Location> locations_;
+    std::vector<Level>    levels_;
+};
+
+} // namespace mksv
@@ -1,14 +1,21 @@
 #pragma once
 
+#include "mksv/assets/vertex_layout.hpp"
 #include "mksv/common/types.hpp"
 
 #include <d3d12.h>
+#include <span>
+#include <vector>
 
 namespace mksv::d3d12
 {
 auto transition_barrier( ID3D12Resource* resource, const D3D12_RESOURCE_STATES before, const D3D12_RESOURCE_STATES after )
     -> D3D12_RESOURCE_BARRIER;
 
+auto aliasing_barrier( ID3D12Resource* before, ID3D12Resource* after ) -> D3D12_RESOURCE_BARRIER;
+
+auto uav_barrier( ID3D12Resource* resource ) -> D3D12_RESOURCE_BARRIER;
+
 auto heap_properties( const D3D12_HEAP_TYPE type ) -> D3D12_HEAP_PROPERTIES;
 
 auto buffer_resource_desc( const u64 width ) -> D3D12_RESOURCE_DESC;
@@ -20,6 +27,20 @@ auto create_root_constant(
     const D3D12_SHADER_VISIBILITY visibility = D3D12_SHADER_VISIBILITY_ALL
 ) -> D3D12_ROOT_PARAMETER;
 
+// type is one of the CBV, SRV and UAV root descriptor types, the buffer is bound by GPU address at record time
+auto create_root_descriptor(
+    const D3D12_ROOT_PARAMETER_TYPE type,
+    const u32                       shader_register,
+    const u32                       register_space = 0,
+    const D3D12_SHADER_VISIBILITY   visibility = D3D12_SHADER_VISIBILITY_ALL
+) -> D3D12_ROOT_PARAMETER;
+
+// Views the bytecode in place, it has to outlive every pipeline state created from it
+auto shader_bytecode( const std::span<const u8> bytecode ) -> D3D12_SHADER_BYTECODE;
+
+// Per vertex elements of the layout in input slot 0, named POSITION, COLOR, NORMAL and TEXCOORD
+auto input_elements( const VertexLayout& layout ) -> std::vector<D3D12_INPUT_ELEMENT_DESC>;
+
 template <typename Inner, D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type>
 struct alignas( void* ) PSSSubobject {
 public:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mksv/common/types.hpp"
+#include "mksv/graphics/descriptor_heap.hpp"
 #include "mksv/mksv_d3d12.hpp"
 #include "mksv/mksv_win.hpp"
 #include "mksv/mksv_wrl.hpp"
@@ -25,13 +26,15 @@ public:
     static inline constexpr u32 BACK_BUFFER_COUNT = 3;
 
     using BackBuffers = std::array<ComPtr<ID3D12Resource>, Window::BACK_BUFFER_COUNT>;
+    using RenderTargetViews = std::array<Descriptor, Window::BACK_BUFFER_COUNT>;
 
 public:
     static auto create(
         WindowProps                props,
         ComPtr<DXGIFactory>        factory,
         ComPtr<ID3D12CommandQueue> queue,
-        ComPtr<D3D12Device>        device
+        ComPtr<D3D12Device>        device,
+        DescriptorHeap&            rtv_heap
     ) -> std::unique_ptr<Window>;
 
 public:
@@ -53,12 +56,12 @@ public:
 
 private:
     Window(
-        const HWND                   h_wnd,
-        WindowProps                  props,
-        ComPtr<DXGISwapChain>        swapchain,
-        ComPtr<ID3D12DescriptorHeap> descriptor_heap,
-        const u32                    descriptor_size,
-        BackBuffers                  back_buffers
+        const HWND            h_wnd,
+        WindowProps           props,
+        ComPtr<DXGISwapChain> swapchain,
+        DescriptorHeap&       rtv_heap,
+        RenderTargetViews     render_target_views,
+        BackBuffers           back_buffers
     );
 
 private:
@@ -67,9 +70,9 @@ private:
     WindowProps           props_;
     ComPtr<DXGISwapChain> swapchain_;
 
-    ComPtr<ID3D12DescriptorHeap> rtv_descriptor_heap_;
-    u32                          rtv_descriptor_size_;
-    BackBuffers                  back_buffers_;
+    DescriptorHeap*   rtv_heap_;
+    RenderTargetViews render_target_views_;
+    BackBuffers       back_buffers_;
 };
 
 } // namespace mksv
@@ -1,30 +1,36 @@
 #include "mksv/engine.hpp"
 
+#include "mksv/assets/vertex_layout.hpp"
+#include "mksv/assets/vertex_quantization.hpp"
 #include "mksv/common/types.hpp"
+#include "mksv/graphics/vertex.hpp"
 #include "mksv/log.hpp"
 #include "mksv/math/consts.hpp"
+#include "mksv/math/mat.hpp"
+#include "mksv/math/quat.hpp"
 #include "mksv/math/types.hpp"
+#include "mksv/profiler.hpp"
+#include "mksv/raster/raster_scene.hpp"
+#include "mksv/raster/software_rasterizer.hpp"
 #include "mksv/utils/d3d12_helpers.hpp"
 #include "mksv/utils/helpers.hpp"
 #include "mksv/utils/string.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cmath>
-#include <d3dcompiler.h>
+#include <optional>
 #include <ranges>
 
-namespace DX = DirectX;
-
 namespace mksv
 {
-struct Vertex {
-    vec3 pos;
-    vec3 col;
-};
+static_assert( sizeof( Vertex ) == 6 * sizeof( f32 ), "Vertex has to match MeshVertexFormat::PositionColor" );
 
-auto Engine::create() -> std::unique_ptr<Engine>
+auto Engine::create( const u32 frames_in_flight ) -> std::unique_ptr<Engine>
 {
+    MKSV_PROFILE_ZONE( "Engine::create" );
+
     const HINSTANCE h_instance = GetModuleHandleW( nullptr );
     assert( h_instance );
 
@@ -90,7 +96,7 @@ auto Engine::create() -> std::unique_ptr<Engine>
                 break;
         }
 
-        log_info( std::format( L"Supported feature level: {}", feature_level_str ) );
+        log_info( L"Supported feature level: {}", feature_level_str );
     }
 
 #ifdef _DEBUG
@@ -120,6 +126,11 @@ auto Engine::create() -> std::unique_ptr<Engine>
         return nullptr;
     }
 
+    auto descriptor_allocator = DescriptorAllocator::create( d3d12_device, *command_queue );
+    if ( !descriptor_allocator ) {
+        return nullptr;
+    }
+
     auto window_class = WindowClass::create( L"MKSV WindowClass" );
     if ( !window_class ) {
         return nullptr;
@@ -129,7 +140,8 @@ auto Engine::create() -> std::unique_ptr<Engine>
         WindowProps{ .width = 800, .height = 600, .title = L"MKSV Engine", .class_name = window_class->get_name().data() },
         dxgi_factory,
         command_queue->get_ptr(),
-        d3d12_device
+        d3d12_device,
+        descriptor_allocator->get_cpu_heap( D3D12_DESCRIPTOR_HEAP_TYPE_RTV )
     );
 
     if ( !window ) {
@@ -141,29 +153,70 @@ auto Engine::create() -> std::unique_ptr<Engine>
     return std::unique_ptr<Engine>{ new Engine(
         h_instance,
         std::move( window_class ),
+        std::move( descriptor_allocator ),
         std::move( window ),
         dxgi_adapter,
         d3d12_device,
-        std::move( command_queue )
+        std::move( command_queue ),
+        frames_in_flight
     ) };
 }
 
 Engine::Engine( Engine&& other )
     : h_instance_{ other.h_instance_ },
       window_class_{ std::move( other.window_class_ ) },
+      descriptor_allocator_{ std::move( other.descriptor_allocator_ ) },
       window_{ std::move( other.window_ ) },
       keyboard_{ std::move( other.keyboard_ ) },
       adapter_{ std::move( other.adapter_ ) },
       device_{ std::move( other.device_ ) },
       command_queue_{ std::move( other.command_queue_ ) },
-      command_allocator_{ std::move( other.command_allocator_ ) },
-      command_list_{ std::move( other.command_list_ ) },
-      vertex_buffer_{ std::move( other.vertex_buffer_ ) },
+      frame_scheduler_{ std::move( other.frame_scheduler_ ) },
+      recorder_{ std::move( other.recorder_ ) },
+      command_list_pool_{ std::move( other.command_list_pool_ ) },
+      timestamp_queries_{ std::move( other.timestamp_queries_ ) },
+      gpu_profiler_{ std::move( other.gpu_profiler_ ) },
+      upload_queue_{ std::move( other.upload_queue_ ) },
+      uploader_{ std::move( other.uploader_ ) },
+      upload_ring_{ std::move( other.upload_ring_ ) },
+      heap_allocator_{ std::move( other.heap_allocator_ ) },
+      barriers_{ std::move( other.barriers_ ) },
+      frame_graph_{ std::move( other.frame_graph_ ) },
+      shader_archive_{ std::move( other.shader_archive_ ) },
+      mesh_{ std::move( other.mesh_ ) },
+      pipeline_cache_{ std::move( other.pipeline_cache_ ) },
+      vertex_buffer_{ other.vertex_buffer_ },
       vertex_buffer_view_{ other.vertex_buffer_view_ },
-      index_buffer_{ std::move( other.index_buffer_ ) },
+      index_buffer_{ other.index_buffer_ },
       index_buffer_view_{ other.index_buffer_view_ },
       root_signature_{ std::move( other.root_signature_ ) },
-      pipeline_state_{ std::move( other.pipeline_state_ ) }
+      pipeline_state_{ std::move( other.pipeline_state_ ) },
+      angle_{ other.angle_ },
+      eye_{ other.eye_ },
+      focus_{ other.focus_ },
+      jobs_{ std::move( other.jobs_ ) },
+      transforms_{ std::move( other.transforms_ ) },
+      scene_root_{ other.scene_root_ },
+      objects_{ std::move( other.objects_ ) },
+      spinning_{ std::move( other.spinning_ ) },
+      spinning_rotations_{ std::move( other.spinning_rotations_ ) },
+      culler_{ std::move( other.culler_ ) },
+      visible_{ std::move( other.visible_ ) },
+      draw_queue_{ std::move( other.draw_queue_ ) },
+      batcher_{ std::move( other.batcher_ ) },
+      instancing_{ other.instancing_ },
+      mesh_center_{ other.mesh_center_ },
+      mesh_extent_{ other.mesh_extent_ },
+      frame_stats_{ std::move( other.frame_stats_ ) },
+      stats_transform_count_{ other.stats_transform_count_ },
+      stats_visible_count_{ other.stats_visible_count_ },
+      stats_draw_count_{ other.stats_draw_count_ },
+      stats_state_changes_{ other.stats_state_changes_ },
+      stats_unsorted_state_changes_{ other.stats_unsorted_state_changes_ },
+      stats_transform_milliseconds_{ other.stats_transform_milliseconds_ },
+      stats_cull_milliseconds_{ other.stats_cull_milliseconds_ },
+      stats_sort_milliseconds_{ other.stats_sort_milliseconds_ },
+      stats_frame_count_{ other.stats_frame_count_ }
 {
     other.h_instance_ = nullptr;
     other.vertex_buffer_view_ = {};
@@ -178,18 +231,57 @@ auto Engine::operator=( Engine&& other ) -> Engine&
     h_instance_ = other.h_instance_;
     window_class_ = std::move( other.window_class_ );
     window_ = std::move( other.window_ );
+    descriptor_allocator_ = std::move( other.descriptor_allocator_ );
     keyboard_ = std::move( other.keyboard_ );
     adapter_ = std::move( other.adapter_ );
     device_ = std::move( other.device_ );
     command_queue_ = std::move( other.command_queue_ );
-    command_allocator_ = std::move( other.command_allocator_ );
-    command_list_ = std::move( other.command_list_ );
-    vertex_buffer_ = std::move( other.vertex_buffer_ );
+    frame_scheduler_ = std::move( other.frame_scheduler_ );
+    recorder_ = std::move( other.recorder_ );
+    command_list_pool_ = std::move( other.command_list_pool_ );
+    timestamp_queries_ = std::move( other.timestamp_queries_ );
+    gpu_profiler_ = std::move( other.gpu_profiler_ );
+    upload_queue_ = std::move( other.upload_queue_ );
+    uploader_ = std::move( other.uploader_ );
+    upload_ring_ = std::move( other.upload_ring_ );
+    heap_allocator_ = std::move( other.heap_allocator_ );
+    barriers_ = std::move( other.barriers_ );
+    frame_graph_ = std::move( other.frame_graph_ );
+    shader_archive_ = std::move( other.shader_archive_ );
+    mesh_ = std::move( other.mesh_ );
+    pipeline_cache_ = std::move( other.pipeline_cache_ );
+    vertex_buffer_ = other.vertex_buffer_;
     vertex_buffer_view_ = other.vertex_buffer_view_;
-    index_buffer_ = std::move( other.index_buffer_ );
+    index_buffer_ = other.index_buffer_;
     index_buffer_view_ = other.index_buffer_view_;
     root_signature_ = std::move( other.root_signature_ );
     pipeline_state_ = std::move( other.pipeline_state_ );
+    angle_ = other.angle_;
+    eye_ = other.eye_;
+    focus_ = other.focus_;
+    jobs_ = std::move( other.jobs_ );
+    transforms_ = std::move( other.transforms_ );
+    scene_root_ = other.scene_root_;
+    objects_ = std::move( other.objects_ );
+    spinning_ = std::move( other.spinning_ );
+    spinning_rotations_ = std::move( other.spinning_rotations_ );
+    culler_ = std::move( other.culler_ );
+    visible_ = std::move( other.visible_ );
+    draw_queue_ = std::move( other.draw_queue_ );
+    batcher_ = std::move( other.batcher_ );
+    instancing_ = other.instancing_;
+    mesh_center_ = other.mesh_center_;
+    mesh_extent_ = other.mesh_extent_;
+    frame_stats_ = std::move( other.frame_stats_ );
+    stats_transform_count_ = other.stats_transform_count_;
+    stats_visible_count_ = other.stats_visible_count_;
+    stats_draw_count_ = other.stats_draw_count_;
+    stats_state_changes_ = other.stats_state_changes_;
+    stats_unsorted_state_changes_ = other.stats_unsorted_state_changes_;
+    stats_transform_milliseconds_ = other.stats_transform_milliseconds_;
+    stats_cull_milliseconds_ = other.stats_cull_milliseconds_;
+    stats_sort_milliseconds_ = other.stats_sort_milliseconds_;
+    stats_frame_count_ = other.stats_frame_count_;
     other.h_instance_ = nullptr;
     other.vertex_buffer_view_ = {};
 
@@ -204,210 +296,155 @@ Engine::~Engine()
 
 auto Engine::init() -> bool
 {
-    const auto desc = command_queue_->get_ptr()->GetDesc();
-
-    HRESULT hr = device_->CreateCommandAllocator( desc.Type, IID_PPV_ARGS( &command_allocator_ ) );
-
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    MKSV_PROFILE_ZONE( "Engine::init" );
+
+    // Command lists are recorded on the job system's workers, which share the pool's worker indices
+    jobs_ = JobSystem::create();
+    recorder_ = ParallelRecorder::create( jobs_->get_worker_count() + 1 );
+    command_list_pool_ = GraphicsCommandListPool::create(
+        device_,
+        *command_queue_,
+        recorder_->get_worker_count(),
+        frame_scheduler_.get_frames_in_flight()
+    );
+    if ( !command_list_pool_ ) {
         return false;
     }
 
-    hr = device_->CreateCommandList1( 0, desc.Type, D3D12_COMMAND_LIST_FLAG_NONE, IID_PPV_ARGS( &command_list_ ) );
-
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    const u32 frames_in_flight = frame_scheduler_.get_frames_in_flight();
+    timestamp_queries_ =
+        GraphicsTimestampQueryPool::create( device_, *command_queue_, 2 * GPU_ZONES_PER_FRAME * frames_in_flight );
+    if ( !timestamp_queries_ ) {
         return false;
     }
+    gpu_profiler_ = std::make_unique<GpuProfiler>( *timestamp_queries_, frames_in_flight );
 
-    return true;
-}
-
-auto Engine::copy_data() -> bool
-{
-    const vec3 red = { 1.0f, 0.0f, 0.0f };
-    const vec3 yellow = { 1.0f, 1.0f, 0.0f };
-    const vec3 green = { 0.0f, 1.0f, 0.0f };
-    const vec3 cyan = { 0.0f, 1.0f, 1.0f };
-    const vec3 blue = { 0.0f, 0.0f, 1.0f };
-
-    const Vertex vertices[] = {
-        {{ -0.5f, 0.5f, 0.5f },    red   },
-        { { 0.5f, 0.5f, 0.5f },    yellow},
-        { { 0.5f, -0.5f, 0.5f },   blue  },
-        { { -0.5f, -0.5f, 0.5f },  green },
-        { { -0.5f, 0.5f, -0.5f },  cyan  },
-        { { 0.5f, 0.5f, -0.5f },   green },
-        { { 0.5f, -0.5f, -0.5f },  red   },
-        { { -0.5f, -0.5f, -0.5f }, yellow},
-    };
-
-    const u32 indices[] = {
-        0, 2, 1, 2, 0, 3, // front
-        0, 5, 4, 5, 0, 1, // top
-        3, 6, 2, 6, 3, 7, // botttom
-        4, 6, 7, 6, 4, 5, // back
-        0, 7, 3, 7, 0, 4, // left
-        1, 6, 5, 6, 1, 2, // right
-    };
-
-    HRESULT hr = E_FAIL;
-
-    {
-        const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_DEFAULT );
-        const auto res_desc = d3d12::buffer_resource_desc( sizeof( vertices ) );
-
-        hr = device_->CreateCommittedResource(
-            &heap_props,
-            D3D12_HEAP_FLAG_CREATE_NOT_ZEROED,
-            &res_desc,
-            D3D12_RESOURCE_STATE_COPY_DEST,
-            nullptr,
-            IID_PPV_ARGS( &vertex_buffer_ )
-        );
-
-        if ( FAILED( hr ) ) {
-            log_hresult( hr );
-            return false;
-        }
+    // Mesh data is staged and copied into default heap buffers on the copy queue
+    upload_queue_ = GraphicsUploadQueue::create( device_, *command_queue_, UPLOAD_STAGING_CAPACITY );
+    if ( !upload_queue_ ) {
+        return false;
     }
 
-    ComPtr<ID3D12Resource> vertex_upload_buffer{};
-    {
-        const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_UPLOAD );
-        const auto res_desc = d3d12::buffer_resource_desc( sizeof( vertices ) );
-
-        hr = device_->CreateCommittedResource(
-            &heap_props,
-            D3D12_HEAP_FLAG_CREATE_NOT_ZEROED,
-            &res_desc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS( &vertex_upload_buffer )
-        );
+    uploader_ = StreamingUploader::create( *upload_queue_ );
+    if ( !uploader_ ) {
+        return false;
+    }
 
-        if ( FAILED( hr ) ) {
-            log_hresult( hr );
-            return false;
-        }
+    // Per frame instance data is read by the draws straight from the upload heap
+    upload_ring_ = UploadRing::create( device_, *command_queue_, INSTANCE_RING_CAPACITY );
+    if ( !upload_ring_ ) {
+        return false;
     }
 
-    {
-        Vertex* mapped_vertices = nullptr;
-        hr = vertex_upload_buffer->Map( 0, nullptr, reinterpret_cast<void**>( &mapped_vertices ) );
+    heap_allocator_ = HeapAllocator::create( device_, *command_queue_, *upload_queue_ );
+    if ( !heap_allocator_ ) {
+        return false;
+    }
 
-        if ( FAILED( hr ) ) {
-            log_hresult( hr );
-            return false;
-        }
+    frame_graph_ = FrameGraph::create( device_, *command_queue_ );
 
-        std::ranges::copy( vertices, mapped_vertices );
-        vertex_upload_buffer->Unmap( 0, nullptr );
+    shader_archive_ = ShaderArchive::open( SHADER_ARCHIVE_PATH );
+    if ( !shader_archive_ ) {
+        log_error( L"Failed to open the shader archive {}", SHADER_ARCHIVE_PATH );
+        return false;
     }
 
-    {
-        const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_DEFAULT );
-        const auto res_desc = d3d12::buffer_resource_desc( sizeof( indices ) );
-
-        hr = device_->CreateCommittedResource(
-            &heap_props,
-            D3D12_HEAP_FLAG_CREATE_NOT_ZEROED,
-            &res_desc,
-            D3D12_RESOURCE_STATE_COPY_DEST,
-            nullptr,
-            IID_PPV_ARGS( &index_buffer_ )
-        );
+    pipeline_cache_ = PipelineCache::create( device_, adapter_, PIPELINE_CACHE_PATH );
+    if ( !pipeline_cache_ ) {
+        return false;
+    }
 
-        if ( FAILED( hr ) ) {
-            log_hresult( hr );
-            return false;
-        }
+    for ( u32 i = 0; i < Window::BACK_BUFFER_COUNT; ++i ) {
+        barriers_.track( window_->get_back_buffer( i ).Get(), D3D12_RESOURCE_STATE_PRESENT );
     }
 
-    ComPtr<ID3D12Resource> index_upload_buffer{};
-    {
-        const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_UPLOAD );
-        const auto res_desc = d3d12::buffer_resource_desc( sizeof( indices ) );
+    return true;
+}
 
-        hr = device_->CreateCommittedResource(
-            &heap_props,
-            D3D12_HEAP_FLAG_CREATE_NOT_ZEROED,
-            &res_desc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS( &index_upload_buffer )
-        );
-    }
+auto Engine::copy_data() -> bool
+{
+    MKSV_PROFILE_ZONE( "Engine::copy_data" );
 
-    {
-        u32* mapped_indices = nullptr;
-        hr = index_upload_buffer->Map( 0, nullptr, reinterpret_cast<void**>( &mapped_indices ) );
+    HRESULT hr = E_FAIL;
 
-        if ( FAILED( hr ) ) {
-            log_hresult( hr );
-            return false;
-        }
+    const auto mesh_start = std::chrono::steady_clock::now();
 
-        std::ranges::copy( indices, mapped_indices );
-        index_upload_buffer->Unmap( 0, nullptr );
+    mesh_ = MeshFile::open( MESH_PATH );
+    if ( !mesh_ ) {
+        log_error( L"Failed to open the mesh {}", MESH_PATH );
+        return false;
     }
 
-    hr = command_allocator_->Reset();
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    const std::optional<VertexLayout> vertex_layout = get_vertex_layout( mesh_->get_vertex_format() );
+    if ( !vertex_layout || mesh_->get_index_count() == 0 ) {
+        log_error( L"The mesh {} has an unsupported layout", MESH_PATH );
         return false;
     }
 
-    hr = command_list_->Reset( command_allocator_.Get(), nullptr );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    // Uploaded straight from the mapping, the staging copy is the only one
+    const std::span<const u8> vertices = mesh_->get_vertex_data();
+    const std::span<const u8> indices = mesh_->get_index_data();
+
+    // Buffers start out in the common state, the copy queue promotes them for the copies and they decay back
+    // afterwards, so the draws promote them to their read states without any barrier
+    const auto vertex_desc = d3d12::buffer_resource_desc( vertices.size() );
+    const auto index_desc = d3d12::buffer_resource_desc( indices.size() );
+    const auto vertex_allocation = heap_allocator_->allocate( vertex_desc, D3D12_RESOURCE_STATE_COMMON );
+    const auto index_allocation = heap_allocator_->allocate( index_desc, D3D12_RESOURCE_STATE_COMMON );
+    if ( !vertex_allocation || !index_allocation ) {
+        log_error( L"Failed to allocate GPU memory for the mesh" );
         return false;
     }
 
-    command_list_->CopyResource( vertex_buffer_.Get(), vertex_upload_buffer.Get() );
-    const auto vertex_barrier = d3d12::transition_barrier(
-        vertex_buffer_.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER
-    );
-    command_list_->ResourceBarrier( 1, &vertex_barrier );
+    vertex_buffer_ = *vertex_allocation;
+    index_buffer_ = *index_allocation;
 
-    command_list_->CopyResource( index_buffer_.Get(), index_upload_buffer.Get() );
-    const auto index_barrier =
-        d3d12::transition_barrier( index_buffer_.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_INDEX_BUFFER );
-    command_list_->ResourceBarrier( 1, &index_barrier );
-
-    hr = command_list_->Close();
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    const auto vertex_upload =
+        uploader_->request( heap_allocator_->get_resource( vertex_buffer_ ), 0, vertices.data(), vertices.size() );
+    const auto index_upload =
+        uploader_->request( heap_allocator_->get_resource( index_buffer_ ), 0, indices.data(), indices.size() );
+    if ( !vertex_upload || !index_upload ) {
+        log_error( L"Failed to stage the mesh for upload" );
         return false;
     }
 
-    command_queue_->execute( command_list_.Get() );
-    hr = command_queue_->flush();
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    const std::chrono::duration<f64, std::milli> mesh_time = std::chrono::steady_clock::now() - mesh_start;
+    const f64                                    mesh_megabytes =
+        static_cast<f64>( vertices.size() + indices.size() ) / ( 1024.0 * 1024.0 );
+    log_info(
+        L"Loaded and staged {:.2f} MiB of mesh data in {:.3f} ms ({:.1f} MiB/s)",
+        mesh_megabytes,
+        mesh_time.count(),
+        mesh_megabytes / std::max( mesh_time.count() / 1000.0, 1e-9 )
+    );
+
+    // The index upload is the later one, waiting for it covers both
+    if ( !uploader_->wait_on_gpu( *index_upload ) ) {
         return false;
     }
 
-    vertex_buffer_view_ = {
-        .BufferLocation = vertex_buffer_->GetGPUVirtualAddress(),
-        .SizeInBytes = sizeof( vertices ),
-        .StrideInBytes = sizeof( Vertex ),
-    };
+    update_mesh_views();
 
-    index_buffer_view_ = {
-        .BufferLocation = index_buffer_->GetGPUVirtualAddress(),
-        .SizeInBytes = sizeof( indices ),
-        .Format = DXGI_FORMAT_R32_UINT,
+    const MeshBounds& bounds = mesh_->get_bounds();
+    mesh_center_ = {
+        0.5f * ( bounds.min[0] + bounds.max[0] ),
+        0.5f * ( bounds.min[1] + bounds.max[1] ),
+        0.5f * ( bounds.min[2] + bounds.max[2] ),
+    };
+    mesh_extent_ = {
+        0.5f * ( bounds.max[0] - bounds.min[0] ),
+        0.5f * ( bounds.max[1] - bounds.min[1] ),
+        0.5f * ( bounds.max[2] - bounds.min[2] ),
     };
 
-    const D3D12_ROOT_PARAMETER params[1] = {
-        d3d12::create_root_constant( sizeof( mat4 ) / sizeof( u32 ), 0, 0, D3D12_SHADER_VISIBILITY_VERTEX ),
+    // The instance transforms are bound per draw as a root SRV, so that batches need no descriptors of their own
+    const D3D12_ROOT_PARAMETER params[2] = {
+        d3d12::create_root_constant( DRAW_CONSTANT_COUNT, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX ),
+        d3d12::create_root_descriptor( D3D12_ROOT_PARAMETER_TYPE_SRV, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX ),
     };
 
     const D3D12_ROOT_SIGNATURE_DESC root_signature_desc = {
-        .NumParameters = 1,
+        .NumParameters = static_cast<u32>( std::size( params ) ),
         .pParameters = params,
         .NumStaticSamplers = 0,
         .pStaticSamplers = nullptr,
@@ -432,14 +469,9 @@ auto Engine::copy_data() -> bool
         return false;
     }
 
-    hr = device_->CreateRootSignature(
-        0,
-        signature_blob->GetBufferPointer(),
-        signature_blob->GetBufferSize(),
-        IID_PPV_ARGS( &root_signature_ )
-    );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    root_signature_ =
+        pipeline_cache_->create_root_signature( signature_blob->GetBufferPointer(), signature_blob->GetBufferSize() );
+    if ( !root_signature_ ) {
         return false;
     }
 
@@ -452,59 +484,26 @@ auto Engine::copy_data() -> bool
         d3d12::PSSRenderTargetFormats rtv_formats;
     } pss;
 
-    const D3D12_INPUT_ELEMENT_DESC elements_desc[] = {
-        {
-         .SemanticName = "POSITION",
-         .SemanticIndex = 0,
-         .Format = DXGI_FORMAT_R32G32B32_FLOAT,
-         .InputSlot = 0,
-         .AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT,
-         .InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-         .InstanceDataStepRate = 0,
-         },
-        {
-         .SemanticName = "COLOR",
-         .SemanticIndex = 0,
-         .Format = DXGI_FORMAT_R32G32B32_FLOAT,
-         .InputSlot = 0,
-         .AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT,
-         .InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-         .InstanceDataStepRate = 0,
-         },
-    };
-    const D3D12_INPUT_LAYOUT_DESC input_layout = {
-        .pInputElementDescs = elements_desc,
-        .NumElements = static_cast<UINT>( std::size( elements_desc ) ),
-    };
-
-    ComPtr<ID3DBlob> vs_blob;
-    hr = D3DReadFileToBlob( L"vertex_shader.cso", &vs_blob );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
-        return false;
-    }
-    const D3D12_SHADER_BYTECODE vs_bytecode = {
-        .pShaderBytecode = vs_blob->GetBufferPointer(),
-        .BytecodeLength = vs_blob->GetBufferSize(),
+    // Quantized formats arrive as floats as well, the shaders take every layout
+    const std::vector<D3D12_INPUT_ELEMENT_DESC> elements_desc = d3d12::input_elements( *vertex_layout );
+    const D3D12_INPUT_LAYOUT_DESC               input_layout = {
+        .pInputElementDescs = elements_desc.data(),
+        .NumElements = static_cast<UINT>( elements_desc.size() ),
     };
 
-    ComPtr<ID3DBlob> ps_blob;
-    hr = D3DReadFileToBlob( L"pixel_shader.cso", &ps_blob );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    // Views into the mapped archive, which outlives the pipeline
+    const std::span<const u8> vs_bytecode = shader_archive_->find( "vertex_shader" );
+    const std::span<const u8> ps_bytecode = shader_archive_->find( "pixel_shader" );
+    if ( vs_bytecode.empty() || ps_bytecode.empty() ) {
+        log_error( L"The shader archive is missing the cube shaders" );
         return false;
     }
 
-    const D3D12_SHADER_BYTECODE ps_bytecode = {
-        .pShaderBytecode = ps_blob->GetBufferPointer(),
-        .BytecodeLength = ps_blob->GetBufferSize(),
-    };
-
     pss.root_sig = root_signature_.Get();
     pss.input_layout = input_layout;
     pss.primitive_topology = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    pss.vs = vs_bytecode;
-    pss.ps = ps_bytecode;
+    pss.vs = d3d12::shader_bytecode( vs_bytecode );
+    pss.ps = d3d12::shader_bytecode( ps_bytecode );
     pss.rtv_formats = {
         .RTFormats{ DXGI_FORMAT_R8G8B8A8_UNORM },
         .NumRenderTargets = 1,
@@ -514,60 +513,259 @@ auto Engine::copy_data() -> bool
         .SizeInBytes = sizeof( pss ),
         .pPipelineStateSubobjectStream = &pss,
     };
-    hr = device_->CreatePipelineState( &pss_desc, IID_PPV_ARGS( &pipeline_state_ ) );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+
+    const auto pipelines_start = std::chrono::steady_clock::now();
+    pipeline_state_ = pipeline_cache_->get_pipeline_state( pss_desc );
+    if ( !pipeline_state_ ) {
         return false;
     }
 
+    const std::chrono::duration<f64, std::milli> pipelines_time = std::chrono::steady_clock::now() - pipelines_start;
+    log_info(
+        L"Created pipeline states in {:.3f} ms, {} compiled and {} loaded from the cache",
+        pipelines_time.count(),
+        pipeline_cache_->get_compile_count(),
+        pipeline_cache_->get_library_hit_count()
+    );
+
+    if ( !pipeline_cache_->save() ) {
+        log_warning( L"Failed to save the pipeline cache, pipelines will be compiled again on the next run" );
+    }
+
     return true;
 }
 
 auto Engine::update() -> void
 {
-    using namespace std::chrono;
+    MKSV_PROFILE_ZONE( "Engine::update" );
 
-    static auto prev = high_resolution_clock::now();
+    using namespace std::chrono;
 
     const u32   current_index = window_->get_current_back_buffer_index();
     const auto& back_buffer = window_->get_back_buffer( current_index );
 
-    HRESULT hr = command_allocator_->Reset();
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    // Blocks only until the GPU has finished the frame that last used this context
+    const u32 frame_index = frame_scheduler_.begin_frame();
+    if ( !command_list_pool_->begin_frame( frame_index ) ) {
+        end_frame();
         return;
     }
+    gpu_profiler_->begin_frame( frame_index );
 
-    hr = command_list_->Reset( command_allocator_.Get(), nullptr );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+    // CPU time of the frame, without the wait for the frame context above. The GPU time is that of the frame just read
+    // back, frames_in_flight frames older.
+    frame_stats_.begin_frame();
+    frame_stats_.set_gpu_milliseconds( gpu_profiler_->get_frame_milliseconds() );
+
+    recorder_->begin( *command_list_pool_, jobs_.get() );
+
+    D3D12GraphicsCommandList* const command_list = GraphicsCommandListPool::get_list( recorder_->get_list() );
+    if ( !command_list ) {
+        end_frame();
         return;
     }
 
-    {
-        const auto barrier =
-            d3d12::transition_barrier( back_buffer.Get(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET );
+    descriptor_allocator_->retire();
+    frame_graph_->retire();
+
+    // Uploads requested since the last frame go out now, whoever draws with them waits on their ticket
+    if ( !uploader_->flush() ) {
+        log_error( L"Failed to submit the pending uploads" );
+    }
+    uploader_->retire();
+
+    // Compacts the placed resource heaps a little every frame on the copy queue, after the uploads flushed above.
+    // Draws keep using the old buffers until retire() swaps in the ones whose copies have completed.
+    if ( heap_allocator_->retire() > 0 ) {
+        update_mesh_views();
+    }
+    heap_allocator_->defragment( DEFRAGMENT_BYTES_PER_FRAME );
+
+    const f32 dt = static_cast<f32>( frame_stats_.get_delta_seconds() );
+    angle_ += 1.0f * dt;
+    if ( angle_ >= 2.0f * PI ) {
+        angle_ -= 2.0f * PI;
+    }
 
-        command_list_->ResourceBarrier( 1, &barrier );
+    // Spins the spinning objects and culls the objects against the frustum. The visible ones are sorted by state and
+    // depth, then grouped into instanced draws in that order, so that every batch holds its instances front to back.
+    const auto transform_start = high_resolution_clock::now();
+    const quat spin = get_spin();
+    for ( usize i = 0; i < spinning_.size(); ++i ) {
+        transforms_.set_rotation( spinning_[i], spinning_rotations_[i] * spin );
+    }
+    stats_transform_count_ += transforms_.update( jobs_.get() );
+    stats_transform_milliseconds_ +=
+        duration<f64, std::milli>( high_resolution_clock::now() - transform_start ).count();
+
+    const auto cull_start = high_resolution_clock::now();
+    culler_.set_transformed( transforms_, objects_, mesh_center_, mesh_extent_, jobs_.get() );
+    culler_.cull( extract_frustum( get_view_projection() ), CullShape::Box, visible_, jobs_.get() );
+    stats_cull_milliseconds_ += duration<f64, std::milli>( high_resolution_clock::now() - cull_start ).count();
+    stats_visible_count_ += visible_.size();
+    MKSV_PROFILE_COUNTER( "Visible objects", visible_.size() );
+
+    const mat4 view = get_view();
+    draw_queue_.reset();
+    for ( const u32 object : visible_ ) {
+        const vec4& position = transforms_.get_world( objects_[object] ).r[3];
+        const f32   depth = transform_point( { position.x, position.y, position.z }, view ).z;
+        draw_queue_.push(
+            DrawQueue::make_key( DrawLayer::Opaque, CUBE_PIPELINE_ID, CUBE_MATERIAL_ID, CUBE_MESH_ID, depth ),
+            object
+        );
     }
 
-    const auto now = high_resolution_clock::now();
-    const f32  dt = duration_cast<duration<f32>>( now - prev ).count();
-    prev = now;
+    const DrawStateChanges unsorted_changes = DrawQueue::count_state_changes( draw_queue_.get_keys() );
+    const auto             sort_start = high_resolution_clock::now();
+    draw_queue_.sort( jobs_.get() );
+    stats_sort_milliseconds_ += duration<f64, std::milli>( high_resolution_clock::now() - sort_start ).count();
+    const DrawStateChanges changes = DrawQueue::count_state_changes( draw_queue_.get_keys() );
+
+    stats_unsorted_state_changes_ += unsorted_changes.pipeline + unsorted_changes.material + unsorted_changes.mesh;
+    stats_state_changes_ += changes.pipeline + changes.material + changes.mesh;
+
+    batcher_.reset();
+    for ( u32 i = 0; i < draw_queue_.get_count(); ++i ) {
+        const u64 key = draw_queue_.get_keys()[i];
+        batcher_.add(
+            DrawQueue::get_mesh( key ),
+            DrawQueue::get_pipeline( key ),
+            transforms_.get_world( objects_[draw_queue_.get_payloads()[i]] )
+        );
+    }
 
-    static f32 angle = 0.0f;
-    angle += 1.0f * dt;
-    if ( angle >= 2.0f * PI ) {
-        angle -= 2.0f * PI;
+    u32 draw_count = 0;
+    if ( batcher_.build( *upload_ring_ ) ) {
+        draw_count = instancing_ ? static_cast<u32>( batcher_.get_batches().size() ) : batcher_.get_instance_count();
+    } else {
+        log_error( L"Failed to allocate the instance buffer, the objects are not drawn this frame" );
     }
 
-    const f32  r = 0.5f + 0.5f * sin( angle + 1.0f );
-    const f32  g = 0.5f + 0.5f * sin( angle + 3.0f );
-    const f32  b = 0.5f + 0.5f * sin( angle + 6.0f );
-    const f32  clear_color[4] = { r, g, b, 1.0f };
     const auto rtv = window_->get_render_target_view( current_index );
-    command_list_->ClearRenderTargetView( rtv, clear_color, 0, nullptr );
 
+    // The graph has the same shape every frame, so it is only compiled once
+    frame_graph_->reset();
+    const RenderGraphResource target = frame_graph_->import_resource( back_buffer.Get() );
+
+    frame_graph_
+        ->add_pass(
+            "clear",
+            [this, rtv]( D3D12GraphicsCommandList* command_list ) {
+                const auto clear_color = get_clear_color();
+                command_list->ClearRenderTargetView( rtv, clear_color.data(), 0, nullptr );
+            }
+        )
+        .write( target, D3D12_RESOURCE_STATE_RENDER_TARGET );
+
+    frame_graph_
+        ->add_parallel_pass(
+            "cubes",
+            draw_count,
+            [this, rtv]( D3D12GraphicsCommandList* command_list, const DrawChunk chunk ) {
+                if ( instancing_ ) {
+                    draw_batches( command_list, rtv, chunk );
+                } else {
+                    draw_objects( command_list, rtv, chunk );
+                }
+            }
+        )
+        .write( target, D3D12_RESOURCE_STATE_RENDER_TARGET );
+
+    frame_graph_->export_resource( target, D3D12_RESOURCE_STATE_PRESENT );
+
+    // A failed pass leaves null lists in the batch and the back buffer outside the present state, so the open list is
+    // only closed and the frame is neither submitted nor presented
+    if ( !frame_graph_->execute( *recorder_, barriers_, gpu_profiler_.get() ) ) {
+        log_error( L"Failed to execute the frame graph" );
+        static_cast<void>( recorder_->finish() );
+        end_frame();
+        return;
+    }
+
+    gpu_profiler_->end_frame( recorder_->get_list() );
+    if ( !recorder_->finish() ) {
+        log_error( L"Failed to close the frame's command lists" );
+        end_frame();
+        return;
+    }
+
+    command_list_pool_->submit( recorder_->get_batch() );
+    frame_stats_.submit();
+
+    stats_draw_count_ += draw_count;
+    MKSV_PROFILE_COUNTER( "Draws", draw_count );
+    report_frame_stats();
+
+    const HRESULT hr = window_->present( false );
+    frame_stats_.present();
+    end_frame();
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return;
+    }
+}
+
+auto Engine::end_frame() -> void
+{
+    const u64 fence_value = frame_scheduler_.end_frame();
+    heap_allocator_->submit( fence_value );
+    upload_ring_->submit( fence_value );
+    descriptor_allocator_->submit( fence_value );
+    frame_graph_->submit( fence_value );
+    frame_stats_.end_frame();
+
+    // Every frame ends here, the ones cut short as well
+    MKSV_PROFILE_FRAME();
+}
+
+auto Engine::add_object(
+    const vec3&       translation,
+    const quat&       rotation,
+    const vec3&       scale,
+    const TransformId parent
+) -> TransformId
+{
+    const TransformId node =
+        transforms_.create( parent == INVALID_TRANSFORM ? scene_root_ : parent, translation, rotation, scale );
+    objects_.push_back( node );
+    return node;
+}
+
+auto Engine::set_spinning( const TransformId object ) -> void
+{
+    if ( std::ranges::find( spinning_, object ) != spinning_.end() ) {
+        return;
+    }
+
+    spinning_.push_back( object );
+    spinning_rotations_.push_back( transforms_.get_rotation( object ) );
+}
+
+auto Engine::set_camera( const vec3& eye, const vec3& focus ) -> void
+{
+    eye_ = eye;
+    focus_ = focus;
+}
+
+auto Engine::set_instancing( const bool enabled ) -> void
+{
+    instancing_ = enabled;
+}
+
+auto Engine::get_frame_stats() -> FrameStats&
+{
+    return frame_stats_;
+}
+
+auto Engine::get_frame_stats() const -> const FrameStats&
+{
+    return frame_stats_;
+}
+
+auto Engine::record_draw_state( D3D12GraphicsCommandList* command_list, const D3D12_CPU_DESCRIPTOR_HANDLE rtv ) const
+    -> void
+{
     const D3D12_RECT scissor_rect = {
         .left = 0,
         .top = 0,
@@ -584,72 +782,279 @@ auto Engine::update() -> void
         .MaxDepth = D3D12_MAX_DEPTH,
     };
 
-    const vec4 axis = DX::XMVectorSet( 0, 1, 1, 0 );
-    const mat4 rotation = DX::XMMatrixRotationAxis( axis, angle );
-    const vec4 eye_pos = DX::XMVectorSet( 0.0f, 0.0f, -2.0f, 1.0f );
-    const vec4 focus_pos = DX::XMVectorSet( 0.0f, 0.0f, 0.0f, 1.0f );
-    const vec4 up = DX::XMVectorSet( 0.0f, 1.0f, 0.0f, 0.0f );
-    const mat4 view = DX::XMMatrixLookAtLH( eye_pos, focus_pos, up );
-    const f32  aspect_ratio = static_cast<f32>( window_->width() ) / static_cast<f32>( window_->height() );
-    const mat4 projection = DX::XMMatrixPerspectiveFovLH( DX::XMConvertToRadians( 80.0f ), aspect_ratio, 0.1f, 100.0f );
-    const mat4 mvp = DX::XMMatrixTranspose( rotation * view * projection );
+    const mat4 constants[2] = {
+        transpose( get_view_projection() ),
+        transpose( get_position_dequantization() ),
+    };
+
+    command_list->SetPipelineState( pipeline_state_.Get() );
+    command_list->SetGraphicsRootSignature( root_signature_.Get() );
+    command_list->SetGraphicsRoot32BitConstants( 0, DRAW_CONSTANT_COUNT, constants, 0 );
+    command_list->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    command_list->IASetVertexBuffers( 0, 1, &vertex_buffer_view_ );
+    command_list->IASetIndexBuffer( &index_buffer_view_ );
+    command_list->RSSetViewports( 1, &viewport );
+    command_list->RSSetScissorRects( 1, &scissor_rect );
+    command_list->OMSetRenderTargets( 1, &rtv, true, nullptr );
+}
+
+auto Engine::draw_batches(
+    D3D12GraphicsCommandList*         command_list,
+    const D3D12_CPU_DESCRIPTOR_HANDLE rtv,
+    const DrawChunk                   chunk
+) const -> void
+{
+    record_draw_state( command_list, rtv );
 
-    command_list_->SetPipelineState( pipeline_state_.Get() );
-    command_list_->SetGraphicsRootSignature( root_signature_.Get() );
-    command_list_->SetGraphicsRoot32BitConstants( 0, sizeof( mat4 ) / sizeof( u32 ), &mvp, 0 );
-    command_list_->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-    command_list_->IASetVertexBuffers( 0, 1, &vertex_buffer_view_ );
-    command_list_->IASetIndexBuffer( &index_buffer_view_ );
-    command_list_->RSSetViewports( 1, &viewport );
-    command_list_->RSSetScissorRects( 1, &scissor_rect );
-    command_list_->OMSetRenderTargets( 1, &rtv, true, nullptr );
-    command_list_->DrawIndexedInstanced( index_buffer_view_.SizeInBytes / sizeof( u32 ), 1, 0, 0, 0 );
+    // SV_InstanceID starts at 0 for every draw, so each batch binds the instance buffer at its first transform
+    const std::span<const InstanceBatch> batches = batcher_.get_batches().subspan( chunk.first, chunk.count );
+    for ( const InstanceBatch& batch : batches ) {
+        command_list->SetGraphicsRootShaderResourceView( 1, batcher_.get_instance_address( batch ) );
+        command_list->DrawIndexedInstanced( mesh_->get_index_count(), batch.instance_count, 0, 0, 0 );
+    }
+}
 
-    {
-        const auto barrier =
-            d3d12::transition_barrier( back_buffer.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT );
+auto Engine::draw_objects(
+    D3D12GraphicsCommandList*         command_list,
+    const D3D12_CPU_DESCRIPTOR_HANDLE rtv,
+    const DrawChunk                   chunk
+) const -> void
+{
+    record_draw_state( command_list, rtv );
 
-        command_list_->ResourceBarrier( 1, &barrier );
+    // One draw and one root argument change per object, what instancing saves
+    for ( u32 instance = chunk.first; instance < chunk.first + chunk.count; ++instance ) {
+        command_list->SetGraphicsRootShaderResourceView( 1, batcher_.get_instance_address( instance ) );
+        command_list->DrawIndexedInstanced( mesh_->get_index_count(), 1, 0, 0, 0 );
     }
+}
 
-    hr = command_list_->Close();
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
+auto Engine::report_frame_stats() -> void
+{
+    if ( ++stats_frame_count_ < STATS_INTERVAL ) {
         return;
     }
 
-    command_queue_->execute( command_list_.Get() );
+    const FrameStatsSummary frames = frame_stats_.get_summary();
+    log_info(
+        L"{} objects in {} draws per frame ({}), {:.3f} ms CPU per frame",
+        objects_.size(),
+        stats_draw_count_ / stats_frame_count_,
+        instancing_ ? L"instanced" : L"one draw per object",
+        frames.cpu.mean
+    );
+    log_info(
+        L"Frame interval p50/p95/p99 {:.2f}/{:.2f}/{:.2f} ms with {} stutters over the last {} frames",
+        frames.interval.p50,
+        frames.interval.p95,
+        frames.interval.p99,
+        frames.stutter_count,
+        frames.frame_count
+    );
+    log_info(
+        L"GPU p50/p95/p99 {:.2f}/{:.2f}/{:.2f} ms, submit to present p50/p95/p99 {:.2f}/{:.2f}/{:.2f} ms",
+        frames.gpu.p50,
+        frames.gpu.p95,
+        frames.gpu.p99,
+        frames.latency.p50,
+        frames.latency.p95,
+        frames.latency.p99
+    );
+    log_info(
+        L"{} transforms updated in {:.3f} ms per frame",
+        stats_transform_count_ / stats_frame_count_,
+        stats_transform_milliseconds_ / stats_frame_count_
+    );
+    log_info(
+        L"{} of {} objects visible, culled in {:.3f} ms per frame",
+        stats_visible_count_ / stats_frame_count_,
+        objects_.size(),
+        stats_cull_milliseconds_ / stats_frame_count_
+    );
+    log_info(
+        L"Sorted the draws in {:.3f} ms per frame, {} state changes instead of {} in submission order",
+        stats_sort_milliseconds_ / stats_frame_count_,
+        stats_state_changes_ / stats_frame_count_,
+        stats_unsorted_state_changes_ / stats_frame_count_
+    );
+
+    stats_transform_count_ = 0;
+    stats_visible_count_ = 0;
+    stats_draw_count_ = 0;
+    stats_state_changes_ = 0;
+    stats_unsorted_state_changes_ = 0;
+    stats_transform_milliseconds_ = 0.0;
+    stats_cull_milliseconds_ = 0.0;
+    stats_sort_milliseconds_ = 0.0;
+    stats_frame_count_ = 0;
+}
 
-    hr = window_->present( false );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
-        return;
+auto Engine::render_reference( SoftwareRasterizer& rasterizer ) const -> void
+{
+    MKSV_PROFILE_ZONE( "Engine::render_reference" );
+
+    // The rasterizer only takes float vertices and 32 bit indices
+    std::vector<u8>           dequantized;
+    std::span<const u8>       vertices = mesh_->get_vertex_data();
+    const std::span<const u8> indices = mesh_->get_index_data();
+    if ( mesh_->get_vertex_format() != MeshVertexFormat::PositionColor ) {
+        dequantized.resize( u64{ mesh_->get_vertex_count() } * sizeof( Vertex ) );
+        if ( !dequantize_vertices( mesh_->get_vertex_format(), mesh_->get_bounds(), vertices, dequantized ) ) {
+            return;
+        }
+        vertices = dequantized;
     }
 
-    hr = command_queue_->flush();
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
-        return;
+    const std::span<const Vertex> mesh_vertices{
+        reinterpret_cast<const Vertex*>( vertices.data() ),
+        mesh_->get_vertex_count(),
+    };
+    std::vector<RasterVertex> raster_vertices;
+    raster_vertices.reserve( mesh_vertices.size() );
+    for ( const Vertex& vertex : mesh_vertices ) {
+        raster_vertices.push_back( {
+            .position = { vertex.pos.x, vertex.pos.y, vertex.pos.z },
+            .color = { vertex.col.x, vertex.col.y, vertex.col.z },
+        } );
+    }
+
+    std::vector<u32> raster_indices( mesh_->get_index_count() );
+    for ( u32 index = 0; index < raster_indices.size(); ++index ) {
+        raster_indices[index] = mesh_->get_index_size() == sizeof( u16 )
+                                    ? reinterpret_cast<const u16*>( indices.data() )[index]
+                                    : reinterpret_cast<const u32*>( indices.data() )[index];
+    }
+
+    RasterScene scene{
+        .clear_color = get_clear_color(),
+        .meshes = { { .vertices = raster_vertices, .indices = raster_indices } },
+        .draws = {},
+    };
+    scene.draws.reserve( objects_.size() );
+
+    const mat4 view_projection = get_view_projection();
+    for ( const TransformId object : objects_ ) {
+        const mat4   mvp = transforms_.get_world( object ) * view_projection;
+        RasterMatrix raster_mvp{};
+        for ( u32 row = 0; row < 4; ++row ) {
+            raster_mvp[row * 4 + 0] = mvp.r[row].x;
+            raster_mvp[row * 4 + 1] = mvp.r[row].y;
+            raster_mvp[row * 4 + 2] = mvp.r[row].z;
+            raster_mvp[row * 4 + 3] = mvp.r[row].w;
+        }
+        scene.draws.push_back( { .mesh = 0, .mvp = raster_mvp } );
+    }
+
+    rasterizer.render( scene, jobs_.get() );
+}
+
+auto Engine::update_mesh_views() -> void
+{
+    vertex_buffer_view_ = {
+        .BufferLocation = heap_allocator_->get_resource( vertex_buffer_ )->GetGPUVirtualAddress(),
+        .SizeInBytes = static_cast<u32>( mesh_->get_vertex_data().size() ),
+        .StrideInBytes = mesh_->get_vertex_stride(),
+    };
+
+    index_buffer_view_ = {
+        .BufferLocation = heap_allocator_->get_resource( index_buffer_ )->GetGPUVirtualAddress(),
+        .SizeInBytes = static_cast<u32>( mesh_->get_index_data().size() ),
+        .Format = mesh_->get_index_size() == sizeof( u16 ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT,
+    };
+}
+
+auto Engine::get_clear_color() const -> std::array<f32, 4>
+{
+    const f32 r = 0.5f + 0.5f * sin( angle_ + 1.0f );
+    const f32 g = 0.5f + 0.5f * sin( angle_ + 3.0f );
+    const f32 b = 0.5f + 0.5f * sin( angle_ + 6.0f );
+
+    return { r, g, b, 1.0f };
+}
+
+auto Engine::get_spin() const -> quat
+{
+    const vec3 axis = { 0.0f, 1.0f, 1.0f };
+    return quat_from_axis_angle( axis, angle_ );
+}
+
+auto Engine::get_view() const -> mat4
+{
+    const vec3 up = { 0.0f, 1.0f, 0.0f };
+    return look_at_lh( eye_, focus_, up );
+}
+
+auto Engine::get_view_projection() const -> mat4
+{
+    const f32  aspect_ratio = static_cast<f32>( window_->width() ) / static_cast<f32>( window_->height() );
+    const mat4 projection = perspective_fov_lh( to_radians( 80.0f ), aspect_ratio, 0.1f, 1000.0f );
+
+    return get_view() * projection;
+}
+
+auto Engine::get_position_dequantization() const -> mat4
+{
+    const std::optional<VertexLayout> vertex_layout = get_vertex_layout( mesh_->get_vertex_format() );
+    if ( !vertex_layout || vertex_layout->position != PositionEncoding::Snorm16 ) {
+        return mat4_identity();
     }
+
+    // Snorm16 positions are relative to the center of the bounds in units of their half extent
+    const MeshBounds& bounds = mesh_->get_bounds();
+    const vec3        half_extent = {
+        0.5f * ( bounds.max[0] - bounds.min[0] ),
+        0.5f * ( bounds.max[1] - bounds.min[1] ),
+        0.5f * ( bounds.max[2] - bounds.min[2] ),
+    };
+    const vec3 center = {
+        0.5f * ( bounds.min[0] + bounds.max[0] ),
+        0.5f * ( bounds.min[1] + bounds.max[1] ),
+        0.5f * ( bounds.min[2] + bounds.max[2] ),
+    };
+
+    return scaling( half_extent ) * translation( center );
 }
 
 Engine::Engine(
-    const HINSTANCE               h_instance,
-    std::unique_ptr<WindowClass>  window_class,
-    std::unique_ptr<Window>       window,
-    ComPtr<DXGIAdapter>           adapter,
-    ComPtr<D3D12Device>           device,
-    std::unique_ptr<CommandQueue> command_queue
+    const HINSTANCE                      h_instance,
+    std::unique_ptr<WindowClass>         window_class,
+    std::unique_ptr<DescriptorAllocator> descriptor_allocator,
+    std::unique_ptr<Window>              window,
+    ComPtr<DXGIAdapter>                  adapter,
+    ComPtr<D3D12Device>                  device,
+    std::unique_ptr<CommandQueue>        command_queue,
+    const u32                            frames_in_flight
 )
     : h_instance_{ h_instance },
       window_class_{ std::move( window_class ) },
+      descriptor_allocator_{ std::move( descriptor_allocator ) },
       window_{ std::move( window ) },
       adapter_{ std::move( adapter ) },
       device_{ std::move( device ) },
       command_queue_{ std::move( command_queue ) },
-      vertex_buffer_{ nullptr }
+      frame_scheduler_{ *command_queue_, std::max( 1u, frames_in_flight ) },
+      vertex_buffer_{ HeapAllocator::INVALID_ALLOCATION },
+      index_buffer_{ HeapAllocator::INVALID_ALLOCATION },
+      angle_{ 0.0f },
+      eye_{ 0.0f, 0.0f, -2.0f },
+      focus_{ 0.0f, 0.0f, 0.0f },
+      scene_root_{ INVALID_TRANSFORM },
+      instancing_{ true },
+      mesh_center_{ 0.0f, 0.0f, 0.0f },
+      mesh_extent_{ 0.0f, 0.0f, 0.0f },
+      frame_stats_{},
+      stats_transform_count_{ 0 },
+      stats_visible_count_{ 0 },
+      stats_draw_count_{ 0 },
+      stats_state_changes_{ 0 },
+      stats_unsorted_state_changes_{ 0 },
+      stats_transform_milliseconds_{ 0.0 },
+      stats_cull_milliseconds_{ 0.0 },
+      stats_sort_milliseconds_{ 0.0 },
+      stats_frame_count_{ 0 }
 {
     assert( instance_count == 0 && "Only 1 engine instance can exist at a time" );
+    scene_root_ = transforms_.create( INVALID_TRANSFORM, { 0.0f, 0.0f, 0.0f }, quat_identity(), { 1.0f, 1.0f, 1.0f } );
     const LONG_PTR result = SetWindowLongPtrW( window_->handle(), GWLP_USERDATA, reinterpret_cast<LONG_PTR>( this ) );
     if ( result != 0 ) {
         log_last_window_error();
@@ -0,0 +1,271 @@
+#include "mksv/frame_stats.hpp"
+
+#include "mksv/log.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace mksv
+{
+namespace
+{
+// In the order of the metrics, used for the CSV columns and JSON keys
+constexpr std::array<const char*, 4> METRIC_NAMES = { "interval", "cpu", "latency", "gpu" };
+} // namespace
+
+FrameStats::FrameStats()
+    : histograms_{},
+      window_( WINDOW_SIZE ),
+      window_next_{ 0 },
+      stutter_count_{ 0 },
+      total_frame_count_{ 0 },
+      total_stutter_count_{ 0 },
+      pending_{},
+      in_frame_{ false },
+      begin_time_{},
+      submit_time_{},
+      delta_seconds_{ 0.0 },
+      dump_interval_{ 0 },
+      dump_csv_path_{},
+      dump_json_path_{}
+{
+    static_assert( METRIC_NAMES.size() == METRIC_COUNT );
+}
+
+auto FrameStats::begin_frame() -> void
+{
+    begin_frame( std::chrono::steady_clock::now() );
+}
+
+auto FrameStats::submit() -> void
+{
+    submit( std::chrono::steady_clock::now() );
+}
+
+auto FrameStats::present() -> void
+{
+    present( std::chrono::steady_clock::now() );
+}
+
+auto FrameStats::begin_frame( const std::chrono::steady_clock::time_point now ) -> void
+{
+    pending_.microseconds.fill( NO_VALUE );
+    pending_.stutter = false;
+    if ( begin_time_ != std::chrono::steady_clock::time_point{} ) {
+        const auto interval = now - begin_time_;
+        pending_.microseconds[METRIC_INTERVAL] = to_microseconds( interval );
+        delta_seconds_ = std::chrono::duration<f64>( interval ).count();
+    }
+
+    begin_time_ = now;
+    in_frame_ = true;
+}
+
+auto FrameStats::submit( const std::chrono::steady_clock::time_point now ) -> void
+{
+    if ( !in_frame_ ) {
+        return;
+    }
+
+    submit_time_ = now;
+    pending_.microseconds[METRIC_CPU] = to_microseconds( submit_time_ - begin_time_ );
+}
+
+auto FrameStats::present( const std::chrono::steady_clock::time_point now ) -> void
+{
+    if ( !in_frame_ || pending_.microseconds[METRIC_CPU] == NO_VALUE ) {
+        return;
+    }
+
+    pending_.microseconds[METRIC_LATENCY] = to_microseconds( now - submit_time_ );
+}
+
+auto FrameStats::set_gpu_milliseconds( const f64 milliseconds ) -> void
+{
+    if ( !in_frame_ || milliseconds <= 0.0 ) {
+        return;
+    }
+
+    pending_.microseconds[METRIC_GPU] = to_microseconds(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<f64, std::milli>( milliseconds )
+        )
+    );
+}
+
+auto FrameStats::end_frame() -> void
+{
+    if ( !in_frame_ ) {
+        return;
+    }
+    in_frame_ = false;
+
+    // Against the window before the frame, which a single long frame cannot drag along
+    const LatencyHistogram& intervals = histograms_[METRIC_INTERVAL];
+    const u32               interval = pending_.microseconds[METRIC_INTERVAL];
+    if ( interval != NO_VALUE && intervals.get_count() >= STUTTER_MIN_FRAMES ) {
+        pending_.stutter = static_cast<f64>( interval ) > STUTTER_FACTOR * intervals.get_percentile( 50.0 );
+    }
+
+    Sample& slot = window_[window_next_];
+    if ( total_frame_count_ >= WINDOW_SIZE ) {
+        for ( u32 metric = 0; metric < METRIC_COUNT; ++metric ) {
+            if ( slot.microseconds[metric] != NO_VALUE ) {
+                histograms_[metric].remove( slot.microseconds[metric] );
+            }
+        }
+        stutter_count_ -= slot.stutter ? 1 : 0;
+    }
+
+    for ( u32 metric = 0; metric < METRIC_COUNT; ++metric ) {
+        if ( pending_.microseconds[metric] != NO_VALUE ) {
+            histograms_[metric].add( pending_.microseconds[metric] );
+        }
+    }
+    if ( pending_.stutter ) {
+        ++stutter_count_;
+        ++total_stutter_count_;
+    }
+
+    slot = pending_;
+    window_next_ = ( window_next_ + 1 ) % WINDOW_SIZE;
+    ++total_frame_count_;
+
+    if ( dump_interval_ > 0 && total_frame_count_ % dump_interval_ == 0 ) {
+        dump();
+    }
+}
+
+auto FrameStats::get_delta_seconds() const -> f64
+{
+    return delta_seconds_;
+}
+
+auto FrameStats::get_summary() const -> FrameStatsSummary
+{
+    return {
+        .interval = summarize( METRIC_INTERVAL ),
+        .cpu = summarize( METRIC_CPU ),
+        .latency = summarize( METRIC_LATENCY ),
+        .gpu = summarize( METRIC_GPU ),
+        .frame_count = static_cast<u32>( std::min<u64>( total_frame_count_, WINDOW_SIZE ) ),
+        .stutter_count = stutter_count_,
+        .total_frame_count = total_frame_count_,
+        .total_stutter_count = total_stutter_count_,
+    };
+}
+
+auto FrameStats::set_dumps( const u32 interval, std::filesystem::path csv_path, std::filesystem::path json_path )
+    -> void
+{
+    dump_interval_ = interval;
+    dump_csv_path_ = std::move( csv_path );
+    dump_json_path_ = std::move( json_path );
+}
+
+auto FrameStats::append_csv( const std::filesystem::path& path ) const -> bool
+{
+    std::error_code error;
+    const auto      size = std::filesystem::file_size( path, error );
+    const bool      write_header = error || size == 0;
+
+    std::ofstream file{ path, std::ios::binary | std::ios::app };
+    if ( !file ) {
+        log_error( L"Failed to open {} for the frame statistics", path.wstring() );
+        return false;
+    }
+
+    std::string csv;
+    if ( write_header ) {
+        csv += "frame,window_frames";
+        for ( const char* name : METRIC_NAMES ) {
+            csv += std::format( ",{0}_mean_ms,{0}_p50_ms,{0}_p95_ms,{0}_p99_ms", name );
+        }
+        csv += ",stutters,total_stutters\n";
+    }
+
+    const FrameStatsSummary summary = get_summary();
+    csv += std::format( "{},{}", summary.total_frame_count, summary.frame_count );
+    for ( u32 metric = 0; metric < METRIC_COUNT; ++metric ) {
+        const FrameTimeSummary times = summarize( static_cast<Metric>( metric ) );
+        csv += std::format( ",{:.3f},{:.3f},{:.3f},{:.3f}", times.mean, times.p50, times.p95, times.p99 );
+    }
+    csv += std::format( ",{},{}\n", summary.stutter_count, summary.total_stutter_count );
+
+    file.write( csv.data(), static_cast<std::streamsize>( csv.size() ) );
+    if ( !file ) {
+        log_error( L"Failed to write the frame statistics {}", path.wstring() );
+        return false;
+    }
+    return true;
+}
+
+auto FrameStats::write_json( const std::filesystem::path& path ) const -> bool
+{
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    if ( !file ) {
+        log_error( L"Failed to open {} for the frame statistics", path.wstring() );
+        return false;
+    }
+
+    const FrameStatsSummary summary = get_summary();
+    std::string             json = std::format(
+        "{{\"frame\":{},\"window_frames\":{},\"stutters\":{},\"total_stutters\":{}",
+        summary.total_frame_count,
+        summary.frame_count,
+        summary.stutter_count,
+        summary.total_stutter_count
+    );
+    for ( u32 metric = 0; metric < METRIC_COUNT; ++metric ) {
+        const FrameTimeSummary times = summarize( static_cast<Metric>( metric ) );
+        json += std::format(
+            ",\"{}\":{{\"mean_ms\":{:.3f},\"p50_ms\":{:.3f},\"p95_ms\":{:.3f},\"p99_ms\":{:.3f}}}",
+            METRIC_NAMES[metric],
+            times.mean,
+            times.p50,
+            times.p95,
+            times.p99
+        );
+    }
+    json += "}\n";
+
+    file.write( json.data(), static_cast<std::streamsize>( json.size() ) );
+    if ( !file ) {
+        log_error( L"Failed to write the frame statistics {}", path.wstring() );
+        return false;
+    }
+    return true;
+}
+
+auto FrameStats::to_microseconds( const std::chrono::steady_clock::duration duration ) -> u32
+{
+    const i64 microseconds = std::chrono::duration_cast<std::chrono::microseconds>( duration ).count();
+    return static_cast<u32>( std::clamp<i64>( microseconds, 0, LatencyHistogram::MAX_VALUE ) );
+}
+
+auto FrameStats::summarize( const Metric metric ) const -> FrameTimeSummary
+{
+    const LatencyHistogram& histogram = histograms_[metric];
+    return {
+        .mean = histogram.get_mean() / 1000.0,
+        .p50 = histogram.get_percentile( 50.0 ) / 1000.0,
+        .p95 = histogram.get_percentile( 95.0 ) / 1000.0,
+        .p99 = histogram.get_percentile( 99.0 ) / 1000.0,
+    };
+}
+
+auto FrameStats::dump() const -> void
+{
+    if ( !dump_csv_path_.empty() ) {
+        append_csv( dump_csv_path_ );
+    }
+    if ( !dump_json_path_.empty() ) {
+        write_json( dump_json_path_ );
+    }
+}
+
+} // namespace mksv
@@ -0,0 +1,95 @@
+#include "mksv/graphics/barrier_recorder.hpp"
+
+#include "mksv/utils/d3d12_helpers.hpp"
+
+namespace mksv
+{
+
+BarrierRecorder::BarrierRecorder()
+    : tracker_{ static_cast<u32>( READ_ONLY_STATES ) }
+{
+}
+
+auto BarrierRecorder::track(
+    ID3D12Resource*             resource,
+    const D3D12_RESOURCE_STATES initial_state,
+    const u32                   subresource_count
+) -> void
+{
+    tracker_.track( resource, static_cast<u32>( initial_state ), subresource_count );
+}
+
+auto BarrierRecorder::untrack( ID3D12Resource* resource ) -> void
+{
+    tracker_.untrack( resource );
+}
+
+auto BarrierRecorder::transition(
+    ID3D12Resource*             resource,
+    const D3D12_RESOURCE_STATES state,
+    const u32                   subresource
+) -> void
+{
+    tracker_.require( resource, static_cast<u32>( state ), subresource );
+}
+
+auto BarrierRecorder::prepare(
+    ID3D12Resource*             resource,
+    const D3D12_RESOURCE_STATES state,
+    const u32                   subresource
+) -> void
+{
+    tracker_.prepare( resource, static_cast<u32>( state ), subresource );
+}
+
+auto BarrierRecorder::alias( ID3D12Resource* before, ID3D12Resource* after ) -> void
+{
+    aliasing_.push_back( d3d12::aliasing_barrier( before, after ) );
+}
+
+auto BarrierRecorder::uav( ID3D12Resource* resource ) -> void
+{
+    uav_.push_back( d3d12::uav_barrier( resource ) );
+}
+
+auto BarrierRecorder::flush( D3D12GraphicsCommandList* command_list ) -> u32
+{
+    transitions_.clear();
+    if ( tracker_.flush( transitions_ ) == 0 && aliasing_.empty() && uav_.empty() ) {
+        return 0;
+    }
+
+    // The memory has to belong to the new resource before it can be transitioned
+    barriers_.assign( aliasing_.begin(), aliasing_.end() );
+    aliasing_.clear();
+
+    for ( const ResourceTransition& transition : transitions_ ) {
+        D3D12_RESOURCE_BARRIER barrier = d3d12::transition_barrier(
+            static_cast<ID3D12Resource*>( const_cast<void*>( transition.resource ) ),
+            static_cast<D3D12_RESOURCE_STATES>( transition.before ),
+            static_cast<D3D12_RESOURCE_STATES>( transition.after )
+        );
+
+        barrier.Transition.Subresource = transition.subresource;
+        if ( transition.phase == BarrierPhase::Begin ) {
+            barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+        } else if ( transition.phase == BarrierPhase::End ) {
+            barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+        }
+
+        barriers_.push_back( barrier );
+    }
+
+    barriers_.insert( barriers_.end(), uav_.begin(), uav_.end() );
+    uav_.clear();
+
+    command_list->ResourceBarrier( static_cast<UINT>( barriers_.size() ), barriers_.data() );
+    return static_cast<u32>( barriers_.size() );
+}
+
+auto BarrierRecorder::get_state( ID3D12Resource* resource, const u32 subresource ) const -> D3D12_RESOURCE_STATES
+{
+    return static_cast<D3D12_RESOURCE_STATES>( tracker_.get_state( resource, subresource ) );
+}
+
+} // namespace mksv
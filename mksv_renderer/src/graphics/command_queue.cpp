@@ -63,7 +63,16 @@ auto CommandQueue::get_ptr() const -> ComPtr<ID3D12CommandQueue>
 
 auto CommandQueue::execute( ID3D12CommandList* const command_list ) -> void
 {
-    queue_->ExecuteCommandLists( 1, &command_list );
+    execute( std::span{ &command_list, 1 } );
+}
+
+auto CommandQueue::execute( const std::span<ID3D12CommandList* const> command_lists ) -> void
+{
+    if ( command_lists.empty() ) {
+        return;
+    }
+
+    queue_->ExecuteCommandLists( static_cast<UINT>( command_lists.size() ), command_lists.data() );
 }
 
 auto CommandQueue::signal() -> u64
@@ -73,6 +82,22 @@ auto CommandQueue::signal() -> u64
     return fence_value_;
 }
 
+auto CommandQueue::get_completed_value() const -> u64
+{
+    return fence_->GetCompletedValue();
+}
+
+auto CommandQueue::wait_for_value( const u64 value ) -> bool
+{
+    const HRESULT hr = wait_for_fence_value( value );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return false;
+    }
+
+    return true;
+}
+
 auto CommandQueue::is_fence_complete( const u64 fence_value ) const -> bool
 {
     return fence_->GetCompletedValue() >= fence_value;
@@ -102,4 +127,12 @@ auto CommandQueue::flush() -> HRESULT
     return wait_for_fence_value( signal() );
 }
 
+auto CommandQueue::wait_on_gpu( const CommandQueue& producer, const u64 fence_value ) -> void
+{
+    const HRESULT hr = queue_->Wait( producer.fence_.Get(), fence_value );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+    }
+}
+
 } // namespace mksv
@@ -0,0 +1,127 @@
+#include "mksv/graphics/descriptor_allocator.hpp"
+
+#include "mksv/log.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace mksv
+{
+
+auto DescriptorAllocator::create( ComPtr<D3D12Device> device, Fence& fence ) -> std::unique_ptr<DescriptorAllocator>
+{
+    static constexpr u32 CPU_CAPACITIES[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES] = {
+        CBV_SRV_UAV_CAPACITY,
+        SAMPLER_CAPACITY,
+        RTV_CAPACITY,
+        DSV_CAPACITY,
+    };
+
+    CpuHeaps cpu_heaps{};
+    for ( u32 type = 0; type < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; ++type ) {
+        cpu_heaps[type] =
+            DescriptorHeap::create( device, fence, static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>( type ), CPU_CAPACITIES[type] );
+
+        if ( !cpu_heaps[type] ) {
+            return nullptr;
+        }
+    }
+
+    auto resource_heap = DescriptorHeap::create(
+        device,
+        fence,
+        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+        SHADER_VISIBLE_CBV_SRV_UAV_CAPACITY,
+        DYNAMIC_CBV_SRV_UAV_CAPACITY
+    );
+
+    if ( !resource_heap ) {
+        return nullptr;
+    }
+
+    auto sampler_heap = DescriptorHeap::create(
+        device,
+        fence,
+        D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER,
+        SHADER_VISIBLE_SAMPLER_CAPACITY,
+        DYNAMIC_SAMPLER_CAPACITY
+    );
+
+    if ( !sampler_heap ) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<DescriptorAllocator>{ new DescriptorAllocator(
+        std::move( device ),
+        std::move( cpu_heaps ),
+        std::move( resource_heap ),
+        std::move( sampler_heap )
+    ) };
+}
+
+DescriptorAllocator::DescriptorAllocator(
+    ComPtr<D3D12Device>             device,
+    CpuHeaps                        cpu_heaps,
+    std::unique_ptr<DescriptorHeap> resource_heap,
+    std::unique_ptr<DescriptorHeap> sampler_heap
+)
+    : device_{ std::move( device ) },
+      cpu_heaps_{ std::move( cpu_heaps ) },
+      resource_heap_{ std::move( resource_heap ) },
+      sampler_heap_{ std::move( sampler_heap ) }
+{
+}
+
+auto DescriptorAllocator::get_cpu_heap( const D3D12_DESCRIPTOR_HEAP_TYPE type ) -> DescriptorHeap&
+{
+    assert( type < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES );
+    return *cpu_heaps_[type];
+}
+
+auto DescriptorAllocator::get_shader_visible_heap( const D3D12_DESCRIPTOR_HEAP_TYPE type ) -> DescriptorHeap&
+{
+    assert( type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV || type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER );
+    return type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER ? *sampler_heap_ : *resource_heap_;
+}
+
+auto DescriptorAllocator::set_shader_visible_heaps( D3D12GraphicsCommandList* command_list ) const -> void
+{
+    ID3D12DescriptorHeap* const heaps[] = { resource_heap_->get_ptr(), sampler_heap_->get_ptr() };
+    command_list->SetDescriptorHeaps( static_cast<UINT>( std::size( heaps ) ), heaps );
+}
+
+auto DescriptorAllocator::stage(
+    const D3D12_DESCRIPTOR_HEAP_TYPE  type,
+    const D3D12_CPU_DESCRIPTOR_HANDLE source,
+    const u32                         count
+) -> std::optional<DescriptorRange>
+{
+    auto range = get_shader_visible_heap( type ).allocate_dynamic( count );
+    if ( range ) {
+        device_->CopyDescriptorsSimple( count, range->cpu, source, type );
+    }
+
+    return range;
+}
+
+auto DescriptorAllocator::submit( const u64 fence_value ) -> void
+{
+    for ( const auto& heap : cpu_heaps_ ) {
+        heap->submit( fence_value );
+    }
+
+    resource_heap_->submit( fence_value );
+    sampler_heap_->submit( fence_value );
+}
+
+auto DescriptorAllocator::retire() -> void
+{
+    for ( const auto& heap : cpu_heaps_ ) {
+        heap->retire();
+    }
+
+    resource_heap_->retire();
+    sampler_heap_->retire();
+}
+
+} // namespace mksv
@@ -0,0 +1,192 @@
+#include "mksv/graphics/descriptor_heap.hpp"
+
+#include "mksv/log.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace mksv
+{
+
+auto DescriptorHeap::create(
+    ComPtr<D3D12Device>              device,
+    Fence&                           fence,
+    const D3D12_DESCRIPTOR_HEAP_TYPE type,
+    const u32                        persistent_capacity,
+    const u32                        dynamic_capacity
+) -> std::unique_ptr<DescriptorHeap>
+{
+    const bool shader_visible =
+        type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV || type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
+
+    if ( dynamic_capacity > 0 && !shader_visible ) {
+        log_error( L"Only CBV_SRV_UAV and SAMPLER descriptor heaps can have a dynamic region" );
+        return nullptr;
+    }
+
+    // Shader visible memory is write-combined and slow to read back, so staging heaps of the same types stay CPU only
+    const D3D12_DESCRIPTOR_HEAP_DESC desc = {
+        .Type = type,
+        .NumDescriptors = persistent_capacity + dynamic_capacity,
+        .Flags = dynamic_capacity > 0 ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+        .NodeMask = 0,
+    };
+
+    ComPtr<ID3D12DescriptorHeap> heap{};
+    const HRESULT                hr = device->CreateDescriptorHeap( &desc, IID_PPV_ARGS( &heap ) );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    const u32 descriptor_size = device->GetDescriptorHandleIncrementSize( type );
+
+    return std::unique_ptr<DescriptorHeap>{
+        new DescriptorHeap( fence, std::move( heap ), type, descriptor_size, persistent_capacity, dynamic_capacity )
+    };
+}
+
+DescriptorHeap::DescriptorHeap(
+    Fence&                           fence,
+    ComPtr<ID3D12DescriptorHeap>     heap,
+    const D3D12_DESCRIPTOR_HEAP_TYPE type,
+    const u32                        descriptor_size,
+    const u32                        persistent_capacity,
+    const u32                        dynamic_capacity
+)
+    : fence_{ &fence },
+      heap_{ std::move( heap ) },
+      type_{ type },
+      descriptor_size_{ descriptor_size },
+      cpu_start_{ heap_->GetCPUDescriptorHandleForHeapStart() },
+      gpu_start_{},
+      persistent_capacity_{ persistent_capacity },
+      free_list_{ persistent_capacity, true },
+      pending_frees_{ persistent_capacity, false }
+{
+    if ( dynamic_capacity > 0 ) {
+        gpu_start_ = heap_->GetGPUDescriptorHandleForHeapStart();
+        dynamic_.emplace( dynamic_capacity );
+    }
+}
+
+auto DescriptorHeap::allocate() -> std::optional<Descriptor>
+{
+    const auto index = free_list_.pop();
+    if ( !index ) {
+        log_error( L"Descriptor heap is out of persistent descriptors" );
+        return std::nullopt;
+    }
+
+    return Descriptor{
+        .cpu = get_cpu_handle( *index ),
+        .gpu = get_gpu_handle( *index ),
+        .index = *index,
+    };
+}
+
+auto DescriptorHeap::free( const Descriptor& descriptor ) -> void
+{
+    assert( descriptor.index < persistent_capacity_ );
+
+    if ( is_shader_visible() ) {
+        pending_frees_.push( descriptor.index );
+    } else {
+        free_list_.push( descriptor.index );
+    }
+}
+
+auto DescriptorHeap::allocate_dynamic( const u32 count ) -> std::optional<DescriptorRange>
+{
+    assert( dynamic_ && "Dynamic descriptors need a heap created with a dynamic region" );
+
+    const auto offset = dynamic_->allocate( count, 1 );
+    if ( !offset ) {
+        log_error( L"Descriptor heap is out of dynamic descriptors for this frame" );
+        return std::nullopt;
+    }
+
+    const u32 first = persistent_capacity_ + static_cast<u32>( *offset );
+
+    return DescriptorRange{
+        .cpu = get_cpu_handle( first ),
+        .gpu = get_gpu_handle( first ),
+        .first = first,
+        .count = count,
+        .descriptor_size = descriptor_size_,
+    };
+}
+
+auto DescriptorHeap::submit( const u64 fence_value ) -> void
+{
+    if ( dynamic_ ) {
+        dynamic_->close_batch( fence_value );
+    }
+
+    const u32 first = pending_frees_.take_all();
+    if ( first != IndexFreeList::INVALID_INDEX ) {
+        batches_.push_back( { fence_value, first } );
+    }
+}
+
+auto DescriptorHeap::retire() -> void
+{
+    const u64 completed = fence_->get_completed_value();
+
+    if ( dynamic_ ) {
+        dynamic_->retire( completed );
+    }
+
+    while ( !batches_.empty() && batches_.front().fence_value <= completed ) {
+        u32 index = batches_.front().first;
+        while ( index != IndexFreeList::INVALID_INDEX ) {
+            const u32 next = pending_frees_.get_next( index );
+            free_list_.push( index );
+            index = next;
+        }
+
+        batches_.pop_front();
+    }
+}
+
+auto DescriptorHeap::get_ptr() const -> ID3D12DescriptorHeap*
+{
+    return heap_.Get();
+}
+
+auto DescriptorHeap::get_type() const -> D3D12_DESCRIPTOR_HEAP_TYPE
+{
+    return type_;
+}
+
+auto DescriptorHeap::get_descriptor_size() const -> u32
+{
+    return descriptor_size_;
+}
+
+auto DescriptorHeap::get_cpu_handle( const u32 index ) const -> D3D12_CPU_DESCRIPTOR_HANDLE
+{
+    return { cpu_start_.ptr + static_cast<SIZE_T>( index ) * descriptor_size_ };
+}
+
+auto DescriptorHeap::get_gpu_handle( const u32 index ) const -> D3D12_GPU_DESCRIPTOR_HANDLE
+{
+    if ( !is_shader_visible() ) {
+        return { 0 };
+    }
+
+    return { gpu_start_.ptr + static_cast<u64>( index ) * descriptor_size_ };
+}
+
+auto DescriptorHeap::is_shader_visible() const -> bool
+{
+    return dynamic_.has_value();
+}
+
+auto DescriptorHeap::get_persistent_free_count() const -> u32
+{
+    return free_list_.get_size();
+}
+
+} // namespace mksv
@@ -0,0 +1,130 @@
+#include "mksv/graphics/draw_queue.hpp"
+
+#include "mksv/jobs/radix_sort.hpp"
+#include "mksv/profiler.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 MESH_SHIFT = 0;
+constexpr u32 MATERIAL_SHIFT = MESH_SHIFT + DrawQueue::MESH_BITS;
+constexpr u32 PIPELINE_SHIFT = MATERIAL_SHIFT + DrawQueue::MATERIAL_BITS;
+constexpr u32 STATE_BITS = DrawQueue::PIPELINE_BITS + DrawQueue::MATERIAL_BITS + DrawQueue::MESH_BITS;
+constexpr u32 LAYER_SHIFT = 63;
+
+constexpr auto mask( const u32 bits ) -> u64
+{
+    return ( u64{ 1 } << bits ) - 1;
+}
+
+// Non-negative floats order like their bits, the top DEPTH_BITS of the 31 that are left without the sign
+auto quantize_depth( const f32 depth ) -> u64
+{
+    const f32 clamped = depth > 0.0f ? depth : 0.0f;
+    return std::bit_cast<u32>( clamped ) >> ( 31 - DrawQueue::DEPTH_BITS );
+}
+
+// Where the state fields start, below the depth for opaque draws and at the bottom for transparent ones
+auto get_state_shift( const u64 key ) -> u32
+{
+    return DrawQueue::get_layer( key ) == DrawLayer::Opaque ? DrawQueue::DEPTH_BITS : 0;
+}
+} // namespace
+
+auto DrawQueue::make_key(
+    const DrawLayer layer,
+    const u32       pipeline,
+    const u32       material,
+    const u32       mesh,
+    const f32       depth
+) -> u64
+{
+    assert( pipeline <= mask( PIPELINE_BITS ) && material <= mask( MATERIAL_BITS ) && mesh <= mask( MESH_BITS ) );
+
+    const u64 state = ( ( pipeline & mask( PIPELINE_BITS ) ) << PIPELINE_SHIFT ) |
+                      ( ( material & mask( MATERIAL_BITS ) ) << MATERIAL_SHIFT ) |
+                      ( ( mesh & mask( MESH_BITS ) ) << MESH_SHIFT );
+    const u64 depth_bits = quantize_depth( depth );
+
+    if ( layer == DrawLayer::Opaque ) {
+        return ( state << DEPTH_BITS ) | depth_bits;
+    }
+
+    return ( u64{ 1 } << LAYER_SHIFT ) | ( ( ~depth_bits & mask( DEPTH_BITS ) ) << STATE_BITS ) | state;
+}
+
+auto DrawQueue::get_layer( const u64 key ) -> DrawLayer
+{
+    return static_cast<DrawLayer>( key >> LAYER_SHIFT );
+}
+
+auto DrawQueue::get_pipeline( const u64 key ) -> u32
+{
+    return static_cast<u32>( ( key >> ( get_state_shift( key ) + PIPELINE_SHIFT ) ) & mask( PIPELINE_BITS ) );
+}
+
+auto DrawQueue::get_material( const u64 key ) -> u32
+{
+    return static_cast<u32>( ( key >> ( get_state_shift( key ) + MATERIAL_SHIFT ) ) & mask( MATERIAL_BITS ) );
+}
+
+auto DrawQueue::get_mesh( const u64 key ) -> u32
+{
+    return static_cast<u32>( ( key >> ( get_state_shift( key ) + MESH_SHIFT ) ) & mask( MESH_BITS ) );
+}
+
+auto DrawQueue::count_state_changes( const std::span<const u64> keys ) -> DrawStateChanges
+{
+    DrawStateChanges changes = { .pipeline = 0, .material = 0, .mesh = 0 };
+
+    for ( usize i = 0; i < keys.size(); ++i ) {
+        const bool first = i == 0;
+        changes.pipeline += first || get_pipeline( keys[i] ) != get_pipeline( keys[i - 1] ) ? 1 : 0;
+        changes.material += first || get_material( keys[i] ) != get_material( keys[i - 1] ) ? 1 : 0;
+        changes.mesh += first || get_mesh( keys[i] ) != get_mesh( keys[i - 1] ) ? 1 : 0;
+    }
+
+    return changes;
+}
+
+auto DrawQueue::reset() -> void
+{
+    keys_.clear();
+    payloads_.clear();
+}
+
+auto DrawQueue::push( const u64 key, const u32 payload ) -> void
+{
+    keys_.push_back( key );
+    payloads_.push_back( payload );
+}
+
+auto DrawQueue::sort( JobSystem* const jobs ) -> void
+{
+    MKSV_PROFILE_ZONE( "DrawQueue::sort" );
+
+    key_scratch_.resize( keys_.size() );
+    payload_scratch_.resize( payloads_.size() );
+    radix_sort( keys_, payloads_, key_scratch_, payload_scratch_, jobs );
+}
+
+auto DrawQueue::get_keys() const -> std::span<const u64>
+{
+    return keys_;
+}
+
+auto DrawQueue::get_payloads() const -> std::span<const u32>
+{
+    return payloads_;
+}
+
+auto DrawQueue::get_count() const -> u32
+{
+    return static_cast<u32>( keys_.size() );
+}
+
+} // namespace mksv
@@ -0,0 +1,357 @@
+#include "mksv/graphics/frame_graph.hpp"
+
+#include "mksv/graphics/graphics_command_list_pool.hpp"
+#include "mksv/log.hpp"
+#include "mksv/profiler.hpp"
+#include "mksv/utils/d3d12_helpers.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace mksv
+{
+
+auto FrameGraph::create( ComPtr<D3D12Device> device, Fence& fence ) -> std::unique_ptr<FrameGraph>
+{
+    return std::unique_ptr<FrameGraph>{ new FrameGraph( std::move( device ), fence ) };
+}
+
+FrameGraph::FrameGraph( ComPtr<D3D12Device> device, Fence& fence )
+    : device_{ std::move( device ) },
+      fence_{ &fence },
+      graph_{ static_cast<u32>( BarrierRecorder::READ_ONLY_STATES ), D3D12_RESOURCE_STATE_UNORDERED_ACCESS },
+      heap_size_{ 0 }
+{
+}
+
+auto FrameGraph::reset() -> void
+{
+    graph_.reset();
+    callbacks_.clear();
+    resources_.clear();
+    textures_.clear();
+}
+
+auto FrameGraph::import_resource( ID3D12Resource* resource ) -> RenderGraphResource
+{
+    const RenderGraphResource handle = graph_.import_resource();
+
+    resources_.push_back( resource );
+    textures_.push_back( {
+        .desc = {},
+        .clear_value = std::nullopt,
+        .info = {},
+        .offset = RenderGraph::INVALID_OFFSET,
+        .resource = nullptr,
+    } );
+
+    return handle;
+}
+
+auto FrameGraph::create_texture( const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clear_value )
+    -> RenderGraphResource
+{
+    const bool depth_stencil = ( desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL ) != 0;
+    const bool render_target = ( desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET ) != 0;
+    if ( desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER || ( !depth_stencil && !render_target ) ) {
+        log_error( L"Transient frame graph resources have to be render target or depth stencil textures" );
+        return RenderGraph::INVALID_RESOURCE;
+    }
+
+    Texture texture = {
+        .desc = desc,
+        .clear_value = std::nullopt,
+        .info = {},
+        .offset = RenderGraph::INVALID_OFFSET,
+        .resource = nullptr,
+    };
+
+    // Only the member of the union that is in use is copied so that textures can be compared bytewise
+    if ( clear_value ) {
+        D3D12_CLEAR_VALUE& clear = texture.clear_value.emplace();
+        clear.Format = clear_value->Format;
+        if ( depth_stencil ) {
+            clear.DepthStencil = clear_value->DepthStencil;
+        } else {
+            std::ranges::copy( clear_value->Color, clear.Color );
+        }
+    }
+
+    // Querying the allocation info is not free, reuse it when the same texture is declared as last time
+    const usize index = textures_.size();
+    if ( index < realized_.size() && is_same_texture( realized_[index], texture ) ) {
+        texture.info = realized_[index].info;
+    } else {
+        texture.info = device_->GetResourceAllocationInfo( 0, 1, &desc );
+        if ( texture.info.SizeInBytes == UINT64_MAX ) {
+            log_error( L"Invalid description for a transient frame graph texture" );
+            return RenderGraph::INVALID_RESOURCE;
+        }
+    }
+
+    const RenderGraphResource handle = graph_.create_transient( texture.info.SizeInBytes, texture.info.Alignment );
+
+    resources_.push_back( nullptr );
+    textures_.push_back( std::move( texture ) );
+
+    return handle;
+}
+
+auto FrameGraph::export_resource( const RenderGraphResource resource, const D3D12_RESOURCE_STATES final_state ) -> void
+{
+    graph_.export_resource( resource, static_cast<u32>( final_state ) );
+}
+
+auto FrameGraph::add_pass( const std::string_view name, ExecuteCallback execute ) -> RenderPassBuilder
+{
+    callbacks_.push_back( { .execute = std::move( execute ), .record = nullptr, .draw_count = 0 } );
+    return graph_.add_pass( name );
+}
+
+auto FrameGraph::add_parallel_pass( const std::string_view name, const u32 draw_count, ChunkCallback record )
+    -> RenderPassBuilder
+{
+    callbacks_.push_back( { .execute = nullptr, .record = std::move( record ), .draw_count = draw_count } );
+    return graph_.add_pass( name );
+}
+
+auto FrameGraph::get_resource( const RenderGraphResource resource ) const -> ID3D12Resource*
+{
+    return resources_[resource];
+}
+
+auto FrameGraph::execute( ParallelRecorder& recorder, BarrierRecorder& barriers, GpuProfiler* gpu_profiler ) -> bool
+{
+    MKSV_PROFILE_ZONE( "FrameGraph::execute" );
+
+    graph_.compile();
+
+    if ( !is_realized() && !realize_transients( barriers ) ) {
+        return false;
+    }
+
+    for ( u32 i = 0; i < resources_.size(); ++i ) {
+        if ( graph_.is_transient( i ) ) {
+            resources_[i] = realized_[i].resource.Get();
+        }
+    }
+
+    const CompiledRenderGraph& compiled = graph_.get_compiled();
+    for ( const CompiledRenderPass& pass : compiled.passes ) {
+        for ( u32 i = pass.first_aliasing; i < pass.first_aliasing + pass.aliasing_count; ++i ) {
+            const RenderGraphAliasing& aliasing = compiled.aliasing[i];
+            ID3D12Resource* const      before =
+                aliasing.before == RenderGraph::INVALID_RESOURCE ? nullptr : resources_[aliasing.before];
+
+            barriers.alias( before, resources_[aliasing.after] );
+        }
+
+        // The barriers after the previous pass are flushed together with the ones before this pass
+        record_barriers( barriers, pass.first_barrier_before, pass.barrier_before_count );
+
+        const CommandListHandle         list = recorder.get_list();
+        D3D12GraphicsCommandList* const command_list = GraphicsCommandListPool::get_list( list );
+        if ( !command_list ) {
+            return false;
+        }
+
+        barriers.flush( command_list );
+
+        // Pass names are literals, which are null terminated
+        u32 zone = GpuProfiler::INVALID_ZONE;
+        if ( gpu_profiler ) {
+            zone = gpu_profiler->begin_zone( list, graph_.get_pass_name( pass.pass ).data() );
+        }
+
+        const Callback& callback = callbacks_[pass.pass];
+        if ( !callback.record ) {
+            callback.execute( command_list );
+        } else {
+            const bool recorded = recorder.record(
+                callback.draw_count,
+                [&callback]( const CommandListHandle list, const DrawChunk chunk ) {
+                    callback.record( GraphicsCommandListPool::get_list( list ), chunk );
+                }
+            );
+
+            if ( !recorded ) {
+                return false;
+            }
+        }
+
+        // A parallel pass continues on a new serial list after its chunks
+        if ( zone != GpuProfiler::INVALID_ZONE ) {
+            gpu_profiler->end_zone( recorder.get_list(), zone );
+        }
+
+        record_barriers( barriers, pass.first_barrier_after, pass.barrier_after_count );
+    }
+
+    D3D12GraphicsCommandList* const command_list = GraphicsCommandListPool::get_list( recorder.get_list() );
+    if ( !command_list ) {
+        return false;
+    }
+
+    barriers.flush( command_list );
+    return true;
+}
+
+auto FrameGraph::submit( const u64 fence_value ) -> void
+{
+    for ( PendingRelease& release : pending_releases_ ) {
+        if ( release.fence_value == OPEN_BATCH ) {
+            release.fence_value = fence_value;
+        }
+    }
+}
+
+auto FrameGraph::retire() -> void
+{
+    const u64 completed = fence_->get_completed_value();
+
+    std::erase_if( pending_releases_, [completed]( const PendingRelease& release ) {
+        return release.fence_value != OPEN_BATCH && release.fence_value <= completed;
+    } );
+}
+
+auto FrameGraph::get_graph() const -> const RenderGraph&
+{
+    return graph_;
+}
+
+auto FrameGraph::is_same_texture( const Texture& a, const Texture& b ) -> bool
+{
+    const D3D12_RESOURCE_DESC& x = a.desc;
+    const D3D12_RESOURCE_DESC& y = b.desc;
+
+    const bool same_desc = x.Dimension == y.Dimension && x.Alignment == y.Alignment && x.Width == y.Width &&
+                           x.Height == y.Height && x.DepthOrArraySize == y.DepthOrArraySize &&
+                           x.MipLevels == y.MipLevels && x.Format == y.Format &&
+                           x.SampleDesc.Count == y.SampleDesc.Count && x.SampleDesc.Quality == y.SampleDesc.Quality &&
+                           x.Layout == y.Layout && x.Flags == y.Flags;
+    if ( !same_desc || a.clear_value.has_value() != b.clear_value.has_value() ) {
+        return false;
+    }
+
+    return !a.clear_value || std::memcmp( &*a.clear_value, &*b.clear_value, sizeof( D3D12_CLEAR_VALUE ) ) == 0;
+}
+
+auto FrameGraph::is_realized() const -> bool
+{
+    const CompiledRenderGraph& compiled = graph_.get_compiled();
+    if ( realized_.size() != textures_.size() || heap_size_ < compiled.transient_size ) {
+        return false;
+    }
+
+    for ( u32 i = 0; i < textures_.size(); ++i ) {
+        if ( realized_[i].offset != compiled.offsets[i] || !is_same_texture( realized_[i], textures_[i] ) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto FrameGraph::realize_transients( BarrierRecorder& barriers ) -> bool
+{
+    release_transients( barriers );
+
+    const CompiledRenderGraph& compiled = graph_.get_compiled();
+
+    u64 alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    for ( u32 i = 0; i < textures_.size(); ++i ) {
+        if ( compiled.offsets[i] != RenderGraph::INVALID_OFFSET ) {
+            alignment = std::max( alignment, textures_[i].info.Alignment );
+        }
+    }
+
+    if ( compiled.transient_size > 0 ) {
+        const D3D12_HEAP_DESC desc = {
+            .SizeInBytes = ( compiled.transient_size + alignment - 1 ) & ~( alignment - 1 ),
+            .Properties = d3d12::heap_properties( D3D12_HEAP_TYPE_DEFAULT ),
+            .Alignment = alignment,
+            .Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        };
+
+        const HRESULT hr = device_->CreateHeap( &desc, IID_PPV_ARGS( &heap_ ) );
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+            return false;
+        }
+    }
+
+    realized_ = textures_;
+    for ( u32 i = 0; i < realized_.size(); ++i ) {
+        Texture& texture = realized_[i];
+        texture.offset = compiled.offsets[i];
+        if ( texture.offset == RenderGraph::INVALID_OFFSET ) {
+            continue;
+        }
+
+        const D3D12_CLEAR_VALUE* clear_value = texture.clear_value ? &*texture.clear_value : nullptr;
+        const HRESULT            hr = device_->CreatePlacedResource(
+            heap_.Get(),
+            texture.offset,
+            &texture.desc,
+            D3D12_RESOURCE_STATE_COMMON,
+            clear_value,
+            IID_PPV_ARGS( &texture.resource )
+        );
+
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+            release_transients( barriers );
+            return false;
+        }
+
+        barriers.track( texture.resource.Get(), D3D12_RESOURCE_STATE_COMMON );
+    }
+
+    heap_size_ = compiled.transient_size;
+    return true;
+}
+
+auto FrameGraph::release_transients( BarrierRecorder& barriers ) -> void
+{
+    PendingRelease release = {
+        .heap = std::move( heap_ ),
+        .resources = {},
+        .fence_value = OPEN_BATCH,
+    };
+
+    for ( Texture& texture : realized_ ) {
+        if ( texture.resource ) {
+            barriers.untrack( texture.resource.Get() );
+            release.resources.push_back( std::move( texture.resource ) );
+        }
+    }
+
+    if ( release.heap ) {
+        pending_releases_.push_back( std::move( release ) );
+    }
+
+    heap_size_ = 0;
+    realized_.clear();
+}
+
+auto FrameGraph::record_barriers( BarrierRecorder& barriers, const u32 first, const u32 count ) const -> void
+{
+    const CompiledRenderGraph& compiled = graph_.get_compiled();
+
+    for ( u32 i = first; i < first + count; ++i ) {
+        const RenderGraphBarrier&   barrier = compiled.barriers[i];
+        ID3D12Resource* const       resource = resources_[barrier.resource];
+        const D3D12_RESOURCE_STATES state = static_cast<D3D12_RESOURCE_STATES>( barrier.state );
+
+        if ( barrier.type == RenderGraphBarrierType::UnorderedAccess ) {
+            barriers.uav( resource );
+        } else if ( barrier.phase == BarrierPhase::Begin ) {
+            barriers.prepare( resource, state );
+        } else {
+            barriers.transition( resource, state );
+        }
+    }
+}
+
+} // namespace mksv
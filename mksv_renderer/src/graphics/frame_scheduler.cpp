@@ -0,0 +1,83 @@
+#include "mksv/graphics/frame_scheduler.hpp"
+
+#include "mksv/profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace mksv
+{
+
+FrameScheduler::FrameScheduler( Fence& fence, const u32 frames_in_flight )
+    : fence_{ &fence },
+      fence_values_( std::max( 1u, frames_in_flight ), 0 ),
+      current_index_{ 0 },
+      frame_number_{ 0 },
+      stall_count_{ 0 },
+      in_frame_{ false }
+{
+}
+
+auto FrameScheduler::begin_frame() -> u32
+{
+    MKSV_PROFILE_ZONE( "FrameScheduler::begin_frame" );
+
+    assert( !in_frame_ && "begin_frame called twice without end_frame" );
+
+    current_index_ = static_cast<u32>( frame_number_ % fence_values_.size() );
+
+    const u64 pending = fence_values_[current_index_];
+    if ( fence_->get_completed_value() < pending ) {
+        ++stall_count_;
+        fence_->wait_for_value( pending );
+    }
+
+    in_frame_ = true;
+    return current_index_;
+}
+
+auto FrameScheduler::end_frame() -> u64
+{
+    assert( in_frame_ && "end_frame called without begin_frame" );
+
+    const u64 value = fence_->signal();
+    fence_values_[current_index_] = value;
+    ++frame_number_;
+    in_frame_ = false;
+
+    return value;
+}
+
+auto FrameScheduler::wait_idle() -> bool
+{
+    const u64 last = *std::ranges::max_element( fence_values_ );
+    return fence_->wait_for_value( last );
+}
+
+auto FrameScheduler::get_frames_in_flight() const -> u32
+{
+    return static_cast<u32>( fence_values_.size() );
+}
+
+auto FrameScheduler::get_current_index() const -> u32
+{
+    return current_index_;
+}
+
+auto FrameScheduler::get_frame_number() const -> u64
+{
+    return frame_number_;
+}
+
+auto FrameScheduler::get_context_fence_value( const u32 index ) const -> u64
+{
+    assert( index < fence_values_.size() );
+    return fence_values_[index];
+}
+
+auto FrameScheduler::get_stall_count() const -> u64
+{
+    return stall_count_;
+}
+
+} // namespace mksv
@@ -0,0 +1,428 @@
+#include "mksv/graphics/frustum_culler.hpp"
+
+#include "mksv/math/mat.hpp"
+#include "mksv/math/simd.hpp"
+#include "mksv/profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+#if defined( __AVX512F__ ) && !defined( MKSV_MATH_SCALAR )
+#define MKSV_CULL_AVX512 1
+#endif
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 PLANE_COUNT = 6;
+
+// Plane coefficients as separate streams, with the absolute normals the box test projects the extents on
+struct Planes {
+    f32 x[PLANE_COUNT];
+    f32 y[PLANE_COUNT];
+    f32 z[PLANE_COUNT];
+    f32 w[PLANE_COUNT];
+    f32 abs_x[PLANE_COUNT];
+    f32 abs_y[PLANE_COUNT];
+    f32 abs_z[PLANE_COUNT];
+};
+
+struct Bounds {
+    const f32* center_x;
+    const f32* center_y;
+    const f32* center_z;
+    const f32* extent_x;
+    const f32* extent_y;
+    const f32* extent_z;
+    const f32* radius;
+};
+
+auto to_planes( const Frustum& frustum ) -> Planes
+{
+    Planes planes;
+    for ( u32 p = 0; p < PLANE_COUNT; ++p ) {
+        const vec4& plane = frustum.planes[p];
+        planes.x[p] = plane.x;
+        planes.y[p] = plane.y;
+        planes.z[p] = plane.z;
+        planes.w[p] = plane.w;
+        planes.abs_x[p] = std::abs( plane.x );
+        planes.abs_y[p] = std::abs( plane.y );
+        planes.abs_z[p] = std::abs( plane.z );
+    }
+    return planes;
+}
+
+// An object is outside once its bounds are entirely behind a single plane. The SIMD paths run the same test, only
+// fused multiply adds may round bounds that touch a plane differently.
+template <CullShape shape>
+auto is_visible( const Planes& planes, const Bounds& bounds, const u32 i ) -> bool
+{
+    for ( u32 p = 0; p < PLANE_COUNT; ++p ) {
+        const f32 distance = bounds.center_x[i] * planes.x[p] + bounds.center_y[i] * planes.y[p] +
+                             bounds.center_z[i] * planes.z[p] + planes.w[p];
+        f32 radius = 0.0f;
+        if constexpr ( shape == CullShape::Box ) {
+            radius = bounds.extent_x[i] * planes.abs_x[p] + bounds.extent_y[i] * planes.abs_y[p] +
+                     bounds.extent_z[i] * planes.abs_z[p];
+        } else {
+            radius = bounds.radius[i];
+        }
+
+        if ( !( distance + radius >= 0.0f ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <CullShape shape>
+auto cull_range( const Planes& planes, const Bounds& bounds, const u32 first, const u32 end, u32* visible ) -> u32
+{
+    u32 visible_count = 0;
+    u32 i = first;
+
+#if defined( MKSV_CULL_AVX512 )
+    // Compress stores write the visible lanes' indices out contiguously, without a branch per object
+    const __m512i lane_indices = _mm512_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+    for ( ; i + 16 <= end; i += 16 ) {
+        const __m512 center_x = _mm512_loadu_ps( bounds.center_x + i );
+        const __m512 center_y = _mm512_loadu_ps( bounds.center_y + i );
+        const __m512 center_z = _mm512_loadu_ps( bounds.center_z + i );
+
+        __m512 extent_x = _mm512_setzero_ps();
+        __m512 extent_y = _mm512_setzero_ps();
+        __m512 extent_z = _mm512_setzero_ps();
+        __m512 radius = _mm512_setzero_ps();
+        if constexpr ( shape == CullShape::Box ) {
+            extent_x = _mm512_loadu_ps( bounds.extent_x + i );
+            extent_y = _mm512_loadu_ps( bounds.extent_y + i );
+            extent_z = _mm512_loadu_ps( bounds.extent_z + i );
+        } else {
+            radius = _mm512_loadu_ps( bounds.radius + i );
+        }
+
+        __mmask16 inside = 0xFFFF;
+        for ( u32 p = 0; p < PLANE_COUNT; ++p ) {
+            __m512 distance = _mm512_fmadd_ps( center_x, _mm512_set1_ps( planes.x[p] ), _mm512_set1_ps( planes.w[p] ) );
+            distance = _mm512_fmadd_ps( center_y, _mm512_set1_ps( planes.y[p] ), distance );
+            distance = _mm512_fmadd_ps( center_z, _mm512_set1_ps( planes.z[p] ), distance );
+
+            if constexpr ( shape == CullShape::Box ) {
+                distance = _mm512_fmadd_ps( extent_x, _mm512_set1_ps( planes.abs_x[p] ), distance );
+                distance = _mm512_fmadd_ps( extent_y, _mm512_set1_ps( planes.abs_y[p] ), distance );
+                distance = _mm512_fmadd_ps( extent_z, _mm512_set1_ps( planes.abs_z[p] ), distance );
+            } else {
+                distance = _mm512_add_ps( distance, radius );
+            }
+
+            inside = _mm512_mask_cmp_ps_mask( inside, distance, _mm512_setzero_ps(), _CMP_GE_OQ );
+        }
+
+        const __m512i indices = _mm512_add_epi32( _mm512_set1_epi32( static_cast<i32>( i ) ), lane_indices );
+        _mm512_mask_compressstoreu_epi32( visible + visible_count, inside, indices );
+        visible_count += static_cast<u32>( std::popcount( static_cast<u32>( inside ) ) );
+    }
+#else
+    using namespace simd;
+
+    constexpr u32 lane_count = static_cast<u32>( WIDE_LANE_COUNT );
+
+    if constexpr ( lane_count > 1 ) {
+        for ( ; i + lane_count <= end; i += lane_count ) {
+            const f32xw center_x = wide_load( bounds.center_x + i );
+            const f32xw center_y = wide_load( bounds.center_y + i );
+            const f32xw center_z = wide_load( bounds.center_z + i );
+
+            u32 inside = ( 1u << lane_count ) - 1;
+            for ( u32 p = 0; p < PLANE_COUNT && inside != 0; ++p ) {
+                f32xw distance = wide_madd( center_x, wide_splat( planes.x[p] ), wide_splat( planes.w[p] ) );
+                distance = wide_madd( center_y, wide_splat( planes.y[p] ), distance );
+                distance = wide_madd( center_z, wide_splat( planes.z[p] ), distance );
+
+                if constexpr ( shape == CullShape::Box ) {
+                    distance = wide_madd( wide_load( bounds.extent_x + i ), wide_splat( planes.abs_x[p] ), distance );
+                    distance = wide_madd( wide_load( bounds.extent_y + i ), wide_splat( planes.abs_y[p] ), distance );
+                    distance = wide_madd( wide_load( bounds.extent_z + i ), wide_splat( planes.abs_z[p] ), distance );
+                } else {
+                    distance = wide_add( distance, wide_load( bounds.radius + i ) );
+                }
+
+                inside &= wide_ge_zero_mask( distance );
+            }
+
+            // One iteration per visible object
+            for ( ; inside != 0; inside &= inside - 1 ) {
+                visible[visible_count++] = i + static_cast<u32>( std::countr_zero( inside ) );
+            }
+        }
+    }
+#endif
+
+    for ( ; i < end; ++i ) {
+        if ( is_visible<shape>( planes, bounds, i ) ) {
+            visible[visible_count++] = i;
+        }
+    }
+
+    return visible_count;
+}
+} // namespace
+
+auto extract_frustum( const mat4& view_projection ) -> Frustum
+{
+    // With row vectors clip space is v * M, so every clip coordinate is the dot product with a column
+    const auto column = [&view_projection]( const u32 c ) {
+        const auto element = [c]( const vec4& row ) {
+            return c == 0 ? row.x : c == 1 ? row.y : c == 2 ? row.z : row.w;
+        };
+        return vec4{
+            element( view_projection.r[0] ),
+            element( view_projection.r[1] ),
+            element( view_projection.r[2] ),
+            element( view_projection.r[3] ),
+        };
+    };
+
+    const vec4 x = column( 0 );
+    const vec4 y = column( 1 );
+    const vec4 z = column( 2 );
+    const vec4 w = column( 3 );
+
+    Frustum frustum = { {
+        vec4{ w.x + x.x, w.y + x.y, w.z + x.z, w.w + x.w },
+        vec4{ w.x - x.x, w.y - x.y, w.z - x.z, w.w - x.w },
+        vec4{ w.x + y.x, w.y + y.y, w.z + y.z, w.w + y.w },
+        vec4{ w.x - y.x, w.y - y.y, w.z - y.z, w.w - y.w },
+        z,
+        vec4{ w.x - z.x, w.y - z.y, w.z - z.z, w.w - z.w },
+    } };
+
+    for ( vec4& plane : frustum.planes ) {
+        const f32 length = std::sqrt( plane.x * plane.x + plane.y * plane.y + plane.z * plane.z );
+        if ( length > 0.0f ) {
+            plane = { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+        }
+    }
+
+    return frustum;
+}
+
+auto FrustumCuller::clear() -> void
+{
+    resize( 0 );
+}
+
+auto FrustumCuller::resize( const u32 count ) -> void
+{
+    center_x_.resize( count );
+    center_y_.resize( count );
+    center_z_.resize( count );
+    extent_x_.resize( count );
+    extent_y_.resize( count );
+    extent_z_.resize( count );
+    radius_.resize( count );
+}
+
+auto FrustumCuller::add( const vec3& center, const vec3& extent ) -> u32
+{
+    const u32 index = get_count();
+    resize( index + 1 );
+    set( index, center, extent );
+    return index;
+}
+
+auto FrustumCuller::set( const u32 index, const vec3& center, const vec3& extent ) -> void
+{
+    assert( index < get_count() );
+
+    center_x_[index] = center.x;
+    center_y_[index] = center.y;
+    center_z_[index] = center.z;
+    extent_x_[index] = extent.x;
+    extent_y_[index] = extent.y;
+    extent_z_[index] = extent.z;
+    radius_[index] = std::sqrt( extent.x * extent.x + extent.y * extent.y + extent.z * extent.z );
+}
+
+auto FrustumCuller::set_transformed(
+    const TransformHierarchy&          transforms,
+    const std::span<const TransformId> objects,
+    const vec3&                        center,
+    const vec3&                        extent,
+    JobSystem* const                   jobs
+) -> void
+{
+    MKSV_PROFILE_ZONE( "FrustumCuller::set_transformed" );
+
+    const u32 count = static_cast<u32>( objects.size() );
+    resize( count );
+
+    if ( !jobs || count < 2 * MIN_BLOCK_SIZE ) {
+        set_transformed_range( transforms, objects, center, extent, 0, count );
+        return;
+    }
+
+    // Blocks are a multiple of the SIMD width, only the last one has a scalar tail
+    const u32 block_count = ( count + MIN_BLOCK_SIZE - 1 ) / MIN_BLOCK_SIZE;
+    jobs->parallel_for( block_count, 1, [&]( const u32 first_block, const u32 blocks ) {
+        const u32 first = first_block * MIN_BLOCK_SIZE;
+        const u32 end = std::min( count, ( first_block + blocks ) * MIN_BLOCK_SIZE );
+        set_transformed_range( transforms, objects, center, extent, first, end );
+    } );
+}
+
+auto FrustumCuller::get_count() const -> u32
+{
+    return static_cast<u32>( center_x_.size() );
+}
+
+auto FrustumCuller::get_lane_count() -> u32
+{
+#if defined( MKSV_CULL_AVX512 )
+    return 16;
+#else
+    return static_cast<u32>( simd::WIDE_LANE_COUNT );
+#endif
+}
+
+auto FrustumCuller::set_transformed_range(
+    const TransformHierarchy&          transforms,
+    const std::span<const TransformId> objects,
+    const vec3&                        center,
+    const vec3&                        extent,
+    const u32                          first,
+    const u32                          end
+) -> void
+{
+    using namespace simd;
+
+    constexpr u32 lane_count = static_cast<u32>( WIDE_LANE_COUNT );
+
+    // The box around the transformed box: the center is transformed as a point, every world axis gathers the local
+    // extents it is rotated onto
+    f32* const centers[3] = { center_x_.data(), center_y_.data(), center_z_.data() };
+    f32* const extents[3] = { extent_x_.data(), extent_y_.data(), extent_z_.data() };
+    const f32  local_center[3] = { center.x, center.y, center.z };
+    const f32  local_extent[3] = { extent.x, extent.y, extent.z };
+
+    u32 i = first;
+    if constexpr ( lane_count > 1 ) {
+        for ( ; i + lane_count <= end; i += lane_count ) {
+            // Rows of the affine part, and the absolute values of the rotation rows for the extents
+            alignas( 64 ) f32 rows[4][3][lane_count];
+            alignas( 64 ) f32 abs_rows[3][3][lane_count];
+            for ( u32 lane = 0; lane < lane_count; ++lane ) {
+                const mat4& world = transforms.get_world( objects[i + lane] );
+                for ( u32 row = 0; row < 4; ++row ) {
+                    rows[row][0][lane] = world.r[row].x;
+                    rows[row][1][lane] = world.r[row].y;
+                    rows[row][2][lane] = world.r[row].z;
+                }
+                for ( u32 row = 0; row < 3; ++row ) {
+                    abs_rows[row][0][lane] = std::abs( world.r[row].x );
+                    abs_rows[row][1][lane] = std::abs( world.r[row].y );
+                    abs_rows[row][2][lane] = std::abs( world.r[row].z );
+                }
+            }
+
+            f32xw squared_radius = wide_splat( 0.0f );
+            for ( u32 axis = 0; axis < 3; ++axis ) {
+                f32xw world_center = wide_load( rows[3][axis] );
+                f32xw world_extent = wide_splat( 0.0f );
+                for ( u32 row = 0; row < 3; ++row ) {
+                    world_center =
+                        wide_madd( wide_splat( local_center[row] ), wide_load( rows[row][axis] ), world_center );
+                    world_extent =
+                        wide_madd( wide_splat( local_extent[row] ), wide_load( abs_rows[row][axis] ), world_extent );
+                }
+                wide_store( centers[axis] + i, world_center );
+                wide_store( extents[axis] + i, world_extent );
+                squared_radius = wide_madd( world_extent, world_extent, squared_radius );
+            }
+            wide_store( radius_.data() + i, wide_sqrt( squared_radius ) );
+        }
+    }
+
+    for ( ; i < end; ++i ) {
+        const mat4& world = transforms.get_world( objects[i] );
+        const vec3  world_extent = {
+            std::abs( world.r[0].x ) * extent.x + std::abs( world.r[1].x ) * extent.y +
+                std::abs( world.r[2].x ) * extent.z,
+            std::abs( world.r[0].y ) * extent.x + std::abs( world.r[1].y ) * extent.y +
+                std::abs( world.r[2].y ) * extent.z,
+            std::abs( world.r[0].z ) * extent.x + std::abs( world.r[1].z ) * extent.y +
+                std::abs( world.r[2].z ) * extent.z,
+        };
+        set( i, transform_point( center, world ), world_extent );
+    }
+}
+
+auto FrustumCuller::cull(
+    const Frustum&  frustum,
+    const CullShape shape,
+    const u32       first,
+    const u32       count,
+    u32*            visible
+) const -> u32
+{
+    assert( first + count <= get_count() );
+
+    const Planes planes = to_planes( frustum );
+    const Bounds bounds = {
+        .center_x = center_x_.data(),
+        .center_y = center_y_.data(),
+        .center_z = center_z_.data(),
+        .extent_x = extent_x_.data(),
+        .extent_y = extent_y_.data(),
+        .extent_z = extent_z_.data(),
+        .radius = radius_.data(),
+    };
+
+    if ( shape == CullShape::Box ) {
+        return cull_range<CullShape::Box>( planes, bounds, first, first + count, visible );
+    }
+    return cull_range<CullShape::Sphere>( planes, bounds, first, first + count, visible );
+}
+
+auto FrustumCuller::cull(
+    const Frustum&    frustum,
+    const CullShape   shape,
+    std::vector<u32>& visible,
+    JobSystem* const  jobs
+) const -> void
+{
+    MKSV_PROFILE_ZONE( "FrustumCuller::cull" );
+
+    const u32 count = get_count();
+    visible.resize( count );
+
+    if ( !jobs || count < 2 * MIN_BLOCK_SIZE ) {
+        visible.resize( cull( frustum, shape, 0, count, visible.data() ) );
+        return;
+    }
+
+    // Every block compacts into its own part of the output, the parts are then moved together in order
+    const u32 block_count = ( count + MIN_BLOCK_SIZE - 1 ) / MIN_BLOCK_SIZE;
+    block_visible_.resize( block_count );
+    jobs->parallel_for( block_count, 1, [&]( const u32 first_block, const u32 blocks ) {
+        for ( u32 block = first_block; block < first_block + blocks; ++block ) {
+            const u32 first = block * MIN_BLOCK_SIZE;
+            const u32 size = std::min( MIN_BLOCK_SIZE, count - first );
+            block_visible_[block] = cull( frustum, shape, first, size, visible.data() + first );
+        }
+    } );
+
+    u32 visible_count = 0;
+    for ( u32 block = 0; block < block_count; ++block ) {
+        const auto source = visible.begin() + block * MIN_BLOCK_SIZE;
+        std::copy( source, source + block_visible_[block], visible.begin() + visible_count );
+        visible_count += block_visible_[block];
+    }
+    visible.resize( visible_count );
+}
+
+} // namespace mksv
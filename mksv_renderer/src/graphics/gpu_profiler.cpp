@@ -0,0 +1,144 @@
+#include "mksv/graphics/gpu_profiler.hpp"
+
+#include "mksv/profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <optional>
+
+namespace mksv
+{
+
+GpuProfiler::GpuProfiler( TimestampQueryPool& pool, const u32 frames_in_flight )
+    : pool_{ &pool },
+      zones_per_frame_{ pool.get_query_count() / ( 2 * frames_in_flight ) },
+      frames_( frames_in_flight, Frame{ .zones = {}, .resolved = false } ),
+      current_index_{ 0 },
+      frame_milliseconds_{ 0.0 },
+      dropped_count_{ 0 }
+{
+    assert( zones_per_frame_ > 0 && "The query pool needs at least two queries per frame in flight" );
+}
+
+auto GpuProfiler::begin_frame( const u32 frame_index ) -> void
+{
+    assert( frame_index < frames_.size() );
+
+    current_index_ = frame_index;
+    zones_.clear();
+    frame_milliseconds_ = 0.0;
+
+    Frame& frame = frames_[frame_index];
+    if ( frame.resolved && !frame.zones.empty() ) {
+        read_frame( frame_index );
+    }
+
+    frame.zones.clear();
+    frame.resolved = false;
+}
+
+auto GpuProfiler::begin_zone( const CommandListHandle list, const char* name ) -> u32
+{
+    Frame& frame = frames_[current_index_];
+    if ( !list || frame.resolved || frame.zones.size() == zones_per_frame_ ) {
+        ++dropped_count_;
+        return INVALID_ZONE;
+    }
+
+    const u32 zone = static_cast<u32>( frame.zones.size() );
+    pool_->write( list, get_first_query( current_index_ ) + 2 * zone );
+    frame.zones.push_back( { .name = name, .open = true } );
+    return zone;
+}
+
+auto GpuProfiler::end_zone( const CommandListHandle list, const u32 zone ) -> void
+{
+    Frame& frame = frames_[current_index_];
+    if ( !list || zone >= frame.zones.size() || !frame.zones[zone].open ) {
+        return;
+    }
+
+    pool_->write( list, get_first_query( current_index_ ) + 2 * zone + 1 );
+    frame.zones[zone].open = false;
+}
+
+auto GpuProfiler::end_frame( const CommandListHandle list ) -> void
+{
+    Frame& frame = frames_[current_index_];
+    if ( !list || frame.resolved || frame.zones.empty() ) {
+        return;
+    }
+
+    for ( u32 zone = 0; zone < frame.zones.size(); ++zone ) {
+        end_zone( list, zone );
+    }
+
+    pool_->resolve( list, get_first_query( current_index_ ), 2 * static_cast<u32>( frame.zones.size() ) );
+    frame.resolved = true;
+}
+
+auto GpuProfiler::get_zones() const -> std::span<const GpuZoneTiming>
+{
+    return zones_;
+}
+
+auto GpuProfiler::get_frame_milliseconds() const -> f64
+{
+    return frame_milliseconds_;
+}
+
+auto GpuProfiler::get_dropped_count() const -> u64
+{
+    return dropped_count_;
+}
+
+auto GpuProfiler::get_first_query( const u32 frame_index ) const -> u32
+{
+    return frame_index * 2 * zones_per_frame_;
+}
+
+auto GpuProfiler::read_frame( const u32 frame_index ) -> void
+{
+    const Frame& frame = frames_[frame_index];
+    timestamps_.resize( 2 * frame.zones.size() );
+    if ( !pool_->read( get_first_query( frame_index ), timestamps_ ) ) {
+        return;
+    }
+
+    const std::optional<GpuClockCalibration> calibration = pool_->get_calibration();
+    if ( !calibration ) {
+        return;
+    }
+
+    // The zones ran before the calibration was taken, their tick differences are negative
+    const f64  nanoseconds_per_tick = 1e9 / static_cast<f64>( pool_->get_frequency() );
+    const auto to_cpu_time = [&]( const u64 timestamp ) {
+        const i64 ticks = static_cast<i64>( timestamp - calibration->gpu_timestamp );
+        return calibration->cpu_time +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                   std::chrono::duration<f64, std::nano>( static_cast<f64>( ticks ) * nanoseconds_per_tick )
+               );
+    };
+
+    u64 first = std::numeric_limits<u64>::max();
+    u64 last = 0;
+    for ( u32 zone = 0; zone < frame.zones.size(); ++zone ) {
+        const u64 begin = timestamps_[2 * zone];
+        const u64 end = std::max( begin, timestamps_[2 * zone + 1] );
+        first = std::min( first, begin );
+        last = std::max( last, end );
+
+        const GpuZoneTiming timing = {
+            .name = frame.zones[zone].name,
+            .begin = to_cpu_time( begin ),
+            .end = to_cpu_time( end ),
+        };
+        zones_.push_back( timing );
+        profile_gpu_zone( timing.name, timing.begin, timing.end );
+    }
+
+    frame_milliseconds_ = static_cast<f64>( last - first ) * nanoseconds_per_tick / 1e6;
+}
+
+} // namespace mksv
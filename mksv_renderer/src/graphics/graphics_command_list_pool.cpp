@@ -0,0 +1,134 @@
+#include "mksv/graphics/graphics_command_list_pool.hpp"
+
+#include "mksv/log.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace mksv
+{
+
+auto GraphicsCommandListPool::create(
+    ComPtr<D3D12Device> device,
+    CommandQueue&       queue,
+    const u32           worker_count,
+    const u32           frames_in_flight
+) -> std::unique_ptr<GraphicsCommandListPool>
+{
+    const D3D12_COMMAND_LIST_TYPE type = queue.get_ptr()->GetDesc().Type;
+
+    std::vector<Worker> workers( std::max( 1u, worker_count ) );
+    for ( Worker& worker : workers ) {
+        worker.allocators.resize( std::max( 1u, frames_in_flight ) );
+        worker.used = 0;
+
+        for ( ComPtr<ID3D12CommandAllocator>& allocator : worker.allocators ) {
+            const HRESULT hr = device->CreateCommandAllocator( type, IID_PPV_ARGS( &allocator ) );
+            if ( FAILED( hr ) ) {
+                log_hresult( hr );
+                return nullptr;
+            }
+        }
+    }
+
+    return std::unique_ptr<GraphicsCommandListPool>{
+        new GraphicsCommandListPool( std::move( device ), queue, type, std::move( workers ) )
+    };
+}
+
+auto GraphicsCommandListPool::get_list( const CommandListHandle list ) -> D3D12GraphicsCommandList*
+{
+    return static_cast<D3D12GraphicsCommandList*>( list );
+}
+
+GraphicsCommandListPool::GraphicsCommandListPool(
+    ComPtr<D3D12Device>           device,
+    CommandQueue&                 queue,
+    const D3D12_COMMAND_LIST_TYPE type,
+    std::vector<Worker>           workers
+)
+    : device_{ std::move( device ) },
+      queue_{ &queue },
+      type_{ type },
+      workers_{ std::move( workers ) },
+      frame_index_{ 0 }
+{
+}
+
+auto GraphicsCommandListPool::begin_frame( const u32 frame_index ) -> bool
+{
+    assert( frame_index < workers_.front().allocators.size() );
+
+    frame_index_ = frame_index;
+
+    for ( Worker& worker : workers_ ) {
+        worker.used = 0;
+
+        const HRESULT hr = worker.allocators[frame_index]->Reset();
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto GraphicsCommandListPool::open( const u32 worker ) -> CommandListHandle
+{
+    assert( worker < workers_.size() );
+    Worker& state = workers_[worker];
+
+    // New lists are created closed so that every list goes through the same Reset below
+    if ( state.used == state.lists.size() ) {
+        ComPtr<D3D12GraphicsCommandList> list{};
+        const HRESULT hr = device_->CreateCommandList1( 0, type_, D3D12_COMMAND_LIST_FLAG_NONE, IID_PPV_ARGS( &list ) );
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+            return nullptr;
+        }
+
+        state.lists.push_back( std::move( list ) );
+    }
+
+    D3D12GraphicsCommandList* const list = state.lists[state.used].Get();
+    const HRESULT                   hr = list->Reset( state.allocators[frame_index_].Get(), nullptr );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    ++state.used;
+    return list;
+}
+
+auto GraphicsCommandListPool::close( [[maybe_unused]] const u32 worker, const CommandListHandle list ) -> bool
+{
+    assert( worker < workers_.size() );
+
+    const HRESULT hr = get_list( list )->Close();
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return false;
+    }
+
+    return true;
+}
+
+auto GraphicsCommandListPool::submit( const std::span<const CommandListHandle> lists ) -> void
+{
+    submission_.clear();
+    for ( const CommandListHandle list : lists ) {
+        submission_.push_back( get_list( list ) );
+    }
+
+    queue_->execute( submission_ );
+}
+
+auto GraphicsCommandListPool::get_worker_count() const -> u32
+{
+    return static_cast<u32>( workers_.size() );
+}
+
+} // namespace mksv
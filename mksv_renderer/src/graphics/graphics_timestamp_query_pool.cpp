@@ -0,0 +1,156 @@
+#include "mksv/graphics/graphics_timestamp_query_pool.hpp"
+
+#include "mksv/graphics/graphics_command_list_pool.hpp"
+#include "mksv/log.hpp"
+#include "mksv/utils/d3d12_helpers.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace mksv
+{
+
+auto GraphicsTimestampQueryPool::create( ComPtr<D3D12Device> device, CommandQueue& queue, const u32 query_count )
+    -> std::unique_ptr<GraphicsTimestampQueryPool>
+{
+    u64     frequency = 0;
+    HRESULT hr = queue.get_ptr()->GetTimestampFrequency( &frequency );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    LARGE_INTEGER qpc_frequency{};
+    QueryPerformanceFrequency( &qpc_frequency );
+
+    const D3D12_QUERY_HEAP_DESC heap_desc = {
+        .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+        .Count = query_count,
+        .NodeMask = 0,
+    };
+
+    ComPtr<ID3D12QueryHeap> heap{};
+    hr = device->CreateQueryHeap( &heap_desc, IID_PPV_ARGS( &heap ) );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_READBACK );
+    const auto res_desc = d3d12::buffer_resource_desc( u64{ query_count } * sizeof( u64 ) );
+
+    ComPtr<ID3D12Resource> readback{};
+    hr = device->CreateCommittedResource(
+        &heap_props,
+        D3D12_HEAP_FLAG_NONE,
+        &res_desc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS( &readback )
+    );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    return std::unique_ptr<GraphicsTimestampQueryPool>{ new GraphicsTimestampQueryPool(
+        queue,
+        std::move( heap ),
+        std::move( readback ),
+        query_count,
+        frequency,
+        static_cast<u64>( qpc_frequency.QuadPart )
+    ) };
+}
+
+GraphicsTimestampQueryPool::GraphicsTimestampQueryPool(
+    CommandQueue&           queue,
+    ComPtr<ID3D12QueryHeap> heap,
+    ComPtr<ID3D12Resource>  readback,
+    const u32               query_count,
+    const u64               frequency,
+    const u64               qpc_frequency
+)
+    : queue_{ &queue },
+      heap_{ std::move( heap ) },
+      readback_{ std::move( readback ) },
+      query_count_{ query_count },
+      frequency_{ frequency },
+      qpc_frequency_{ qpc_frequency }
+{
+}
+
+auto GraphicsTimestampQueryPool::write( const CommandListHandle list, const u32 query ) -> void
+{
+    GraphicsCommandListPool::get_list( list )->EndQuery( heap_.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query );
+}
+
+auto GraphicsTimestampQueryPool::resolve( const CommandListHandle list, const u32 first, const u32 count ) -> void
+{
+    GraphicsCommandListPool::get_list( list )->ResolveQueryData(
+        heap_.Get(),
+        D3D12_QUERY_TYPE_TIMESTAMP,
+        first,
+        count,
+        readback_.Get(),
+        u64{ first } * sizeof( u64 )
+    );
+}
+
+auto GraphicsTimestampQueryPool::read( const u32 first, const std::span<u64> values ) -> bool
+{
+    // Readback memory is only coherent for the range passed to Map
+    const D3D12_RANGE read_range = {
+        .Begin = u64{ first } * sizeof( u64 ),
+        .End = ( u64{ first } + values.size() ) * sizeof( u64 ),
+    };
+
+    u8*           mapped = nullptr;
+    const HRESULT hr = readback_->Map( 0, &read_range, reinterpret_cast<void**>( &mapped ) );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return false;
+    }
+
+    std::memcpy( values.data(), mapped + read_range.Begin, values.size_bytes() );
+
+    const D3D12_RANGE written_range = { .Begin = 0, .End = 0 };
+    readback_->Unmap( 0, &written_range );
+    return true;
+}
+
+auto GraphicsTimestampQueryPool::get_query_count() const -> u32
+{
+    return query_count_;
+}
+
+auto GraphicsTimestampQueryPool::get_frequency() const -> u64
+{
+    return frequency_;
+}
+
+auto GraphicsTimestampQueryPool::get_calibration() -> std::optional<GpuClockCalibration>
+{
+    u64           gpu_timestamp = 0;
+    u64           qpc = 0;
+    const HRESULT hr = queue_->get_ptr()->GetClockCalibration( &gpu_timestamp, &qpc );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return std::nullopt;
+    }
+
+    // The steady clock counts QueryPerformanceCounter ticks since boot, split to keep the nanoseconds from overflowing
+    const u64 nanoseconds =
+        qpc / qpc_frequency_ * 1'000'000'000 + qpc % qpc_frequency_ * 1'000'000'000 / qpc_frequency_;
+    const auto cpu_time = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::nanoseconds{ static_cast<i64>( nanoseconds ) }
+    );
+
+    return GpuClockCalibration{
+        .gpu_timestamp = gpu_timestamp,
+        .cpu_time = std::chrono::steady_clock::time_point{ cpu_time },
+    };
+}
+
+} // namespace mksv
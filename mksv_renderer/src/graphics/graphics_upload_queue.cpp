@@ -0,0 +1,192 @@
+#include "mksv/graphics/graphics_upload_queue.hpp"
+
+#include "mksv/log.hpp"
+#include "mksv/utils/d3d12_helpers.hpp"
+
+#include <utility>
+
+namespace mksv
+{
+
+auto GraphicsUploadQueue::create( ComPtr<D3D12Device> device, CommandQueue& consumer, const u64 staging_capacity )
+    -> std::unique_ptr<GraphicsUploadQueue>
+{
+    auto queue = CommandQueue::create( device, D3D12_COMMAND_LIST_TYPE_COPY );
+    if ( !queue ) {
+        return nullptr;
+    }
+
+    const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_UPLOAD );
+    const auto res_desc = d3d12::buffer_resource_desc( staging_capacity );
+
+    ComPtr<ID3D12Resource> staging{};
+    HRESULT                hr = device->CreateCommittedResource(
+        &heap_props,
+        D3D12_HEAP_FLAG_CREATE_NOT_ZEROED,
+        &res_desc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS( &staging )
+    );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    u8*               mapped = nullptr;
+    const D3D12_RANGE read_range = { .Begin = 0, .End = 0 };
+    hr = staging->Map( 0, &read_range, reinterpret_cast<void**>( &mapped ) );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    return std::unique_ptr<GraphicsUploadQueue>{ new GraphicsUploadQueue(
+        std::move( device ),
+        consumer,
+        std::move( queue ),
+        std::move( staging ),
+        mapped,
+        staging_capacity
+    ) };
+}
+
+GraphicsUploadQueue::GraphicsUploadQueue(
+    ComPtr<D3D12Device>           device,
+    CommandQueue&                 consumer,
+    std::unique_ptr<CommandQueue> queue,
+    ComPtr<ID3D12Resource>        staging,
+    u8*                           mapped,
+    const u64                     staging_capacity
+)
+    : device_{ std::move( device ) },
+      consumer_{ &consumer },
+      queue_{ std::move( queue ) },
+      staging_{ std::move( staging ) },
+      mapped_{ mapped },
+      staging_capacity_{ staging_capacity }
+{
+}
+
+GraphicsUploadQueue::~GraphicsUploadQueue()
+{
+    queue_->flush();
+    staging_->Unmap( 0, nullptr );
+}
+
+auto GraphicsUploadQueue::get_staging_memory() const -> std::span<u8>
+{
+    return { mapped_, staging_capacity_ };
+}
+
+auto GraphicsUploadQueue::submit( const std::span<const BufferCopy> copies ) -> u64
+{
+    std::optional<Submission> submission = acquire_submission();
+    if ( !submission ) {
+        return 0;
+    }
+
+    D3D12GraphicsCommandList* const command_list = submission->command_list.Get();
+    for ( const BufferCopy& copy : copies ) {
+        command_list->CopyBufferRegion(
+            static_cast<ID3D12Resource*>( copy.destination ),
+            copy.destination_offset,
+            staging_.Get(),
+            copy.staging_offset,
+            copy.size
+        );
+    }
+
+    return execute_submission( std::move( *submission ) );
+}
+
+auto GraphicsUploadQueue::submit_copies( const std::span<const ResourceCopy> copies ) -> u64
+{
+    std::optional<Submission> submission = acquire_submission();
+    if ( !submission ) {
+        return 0;
+    }
+
+    for ( const ResourceCopy& copy : copies ) {
+        submission->command_list->CopyResource( copy.destination, copy.source );
+    }
+
+    return execute_submission( std::move( *submission ) );
+}
+
+auto GraphicsUploadQueue::wait_on_gpu( const u64 fence_value ) -> void
+{
+    consumer_->wait_on_gpu( *queue_, fence_value );
+}
+
+auto GraphicsUploadQueue::get_fence() -> Fence&
+{
+    return *queue_;
+}
+
+auto GraphicsUploadQueue::get_queue() -> CommandQueue&
+{
+    return *queue_;
+}
+
+auto GraphicsUploadQueue::acquire_submission() -> std::optional<Submission>
+{
+    Submission submission{};
+
+    if ( !submissions_.empty() && queue_->is_fence_complete( submissions_.front().fence_value ) ) {
+        submission = std::move( submissions_.front() );
+        submissions_.pop_front();
+    } else {
+        HRESULT hr =
+            device_->CreateCommandAllocator( D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS( &submission.allocator ) );
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+            return std::nullopt;
+        }
+
+        hr = device_->CreateCommandList1(
+            0,
+            D3D12_COMMAND_LIST_TYPE_COPY,
+            D3D12_COMMAND_LIST_FLAG_NONE,
+            IID_PPV_ARGS( &submission.command_list )
+        );
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+            return std::nullopt;
+        }
+    }
+
+    HRESULT hr = submission.allocator->Reset();
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return std::nullopt;
+    }
+
+    hr = submission.command_list->Reset( submission.allocator.Get(), nullptr );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return std::nullopt;
+    }
+
+    return submission;
+}
+
+auto GraphicsUploadQueue::execute_submission( Submission&& submission ) -> u64
+{
+    const HRESULT hr = submission.command_list->Close();
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return 0;
+    }
+
+    queue_->execute( submission.command_list.Get() );
+    submission.fence_value = queue_->signal();
+
+    const u64 fence_value = submission.fence_value;
+    submissions_.push_back( std::move( submission ) );
+    return fence_value;
+}
+
+} // namespace mksv
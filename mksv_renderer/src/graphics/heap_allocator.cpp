@@ -0,0 +1,462 @@
+#include "mksv/graphics/heap_allocator.hpp"
+
+#include "mksv/log.hpp"
+#include "mksv/utils/d3d12_helpers.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace mksv
+{
+
+auto HeapAllocator::create(
+    ComPtr<D3D12Device>  device,
+    Fence&               fence,
+    GraphicsUploadQueue& copy_queue,
+    const u64            heap_size
+) -> std::unique_ptr<HeapAllocator>
+{
+    if ( heap_size == 0 || heap_size % D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT != 0 ) {
+        log_error( L"Heap size must be a non-zero multiple of the MSAA placement alignment" );
+        return nullptr;
+    }
+
+    return std::unique_ptr<HeapAllocator>{ new HeapAllocator( std::move( device ), fence, copy_queue, heap_size ) };
+}
+
+HeapAllocator::HeapAllocator(
+    ComPtr<D3D12Device>  device,
+    Fence&               fence,
+    GraphicsUploadQueue& copy_queue,
+    const u64            heap_size
+)
+    : device_{ std::move( device ) },
+      fence_{ &fence },
+      copy_queue_{ &copy_queue },
+      heap_size_{ heap_size },
+      defragmented_bytes_{ 0 }
+{
+}
+
+auto HeapAllocator::allocate(
+    const D3D12_RESOURCE_DESC&  desc,
+    const D3D12_RESOURCE_STATES initial_state,
+    const D3D12_CLEAR_VALUE*    clear_value
+) -> std::optional<HeapAllocationId>
+{
+    const D3D12_RESOURCE_ALLOCATION_INFO info = device_->GetResourceAllocationInfo( 0, 1, &desc );
+    if ( info.SizeInBytes == UINT64_MAX ) {
+        log_error( L"Invalid description for a placed resource" );
+        return std::nullopt;
+    }
+
+    const u32 pool = pool_index( desc );
+    const u64 alignment = std::max( info.Alignment, pool_alignment( pool ) );
+
+    std::scoped_lock lock{ mutex_ };
+
+    Page*                         page = nullptr;
+    std::optional<TlsfAllocation> allocation{};
+    for ( const auto& candidate : pools_[pool] ) {
+        allocation = candidate->allocator.allocate( info.SizeInBytes, alignment );
+        if ( allocation ) {
+            page = candidate.get();
+            break;
+        }
+    }
+
+    if ( !allocation ) {
+        page = create_page( pool, info.SizeInBytes );
+        if ( !page ) {
+            return std::nullopt;
+        }
+
+        allocation = page->allocator.allocate( info.SizeInBytes, alignment );
+        if ( !allocation ) {
+            return std::nullopt;
+        }
+    }
+
+    auto resource = create_placed_resource( *page, allocation->offset, desc, initial_state, clear_value );
+    if ( !resource ) {
+        page->allocator.free( allocation->block );
+        return std::nullopt;
+    }
+
+    HeapAllocationId id = INVALID_ALLOCATION;
+    if ( !free_ids_.empty() ) {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+    } else {
+        id = static_cast<HeapAllocationId>( records_.size() );
+        records_.emplace_back();
+    }
+
+    records_[id] = Record{
+        .resource = std::move( resource ),
+        .desc = desc,
+        .clear_value = clear_value ? std::optional{ *clear_value } : std::nullopt,
+        .state = initial_state,
+        .pool = pool,
+        .alignment = alignment,
+        .page = page,
+        .allocation = *allocation,
+        .moving = false,
+    };
+
+    return id;
+}
+
+auto HeapAllocator::release( const HeapAllocationId id ) -> void
+{
+    std::scoped_lock lock{ mutex_ };
+
+    assert( id < records_.size() && records_[id] );
+    Record& record = *records_[id];
+
+    if ( record.moving ) {
+        for ( PendingMove& move : pending_moves_ ) {
+            if ( move.id == id ) {
+                move.id = INVALID_ALLOCATION;
+            }
+        }
+    }
+
+    pending_releases_.push_back( {
+        .resource = std::move( record.resource ),
+        .page = record.page,
+        .block = record.allocation.block,
+        .fence_value = OPEN_BATCH,
+    } );
+
+    records_[id].reset();
+    free_ids_.push_back( id );
+}
+
+auto HeapAllocator::get_resource( const HeapAllocationId id ) const -> ID3D12Resource*
+{
+    std::scoped_lock lock{ mutex_ };
+
+    assert( id < records_.size() && records_[id] );
+    return records_[id]->resource.Get();
+}
+
+auto HeapAllocator::set_state( const HeapAllocationId id, const D3D12_RESOURCE_STATES state ) -> void
+{
+    std::scoped_lock lock{ mutex_ };
+
+    assert( id < records_.size() && records_[id] );
+    records_[id]->state = state;
+}
+
+auto HeapAllocator::defragment( const u64 max_bytes ) -> u32
+{
+    std::scoped_lock lock{ mutex_ };
+
+    // Only buffers are moved, see the header. There are no MSAA buffers, so that is a single pool.
+    const u32 pool = static_cast<u32>( HeapCategory::Buffer ) * 2;
+
+    // The least used heap is the cheapest to empty, fill the most used ones first so the moves pack tightly
+    std::vector<Page*> targets{};
+    for ( const auto& page : pools_[pool] ) {
+        if ( !page->allocator.is_empty() ) {
+            targets.push_back( page.get() );
+        }
+    }
+
+    if ( targets.size() < 2 ) {
+        return 0;
+    }
+
+    std::ranges::sort( targets, std::ranges::greater{}, []( const Page* page ) {
+        return page->allocator.get_used();
+    } );
+
+    Page* const source = targets.back();
+    targets.pop_back();
+
+    u64 target_free = 0;
+    for ( const Page* page : targets ) {
+        target_free += page->allocator.get_capacity() - page->allocator.get_used();
+    }
+
+    // Partially emptying a heap only shuffles memory around
+    if ( target_free < source->allocator.get_used() ) {
+        return 0;
+    }
+
+    std::vector<PendingMove> moves{};
+    u64                      moved_bytes = 0;
+
+    for ( HeapAllocationId id = 0; id < records_.size() && moved_bytes < max_bytes; ++id ) {
+        auto& record = records_[id];
+        if ( !record || record->page != source || record->moving ) {
+            continue;
+        }
+
+        // The copy queue only promotes from and decays to the common state, anything else needs a barrier on the
+        // direct queue first
+        assert( record->desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER );
+        if ( record->state != D3D12_RESOURCE_STATE_COMMON ) {
+            continue;
+        }
+
+        for ( Page* page : targets ) {
+            const auto allocation = page->allocator.allocate( record->allocation.size, record->alignment );
+            if ( !allocation ) {
+                continue;
+            }
+
+            auto resource = create_placed_resource(
+                *page,
+                allocation->offset,
+                record->desc,
+                D3D12_RESOURCE_STATE_COMMON,
+                record->clear_value ? &*record->clear_value : nullptr
+            );
+
+            if ( !resource ) {
+                page->allocator.free( allocation->block );
+                break;
+            }
+
+            moves.push_back( {
+                .id = id,
+                .source = record->resource,
+                .resource = std::move( resource ),
+                .page = page,
+                .allocation = *allocation,
+                .copy_fence_value = 0,
+            } );
+            moved_bytes += allocation->size;
+            break;
+        }
+    }
+
+    if ( moves.empty() ) {
+        return 0;
+    }
+
+    std::vector<ResourceCopy> copies{};
+    copies.reserve( moves.size() );
+    for ( const PendingMove& move : moves ) {
+        copies.push_back( { .destination = move.resource.Get(), .source = move.source.Get() } );
+    }
+
+    const u64 copy_fence_value = copy_queue_->submit_copies( copies );
+    if ( copy_fence_value == 0 ) {
+        for ( const PendingMove& move : moves ) {
+            move.page->allocator.free( move.allocation.block );
+        }
+        return 0;
+    }
+
+    for ( PendingMove& move : moves ) {
+        records_[move.id]->moving = true;
+        move.copy_fence_value = copy_fence_value;
+        pending_moves_.push_back( std::move( move ) );
+    }
+
+    defragmented_bytes_ += moved_bytes;
+    return static_cast<u32>( moves.size() );
+}
+
+auto HeapAllocator::submit( const u64 fence_value ) -> void
+{
+    std::scoped_lock lock{ mutex_ };
+
+    for ( PendingRelease& release : pending_releases_ ) {
+        if ( release.fence_value == OPEN_BATCH ) {
+            release.fence_value = fence_value;
+        }
+    }
+}
+
+auto HeapAllocator::retire() -> u32
+{
+    const u64 completed = fence_->get_completed_value();
+    const u64 copy_completed = copy_queue_->get_fence().get_completed_value();
+
+    std::scoped_lock lock{ mutex_ };
+
+    std::erase_if( pending_releases_, [completed]( const PendingRelease& release ) {
+        if ( release.fence_value == OPEN_BATCH || release.fence_value > completed ) {
+            return false;
+        }
+
+        release.page->allocator.free( release.block );
+        return true;
+    } );
+
+    // The direct queue may still read the old resource in frames in flight, it is released with the next submit
+    u32 swapped = 0;
+    std::erase_if( pending_moves_, [this, copy_completed, &swapped]( PendingMove& move ) {
+        if ( move.copy_fence_value > copy_completed ) {
+            return false;
+        }
+
+        // Nothing but the copy used the new resource of a move that was released in the meantime
+        if ( move.id == INVALID_ALLOCATION ) {
+            move.page->allocator.free( move.allocation.block );
+            return true;
+        }
+
+        Record& record = *records_[move.id];
+        pending_releases_.push_back( {
+            .resource = std::move( record.resource ),
+            .page = record.page,
+            .block = record.allocation.block,
+            .fence_value = OPEN_BATCH,
+        } );
+
+        record.resource = std::move( move.resource );
+        record.page = move.page;
+        record.allocation = move.allocation;
+        record.moving = false;
+        ++swapped;
+        return true;
+    } );
+
+    release_empty_pages();
+    return swapped;
+}
+
+auto HeapAllocator::get_stats() const -> HeapAllocatorStats
+{
+    std::scoped_lock lock{ mutex_ };
+
+    HeapAllocatorStats stats = {
+        .heap_count = 0,
+        .reserved = 0,
+        .used = 0,
+        .largest_free_block = 0,
+        .allocation_count = 0,
+        .free_block_count = 0,
+        .fragmentation = 0.0f,
+        .defragmented_bytes = defragmented_bytes_,
+    };
+
+    f32 weighted_fragmentation = 0.0f;
+    for ( const auto& pages : pools_ ) {
+        for ( const auto& page : pages ) {
+            const TlsfStats page_stats = page->allocator.get_stats();
+            const u64       free = page_stats.capacity - page_stats.used;
+
+            ++stats.heap_count;
+            stats.reserved += page_stats.capacity;
+            stats.used += page_stats.used;
+            stats.largest_free_block = std::max( stats.largest_free_block, page_stats.largest_free_block );
+            stats.allocation_count += page_stats.allocation_count;
+            stats.free_block_count += page_stats.free_block_count;
+            weighted_fragmentation += page_stats.fragmentation * static_cast<f32>( free );
+        }
+    }
+
+    const u64 free = stats.reserved - stats.used;
+    if ( free > 0 ) {
+        stats.fragmentation = weighted_fragmentation / static_cast<f32>( free );
+    }
+
+    return stats;
+}
+
+auto HeapAllocator::pool_index( const D3D12_RESOURCE_DESC& desc ) -> u32
+{
+    HeapCategory category = HeapCategory::Texture;
+    if ( desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER ) {
+        category = HeapCategory::Buffer;
+    } else if ( desc.Flags &
+                ( D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL ) ) {
+        category = HeapCategory::RenderTarget;
+    }
+
+    const u32 msaa = desc.SampleDesc.Count > 1 ? 1 : 0;
+    return static_cast<u32>( category ) * 2 + msaa;
+}
+
+auto HeapAllocator::pool_alignment( const u32 pool ) -> u64
+{
+    return pool % 2 == 1 ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+}
+
+auto HeapAllocator::pool_heap_flags( const u32 pool ) -> D3D12_HEAP_FLAGS
+{
+    switch ( static_cast<HeapCategory>( pool / 2 ) ) {
+        case HeapCategory::Buffer:
+            return D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS | D3D12_HEAP_FLAG_CREATE_NOT_ZEROED;
+        case HeapCategory::Texture:
+            return D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES | D3D12_HEAP_FLAG_CREATE_NOT_ZEROED;
+        default:
+            return D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES | D3D12_HEAP_FLAG_CREATE_NOT_ZEROED;
+    }
+}
+
+auto HeapAllocator::create_page( const u32 pool, const u64 min_size ) -> Page*
+{
+    const u64 alignment = pool_alignment( pool );
+    const u64 size = std::max( heap_size_, ( min_size + alignment - 1 ) & ~( alignment - 1 ) );
+
+    const D3D12_HEAP_DESC desc = {
+        .SizeInBytes = size,
+        .Properties = d3d12::heap_properties( D3D12_HEAP_TYPE_DEFAULT ),
+        .Alignment = alignment,
+        .Flags = pool_heap_flags( pool ),
+    };
+
+    ComPtr<ID3D12Heap> heap{};
+    const HRESULT      hr = device_->CreateHeap( &desc, IID_PPV_ARGS( &heap ) );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    // Allocations are tracked at buffer placement granularity, the MSAA pools only raise the alignment
+    auto page = std::make_unique<Page>(
+        std::move( heap ), TlsfAllocator{ size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT }
+    );
+    return pools_[pool].emplace_back( std::move( page ) ).get();
+}
+
+auto HeapAllocator::create_placed_resource(
+    Page&                       page,
+    const u64                   offset,
+    const D3D12_RESOURCE_DESC&  desc,
+    const D3D12_RESOURCE_STATES state,
+    const D3D12_CLEAR_VALUE*    clear_value
+) -> ComPtr<ID3D12Resource>
+{
+    ComPtr<ID3D12Resource> resource{};
+    const HRESULT          hr =
+        device_->CreatePlacedResource( page.heap.Get(), offset, &desc, state, clear_value, IID_PPV_ARGS( &resource ) );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    return resource;
+}
+
+// Keeps one empty heap per pool around so that a single alloc/free pattern does not recreate heaps every frame
+auto HeapAllocator::release_empty_pages() -> void
+{
+    for ( auto& pages : pools_ ) {
+        bool kept_empty = false;
+        std::erase_if( pages, [&kept_empty]( const std::unique_ptr<Page>& page ) {
+            if ( !page->allocator.is_empty() ) {
+                return false;
+            }
+
+            if ( !kept_empty ) {
+                kept_empty = true;
+                return false;
+            }
+
+            return true;
+        } );
+    }
+}
+
+} // namespace mksv
@@ -0,0 +1,119 @@
+#include "mksv/graphics/index_free_list.hpp"
+
+#include <cassert>
+
+namespace mksv
+{
+
+IndexFreeList::IndexFreeList( const u32 capacity, const bool filled )
+    : capacity_{ capacity },
+      next_{ std::make_unique<std::atomic<u32>[]>( capacity ) },
+      head_{ pack( 0, INVALID_INDEX ) },
+      size_{ 0 }
+{
+    assert( capacity < INVALID_INDEX );
+
+    for ( u32 i = 0; i < capacity; ++i ) {
+        next_[i].store( filled && i + 1 < capacity ? i + 1 : INVALID_INDEX, std::memory_order_relaxed );
+    }
+
+    if ( filled && capacity > 0 ) {
+        head_.store( pack( 0, 0 ), std::memory_order_relaxed );
+        size_.store( capacity, std::memory_order_relaxed );
+    }
+}
+
+auto IndexFreeList::pop() -> std::optional<u32>
+{
+    u64 head = head_.load( std::memory_order_acquire );
+    while ( true ) {
+        const u32 index = index_of( head );
+        if ( index == INVALID_INDEX ) {
+            return std::nullopt;
+        }
+
+        // May read a stale link if index is popped concurrently, the tag makes the exchange below fail in that case
+        const u32 next = next_[index].load( std::memory_order_relaxed );
+        if ( head_.compare_exchange_weak(
+                 head,
+                 pack( tag_of( head ) + 1, next ),
+                 std::memory_order_acq_rel,
+                 std::memory_order_acquire
+             ) ) {
+            size_.fetch_sub( 1, std::memory_order_relaxed );
+            return index;
+        }
+    }
+}
+
+auto IndexFreeList::push( const u32 index ) -> void
+{
+    assert( index < capacity_ );
+
+    // Counted before the index becomes visible so a racing pop can never take the size below zero
+    size_.fetch_add( 1, std::memory_order_relaxed );
+
+    u64 head = head_.load( std::memory_order_relaxed );
+    do {
+        next_[index].store( index_of( head ), std::memory_order_relaxed );
+    } while ( !head_.compare_exchange_weak(
+        head,
+        pack( tag_of( head ) + 1, index ),
+        std::memory_order_release,
+        std::memory_order_relaxed
+    ) );
+}
+
+auto IndexFreeList::take_all() -> u32
+{
+    u64 head = head_.load( std::memory_order_relaxed );
+    while ( !head_.compare_exchange_weak(
+        head,
+        pack( tag_of( head ) + 1, INVALID_INDEX ),
+        std::memory_order_acq_rel,
+        std::memory_order_relaxed
+    ) ) {
+    }
+
+    // Pushes racing with this exchange either land in the detached chain or in the new list, never in both
+    u32 count = 0;
+    for ( u32 index = index_of( head ); index != INVALID_INDEX; index = get_next( index ) ) {
+        ++count;
+    }
+    size_.fetch_sub( count, std::memory_order_relaxed );
+
+    return index_of( head );
+}
+
+auto IndexFreeList::get_next( const u32 index ) const -> u32
+{
+    assert( index < capacity_ );
+    return next_[index].load( std::memory_order_relaxed );
+}
+
+auto IndexFreeList::get_capacity() const -> u32
+{
+    return capacity_;
+}
+
+auto IndexFreeList::get_size() const -> u32
+{
+    return size_.load( std::memory_order_relaxed );
+}
+
+auto IndexFreeList::pack( const u32 tag, const u32 index ) -> u64
+{
+    return ( static_cast<u64>( tag ) << 32 ) | index;
+}
+
+auto IndexFreeList::index_of( const u64 head ) -> u32
+{
+    return static_cast<u32>( head );
+}
+
+auto IndexFreeList::tag_of( const u64 head ) -> u32
+{
+    return static_cast<u32>( head >> 32 );
+}
+
+} // namespace mksv
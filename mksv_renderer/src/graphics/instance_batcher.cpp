@@ -0,0 +1,149 @@
+#include "mksv/graphics/instance_batcher.hpp"
+
+#include "mksv/profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mksv
+{
+
+InstanceBatcher::InstanceBatcher()
+    : instance_address_{ 0 }
+{
+}
+
+auto InstanceBatcher::reset() -> void
+{
+    group_lookup_.clear();
+    groups_.clear();
+    runs_.clear();
+    transforms_.clear();
+    batches_.clear();
+    instance_address_ = 0;
+}
+
+auto InstanceBatcher::add( const u32 mesh, const u32 pipeline, const mat4& transform ) -> void
+{
+    const u32 group = find_group( mesh, pipeline );
+    append_run( group, 1 );
+    transforms_.push_back( transform );
+}
+
+auto InstanceBatcher::add( const u32 mesh, const u32 pipeline, const std::span<const mat4> transforms ) -> void
+{
+    if ( transforms.empty() ) {
+        return;
+    }
+
+    const u32 group = find_group( mesh, pipeline );
+    append_run( group, static_cast<u32>( transforms.size() ) );
+    transforms_.insert( transforms_.end(), transforms.begin(), transforms.end() );
+}
+
+auto InstanceBatcher::build( UploadRing& ring ) -> bool
+{
+    MKSV_PROFILE_ZONE( "InstanceBatcher::build" );
+
+    batches_.clear();
+    instance_address_ = 0;
+
+    if ( transforms_.empty() ) {
+        return true;
+    }
+
+    // first_instance holds the group index until the batches are sorted
+    for ( u32 i = 0; i < groups_.size(); ++i ) {
+        batches_.push_back( InstanceBatch{
+            .mesh = groups_[i].mesh,
+            .pipeline = groups_[i].pipeline,
+            .first_instance = i,
+            .instance_count = groups_[i].instance_count,
+        } );
+    }
+
+    std::ranges::sort( batches_, []( const InstanceBatch& a, const InstanceBatch& b ) {
+        return a.pipeline != b.pipeline ? a.pipeline < b.pipeline : a.mesh < b.mesh;
+    } );
+
+    u32 first_instance = 0;
+    for ( InstanceBatch& batch : batches_ ) {
+        groups_[batch.first_instance].next_instance = first_instance;
+        batch.first_instance = first_instance;
+        first_instance += batch.instance_count;
+    }
+
+    const auto allocation = ring.allocate( transforms_.size() * INSTANCE_STRIDE );
+    if ( !allocation ) {
+        batches_.clear();
+        return false;
+    }
+
+    // Upload heaps are write combined, every run goes out as one sequential copy
+    for ( const Run& run : runs_ ) {
+        Group& group = groups_[run.group];
+        std::memcpy(
+            allocation->cpu_address + u64{ group.next_instance } * INSTANCE_STRIDE,
+            transforms_.data() + run.first,
+            u64{ run.count } * INSTANCE_STRIDE
+        );
+        group.next_instance += run.count;
+    }
+
+    instance_address_ = allocation->gpu_address;
+    return true;
+}
+
+auto InstanceBatcher::get_batches() const -> std::span<const InstanceBatch>
+{
+    return batches_;
+}
+
+auto InstanceBatcher::get_instance_count() const -> u32
+{
+    return static_cast<u32>( transforms_.size() );
+}
+
+auto InstanceBatcher::get_instance_address( const InstanceBatch& batch ) const -> D3D12_GPU_VIRTUAL_ADDRESS
+{
+    return get_instance_address( batch.first_instance );
+}
+
+auto InstanceBatcher::get_instance_address( const u32 instance ) const -> D3D12_GPU_VIRTUAL_ADDRESS
+{
+    return instance_address_ + u64{ instance } * INSTANCE_STRIDE;
+}
+
+auto InstanceBatcher::find_group( const u32 mesh, const u32 pipeline ) -> u32
+{
+    // Sorted submissions add one object after the other to the same group, those skip the lookup
+    if ( !runs_.empty() ) {
+        const Group& last = groups_[runs_.back().group];
+        if ( last.mesh == mesh && last.pipeline == pipeline ) {
+            return runs_.back().group;
+        }
+    }
+
+    const u64 key = ( u64{ pipeline } << 32 ) | mesh;
+
+    const auto [it, inserted] = group_lookup_.try_emplace( key, static_cast<u32>( groups_.size() ) );
+    if ( inserted ) {
+        groups_.push_back( Group{ .mesh = mesh, .pipeline = pipeline, .instance_count = 0, .next_instance = 0 } );
+    }
+
+    return it->second;
+}
+
+auto InstanceBatcher::append_run( const u32 group, const u32 count ) -> void
+{
+    groups_[group].instance_count += count;
+
+    if ( !runs_.empty() && runs_.back().group == group ) {
+        runs_.back().count += count;
+        return;
+    }
+
+    runs_.push_back( Run{ .group = group, .first = static_cast<u32>( transforms_.size() ), .count = count } );
+}
+
+} // namespace mksv
@@ -0,0 +1,115 @@
+#include "mksv/graphics/mock_command_list_pool.hpp"
+
+#include <cassert>
+
+namespace mksv
+{
+
+MockCommandListPool::MockCommandListPool( const u32 worker_count )
+    : workers_( worker_count ),
+      frame_index_{ 0 },
+      error_count_{ 0 }
+{
+    for ( Worker& worker : workers_ ) {
+        worker.used = 0;
+        worker.recording = false;
+    }
+}
+
+auto MockCommandListPool::get_list( const CommandListHandle list ) -> MockCommandList&
+{
+    assert( list );
+    return *static_cast<MockCommandList*>( list );
+}
+
+auto MockCommandListPool::begin_frame( const u32 frame_index ) -> bool
+{
+    frame_index_ = frame_index;
+
+    for ( Worker& worker : workers_ ) {
+        if ( worker.recording ) {
+            error_count_.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        worker.used = 0;
+        worker.recording = false;
+    }
+
+    return true;
+}
+
+auto MockCommandListPool::open( const u32 worker ) -> CommandListHandle
+{
+    if ( worker >= workers_.size() ) {
+        error_count_.fetch_add( 1, std::memory_order_relaxed );
+        return nullptr;
+    }
+
+    Worker& state = workers_[worker];
+    if ( state.recording ) {
+        error_count_.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    if ( state.used == state.lists.size() ) {
+        state.lists.emplace_back();
+    }
+
+    MockCommandList& list = state.lists[state.used++];
+    list.worker = worker;
+    list.frame_index = frame_index_;
+    list.open = true;
+    list.commands.clear();
+
+    state.recording = true;
+    return &list;
+}
+
+auto MockCommandListPool::close( const u32 worker, const CommandListHandle list ) -> bool
+{
+    MockCommandList& closed = get_list( list );
+    if ( worker >= workers_.size() || closed.worker != worker || !closed.open ) {
+        error_count_.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+
+    closed.open = false;
+    workers_[worker].recording = false;
+    return true;
+}
+
+auto MockCommandListPool::submit( const std::span<const CommandListHandle> lists ) -> void
+{
+    std::vector<MockCommandList>& submission = submissions_.emplace_back();
+    submission.reserve( lists.size() );
+
+    for ( const CommandListHandle list : lists ) {
+        const MockCommandList& submitted = get_list( list );
+        if ( submitted.open ) {
+            error_count_.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        submission.push_back( submitted );
+    }
+}
+
+auto MockCommandListPool::get_worker_count() const -> u32
+{
+    return static_cast<u32>( workers_.size() );
+}
+
+auto MockCommandListPool::get_submissions() const -> const std::vector<std::vector<MockCommandList>>&
+{
+    return submissions_;
+}
+
+auto MockCommandListPool::get_error_count() const -> u32
+{
+    return error_count_.load( std::memory_order_relaxed );
+}
+
+auto MockCommandListPool::get_list_count( const u32 worker ) const -> usize
+{
+    return workers_[worker].lists.size();
+}
+
+} // namespace mksv
@@ -0,0 +1,52 @@
+#include "mksv/graphics/mock_fence.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace mksv
+{
+
+auto MockFence::signal() -> u64
+{
+    return ++signaled_value_;
+}
+
+auto MockFence::get_completed_value() const -> u64
+{
+    return completed_value_;
+}
+
+auto MockFence::wait_for_value( const u64 value ) -> bool
+{
+    assert( value <= signaled_value_ && "Waiting on a value that was never signaled" );
+
+    ++wait_count_;
+    if ( completed_value_ < value ) {
+        ++stall_count_;
+        completed_value_ = value;
+    }
+
+    return true;
+}
+
+auto MockFence::complete_up_to( const u64 value ) -> void
+{
+    completed_value_ = std::max( completed_value_, std::min( value, signaled_value_ ) );
+}
+
+auto MockFence::get_signaled_value() const -> u64
+{
+    return signaled_value_;
+}
+
+auto MockFence::get_wait_count() const -> u64
+{
+    return wait_count_;
+}
+
+auto MockFence::get_stall_count() const -> u64
+{
+    return stall_count_;
+}
+
+} // namespace mksv
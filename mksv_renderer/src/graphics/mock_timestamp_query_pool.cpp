@@ -0,0 +1,85 @@
+#include "mksv/graphics/mock_timestamp_query_pool.hpp"
+
+#include <algorithm>
+
+namespace mksv
+{
+
+MockTimestampQueryPool::MockTimestampQueryPool( const u32 query_count, const u64 frequency )
+    : queries_( query_count, 0 ),
+      readback_( query_count, 0 ),
+      frequency_{ frequency },
+      gpu_timestamp_{ 0 },
+      calibration_{ .gpu_timestamp = 0, .cpu_time = std::chrono::steady_clock::now() },
+      error_count_{ 0 }
+{
+}
+
+auto MockTimestampQueryPool::write( [[maybe_unused]] const CommandListHandle list, const u32 query ) -> void
+{
+    if ( query >= queries_.size() ) {
+        ++error_count_;
+        return;
+    }
+
+    queries_[query] = gpu_timestamp_;
+}
+
+auto MockTimestampQueryPool::resolve( [[maybe_unused]] const CommandListHandle list, const u32 first, const u32 count )
+    -> void
+{
+    if ( first > queries_.size() || count > queries_.size() - first ) {
+        ++error_count_;
+        return;
+    }
+
+    std::copy_n( queries_.begin() + first, count, readback_.begin() + first );
+}
+
+auto MockTimestampQueryPool::read( const u32 first, const std::span<u64> values ) -> bool
+{
+    if ( first > readback_.size() || values.size() > readback_.size() - first ) {
+        ++error_count_;
+        return false;
+    }
+
+    std::copy_n( readback_.begin() + first, values.size(), values.begin() );
+    return true;
+}
+
+auto MockTimestampQueryPool::get_query_count() const -> u32
+{
+    return static_cast<u32>( queries_.size() );
+}
+
+auto MockTimestampQueryPool::get_frequency() const -> u64
+{
+    return frequency_;
+}
+
+auto MockTimestampQueryPool::get_calibration() -> std::optional<GpuClockCalibration>
+{
+    return calibration_;
+}
+
+auto MockTimestampQueryPool::advance( const u64 ticks ) -> void
+{
+    gpu_timestamp_ += ticks;
+}
+
+auto MockTimestampQueryPool::get_gpu_timestamp() const -> u64
+{
+    return gpu_timestamp_;
+}
+
+auto MockTimestampQueryPool::set_calibration( const GpuClockCalibration& calibration ) -> void
+{
+    calibration_ = calibration;
+}
+
+auto MockTimestampQueryPool::get_error_count() const -> u32
+{
+    return error_count_;
+}
+
+} // namespace mksv
@@ -0,0 +1,63 @@
+#include "mksv/graphics/mock_upload_queue.hpp"
+
+#include <cassert>
+
+namespace mksv
+{
+
+MockUploadQueue::MockUploadQueue( const u64 staging_capacity )
+    : staging_( staging_capacity )
+{
+}
+
+auto MockUploadQueue::get_staging_memory() const -> std::span<u8>
+{
+    return staging_;
+}
+
+auto MockUploadQueue::submit( const std::span<const BufferCopy> copies ) -> u64
+{
+    MockUploadSubmission& submission = submissions_.emplace_back();
+    submission.copies.reserve( copies.size() );
+
+    for ( const BufferCopy& copy : copies ) {
+        assert( copy.staging_offset + copy.size <= staging_.size() && "Copy reads past the staging memory" );
+
+        const auto first = staging_.begin() + static_cast<isize>( copy.staging_offset );
+        submission.copies.push_back( {
+            .copy = copy,
+            .data = { first, first + static_cast<isize>( copy.size ) },
+        } );
+    }
+
+    submission.fence_value = fence_.signal();
+    return submission.fence_value;
+}
+
+auto MockUploadQueue::wait_on_gpu( const u64 fence_value ) -> void
+{
+    assert( fence_value <= fence_.get_signaled_value() && "Waiting on a value that was never signaled" );
+    gpu_waits_.push_back( fence_value );
+}
+
+auto MockUploadQueue::get_fence() -> Fence&
+{
+    return fence_;
+}
+
+auto MockUploadQueue::get_mock_fence() -> MockFence&
+{
+    return fence_;
+}
+
+auto MockUploadQueue::get_submissions() const -> const std::vector<MockUploadSubmission>&
+{
+    return submissions_;
+}
+
+auto MockUploadQueue::get_gpu_waits() const -> const std::vector<u64>&
+{
+    return gpu_waits_;
+}
+
+} // namespace mksv
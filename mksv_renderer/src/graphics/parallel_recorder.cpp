@@ -0,0 +1,181 @@
+#include "mksv/graphics/parallel_recorder.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace mksv
+{
+
+auto ParallelRecorder::create( const u32 worker_count, const u32 min_chunk_size ) -> std::unique_ptr<ParallelRecorder>
+{
+    u32 workers = worker_count;
+    if ( workers == 0 ) {
+        workers = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
+    return std::unique_ptr<ParallelRecorder>{ new ParallelRecorder( workers, std::max( 1u, min_chunk_size ) ) };
+}
+
+auto ParallelRecorder::split(
+    const u32               draw_count,
+    const u32               worker_count,
+    const u32               min_chunk_size,
+    std::vector<DrawChunk>& out
+) -> void
+{
+    out.clear();
+    if ( draw_count == 0 ) {
+        return;
+    }
+
+    const u32 max_chunks = std::max( 1u, worker_count * CHUNKS_PER_WORKER );
+    const u32 chunk_count = std::clamp( draw_count / std::max( 1u, min_chunk_size ), 1u, max_chunks );
+    const u32 base = draw_count / chunk_count;
+    const u32 remainder = draw_count % chunk_count;
+
+    u32 first = 0;
+    for ( u32 i = 0; i < chunk_count; ++i ) {
+        const u32 count = base + ( i < remainder ? 1 : 0 );
+        out.push_back( { first, count } );
+        first += count;
+    }
+}
+
+ParallelRecorder::ParallelRecorder( const u32 worker_count, const u32 min_chunk_size )
+    : worker_count_{ worker_count },
+      min_chunk_size_{ min_chunk_size },
+      pool_{ nullptr },
+      jobs_{ nullptr },
+      list_{ nullptr },
+      failed_{ false }
+{
+}
+
+auto ParallelRecorder::begin( CommandListPool& pool, JobSystem* const jobs ) -> void
+{
+    assert( pool.get_worker_count() >= worker_count_ && "The pool has fewer workers than the recorder" );
+    assert( ( !jobs || jobs->get_worker_count() < worker_count_ ) && "The recorder has fewer workers than the jobs" );
+    assert( !list_ && "begin called before the previous frame finished" );
+
+    pool_ = &pool;
+    jobs_ = jobs;
+    batch_.clear();
+}
+
+auto ParallelRecorder::get_list() -> CommandListHandle
+{
+    assert( pool_ && "get_list called outside of begin and finish" );
+
+    if ( !list_ ) {
+        list_ = pool_->open( 0 );
+    }
+
+    return list_;
+}
+
+auto ParallelRecorder::record( const u32 draw_count, const RecordChunk& record ) -> bool
+{
+    split( draw_count, worker_count_, min_chunk_size_, chunks_ );
+    if ( chunks_.empty() ) {
+        return true;
+    }
+
+    // Not worth a list of its own, and the serial list may already have the state the draws need
+    if ( chunks_.size() == 1 ) {
+        const CommandListHandle list = get_list();
+        if ( !list ) {
+            return false;
+        }
+
+        record( list, chunks_.front() );
+        return true;
+    }
+
+    // The calling thread records chunks as worker 0, which can only have one list open
+    if ( !close_list() ) {
+        return false;
+    }
+
+    chunk_lists_.assign( chunks_.size(), nullptr );
+    failed_.store( false, std::memory_order_relaxed );
+
+    const u32 chunk_count = static_cast<u32>( chunks_.size() );
+    if ( !jobs_ ) {
+        for ( u32 chunk = 0; chunk < chunk_count; ++chunk ) {
+            record_chunk( 0, chunk, record );
+        }
+    } else {
+        jobs_->parallel_for( chunk_count, 1, [this, &record]( const u32 first, const u32 count ) {
+            const u32 index = jobs_->get_worker_index();
+            const u32 worker = index == JobSystem::INVALID_WORKER ? 0 : index + 1;
+            for ( u32 chunk = first; chunk < first + count; ++chunk ) {
+                record_chunk( worker, chunk, record );
+            }
+        } );
+    }
+
+    batch_.insert( batch_.end(), chunk_lists_.begin(), chunk_lists_.end() );
+
+    return !failed_.load( std::memory_order_relaxed );
+}
+
+auto ParallelRecorder::finish() -> bool
+{
+    const bool closed = close_list();
+    pool_ = nullptr;
+    jobs_ = nullptr;
+    return closed;
+}
+
+auto ParallelRecorder::get_batch() const -> std::span<const CommandListHandle>
+{
+    return batch_;
+}
+
+auto ParallelRecorder::get_worker_count() const -> u32
+{
+    return worker_count_;
+}
+
+auto ParallelRecorder::get_min_chunk_size() const -> u32
+{
+    return min_chunk_size_;
+}
+
+auto ParallelRecorder::close_list() -> bool
+{
+    if ( !list_ ) {
+        return true;
+    }
+
+    const CommandListHandle list = list_;
+    list_ = nullptr;
+    if ( !pool_->close( 0, list ) ) {
+        return false;
+    }
+
+    batch_.push_back( list );
+    return true;
+}
+
+// Failed chunks leave a null list behind, record() reports the failure and the batch must not be submitted
+auto ParallelRecorder::record_chunk( const u32 worker, const u32 chunk, const RecordChunk& record ) -> void
+{
+    const CommandListHandle list = pool_->open( worker );
+    if ( !list ) {
+        failed_.store( true, std::memory_order_relaxed );
+        return;
+    }
+
+    record( list, chunks_[chunk] );
+
+    if ( !pool_->close( worker, list ) ) {
+        failed_.store( true, std::memory_order_relaxed );
+        return;
+    }
+
+    chunk_lists_[chunk] = list;
+}
+
+} // namespace mksv
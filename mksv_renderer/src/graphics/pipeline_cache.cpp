@@ -0,0 +1,700 @@
+#include "mksv/graphics/pipeline_cache.hpp"
+
+#include "mksv/assets/hash.hpp"
+#include "mksv/log.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace mksv
+{
+namespace
+{
+// Collects the fields of a stream one by one, so that padding never takes part in the hash
+class StreamHasher
+{
+public:
+    template <typename T>
+        requires std::is_scalar_v<T>
+    auto add( const T value ) -> void
+    {
+        const usize offset = bytes_.size();
+        bytes_.resize( offset + sizeof( T ) );
+        std::memcpy( bytes_.data() + offset, &value, sizeof( T ) );
+    }
+
+    auto add( const char* str ) -> void
+    {
+        const std::string_view view = str ? str : "";
+        add( view.size() );
+        bytes_.insert( bytes_.end(), view.begin(), view.end() );
+    }
+
+    auto get() const -> u64
+    {
+        return hash_bytes( bytes_.data(), bytes_.size() );
+    }
+
+private:
+    std::vector<u8> bytes_;
+};
+
+// Every DXBC and DXIL container starts with its magic followed by a 16 byte digest of the rest. The digest is zero
+// when the shader was compiled without validation, the whole bytecode is hashed then.
+auto hash_bytecode( const D3D12_SHADER_BYTECODE& bytecode ) -> u64
+{
+    static constexpr usize DIGEST_OFFSET = 4;
+    static constexpr usize DIGEST_SIZE = 16;
+    static constexpr u8    ZERO_DIGEST[DIGEST_SIZE] = {};
+
+    const u8* const bytes = static_cast<const u8*>( bytecode.pShaderBytecode );
+    if ( !bytes || bytecode.BytecodeLength == 0 ) {
+        return 0;
+    }
+
+    if ( bytecode.BytecodeLength >= DIGEST_OFFSET + DIGEST_SIZE && std::memcmp( bytes, "DXBC", DIGEST_OFFSET ) == 0 &&
+         std::memcmp( bytes + DIGEST_OFFSET, ZERO_DIGEST, DIGEST_SIZE ) != 0 ) {
+        return hash_combine( hash_bytes( bytes + DIGEST_OFFSET, DIGEST_SIZE ), bytecode.BytecodeLength );
+    }
+
+    return hash_bytes( bytes, bytecode.BytecodeLength );
+}
+
+auto add_stencil_op( StreamHasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& op ) -> void
+{
+    hasher.add( op.StencilFailOp );
+    hasher.add( op.StencilDepthFailOp );
+    hasher.add( op.StencilPassOp );
+    hasher.add( op.StencilFunc );
+}
+
+// D3D12_DEPTH_STENCIL_DESC1 extends the original with a trailing DepthBoundsTestEnable
+template <typename Desc>
+auto add_depth_stencil( StreamHasher& hasher, const Desc& desc ) -> void
+{
+    hasher.add( desc.DepthEnable );
+    hasher.add( desc.DepthWriteMask );
+    hasher.add( desc.DepthFunc );
+    hasher.add( desc.StencilEnable );
+    hasher.add( desc.StencilReadMask );
+    hasher.add( desc.StencilWriteMask );
+    add_stencil_op( hasher, desc.FrontFace );
+    add_stencil_op( hasher, desc.BackFace );
+}
+
+auto add_blend( StreamHasher& hasher, const D3D12_BLEND_DESC& desc ) -> void
+{
+    hasher.add( desc.AlphaToCoverageEnable );
+    hasher.add( desc.IndependentBlendEnable );
+    for ( const D3D12_RENDER_TARGET_BLEND_DESC& target : desc.RenderTarget ) {
+        hasher.add( target.BlendEnable );
+        hasher.add( target.LogicOpEnable );
+        hasher.add( target.SrcBlend );
+        hasher.add( target.DestBlend );
+        hasher.add( target.BlendOp );
+        hasher.add( target.SrcBlendAlpha );
+        hasher.add( target.DestBlendAlpha );
+        hasher.add( target.BlendOpAlpha );
+        hasher.add( target.LogicOp );
+        hasher.add( target.RenderTargetWriteMask );
+    }
+}
+
+auto add_rasterizer( StreamHasher& hasher, const D3D12_RASTERIZER_DESC& desc ) -> void
+{
+    hasher.add( desc.FillMode );
+    hasher.add( desc.CullMode );
+    hasher.add( desc.FrontCounterClockwise );
+    hasher.add( desc.DepthBias );
+    hasher.add( desc.DepthBiasClamp );
+    hasher.add( desc.SlopeScaledDepthBias );
+    hasher.add( desc.DepthClipEnable );
+    hasher.add( desc.MultisampleEnable );
+    hasher.add( desc.AntialiasedLineEnable );
+    hasher.add( desc.ForcedSampleCount );
+    hasher.add( desc.ConservativeRaster );
+}
+
+auto add_input_layout( StreamHasher& hasher, const D3D12_INPUT_LAYOUT_DESC& desc ) -> void
+{
+    hasher.add( desc.NumElements );
+    for ( u32 i = 0; i < desc.NumElements; ++i ) {
+        const D3D12_INPUT_ELEMENT_DESC& element = desc.pInputElementDescs[i];
+        hasher.add( element.SemanticName );
+        hasher.add( element.SemanticIndex );
+        hasher.add( element.Format );
+        hasher.add( element.InputSlot );
+        hasher.add( element.AlignedByteOffset );
+        hasher.add( element.InputSlotClass );
+        hasher.add( element.InstanceDataStepRate );
+    }
+}
+
+auto add_stream_output( StreamHasher& hasher, const D3D12_STREAM_OUTPUT_DESC& desc ) -> void
+{
+    hasher.add( desc.NumEntries );
+    for ( u32 i = 0; i < desc.NumEntries; ++i ) {
+        const D3D12_SO_DECLARATION_ENTRY& entry = desc.pSODeclaration[i];
+        hasher.add( entry.Stream );
+        hasher.add( entry.SemanticName );
+        hasher.add( entry.SemanticIndex );
+        hasher.add( entry.StartComponent );
+        hasher.add( entry.ComponentCount );
+        hasher.add( entry.OutputSlot );
+    }
+
+    hasher.add( desc.NumStrides );
+    for ( u32 i = 0; i < desc.NumStrides; ++i ) {
+        hasher.add( desc.pBufferStrides[i] );
+    }
+
+    hasher.add( desc.RasterizedStream );
+}
+
+auto add_view_instancing( StreamHasher& hasher, const D3D12_VIEW_INSTANCING_DESC& desc ) -> void
+{
+    hasher.add( desc.ViewInstanceCount );
+    for ( u32 i = 0; i < desc.ViewInstanceCount; ++i ) {
+        hasher.add( desc.pViewInstanceLocations[i].ViewportArrayIndex );
+        hasher.add( desc.pViewInstanceLocations[i].RenderTargetArrayIndex );
+    }
+    hasher.add( desc.Flags );
+}
+
+constexpr auto align_up( const usize value, const usize alignment ) -> usize
+{
+    return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+// Walks a stream laid out like d3d12::PSSSubobject: each subobject starts pointer aligned with its type, followed by
+// its data at the data's own alignment
+class StreamReader
+{
+public:
+    explicit StreamReader( const D3D12_PIPELINE_STATE_STREAM_DESC& desc )
+        : stream_{ static_cast<const u8*>( desc.pPipelineStateSubobjectStream ) },
+          size_{ desc.SizeInBytes },
+          offset_{ 0 }
+    {
+    }
+
+    auto next_type() -> std::optional<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE>
+    {
+        offset_ = align_up( offset_, sizeof( void* ) );
+        if ( offset_ + sizeof( D3D12_PIPELINE_STATE_SUBOBJECT_TYPE ) > size_ ) {
+            return std::nullopt;
+        }
+
+        D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type;
+        std::memcpy( &type, stream_ + offset_, sizeof( type ) );
+        return type;
+    }
+
+    template <typename Inner>
+    auto read() -> const Inner*
+    {
+        const usize inner_offset =
+            align_up( offset_ + sizeof( D3D12_PIPELINE_STATE_SUBOBJECT_TYPE ), alignof( Inner ) );
+        if ( inner_offset + sizeof( Inner ) > size_ ) {
+            return nullptr;
+        }
+
+        offset_ = inner_offset + sizeof( Inner );
+        return reinterpret_cast<const Inner*>( stream_ + inner_offset );
+    }
+
+private:
+    const u8* stream_;
+    usize     size_;
+    usize     offset_;
+};
+
+auto get_adapter_info( DXGIAdapter* adapter ) -> std::optional<std::pair<DXGI_ADAPTER_DESC3, LARGE_INTEGER>>
+{
+    DXGI_ADAPTER_DESC3 adapter_desc{};
+    HRESULT            hr = adapter->GetDesc3( &adapter_desc );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return std::nullopt;
+    }
+
+    // The user mode driver version is only reported through this query
+    LARGE_INTEGER driver_version{};
+    hr = adapter->CheckInterfaceSupport( __uuidof( IDXGIDevice ), &driver_version );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return std::nullopt;
+    }
+
+    return std::pair{ adapter_desc, driver_version };
+}
+} // namespace
+
+auto PipelineCache::create( ComPtr<D3D12Device> device, ComPtr<DXGIAdapter> adapter, std::filesystem::path path )
+    -> std::unique_ptr<PipelineCache>
+{
+    const auto adapter_info = get_adapter_info( adapter.Get() );
+    if ( !adapter_info ) {
+        return nullptr;
+    }
+
+    const auto& [adapter_desc, driver_version] = *adapter_info;
+    const FileHeader header = {
+        .magic = FILE_MAGIC,
+        .version = FILE_VERSION,
+        .vendor_id = adapter_desc.VendorId,
+        .device_id = adapter_desc.DeviceId,
+        .sub_sys_id = adapter_desc.SubSysId,
+        .revision = adapter_desc.Revision,
+        .driver_version = static_cast<u64>( driver_version.QuadPart ),
+        .library_size = 0,
+        .library_hash = 0,
+    };
+
+    std::vector<u8>                library_data = read_library_data( path, header );
+    ComPtr<ID3D12PipelineLibrary1> library{};
+    HRESULT hr = device->CreatePipelineLibrary( library_data.data(), library_data.size(), IID_PPV_ARGS( &library ) );
+
+    // The runtime checks the adapter and driver itself as well, covering drivers that change without a new version
+    if ( hr == D3D12_ERROR_ADAPTER_NOT_FOUND || hr == D3D12_ERROR_DRIVER_VERSION_MISMATCH || hr == E_INVALIDARG ) {
+        log_info( L"Discarding pipeline cache {}, it was built for another device", path.wstring() );
+        library_data.clear();
+        hr = device->CreatePipelineLibrary( nullptr, 0, IID_PPV_ARGS( &library ) );
+    }
+
+    if ( hr == DXGI_ERROR_UNSUPPORTED ) {
+        log_warning( L"Pipeline libraries are not supported, pipelines are only cached in memory" );
+        library = nullptr;
+    } else if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    return std::unique_ptr<PipelineCache>{ new PipelineCache(
+        std::move( device ),
+        std::move( library_data ),
+        std::move( library ),
+        header,
+        std::move( path )
+    ) };
+}
+
+auto PipelineCache::read_library_data( const std::filesystem::path& path, const FileHeader& expected )
+    -> std::vector<u8>
+{
+    std::ifstream file{ path, std::ios::binary | std::ios::ate };
+    if ( !file ) {
+        log_info( L"No pipeline cache at {}, pipelines will be compiled", path.wstring() );
+        return {};
+    }
+
+    const auto file_size = static_cast<u64>( file.tellg() );
+    file.seekg( 0 );
+
+    FileHeader header{};
+    if ( file_size < sizeof( header ) || !file.read( reinterpret_cast<char*>( &header ), sizeof( header ) ) ) {
+        log_warning( L"Discarding pipeline cache {}, it is truncated", path.wstring() );
+        return {};
+    }
+
+    if ( header.magic != expected.magic || header.version != expected.version ) {
+        log_info( L"Discarding pipeline cache {}, it is from another version", path.wstring() );
+        return {};
+    }
+
+    if ( header.vendor_id != expected.vendor_id || header.device_id != expected.device_id ||
+         header.sub_sys_id != expected.sub_sys_id || header.revision != expected.revision ) {
+        log_info( L"Discarding pipeline cache {}, it was built for another adapter", path.wstring() );
+        return {};
+    }
+
+    if ( header.driver_version != expected.driver_version ) {
+        log_info( L"Discarding pipeline cache {}, the driver was updated", path.wstring() );
+        return {};
+    }
+
+    std::vector<u8>       data( file_size - sizeof( header ) );
+    const std::streamsize data_size = static_cast<std::streamsize>( data.size() );
+    if ( header.library_size != data.size() || !file.read( reinterpret_cast<char*>( data.data() ), data_size ) ||
+         hash_bytes( data.data(), data.size() ) != header.library_hash ) {
+        log_warning( L"Discarding pipeline cache {}, it is corrupted", path.wstring() );
+        return {};
+    }
+
+    return data;
+}
+
+PipelineCache::PipelineCache(
+    ComPtr<D3D12Device>            device,
+    std::vector<u8>                library_data,
+    ComPtr<ID3D12PipelineLibrary1> library,
+    const FileHeader&              header,
+    std::filesystem::path          path
+)
+    : device_{ std::move( device ) },
+      library_data_{ std::move( library_data ) },
+      library_{ std::move( library ) },
+      header_{ header },
+      path_{ std::move( path ) },
+      dirty_{ false },
+      memory_hits_{ 0 },
+      library_hits_{ 0 },
+      compiles_{ 0 }
+{
+}
+
+auto PipelineCache::create_root_signature( const void* blob, const usize size ) -> ComPtr<ID3D12RootSignature>
+{
+    const u64 hash = hash_bytes( blob, size );
+
+    std::scoped_lock lock{ mutex_ };
+
+    if ( const auto it = root_signatures_.find( hash ); it != root_signatures_.end() ) {
+        return it->second;
+    }
+
+    ComPtr<ID3D12RootSignature> root_signature{};
+    const HRESULT               hr = device_->CreateRootSignature( 0, blob, size, IID_PPV_ARGS( &root_signature ) );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    root_signatures_.emplace( hash, root_signature );
+    root_signature_hashes_.emplace( root_signature.Get(), hash );
+    return root_signature;
+}
+
+auto PipelineCache::get_pipeline_state( const D3D12_PIPELINE_STATE_STREAM_DESC& desc ) -> ComPtr<ID3D12PipelineState>
+{
+    const std::optional<u64> hash = hash_stream( desc );
+    if ( !hash ) {
+        log_warning( L"Creating a pipeline state that cannot be cached" );
+
+        ComPtr<ID3D12PipelineState> pipeline_state{};
+        const HRESULT               hr = device_->CreatePipelineState( &desc, IID_PPV_ARGS( &pipeline_state ) );
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+            return nullptr;
+        }
+
+        return pipeline_state;
+    }
+
+    {
+        std::unique_lock lock{ mutex_ };
+
+        const auto [it, inserted] = pipelines_.try_emplace( *hash, Entry{ .pipeline_state = nullptr, .ready = false } );
+        if ( !inserted ) {
+            // References into the map stay valid across rehashes, iterators do not
+            Entry& entry = it->second;
+            ready_cv_.wait( lock, [&entry] { return entry.ready; } );
+            if ( entry.pipeline_state ) {
+                ++memory_hits_;
+            }
+            return entry.pipeline_state;
+        }
+    }
+
+    // Failures are kept as well, creating the same stream again would fail the same way
+    ComPtr<ID3D12PipelineState> pipeline_state = load_or_compile( desc, *hash );
+
+    {
+        std::scoped_lock lock{ mutex_ };
+
+        Entry& entry = pipelines_.at( *hash );
+        entry.pipeline_state = pipeline_state;
+        entry.ready = true;
+    }
+
+    ready_cv_.notify_all();
+    return pipeline_state;
+}
+
+auto PipelineCache::load_or_compile( const D3D12_PIPELINE_STATE_STREAM_DESC& desc, const u64 hash )
+    -> ComPtr<ID3D12PipelineState>
+{
+    const std::wstring name = std::format( L"{:016x}", hash );
+
+    ComPtr<ID3D12PipelineState> pipeline_state{};
+    HRESULT                     hr = E_FAIL;
+
+    // Fails with E_INVALIDARG when the library holds no pipeline by that name or one created from another stream
+    if ( library_ ) {
+        hr = library_->LoadPipeline( name.c_str(), &desc, IID_PPV_ARGS( &pipeline_state ) );
+        if ( SUCCEEDED( hr ) ) {
+            std::scoped_lock lock{ mutex_ };
+            ++library_hits_;
+            return pipeline_state;
+        }
+    }
+
+    hr = device_->CreatePipelineState( &desc, IID_PPV_ARGS( &pipeline_state ) );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    std::scoped_lock lock{ mutex_ };
+    ++compiles_;
+
+    if ( library_ ) {
+        hr = library_->StorePipeline( name.c_str(), pipeline_state.Get() );
+        if ( FAILED( hr ) ) {
+            log_hresult( hr );
+        } else {
+            dirty_ = true;
+        }
+    }
+
+    return pipeline_state;
+}
+
+auto PipelineCache::hash_stream( const D3D12_PIPELINE_STATE_STREAM_DESC& desc ) const -> std::optional<u64>
+{
+    StreamHasher hasher{};
+    StreamReader reader{ desc };
+
+    while ( const auto type = reader.next_type() ) {
+        hasher.add( *type );
+
+        switch ( *type ) {
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE: {
+                const auto root_signature = reader.read<ID3D12RootSignature*>();
+                if ( !root_signature ) {
+                    return std::nullopt;
+                }
+
+                std::scoped_lock lock{ mutex_ };
+
+                const auto it = root_signature_hashes_.find( *root_signature );
+                if ( it == root_signature_hashes_.end() ) {
+                    return std::nullopt;
+                }
+                hasher.add( it->second );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_VS:
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS:
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DS:
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_HS:
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_GS:
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_CS:
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS:
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS: {
+                const auto bytecode = reader.read<D3D12_SHADER_BYTECODE>();
+                if ( !bytecode ) {
+                    return std::nullopt;
+                }
+                hasher.add( hash_bytecode( *bytecode ) );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_STREAM_OUTPUT: {
+                const auto stream_output = reader.read<D3D12_STREAM_OUTPUT_DESC>();
+                if ( !stream_output ) {
+                    return std::nullopt;
+                }
+                add_stream_output( hasher, *stream_output );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND: {
+                const auto blend = reader.read<D3D12_BLEND_DESC>();
+                if ( !blend ) {
+                    return std::nullopt;
+                }
+                add_blend( hasher, *blend );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK: {
+                const auto sample_mask = reader.read<UINT>();
+                if ( !sample_mask ) {
+                    return std::nullopt;
+                }
+                hasher.add( *sample_mask );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER: {
+                const auto rasterizer = reader.read<D3D12_RASTERIZER_DESC>();
+                if ( !rasterizer ) {
+                    return std::nullopt;
+                }
+                add_rasterizer( hasher, *rasterizer );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL: {
+                const auto depth_stencil = reader.read<D3D12_DEPTH_STENCIL_DESC>();
+                if ( !depth_stencil ) {
+                    return std::nullopt;
+                }
+                add_depth_stencil( hasher, *depth_stencil );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL1: {
+                const auto depth_stencil = reader.read<D3D12_DEPTH_STENCIL_DESC1>();
+                if ( !depth_stencil ) {
+                    return std::nullopt;
+                }
+                add_depth_stencil( hasher, *depth_stencil );
+                hasher.add( depth_stencil->DepthBoundsTestEnable );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_INPUT_LAYOUT: {
+                const auto input_layout = reader.read<D3D12_INPUT_LAYOUT_DESC>();
+                if ( !input_layout ) {
+                    return std::nullopt;
+                }
+                add_input_layout( hasher, *input_layout );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_IB_STRIP_CUT_VALUE: {
+                const auto cut_value = reader.read<D3D12_INDEX_BUFFER_STRIP_CUT_VALUE>();
+                if ( !cut_value ) {
+                    return std::nullopt;
+                }
+                hasher.add( *cut_value );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PRIMITIVE_TOPOLOGY: {
+                const auto topology = reader.read<D3D12_PRIMITIVE_TOPOLOGY_TYPE>();
+                if ( !topology ) {
+                    return std::nullopt;
+                }
+                hasher.add( *topology );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS: {
+                const auto formats = reader.read<D3D12_RT_FORMAT_ARRAY>();
+                if ( !formats ) {
+                    return std::nullopt;
+                }
+
+                // Formats past NumRenderTargets are ignored by the runtime
+                hasher.add( formats->NumRenderTargets );
+                for ( u32 i = 0; i < formats->NumRenderTargets && i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i ) {
+                    hasher.add( formats->RTFormats[i] );
+                }
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT: {
+                const auto format = reader.read<DXGI_FORMAT>();
+                if ( !format ) {
+                    return std::nullopt;
+                }
+                hasher.add( *format );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC: {
+                const auto sample_desc = reader.read<DXGI_SAMPLE_DESC>();
+                if ( !sample_desc ) {
+                    return std::nullopt;
+                }
+                hasher.add( sample_desc->Count );
+                hasher.add( sample_desc->Quality );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_NODE_MASK: {
+                const auto node_mask = reader.read<D3D12_NODE_MASK>();
+                if ( !node_mask ) {
+                    return std::nullopt;
+                }
+                hasher.add( node_mask->NodeMask );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_CACHED_PSO: {
+                // A driver blob to start from, it does not change the pipeline
+                if ( !reader.read<D3D12_CACHED_PIPELINE_STATE>() ) {
+                    return std::nullopt;
+                }
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_FLAGS: {
+                const auto flags = reader.read<D3D12_PIPELINE_STATE_FLAGS>();
+                if ( !flags ) {
+                    return std::nullopt;
+                }
+                hasher.add( *flags );
+                break;
+            }
+            case D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_VIEW_INSTANCING: {
+                const auto view_instancing = reader.read<D3D12_VIEW_INSTANCING_DESC>();
+                if ( !view_instancing ) {
+                    return std::nullopt;
+                }
+                add_view_instancing( hasher, *view_instancing );
+                break;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+
+    return hasher.get();
+}
+
+auto PipelineCache::save() -> bool
+{
+    std::scoped_lock lock{ mutex_ };
+
+    if ( !library_ || !dirty_ ) {
+        return true;
+    }
+
+    std::vector<u8> data( library_->GetSerializedSize() );
+    HRESULT         hr = library_->Serialize( data.data(), data.size() );
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return false;
+    }
+
+    FileHeader header = header_;
+    header.library_size = data.size();
+    header.library_hash = hash_bytes( data.data(), data.size() );
+
+    // Written next to the cache and renamed over it, so that an interrupted save never leaves a torn file behind
+    std::filesystem::path temp_path = path_;
+    temp_path += L".tmp";
+    {
+        std::ofstream file{ temp_path, std::ios::binary | std::ios::trunc };
+        file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+        file.write( reinterpret_cast<const char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+        if ( !file ) {
+            log_error( L"Failed to write pipeline cache {}", temp_path.wstring() );
+            return false;
+        }
+    }
+
+    std::error_code error{};
+    std::filesystem::rename( temp_path, path_, error );
+    if ( error ) {
+        log_error( L"Failed to replace pipeline cache {}", path_.wstring() );
+        return false;
+    }
+
+    dirty_ = false;
+    return true;
+}
+
+auto PipelineCache::get_memory_hit_count() const -> u64
+{
+    std::scoped_lock lock{ mutex_ };
+    return memory_hits_;
+}
+
+auto PipelineCache::get_library_hit_count() const -> u64
+{
+    std::scoped_lock lock{ mutex_ };
+    return library_hits_;
+}
+
+auto PipelineCache::get_compile_count() const -> u64
+{
+    std::scoped_lock lock{ mutex_ };
+    return compiles_;
+}
+
+} // namespace mksv
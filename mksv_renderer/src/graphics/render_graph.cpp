@@ -0,0 +1,533 @@
+#include "mksv/graphics/render_graph.hpp"
+
+#include "mksv/log.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace mksv
+{
+enum class Declaration : u64 {
+    Import = 1,
+    Transient,
+    Export,
+    Pass,
+    SideEffects,
+    Read,
+    Write,
+};
+
+static constexpr u32 NO_USE = ~0u;
+static constexpr u32 NO_BARRIER = ~0u;
+
+static auto encode( const Declaration declaration, const u32 index = 0 ) -> u64
+{
+    return static_cast<u64>( declaration ) | static_cast<u64>( index ) << 8;
+}
+
+static auto align_up( const u64 value, const u64 alignment ) -> u64
+{
+    return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+RenderPassBuilder::RenderPassBuilder( RenderGraph& graph, const RenderGraphPass pass )
+    : graph_{ &graph },
+      pass_{ pass }
+{
+}
+
+auto RenderPassBuilder::read( const RenderGraphResource resource, const u32 state ) -> RenderPassBuilder&
+{
+    graph_->add_access( pass_, resource, state, false );
+    return *this;
+}
+
+auto RenderPassBuilder::write( const RenderGraphResource resource, const u32 state ) -> RenderPassBuilder&
+{
+    graph_->add_access( pass_, resource, state, true );
+    return *this;
+}
+
+auto RenderPassBuilder::has_side_effects() -> RenderPassBuilder&
+{
+    graph_->passes_[pass_].side_effects = true;
+    graph_->signature_.push_back( encode( Declaration::SideEffects, pass_ ) );
+    return *this;
+}
+
+auto RenderPassBuilder::get_pass() const -> RenderGraphPass
+{
+    return pass_;
+}
+
+RenderGraph::RenderGraph( const u32 read_only_states, const u32 unordered_access_state )
+    : read_only_states_{ read_only_states },
+      unordered_access_state_{ unordered_access_state },
+      rejected_access_count_{ 0 },
+      has_compiled_{ false },
+      compiled_{}
+{
+}
+
+auto RenderGraph::reset() -> void
+{
+    passes_.clear();
+    accesses_.clear();
+    resources_.clear();
+    signature_.clear();
+    rejected_access_count_ = 0;
+}
+
+auto RenderGraph::import_resource() -> RenderGraphResource
+{
+    signature_.push_back( encode( Declaration::Import ) );
+
+    resources_.push_back( {
+        .size = 0,
+        .alignment = 0,
+        .final_state = 0,
+        .transient = false,
+        .exported = false,
+    } );
+
+    return static_cast<RenderGraphResource>( resources_.size() - 1 );
+}
+
+auto RenderGraph::create_transient( const u64 size, const u64 alignment ) -> RenderGraphResource
+{
+    assert( size > 0 && alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+
+    signature_.push_back( encode( Declaration::Transient ) );
+    signature_.push_back( size );
+    signature_.push_back( alignment );
+
+    resources_.push_back( {
+        .size = size,
+        .alignment = alignment,
+        .final_state = 0,
+        .transient = true,
+        .exported = false,
+    } );
+
+    return static_cast<RenderGraphResource>( resources_.size() - 1 );
+}
+
+auto RenderGraph::export_resource( const RenderGraphResource resource, const u32 final_state ) -> void
+{
+    assert( resource < resources_.size() );
+
+    signature_.push_back( encode( Declaration::Export, resource ) );
+    signature_.push_back( final_state );
+
+    resources_[resource].exported = true;
+    resources_[resource].final_state = final_state;
+}
+
+auto RenderGraph::add_pass( const std::string_view name ) -> RenderPassBuilder
+{
+    signature_.push_back( encode( Declaration::Pass ) );
+
+    passes_.push_back( {
+        .name = name,
+        .first_access = static_cast<u32>( accesses_.size() ),
+        .access_count = 0,
+        .side_effects = false,
+    } );
+
+    return RenderPassBuilder{ *this, static_cast<RenderGraphPass>( passes_.size() - 1 ) };
+}
+
+auto RenderGraph::compile() -> bool
+{
+    if ( has_compiled_ && signature_ == compiled_signature_ ) {
+        return false;
+    }
+
+    compiled_.passes.clear();
+    compiled_.barriers.clear();
+    compiled_.aliasing.clear();
+    compiled_.offsets.assign( resources_.size(), INVALID_OFFSET );
+    compiled_.transient_size = 0;
+    compiled_.culled_pass_count = 0;
+
+    cull();
+    compute_lifetimes();
+    place_transients();
+    place_aliasing();
+    place_barriers();
+
+    compiled_signature_ = signature_;
+    has_compiled_ = true;
+
+    return true;
+}
+
+auto RenderGraph::get_compiled() const -> const CompiledRenderGraph&
+{
+    assert( has_compiled_ );
+    return compiled_;
+}
+
+auto RenderGraph::get_pass_name( const RenderGraphPass pass ) const -> std::string_view
+{
+    return passes_[pass].name;
+}
+
+auto RenderGraph::get_pass_count() const -> u32
+{
+    return static_cast<u32>( passes_.size() );
+}
+
+auto RenderGraph::get_resource_count() const -> u32
+{
+    return static_cast<u32>( resources_.size() );
+}
+
+auto RenderGraph::is_transient( const RenderGraphResource resource ) const -> bool
+{
+    return resources_[resource].transient;
+}
+
+auto RenderGraph::get_rejected_access_count() const -> u32
+{
+    return rejected_access_count_;
+}
+
+auto RenderGraph::add_access(
+    const RenderGraphPass     pass,
+    const RenderGraphResource resource,
+    const u32                 state,
+    const bool                write
+) -> void
+{
+    assert( pass + 1 == passes_.size() && "Resources have to be declared right after the pass that uses them" );
+    assert( resource < resources_.size() );
+
+    // A resource is in a single state for the whole pass, only read states can be combined into one
+    const Pass& declared = passes_[pass];
+    for ( u32 a = declared.first_access; a < declared.first_access + declared.access_count; ++a ) {
+        const Access& other = accesses_[a];
+        if ( other.resource == resource && other.state != state &&
+             !( is_read_only( other.state ) && is_read_only( state ) ) ) {
+            log_error(
+                L"Pass {} uses resource {} in states {:#x} and {:#x}",
+                std::wstring( declared.name.begin(), declared.name.end() ),
+                resource,
+                other.state,
+                state
+            );
+            ++rejected_access_count_;
+            return;
+        }
+    }
+
+    signature_.push_back( encode( write ? Declaration::Write : Declaration::Read, resource ) );
+    signature_.push_back( state );
+
+    accesses_.push_back( { .resource = resource, .state = state, .write = write } );
+    ++passes_[pass].access_count;
+}
+
+// Walks the passes backwards keeping track of which resources are still needed. A pass lives when it writes one of
+// them, and then everything it reads is needed as well. Writes do not end a resource's need, a pass may only be
+// updating part of it.
+auto RenderGraph::cull() -> void
+{
+    needed_.assign( resources_.size(), 0 );
+    live_.assign( passes_.size(), 0 );
+
+    for ( u32 i = 0; i < resources_.size(); ++i ) {
+        needed_[i] = resources_[i].exported;
+    }
+
+    for ( u32 i = static_cast<u32>( passes_.size() ); i-- > 0; ) {
+        const Pass& pass = passes_[i];
+
+        bool live = pass.side_effects;
+        for ( u32 a = pass.first_access; a < pass.first_access + pass.access_count && !live; ++a ) {
+            live = accesses_[a].write && needed_[accesses_[a].resource];
+        }
+
+        if ( !live ) {
+            continue;
+        }
+
+        live_[i] = 1;
+        for ( u32 a = pass.first_access; a < pass.first_access + pass.access_count; ++a ) {
+            if ( !accesses_[a].write ) {
+                needed_[accesses_[a].resource] = 1;
+            }
+        }
+    }
+
+    for ( u32 i = 0; i < passes_.size(); ++i ) {
+        if ( !live_[i] ) {
+            ++compiled_.culled_pass_count;
+            continue;
+        }
+
+        compiled_.passes.push_back( {
+            .pass = i,
+            .first_aliasing = 0,
+            .aliasing_count = 0,
+            .first_barrier_before = 0,
+            .barrier_before_count = 0,
+            .first_barrier_after = 0,
+            .barrier_after_count = 0,
+        } );
+    }
+}
+
+// First and last compiled pass using each resource
+auto RenderGraph::compute_lifetimes() -> void
+{
+    first_use_.assign( resources_.size(), NO_USE );
+    last_use_.assign( resources_.size(), NO_USE );
+
+    for ( u32 k = 0; k < compiled_.passes.size(); ++k ) {
+        const Pass& pass = passes_[compiled_.passes[k].pass];
+
+        for ( u32 a = pass.first_access; a < pass.first_access + pass.access_count; ++a ) {
+            const RenderGraphResource resource = accesses_[a].resource;
+            if ( first_use_[resource] == NO_USE ) {
+                first_use_[resource] = k;
+            }
+            last_use_[resource] = k;
+        }
+    }
+}
+
+// Largest first, each transient goes to the lowest offset that does not overlap a transient already placed whose
+// lifetime overlaps its own
+auto RenderGraph::place_transients() -> void
+{
+    placement_order_.clear();
+    for ( u32 i = 0; i < resources_.size(); ++i ) {
+        if ( resources_[i].transient && first_use_[i] != NO_USE ) {
+            placement_order_.push_back( i );
+        }
+    }
+
+    std::ranges::sort( placement_order_, [this]( const u32 a, const u32 b ) {
+        if ( resources_[a].size != resources_[b].size ) {
+            return resources_[a].size > resources_[b].size;
+        }
+        return first_use_[a] < first_use_[b];
+    } );
+
+    placements_.clear();
+    for ( const u32 resource : placement_order_ ) {
+        const Resource& desc = resources_[resource];
+        const u32       first = first_use_[resource];
+        const u32       last = last_use_[resource];
+
+        // Placements are sorted by offset, so the first gap large enough is the lowest one
+        u64 offset = 0;
+        for ( const Placement& placed : placements_ ) {
+            if ( placed.last_use < first || last < placed.first_use ) {
+                continue;
+            }
+            if ( align_up( offset, desc.alignment ) + desc.size <= placed.begin ) {
+                break;
+            }
+            offset = std::max( offset, placed.end );
+        }
+
+        offset = align_up( offset, desc.alignment );
+        compiled_.offsets[resource] = offset;
+        compiled_.transient_size = std::max( compiled_.transient_size, offset + desc.size );
+
+        const Placement placement = {
+            .resource = resource,
+            .first_use = first,
+            .last_use = last,
+            .begin = offset,
+            .end = offset + desc.size,
+        };
+        const auto position = std::ranges::upper_bound( placements_, offset, {}, &Placement::begin );
+        placements_.insert( position, placement );
+    }
+}
+
+// A transient whose memory is shared needs an aliasing barrier before its first use. When a single transient used
+// that memory earlier in the frame it is named, otherwise the memory may also come from the previous frame.
+auto RenderGraph::place_aliasing() -> void
+{
+    std::ranges::sort( placement_order_, {}, [this]( const u32 resource ) { return first_use_[resource]; } );
+
+    for ( const u32 resource : placement_order_ ) {
+        const u64 begin = compiled_.offsets[resource];
+        const u64 end = begin + resources_[resource].size;
+        const u32 first = first_use_[resource];
+
+        bool                shared = false;
+        u32                 predecessors = 0;
+        RenderGraphResource before = INVALID_RESOURCE;
+
+        for ( const Placement& placed : placements_ ) {
+            if ( placed.begin >= end ) {
+                break;
+            }
+            if ( placed.resource == resource || placed.end <= begin ) {
+                continue;
+            }
+
+            shared = true;
+            if ( placed.last_use < first ) {
+                ++predecessors;
+                before = placed.resource;
+            }
+        }
+
+        if ( !shared ) {
+            continue;
+        }
+
+        CompiledRenderPass& pass = compiled_.passes[first];
+        if ( pass.aliasing_count == 0 ) {
+            pass.first_aliasing = static_cast<u32>( compiled_.aliasing.size() );
+        }
+        ++pass.aliasing_count;
+
+        compiled_.aliasing.push_back( {
+            .before = predecessors == 1 ? before : INVALID_RESOURCE,
+            .after = resource,
+        } );
+    }
+}
+
+// Simulates the state of every resource through the compiled passes. Imported and transient resources start in an
+// unknown state, so their first use always gets a barrier and the executor drops it if it turns out to be redundant.
+auto RenderGraph::place_barriers() -> void
+{
+    cursors_.assign(
+        resources_.size(),
+        { .state = 0, .last_use = NO_USE, .full = NO_BARRIER, .begin = NO_BARRIER, .written = false }
+    );
+    slotted_.clear();
+
+    for ( u32 k = 0; k < compiled_.passes.size(); ++k ) {
+        const Pass& pass = passes_[compiled_.passes[k].pass];
+
+        for ( u32 a = pass.first_access; a < pass.first_access + pass.access_count; ++a ) {
+            const Access&  access = accesses_[a];
+            BarrierCursor& cursor = cursors_[access.resource];
+            const u32      state = access.state;
+
+            if ( cursor.last_use == NO_USE ) {
+                cursor = { state, k, emit( 2 * k, access.resource, state, BarrierPhase::Full ), NO_BARRIER, false };
+                cursor.written = writes( pass, access.resource );
+                continue;
+            }
+
+            // Whether the previous pass using the resource wrote it, the current one may not have been seen whole yet
+            const bool same_pass = cursor.last_use == k;
+            const bool written_before = cursor.written;
+            cursor.written = writes( pass, access.resource );
+
+            // A read-only run keeps growing until something needs an exclusive state, every reader in it is served
+            // by the barrier in front of the first one
+            const bool read_run = is_read_only( state ) && is_read_only( cursor.state );
+            if ( ( same_pass || read_run ) && cursor.full != NO_BARRIER ) {
+                if ( ( cursor.state & state ) != state ) {
+                    cursor.state |= state;
+                    slotted_[cursor.full].barrier.state = cursor.state;
+                    if ( cursor.begin != NO_BARRIER ) {
+                        slotted_[cursor.begin].barrier.state = cursor.state;
+                    }
+                }
+
+                cursor.last_use = k;
+                continue;
+            }
+
+            if ( cursor.state == state ) {
+                // Unordered access is not ordered between passes, a write on either side needs a barrier
+                if ( !same_pass && state == unordered_access_state_ && ( written_before || cursor.written ) ) {
+                    emit( 2 * k, access.resource, state, BarrierPhase::Full, RenderGraphBarrierType::UnorderedAccess );
+                }
+
+                cursor.last_use = k;
+                cursor.full = NO_BARRIER;
+                cursor.begin = NO_BARRIER;
+                continue;
+            }
+
+            cursor.begin = k - cursor.last_use > 1
+                             ? emit( 2 * cursor.last_use + 1, access.resource, state, BarrierPhase::Begin )
+                             : NO_BARRIER;
+            cursor.full = emit( 2 * k, access.resource, state, BarrierPhase::Full );
+            cursor.state = state;
+            cursor.last_use = k;
+        }
+    }
+
+    // Exported resources transition to their final state once the graph is done with them
+    const u32 pass_count = static_cast<u32>( compiled_.passes.size() );
+    for ( u32 i = 0; i < resources_.size(); ++i ) {
+        const BarrierCursor& cursor = cursors_[i];
+        const u32            final_state = resources_[i].final_state;
+        if ( !resources_[i].exported || cursor.last_use == NO_USE || cursor.state == final_state ) {
+            continue;
+        }
+
+        if ( pass_count - cursor.last_use > 1 ) {
+            emit( 2 * cursor.last_use + 1, i, final_state, BarrierPhase::Begin );
+        }
+        emit( 2 * pass_count - 1, i, final_state, BarrierPhase::Full );
+    }
+
+    // Stable counting sort of the barriers into their slots
+    slot_offsets_.assign( 2 * pass_count + 1, 0 );
+    for ( const SlottedBarrier& slotted : slotted_ ) {
+        ++slot_offsets_[slotted.slot + 1];
+    }
+    for ( u32 s = 1; s < slot_offsets_.size(); ++s ) {
+        slot_offsets_[s] += slot_offsets_[s - 1];
+    }
+
+    for ( u32 k = 0; k < pass_count; ++k ) {
+        CompiledRenderPass& compiled = compiled_.passes[k];
+        compiled.first_barrier_before = slot_offsets_[2 * k];
+        compiled.barrier_before_count = slot_offsets_[2 * k + 1] - slot_offsets_[2 * k];
+        compiled.first_barrier_after = slot_offsets_[2 * k + 1];
+        compiled.barrier_after_count = slot_offsets_[2 * k + 2] - slot_offsets_[2 * k + 1];
+    }
+
+    compiled_.barriers.resize( slotted_.size() );
+    for ( const SlottedBarrier& slotted : slotted_ ) {
+        compiled_.barriers[slot_offsets_[slotted.slot]++] = slotted.barrier;
+    }
+}
+
+auto RenderGraph::emit(
+    const u32                    slot,
+    const RenderGraphResource    resource,
+    const u32                    state,
+    const BarrierPhase           phase,
+    const RenderGraphBarrierType type
+) -> u32
+{
+    slotted_.push_back( {
+        .slot = slot,
+        .barrier = { .resource = resource, .state = state, .phase = phase, .type = type },
+    } );
+    return static_cast<u32>( slotted_.size() - 1 );
+}
+
+auto RenderGraph::writes( const Pass& pass, const RenderGraphResource resource ) const -> bool
+{
+    for ( u32 a = pass.first_access; a < pass.first_access + pass.access_count; ++a ) {
+        if ( accesses_[a].resource == resource && accesses_[a].write ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto RenderGraph::is_read_only( const u32 state ) const -> bool
+{
+    return state != 0 && ( state & ~read_only_states_ ) == 0;
+}
+
+} // namespace mksv
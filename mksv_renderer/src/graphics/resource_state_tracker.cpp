@@ -0,0 +1,255 @@
+#include "mksv/graphics/resource_state_tracker.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace mksv
+{
+
+ResourceStateTracker::ResourceStateTracker( const u32 read_only_states )
+    : read_only_states_{ read_only_states }
+{
+}
+
+auto ResourceStateTracker::track( const void* resource, const u32 initial_state, const u32 subresource_count ) -> void
+{
+    assert( subresource_count > 0 );
+
+    resources_[resource] = Resource{
+        .subresources = std::vector<Subresource>( subresource_count, { initial_state, NO_SPLIT } ),
+        .split_all = false,
+    };
+}
+
+auto ResourceStateTracker::untrack( const void* resource ) -> void
+{
+    resources_.erase( resource );
+
+    // A transition already requested still has to reach the command list, it just can no longer absorb new ones
+    last_pending_.erase( resource );
+}
+
+auto ResourceStateTracker::is_tracked( const void* resource ) const -> bool
+{
+    return resources_.contains( resource );
+}
+
+auto ResourceStateTracker::require( const void* resource, const u32 state, const u32 subresource ) -> void
+{
+    const auto it = resources_.find( resource );
+    assert( it != resources_.end() && "Resource is not tracked" );
+    Resource& tracked = it->second;
+
+    if ( tracked.split_all && ( subresource != ALL_SUBRESOURCES || !is_uniform( tracked ) ) ) {
+        end_split( resource, tracked, ALL_SUBRESOURCES );
+    }
+
+    if ( subresource != ALL_SUBRESOURCES ) {
+        assert( subresource < tracked.subresources.size() );
+        resolve( resource, tracked, subresource, state );
+        return;
+    }
+
+    // Splits begun one subresource at a time have to end the same way even if they left the resource uniform
+    const bool split_per_subresource = tracked.subresources.front().split_target != NO_SPLIT && !tracked.split_all;
+    if ( is_uniform( tracked ) && !split_per_subresource ) {
+        resolve( resource, tracked, ALL_SUBRESOURCES, state );
+        return;
+    }
+
+    for ( u32 i = 0; i < tracked.subresources.size(); ++i ) {
+        resolve( resource, tracked, i, state );
+    }
+}
+
+auto ResourceStateTracker::prepare( const void* resource, const u32 state, const u32 subresource ) -> void
+{
+    const auto it = resources_.find( resource );
+    assert( it != resources_.end() && "Resource is not tracked" );
+    Resource& tracked = it->second;
+
+    if ( tracked.split_all ) {
+        return;
+    }
+
+    if ( subresource != ALL_SUBRESOURCES ) {
+        assert( subresource < tracked.subresources.size() );
+        begin_split( resource, tracked, subresource, state );
+        return;
+    }
+
+    if ( is_uniform( tracked ) ) {
+        begin_split( resource, tracked, ALL_SUBRESOURCES, state );
+        return;
+    }
+
+    for ( u32 i = 0; i < tracked.subresources.size(); ++i ) {
+        begin_split( resource, tracked, i, state );
+    }
+}
+
+auto ResourceStateTracker::flush( std::vector<ResourceTransition>& out ) -> u32
+{
+    u32 count = 0;
+    for ( const ResourceTransition& transition : pending_ ) {
+        if ( transition.phase == BarrierPhase::Full && transition.before == transition.after ) {
+            continue;
+        }
+
+        out.push_back( transition );
+        ++count;
+    }
+
+    pending_.clear();
+    last_pending_.clear();
+
+    return count;
+}
+
+auto ResourceStateTracker::get_state( const void* resource, const u32 subresource ) const -> u32
+{
+    const auto it = resources_.find( resource );
+    assert( it != resources_.end() && subresource < it->second.subresources.size() );
+    return it->second.subresources[subresource].state;
+}
+
+auto ResourceStateTracker::has_pending() const -> bool
+{
+    return std::ranges::any_of( pending_, []( const ResourceTransition& transition ) {
+        return transition.phase != BarrierPhase::Full || transition.before != transition.after;
+    } );
+}
+
+auto ResourceStateTracker::is_uniform( const Resource& resource ) -> bool
+{
+    const Subresource& first = resource.subresources.front();
+    return std::ranges::all_of( resource.subresources, [&first]( const Subresource& subresource ) {
+        return subresource.state == first.state && subresource.split_target == first.split_target;
+    } );
+}
+
+auto ResourceStateTracker::set_subresources( Resource& resource, const u32 subresource, const Subresource value )
+    -> void
+{
+    if ( subresource == ALL_SUBRESOURCES ) {
+        std::ranges::fill( resource.subresources, value );
+    } else {
+        resource.subresources[subresource] = value;
+    }
+}
+
+// subresource is ALL_SUBRESOURCES only when every subresource is in the same state
+auto ResourceStateTracker::resolve( const void* key, Resource& resource, const u32 subresource, const u32 state )
+    -> void
+{
+    const u32 index = subresource == ALL_SUBRESOURCES ? 0 : subresource;
+
+    u32 current = resource.subresources[index].state;
+    if ( resource.subresources[index].split_target != NO_SPLIT ) {
+        current = end_split( key, resource, subresource );
+    }
+
+    if ( covers( current, state ) ) {
+        return;
+    }
+
+    // Read-only states can be held together, so widen instead of trading one read state for another
+    const u32 target = is_read_only( current ) && is_read_only( state ) ? current | state : state;
+
+    push( {
+        .resource = key,
+        .subresource = subresource,
+        .before = current,
+        .after = target,
+        .phase = BarrierPhase::Full,
+    } );
+
+    set_subresources( resource, subresource, { target, NO_SPLIT } );
+}
+
+auto ResourceStateTracker::begin_split( const void* key, Resource& resource, const u32 subresource, const u32 state )
+    -> void
+{
+    const u32          index = subresource == ALL_SUBRESOURCES ? 0 : subresource;
+    const Subresource& current = resource.subresources[index];
+
+    if ( current.split_target != NO_SPLIT || covers( current.state, state ) ) {
+        return;
+    }
+
+    const u32 target = is_read_only( current.state ) && is_read_only( state ) ? current.state | state : state;
+
+    push( {
+        .resource = key,
+        .subresource = subresource,
+        .before = current.state,
+        .after = target,
+        .phase = BarrierPhase::Begin,
+    } );
+
+    set_subresources( resource, subresource, { current.state, target } );
+    resource.split_all = subresource == ALL_SUBRESOURCES;
+}
+
+// Emits the end half of a split begun with the same subresource argument and returns the state it lands in
+auto ResourceStateTracker::end_split( const void* key, Resource& resource, const u32 subresource ) -> u32
+{
+    const u32         index = subresource == ALL_SUBRESOURCES ? 0 : subresource;
+    const Subresource current = resource.subresources[index];
+    assert( current.split_target != NO_SPLIT );
+
+    push( {
+        .resource = key,
+        .subresource = subresource,
+        .before = current.state,
+        .after = current.split_target,
+        .phase = BarrierPhase::End,
+    } );
+
+    set_subresources( resource, subresource, { current.split_target, NO_SPLIT } );
+    if ( subresource == ALL_SUBRESOURCES ) {
+        resource.split_all = false;
+    }
+
+    return current.split_target;
+}
+
+auto ResourceStateTracker::push( const ResourceTransition& transition ) -> void
+{
+    // Fold into the previous transition of the same subresource when nothing for this resource was queued after it.
+    // A split that begins and ends in the same batch is just a regular transition.
+    const auto it = last_pending_.find( transition.resource );
+    if ( it != last_pending_.end() ) {
+        ResourceTransition& last = pending_[it->second];
+        if ( last.subresource == transition.subresource ) {
+            if ( transition.phase == BarrierPhase::Full && last.phase == BarrierPhase::Full ) {
+                last.after = transition.after;
+                return;
+            }
+
+            if ( transition.phase == BarrierPhase::End && last.phase == BarrierPhase::Begin ) {
+                last.phase = BarrierPhase::Full;
+                return;
+            }
+        }
+    }
+
+    last_pending_[transition.resource] = pending_.size();
+    pending_.push_back( transition );
+}
+
+auto ResourceStateTracker::covers( const u32 current, const u32 state ) const -> bool
+{
+    if ( current == state ) {
+        return true;
+    }
+
+    return is_read_only( current ) && is_read_only( state ) && ( current & state ) == state;
+}
+
+auto ResourceStateTracker::is_read_only( const u32 state ) const -> bool
+{
+    return state != 0 && ( state & ~read_only_states_ ) == 0;
+}
+
+} // namespace mksv
@@ -0,0 +1,101 @@
+#include "mksv/graphics/ring_allocator.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace mksv
+{
+
+RingAllocator::RingAllocator( const u64 capacity )
+    : capacity_{ capacity },
+      head_{ 0 },
+      tail_{ 0 },
+      closed_head_{ 0 }
+{
+    assert( capacity > 0 );
+}
+
+auto RingAllocator::allocate( const u64 size, const u64 alignment ) -> std::optional<u64>
+{
+    assert( std::has_single_bit( alignment ) );
+    assert( capacity_ % alignment == 0 && "The ring capacity must be a multiple of every alignment used" );
+
+    if ( size == 0 || size > capacity_ ) {
+        return std::nullopt;
+    }
+
+    u64 head = head_.load( std::memory_order_relaxed );
+    while ( true ) {
+        const u64 physical = head % capacity_;
+        u64       aligned = ( physical + alignment - 1 ) & ~( alignment - 1 );
+        u64       padding = aligned - physical;
+
+        // Never split an allocation across the end of the buffer, skip to the start instead
+        if ( aligned + size > capacity_ ) {
+            padding = capacity_ - physical;
+            aligned = 0;
+        }
+
+        const u64 new_head = head + padding + size;
+        if ( new_head - tail_.load( std::memory_order_acquire ) > capacity_ ) {
+            return std::nullopt;
+        }
+
+        if ( head_.compare_exchange_weak( head, new_head, std::memory_order_acq_rel, std::memory_order_relaxed ) ) {
+            return aligned;
+        }
+    }
+}
+
+auto RingAllocator::close_batch( const u64 fence_value ) -> void
+{
+    std::scoped_lock lock{ mutex_ };
+
+    const u64 head = head_.load( std::memory_order_acquire );
+    if ( head == closed_head_ ) {
+        return;
+    }
+
+    assert( batches_.empty() || batches_.back().fence_value <= fence_value );
+    batches_.push_back( { fence_value, head } );
+    closed_head_ = head;
+}
+
+auto RingAllocator::retire( const u64 completed_fence_value ) -> void
+{
+    std::scoped_lock lock{ mutex_ };
+
+    while ( !batches_.empty() && batches_.front().fence_value <= completed_fence_value ) {
+        tail_.store( batches_.front().end, std::memory_order_release );
+        batches_.pop_front();
+    }
+}
+
+auto RingAllocator::get_oldest_pending_fence() const -> std::optional<u64>
+{
+    std::scoped_lock lock{ mutex_ };
+
+    if ( batches_.empty() ) {
+        return std::nullopt;
+    }
+
+    return batches_.front().fence_value;
+}
+
+auto RingAllocator::has_open_allocations() const -> bool
+{
+    std::scoped_lock lock{ mutex_ };
+    return head_.load( std::memory_order_acquire ) != closed_head_;
+}
+
+auto RingAllocator::get_capacity() const -> u64
+{
+    return capacity_;
+}
+
+auto RingAllocator::get_used() const -> u64
+{
+    return head_.load( std::memory_order_acquire ) - tail_.load( std::memory_order_acquire );
+}
+
+} // namespace mksv
@@ -0,0 +1,208 @@
+#include "mksv/graphics/streaming_uploader.hpp"
+
+#include "mksv/log.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace mksv
+{
+
+auto StreamingUploader::create( UploadQueue& queue, const u64 batch_size ) -> std::unique_ptr<StreamingUploader>
+{
+    const u64 capacity = queue.get_staging_memory().size();
+    if ( capacity < 2 * STAGING_ALIGNMENT || capacity % STAGING_ALIGNMENT != 0 ) {
+        log_error( L"Invalid staging memory size of {} bytes for streaming uploads", capacity );
+        return nullptr;
+    }
+
+    const u64 clamped = std::clamp( batch_size, STAGING_ALIGNMENT, capacity / 2 ) & ~( STAGING_ALIGNMENT - 1 );
+    return std::unique_ptr<StreamingUploader>{ new StreamingUploader( queue, clamped ) };
+}
+
+StreamingUploader::StreamingUploader( UploadQueue& queue, const u64 batch_size )
+    : queue_{ &queue },
+      staging_{ queue.get_staging_memory() },
+      ring_{ staging_.size() },
+      batch_size_{ batch_size },
+      open_bytes_{ 0 },
+      first_pending_{ 0 },
+      submitted_count_{ 0 },
+      gpu_waited_value_{ 0 },
+      stall_count_{ 0 }
+{
+}
+
+auto StreamingUploader::request(
+    const UploadDestination destination,
+    const u64               destination_offset,
+    const void*             data,
+    const u64               size
+) -> std::optional<UploadTicket>
+{
+    // The ticket would name a batch nothing is uploaded with, which may never be submitted
+    if ( size == 0 ) {
+        log_error( L"Rejected an upload of 0 bytes" );
+        return std::nullopt;
+    }
+
+    std::scoped_lock lock{ mutex_ };
+
+    const u8* const bytes = static_cast<const u8*>( data );
+
+    u64 copied = 0;
+    while ( copied < size ) {
+        const u64                piece = std::min( size - copied, batch_size_ - open_bytes_ );
+        const std::optional<u64> offset = allocate( piece );
+        if ( !offset ) {
+            return std::nullopt;
+        }
+
+        std::memcpy( staging_.data() + *offset, bytes + copied, piece );
+        copies_.push_back( {
+            .destination = destination,
+            .destination_offset = destination_offset + copied,
+            .staging_offset = *offset,
+            .size = piece,
+        } );
+
+        copied += piece;
+        open_bytes_ += piece;
+
+        // The last piece stays in the open batch unless it filled it, so that small requests keep batching up
+        if ( open_bytes_ == batch_size_ && !submit_batch() ) {
+            return std::nullopt;
+        }
+    }
+
+    // The last piece is in the open batch, unless it filled the batch and went out with it
+    const bool submitted = copies_.empty() && submitted_count_ > 0;
+    return UploadTicket{ .batch = submitted ? submitted_count_ - 1 : submitted_count_ };
+}
+
+auto StreamingUploader::flush() -> bool
+{
+    std::scoped_lock lock{ mutex_ };
+    return copies_.empty() || submit_batch();
+}
+
+auto StreamingUploader::is_complete( const UploadTicket ticket ) const -> bool
+{
+    std::scoped_lock lock{ mutex_ };
+
+    if ( ticket.batch >= submitted_count_ ) {
+        return false;
+    }
+
+    if ( ticket.batch < first_pending_ ) {
+        return true;
+    }
+
+    return queue_->get_fence().get_completed_value() >= pending_[ticket.batch - first_pending_];
+}
+
+auto StreamingUploader::wait_on_gpu( const UploadTicket ticket ) -> bool
+{
+    std::scoped_lock lock{ mutex_ };
+
+    if ( ticket.batch >= submitted_count_ && !submit_batch() ) {
+        return false;
+    }
+
+    assert( ticket.batch < submitted_count_ && "Ticket from a batch that was never opened" );
+    if ( ticket.batch < first_pending_ ) {
+        return true;
+    }
+
+    // Waits are cumulative, so one for a later batch already covers this one
+    const u64 fence_value = pending_[ticket.batch - first_pending_];
+    if ( fence_value > gpu_waited_value_ ) {
+        queue_->wait_on_gpu( fence_value );
+        gpu_waited_value_ = fence_value;
+    }
+
+    return true;
+}
+
+auto StreamingUploader::retire() -> void
+{
+    std::scoped_lock lock{ mutex_ };
+    retire_batches();
+}
+
+auto StreamingUploader::get_batch_size() const -> u64
+{
+    return batch_size_;
+}
+
+auto StreamingUploader::get_submitted_batch_count() const -> u64
+{
+    std::scoped_lock lock{ mutex_ };
+    return submitted_count_;
+}
+
+auto StreamingUploader::get_stall_count() const -> u64
+{
+    std::scoped_lock lock{ mutex_ };
+    return stall_count_;
+}
+
+auto StreamingUploader::allocate( const u64 size ) -> std::optional<u64>
+{
+    retire_batches();
+
+    std::optional<u64> offset = ring_.allocate( size, STAGING_ALIGNMENT );
+    while ( !offset ) {
+        // The open batch has to go out before its memory can ever be recycled
+        if ( !copies_.empty() && !submit_batch() ) {
+            return std::nullopt;
+        }
+
+        const std::optional<u64> oldest = ring_.get_oldest_pending_fence();
+        if ( !oldest ) {
+            log_error( L"Staging memory cannot hold an upload of {} bytes", size );
+            return std::nullopt;
+        }
+
+        ++stall_count_;
+        if ( !queue_->get_fence().wait_for_value( *oldest ) ) {
+            return std::nullopt;
+        }
+
+        retire_batches();
+        offset = ring_.allocate( size, STAGING_ALIGNMENT );
+    }
+
+    return offset;
+}
+
+auto StreamingUploader::submit_batch() -> bool
+{
+    const u64 fence_value = queue_->submit( copies_ );
+    if ( fence_value == 0 ) {
+        log_error( L"Failed to submit a batch of uploads" );
+        return false;
+    }
+
+    ring_.close_batch( fence_value );
+    pending_.push_back( fence_value );
+    ++submitted_count_;
+
+    copies_.clear();
+    open_bytes_ = 0;
+    return true;
+}
+
+auto StreamingUploader::retire_batches() -> void
+{
+    const u64 completed = queue_->get_fence().get_completed_value();
+    ring_.retire( completed );
+
+    while ( !pending_.empty() && pending_.front() <= completed ) {
+        pending_.pop_front();
+        ++first_pending_;
+    }
+}
+
+} // namespace mksv
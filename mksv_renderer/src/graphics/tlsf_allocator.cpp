@@ -0,0 +1,316 @@
+#include "mksv/graphics/tlsf_allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace mksv
+{
+
+TlsfAllocator::TlsfAllocator( const u64 capacity, const u64 granularity )
+    : capacity_{ capacity },
+      granularity_{ granularity },
+      used_{ 0 },
+      allocation_count_{ 0 },
+      free_block_count_{ 0 },
+      first_level_bitmap_{ 0 },
+      second_level_bitmaps_{}
+{
+    assert( std::has_single_bit( granularity ) );
+    assert( capacity > 0 && capacity % granularity == 0 );
+
+    for ( auto& heads : free_heads_ ) {
+        heads.fill( INVALID_BLOCK );
+    }
+
+    const u32 block = new_block();
+    blocks_[block].offset = 0;
+    blocks_[block].size = capacity;
+    insert_free_block( block );
+}
+
+auto TlsfAllocator::allocate( const u64 size, const u64 alignment ) -> std::optional<TlsfAllocation>
+{
+    assert( std::has_single_bit( alignment ) );
+
+    if ( size == 0 || size > capacity_ ) {
+        return std::nullopt;
+    }
+
+    const u64 aligned_size = ( size + granularity_ - 1 ) & ~( granularity_ - 1 );
+    const u64 block_alignment = std::max( alignment, granularity_ );
+
+    // Offsets are always multiples of the granularity, so this is the worst case padding needed to align
+    const u64 search_size = aligned_size + block_alignment - granularity_;
+    if ( search_size > capacity_ ) {
+        return std::nullopt;
+    }
+
+    u32 block = find_free_block( search_size );
+    if ( block == INVALID_BLOCK ) {
+        return std::nullopt;
+    }
+
+    remove_free_block( block );
+
+    const u64 aligned_offset = ( blocks_[block].offset + block_alignment - 1 ) & ~( block_alignment - 1 );
+    const u64 padding = aligned_offset - blocks_[block].offset;
+    if ( padding > 0 ) {
+        const u32 padding_block = block;
+        block = split_block( padding_block, padding );
+        insert_free_block( padding_block );
+    }
+
+    if ( blocks_[block].size > aligned_size ) {
+        const u32 remainder = split_block( block, aligned_size );
+        insert_free_block( remainder );
+    }
+
+    blocks_[block].is_free = false;
+    used_ += blocks_[block].size;
+    ++allocation_count_;
+
+    return TlsfAllocation{
+        .block = block,
+        .offset = blocks_[block].offset,
+        .size = blocks_[block].size,
+    };
+}
+
+auto TlsfAllocator::free( const u32 block ) -> void
+{
+    assert( block < blocks_.size() && !blocks_[block].is_free );
+
+    used_ -= blocks_[block].size;
+    --allocation_count_;
+
+    blocks_[block].is_free = true;
+
+    u32 merged = block;
+    const u32 prev = blocks_[merged].prev_physical;
+    if ( prev != INVALID_BLOCK && blocks_[prev].is_free ) {
+        remove_free_block( prev );
+        merged = merge_into_prev( merged );
+    }
+
+    const u32 next = blocks_[merged].next_physical;
+    if ( next != INVALID_BLOCK && blocks_[next].is_free ) {
+        remove_free_block( next );
+        merged = merge_into_prev( next );
+    }
+
+    insert_free_block( merged );
+}
+
+auto TlsfAllocator::get_stats() const -> TlsfStats
+{
+    u64 largest_free_block = 0;
+    if ( first_level_bitmap_ != 0 ) {
+        // Only the highest non-empty class can hold the largest block, but its members are not sorted
+        const u32 first_level = 63 - static_cast<u32>( std::countl_zero( first_level_bitmap_ ) );
+        const u32 second_level = 31 - static_cast<u32>( std::countl_zero( second_level_bitmaps_[first_level] ) );
+
+        for ( u32 block = free_heads_[first_level][second_level]; block != INVALID_BLOCK;
+              block = blocks_[block].next_free ) {
+            largest_free_block = std::max( largest_free_block, blocks_[block].size );
+        }
+    }
+
+    const u64 free = capacity_ - used_;
+
+    return TlsfStats{
+        .capacity = capacity_,
+        .used = used_,
+        .largest_free_block = largest_free_block,
+        .allocation_count = allocation_count_,
+        .free_block_count = free_block_count_,
+        .fragmentation =
+            free > 0 ? 1.0f - static_cast<f32>( largest_free_block ) / static_cast<f32>( free ) : 0.0f,
+    };
+}
+
+auto TlsfAllocator::get_capacity() const -> u64
+{
+    return capacity_;
+}
+
+auto TlsfAllocator::get_granularity() const -> u64
+{
+    return granularity_;
+}
+
+auto TlsfAllocator::get_used() const -> u64
+{
+    return used_;
+}
+
+auto TlsfAllocator::get_allocation_count() const -> u32
+{
+    return allocation_count_;
+}
+
+auto TlsfAllocator::is_empty() const -> bool
+{
+    return allocation_count_ == 0;
+}
+
+auto TlsfAllocator::size_class( const u64 size ) -> SizeClass
+{
+    // Sizes below SECOND_LEVEL_COUNT map linearly into the first row
+    if ( size < SECOND_LEVEL_COUNT ) {
+        return { 0, static_cast<u32>( size ) };
+    }
+
+    const u32 log2 = 63 - static_cast<u32>( std::countl_zero( size ) );
+    const u32 second_level = static_cast<u32>( size >> ( log2 - SECOND_LEVEL_LOG2 ) ) ^ SECOND_LEVEL_COUNT;
+
+    return { log2 - SECOND_LEVEL_LOG2 + 1, second_level };
+}
+
+auto TlsfAllocator::find_free_block( const u64 size ) const -> u32
+{
+    // Round up to the next class boundary so that any block in the class found is large enough
+    u64 rounded = size;
+    if ( size >= SECOND_LEVEL_COUNT ) {
+        const u32 log2 = 63 - static_cast<u32>( std::countl_zero( size ) );
+        rounded += ( 1ull << ( log2 - SECOND_LEVEL_LOG2 ) ) - 1;
+    }
+
+    auto [first_level, second_level] = size_class( rounded );
+    if ( first_level >= FIRST_LEVEL_COUNT ) {
+        return INVALID_BLOCK;
+    }
+
+    u32 second_level_map = second_level_bitmaps_[first_level] & ( ~0u << second_level );
+    if ( second_level_map == 0 ) {
+        const u64 first_level_map =
+            first_level + 1 < 64 ? first_level_bitmap_ & ( ~0ull << ( first_level + 1 ) ) : 0;
+        if ( first_level_map == 0 ) {
+            return INVALID_BLOCK;
+        }
+
+        first_level = static_cast<u32>( std::countr_zero( first_level_map ) );
+        second_level_map = second_level_bitmaps_[first_level];
+    }
+
+    second_level = static_cast<u32>( std::countr_zero( second_level_map ) );
+    return free_heads_[first_level][second_level];
+}
+
+auto TlsfAllocator::insert_free_block( const u32 block ) -> void
+{
+    const auto [first_level, second_level] = size_class( blocks_[block].size );
+    const u32 head = free_heads_[first_level][second_level];
+
+    blocks_[block].is_free = true;
+    blocks_[block].prev_free = INVALID_BLOCK;
+    blocks_[block].next_free = head;
+    if ( head != INVALID_BLOCK ) {
+        blocks_[head].prev_free = block;
+    }
+
+    free_heads_[first_level][second_level] = block;
+    first_level_bitmap_ |= 1ull << first_level;
+    second_level_bitmaps_[first_level] |= 1u << second_level;
+    ++free_block_count_;
+}
+
+auto TlsfAllocator::remove_free_block( const u32 block ) -> void
+{
+    const auto [first_level, second_level] = size_class( blocks_[block].size );
+    const u32 prev = blocks_[block].prev_free;
+    const u32 next = blocks_[block].next_free;
+
+    if ( prev != INVALID_BLOCK ) {
+        blocks_[prev].next_free = next;
+    } else {
+        free_heads_[first_level][second_level] = next;
+    }
+
+    if ( next != INVALID_BLOCK ) {
+        blocks_[next].prev_free = prev;
+    }
+
+    if ( free_heads_[first_level][second_level] == INVALID_BLOCK ) {
+        second_level_bitmaps_[first_level] &= ~( 1u << second_level );
+        if ( second_level_bitmaps_[first_level] == 0 ) {
+            first_level_bitmap_ &= ~( 1ull << first_level );
+        }
+    }
+
+    blocks_[block].prev_free = INVALID_BLOCK;
+    blocks_[block].next_free = INVALID_BLOCK;
+    --free_block_count_;
+}
+
+// Keeps the first size bytes in block and returns a new block for the rest, neither is put in a free list
+auto TlsfAllocator::split_block( const u32 block, const u64 size ) -> u32
+{
+    assert( size < blocks_[block].size );
+
+    const u32 remainder = new_block();
+    Block&    current = blocks_[block];
+    Block&    rest = blocks_[remainder];
+
+    rest.offset = current.offset + size;
+    rest.size = current.size - size;
+    rest.prev_physical = block;
+    rest.next_physical = current.next_physical;
+    rest.is_free = true;
+    if ( rest.next_physical != INVALID_BLOCK ) {
+        blocks_[rest.next_physical].prev_physical = remainder;
+    }
+
+    current.size = size;
+    current.next_physical = remainder;
+
+    return remainder;
+}
+
+// Absorbs block into its physical predecessor and returns the predecessor
+auto TlsfAllocator::merge_into_prev( const u32 block ) -> u32
+{
+    const u32 prev = blocks_[block].prev_physical;
+    const u32 next = blocks_[block].next_physical;
+    assert( prev != INVALID_BLOCK );
+
+    blocks_[prev].size += blocks_[block].size;
+    blocks_[prev].next_physical = next;
+    if ( next != INVALID_BLOCK ) {
+        blocks_[next].prev_physical = prev;
+    }
+
+    recycle_block( block );
+    return prev;
+}
+
+auto TlsfAllocator::new_block() -> u32
+{
+    u32 block = INVALID_BLOCK;
+    if ( !unused_blocks_.empty() ) {
+        block = unused_blocks_.back();
+        unused_blocks_.pop_back();
+    } else {
+        block = static_cast<u32>( blocks_.size() );
+        blocks_.emplace_back();
+    }
+
+    blocks_[block] = {
+        .offset = 0,
+        .size = 0,
+        .prev_physical = INVALID_BLOCK,
+        .next_physical = INVALID_BLOCK,
+        .prev_free = INVALID_BLOCK,
+        .next_free = INVALID_BLOCK,
+        .is_free = true,
+    };
+
+    return block;
+}
+
+auto TlsfAllocator::recycle_block( const u32 block ) -> void
+{
+    unused_blocks_.push_back( block );
+}
+
+} // namespace mksv
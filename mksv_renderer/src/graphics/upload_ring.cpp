@@ -0,0 +1,193 @@
+#include "mksv/graphics/upload_ring.hpp"
+
+#include "mksv/log.hpp"
+#include "mksv/utils/d3d12_helpers.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace mksv
+{
+
+auto UploadRing::create( ComPtr<D3D12Device> device, Fence& fence, const u64 capacity ) -> std::unique_ptr<UploadRing>
+{
+    const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_UPLOAD );
+    const auto res_desc = d3d12::buffer_resource_desc( capacity );
+
+    ComPtr<ID3D12Resource> buffer{};
+    HRESULT                hr = device->CreateCommittedResource(
+        &heap_props,
+        D3D12_HEAP_FLAG_CREATE_NOT_ZEROED,
+        &res_desc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS( &buffer )
+    );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    // Upload heaps can stay mapped for the lifetime of the resource
+    u8*               mapped = nullptr;
+    const D3D12_RANGE read_range = { .Begin = 0, .End = 0 };
+    hr = buffer->Map( 0, &read_range, reinterpret_cast<void**>( &mapped ) );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return nullptr;
+    }
+
+    return std::unique_ptr<UploadRing>{ new UploadRing( std::move( device ), fence, std::move( buffer ), mapped, capacity ) };
+}
+
+UploadRing::UploadRing(
+    ComPtr<D3D12Device>    device,
+    Fence&                 fence,
+    ComPtr<ID3D12Resource> buffer,
+    u8*                    mapped,
+    const u64              capacity
+)
+    : device_{ std::move( device ) },
+      fence_{ &fence },
+      buffer_{ std::move( buffer ) },
+      mapped_{ mapped },
+      ring_{ capacity },
+      fallback_count_{ 0 }
+{
+}
+
+UploadRing::~UploadRing()
+{
+    buffer_->Unmap( 0, nullptr );
+}
+
+auto UploadRing::allocate( const u64 size, const u64 alignment ) -> std::optional<UploadAllocation>
+{
+    retire();
+
+    std::optional<u64> offset = ring_.allocate( size, alignment );
+
+    while ( !offset && size <= ring_.get_capacity() ) {
+        const auto oldest = ring_.get_oldest_pending_fence();
+        if ( !oldest ) {
+            break;
+        }
+
+        if ( !fence_->wait_for_value( *oldest ) ) {
+            return std::nullopt;
+        }
+
+        retire();
+        offset = ring_.allocate( size, alignment );
+    }
+
+    if ( !offset ) {
+        return allocate_fallback( size );
+    }
+
+    return UploadAllocation{
+        .resource = buffer_.Get(),
+        .offset = *offset,
+        .cpu_address = mapped_ + *offset,
+        .gpu_address = buffer_->GetGPUVirtualAddress() + *offset,
+        .size = size,
+    };
+}
+
+auto UploadRing::upload( const void* data, const u64 size, const u64 alignment ) -> std::optional<UploadAllocation>
+{
+    auto allocation = allocate( size, alignment );
+    if ( allocation ) {
+        std::memcpy( allocation->cpu_address, data, size );
+    }
+
+    return allocation;
+}
+
+auto UploadRing::submit( const u64 fence_value ) -> void
+{
+    ring_.close_batch( fence_value );
+
+    std::scoped_lock lock{ fallback_mutex_ };
+    for ( Fallback& fallback : fallbacks_ ) {
+        if ( fallback.fence_value == OPEN_BATCH ) {
+            fallback.fence_value = fence_value;
+        }
+    }
+}
+
+auto UploadRing::retire() -> void
+{
+    const u64 completed = fence_->get_completed_value();
+    ring_.retire( completed );
+
+    std::scoped_lock lock{ fallback_mutex_ };
+    std::erase_if( fallbacks_, [completed]( const Fallback& fallback ) {
+        return fallback.fence_value != OPEN_BATCH && fallback.fence_value <= completed;
+    } );
+}
+
+auto UploadRing::get_capacity() const -> u64
+{
+    return ring_.get_capacity();
+}
+
+auto UploadRing::get_used() const -> u64
+{
+    return ring_.get_used();
+}
+
+auto UploadRing::get_fallback_count() const -> u64
+{
+    return fallback_count_.load( std::memory_order_relaxed );
+}
+
+auto UploadRing::allocate_fallback( const u64 size ) -> std::optional<UploadAllocation>
+{
+    const auto heap_props = d3d12::heap_properties( D3D12_HEAP_TYPE_UPLOAD );
+    const auto res_desc = d3d12::buffer_resource_desc( size );
+
+    ComPtr<ID3D12Resource> resource{};
+    HRESULT                hr = device_->CreateCommittedResource(
+        &heap_props,
+        D3D12_HEAP_FLAG_CREATE_NOT_ZEROED,
+        &res_desc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS( &resource )
+    );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return std::nullopt;
+    }
+
+    u8*               mapped = nullptr;
+    const D3D12_RANGE read_range = { .Begin = 0, .End = 0 };
+    hr = resource->Map( 0, &read_range, reinterpret_cast<void**>( &mapped ) );
+
+    if ( FAILED( hr ) ) {
+        log_hresult( hr );
+        return std::nullopt;
+    }
+
+    log_warning( L"Upload ring full, using a dedicated {} byte upload buffer", size );
+
+    const UploadAllocation allocation = {
+        .resource = resource.Get(),
+        .offset = 0,
+        .cpu_address = mapped,
+        .gpu_address = resource->GetGPUVirtualAddress(),
+        .size = size,
+    };
+
+    std::scoped_lock lock{ fallback_mutex_ };
+    fallbacks_.push_back( { std::move( resource ), OPEN_BATCH } );
+    fallback_count_.fetch_add( 1, std::memory_order_relaxed );
+
+    return allocation;
+}
+
+} // namespace mksv
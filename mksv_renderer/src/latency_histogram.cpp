@@ -0,0 +1,96 @@
+#include "mksv/latency_histogram.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace mksv
+{
+
+LatencyHistogram::LatencyHistogram()
+    : counts_{},
+      count_{ 0 },
+      sum_{ 0 }
+{
+}
+
+auto LatencyHistogram::add( const u32 microseconds ) -> void
+{
+    const u32 value = std::min( microseconds, MAX_VALUE );
+    ++counts_[get_bucket( value )];
+    ++count_;
+    sum_ += value;
+}
+
+auto LatencyHistogram::remove( const u32 microseconds ) -> void
+{
+    const u32 value = std::min( microseconds, MAX_VALUE );
+    u32&      bucket_count = counts_[get_bucket( value )];
+    assert( bucket_count > 0 && "Removing a value that was not added" );
+
+    --bucket_count;
+    --count_;
+    sum_ -= value;
+}
+
+auto LatencyHistogram::clear() -> void
+{
+    counts_.fill( 0 );
+    count_ = 0;
+    sum_ = 0;
+}
+
+auto LatencyHistogram::get_percentile( const f64 percentile ) const -> u32
+{
+    if ( count_ == 0 ) {
+        return 0;
+    }
+
+    // The rank of the value, counting from 1, the lowest value for percentile 0
+    const f64 clamped = std::clamp( percentile, 0.0, 100.0 );
+    const u32 rank = std::max( static_cast<u32>( std::ceil( clamped / 100.0 * static_cast<f64>( count_ ) ) ), 1u );
+
+    u32 seen = 0;
+    for ( u32 bucket = 0; bucket < BUCKET_COUNT; ++bucket ) {
+        seen += counts_[bucket];
+        if ( seen >= rank ) {
+            return get_bucket_max( bucket );
+        }
+    }
+
+    return MAX_VALUE;
+}
+
+auto LatencyHistogram::get_mean() const -> f64
+{
+    return count_ > 0 ? static_cast<f64>( sum_ ) / static_cast<f64>( count_ ) : 0.0;
+}
+
+auto LatencyHistogram::get_count() const -> u32
+{
+    return count_;
+}
+
+auto LatencyHistogram::get_bucket( const u32 microseconds ) -> u32
+{
+    if ( microseconds < SUB_BUCKET_COUNT ) {
+        return microseconds;
+    }
+
+    // Shifted down until the top SUB_BUCKET_BITS bits remain, which puts it into the upper half of the sub-buckets
+    const u32 shift = static_cast<u32>( std::bit_width( microseconds ) ) - SUB_BUCKET_BITS;
+    return shift * ( SUB_BUCKET_COUNT / 2 ) + ( microseconds >> shift );
+}
+
+auto LatencyHistogram::get_bucket_max( const u32 bucket ) -> u32
+{
+    if ( bucket < SUB_BUCKET_COUNT ) {
+        return bucket;
+    }
+
+    const u32 shift = bucket / ( SUB_BUCKET_COUNT / 2 ) - 1;
+    const u32 sub_bucket = bucket - shift * ( SUB_BUCKET_COUNT / 2 );
+    return ( ( sub_bucket + 1 ) << shift ) - 1;
+}
+
+} // namespace mksv
@@ -1,28 +1,15 @@
 #include "mksv/log.hpp"
 
+#if defined( _WIN32 )
 #include "mksv/mksv_win.hpp"
 #include "mksv/utils/helpers.hpp"
-#include "mksv/utils/string.hpp"
+#endif
 
-#include <algorithm>
 #include <cassert>
-#include <format>
 
 namespace mksv
 {
 
-static auto log( const LogLevel level, const std::wstring_view msg, const std::source_location location ) -> void
-{
-    const auto fmt = std::format(
-        L"[{}]: {} ({}:{})\n",
-        log_level_str( level ),
-        msg,
-        string_to_wstring( location.file_name() ),
-        location.line()
-    );
-    OutputDebugString( fmt.c_str() );
-}
-
 auto log_level_str( const LogLevel level ) -> std::wstring_view
 {
     switch ( level ) {
@@ -38,21 +25,7 @@ auto log_level_str( const LogLevel level ) -> std::wstring_view
     }
 }
 
-auto log_info( const std::wstring_view msg, const std::source_location location ) -> void
-{
-    log( LogLevel::Info, msg, location );
-}
-
-auto log_warning( const std::wstring_view msg, const std::source_location location ) -> void
-{
-    log( LogLevel::Warning, msg, location );
-}
-
-auto log_error( const std::wstring_view msg, const std::source_location location ) -> void
-{
-    log( LogLevel::Error, msg, location );
-}
-
+#if defined( _WIN32 )
 auto log_last_window_error( const std::source_location location ) -> void
 {
     const auto error = get_last_window_error_string();
@@ -63,5 +36,6 @@ auto log_hresult( const u32 hr, const std::source_location location ) -> void
 {
     log_error( windows_error_string( static_cast<DWORD>( hr ) ), location );
 }
+#endif
 
 } // namespace mksv
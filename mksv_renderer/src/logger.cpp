@@ -0,0 +1,389 @@
+#include "mksv/logger.hpp"
+
+#if defined( _WIN32 )
+#include "mksv/mksv_win.hpp"
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+namespace mksv
+{
+namespace detail
+{
+// Records of one thread, written by that thread and read by the logger's. A record is never split by the end of the
+// buffer: the producer skips the bytes left before the end, marking them with a header without decoder if one fits.
+struct LogRing {
+    static inline constexpr u64 MASK = Logger::RING_CAPACITY - 1;
+
+    LogRing()
+        : data{ std::make_unique<std::byte[]>( Logger::RING_CAPACITY ) }
+    {
+        static_assert( ( Logger::RING_CAPACITY & MASK ) == 0 );
+    }
+
+    auto try_reserve( const u32 size ) -> std::byte*
+    {
+        const u32 offset = static_cast<u32>( write_position & MASK );
+        const u32 contiguous = Logger::RING_CAPACITY - offset;
+        const u32 skip = contiguous < size ? contiguous : 0;
+
+        if ( write_position + skip + size - cached_read > Logger::RING_CAPACITY ) {
+            cached_read = read.load( std::memory_order_acquire );
+            if ( write_position + skip + size - cached_read > Logger::RING_CAPACITY ) {
+                return nullptr;
+            }
+        }
+
+        if ( skip > 0 ) {
+            if ( skip >= sizeof( LogRecordHeader ) ) {
+                LogRecordHeader padding{};
+                padding.size = skip;
+                std::memcpy( data.get() + offset, &padding, sizeof( padding ) );
+            }
+            write_position += skip;
+        }
+
+        return data.get() + ( write_position & MASK );
+    }
+
+    auto commit( const u32 size ) -> void
+    {
+        write_position += size;
+        write.store( write_position, std::memory_order_release );
+    }
+
+    std::unique_ptr<std::byte[]> data;
+
+    // Producer side, write_position runs ahead of write between reserving and committing a record
+    alignas( 64 ) std::atomic<u64> write{ 0 };
+    u64 write_position = 0;
+    u64 cached_read = 0;
+
+    alignas( 64 ) std::atomic<u64> read{ 0 };
+};
+} // namespace detail
+
+namespace
+{
+std::atomic<Logger*> current_logger{ nullptr };
+std::atomic<u64>     logger_generation{ 0 };
+
+struct ThreadLog {
+    // The ring of the logger with this generation
+    u64              generation = 0;
+    detail::LogRing* ring = nullptr;
+
+    // Of the record being written, nullptr without a logger
+    Logger* logger = nullptr;
+    u32     reserved_size = 0;
+
+    // Records are formatted and written out right away without a logger
+    std::vector<std::byte> fallback_record;
+    std::wstring           fallback_line;
+};
+
+thread_local ThreadLog thread_log;
+
+auto append_utf8( const std::wstring_view text, std::string& out ) -> void
+{
+    for ( usize i = 0; i < text.size(); ++i ) {
+        u32 c = static_cast<u32>( text[i] );
+        if constexpr ( sizeof( wchar_t ) == 2 ) {
+            if ( c >= 0xD800 && c < 0xDC00 && i + 1 < text.size() ) {
+                const u32 low = static_cast<u32>( text[i + 1] );
+                if ( low >= 0xDC00 && low < 0xE000 ) {
+                    c = 0x10000 + ( ( c - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                    ++i;
+                }
+            }
+        }
+
+        if ( c < 0x80 ) {
+            out.push_back( static_cast<char>( c ) );
+        } else if ( c < 0x800 ) {
+            out.push_back( static_cast<char>( 0xC0 | ( c >> 6 ) ) );
+            out.push_back( static_cast<char>( 0x80 | ( c & 0x3F ) ) );
+        } else if ( c < 0x10000 ) {
+            out.push_back( static_cast<char>( 0xE0 | ( c >> 12 ) ) );
+            out.push_back( static_cast<char>( 0x80 | ( ( c >> 6 ) & 0x3F ) ) );
+            out.push_back( static_cast<char>( 0x80 | ( c & 0x3F ) ) );
+        } else {
+            out.push_back( static_cast<char>( 0xF0 | ( c >> 18 ) ) );
+            out.push_back( static_cast<char>( 0x80 | ( ( c >> 12 ) & 0x3F ) ) );
+            out.push_back( static_cast<char>( 0x80 | ( ( c >> 6 ) & 0x3F ) ) );
+            out.push_back( static_cast<char>( 0x80 | ( c & 0x3F ) ) );
+        }
+    }
+}
+
+// Same layout as the synchronous logging had, "[Level]: message (file:line)"
+auto format_record( const std::byte* const record, std::wstring& line ) -> LogLevel
+{
+    detail::LogRecordHeader header;
+    std::memcpy( &header, record, sizeof( header ) );
+
+    line.clear();
+    std::format_to( std::back_inserter( line ), L"[{}]: ", log_level_str( header.level ) );
+    header.decoder(
+        { header.format, header.format_size },
+        record + detail::align_log_size( sizeof( detail::LogRecordHeader ) ),
+        line
+    );
+
+    // Source file names are ASCII, every byte is taken as one character
+    line += L" (";
+    for ( const char* c = header.location.file_name(); *c != '\0'; ++c ) {
+        line.push_back( static_cast<wchar_t>( static_cast<unsigned char>( *c ) ) );
+    }
+    std::format_to( std::back_inserter( line ), L":{})\n", header.location.line() );
+
+    return header.level;
+}
+
+auto write_fallback( const std::wstring& line ) -> void
+{
+#if defined( _WIN32 )
+    OutputDebugStringW( line.c_str() );
+#else
+    std::string utf8;
+    append_utf8( line, utf8 );
+    std::fwrite( utf8.data(), 1, utf8.size(), stderr );
+#endif
+}
+} // namespace
+
+auto detail::log_reserve( const u32 size ) -> std::byte*
+{
+    ThreadLog&    state = thread_log;
+    Logger* const logger = current_logger.load( std::memory_order_acquire );
+    state.logger = logger;
+    state.reserved_size = size;
+
+    if ( !logger ) {
+        state.fallback_record.resize( size );
+        return state.fallback_record.data();
+    }
+
+    if ( size > Logger::RING_CAPACITY / 2 ) {
+        logger->dropped_count_.fetch_add( 1, std::memory_order_relaxed );
+        return nullptr;
+    }
+
+    // A full ring waits for the logger's thread, which never waits on the threads that log
+    LogRing* const ring = logger->get_thread_ring();
+    for ( ;; ) {
+        std::byte* const record = ring->try_reserve( size );
+        if ( record ) {
+            return record;
+        }
+        logger->wake();
+        std::this_thread::yield();
+    }
+}
+
+auto detail::log_commit( const LogLevel level ) -> void
+{
+    ThreadLog& state = thread_log;
+    if ( !state.logger ) {
+        format_record( state.fallback_record.data(), state.fallback_line );
+        write_fallback( state.fallback_line );
+        return;
+    }
+
+    state.ring->commit( state.reserved_size );
+    if ( level == LogLevel::Error ) {
+        state.logger->wake();
+    }
+}
+
+auto FileLogSink::create( const std::filesystem::path& path ) -> std::unique_ptr<FileLogSink>
+{
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    if ( !file ) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<FileLogSink>( new FileLogSink( std::move( file ) ) );
+}
+
+FileLogSink::FileLogSink( std::ofstream file )
+    : file_{ std::move( file ) }
+{
+}
+
+auto FileLogSink::write( [[maybe_unused]] const LogLevel level, const std::wstring& line ) -> void
+{
+    utf8_.clear();
+    append_utf8( line, utf8_ );
+    file_.write( utf8_.data(), static_cast<std::streamsize>( utf8_.size() ) );
+}
+
+auto FileLogSink::flush() -> void
+{
+    file_.flush();
+}
+
+auto StderrLogSink::write( [[maybe_unused]] const LogLevel level, const std::wstring& line ) -> void
+{
+    utf8_.clear();
+    append_utf8( line, utf8_ );
+    std::fwrite( utf8_.data(), 1, utf8_.size(), stderr );
+}
+
+auto StderrLogSink::flush() -> void
+{
+    std::fflush( stderr );
+}
+
+#if defined( _WIN32 )
+auto DebuggerLogSink::write( [[maybe_unused]] const LogLevel level, const std::wstring& line ) -> void
+{
+    OutputDebugStringW( line.c_str() );
+}
+
+auto DebuggerLogSink::flush() -> void
+{
+}
+#endif
+
+auto Logger::create( std::vector<std::unique_ptr<LogSink>> sinks ) -> std::unique_ptr<Logger>
+{
+    auto logger = std::unique_ptr<Logger>( new Logger( std::move( sinks ) ) );
+
+    Logger* expected = nullptr;
+    if ( !current_logger.compare_exchange_strong( expected, logger.get() ) ) {
+        return nullptr;
+    }
+
+    return logger;
+}
+
+Logger::Logger( std::vector<std::unique_ptr<LogSink>> sinks )
+    : sinks_{ std::move( sinks ) },
+      generation_{ logger_generation.fetch_add( 1 ) + 1 },
+      wake_requested_{ false },
+      flush_requests_{ 0 },
+      flushes_done_{ 0 },
+      dropped_count_{ 0 },
+      thread_{ [this]( const std::stop_token stop_token ) { thread_main( stop_token ); } }
+{
+}
+
+Logger::~Logger()
+{
+    // Later log calls write out on their own thread, the records already in the rings are drained before the thread
+    // exits
+    Logger* expected = this;
+    current_logger.compare_exchange_strong( expected, nullptr );
+
+    thread_.request_stop();
+    wake();
+    thread_.join();
+}
+
+auto Logger::flush() -> void
+{
+    std::unique_lock lock{ wake_mutex_ };
+    const u64        request = ++flush_requests_;
+    wake_requested_.store( true );
+    wake_cv_.notify_one();
+    flushed_cv_.wait( lock, [this, request] { return flushes_done_ >= request; } );
+}
+
+auto Logger::get_dropped_count() const -> u64
+{
+    return dropped_count_.load( std::memory_order_relaxed );
+}
+
+auto Logger::get_thread_ring() -> detail::LogRing*
+{
+    ThreadLog& state = thread_log;
+    if ( state.generation != generation_ ) {
+        auto ring = std::make_unique<detail::LogRing>();
+        state.generation = generation_;
+        state.ring = ring.get();
+
+        const std::lock_guard lock{ rings_mutex_ };
+        rings_.push_back( std::move( ring ) );
+    }
+
+    return state.ring;
+}
+
+auto Logger::wake() -> void
+{
+    // Not synchronized with the thread going to sleep, a wake up that is missed waits for the next FLUSH_INTERVAL
+    if ( !wake_requested_.exchange( true ) ) {
+        wake_cv_.notify_one();
+    }
+}
+
+auto Logger::thread_main( const std::stop_token stop_token ) -> void
+{
+    while ( !stop_token.stop_requested() ) {
+        u64 flush_requests = 0;
+        {
+            std::unique_lock lock{ wake_mutex_ };
+            wake_cv_.wait_for( lock, FLUSH_INTERVAL, [this, &stop_token] {
+                return wake_requested_.load() || stop_token.stop_requested();
+            } );
+            wake_requested_.store( false );
+            flush_requests = flush_requests_;
+        }
+
+        drain();
+
+        {
+            const std::lock_guard lock{ wake_mutex_ };
+            flushes_done_ = flush_requests;
+        }
+        flushed_cv_.notify_all();
+    }
+
+    drain();
+}
+
+auto Logger::drain() -> void
+{
+    // Threads logging for the first time wait for the drain to register their ring
+    const std::lock_guard lock{ rings_mutex_ };
+
+    bool written = false;
+    for ( const std::unique_ptr<detail::LogRing>& ring : rings_ ) {
+        u64       read = ring->read.load( std::memory_order_relaxed );
+        const u64 write = ring->write.load( std::memory_order_acquire );
+
+        while ( read < write ) {
+            const u32 offset = static_cast<u32>( read & detail::LogRing::MASK );
+            const u32 contiguous = RING_CAPACITY - offset;
+            if ( contiguous < sizeof( detail::LogRecordHeader ) ) {
+                read += contiguous;
+                continue;
+            }
+
+            const std::byte* const  record = ring->data.get() + offset;
+            detail::LogRecordHeader header;
+            std::memcpy( &header, record, sizeof( header ) );
+            if ( header.decoder ) {
+                const LogLevel level = format_record( record, line_ );
+                for ( const std::unique_ptr<LogSink>& sink : sinks_ ) {
+                    sink->write( level, line_ );
+                }
+                written = true;
+            }
+            read += header.size;
+        }
+
+        ring->read.store( read, std::memory_order_release );
+    }
+
+    if ( written ) {
+        for ( const std::unique_ptr<LogSink>& sink : sinks_ ) {
+            sink->flush();
+        }
+    }
+}
+
+} // namespace mksv
@@ -0,0 +1,120 @@
+#include "mksv/math/batch.hpp"
+
+#include "mksv/math/mat.hpp"
+#include "mksv/math/simd.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace mksv
+{
+using Elements = f32[4][4];
+
+static auto unpack( const mat4& m, Elements& elements ) -> void
+{
+    static_assert( sizeof( Elements ) == sizeof( mat4 ) );
+    std::memcpy( elements, &m, sizeof( mat4 ) );
+}
+
+auto mul_batch( const std::span<const mat4> lhs, const mat4& rhs, const std::span<mat4> out ) -> void
+{
+    assert( lhs.size() <= out.size() );
+
+    for ( usize i = 0; i < lhs.size(); ++i ) {
+        out[i] = lhs[i] * rhs;
+    }
+}
+
+auto mul_batch( const ConstMat4SoA lhs, const mat4& rhs, const Mat4SoA out, const usize count ) -> void
+{
+    using namespace simd;
+
+    Elements b;
+    unpack( rhs, b );
+
+    usize i = 0;
+    for ( ; i + WIDE_LANE_COUNT <= count; i += WIDE_LANE_COUNT ) {
+        for ( u32 row = 0; row < 4; ++row ) {
+            const f32xw a0 = wide_load( lhs.elements[row * 4 + 0] + i );
+            const f32xw a1 = wide_load( lhs.elements[row * 4 + 1] + i );
+            const f32xw a2 = wide_load( lhs.elements[row * 4 + 2] + i );
+            const f32xw a3 = wide_load( lhs.elements[row * 4 + 3] + i );
+
+            for ( u32 column = 0; column < 4; ++column ) {
+                f32xw acc = wide_mul( a0, wide_splat( b[0][column] ) );
+                acc = wide_madd( a1, wide_splat( b[1][column] ), acc );
+                acc = wide_madd( a2, wide_splat( b[2][column] ), acc );
+                acc = wide_madd( a3, wide_splat( b[3][column] ), acc );
+                wide_store( out.elements[row * 4 + column] + i, acc );
+            }
+        }
+    }
+
+    for ( ; i < count; ++i ) {
+        for ( u32 row = 0; row < 4; ++row ) {
+            for ( u32 column = 0; column < 4; ++column ) {
+                f32 acc = 0.0f;
+                for ( u32 k = 0; k < 4; ++k ) {
+                    acc += lhs.elements[row * 4 + k][i] * b[k][column];
+                }
+                out.elements[row * 4 + column][i] = acc;
+            }
+        }
+    }
+}
+
+auto transform_points_batch( const ConstVec3SoA points, const mat4& m, const Vec4SoA out, const usize count ) -> void
+{
+    using namespace simd;
+
+    Elements e;
+    unpack( m, e );
+
+    f32* const out_streams[4] = { out.x, out.y, out.z, out.w };
+
+    usize i = 0;
+    for ( ; i + WIDE_LANE_COUNT <= count; i += WIDE_LANE_COUNT ) {
+        const f32xw x = wide_load( points.x + i );
+        const f32xw y = wide_load( points.y + i );
+        const f32xw z = wide_load( points.z + i );
+
+        for ( u32 column = 0; column < 4; ++column ) {
+            f32xw acc = wide_splat( e[3][column] );
+            acc = wide_madd( x, wide_splat( e[0][column] ), acc );
+            acc = wide_madd( y, wide_splat( e[1][column] ), acc );
+            acc = wide_madd( z, wide_splat( e[2][column] ), acc );
+            wide_store( out_streams[column] + i, acc );
+        }
+    }
+
+    for ( ; i < count; ++i ) {
+        const vec4 p = transform( { points.x[i], points.y[i], points.z[i], 1.0f }, m );
+        out.x[i] = p.x;
+        out.y[i] = p.y;
+        out.z[i] = p.z;
+        out.w[i] = p.w;
+    }
+}
+
+auto to_soa( const std::span<const mat4> matrices, const Mat4SoA out ) -> void
+{
+    for ( usize i = 0; i < matrices.size(); ++i ) {
+        Elements e;
+        unpack( matrices[i], e );
+        for ( u32 k = 0; k < 16; ++k ) {
+            out.elements[k][i] = e[k / 4][k % 4];
+        }
+    }
+}
+
+auto from_soa( const ConstMat4SoA matrices, const std::span<mat4> out ) -> void
+{
+    for ( usize i = 0; i < out.size(); ++i ) {
+        Elements e;
+        for ( u32 k = 0; k < 16; ++k ) {
+            e[k / 4][k % 4] = matrices.elements[k][i];
+        }
+        std::memcpy( &out[i], e, sizeof( mat4 ) );
+    }
+}
+} // namespace mksv
@@ -0,0 +1,350 @@
+#include "mksv/profiler.hpp"
+
+#include "mksv/log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <fstream>
+#include <string>
+
+namespace mksv
+{
+namespace detail
+{
+// Events of one thread, written by that thread only. Blocks are allocated by the writer and published along with the
+// count, so a reader that loads the count sees every block below it.
+struct ProfileBuffer {
+    u32 thread = 0;
+
+    // The capture the count belongs to, set by the writer after resetting the count for a new capture
+    std::atomic<u64> capture{ 0 };
+    std::atomic<u32> count{ 0 };
+    std::atomic<u32> dropped_count{ 0 };
+
+    std::array<std::unique_ptr<ProfileEvent[]>, Profiler::MAX_BLOCKS> blocks;
+};
+} // namespace detail
+
+namespace
+{
+std::atomic<Profiler*> current_profiler{ nullptr };
+std::atomic<u64>       profiler_generation{ 0 };
+
+struct ThreadProfile {
+    // The buffer of the profiler with this generation
+    u64                    generation = 0;
+    detail::ProfileBuffer* buffer = nullptr;
+};
+
+thread_local ThreadProfile thread_profile;
+
+auto append_json_string( const char* text, std::string& out ) -> void
+{
+    out.push_back( '"' );
+    for ( const char* c = text; *c != '\0'; ++c ) {
+        if ( *c == '"' || *c == '\\' ) {
+            out.push_back( '\\' );
+        }
+        if ( static_cast<unsigned char>( *c ) >= 0x20 ) {
+            out.push_back( *c );
+        }
+    }
+    out.push_back( '"' );
+}
+
+auto record_frame_marker() -> void
+{
+    detail::profile_record(
+        { .name = "Frame", .begin = read_profile_ticks(), .end = 0, .type = ProfileEventType::Frame }
+    );
+}
+} // namespace
+
+auto detail::profile_record( const ProfileEvent& event ) -> void
+{
+    Profiler* const profiler = current_profiler.load( std::memory_order_acquire );
+    if ( !profiler ) {
+        return;
+    }
+
+    ProfileBuffer* const buffer = profiler->get_thread_buffer();
+    const u64            capture = profiler->capture_.load( std::memory_order_relaxed );
+    u32                  count = buffer->count.load( std::memory_order_relaxed );
+    if ( buffer->capture.load( std::memory_order_relaxed ) != capture ) {
+        count = 0;
+        buffer->count.store( 0, std::memory_order_relaxed );
+        buffer->dropped_count.store( 0, std::memory_order_relaxed );
+        buffer->capture.store( capture, std::memory_order_release );
+    }
+
+    const u32 block = count / Profiler::BLOCK_SIZE;
+    if ( block == Profiler::MAX_BLOCKS ) {
+        buffer->dropped_count.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+
+    std::unique_ptr<ProfileEvent[]>& events = buffer->blocks[block];
+    if ( !events ) {
+        events = std::make_unique<ProfileEvent[]>( Profiler::BLOCK_SIZE );
+    }
+
+    events[count % Profiler::BLOCK_SIZE] = event;
+    buffer->count.store( count + 1, std::memory_order_release );
+}
+
+auto detail::profile_frame() -> void
+{
+    Profiler* const profiler = current_profiler.load( std::memory_order_acquire );
+    if ( profiler ) {
+        profiler->on_frame();
+    }
+}
+
+auto Profiler::create() -> std::unique_ptr<Profiler>
+{
+    auto profiler = std::unique_ptr<Profiler>( new Profiler() );
+
+    Profiler* expected = nullptr;
+    if ( !current_profiler.compare_exchange_strong( expected, profiler.get() ) ) {
+        return nullptr;
+    }
+
+    return profiler;
+}
+
+Profiler::Profiler()
+    : generation_{ profiler_generation.fetch_add( 1 ) + 1 },
+      capture_{ 0 },
+      capture_begin_ticks_{ 0 },
+      capture_end_ticks_{ 0 },
+      capture_begin_time_{},
+      reference_ticks_{ read_profile_ticks() },
+      reference_time_{ std::chrono::steady_clock::now() },
+      ticks_per_microsecond_{ 1.0 },
+      dropped_count_{ 0 },
+      frame_capture_pending_{ false },
+      frame_capture_count_{ 0 },
+      frame_capture_frames_{ 0 }
+{
+}
+
+Profiler::~Profiler()
+{
+    detail::profile_capturing.store( false );
+
+    Profiler* expected = this;
+    current_profiler.compare_exchange_strong( expected, nullptr );
+}
+
+auto Profiler::begin_capture() -> void
+{
+    const std::lock_guard lock{ capture_mutex_ };
+    begin_capture_locked();
+}
+
+auto Profiler::end_capture() -> void
+{
+    const std::lock_guard lock{ capture_mutex_ };
+    end_capture_locked();
+}
+
+auto Profiler::capture_frames( const u32 frame_count, std::filesystem::path path ) -> void
+{
+    const std::lock_guard lock{ capture_mutex_ };
+    frame_capture_count_ = std::max( frame_count, 1u );
+    frame_capture_frames_ = 0;
+    frame_capture_path_ = std::move( path );
+    frame_capture_pending_.store( true );
+}
+
+auto Profiler::write_chrome_trace( const std::filesystem::path& path ) const -> bool
+{
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    if ( !file ) {
+        log_error( L"Failed to open {} for the profile capture", path.wstring() );
+        return false;
+    }
+
+    // Zones are complete events, counters counter events and frame markers global instant events. GPU zones go on a
+    // track of their own, named by a metadata event.
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json += std::format(
+        "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"GPU\"}}}}",
+        GPU_TRACK
+    );
+    for ( const CapturedEvent& captured : events_ ) {
+        const ProfileEvent& event = captured.event;
+        json += ",\n{\"name\":";
+        append_json_string( event.name, json );
+
+        const u32 thread = captured.thread;
+        switch ( event.type ) {
+            case ProfileEventType::Zone: {
+                const f64 begin = to_microseconds( event.begin );
+                const f64 end = to_microseconds( event.end );
+                json += std::format(
+                    ",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"ph\":\"X\",\"dur\":{:.3f}}}",
+                    thread,
+                    begin,
+                    end - begin
+                );
+                break;
+            }
+            case ProfileEventType::Counter:
+                json += std::format(
+                    ",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"ph\":\"C\",\"args\":{{\"value\":{}}}}}",
+                    thread,
+                    to_microseconds( event.begin ),
+                    std::bit_cast<f64>( event.end )
+                );
+                break;
+            case ProfileEventType::Frame:
+                json += std::format(
+                    ",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"ph\":\"i\",\"s\":\"g\"}}",
+                    thread,
+                    to_microseconds( event.begin )
+                );
+                break;
+            case ProfileEventType::GpuZone: {
+                const f64 begin = to_microseconds( std::chrono::nanoseconds{ event.begin } );
+                const f64 end = to_microseconds( std::chrono::nanoseconds{ event.end } );
+                json += std::format(
+                    ",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"ph\":\"X\",\"dur\":{:.3f}}}",
+                    GPU_TRACK,
+                    begin,
+                    end - begin
+                );
+                break;
+            }
+        }
+
+        if ( json.size() > 64 * 1024 ) {
+            file.write( json.data(), static_cast<std::streamsize>( json.size() ) );
+            json.clear();
+        }
+    }
+    json += "\n]}\n";
+    file.write( json.data(), static_cast<std::streamsize>( json.size() ) );
+
+    if ( !file ) {
+        log_error( L"Failed to write the profile capture {}", path.wstring() );
+        return false;
+    }
+    return true;
+}
+
+auto Profiler::get_event_count() const -> usize
+{
+    return events_.size();
+}
+
+auto Profiler::get_dropped_count() const -> u64
+{
+    return dropped_count_;
+}
+
+auto Profiler::get_thread_buffer() -> detail::ProfileBuffer*
+{
+    ThreadProfile& state = thread_profile;
+    if ( state.generation != generation_ ) {
+        auto buffer = std::make_unique<detail::ProfileBuffer>();
+        state.generation = generation_;
+        state.buffer = buffer.get();
+
+        const std::lock_guard lock{ buffers_mutex_ };
+        buffer->thread = static_cast<u32>( buffers_.size() );
+        buffers_.push_back( std::move( buffer ) );
+    }
+
+    return state.buffer;
+}
+
+auto Profiler::on_frame() -> void
+{
+    if ( !frame_capture_pending_.load( std::memory_order_relaxed ) ) {
+        if ( is_profile_capturing() ) {
+            record_frame_marker();
+        }
+        return;
+    }
+
+    // The capture begins and ends on a frame marker, both markers are part of it
+    const std::lock_guard lock{ capture_mutex_ };
+    if ( !frame_capture_pending_.load() ) {
+        return;
+    }
+
+    if ( frame_capture_frames_ == 0 && !is_profile_capturing() ) {
+        begin_capture_locked();
+    }
+    record_frame_marker();
+
+    if ( frame_capture_frames_++ == frame_capture_count_ ) {
+        end_capture_locked();
+        frame_capture_pending_.store( false );
+        if ( write_chrome_trace( frame_capture_path_ ) ) {
+            log_info(
+                L"Captured {} frames with {} events to {}",
+                frame_capture_count_,
+                events_.size(),
+                frame_capture_path_.wstring()
+            );
+        }
+    }
+}
+
+auto Profiler::begin_capture_locked() -> void
+{
+    // Threads reset their buffers when they next record and see the new capture
+    capture_begin_ticks_ = read_profile_ticks();
+    capture_begin_time_ = std::chrono::steady_clock::now();
+    capture_.fetch_add( 1, std::memory_order_relaxed );
+    detail::profile_capturing.store( true, std::memory_order_relaxed );
+}
+
+auto Profiler::end_capture_locked() -> void
+{
+    if ( !is_profile_capturing() ) {
+        return;
+    }
+
+    detail::profile_capturing.store( false, std::memory_order_relaxed );
+    capture_end_ticks_ = read_profile_ticks();
+    const auto end_time = std::chrono::steady_clock::now();
+
+    const std::chrono::duration<f64, std::micro> elapsed = end_time - reference_time_;
+    if ( elapsed.count() > 0.0 && capture_end_ticks_ > reference_ticks_ ) {
+        ticks_per_microsecond_ = static_cast<f64>( capture_end_ticks_ - reference_ticks_ ) / elapsed.count();
+    }
+
+    // Events recorded by threads that have not seen the end of the capture yet are left out
+    const u64 capture = capture_.load( std::memory_order_relaxed );
+    events_.clear();
+    dropped_count_ = 0;
+
+    const std::lock_guard lock{ buffers_mutex_ };
+    for ( const std::unique_ptr<detail::ProfileBuffer>& buffer : buffers_ ) {
+        if ( buffer->capture.load( std::memory_order_acquire ) != capture ) {
+            continue;
+        }
+
+        const u32 count = buffer->count.load( std::memory_order_acquire );
+        for ( u32 i = 0; i < count; ++i ) {
+            events_.push_back( { .event = buffer->blocks[i / BLOCK_SIZE][i % BLOCK_SIZE], .thread = buffer->thread } );
+        }
+        dropped_count_ += buffer->dropped_count.load( std::memory_order_relaxed );
+    }
+}
+
+auto Profiler::to_microseconds( const u64 ticks ) const -> f64
+{
+    return ( static_cast<f64>( ticks ) - static_cast<f64>( capture_begin_ticks_ ) ) / ticks_per_microsecond_;
+}
+
+auto Profiler::to_microseconds( const std::chrono::nanoseconds time ) const -> f64
+{
+    return std::chrono::duration<f64, std::micro>( time - capture_begin_time_.time_since_epoch() ).count();
+}
+
+} // namespace mksv
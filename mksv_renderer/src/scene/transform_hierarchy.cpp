@@ -0,0 +1,365 @@
+#include "mksv/scene/transform_hierarchy.hpp"
+
+#include "mksv/math/mat.hpp"
+#include "mksv/math/quat.hpp"
+#include "mksv/math/simd.hpp"
+#include "mksv/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace mksv
+{
+
+auto TransformHierarchy::clear() -> void
+{
+    locations_.clear();
+    levels_.clear();
+}
+
+auto TransformHierarchy::create(
+    const TransformId parent,
+    const vec3&       translation,
+    const quat&       rotation,
+    const vec3&       scale
+) -> TransformId
+{
+    u32 depth = 0;
+    u32 parent_index = INVALID_TRANSFORM;
+    if ( parent != INVALID_TRANSFORM ) {
+        assert( parent < get_count() );
+        depth = locations_[parent].level + 1;
+        parent_index = locations_[parent].index;
+    }
+
+    if ( depth == levels_.size() ) {
+        levels_.push_back( Level{} );
+    }
+
+    Level&            level = levels_[depth];
+    const TransformId node = get_count();
+    const Location    location = { .level = depth, .index = static_cast<u32>( level.nodes.size() ) };
+
+    level.translation_x.push_back( translation.x );
+    level.translation_y.push_back( translation.y );
+    level.translation_z.push_back( translation.z );
+    level.rotation_x.push_back( rotation.x );
+    level.rotation_y.push_back( rotation.y );
+    level.rotation_z.push_back( rotation.z );
+    level.rotation_w.push_back( rotation.w );
+    level.scale_x.push_back( scale.x );
+    level.scale_y.push_back( scale.y );
+    level.scale_z.push_back( scale.z );
+    level.parents.push_back( parent_index );
+    level.nodes.push_back( node );
+    level.world.push_back( mat4_identity() );
+    level.dirty.push_back( 0 );
+    level.changed.push_back( 0 );
+
+    locations_.push_back( location );
+    mark_dirty( location );
+    return node;
+}
+
+auto TransformHierarchy::set_local(
+    const TransformId node,
+    const vec3&       translation,
+    const quat&       rotation,
+    const vec3&       scale
+) -> void
+{
+    set_translation( node, translation );
+    set_rotation( node, rotation );
+    set_scale( node, scale );
+}
+
+auto TransformHierarchy::set_translation( const TransformId node, const vec3& translation ) -> void
+{
+    assert( node < get_count() );
+
+    const Location& location = locations_[node];
+    Level&          level = levels_[location.level];
+    level.translation_x[location.index] = translation.x;
+    level.translation_y[location.index] = translation.y;
+    level.translation_z[location.index] = translation.z;
+    mark_dirty( location );
+}
+
+auto TransformHierarchy::set_rotation( const TransformId node, const quat& rotation ) -> void
+{
+    assert( node < get_count() );
+
+    const Location& location = locations_[node];
+    Level&          level = levels_[location.level];
+    level.rotation_x[location.index] = rotation.x;
+    level.rotation_y[location.index] = rotation.y;
+    level.rotation_z[location.index] = rotation.z;
+    level.rotation_w[location.index] = rotation.w;
+    mark_dirty( location );
+}
+
+auto TransformHierarchy::set_scale( const TransformId node, const vec3& scale ) -> void
+{
+    assert( node < get_count() );
+
+    const Location& location = locations_[node];
+    Level&          level = levels_[location.level];
+    level.scale_x[location.index] = scale.x;
+    level.scale_y[location.index] = scale.y;
+    level.scale_z[location.index] = scale.z;
+    mark_dirty( location );
+}
+
+auto TransformHierarchy::update( JobSystem* const jobs ) -> u32
+{
+    MKSV_PROFILE_ZONE( "TransformHierarchy::update" );
+
+    u32 updated_count = 0;
+    for ( u32 depth = 0; depth < levels_.size(); ++depth ) {
+        Level&       level = levels_[depth];
+        const Level* parent = depth > 0 ? &levels_[depth - 1] : nullptr;
+
+        // The flags of the previous update, the level above has already moved on to this update's
+        if ( level.changed_count > 0 ) {
+            std::ranges::fill( level.changed, u8{ 0 } );
+            level.changed_count = 0;
+        }
+
+        if ( level.dirty_count == 0 && ( !parent || parent->changed_count == 0 ) ) {
+            continue;
+        }
+
+        const u32 count = static_cast<u32>( level.nodes.size() );
+        if ( !jobs || count < 2 * MIN_BLOCK_SIZE ) {
+            level.changed_count = update_range( level, parent, 0, count );
+        } else {
+            // Blocks are a multiple of the SIMD width, only the last one of the level has a scalar tail
+            const u32        block_count = ( count + MIN_BLOCK_SIZE - 1 ) / MIN_BLOCK_SIZE;
+            std::atomic<u32> changed_count = 0;
+            jobs->parallel_for( block_count, 1, [&]( const u32 first_block, const u32 blocks ) {
+                const u32 first = first_block * MIN_BLOCK_SIZE;
+                const u32 end = std::min( count, ( first_block + blocks ) * MIN_BLOCK_SIZE );
+                changed_count.fetch_add( update_range( level, parent, first, end ), std::memory_order_relaxed );
+            } );
+            level.changed_count = changed_count.load( std::memory_order_relaxed );
+        }
+
+        if ( level.dirty_count > 0 ) {
+            std::ranges::fill( level.dirty, u8{ 0 } );
+            level.dirty_count = 0;
+        }
+        updated_count += level.changed_count;
+    }
+
+    return updated_count;
+}
+
+auto TransformHierarchy::get_world( const TransformId node ) const -> const mat4&
+{
+    assert( node < get_count() );
+
+    const Location& location = locations_[node];
+    return levels_[location.level].world[location.index];
+}
+
+auto TransformHierarchy::get_rotation( const TransformId node ) const -> quat
+{
+    assert( node < get_count() );
+
+    const Location& location = locations_[node];
+    const Level&    level = levels_[location.level];
+    return {
+        level.rotation_x[location.index],
+        level.rotation_y[location.index],
+        level.rotation_z[location.index],
+        level.rotation_w[location.index],
+    };
+}
+
+auto TransformHierarchy::get_parent( const TransformId node ) const -> TransformId
+{
+    assert( node < get_count() );
+
+    const Location& location = locations_[node];
+    if ( location.level == 0 ) {
+        return INVALID_TRANSFORM;
+    }
+    return levels_[location.level - 1].nodes[levels_[location.level].parents[location.index]];
+}
+
+auto TransformHierarchy::get_depth( const TransformId node ) const -> u32
+{
+    assert( node < get_count() );
+
+    return locations_[node].level;
+}
+
+auto TransformHierarchy::get_count() const -> u32
+{
+    return static_cast<u32>( locations_.size() );
+}
+
+auto TransformHierarchy::get_level_count() const -> u32
+{
+    return static_cast<u32>( levels_.size() );
+}
+
+auto TransformHierarchy::mark_dirty( const Location& location ) -> void
+{
+    Level& level = levels_[location.level];
+    if ( level.dirty[location.index] == 0 ) {
+        level.dirty[location.index] = 1;
+        ++level.dirty_count;
+    }
+}
+
+auto TransformHierarchy::update_range( Level& level, const Level* parent, const u32 first, const u32 end ) -> u32
+{
+    using namespace simd;
+
+    constexpr u32 lane_count = static_cast<u32>( WIDE_LANE_COUNT );
+    static_assert( lane_count <= sizeof( u64 ) );
+
+    // The flags are 0 or 1, they are combined without a branch per node since only a few nodes may need an update
+    const u8*  dirty = level.dirty.data();
+    const u32* parents = level.parents.data();
+    const u8*  parent_changed = parent && parent->changed_count > 0 ? parent->changed.data() : nullptr;
+    const auto needs_update = [=]( const u32 i ) -> u32 {
+        u32 flag = dirty[i];
+        if ( parent_changed ) {
+            flag |= parent_changed[parents[i]];
+        }
+        return flag;
+    };
+
+    u32 changed_count = 0;
+    u32 i = first;
+    for ( ; i + lane_count <= end; i += lane_count ) {
+        // With an unchanged parent level only dirty nodes are updated, batches without any are skipped at once
+        if ( !parent_changed ) {
+            u64 flags = 0;
+            std::memcpy( &flags, dirty + i, lane_count );
+            if ( flags == 0 ) {
+                continue;
+            }
+        }
+
+        u32 lanes = 0;
+        for ( u32 lane = 0; lane < lane_count; ++lane ) {
+            lanes |= needs_update( i + lane ) << lane;
+        }
+        if ( lanes == 0 ) {
+            continue;
+        }
+
+        // The rows of the local matrix as in trs(), the rotation matrix rows scaled and the translation
+        const f32xw x = wide_load( level.rotation_x.data() + i );
+        const f32xw y = wide_load( level.rotation_y.data() + i );
+        const f32xw z = wide_load( level.rotation_z.data() + i );
+        const f32xw w = wide_load( level.rotation_w.data() + i );
+        const f32xw xx = wide_mul( x, x );
+        const f32xw yy = wide_mul( y, y );
+        const f32xw zz = wide_mul( z, z );
+        const f32xw xy = wide_mul( x, y );
+        const f32xw xz = wide_mul( x, z );
+        const f32xw yz = wide_mul( y, z );
+        const f32xw wx = wide_mul( w, x );
+        const f32xw wy = wide_mul( w, y );
+        const f32xw wz = wide_mul( w, z );
+
+        const f32xw two = wide_splat( 2.0f );
+        const f32xw scale_x = wide_mul( two, wide_load( level.scale_x.data() + i ) );
+        const f32xw scale_y = wide_mul( two, wide_load( level.scale_y.data() + i ) );
+        const f32xw scale_z = wide_mul( two, wide_load( level.scale_z.data() + i ) );
+
+        // ( 1 - 2 a ) s is computed as ( 1 / 2 - a ) 2 s
+        const f32xw half = wide_splat( 0.5f );
+        const f32xw local[4][3] = {
+            {
+                wide_mul( wide_sub( half, wide_add( yy, zz ) ), scale_x ),
+                wide_mul( wide_add( xy, wz ), scale_x ),
+                wide_mul( wide_sub( xz, wy ), scale_x ),
+            },
+            {
+                wide_mul( wide_sub( xy, wz ), scale_y ),
+                wide_mul( wide_sub( half, wide_add( xx, zz ) ), scale_y ),
+                wide_mul( wide_add( yz, wx ), scale_y ),
+            },
+            {
+                wide_mul( wide_add( xz, wy ), scale_z ),
+                wide_mul( wide_sub( yz, wx ), scale_z ),
+                wide_mul( wide_sub( half, wide_add( xx, yy ) ), scale_z ),
+            },
+            {
+                wide_load( level.translation_x.data() + i ),
+                wide_load( level.translation_y.data() + i ),
+                wide_load( level.translation_z.data() + i ),
+            },
+        };
+
+        // Only the first three columns are computed, the last one of an affine matrix is ( 0, 0, 0, 1 )
+        alignas( 64 ) f32 world[4][3][lane_count];
+        if ( parent ) {
+            alignas( 64 ) f32 parent_world[4][3][lane_count];
+            for ( u32 lane = 0; lane < lane_count; ++lane ) {
+                const mat4& m = parent->world[level.parents[i + lane]];
+                for ( u32 row = 0; row < 4; ++row ) {
+                    parent_world[row][0][lane] = m.r[row].x;
+                    parent_world[row][1][lane] = m.r[row].y;
+                    parent_world[row][2][lane] = m.r[row].z;
+                }
+            }
+
+            for ( u32 column = 0; column < 3; ++column ) {
+                const f32xw parent_x = wide_load( parent_world[0][column] );
+                const f32xw parent_y = wide_load( parent_world[1][column] );
+                const f32xw parent_z = wide_load( parent_world[2][column] );
+                for ( u32 row = 0; row < 4; ++row ) {
+                    f32xw v = row == 3 ? wide_load( parent_world[3][column] ) : wide_splat( 0.0f );
+                    v = wide_madd( local[row][0], parent_x, v );
+                    v = wide_madd( local[row][1], parent_y, v );
+                    v = wide_madd( local[row][2], parent_z, v );
+                    wide_store( world[row][column], v );
+                }
+            }
+        } else {
+            for ( u32 row = 0; row < 4; ++row ) {
+                for ( u32 column = 0; column < 3; ++column ) {
+                    wide_store( world[row][column], local[row][column] );
+                }
+            }
+        }
+
+        for ( ; lanes != 0; lanes &= lanes - 1 ) {
+            const u32 lane = static_cast<u32>( std::countr_zero( lanes ) );
+            mat4&     m = level.world[i + lane];
+            for ( u32 row = 0; row < 4; ++row ) {
+                m.r[row] = { world[row][0][lane], world[row][1][lane], world[row][2][lane], row == 3 ? 1.0f : 0.0f };
+            }
+            level.changed[i + lane] = 1;
+            ++changed_count;
+        }
+    }
+
+    for ( ; i < end; ++i ) {
+        if ( needs_update( i ) == 0 ) {
+            continue;
+        }
+
+        const mat4 local = trs(
+            { level.translation_x[i], level.translation_y[i], level.translation_z[i] },
+            { level.rotation_x[i], level.rotation_y[i], level.rotation_z[i], level.rotation_w[i] },
+            { level.scale_x[i], level.scale_y[i], level.scale_z[i] }
+        );
+        level.world[i] = parent ? local * parent->world[level.parents[i]] : local;
+        level.changed[i] = 1;
+        ++changed_count;
+    }
+
+    return changed_count;
+}
+
+} // namespace mksv
@@ -2,6 +2,63 @@
 
 namespace mksv::d3d12
 {
+namespace
+{
+auto get_position_format( const PositionEncoding encoding ) -> DXGI_FORMAT
+{
+    switch ( encoding ) {
+        case PositionEncoding::Float32:
+            return DXGI_FORMAT_R32G32B32_FLOAT;
+        case PositionEncoding::Half:
+            return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        case PositionEncoding::Snorm16:
+            return DXGI_FORMAT_R16G16B16A16_SNORM;
+    }
+
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+auto get_color_format( const ColorEncoding encoding ) -> DXGI_FORMAT
+{
+    switch ( encoding ) {
+        case ColorEncoding::Float32:
+            return DXGI_FORMAT_R32G32B32_FLOAT;
+        case ColorEncoding::Unorm8:
+            return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+auto get_normal_format( const NormalEncoding encoding ) -> DXGI_FORMAT
+{
+    switch ( encoding ) {
+        case NormalEncoding::None:
+            return DXGI_FORMAT_UNKNOWN;
+        case NormalEncoding::Float32:
+            return DXGI_FORMAT_R32G32B32_FLOAT;
+        case NormalEncoding::Octahedral:
+            return DXGI_FORMAT_R16G16_SNORM;
+    }
+
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+auto get_uv_format( const UvEncoding encoding ) -> DXGI_FORMAT
+{
+    switch ( encoding ) {
+        case UvEncoding::None:
+            return DXGI_FORMAT_UNKNOWN;
+        case UvEncoding::Float32:
+            return DXGI_FORMAT_R32G32_FLOAT;
+        case UvEncoding::Half:
+            return DXGI_FORMAT_R16G16_FLOAT;
+    }
+
+    return DXGI_FORMAT_UNKNOWN;
+}
+} // namespace
+
 auto transition_barrier( ID3D12Resource* resource, const D3D12_RESOURCE_STATES before, const D3D12_RESOURCE_STATES after )
     -> D3D12_RESOURCE_BARRIER
 {
@@ -19,6 +76,29 @@ auto transition_barrier( ID3D12Resource* resource, const D3D12_RESOURCE_STATES b
     };
 }
 
+auto aliasing_barrier( ID3D12Resource* before, ID3D12Resource* after ) -> D3D12_RESOURCE_BARRIER
+{
+    const D3D12_RESOURCE_ALIASING_BARRIER aliasing = {
+        .pResourceBefore = before,
+        .pResourceAfter = after,
+    };
+
+    return {
+        .Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING,
+        .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+        .Aliasing = aliasing,
+    };
+}
+
+auto uav_barrier( ID3D12Resource* resource ) -> D3D12_RESOURCE_BARRIER
+{
+    return {
+        .Type = D3D12_RESOURCE_BARRIER_TYPE_UAV,
+        .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+        .UAV = { .pResource = resource },
+    };
+}
+
 auto heap_properties( const D3D12_HEAP_TYPE type ) -> D3D12_HEAP_PROPERTIES
 {
     return {
@@ -71,4 +151,64 @@ auto create_root_constant(
     };
 }
 
+auto create_root_descriptor(
+    const D3D12_ROOT_PARAMETER_TYPE type,
+    const u32                       shader_register,
+    const u32                       register_space,
+    const D3D12_SHADER_VISIBILITY   visibility
+) -> D3D12_ROOT_PARAMETER
+{
+    const D3D12_ROOT_DESCRIPTOR descriptor = {
+        .ShaderRegister = shader_register,
+        .RegisterSpace = register_space,
+    };
+
+    return D3D12_ROOT_PARAMETER{
+        .ParameterType = type,
+        .Descriptor = descriptor,
+        .ShaderVisibility = visibility,
+    };
+}
+
+auto shader_bytecode( const std::span<const u8> bytecode ) -> D3D12_SHADER_BYTECODE
+{
+    return {
+        .pShaderBytecode = bytecode.data(),
+        .BytecodeLength = bytecode.size(),
+    };
+}
+
+auto input_elements( const VertexLayout& layout ) -> std::vector<D3D12_INPUT_ELEMENT_DESC>
+{
+    const struct {
+        VertexAttribute attribute;
+        const char*     semantic_name;
+        DXGI_FORMAT     format;
+    } attributes[VERTEX_ATTRIBUTE_COUNT] = {
+        { VertexAttribute::Position, "POSITION", get_position_format( layout.position ) },
+        { VertexAttribute::Color, "COLOR", get_color_format( layout.color ) },
+        { VertexAttribute::Normal, "NORMAL", get_normal_format( layout.normal ) },
+        { VertexAttribute::Uv, "TEXCOORD", get_uv_format( layout.uv ) },
+    };
+
+    std::vector<D3D12_INPUT_ELEMENT_DESC> elements;
+    for ( const auto& [attribute, semantic_name, format] : attributes ) {
+        if ( format == DXGI_FORMAT_UNKNOWN ) {
+            continue;
+        }
+
+        elements.push_back( {
+            .SemanticName = semantic_name,
+            .SemanticIndex = 0,
+            .Format = format,
+            .InputSlot = 0,
+            .AlignedByteOffset = get_attribute_offset( layout, attribute ),
+            .InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+            .InstanceDataStepRate = 0,
+        } );
+    }
+
+    return elements;
+}
+
 } // namespace mksv::d3d12
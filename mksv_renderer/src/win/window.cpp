@@ -1,6 +1,7 @@
 #include "mksv/win/window.hpp"
 
 #include "mksv/log.hpp"
+#include "mksv/profiler.hpp"
 #include "mksv/utils/helpers.hpp"
 
 #include <cassert>
@@ -12,7 +13,8 @@ auto Window::create(
     const WindowProps          props,
     ComPtr<DXGIFactory>        factory,
     ComPtr<ID3D12CommandQueue> queue,
-    ComPtr<D3D12Device>        device
+    ComPtr<D3D12Device>        device,
+    DescriptorHeap&            rtv_heap
 ) -> std::unique_ptr<Window>
 {
     RECT window_rect =
@@ -69,60 +71,62 @@ auto Window::create(
         return nullptr;
     }
 
-    const D3D12_DESCRIPTOR_HEAP_DESC heap_desc = {
-        .Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
-        .NumDescriptors = Window::BACK_BUFFER_COUNT,
-        .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
-        .NodeMask = 0,
-    };
-    ComPtr<ID3D12DescriptorHeap> rtv_descriptor_heap{};
-    hr = device->CreateDescriptorHeap( &heap_desc, IID_PPV_ARGS( &rtv_descriptor_heap ) );
-    if ( FAILED( hr ) ) {
-        log_hresult( hr );
-        DestroyWindow( h_wnd );
-        return nullptr;
-    }
+    assert( rtv_heap.get_type() == D3D12_DESCRIPTOR_HEAP_TYPE_RTV );
 
-    const u32 rtv_descriptor_size = device->GetDescriptorHandleIncrementSize( D3D12_DESCRIPTOR_HEAP_TYPE_RTV );
+    BackBuffers       back_buffers;
+    RenderTargetViews render_target_views{};
+    u32               rtv_count = 0;
 
-    BackBuffers                 back_buffers;
-    D3D12_CPU_DESCRIPTOR_HANDLE rtv_handle = rtv_descriptor_heap->GetCPUDescriptorHandleForHeapStart();
+    const auto release_views = [&]() {
+        for ( u32 i = 0; i < rtv_count; ++i ) {
+            rtv_heap.free( render_target_views[i] );
+        }
+    };
 
     for ( u32 i = 0; i < back_buffers.size(); ++i ) {
         hr = swapchain->GetBuffer( i, IID_PPV_ARGS( &back_buffers[i] ) );
         if ( FAILED( hr ) ) {
             log_hresult( hr );
+            release_views();
             DestroyWindow( h_wnd );
             return nullptr;
         }
 
-        device->CreateRenderTargetView( back_buffers[i].Get(), nullptr, rtv_handle );
-        rtv_handle.ptr += rtv_descriptor_size;
+        const auto rtv = rtv_heap.allocate();
+        if ( !rtv ) {
+            release_views();
+            DestroyWindow( h_wnd );
+            return nullptr;
+        }
+
+        render_target_views[i] = *rtv;
+        ++rtv_count;
+        device->CreateRenderTargetView( back_buffers[i].Get(), nullptr, rtv->cpu );
     }
 
     return std::unique_ptr<Window>{ new Window(
         h_wnd,
         props,
         std::move( swapchain ),
-        std::move( rtv_descriptor_heap ),
-        rtv_descriptor_size,
+        rtv_heap,
+        render_target_views,
         std::move( back_buffers )
     ) };
 }
 
 Window::Window(
-    const HWND                   h_wnd,
-    WindowProps                  props,
-    ComPtr<DXGISwapChain>        swapchain,
-    ComPtr<ID3D12DescriptorHeap> descriptor_heap,
-    const u32                    descriptor_size,
-    BackBuffers                  back_buffers
+    const HWND            h_wnd,
+    WindowProps           props,
+    ComPtr<DXGISwapChain> swapchain,
+    DescriptorHeap&       rtv_heap,
+    RenderTargetViews     render_target_views,
+    BackBuffers           back_buffers
 )
     : h_wnd_{ h_wnd },
       props_{ std::move( props ) },
       swapchain_{ std::move( swapchain ) },
-      rtv_descriptor_heap_{ std::move( descriptor_heap ) },
-      rtv_descriptor_size_{ descriptor_size },
+      rtv_heap_{ &rtv_heap },
+      render_target_views_{ render_target_views },
       back_buffers_{ std::move( back_buffers ) }
 {
 }
@@ -131,12 +135,12 @@ Window::Window( Window&& other )
     : h_wnd_{ other.h_wnd_ },
       props_{ std::move( other.props_ ) },
       swapchain_{ std::move( other.swapchain_ ) },
-      rtv_descriptor_heap_{ std::move( other.rtv_descriptor_heap_ ) },
-      rtv_descriptor_size_{ other.rtv_descriptor_size_ },
+      rtv_heap_{ other.rtv_heap_ },
+      render_target_views_{ other.render_target_views_ },
       back_buffers_{ std::move( other.back_buffers_ ) }
 {
     other.h_wnd_ = nullptr;
-    other.rtv_descriptor_size_ = 0;
+    other.rtv_heap_ = nullptr;
 }
 
 auto Window::operator=( Window&& other ) -> Window&
@@ -148,17 +152,23 @@ auto Window::operator=( Window&& other ) -> Window&
     h_wnd_ = other.h_wnd_;
     props_ = std::move( other.props_ );
     swapchain_ = std::move( other.swapchain_ );
-    rtv_descriptor_heap_ = std::move( other.rtv_descriptor_heap_ );
-    rtv_descriptor_size_ = other.rtv_descriptor_size_;
+    rtv_heap_ = other.rtv_heap_;
+    render_target_views_ = other.render_target_views_;
     back_buffers_ = std::move( other.back_buffers_ );
     other.h_wnd_ = nullptr;
-    other.rtv_descriptor_size_ = 0;
+    other.rtv_heap_ = nullptr;
 
     return *this;
 }
 
 Window::~Window()
 {
+    if ( rtv_heap_ ) {
+        for ( const Descriptor& rtv : render_target_views_ ) {
+            rtv_heap_->free( rtv );
+        }
+    }
+
     DestroyWindow( h_wnd_ );
 }
 
@@ -185,15 +195,14 @@ auto Window::get_current_back_buffer_index() const -> u32
 
 auto Window::get_render_target_view( const u32 index ) const -> D3D12_CPU_DESCRIPTOR_HANDLE
 {
-    D3D12_CPU_DESCRIPTOR_HANDLE handle = rtv_descriptor_heap_->GetCPUDescriptorHandleForHeapStart();
-
-    handle.ptr += index * rtv_descriptor_size_;
-
-    return handle;
+    assert( index < Window::BACK_BUFFER_COUNT );
+    return render_target_views_[index].cpu;
 }
 
 auto Window::present( const bool v_sync ) -> HRESULT
 {
+    MKSV_PROFILE_ZONE( "Window::present" );
+
     return swapchain_->Present( v_sync ? 1u : 0u, 0 );
 }
 
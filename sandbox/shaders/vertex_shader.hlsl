@@ -4,15 +4,24 @@ struct Output {
 };
 
 struct Params {
-    matrix mvp;
+    matrix view_projection;
+    matrix dequantization;
+};
+
+// Written by the CPU in its own row major layout, so the transforms need no transposing
+struct Instance {
+    row_major float4x4 world;
 };
 
 ConstantBuffer<Params> params : register(b0);
+StructuredBuffer<Instance> instances : register(t0);
 
-Output main(float3 pos : POSITION, float3 color : COLOR) {
+Output main(float3 pos : POSITION, float3 color : COLOR, uint instance : SV_InstanceID) {
     Output output;
 
-    output.Position = mul(float4(pos, 1.0f), params.mvp);
+    const float4 model = mul(float4(pos, 1.0f), params.dequantization);
+    const float4 world = mul(model, instances[instance].world);
+    output.Position = mul(world, params.view_projection);
     output.Color = float4(color, 1.0f);
 
     return output;
@@ -1,11 +1,69 @@
 #include <mksv/common/types.hpp>
 #include <mksv/engine.hpp>
 #include <mksv/log.hpp>
+#include <mksv/logger.hpp>
+#include <mksv/math/quat.hpp>
+#include <mksv/math/types.hpp>
 #include <mksv/mksv_win.hpp>
+#include <mksv/profiler.hpp>
+#include <mksv/scene/transform_hierarchy.hpp>
 #include <mksv/utils/helpers.hpp>
 #include <mksv/win/window.hpp>
 
 #include <crtdbg.h>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// 100k cubes, a grid of CUBE_GRID_X * CUBE_GRID_Y * CUBE_GRID_Z centered on the origin
+constexpr u32 CUBE_GRID_X = 50;
+constexpr u32 CUBE_GRID_Y = 40;
+constexpr u32 CUBE_GRID_Z = 50;
+constexpr f32 CUBE_SPACING = 2.0f;
+
+// Every CUBE_SPIN_INTERVAL-th cube spins, the rest of the hierarchy stays clean from frame to frame
+constexpr u32 CUBE_SPIN_INTERVAL = 100;
+
+// Frames captured after startup with --profile
+constexpr u32 PROFILE_FRAME_COUNT = 120;
+
+// Frames between the frame statistics dumps with --frame-stats
+constexpr u32 FRAME_STATS_DUMP_INTERVAL = 1000;
+
+auto add_cube_grid( mksv::Engine& engine ) -> void
+{
+    const mksv::vec3 origin = {
+        -0.5f * CUBE_SPACING * static_cast<f32>( CUBE_GRID_X - 1 ),
+        -0.5f * CUBE_SPACING * static_cast<f32>( CUBE_GRID_Y - 1 ),
+        -0.5f * CUBE_SPACING * static_cast<f32>( CUBE_GRID_Z - 1 ),
+    };
+
+    u32 cube_count = 0;
+    for ( u32 z = 0; z < CUBE_GRID_Z; ++z ) {
+        for ( u32 y = 0; y < CUBE_GRID_Y; ++y ) {
+            for ( u32 x = 0; x < CUBE_GRID_X; ++x ) {
+                const mksv::TransformId cube = engine.add_object(
+                    {
+                        origin.x + CUBE_SPACING * static_cast<f32>( x ),
+                        origin.y + CUBE_SPACING * static_cast<f32>( y ),
+                        origin.z + CUBE_SPACING * static_cast<f32>( z ),
+                    },
+                    mksv::quat_identity(),
+                    { 1.0f, 1.0f, 1.0f }
+                );
+                if ( cube_count++ % CUBE_SPIN_INTERVAL == 0 ) {
+                    engine.set_spinning( cube );
+                }
+            }
+        }
+    }
+
+    engine.set_camera( { 0.0f, 60.0f, -160.0f }, { 0.0f, 0.0f, 0.0f } );
+}
+} // namespace
 
 auto WINAPI wWinMain(
     [[maybe_unused]] _In_ HINSTANCE     hInstance,
@@ -18,6 +76,21 @@ auto WINAPI wWinMain(
     _CrtSetDbgFlag( _CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF );
 #endif
 
+    // Created first so that it outlives the engine and its threads
+    std::vector<std::unique_ptr<mksv::LogSink>> log_sinks;
+    log_sinks.push_back( std::make_unique<mksv::DebuggerLogSink>() );
+    if ( auto file_sink = mksv::FileLogSink::create( L"mksv.log" ) ) {
+        log_sinks.push_back( std::move( file_sink ) );
+    }
+    const auto logger = mksv::Logger::create( std::move( log_sinks ) );
+
+    // --profile captures the startup and the first frames into a Chrome trace
+    const auto profiler = mksv::Profiler::create();
+    if ( std::wstring_view{ lpCmdLine }.find( L"--profile" ) != std::wstring_view::npos ) {
+        profiler->begin_capture();
+        profiler->capture_frames( PROFILE_FRAME_COUNT, L"mksv_trace.json" );
+    }
+
     auto engine = mksv::Engine::create();
 
     if ( !engine ) {
@@ -35,6 +108,19 @@ auto WINAPI wWinMain(
         return -1;
     }
 
+    // --per-object-draws measures the same scene without instancing
+    add_cube_grid( *engine );
+    engine->set_instancing( std::wstring_view{ lpCmdLine }.find( L"--per-object-draws" ) == std::wstring_view::npos );
+
+    // --frame-stats appends the frame time percentiles to a CSV file and keeps the latest ones in a JSON file
+    if ( std::wstring_view{ lpCmdLine }.find( L"--frame-stats" ) != std::wstring_view::npos ) {
+        engine->get_frame_stats().set_dumps(
+            FRAME_STATS_DUMP_INTERVAL,
+            L"mksv_frame_stats.csv",
+            L"mksv_frame_stats.json"
+        );
+    }
+
     MSG msg{};
     while ( msg.message != WM_QUIT ) {
         if ( PeekMessageW( &msg, nullptr, 0, 0, PM_REMOVE ) ) {
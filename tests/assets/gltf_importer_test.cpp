@@ -0,0 +1,185 @@
+#include "mksv/assets/gltf_importer.hpp"
+
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// One triangle, positions (0 0 0) (1 0 0) (0 1 0) followed by the 16-bit indices 0 1 2
+constexpr std::string_view TRIANGLE_ASSET = R"(
+    "asset": { "version": "2.0" },
+    "buffers": [ { "byteLength": 42 } ],
+    "bufferViews": [
+        { "buffer": 0, "byteOffset": 0, "byteLength": 36 },
+        { "buffer": 0, "byteOffset": 36, "byteLength": 6 }
+    ],
+    "accessors": [
+        { "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3" },
+        { "bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR" }
+    ],
+    "meshes": [ { "primitives": [ { "attributes": { "POSITION": 0 }, "indices": 1 } ] } ])";
+
+struct Mesh {
+    std::vector<std::array<f32, 3>> positions;
+    std::vector<u32>                indices;
+    std::vector<MeshSubmesh>        submeshes;
+};
+
+// Grows the vector and copies the value in, inserting a byte range cast from the value trips GCC's stringop-overflow
+template <typename T>
+auto append( std::vector<u8>& data, const T value ) -> void
+{
+    const usize offset = data.size();
+    data.resize( offset + sizeof( value ) );
+    std::memcpy( data.data() + offset, &value, sizeof( value ) );
+}
+
+// Writes TRIANGLE_ASSET followed by nodes as a .glb and imports it
+auto import_glb( const std::string& name, const std::string_view nodes ) -> std::optional<Mesh>
+{
+    std::string json = "{" + std::string{ TRIANGLE_ASSET } + std::string{ nodes } + "}";
+    json.resize( ( json.size() + 3 ) / 4 * 4, ' ' );
+
+    std::vector<u8> binary;
+    for ( const f32 value : { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f } ) {
+        append( binary, value );
+    }
+    binary.insert( binary.end(), { 0, 0, 1, 0, 2, 0, 0, 0 } );
+
+    std::vector<u8> glb;
+    append( glb, 0x46546C67u );
+    append( glb, 2u );
+    append( glb, static_cast<u32>( 12 + 8 + json.size() + 8 + binary.size() ) );
+    append( glb, static_cast<u32>( json.size() ) );
+    append( glb, 0x4E4F534Au );
+    glb.insert( glb.end(), json.begin(), json.end() );
+    append( glb, static_cast<u32>( binary.size() ) );
+    append( glb, 0x004E4942u );
+    glb.insert( glb.end(), binary.begin(), binary.end() );
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / ( "mksv_" + name + ".glb" );
+    {
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file.write( reinterpret_cast<const char*>( glb.data() ), static_cast<std::streamsize>( glb.size() ) );
+    }
+
+    const std::unique_ptr<GltfImporter> importer = GltfImporter::open( path );
+    std::filesystem::remove( path );
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 2 );
+    if ( !importer || !jobs ) {
+        return std::nullopt;
+    }
+
+    const u32       stride = get_vertex_stride( MeshVertexFormat::PositionColor );
+    std::vector<u8> vertices( u64{ importer->get_vertex_count() } * stride );
+    Mesh            mesh{};
+    mesh.indices.resize( importer->get_index_count() );
+    mesh.submeshes.resize( importer->get_submesh_count() );
+    if ( !importer->decode( *jobs, vertices, mesh.indices, mesh.submeshes ) ) {
+        return std::nullopt;
+    }
+
+    for ( u32 v = 0; v < importer->get_vertex_count(); ++v ) {
+        std::array<f32, 3>& position = mesh.positions.emplace_back();
+        std::memcpy( position.data(), vertices.data() + u64{ v } * stride, sizeof( position ) );
+    }
+    return mesh;
+}
+
+auto expect_position( const Mesh& mesh, const u32 vertex, const std::array<f32, 3>& expected ) -> void
+{
+    ASSERT_LT( vertex, mesh.positions.size() );
+    for ( u32 axis = 0; axis < 3; ++axis ) {
+        EXPECT_NEAR( mesh.positions[vertex][axis], expected[axis], 1e-5f ) << "vertex " << vertex << " axis " << axis;
+    }
+}
+
+TEST( GltfImporter, imports_meshes_without_nodes_in_their_own_space )
+{
+    const std::optional<Mesh> mesh = import_glb( "no_nodes", "" );
+    ASSERT_TRUE( mesh );
+
+    ASSERT_EQ( mesh->submeshes.size(), 1u );
+    EXPECT_EQ( mesh->indices, ( std::vector<u32>{ 0, 1, 2 } ) );
+    expect_position( *mesh, 0, { 0.0f, 0.0f, 0.0f } );
+    expect_position( *mesh, 1, { 1.0f, 0.0f, 0.0f } );
+    expect_position( *mesh, 2, { 0.0f, 1.0f, 0.0f } );
+}
+
+TEST( GltfImporter, applies_the_node_hierarchy )
+{
+    const std::optional<Mesh> mesh = import_glb( "hierarchy", R"(,
+        "scene": 0,
+        "scenes": [ { "nodes": [ 0 ] } ],
+        "nodes": [
+            { "translation": [ 10, 0, 0 ], "children": [ 1, 2 ] },
+            { "mesh": 0, "scale": [ 2, 2, 2 ] },
+            { "mesh": 0, "rotation": [ 0, 0, 0.70710678, 0.70710678 ] }
+        ])" );
+    ASSERT_TRUE( mesh );
+
+    // Once per node, in depth first order
+    ASSERT_EQ( mesh->submeshes.size(), 2u );
+    EXPECT_EQ( mesh->submeshes[1].first_vertex, 3u );
+    EXPECT_EQ( mesh->indices, ( std::vector<u32>{ 0, 1, 2, 3, 4, 5 } ) );
+
+    expect_position( *mesh, 1, { 12.0f, 0.0f, 0.0f } );
+    expect_position( *mesh, 2, { 10.0f, 2.0f, 0.0f } );
+    expect_position( *mesh, 4, { 10.0f, 1.0f, 0.0f } );
+    expect_position( *mesh, 5, { 9.0f, 0.0f, 0.0f } );
+
+    EXPECT_NEAR( mesh->submeshes[0].bounds.max[0], 12.0f, 1e-5f );
+    EXPECT_NEAR( mesh->submeshes[1].bounds.min[0], 9.0f, 1e-5f );
+}
+
+TEST( GltfImporter, imports_only_the_default_scene )
+{
+    const std::optional<Mesh> mesh = import_glb( "scenes", R"(,
+        "scene": 1,
+        "scenes": [ { "nodes": [ 0 ] }, { "nodes": [ 1 ] } ],
+        "nodes": [
+            { "mesh": 0 },
+            { "mesh": 0, "matrix": [ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 5, 1 ] }
+        ])" );
+    ASSERT_TRUE( mesh );
+
+    ASSERT_EQ( mesh->submeshes.size(), 1u );
+    expect_position( *mesh, 1, { 1.0f, 0.0f, 5.0f } );
+}
+
+TEST( GltfImporter, flips_the_winding_of_mirrored_nodes )
+{
+    const std::optional<Mesh> mesh = import_glb( "mirrored", R"(,
+        "nodes": [ { "mesh": 0, "scale": [ -1, 1, 1 ] } ])" );
+    ASSERT_TRUE( mesh );
+
+    EXPECT_EQ( mesh->indices, ( std::vector<u32>{ 0, 2, 1 } ) );
+    expect_position( *mesh, 1, { -1.0f, 0.0f, 0.0f } );
+}
+
+TEST( GltfImporter, rejects_malformed_hierarchies )
+{
+    EXPECT_FALSE( import_glb( "cycle", R"(, "scenes": [ { "nodes": [ 0 ] } ], "nodes": [ { "children": [ 0 ] } ])" ) );
+    EXPECT_FALSE( import_glb( "shared_child", R"(,
+        "nodes": [ { "children": [ 2 ] }, { "children": [ 2 ] }, { "mesh": 0 } ])" ) );
+    EXPECT_FALSE( import_glb( "missing_child", R"(, "nodes": [ { "children": [ 1 ] } ])" ) );
+    EXPECT_FALSE( import_glb( "missing_mesh", R"(, "nodes": [ { "mesh": 1 } ])" ) );
+    EXPECT_FALSE( import_glb( "missing_scene", R"(, "scene": 1, "scenes": [ { "nodes": [] } ], "nodes": [ {} ])" ) );
+    EXPECT_FALSE( import_glb( "short_translation", R"(, "nodes": [ { "mesh": 0, "translation": [ 1, 2 ] } ])" ) );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,190 @@
+#include "mksv/assets/mesh_file.hpp"
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+auto temp_path( const std::string& name ) -> std::filesystem::path
+{
+    return std::filesystem::temp_directory_path() / ( "mksv_" + name );
+}
+
+// A strip of vertex_count / 2 quads split into two submeshes, positions on a grid and colors from the vertex index
+auto make_mesh( const u32 vertex_count ) -> MeshData
+{
+    MeshData mesh{};
+    mesh.vertex_format = MeshVertexFormat::PositionColor;
+
+    for ( u32 i = 0; i < vertex_count; ++i ) {
+        const f32 vertex[6] = {
+            static_cast<f32>( i / 2 ),
+            static_cast<f32>( i % 2 ) - 0.5f,
+            static_cast<f32>( i % 7 ) * -0.25f,
+            static_cast<f32>( i % 3 ) / 2.0f,
+            static_cast<f32>( i % 5 ) / 4.0f,
+            1.0f,
+        };
+        const u8* const bytes = reinterpret_cast<const u8*>( vertex );
+        mesh.vertices.insert( mesh.vertices.end(), bytes, bytes + sizeof( vertex ) );
+    }
+
+    for ( u32 i = 0; i + 3 < vertex_count; i += 2 ) {
+        mesh.indices.insert( mesh.indices.end(), { i, i + 1, i + 2, i + 2, i + 1, i + 3 } );
+    }
+
+    const u32 split = static_cast<u32>( mesh.indices.size() / 6 / 2 * 6 );
+    mesh.submeshes = {
+        { .first_index = 0, .index_count = split, .first_vertex = 0, .vertex_count = 0, .bounds = {} },
+        {
+            .first_index = split,
+            .index_count = static_cast<u32>( mesh.indices.size() ) - split,
+            .first_vertex = 0,
+            .vertex_count = 0,
+            .bounds = {},
+        },
+    };
+
+    update_mesh_bounds( mesh );
+    return mesh;
+}
+
+auto expect_bounds_eq( const MeshBounds& actual, const MeshBounds& expected ) -> void
+{
+    for ( u32 axis = 0; axis < 3; ++axis ) {
+        EXPECT_EQ( actual.min[axis], expected.min[axis] ) << "axis " << axis;
+        EXPECT_EQ( actual.max[axis], expected.max[axis] ) << "axis " << axis;
+    }
+}
+
+// Writes the mesh, maps it again and compares everything the file holds
+auto expect_round_trip( const MeshData& mesh, const std::string& name, const u32 index_size ) -> void
+{
+    const std::filesystem::path path = temp_path( name );
+    ASSERT_TRUE( write_mesh( path, mesh ) );
+
+    {
+        const std::unique_ptr<MeshFile> file = MeshFile::open( path );
+        ASSERT_NE( file, nullptr );
+
+        const u32 stride = get_vertex_stride( mesh.vertex_format );
+        EXPECT_EQ( file->get_vertex_format(), mesh.vertex_format );
+        EXPECT_EQ( file->get_vertex_stride(), stride );
+        EXPECT_EQ( file->get_vertex_count(), mesh.vertices.size() / stride );
+        EXPECT_EQ( file->get_index_count(), mesh.indices.size() );
+        EXPECT_EQ( file->get_index_size(), index_size );
+        expect_bounds_eq( file->get_bounds(), mesh.bounds );
+
+        const std::span<const u8> vertex_data = file->get_vertex_data();
+        EXPECT_EQ( reinterpret_cast<usize>( vertex_data.data() ) % MESH_STREAM_ALIGNMENT, 0u );
+        EXPECT_EQ( std::vector<u8>( vertex_data.begin(), vertex_data.end() ), mesh.vertices );
+
+        const std::span<const u8> index_data = file->get_index_data();
+        ASSERT_EQ( index_data.size(), mesh.indices.size() * index_size );
+        for ( usize i = 0; i < mesh.indices.size(); ++i ) {
+            u32 index = 0;
+            std::memcpy( &index, index_data.data() + i * index_size, index_size );
+            ASSERT_EQ( index, mesh.indices[i] ) << "index " << i;
+        }
+
+        const std::span<const MeshSubmesh> submeshes = file->get_submeshes();
+        ASSERT_EQ( submeshes.size(), mesh.submeshes.size() );
+        for ( usize i = 0; i < submeshes.size(); ++i ) {
+            EXPECT_EQ( submeshes[i].first_index, mesh.submeshes[i].first_index );
+            EXPECT_EQ( submeshes[i].index_count, mesh.submeshes[i].index_count );
+            EXPECT_EQ( submeshes[i].first_vertex, mesh.submeshes[i].first_vertex );
+            EXPECT_EQ( submeshes[i].vertex_count, mesh.submeshes[i].vertex_count );
+            expect_bounds_eq( submeshes[i].bounds, mesh.submeshes[i].bounds );
+        }
+    }
+
+    std::filesystem::remove( path );
+}
+
+TEST( MeshFile, round_trips_with_16_bit_indices )
+{
+    const MeshData mesh = make_mesh( 1000 );
+    EXPECT_EQ( get_mesh_index_size( mesh ), 2u );
+    expect_round_trip( mesh, "mesh_16.mesh", 2 );
+}
+
+TEST( MeshFile, round_trips_with_32_bit_indices )
+{
+    const MeshData mesh = make_mesh( 70000 );
+    EXPECT_EQ( get_mesh_index_size( mesh ), 4u );
+    expect_round_trip( mesh, "mesh_32.mesh", 4 );
+}
+
+TEST( MeshFile, round_trips_an_empty_mesh )
+{
+    MeshData mesh = make_mesh( 0 );
+    EXPECT_TRUE( mesh.indices.empty() );
+    mesh.submeshes.clear();
+    expect_round_trip( mesh, "mesh_empty.mesh", 2 );
+}
+
+TEST( MeshFile, bounds_cover_the_submesh_vertices )
+{
+    const MeshData mesh = make_mesh( 8 );
+
+    // Quads 0-1 and 2-3, the middle vertices are shared
+    ASSERT_EQ( mesh.submeshes.size(), 2u );
+    EXPECT_EQ( mesh.submeshes[0].first_vertex, 0u );
+    EXPECT_EQ( mesh.submeshes[0].vertex_count, 4u );
+    EXPECT_EQ( mesh.submeshes[1].first_vertex, 2u );
+    EXPECT_EQ( mesh.submeshes[1].vertex_count, 6u );
+
+    expect_bounds_eq( mesh.submeshes[0].bounds, { .min = { 0.0f, -0.5f, -0.75f }, .max = { 1.0f, 0.5f, 0.0f } } );
+    expect_bounds_eq( mesh.bounds, { .min = { 0.0f, -0.5f, -1.5f }, .max = { 3.0f, 0.5f, 0.0f } } );
+}
+
+TEST( MeshFile, rejects_corrupt_files )
+{
+    const std::vector<u8> valid = serialize_mesh( make_mesh( 100 ) );
+
+    const auto opens = [&]( const std::vector<u8>& data ) {
+        const std::filesystem::path path = temp_path( "mesh_corrupt.mesh" );
+        {
+            std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+            file.write( reinterpret_cast<const char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+        }
+        const bool opened = MeshFile::open( path ) != nullptr;
+        std::filesystem::remove( path );
+        return opened;
+    };
+
+    const auto with_header = [&]( const auto& modify ) {
+        std::vector<u8> data = valid;
+        MeshHeader      header{};
+        std::memcpy( &header, data.data(), sizeof( header ) );
+        modify( header );
+        std::memcpy( data.data(), &header, sizeof( header ) );
+        return data;
+    };
+
+    EXPECT_TRUE( opens( valid ) );
+    EXPECT_FALSE( opens( with_header( []( MeshHeader& header ) { header.magic = 0; } ) ) );
+    EXPECT_FALSE( opens( with_header( []( MeshHeader& header ) { ++header.version; } ) ) );
+    EXPECT_FALSE( opens( with_header( []( MeshHeader& header ) { header.index_size = 3; } ) ) );
+    EXPECT_FALSE( opens( with_header( []( MeshHeader& header ) { header.vertex_stride += 4; } ) ) );
+    EXPECT_FALSE( opens( with_header( []( MeshHeader& header ) { header.vertex_offset += 4; } ) ) );
+    EXPECT_FALSE( opens( with_header( []( MeshHeader& header ) { header.index_count += 1000; } ) ) );
+    EXPECT_FALSE( opens( with_header( []( MeshHeader& header ) { header.vertex_count = 1; } ) ) );
+    EXPECT_FALSE( opens( std::vector<u8>( valid.begin(), valid.end() - 1 ) ) );
+    EXPECT_FALSE( opens( std::vector<u8>( valid.begin(), valid.begin() + sizeof( MeshHeader ) - 1 ) ) );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,258 @@
+#include "mksv/assets/mesh_optimizer.hpp"
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/assets/vertex_quantization.hpp"
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// A PositionColor vertex
+using Vertex = std::array<f32, 6>;
+using Triangle = std::array<Vertex, 3>;
+
+constexpr u32 STRIDE = sizeof( Vertex );
+
+// Adds a bumpy grid of size x size quads as a submesh over vertices of its own. The vertices are stored in random
+// order, the triangles come in random order and start at a random corner, which keeps their winding.
+auto append_grid( MeshData& mesh, const u32 size, const f32 height, std::mt19937& random ) -> void
+{
+    const u32 row_size = size + 1;
+    const u32 first_vertex = static_cast<u32>( mesh.vertices.size() / STRIDE );
+
+    std::vector<u32> slots( row_size * row_size );
+    for ( u32 i = 0; i < slots.size(); ++i ) {
+        slots[i] = first_vertex + i;
+    }
+    std::ranges::shuffle( slots, random );
+
+    mesh.vertices.resize( mesh.vertices.size() + slots.size() * STRIDE );
+    for ( u32 y = 0; y <= size; ++y ) {
+        for ( u32 x = 0; x <= size; ++x ) {
+            const f32    u = static_cast<f32>( x ) / static_cast<f32>( size );
+            const f32    v = static_cast<f32>( y ) / static_cast<f32>( size );
+            const Vertex vertex = {
+                static_cast<f32>( x ), static_cast<f32>( ( x * y ) % 5 ) * 0.25f + height, static_cast<f32>( y ), u, v,
+                0.5f,
+            };
+            std::memcpy( mesh.vertices.data() + u64{ slots[y * row_size + x] } * STRIDE, &vertex, STRIDE );
+        }
+    }
+
+    std::vector<std::array<u32, 3>> triangles;
+    for ( u32 y = 0; y < size; ++y ) {
+        for ( u32 x = 0; x < size; ++x ) {
+            const u32 corner = y * row_size + x;
+            triangles.push_back( { slots[corner], slots[corner + row_size], slots[corner + 1] } );
+            triangles.push_back( { slots[corner + 1], slots[corner + row_size], slots[corner + row_size + 1] } );
+        }
+    }
+    std::ranges::shuffle( triangles, random );
+
+    const u32 first_index = static_cast<u32>( mesh.indices.size() );
+    for ( std::array<u32, 3>& triangle : triangles ) {
+        std::ranges::rotate( triangle, triangle.begin() + random() % 3 );
+        mesh.indices.insert( mesh.indices.end(), triangle.begin(), triangle.end() );
+    }
+    mesh.submeshes.push_back( {
+        .first_index = first_index,
+        .index_count = static_cast<u32>( mesh.indices.size() ) - first_index,
+        .first_vertex = 0,
+        .vertex_count = 0,
+        .bounds = {},
+    } );
+}
+
+auto make_grids( const u32 grid_count, const u32 size ) -> MeshData
+{
+    MeshData mesh{};
+    mesh.vertex_format = MeshVertexFormat::PositionColor;
+
+    std::mt19937 random{ 11 };
+    for ( u32 grid = 0; grid < grid_count; ++grid ) {
+        append_grid( mesh, size, static_cast<f32>( grid ) * 2.0f, random );
+    }
+    update_mesh_bounds( mesh );
+    return mesh;
+}
+
+auto get_vertex_count( const MeshData& mesh ) -> u32
+{
+    return static_cast<u32>( mesh.vertices.size() / get_vertex_stride( mesh.vertex_format ) );
+}
+
+// The triangles of a submesh by the values of their vertices, dequantized for quantized meshes. Every triangle starts
+// at its smallest vertex, so the same triangle with the same winding compares equal however its indices are rotated.
+auto get_triangles( const MeshData& mesh, const MeshSubmesh& submesh ) -> std::vector<Triangle>
+{
+    std::vector<u8> vertices = mesh.vertices;
+    if ( mesh.vertex_format != MeshVertexFormat::PositionColor ) {
+        vertices.resize( u64{ get_vertex_count( mesh ) } * STRIDE );
+        EXPECT_TRUE( dequantize_vertices( mesh.vertex_format, mesh.bounds, mesh.vertices, vertices ) );
+    }
+
+    std::vector<Triangle> triangles( submesh.index_count / 3 );
+    for ( u32 i = 0; i < triangles.size(); ++i ) {
+        for ( u32 corner = 0; corner < 3; ++corner ) {
+            const u32 index = mesh.indices[submesh.first_index + i * 3 + corner];
+            std::memcpy( &triangles[i][corner], vertices.data() + u64{ index } * STRIDE, STRIDE );
+        }
+        std::ranges::rotate( triangles[i], std::ranges::min_element( triangles[i] ) );
+    }
+    std::ranges::sort( triangles );
+    return triangles;
+}
+
+auto get_acmr( const MeshData& mesh ) -> f32
+{
+    return analyze_vertex_cache( mesh.indices, get_vertex_count( mesh ) ).acmr;
+}
+
+TEST( MeshOptimizer, vertex_cache_keeps_the_triangles )
+{
+    const MeshData original = make_grids( 1, 24 );
+    MeshData       mesh = original;
+    optimize_vertex_cache( mesh.indices, get_vertex_count( mesh ) );
+
+    EXPECT_NE( mesh.indices, original.indices );
+    EXPECT_EQ( get_triangles( mesh, mesh.submeshes[0] ), get_triangles( original, original.submeshes[0] ) );
+}
+
+TEST( MeshOptimizer, overdraw_keeps_the_triangles )
+{
+    const MeshData original = make_grids( 1, 24 );
+    MeshData       mesh = original;
+    optimize_vertex_cache( mesh.indices, get_vertex_count( mesh ) );
+    optimize_overdraw( mesh.indices, mesh.vertices, STRIDE );
+
+    EXPECT_EQ( get_triangles( mesh, mesh.submeshes[0] ), get_triangles( original, original.submeshes[0] ) );
+}
+
+TEST( MeshOptimizer, vertex_fetch_keeps_the_triangles_and_orders_the_vertices )
+{
+    const MeshData original = make_grids( 1, 24 );
+    MeshData       mesh = original;
+    EXPECT_EQ( optimize_vertex_fetch( mesh.vertices, STRIDE, mesh.indices ), get_vertex_count( mesh ) );
+
+    EXPECT_EQ( get_triangles( mesh, mesh.submeshes[0] ), get_triangles( original, original.submeshes[0] ) );
+
+    // Every index is at most one past the highest before it
+    u32 next_vertex = 0;
+    for ( const u32 index : mesh.indices ) {
+        ASSERT_LE( index, next_vertex );
+        next_vertex = std::max( next_vertex, index + 1 );
+    }
+}
+
+TEST( MeshOptimizer, acmr_does_not_get_worse_on_a_shuffled_grid )
+{
+    MeshData  mesh = make_grids( 1, 32 );
+    const f32 shuffled = get_acmr( mesh );
+
+    optimize_vertex_cache( mesh.indices, get_vertex_count( mesh ) );
+    const f32 vertex_cache = get_acmr( mesh );
+    EXPECT_LT( vertex_cache, shuffled );
+    EXPECT_LT( vertex_cache, 1.0f );
+
+    optimize_overdraw( mesh.indices, mesh.vertices, STRIDE );
+    const f32 overdraw = get_acmr( mesh );
+    // The threshold bounds every cluster, not the whole list
+    EXPECT_LE( overdraw, shuffled );
+    EXPECT_LT( overdraw, 1.0f );
+
+    // Renaming the vertices leaves the cache behavior as it is
+    EXPECT_EQ( optimize_vertex_fetch( mesh.vertices, STRIDE, mesh.indices ), get_vertex_count( mesh ) );
+    EXPECT_FLOAT_EQ( get_acmr( mesh ), overdraw );
+}
+
+TEST( MeshOptimizer, optimize_mesh_keeps_the_submeshes )
+{
+    const MeshData original = make_grids( 3, 16 );
+    MeshData       mesh = original;
+    optimize_mesh( mesh );
+
+    EXPECT_LT( get_acmr( mesh ), get_acmr( original ) );
+    ASSERT_EQ( mesh.submeshes.size(), original.submeshes.size() );
+    ASSERT_EQ( get_vertex_count( mesh ), get_vertex_count( original ) );
+    for ( usize i = 0; i < mesh.submeshes.size(); ++i ) {
+        const MeshSubmesh& submesh = mesh.submeshes[i];
+        EXPECT_EQ( submesh.first_index, original.submeshes[i].first_index );
+        EXPECT_EQ( submesh.index_count, original.submeshes[i].index_count );
+        EXPECT_EQ( submesh.vertex_count, original.submeshes[i].vertex_count );
+        EXPECT_EQ( get_triangles( mesh, submesh ), get_triangles( original, original.submeshes[i] ) );
+
+        // The indices stay within the vertex range of their submesh
+        for ( u32 index = submesh.first_index; index < submesh.first_index + submesh.index_count; ++index ) {
+            ASSERT_GE( mesh.indices[index], submesh.first_vertex );
+            ASSERT_LT( mesh.indices[index], submesh.first_vertex + submesh.vertex_count );
+        }
+    }
+
+    // Quantized with the same bounds, the triangles are still the same after dequantizing
+    MeshData quantized_original = original;
+    ASSERT_TRUE( quantize_mesh( quantized_original, MeshVertexFormat::PositionColorQuantized ) );
+    ASSERT_TRUE( quantize_mesh( mesh, MeshVertexFormat::PositionColorQuantized ) );
+    for ( usize i = 0; i < mesh.submeshes.size(); ++i ) {
+        EXPECT_EQ(
+            get_triangles( mesh, mesh.submeshes[i] ),
+            get_triangles( quantized_original, quantized_original.submeshes[i] )
+        );
+    }
+}
+
+TEST( MeshOptimizer, optimize_mesh_drops_unreferenced_vertices )
+{
+    MeshData mesh = make_grids( 1, 8 );
+    mesh.vertices.resize( mesh.vertices.size() + STRIDE * 2 );
+    const std::vector<Triangle> triangles = get_triangles( mesh, mesh.submeshes[0] );
+
+    optimize_mesh( mesh );
+    EXPECT_EQ( get_vertex_count( mesh ), 9u * 9u );
+    EXPECT_EQ( get_triangles( mesh, mesh.submeshes[0] ), triangles );
+}
+
+TEST( MeshOptimizer, index_size_switches_at_65536_vertices )
+{
+    MeshData mesh{};
+    mesh.vertex_format = MeshVertexFormat::PositionColor;
+    mesh.vertices.resize( u64{ 65535 } * STRIDE );
+    EXPECT_EQ( get_mesh_index_size( mesh ), 2u );
+    mesh.vertices.resize( u64{ 65536 } * STRIDE );
+    EXPECT_EQ( get_mesh_index_size( mesh ), 4u );
+
+    // 256 x 256 vertices, dropping the triangles around one of them leaves 65535
+    mesh = make_grids( 1, 255 );
+    ASSERT_EQ( get_vertex_count( mesh ), 65536u );
+    optimize_mesh( mesh );
+    EXPECT_EQ( get_mesh_index_size( mesh ), 4u );
+
+    const u32        dropped = mesh.indices[0];
+    std::vector<u32> indices;
+    for ( usize i = 0; i < mesh.indices.size(); i += 3 ) {
+        if ( mesh.indices[i] != dropped && mesh.indices[i + 1] != dropped && mesh.indices[i + 2] != dropped ) {
+            indices.insert( indices.end(), mesh.indices.begin() + i, mesh.indices.begin() + i + 3 );
+        }
+    }
+    mesh.indices = std::move( indices );
+    mesh.submeshes[0].index_count = static_cast<u32>( mesh.indices.size() );
+    optimize_mesh( mesh );
+    EXPECT_EQ( get_vertex_count( mesh ), 65535u );
+    EXPECT_EQ( get_mesh_index_size( mesh ), 2u );
+
+    MeshHeader header{};
+    std::memcpy( &header, serialize_mesh( mesh ).data(), sizeof( header ) );
+    EXPECT_EQ( header.index_size, 2u );
+}
+} // namespace
+} // namespace mksv
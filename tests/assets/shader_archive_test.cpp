@@ -0,0 +1,211 @@
+#include "mksv/assets/shader_archive.hpp"
+
+#include "mksv/assets/mapped_file.hpp"
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+auto temp_path( const std::string& name ) -> std::filesystem::path
+{
+    return std::filesystem::temp_directory_path() / ( "mksv_" + name );
+}
+
+auto write_file( const std::filesystem::path& path, const std::span<const u8> data ) -> void
+{
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    file.write( reinterpret_cast<const char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+    ASSERT_TRUE( file );
+}
+
+auto make_bytecode( const usize size, const u8 seed ) -> std::vector<u8>
+{
+    std::vector<u8> bytecode( size );
+    for ( usize i = 0; i < size; ++i ) {
+        bytecode[i] = static_cast<u8>( seed + i * 31 );
+    }
+    return bytecode;
+}
+
+auto make_writer() -> ShaderArchiveWriter
+{
+    ShaderArchiveWriter writer;
+    EXPECT_TRUE( writer.add( "vertex_shader", make_bytecode( 100, 1 ) ) );
+    EXPECT_TRUE( writer.add( "pixel_shader", make_bytecode( 37, 2 ) ) );
+    EXPECT_TRUE( writer.add( "compute_shader", make_bytecode( 1, 3 ) ) );
+    return writer;
+}
+
+// Writes the serialized archive after letting modify change it and returns whether it still opens
+auto opens_modified( const std::string& name, const std::function<void( std::vector<u8>& )>& modify ) -> bool
+{
+    std::vector<u8> data = make_writer().serialize();
+    modify( data );
+
+    const std::filesystem::path path = temp_path( name );
+    write_file( path, data );
+    const bool opened = ShaderArchive::open( path ) != nullptr;
+    std::filesystem::remove( path );
+    return opened;
+}
+
+auto modify_header( std::vector<u8>& data, const std::function<void( ShaderArchive::Header& )>& modify ) -> void
+{
+    ShaderArchive::Header header{};
+    std::memcpy( &header, data.data(), sizeof( header ) );
+    modify( header );
+    std::memcpy( data.data(), &header, sizeof( header ) );
+}
+
+TEST( ShaderArchive, round_trips_every_shader )
+{
+    const std::filesystem::path path = temp_path( "round_trip.pak" );
+    ASSERT_TRUE( make_writer().write( path ) );
+
+    {
+        const std::unique_ptr<ShaderArchive> archive = ShaderArchive::open( path );
+        ASSERT_NE( archive, nullptr );
+        EXPECT_EQ( archive->get_shader_count(), 3u );
+
+        const std::span<const u8> vertex_shader = archive->find( "vertex_shader" );
+        EXPECT_EQ( std::vector<u8>( vertex_shader.begin(), vertex_shader.end() ), make_bytecode( 100, 1 ) );
+        EXPECT_EQ( reinterpret_cast<usize>( vertex_shader.data() ) % ShaderArchive::DATA_ALIGNMENT, 0u );
+
+        const std::span<const u8> pixel_shader = archive->find( "pixel_shader" );
+        EXPECT_EQ( std::vector<u8>( pixel_shader.begin(), pixel_shader.end() ), make_bytecode( 37, 2 ) );
+
+        const std::span<const u8> compute_shader = archive->find( "compute_shader" );
+        EXPECT_EQ( std::vector<u8>( compute_shader.begin(), compute_shader.end() ), make_bytecode( 1, 3 ) );
+
+        EXPECT_TRUE( archive->find( "geometry_shader" ).empty() );
+        EXPECT_TRUE( archive->find( "" ).empty() );
+    }
+
+    std::filesystem::remove( path );
+}
+
+TEST( ShaderArchive, writer_output_ignores_insertion_order )
+{
+    ShaderArchiveWriter reversed;
+    EXPECT_TRUE( reversed.add( "compute_shader", make_bytecode( 1, 3 ) ) );
+    EXPECT_TRUE( reversed.add( "pixel_shader", make_bytecode( 37, 2 ) ) );
+    EXPECT_TRUE( reversed.add( "vertex_shader", make_bytecode( 100, 1 ) ) );
+
+    EXPECT_EQ( reversed.serialize(), make_writer().serialize() );
+
+    EXPECT_FALSE( reversed.add( "pixel_shader", make_bytecode( 4, 4 ) ) );
+    EXPECT_FALSE( reversed.add( "", make_bytecode( 4, 4 ) ) );
+}
+
+TEST( ShaderArchive, empty_archive_opens )
+{
+    const std::filesystem::path path = temp_path( "empty.pak" );
+    ASSERT_TRUE( ShaderArchiveWriter{}.write( path ) );
+
+    {
+        const std::unique_ptr<ShaderArchive> archive = ShaderArchive::open( path );
+        ASSERT_NE( archive, nullptr );
+        EXPECT_EQ( archive->get_shader_count(), 0u );
+        EXPECT_TRUE( archive->find( "vertex_shader" ).empty() );
+    }
+
+    std::filesystem::remove( path );
+}
+
+TEST( ShaderArchive, rejects_corrupt_headers )
+{
+    EXPECT_TRUE( opens_modified( "unmodified.pak", []( std::vector<u8>& ) {} ) );
+
+    EXPECT_FALSE( opens_modified( "magic.pak", []( std::vector<u8>& data ) {
+        modify_header( data, []( ShaderArchive::Header& header ) { header.magic = 0; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "version.pak", []( std::vector<u8>& data ) {
+        modify_header( data, []( ShaderArchive::Header& header ) { ++header.version; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "file_size.pak", []( std::vector<u8>& data ) {
+        modify_header( data, []( ShaderArchive::Header& header ) { header.file_size += 16; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "slot_count.pak", []( std::vector<u8>& data ) {
+        modify_header( data, []( ShaderArchive::Header& header ) { header.slot_count -= 1; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "shader_count.pak", []( std::vector<u8>& data ) {
+        modify_header( data, []( ShaderArchive::Header& header ) { header.shader_count += 1; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "slots_offset.pak", []( std::vector<u8>& data ) {
+        modify_header( data, []( ShaderArchive::Header& header ) { header.slots_offset = header.file_size; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "truncated.pak", []( std::vector<u8>& data ) { data.pop_back(); } ) );
+    EXPECT_FALSE( opens_modified( "header_only.pak", []( std::vector<u8>& data ) {
+        data.resize( sizeof( ShaderArchive::Header ) - 1 );
+    } ) );
+}
+
+TEST( ShaderArchive, rejects_slots_outside_the_file )
+{
+    const auto corrupt_slot = []( std::vector<u8>& data, const std::function<void( ShaderArchive::Slot& )>& modify ) {
+        ShaderArchive::Header header{};
+        std::memcpy( &header, data.data(), sizeof( header ) );
+
+        for ( u32 i = 0; i < header.slot_count; ++i ) {
+            u8* const           slot_data = data.data() + header.slots_offset + i * sizeof( ShaderArchive::Slot );
+            ShaderArchive::Slot slot{};
+            std::memcpy( &slot, slot_data, sizeof( slot ) );
+            if ( slot.name_size != 0 ) {
+                modify( slot );
+                std::memcpy( slot_data, &slot, sizeof( slot ) );
+                return;
+            }
+        }
+    };
+
+    EXPECT_FALSE( opens_modified( "data_offset.pak", [&]( std::vector<u8>& data ) {
+        const u64 file_size = data.size();
+        corrupt_slot( data, [file_size]( ShaderArchive::Slot& slot ) { slot.data_offset = file_size; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "data_size.pak", [&]( std::vector<u8>& data ) {
+        corrupt_slot( data, []( ShaderArchive::Slot& slot ) { slot.data_size = ~0ull; } );
+    } ) );
+    EXPECT_FALSE( opens_modified( "name_size.pak", [&]( std::vector<u8>& data ) {
+        const u64 file_size = data.size();
+        corrupt_slot( data, [file_size]( ShaderArchive::Slot& slot ) {
+            slot.name_size = static_cast<u32>( file_size );
+        } );
+    } ) );
+}
+
+TEST( MappedFile, maps_the_whole_file )
+{
+    const std::filesystem::path path = temp_path( "mapped_file.bin" );
+    const std::vector<u8>       data = make_bytecode( 10000, 5 );
+    write_file( path, data );
+
+    {
+        const std::unique_ptr<MappedFile> file = MappedFile::open( path );
+        ASSERT_NE( file, nullptr );
+        EXPECT_EQ( std::vector<u8>( file->get_data().begin(), file->get_data().end() ), data );
+    }
+
+    write_file( path, {} );
+    {
+        const std::unique_ptr<MappedFile> file = MappedFile::open( path );
+        ASSERT_NE( file, nullptr );
+        EXPECT_TRUE( file->get_data().empty() );
+    }
+
+    std::filesystem::remove( path );
+    EXPECT_EQ( MappedFile::open( path ), nullptr );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,267 @@
+#include "mksv/assets/vertex_quantization.hpp"
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/assets/mesh_format.hpp"
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+using Vec3 = std::array<f32, 3>;
+
+constexpr u32 VALUE_COUNT = 10'000;
+
+template <typename T>
+auto load( const u8* const p ) -> T
+{
+    T value;
+    std::memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+auto random_vectors( const u32 count, const f32 min, const f32 max ) -> std::vector<Vec3>
+{
+    std::mt19937                        random{ 7 };
+    std::uniform_real_distribution<f32> distribution{ min, max };
+
+    std::vector<Vec3> vectors( count );
+    for ( Vec3& vector : vectors ) {
+        vector = { distribution( random ), distribution( random ), distribution( random ) };
+    }
+    return vectors;
+}
+
+auto as_bytes( const std::vector<Vec3>& vectors ) -> const u8*
+{
+    return reinterpret_cast<const u8*>( vectors.data() );
+}
+
+// What the scalar encoders compute, the SIMD paths have to match it exactly
+auto reference_snorm16( const f32 value ) -> i16
+{
+    return static_cast<i16>( std::nearbyint( std::clamp( value, -1.0f, 1.0f ) * 32767.0f ) );
+}
+
+auto reference_unorm8( const f32 value ) -> u8
+{
+    return static_cast<u8>( std::nearbyint( std::clamp( value, 0.0f, 1.0f ) * 255.0f ) );
+}
+
+TEST( VertexQuantization, snorm16_positions_are_within_half_a_step )
+{
+    const MeshBounds        bounds = { .min = { -3.0f, 1.0f, -100.0f }, .max = { 5.0f, 2.0f, 100.0f } };
+    const std::vector<Vec3> positions = random_vectors( VALUE_COUNT, 0.0f, 1.0f );
+    std::vector<Vec3>       scaled( positions.size() );
+    for ( usize i = 0; i < positions.size(); ++i ) {
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            scaled[i][axis] = bounds.min[axis] + positions[i][axis] * ( bounds.max[axis] - bounds.min[axis] );
+        }
+    }
+
+    std::vector<u8> encoded( scaled.size() * 4 * sizeof( i16 ) );
+    encode_positions_snorm16( as_bytes( scaled ), sizeof( Vec3 ), encoded.data(), 8, VALUE_COUNT, bounds );
+
+    for ( u32 axis = 0; axis < 3; ++axis ) {
+        const f32 center = 0.5f * ( bounds.min[axis] + bounds.max[axis] );
+        const f32 half_extent = 0.5f * ( bounds.max[axis] - bounds.min[axis] );
+        const f32 max_error = 0.5f * half_extent / 32767.0f + 1e-5f * half_extent;
+
+        f32 worst = 0.0f;
+        for ( u32 i = 0; i < VALUE_COUNT; ++i ) {
+            const i16 value = load<i16>( encoded.data() + i * 8 + axis * sizeof( i16 ) );
+            worst = std::max( worst, std::abs( center + value / 32767.0f * half_extent - scaled[i][axis] ) );
+        }
+        EXPECT_LE( worst, max_error ) << "axis " << axis;
+    }
+
+    for ( u32 i = 0; i < VALUE_COUNT; ++i ) {
+        EXPECT_EQ( load<i16>( encoded.data() + i * 8 + 3 * sizeof( i16 ) ), 32767 );
+    }
+}
+
+TEST( VertexQuantization, half_values_are_within_2_to_the_minus_11 )
+{
+    std::vector<Vec3> values = random_vectors( VALUE_COUNT, -1000.0f, 1000.0f );
+    for ( u32 i = 0; i < VALUE_COUNT; i += 3 ) {
+        values[i][i % 3] *= 1e-3f;
+    }
+
+    std::vector<u8> positions( values.size() * 4 * sizeof( u16 ) );
+    std::vector<u8> uvs( values.size() * 2 * sizeof( u16 ) );
+    encode_positions_half( as_bytes( values ), sizeof( Vec3 ), positions.data(), 8, VALUE_COUNT );
+    encode_uvs_half( as_bytes( values ), sizeof( Vec3 ), uvs.data(), 4, VALUE_COUNT );
+
+    // Relative to the value in the normal range of halves, absolute in the subnormal range
+    const auto max_error = []( const f32 value ) { return std::max( std::abs( value ) * 0x1p-11f, 0x1p-25f ); };
+
+    for ( u32 i = 0; i < VALUE_COUNT; ++i ) {
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            const f32 decoded = half_to_float( load<u16>( positions.data() + i * 8 + axis * sizeof( u16 ) ) );
+            ASSERT_LE( std::abs( decoded - values[i][axis] ), max_error( values[i][axis] ) ) << "position " << i;
+        }
+        ASSERT_EQ( half_to_float( load<u16>( positions.data() + i * 8 + 3 * sizeof( u16 ) ) ), 1.0f );
+
+        for ( u32 axis = 0; axis < 2; ++axis ) {
+            const f32 decoded = half_to_float( load<u16>( uvs.data() + i * 4 + axis * sizeof( u16 ) ) );
+            ASSERT_LE( std::abs( decoded - values[i][axis] ), max_error( values[i][axis] ) ) << "uv " << i;
+        }
+    }
+}
+
+TEST( VertexQuantization, octahedral_normals_are_within_a_hundredth_of_a_degree )
+{
+    std::vector<Vec3> normals = random_vectors( VALUE_COUNT, -1.0f, 1.0f );
+    normals.insert(
+        normals.end(),
+        {
+            { 1.0f, 0.0f, 0.0f },
+            { -1.0f, 0.0f, 0.0f },
+            { 0.0f, 1.0f, 0.0f },
+            { 0.0f, -1.0f, 0.0f },
+            { 0.0f, 0.0f, 1.0f },
+            { 0.0f, 0.0f, -1.0f },
+            { 1.0f, 1.0f, -1.0f },
+            { -1.0f, -1.0f, -1.0f },
+        }
+    );
+    // Not normalized, the encoder does not need them to be
+    normals[0] = { 10.0f, -20.0f, 0.5f };
+
+    const u32       count = static_cast<u32>( normals.size() );
+    std::vector<u8> encoded( normals.size() * 2 * sizeof( i16 ) );
+    encode_normals_octahedral( as_bytes( normals ), sizeof( Vec3 ), encoded.data(), 4, count );
+
+    // In f64, the cosine of such small angles is 1 in f32
+    const f64 max_angle = 0.01 * std::numbers::pi / 180.0;
+    for ( u32 i = 0; i < count; ++i ) {
+        const Vec3& n = normals[i];
+        f32         d[3];
+        decode_octahedral( load<i16>( encoded.data() + i * 4 ), load<i16>( encoded.data() + i * 4 + 2 ), d );
+
+        const f64 cross[3] = {
+            f64{ n[1] } * d[2] - f64{ n[2] } * d[1],
+            f64{ n[2] } * d[0] - f64{ n[0] } * d[2],
+            f64{ n[0] } * d[1] - f64{ n[1] } * d[0],
+        };
+        const f64 sine = std::sqrt( cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2] );
+        const f64 cosine = f64{ n[0] } * d[0] + f64{ n[1] } * d[1] + f64{ n[2] } * d[2];
+        ASSERT_LE( std::atan2( sine, cosine ), max_angle ) << "normal " << i;
+    }
+}
+
+TEST( VertexQuantization, colors_are_within_half_a_step )
+{
+    const std::vector<Vec3> colors = random_vectors( VALUE_COUNT, 0.0f, 1.0f );
+    std::vector<u8>         encoded( colors.size() * 4 );
+    encode_colors_unorm8( as_bytes( colors ), sizeof( Vec3 ), encoded.data(), 4, VALUE_COUNT );
+
+    for ( u32 i = 0; i < VALUE_COUNT; ++i ) {
+        for ( u32 channel = 0; channel < 3; ++channel ) {
+            const f32 decoded = static_cast<f32>( encoded[i * 4 + channel] ) / 255.0f;
+            ASSERT_LE( std::abs( decoded - colors[i][channel] ), 0.5f / 255.0f + 1e-6f ) << "color " << i;
+        }
+        ASSERT_EQ( encoded[i * 4 + 3], 255 );
+    }
+}
+
+// Values around every rounding and range edge, the SIMD kernels see them in every lane position
+auto edge_values() -> std::vector<Vec3>
+{
+    constexpr f32 INFINITY_VALUE = std::numeric_limits<f32>::infinity();
+
+    const std::vector<f32> values = {
+        // Signed zeros and clamping
+        0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 1.5f, -2.0f,
+        // Half subnormals, overflow and infinities
+        1e-9f, 6e-8f, -6e-8f, 3e-5f, 6.1e-5f, 65504.0f, 65519.0f, 65520.0f, -65520.0f, 1e10f, -1e10f, INFINITY_VALUE,
+        -INFINITY_VALUE,
+        // Ties between halves, snorm16 steps and unorm8 steps
+        1.0009765625f, 1.00048828125f, 1.00146484375f, 1.0f / 65534.0f, -1.0f / 65534.0f, 0.5f / 255.0f, 1.5f / 255.0f,
+    };
+
+    std::vector<Vec3> vectors;
+    for ( usize i = 0; i < values.size(); ++i ) {
+        vectors.push_back( { values[i], values[( i + 5 ) % values.size()], values[( i + 11 ) % values.size()] } );
+    }
+    return vectors;
+}
+
+TEST( VertexQuantization, simd_matches_scalar )
+{
+    const std::vector<Vec3> values = edge_values();
+    const u32               count = static_cast<u32>( values.size() );
+
+    std::vector<u8> half( count * 8 );
+    encode_positions_half( as_bytes( values ), sizeof( Vec3 ), half.data(), 8, count );
+
+    const MeshBounds bounds = { .min = { -1.0f, -1.0f, -1.0f }, .max = { 1.0f, 1.0f, 1.0f } };
+    std::vector<u8>  snorm( count * 8 );
+    encode_positions_snorm16( as_bytes( values ), sizeof( Vec3 ), snorm.data(), 8, count, bounds );
+
+    std::vector<u8> unorm( count * 4 );
+    encode_colors_unorm8( as_bytes( values ), sizeof( Vec3 ), unorm.data(), 4, count );
+
+    for ( u32 i = 0; i < count; ++i ) {
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            const f32 value = values[i][axis];
+            EXPECT_EQ( load<u16>( half.data() + i * 8 + axis * 2 ), float_to_half( value ) ) << value;
+            EXPECT_EQ( load<i16>( snorm.data() + i * 8 + axis * 2 ), reference_snorm16( value ) ) << value;
+            EXPECT_EQ( unorm[i * 4 + axis], reference_unorm8( value ) ) << value;
+        }
+    }
+
+    // Octahedral normals go four at a time, the remainder and single normals take the scalar path
+    std::vector<Vec3> normals = random_vectors( 64, -1.0f, 1.0f );
+    normals.insert( normals.end(), { { 0.0f, 0.0f, -1.0f }, { 0.0f, -0.0f, -1.0f }, { 0.0f, 0.0f, 0.0f } } );
+    normals.push_back( { -0.5f, 0.5f, -0.0f } );
+
+    const u32       normal_count = static_cast<u32>( normals.size() );
+    std::vector<u8> batched( normal_count * 4 );
+    std::vector<u8> single( normal_count * 4 );
+    encode_normals_octahedral( as_bytes( normals ), sizeof( Vec3 ), batched.data(), 4, normal_count );
+    for ( u32 i = 0; i < normal_count; ++i ) {
+        const u8* const normal = as_bytes( normals ) + i * sizeof( Vec3 );
+        encode_normals_octahedral( normal, sizeof( Vec3 ), single.data() + i * 4, 4, 1 );
+    }
+    EXPECT_EQ( batched, single );
+}
+
+TEST( VertexQuantization, quantized_meshes_round_trip )
+{
+    MeshData mesh{};
+    mesh.vertex_format = MeshVertexFormat::PositionColor;
+    for ( const Vec3& value : random_vectors( 1000, 0.0f, 1.0f ) ) {
+        const f32       vertex[6] = { value[0] * 10.0f, value[1] - 4.0f, 0.25f, value[2], value[1], value[0] };
+        const u8* const bytes = reinterpret_cast<const u8*>( vertex );
+        mesh.vertices.insert( mesh.vertices.end(), bytes, bytes + sizeof( vertex ) );
+    }
+    mesh.bounds = { .min = { 0.0f, -4.0f, 0.25f }, .max = { 10.0f, -3.0f, 0.25f } };
+
+    const std::vector<u8> original = mesh.vertices;
+    ASSERT_TRUE( quantize_mesh( mesh, MeshVertexFormat::PositionColorQuantized ) );
+    EXPECT_EQ( mesh.vertex_format, MeshVertexFormat::PositionColorQuantized );
+    EXPECT_FALSE( quantize_mesh( mesh, MeshVertexFormat::PositionColorQuantized ) );
+
+    std::vector<u8> decoded( original.size() );
+    ASSERT_TRUE( dequantize_vertices( mesh.vertex_format, mesh.bounds, mesh.vertices, decoded ) );
+
+    const f32 max_errors[6] = { 5.0f / 32767.0f, 0.5f / 32767.0f, 0.0f, 0.5f / 255.0f, 0.5f / 255.0f, 0.5f / 255.0f };
+    for ( usize i = 0; i < original.size(); i += sizeof( f32 ) ) {
+        const f32 error = std::abs( load<f32>( decoded.data() + i ) - load<f32>( original.data() + i ) );
+        ASSERT_LE( error, max_errors[i / sizeof( f32 ) % 6] * 1.001f + 1e-6f ) << "float " << i / sizeof( f32 );
+    }
+}
+} // namespace
+} // namespace mksv
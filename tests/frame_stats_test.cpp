@@ -0,0 +1,138 @@
+#include "mksv/frame_stats.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace mksv
+{
+namespace
+{
+using namespace std::chrono_literals;
+
+// Replays frames with given timings, the clock starts away from the epoch which FrameStats takes for no frame yet
+class FrameReplay
+{
+public:
+    auto frame(
+        const std::chrono::microseconds interval,
+        const std::chrono::microseconds cpu = 1ms,
+        const std::chrono::microseconds latency = 1ms,
+        const std::chrono::microseconds gpu = 0ms
+    ) -> void
+    {
+        now_ += interval;
+        stats.begin_frame( now_ );
+        stats.submit( now_ + cpu );
+        stats.present( now_ + cpu + latency );
+        stats.set_gpu_milliseconds( std::chrono::duration<f64, std::milli>( gpu ).count() );
+        stats.end_frame();
+    }
+
+    auto frames( const u32 count, const std::chrono::microseconds interval ) -> void
+    {
+        for ( u32 i = 0; i < count; ++i ) {
+            frame( interval );
+        }
+    }
+
+public:
+    FrameStats stats;
+
+private:
+    std::chrono::steady_clock::time_point now_ = std::chrono::steady_clock::time_point{} + 1s;
+};
+
+TEST( FrameStats, summarizes_every_metric )
+{
+    FrameReplay replay;
+    replay.stats.begin_frame( std::chrono::steady_clock::time_point{} + 1s );
+    replay.stats.end_frame();
+    for ( u32 i = 0; i < 10; ++i ) {
+        replay.frame( 16ms, 3ms, 2ms, 4ms );
+    }
+
+    const FrameStatsSummary summary = replay.stats.get_summary();
+    EXPECT_EQ( summary.frame_count, 11u );
+    EXPECT_EQ( summary.total_frame_count, 11u );
+    EXPECT_DOUBLE_EQ( summary.interval.mean, 16.0 );
+    EXPECT_DOUBLE_EQ( summary.cpu.mean, 3.0 );
+    EXPECT_DOUBLE_EQ( summary.latency.mean, 2.0 );
+    EXPECT_DOUBLE_EQ( summary.gpu.mean, 4.0 );
+    EXPECT_DOUBLE_EQ( replay.stats.get_delta_seconds(), 0.016 );
+
+    // The percentile is the top of its bucket, within 1/32 above the value
+    EXPECT_GE( summary.interval.p99, 16.0 );
+    EXPECT_LE( summary.interval.p99, 16.0 * 33.0 / 32.0 );
+}
+
+TEST( FrameStats, ignores_frames_that_were_not_begun )
+{
+    FrameStats stats;
+    stats.submit();
+    stats.present();
+    stats.end_frame();
+
+    EXPECT_EQ( stats.get_summary().total_frame_count, 0u );
+}
+
+TEST( FrameStats, window_evicts_the_oldest_frames )
+{
+    FrameReplay replay;
+    replay.frames( FrameStats::WINDOW_SIZE, 10ms );
+    EXPECT_DOUBLE_EQ( replay.stats.get_summary().interval.mean, 10.0 );
+
+    // Half the window at 20 ms, the median is the top of the 10 ms frames still in it
+    replay.frames( FrameStats::WINDOW_SIZE / 2, 20ms );
+    FrameStatsSummary summary = replay.stats.get_summary();
+    EXPECT_EQ( summary.frame_count, FrameStats::WINDOW_SIZE );
+    EXPECT_DOUBLE_EQ( summary.interval.mean, 15.0 );
+    EXPECT_LT( summary.interval.p50, 20.0 );
+
+    replay.frames( FrameStats::WINDOW_SIZE / 2, 20ms );
+    summary = replay.stats.get_summary();
+    EXPECT_EQ( summary.frame_count, FrameStats::WINDOW_SIZE );
+    EXPECT_EQ( summary.total_frame_count, 2 * FrameStats::WINDOW_SIZE );
+    EXPECT_DOUBLE_EQ( summary.interval.mean, 20.0 );
+    EXPECT_GE( summary.interval.p50, 20.0 );
+    EXPECT_EQ( summary.stutter_count, 0u );
+}
+
+TEST( FrameStats, counts_stutters_against_the_median )
+{
+    FrameReplay replay;
+    replay.frames( 100, 10ms );
+
+    // Twice the median is not a stutter yet, more than that is
+    replay.frame( 20ms );
+    EXPECT_EQ( replay.stats.get_summary().stutter_count, 0u );
+    replay.frame( 25ms );
+    replay.frames( 10, 10ms );
+    replay.frame( 50ms );
+
+    FrameStatsSummary summary = replay.stats.get_summary();
+    EXPECT_EQ( summary.stutter_count, 2u );
+    EXPECT_EQ( summary.total_stutter_count, 2u );
+
+    // The stutters leave the window, the totals keep them
+    replay.frames( FrameStats::WINDOW_SIZE, 10ms );
+    summary = replay.stats.get_summary();
+    EXPECT_EQ( summary.stutter_count, 0u );
+    EXPECT_EQ( summary.total_stutter_count, 2u );
+}
+
+TEST( FrameStats, no_stutters_while_warming_up )
+{
+    FrameReplay replay;
+    // The first frame has no interval
+    replay.frames( FrameStats::STUTTER_MIN_FRAMES, 10ms );
+    replay.frame( 100ms );
+    EXPECT_EQ( replay.stats.get_summary().stutter_count, 0u );
+
+    replay.frame( 100ms );
+    EXPECT_EQ( replay.stats.get_summary().stutter_count, 1u );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,20 @@
+#include "mksv/common/types.hpp"
+
+#include "tlsf_allocator_fuzz.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+
+extern "C" auto LLVMFuzzerTestOneInput( const std::uint8_t* data, const std::size_t size ) -> int
+{
+    const std::string error = mksv::run_tlsf_allocator_ops( std::span<const mksv::u8>{ data, size } );
+    if ( !error.empty() ) {
+        std::fprintf( stderr, "%s\n", error.c_str() );
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include "mksv/graphics/draw_queue.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+struct Draw {
+    DrawLayer layer;
+    u32       pipeline;
+    u32       material;
+    u32       mesh;
+    f32       depth;
+};
+
+// Draws over a few states each, at depths far enough apart to survive the quantization of the key
+auto make_draws( const u32 count ) -> std::vector<Draw>
+{
+    std::mt19937      random{ 5 };
+    std::vector<Draw> draws( count );
+    for ( Draw& draw : draws ) {
+        draw = {
+            .layer = random() % 4 == 0 ? DrawLayer::Transparent : DrawLayer::Opaque,
+            .pipeline = static_cast<u32>( random() % 3 ),
+            .material = static_cast<u32>( random() % 5 ),
+            .mesh = static_cast<u32>( random() % 7 ),
+            .depth = static_cast<f32>( random() % 1000 ) * 0.5f,
+        };
+    }
+    return draws;
+}
+
+// Pushes the draws with their index as the payload and sorts them
+auto sort_draws( const std::vector<Draw>& draws, JobSystem* const jobs ) -> DrawQueue
+{
+    DrawQueue queue;
+    for ( u32 i = 0; i < draws.size(); ++i ) {
+        const Draw& draw = draws[i];
+        queue.push( DrawQueue::make_key( draw.layer, draw.pipeline, draw.material, draw.mesh, draw.depth ), i );
+    }
+    queue.sort( jobs );
+    return queue;
+}
+
+auto get_state( const Draw& draw ) -> std::tuple<u32, u32, u32>
+{
+    return { draw.pipeline, draw.material, draw.mesh };
+}
+
+TEST( DrawQueue, keys_read_back_what_went_in )
+{
+    constexpr u32 max_pipeline = ( 1u << DrawQueue::PIPELINE_BITS ) - 1;
+    constexpr u32 max_material = ( 1u << DrawQueue::MATERIAL_BITS ) - 1;
+    constexpr u32 max_mesh = ( 1u << DrawQueue::MESH_BITS ) - 1;
+
+    for ( const DrawLayer layer : { DrawLayer::Opaque, DrawLayer::Transparent } ) {
+        for ( const f32 depth : { 0.0f, 1.0f, 1e6f } ) {
+            const u64 low = DrawQueue::make_key( layer, 0, 0, 0, depth );
+            EXPECT_EQ( DrawQueue::get_layer( low ), layer );
+            EXPECT_EQ( DrawQueue::get_pipeline( low ), 0u );
+            EXPECT_EQ( DrawQueue::get_material( low ), 0u );
+            EXPECT_EQ( DrawQueue::get_mesh( low ), 0u );
+
+            const u64 high = DrawQueue::make_key( layer, max_pipeline, max_material, max_mesh, depth );
+            EXPECT_EQ( DrawQueue::get_layer( high ), layer );
+            EXPECT_EQ( DrawQueue::get_pipeline( high ), max_pipeline );
+            EXPECT_EQ( DrawQueue::get_material( high ), max_material );
+            EXPECT_EQ( DrawQueue::get_mesh( high ), max_mesh );
+
+            const u64 mixed = DrawQueue::make_key( layer, 1234, 2345, 34567, depth );
+            EXPECT_EQ( DrawQueue::get_pipeline( mixed ), 1234u );
+            EXPECT_EQ( DrawQueue::get_material( mixed ), 2345u );
+            EXPECT_EQ( DrawQueue::get_mesh( mixed ), 34567u );
+        }
+    }
+}
+
+TEST( DrawQueue, negative_and_nan_depths_sort_as_zero )
+{
+    for ( const DrawLayer layer : { DrawLayer::Opaque, DrawLayer::Transparent } ) {
+        const u64 zero = DrawQueue::make_key( layer, 1, 2, 3, 0.0f );
+        EXPECT_EQ( DrawQueue::make_key( layer, 1, 2, 3, -0.0f ), zero );
+        EXPECT_EQ( DrawQueue::make_key( layer, 1, 2, 3, -5.0f ), zero );
+        EXPECT_EQ( DrawQueue::make_key( layer, 1, 2, 3, -std::numeric_limits<f32>::infinity() ), zero );
+        EXPECT_EQ( DrawQueue::make_key( layer, 1, 2, 3, std::numeric_limits<f32>::quiet_NaN() ), zero );
+        EXPECT_EQ( DrawQueue::make_key( layer, 1, 2, 3, -std::numeric_limits<f32>::quiet_NaN() ), zero );
+        EXPECT_EQ( DrawQueue::get_mesh( zero ), 3u );
+    }
+
+    // Nearest first for opaque draws, farthest first for transparent ones
+    EXPECT_LT(
+        DrawQueue::make_key( DrawLayer::Opaque, 1, 2, 3, -1.0f ),
+        DrawQueue::make_key( DrawLayer::Opaque, 1, 2, 3, 0.5f )
+    );
+    EXPECT_GT(
+        DrawQueue::make_key( DrawLayer::Transparent, 1, 2, 3, -1.0f ),
+        DrawQueue::make_key( DrawLayer::Transparent, 1, 2, 3, 0.5f )
+    );
+}
+
+TEST( DrawQueue, sorts_opaque_by_state_then_front_to_back_and_transparent_back_to_front )
+{
+    const std::vector<Draw>          draws = make_draws( 50'000 );
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 3 );
+    for ( JobSystem* const job_system : { static_cast<JobSystem*>( nullptr ), jobs.get() } ) {
+        SCOPED_TRACE( job_system ? "with jobs" : "without jobs" );
+
+        const DrawQueue queue = sort_draws( draws, job_system );
+        ASSERT_EQ( queue.get_count(), draws.size() );
+
+        const std::span<const u64> keys = queue.get_keys();
+        const std::span<const u32> payloads = queue.get_payloads();
+        for ( u32 i = 0; i < queue.get_count(); ++i ) {
+            const Draw& draw = draws[payloads[i]];
+            ASSERT_EQ( DrawQueue::get_layer( keys[i] ), draw.layer );
+            ASSERT_EQ( DrawQueue::get_pipeline( keys[i] ), draw.pipeline );
+            ASSERT_EQ( DrawQueue::get_material( keys[i] ), draw.material );
+            ASSERT_EQ( DrawQueue::get_mesh( keys[i] ), draw.mesh );
+            if ( i == 0 ) {
+                continue;
+            }
+
+            const Draw& previous = draws[payloads[i - 1]];
+            ASSERT_LE( previous.layer, draw.layer );
+            if ( previous.layer != draw.layer ) {
+                continue;
+            }
+
+            if ( draw.layer == DrawLayer::Opaque ) {
+                ASSERT_LE( get_state( previous ), get_state( draw ) );
+                if ( get_state( previous ) == get_state( draw ) ) {
+                    ASSERT_LE( previous.depth, draw.depth );
+                }
+            } else {
+                ASSERT_GE( previous.depth, draw.depth );
+                if ( previous.depth == draw.depth ) {
+                    ASSERT_LE( get_state( previous ), get_state( draw ) );
+                }
+            }
+
+            // Equal keys keep their push order
+            if ( keys[i - 1] == keys[i] ) {
+                ASSERT_LT( payloads[i - 1], payloads[i] );
+            }
+        }
+    }
+}
+
+TEST( DrawQueue, reset_keeps_nothing_of_the_previous_frame )
+{
+    DrawQueue queue = sort_draws( make_draws( 100 ), nullptr );
+    queue.reset();
+    EXPECT_EQ( queue.get_count(), 0u );
+
+    queue.push( DrawQueue::make_key( DrawLayer::Opaque, 1, 1, 1, 2.0f ), 7 );
+    queue.sort();
+    ASSERT_EQ( queue.get_count(), 1u );
+    EXPECT_EQ( queue.get_payloads()[0], 7u );
+}
+
+TEST( DrawQueue, counts_state_changes )
+{
+    EXPECT_EQ( DrawQueue::count_state_changes( {} ).pipeline, 0u );
+
+    const std::vector<u64> keys = {
+        DrawQueue::make_key( DrawLayer::Opaque, 0, 0, 0, 1.0f ),
+        DrawQueue::make_key( DrawLayer::Opaque, 0, 0, 0, 2.0f ),
+        DrawQueue::make_key( DrawLayer::Opaque, 0, 0, 1, 1.0f ),
+        DrawQueue::make_key( DrawLayer::Opaque, 0, 1, 1, 1.0f ),
+        DrawQueue::make_key( DrawLayer::Opaque, 1, 1, 1, 1.0f ),
+        // The same state in the other layer is not a change
+        DrawQueue::make_key( DrawLayer::Transparent, 1, 1, 1, 5.0f ),
+        DrawQueue::make_key( DrawLayer::Transparent, 1, 1, 2, 4.0f ),
+        DrawQueue::make_key( DrawLayer::Transparent, 1, 1, 1, 3.0f ),
+    };
+
+    const DrawStateChanges first = DrawQueue::count_state_changes( std::span{ keys }.first( 1 ) );
+    EXPECT_EQ( first.pipeline, 1u );
+    EXPECT_EQ( first.material, 1u );
+    EXPECT_EQ( first.mesh, 1u );
+
+    const DrawStateChanges changes = DrawQueue::count_state_changes( keys );
+    EXPECT_EQ( changes.pipeline, 2u );
+    EXPECT_EQ( changes.material, 2u );
+    EXPECT_EQ( changes.mesh, 4u );
+}
+} // namespace
+} // namespace mksv
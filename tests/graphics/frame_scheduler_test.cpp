@@ -0,0 +1,87 @@
+#include "mksv/graphics/frame_scheduler.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/mock_fence.hpp"
+
+#include <gtest/gtest.h>
+
+namespace mksv
+{
+namespace
+{
+TEST( FrameScheduler, contexts_are_reused_round_robin )
+{
+    MockFence      fence;
+    FrameScheduler scheduler{ fence, 3 };
+
+    for ( u32 frame = 0; frame < 7; ++frame ) {
+        EXPECT_EQ( scheduler.begin_frame(), frame % 3 );
+        EXPECT_EQ( scheduler.end_frame(), u64{ frame } + 1 );
+
+        // The GPU keeps up, nothing ever has to wait
+        fence.complete_up_to( fence.get_signaled_value() );
+    }
+
+    EXPECT_EQ( scheduler.get_frame_number(), 7u );
+    EXPECT_EQ( scheduler.get_stall_count(), 0u );
+    EXPECT_EQ( fence.get_wait_count(), 0u );
+}
+
+TEST( FrameScheduler, frames_in_flight_are_queued_without_waiting )
+{
+    MockFence      fence;
+    FrameScheduler scheduler{ fence, 3 };
+
+    for ( u32 frame = 0; frame < 3; ++frame ) {
+        static_cast<void>( scheduler.begin_frame() );
+        scheduler.end_frame();
+    }
+
+    EXPECT_EQ( fence.get_completed_value(), 0u );
+    EXPECT_EQ( scheduler.get_stall_count(), 0u );
+    EXPECT_EQ( fence.get_wait_count(), 0u );
+}
+
+TEST( FrameScheduler, reusing_a_busy_context_waits_for_its_fence_only )
+{
+    MockFence      fence;
+    FrameScheduler scheduler{ fence, 2 };
+
+    static_cast<void>( scheduler.begin_frame() );
+    const u64 first = scheduler.end_frame();
+    static_cast<void>( scheduler.begin_frame() );
+    const u64 second = scheduler.end_frame();
+
+    // Context 0 is reused with the GPU still on the first frame, the wait must not cover the second one
+    EXPECT_EQ( scheduler.begin_frame(), 0u );
+    EXPECT_EQ( scheduler.get_stall_count(), 1u );
+    EXPECT_EQ( fence.get_stall_count(), 1u );
+    EXPECT_EQ( fence.get_completed_value(), first );
+    EXPECT_LT( fence.get_completed_value(), second );
+    EXPECT_EQ( scheduler.get_context_fence_value( 1 ), second );
+    scheduler.end_frame();
+
+    // Once the GPU has caught up on its own, reuse is free again
+    fence.complete_up_to( second );
+    EXPECT_EQ( scheduler.begin_frame(), 1u );
+    EXPECT_EQ( scheduler.get_stall_count(), 1u );
+    scheduler.end_frame();
+}
+
+TEST( FrameScheduler, wait_idle_waits_for_the_last_frame )
+{
+    MockFence      fence;
+    FrameScheduler scheduler{ fence, 3 };
+
+    u64 last = 0;
+    for ( u32 frame = 0; frame < 5; ++frame ) {
+        static_cast<void>( scheduler.begin_frame() );
+        last = scheduler.end_frame();
+        fence.complete_up_to( last - 1 );
+    }
+
+    EXPECT_TRUE( scheduler.wait_idle() );
+    EXPECT_EQ( fence.get_completed_value(), last );
+}
+} // namespace
+} // namespace mksv
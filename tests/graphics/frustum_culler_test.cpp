@@ -0,0 +1,135 @@
+#include "mksv/graphics/frustum_culler.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+#include "mksv/math/mat.hpp"
+#include "mksv/math/quat.hpp"
+#include "mksv/scene/transform_hierarchy.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+const vec3 CENTER = { 0.25f, 0.5f, -1.0f };
+const vec3 EXTENT = { 0.5f, 1.0f, 2.0f };
+
+struct Scene {
+    TransformHierarchy       transforms;
+    std::vector<TransformId> objects;
+};
+
+// count objects under a rotated and scaled root, each with its own translation, rotation and scale
+auto make_scene( const u32 count ) -> std::unique_ptr<Scene>
+{
+    auto              scene = std::make_unique<Scene>();
+    const quat        tilt = quat_from_axis_angle( { 1.0f, 0.0f, 0.0f }, 0.3f );
+    const vec3        scale = { 2.0f, 2.0f, 2.0f };
+    const TransformId root = scene->transforms.create( INVALID_TRANSFORM, { 1.0f, 2.0f, 3.0f }, tilt, scale );
+
+    for ( u32 i = 0; i < count; ++i ) {
+        const f32 t = static_cast<f32>( i );
+        scene->objects.push_back( scene->transforms.create(
+            root,
+            { std::sin( t ) * 50.0f, std::cos( t ) * 50.0f, t * 0.01f },
+            quat_from_axis_angle( { 0.0f, 1.0f, 1.0f }, t * 0.1f ),
+            { 1.0f, 0.5f + static_cast<f32>( i % 3 ), 1.0f }
+        ) );
+    }
+
+    scene->transforms.update();
+    return scene;
+}
+
+// The box around every object's transformed box, as set_transformed() computes it without SIMD
+auto make_reference( const Scene& scene ) -> FrustumCuller
+{
+    FrustumCuller culler;
+    for ( const TransformId object : scene.objects ) {
+        const mat4& world = scene.transforms.get_world( object );
+        const vec3  extent = {
+            std::abs( world.r[0].x ) * EXTENT.x + std::abs( world.r[1].x ) * EXTENT.y +
+                std::abs( world.r[2].x ) * EXTENT.z,
+            std::abs( world.r[0].y ) * EXTENT.x + std::abs( world.r[1].y ) * EXTENT.y +
+                std::abs( world.r[2].y ) * EXTENT.z,
+            std::abs( world.r[0].z ) * EXTENT.x + std::abs( world.r[1].z ) * EXTENT.y +
+                std::abs( world.r[2].z ) * EXTENT.z,
+        };
+        culler.add( transform_point( CENTER, world ), extent );
+    }
+    return culler;
+}
+
+// Narrow frusta looking at the scene from around it, each one cuts through a different part of the objects
+auto make_frusta() -> std::vector<Frustum>
+{
+    std::vector<Frustum> frusta;
+    for ( u32 i = 0; i < 16; ++i ) {
+        const f32  angle = static_cast<f32>( i ) * 0.4f;
+        const f32  height = static_cast<f32>( i ) * 5.0f - 40.0f;
+        const vec3 eye = { std::sin( angle ) * 150.0f, height, std::cos( angle ) * 150.0f };
+        const mat4 view = look_at_lh( eye, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } );
+        frusta.push_back( extract_frustum( view * perspective_fov_lh( 0.3f, 1.0f, 1.0f, 300.0f ) ) );
+    }
+    return frusta;
+}
+
+auto get_visible( const FrustumCuller& culler, const Frustum& frustum, const CullShape shape, JobSystem* const jobs )
+    -> std::vector<u32>
+{
+    std::vector<u32> visible;
+    culler.cull( frustum, shape, visible, jobs );
+    return visible;
+}
+
+TEST( FrustumCuller, transformed_bounds_match_the_scalar_boxes )
+{
+    // Not a multiple of any SIMD width, so the scalar tail runs as well
+    const std::unique_ptr<Scene> scene = make_scene( 1001 );
+
+    FrustumCuller culler;
+    culler.set_transformed( scene->transforms, scene->objects, CENTER, EXTENT );
+    const FrustumCuller reference = make_reference( *scene );
+    ASSERT_EQ( culler.get_count(), reference.get_count() );
+
+    u64 visible_count = 0;
+    for ( const Frustum& frustum : make_frusta() ) {
+        for ( const CullShape shape : { CullShape::Box, CullShape::Sphere } ) {
+            const std::vector<u32> visible = get_visible( culler, frustum, shape, nullptr );
+            EXPECT_EQ( visible, get_visible( reference, frustum, shape, nullptr ) );
+            visible_count += visible.size();
+        }
+    }
+
+    // Neither everything nor nothing, or the comparison says little
+    EXPECT_GT( visible_count, 0u );
+    EXPECT_LT( visible_count, u64{ 1001 } * 32 );
+}
+
+TEST( FrustumCuller, jobs_match_a_single_thread )
+{
+    const u32                    count = 5 * FrustumCuller::MIN_BLOCK_SIZE + 3;
+    const std::unique_ptr<Scene> scene = make_scene( count );
+    const auto                   jobs = JobSystem::create( 3 );
+    ASSERT_NE( jobs, nullptr );
+
+    FrustumCuller single;
+    single.set_transformed( scene->transforms, scene->objects, CENTER, EXTENT );
+    FrustumCuller parallel;
+    parallel.set_transformed( scene->transforms, scene->objects, CENTER, EXTENT, jobs.get() );
+    ASSERT_EQ( parallel.get_count(), count );
+
+    // Culling again with the same culler reuses its block counts
+    for ( const Frustum& frustum : make_frusta() ) {
+        const std::vector<u32> expected = get_visible( single, frustum, CullShape::Box, nullptr );
+        EXPECT_EQ( get_visible( parallel, frustum, CullShape::Box, jobs.get() ), expected );
+        EXPECT_EQ( get_visible( single, frustum, CullShape::Box, jobs.get() ), expected );
+    }
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,138 @@
+#include "mksv/graphics/gpu_profiler.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/command_list_pool.hpp"
+#include "mksv/graphics/mock_timestamp_query_pool.hpp"
+#include "mksv/profiler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace mksv
+{
+namespace
+{
+using namespace std::chrono_literals;
+
+// A microsecond per tick
+constexpr u64 FREQUENCY = 1'000'000;
+
+// Two frames in flight with two zones each
+constexpr u32 QUERY_COUNT = 8;
+constexpr u32 FRAMES_IN_FLIGHT = 2;
+
+struct Fixture {
+    MockTimestampQueryPool                      pool{ QUERY_COUNT, FREQUENCY };
+    GpuProfiler                                 profiler{ pool, FRAMES_IN_FLIGHT };
+    const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    // Any non-null handle, the mock pool never dereferences it
+    int               list_storage = 0;
+    CommandListHandle list = &list_storage;
+
+    Fixture()
+    {
+        pool.set_calibration( { .gpu_timestamp = 0, .cpu_time = origin } );
+    }
+
+    // Reads frame 0 back once the other frame in flight is done
+    auto read_back() -> void
+    {
+        profiler.begin_frame( 1 );
+        profiler.end_frame( list );
+        profiler.begin_frame( 0 );
+    }
+};
+
+TEST( GpuProfiler, zones_round_trip_through_the_queries )
+{
+    Fixture fixture;
+    fixture.profiler.begin_frame( 0 );
+
+    const u32 outer = fixture.profiler.begin_zone( fixture.list, "outer" );
+    fixture.pool.advance( 1000 );
+    const u32 inner = fixture.profiler.begin_zone( fixture.list, "inner" );
+    fixture.pool.advance( 500 );
+    fixture.profiler.end_zone( fixture.list, inner );
+    fixture.pool.advance( 250 );
+    fixture.profiler.end_zone( fixture.list, outer );
+    fixture.profiler.end_frame( fixture.list );
+
+    // Nothing is read back before the context comes around again
+    EXPECT_TRUE( fixture.profiler.get_zones().empty() );
+
+    fixture.read_back();
+    const std::span<const GpuZoneTiming> zones = fixture.profiler.get_zones();
+    ASSERT_EQ( zones.size(), 2u );
+
+    EXPECT_EQ( std::string_view{ zones[0].name }, "outer" );
+    EXPECT_EQ( zones[0].begin, fixture.origin );
+    EXPECT_EQ( zones[0].end, fixture.origin + 1750us );
+
+    EXPECT_EQ( std::string_view{ zones[1].name }, "inner" );
+    EXPECT_EQ( zones[1].begin, fixture.origin + 1000us );
+    EXPECT_EQ( zones[1].end, fixture.origin + 1500us );
+
+    EXPECT_DOUBLE_EQ( fixture.profiler.get_frame_milliseconds(), 1.75 );
+    EXPECT_EQ( fixture.profiler.get_dropped_count(), 0u );
+    EXPECT_EQ( fixture.pool.get_error_count(), 0u );
+}
+
+TEST( GpuProfiler, end_frame_closes_open_zones )
+{
+    Fixture fixture;
+    fixture.profiler.begin_frame( 0 );
+
+    [[maybe_unused]] const u32 zone = fixture.profiler.begin_zone( fixture.list, "open" );
+    fixture.pool.advance( 300 );
+    fixture.profiler.end_frame( fixture.list );
+
+    fixture.read_back();
+    ASSERT_EQ( fixture.profiler.get_zones().size(), 1u );
+    EXPECT_EQ( fixture.profiler.get_zones()[0].end, fixture.origin + 300us );
+}
+
+TEST( GpuProfiler, counts_zones_without_queries )
+{
+    Fixture fixture;
+    fixture.profiler.begin_frame( 0 );
+
+    EXPECT_NE( fixture.profiler.begin_zone( fixture.list, "first" ), GpuProfiler::INVALID_ZONE );
+    EXPECT_NE( fixture.profiler.begin_zone( fixture.list, "second" ), GpuProfiler::INVALID_ZONE );
+    EXPECT_EQ( fixture.profiler.begin_zone( fixture.list, "third" ), GpuProfiler::INVALID_ZONE );
+    EXPECT_EQ( fixture.profiler.begin_zone( nullptr, "null_list" ), GpuProfiler::INVALID_ZONE );
+    fixture.profiler.end_zone( fixture.list, GpuProfiler::INVALID_ZONE );
+    fixture.profiler.end_frame( fixture.list );
+    EXPECT_EQ( fixture.profiler.begin_zone( fixture.list, "after_end" ), GpuProfiler::INVALID_ZONE );
+
+    EXPECT_EQ( fixture.profiler.get_dropped_count(), 3u );
+
+    // The dropped zones never touched the queries of the other frame
+    fixture.read_back();
+    EXPECT_EQ( fixture.profiler.get_zones().size(), 2u );
+    EXPECT_EQ( fixture.pool.get_error_count(), 0u );
+}
+
+TEST( GpuProfiler, zones_reach_the_capture )
+{
+    const std::unique_ptr<Profiler> capture = Profiler::create();
+    ASSERT_NE( capture, nullptr );
+
+    Fixture fixture;
+    fixture.profiler.begin_frame( 0 );
+    const u32 zone = fixture.profiler.begin_zone( fixture.list, "gpu" );
+    fixture.pool.advance( 100 );
+    fixture.profiler.end_zone( fixture.list, zone );
+    fixture.profiler.end_frame( fixture.list );
+
+    capture->begin_capture();
+    fixture.read_back();
+    capture->end_capture();
+
+    EXPECT_EQ( capture->get_event_count(), 1u );
+}
+} // namespace
+} // namespace mksv
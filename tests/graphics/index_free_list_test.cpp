@@ -0,0 +1,120 @@
+#include "mksv/graphics/index_free_list.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <barrier>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+TEST( IndexFreeList, pops_filled_indices_in_order_and_reuses_the_last_pushed )
+{
+    IndexFreeList list{ 4, true };
+    EXPECT_EQ( list.get_size(), 4u );
+
+    for ( u32 index = 0; index < 4; ++index ) {
+        EXPECT_EQ( list.pop(), index );
+    }
+    EXPECT_EQ( list.pop(), std::nullopt );
+    EXPECT_EQ( list.get_size(), 0u );
+
+    list.push( 2 );
+    list.push( 0 );
+    EXPECT_EQ( list.get_size(), 2u );
+    EXPECT_EQ( list.pop(), 0u );
+    EXPECT_EQ( list.pop(), 2u );
+    EXPECT_EQ( list.pop(), std::nullopt );
+}
+
+TEST( IndexFreeList, take_all_detaches_the_chain )
+{
+    IndexFreeList list{ 8, false };
+    EXPECT_EQ( list.pop(), std::nullopt );
+    EXPECT_EQ( list.take_all(), IndexFreeList::INVALID_INDEX );
+
+    list.push( 5 );
+    list.push( 1 );
+    list.push( 7 );
+
+    std::vector<u32> chain;
+    for ( u32 index = list.take_all(); index != IndexFreeList::INVALID_INDEX; index = list.get_next( index ) ) {
+        chain.push_back( index );
+    }
+
+    EXPECT_EQ( chain, ( std::vector<u32>{ 7, 1, 5 } ) );
+    EXPECT_EQ( list.get_size(), 0u );
+    EXPECT_EQ( list.pop(), std::nullopt );
+
+    // Indices of a walked chain can go back into the list they came from
+    for ( const u32 index : chain ) {
+        list.push( index );
+    }
+    EXPECT_EQ( list.get_size(), 3u );
+    EXPECT_EQ( list.pop(), 5u );
+}
+
+// Threads churn through a list smaller than their combined demand, an index handed to two owners at once is the ABA
+// failure the head tag guards against
+TEST( IndexFreeList, concurrent_pop_and_push_never_share_an_index )
+{
+    constexpr u32 capacity = 64;
+    constexpr u32 thread_count = 4;
+    constexpr u32 iteration_count = 50'000;
+
+    IndexFreeList                        list{ capacity, true };
+    std::unique_ptr<std::atomic<bool>[]> owned = std::make_unique<std::atomic<bool>[]>( capacity );
+    std::atomic<u32>                     shared_count{ 0 };
+    std::barrier                         start{ thread_count };
+
+    std::vector<std::jthread> threads;
+    for ( u32 thread = 0; thread < thread_count; ++thread ) {
+        threads.emplace_back( [&] {
+            std::vector<u32> held;
+            start.arrive_and_wait();
+
+            for ( u32 iteration = 0; iteration < iteration_count; ++iteration ) {
+                // Holds up to a few indices at a time so the list runs empty now and then
+                if ( held.size() < 4 && iteration % 5 != 4 ) {
+                    if ( const std::optional<u32> index = list.pop() ) {
+                        if ( owned[*index].exchange( true ) ) {
+                            shared_count.fetch_add( 1 );
+                        }
+                        held.push_back( *index );
+                    }
+                } else if ( !held.empty() ) {
+                    owned[held.back()].store( false );
+                    list.push( held.back() );
+                    held.pop_back();
+                }
+            }
+
+            for ( const u32 index : held ) {
+                owned[index].store( false );
+                list.push( index );
+            }
+        } );
+    }
+    threads.clear();
+
+    EXPECT_EQ( shared_count.load(), 0u );
+    ASSERT_EQ( list.get_size(), capacity );
+
+    std::vector<bool> seen( capacity, false );
+    for ( u32 index = 0; index < capacity; ++index ) {
+        const std::optional<u32> popped = list.pop();
+        ASSERT_TRUE( popped );
+        ASSERT_FALSE( seen[*popped] ) << "index " << *popped;
+        seen[*popped] = true;
+    }
+    EXPECT_EQ( list.pop(), std::nullopt );
+}
+} // namespace
+} // namespace mksv
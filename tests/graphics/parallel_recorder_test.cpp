@@ -0,0 +1,112 @@
+#include "mksv/graphics/parallel_recorder.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/mock_command_list_pool.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+constexpr u32 SERIAL_MARKER = ~0u;
+
+// Records a marker, draw_count draws and another marker, then returns the commands of the submitted batch in order
+auto record_frame( ParallelRecorder& recorder, MockCommandListPool& pool, JobSystem* const jobs, const u32 draw_count )
+    -> std::vector<u32>
+{
+    EXPECT_TRUE( pool.begin_frame( 0 ) );
+    recorder.begin( pool, jobs );
+
+    MockCommandListPool::get_list( recorder.get_list() ).commands.push_back( SERIAL_MARKER );
+    const bool recorded = recorder.record( draw_count, []( const CommandListHandle list, const DrawChunk chunk ) {
+        for ( u32 draw = chunk.first; draw < chunk.first + chunk.count; ++draw ) {
+            MockCommandListPool::get_list( list ).commands.push_back( draw );
+        }
+    } );
+    EXPECT_TRUE( recorded );
+    MockCommandListPool::get_list( recorder.get_list() ).commands.push_back( SERIAL_MARKER );
+
+    EXPECT_TRUE( recorder.finish() );
+    pool.submit( recorder.get_batch() );
+
+    std::vector<u32> commands;
+    for ( const MockCommandList& list : pool.get_submissions().back() ) {
+        commands.insert( commands.end(), list.commands.begin(), list.commands.end() );
+    }
+    return commands;
+}
+
+auto expected_commands( const u32 draw_count ) -> std::vector<u32>
+{
+    std::vector<u32> commands{ SERIAL_MARKER };
+    for ( u32 draw = 0; draw < draw_count; ++draw ) {
+        commands.push_back( draw );
+    }
+    commands.push_back( SERIAL_MARKER );
+    return commands;
+}
+
+TEST( ParallelRecorder, split_balances_chunks )
+{
+    std::vector<DrawChunk> chunks;
+
+    ParallelRecorder::split( 1000, 4, 10, chunks );
+    ASSERT_EQ( chunks.size(), 4 * ParallelRecorder::CHUNKS_PER_WORKER );
+    u32 next = 0;
+    for ( const DrawChunk& chunk : chunks ) {
+        EXPECT_EQ( chunk.first, next );
+        EXPECT_TRUE( chunk.count == 62 || chunk.count == 63 );
+        next += chunk.count;
+    }
+    EXPECT_EQ( next, 1000u );
+
+    ParallelRecorder::split( 1000, 4, 300, chunks );
+    EXPECT_EQ( chunks.size(), 3u );
+
+    ParallelRecorder::split( 0, 4, 1, chunks );
+    EXPECT_TRUE( chunks.empty() );
+}
+
+TEST( ParallelRecorder, records_chunks_as_jobs_in_draw_order )
+{
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 3 );
+    const u32                        worker_count = jobs->get_worker_count() + 1;
+
+    MockCommandListPool                     pool{ worker_count };
+    const std::unique_ptr<ParallelRecorder> recorder = ParallelRecorder::create( worker_count, 16 );
+
+    for ( u32 frame = 0; frame < 10; ++frame ) {
+        EXPECT_EQ( record_frame( *recorder, pool, jobs.get(), 1000 ), expected_commands( 1000 ) );
+    }
+
+    EXPECT_EQ( pool.get_error_count(), 0u );
+    EXPECT_EQ( pool.get_submissions().back().size(), worker_count * ParallelRecorder::CHUNKS_PER_WORKER + 2 );
+
+    // Lists are reused from frame to frame instead of piling up. Whichever worker steals the most chunks in a frame
+    // needs that many lists, so every worker stays within the lists of a single frame.
+    for ( u32 worker = 0; worker < worker_count; ++worker ) {
+        EXPECT_LE( pool.get_list_count( worker ), worker_count * ParallelRecorder::CHUNKS_PER_WORKER + 2 );
+    }
+}
+
+TEST( ParallelRecorder, records_chunks_serially_without_jobs )
+{
+    MockCommandListPool                     pool{ 4 };
+    const std::unique_ptr<ParallelRecorder> recorder = ParallelRecorder::create( 4, 16 );
+
+    EXPECT_EQ( record_frame( *recorder, pool, nullptr, 500 ), expected_commands( 500 ) );
+    EXPECT_EQ( pool.get_error_count(), 0u );
+    EXPECT_EQ( pool.get_list_count( 1 ), 0u );
+
+    // A range that fits in one chunk stays in the serial list
+    EXPECT_EQ( record_frame( *recorder, pool, nullptr, 10 ), expected_commands( 10 ) );
+    EXPECT_EQ( pool.get_submissions().back().size(), 1u );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,159 @@
+#include "mksv/graphics/render_graph.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// The D3D12_RESOURCE_STATES values, the graph only sees them as bit masks
+constexpr u32 RENDER_TARGET = 0x4;
+constexpr u32 UNORDERED_ACCESS = 0x8;
+constexpr u32 NON_PIXEL_SHADER_RESOURCE = 0x40;
+constexpr u32 PIXEL_SHADER_RESOURCE = 0x80;
+constexpr u32 READ_ONLY_STATES = NON_PIXEL_SHADER_RESOURCE | PIXEL_SHADER_RESOURCE;
+
+auto barriers_before( const RenderGraph& graph, const u32 compiled_pass ) -> std::vector<RenderGraphBarrier>
+{
+    const CompiledRenderGraph& compiled = graph.get_compiled();
+    const CompiledRenderPass&  pass = compiled.passes[compiled_pass];
+    return {
+        compiled.barriers.begin() + pass.first_barrier_before,
+        compiled.barriers.begin() + pass.first_barrier_before + pass.barrier_before_count,
+    };
+}
+
+TEST( RenderGraph, culls_passes_without_consumers )
+{
+    RenderGraph graph{ READ_ONLY_STATES, UNORDERED_ACCESS };
+
+    const RenderGraphResource back_buffer = graph.import_resource();
+    const RenderGraphResource unused = graph.create_transient( 1024, 256 );
+    graph.add_pass( "unused" ).write( unused, RENDER_TARGET );
+    graph.add_pass( "draw" ).write( back_buffer, RENDER_TARGET );
+    graph.export_resource( back_buffer, 0 );
+
+    EXPECT_TRUE( graph.compile() );
+    const CompiledRenderGraph& compiled = graph.get_compiled();
+    ASSERT_EQ( compiled.passes.size(), 1u );
+    EXPECT_EQ( graph.get_pass_name( compiled.passes[0].pass ), "draw" );
+    EXPECT_EQ( compiled.culled_pass_count, 1u );
+    EXPECT_EQ( compiled.offsets[unused], RenderGraph::INVALID_OFFSET );
+
+    // The same declarations again reuse the compiled graph
+    graph.reset();
+    const RenderGraphResource next_back_buffer = graph.import_resource();
+    const RenderGraphResource next_unused = graph.create_transient( 1024, 256 );
+    graph.add_pass( "unused" ).write( next_unused, RENDER_TARGET );
+    graph.add_pass( "draw" ).write( next_back_buffer, RENDER_TARGET );
+    graph.export_resource( next_back_buffer, 0 );
+    EXPECT_FALSE( graph.compile() );
+}
+
+TEST( RenderGraph, rejects_conflicting_states_within_a_pass )
+{
+    RenderGraph graph{ READ_ONLY_STATES, UNORDERED_ACCESS };
+
+    const RenderGraphResource target = graph.import_resource();
+    const RenderGraphResource buffer = graph.import_resource();
+    graph.add_pass( "feedback" )
+        .write( target, RENDER_TARGET )
+        .read( target, PIXEL_SHADER_RESOURCE )
+        .read( buffer, PIXEL_SHADER_RESOURCE )
+        .read( buffer, NON_PIXEL_SHADER_RESOURCE )
+        .read( buffer, PIXEL_SHADER_RESOURCE );
+    graph.export_resource( target, 0 );
+
+    // Only the render target read is dropped, read states combine and repeating a state is fine
+    EXPECT_EQ( graph.get_rejected_access_count(), 1u );
+
+    ASSERT_TRUE( graph.compile() );
+    const std::vector<RenderGraphBarrier> barriers = barriers_before( graph, 0 );
+    ASSERT_EQ( barriers.size(), 2u );
+    EXPECT_EQ( barriers[0].resource, target );
+    EXPECT_EQ( barriers[0].state, RENDER_TARGET );
+    EXPECT_EQ( barriers[1].resource, buffer );
+    EXPECT_EQ( barriers[1].state, PIXEL_SHADER_RESOURCE | NON_PIXEL_SHADER_RESOURCE );
+
+    graph.reset();
+    EXPECT_EQ( graph.get_rejected_access_count(), 0u );
+}
+
+TEST( RenderGraph, orders_unordered_access_between_passes )
+{
+    RenderGraph graph{ READ_ONLY_STATES, UNORDERED_ACCESS };
+
+    const RenderGraphResource buffer = graph.import_resource();
+    graph.add_pass( "clear" ).write( buffer, UNORDERED_ACCESS );
+    graph.add_pass( "accumulate" ).read( buffer, UNORDERED_ACCESS ).write( buffer, UNORDERED_ACCESS );
+    graph.add_pass( "read" ).read( buffer, UNORDERED_ACCESS ).has_side_effects();
+    graph.add_pass( "read_again" ).read( buffer, UNORDERED_ACCESS ).has_side_effects();
+    graph.export_resource( buffer, UNORDERED_ACCESS );
+
+    ASSERT_TRUE( graph.compile() );
+    ASSERT_EQ( graph.get_compiled().passes.size(), 4u );
+
+    std::vector<RenderGraphBarrier> barriers = barriers_before( graph, 0 );
+    ASSERT_EQ( barriers.size(), 1u );
+    EXPECT_EQ( barriers[0].type, RenderGraphBarrierType::Transition );
+
+    // Write after write and read after write, one barrier per pass even with several accesses
+    for ( u32 pass = 1; pass < 3; ++pass ) {
+        barriers = barriers_before( graph, pass );
+        ASSERT_EQ( barriers.size(), 1u ) << "pass " << pass;
+        EXPECT_EQ( barriers[0].resource, buffer );
+        EXPECT_EQ( barriers[0].state, UNORDERED_ACCESS );
+        EXPECT_EQ( barriers[0].type, RenderGraphBarrierType::UnorderedAccess );
+    }
+
+    // Two reads need no ordering
+    EXPECT_TRUE( barriers_before( graph, 3 ).empty() );
+}
+
+TEST( RenderGraph, does_not_order_render_target_writes )
+{
+    RenderGraph graph{ READ_ONLY_STATES, UNORDERED_ACCESS };
+
+    const RenderGraphResource target = graph.import_resource();
+    graph.add_pass( "opaque" ).write( target, RENDER_TARGET );
+    graph.add_pass( "transparent" ).write( target, RENDER_TARGET );
+    graph.export_resource( target, RENDER_TARGET );
+
+    ASSERT_TRUE( graph.compile() );
+    EXPECT_EQ( barriers_before( graph, 0 ).size(), 1u );
+    EXPECT_TRUE( barriers_before( graph, 1 ).empty() );
+}
+
+TEST( RenderGraph, aliases_transients_with_disjoint_lifetimes )
+{
+    RenderGraph graph{ READ_ONLY_STATES, UNORDERED_ACCESS };
+
+    const RenderGraphResource back_buffer = graph.import_resource();
+    const RenderGraphResource first = graph.create_transient( 4096, 256 );
+    const RenderGraphResource second = graph.create_transient( 4096, 256 );
+    const RenderGraphResource third = graph.create_transient( 4096, 256 );
+    graph.add_pass( "first" ).write( first, RENDER_TARGET );
+    graph.add_pass( "second" ).read( first, PIXEL_SHADER_RESOURCE ).write( second, RENDER_TARGET );
+    graph.add_pass( "third" ).read( second, PIXEL_SHADER_RESOURCE ).write( third, RENDER_TARGET );
+    graph.add_pass( "resolve" ).read( third, PIXEL_SHADER_RESOURCE ).write( back_buffer, RENDER_TARGET );
+    graph.export_resource( back_buffer, 0 );
+
+    ASSERT_TRUE( graph.compile() );
+    const CompiledRenderGraph& compiled = graph.get_compiled();
+
+    // first is done before third starts, second overlaps both
+    EXPECT_EQ( compiled.offsets[first], compiled.offsets[third] );
+    EXPECT_NE( compiled.offsets[first], compiled.offsets[second] );
+    EXPECT_EQ( compiled.transient_size, 8192u );
+
+    const CompiledRenderPass& pass = compiled.passes[2];
+    ASSERT_EQ( pass.aliasing_count, 1u );
+    EXPECT_EQ( compiled.aliasing[pass.first_aliasing].before, first );
+    EXPECT_EQ( compiled.aliasing[pass.first_aliasing].after, third );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,180 @@
+#include "mksv/graphics/resource_state_tracker.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// The D3D12_RESOURCE_STATES values, the tracker only sees them as bit masks
+constexpr u32 COMMON = 0x0;
+constexpr u32 RENDER_TARGET = 0x4;
+constexpr u32 UNORDERED_ACCESS = 0x8;
+constexpr u32 PIXEL_SHADER_RESOURCE = 0x80;
+constexpr u32 COPY_SOURCE = 0x800;
+constexpr u32 READ_ONLY_STATES = PIXEL_SHADER_RESOURCE | COPY_SOURCE;
+
+constexpr u32 ALL = ResourceStateTracker::ALL_SUBRESOURCES;
+
+const int         texture_storage = 0;
+const int         buffer_storage = 0;
+const void* const texture = &texture_storage;
+const void* const buffer = &buffer_storage;
+
+auto flush( ResourceStateTracker& tracker ) -> std::vector<ResourceTransition>
+{
+    std::vector<ResourceTransition> transitions;
+    const u32                       count = tracker.flush( transitions );
+    EXPECT_EQ( count, transitions.size() );
+    return transitions;
+}
+
+auto expect_transition(
+    const ResourceTransition& transition,
+    const void*               resource,
+    const u32                 subresource,
+    const u32                 before,
+    const u32                 after,
+    const BarrierPhase        phase
+) -> void
+{
+    EXPECT_EQ( transition.resource, resource );
+    EXPECT_EQ( transition.subresource, subresource );
+    EXPECT_EQ( transition.before, before );
+    EXPECT_EQ( transition.after, after );
+    EXPECT_EQ( transition.phase, phase );
+}
+
+TEST( ResourceStateTracker, drops_redundant_transitions )
+{
+    ResourceStateTracker tracker{ READ_ONLY_STATES };
+    tracker.track( texture, PIXEL_SHADER_RESOURCE );
+
+    tracker.require( texture, PIXEL_SHADER_RESOURCE );
+    EXPECT_FALSE( tracker.has_pending() );
+    EXPECT_TRUE( flush( tracker ).empty() );
+
+    tracker.require( texture, RENDER_TARGET );
+    tracker.require( texture, RENDER_TARGET );
+    std::vector<ResourceTransition> transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition( transitions[0], texture, ALL, PIXEL_SHADER_RESOURCE, RENDER_TARGET, BarrierPhase::Full );
+
+    // A round trip between two flushes leaves nothing to record
+    tracker.require( texture, UNORDERED_ACCESS );
+    tracker.require( texture, RENDER_TARGET );
+    EXPECT_FALSE( tracker.has_pending() );
+    EXPECT_TRUE( flush( tracker ).empty() );
+    EXPECT_EQ( tracker.get_state( texture ), RENDER_TARGET );
+}
+
+TEST( ResourceStateTracker, combines_read_only_states )
+{
+    ResourceStateTracker tracker{ READ_ONLY_STATES };
+    tracker.track( buffer, PIXEL_SHADER_RESOURCE );
+
+    tracker.require( buffer, COPY_SOURCE );
+    std::vector<ResourceTransition> transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition(
+        transitions[0], buffer, ALL, PIXEL_SHADER_RESOURCE, PIXEL_SHADER_RESOURCE | COPY_SOURCE, BarrierPhase::Full
+    );
+
+    // Either read state is covered by the combined one
+    tracker.require( buffer, PIXEL_SHADER_RESOURCE );
+    tracker.require( buffer, COPY_SOURCE );
+    EXPECT_TRUE( flush( tracker ).empty() );
+}
+
+TEST( ResourceStateTracker, tracks_each_subresource )
+{
+    ResourceStateTracker tracker{ READ_ONLY_STATES };
+    tracker.track( texture, COMMON, 3 );
+
+    tracker.require( texture, RENDER_TARGET, 1 );
+    std::vector<ResourceTransition> transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition( transitions[0], texture, 1, COMMON, RENDER_TARGET, BarrierPhase::Full );
+    EXPECT_EQ( tracker.get_state( texture, 0 ), COMMON );
+    EXPECT_EQ( tracker.get_state( texture, 1 ), RENDER_TARGET );
+    EXPECT_EQ( tracker.get_state( texture, 2 ), COMMON );
+
+    // Subresources in different states are transitioned one by one
+    tracker.require( texture, PIXEL_SHADER_RESOURCE );
+    transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 3u );
+    expect_transition( transitions[0], texture, 0, COMMON, PIXEL_SHADER_RESOURCE, BarrierPhase::Full );
+    expect_transition( transitions[1], texture, 1, RENDER_TARGET, PIXEL_SHADER_RESOURCE, BarrierPhase::Full );
+    expect_transition( transitions[2], texture, 2, COMMON, PIXEL_SHADER_RESOURCE, BarrierPhase::Full );
+
+    // And with the same state again in a single transition for all of them
+    tracker.require( texture, UNORDERED_ACCESS );
+    transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition( transitions[0], texture, ALL, PIXEL_SHADER_RESOURCE, UNORDERED_ACCESS, BarrierPhase::Full );
+}
+
+TEST( ResourceStateTracker, splits_a_transition_across_flushes )
+{
+    ResourceStateTracker tracker{ READ_ONLY_STATES };
+    tracker.track( texture, RENDER_TARGET );
+
+    tracker.prepare( texture, PIXEL_SHADER_RESOURCE );
+    std::vector<ResourceTransition> transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition( transitions[0], texture, ALL, RENDER_TARGET, PIXEL_SHADER_RESOURCE, BarrierPhase::Begin );
+    EXPECT_EQ( tracker.get_state( texture ), RENDER_TARGET );
+
+    tracker.require( texture, PIXEL_SHADER_RESOURCE );
+    transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition( transitions[0], texture, ALL, RENDER_TARGET, PIXEL_SHADER_RESOURCE, BarrierPhase::End );
+    EXPECT_EQ( tracker.get_state( texture ), PIXEL_SHADER_RESOURCE );
+}
+
+TEST( ResourceStateTracker, ends_a_split_before_a_different_state )
+{
+    ResourceStateTracker tracker{ READ_ONLY_STATES };
+    tracker.track( texture, RENDER_TARGET, 2 );
+
+    tracker.prepare( texture, PIXEL_SHADER_RESOURCE, 0 );
+    EXPECT_EQ( flush( tracker ).size(), 1u );
+
+    tracker.require( texture, UNORDERED_ACCESS, 0 );
+    const std::vector<ResourceTransition> transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 2u );
+    expect_transition( transitions[0], texture, 0, RENDER_TARGET, PIXEL_SHADER_RESOURCE, BarrierPhase::End );
+    expect_transition( transitions[1], texture, 0, PIXEL_SHADER_RESOURCE, UNORDERED_ACCESS, BarrierPhase::Full );
+    EXPECT_EQ( tracker.get_state( texture, 1 ), RENDER_TARGET );
+}
+
+TEST( ResourceStateTracker, collapses_a_split_within_one_flush )
+{
+    ResourceStateTracker tracker{ READ_ONLY_STATES };
+    tracker.track( texture, RENDER_TARGET );
+
+    tracker.prepare( texture, PIXEL_SHADER_RESOURCE );
+    tracker.require( texture, PIXEL_SHADER_RESOURCE );
+    const std::vector<ResourceTransition> transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition( transitions[0], texture, ALL, RENDER_TARGET, PIXEL_SHADER_RESOURCE, BarrierPhase::Full );
+}
+
+TEST( ResourceStateTracker, untrack_keeps_requested_transitions )
+{
+    ResourceStateTracker tracker{ READ_ONLY_STATES };
+    tracker.track( buffer, COMMON );
+    tracker.require( buffer, COPY_SOURCE );
+    tracker.untrack( buffer );
+
+    EXPECT_FALSE( tracker.is_tracked( buffer ) );
+    const std::vector<ResourceTransition> transitions = flush( tracker );
+    ASSERT_EQ( transitions.size(), 1u );
+    expect_transition( transitions[0], buffer, ALL, COMMON, COPY_SOURCE, BarrierPhase::Full );
+}
+} // namespace
+} // namespace mksv
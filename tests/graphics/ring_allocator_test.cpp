@@ -0,0 +1,151 @@
+#include "mksv/graphics/ring_allocator.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <barrier>
+#include <deque>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+struct Range {
+    u64 offset;
+    u64 size;
+};
+
+// Sorts the ranges and checks that none of them overlap or leave the ring
+auto expect_disjoint( std::vector<Range> ranges, const u64 capacity ) -> void
+{
+    std::ranges::sort( ranges, {}, &Range::offset );
+    for ( usize i = 0; i < ranges.size(); ++i ) {
+        ASSERT_LE( ranges[i].offset + ranges[i].size, capacity ) << "range " << i;
+        if ( i > 0 ) {
+            ASSERT_LE( ranges[i - 1].offset + ranges[i - 1].size, ranges[i].offset ) << "range " << i;
+        }
+    }
+}
+
+TEST( RingAllocator, allocations_are_aligned_and_never_wrap )
+{
+    RingAllocator ring{ 256 };
+
+    EXPECT_EQ( ring.allocate( 64, 16 ), 0u );
+    EXPECT_EQ( ring.allocate( 10, 16 ), 64u );
+    EXPECT_EQ( ring.allocate( 0, 16 ), std::nullopt );
+    EXPECT_EQ( ring.allocate( 257, 16 ), std::nullopt );
+    ring.close_batch( 1 );
+
+    EXPECT_EQ( ring.allocate( 150, 16 ), 80u );
+    ring.close_batch( 2 );
+
+    // Full until the first batch is retired, then the next allocation skips the tail end and starts over at 0
+    EXPECT_EQ( ring.allocate( 32, 16 ), std::nullopt );
+    ring.retire( 1 );
+    EXPECT_EQ( ring.get_oldest_pending_fence(), 2u );
+    EXPECT_EQ( ring.allocate( 32, 16 ), 0u );
+
+    // The skipped end of the buffer counts as used until the batch that skipped it retires
+    EXPECT_EQ( ring.get_used(), 256u - 74u + 32u );
+
+    ring.close_batch( 3 );
+    ring.retire( 3 );
+    EXPECT_EQ( ring.get_used(), 0u );
+    EXPECT_EQ( ring.get_oldest_pending_fence(), std::nullopt );
+}
+
+TEST( RingAllocator, empty_batches_are_not_recorded )
+{
+    RingAllocator ring{ 64 };
+
+    ring.close_batch( 1 );
+    EXPECT_EQ( ring.get_oldest_pending_fence(), std::nullopt );
+    EXPECT_FALSE( ring.has_open_allocations() );
+
+    EXPECT_TRUE( ring.allocate( 8, 8 ) );
+    EXPECT_TRUE( ring.has_open_allocations() );
+    ring.close_batch( 2 );
+    EXPECT_FALSE( ring.has_open_allocations() );
+    EXPECT_EQ( ring.get_oldest_pending_fence(), 2u );
+}
+
+// Producers reserve concurrently during a frame, the submitting thread commits the frame as a batch and retires the
+// batch frames_in_flight frames later. No reservation may overlap one of a frame that is still in flight.
+TEST( RingAllocator, concurrent_producers_never_overlap )
+{
+    constexpr u64 capacity = 64 * 1024;
+    constexpr u32 producer_count = 4;
+    constexpr u32 frame_count = 200;
+    constexpr u32 frames_in_flight = 3;
+    constexpr u32 reservations_per_frame = 64;
+
+    RingAllocator                   ring{ capacity };
+    std::vector<std::vector<Range>> produced( producer_count );
+    std::vector<u32>                failures( producer_count, 0 );
+
+    std::barrier frame_start{ producer_count + 1 };
+    std::barrier frame_end{ producer_count + 1 };
+
+    std::vector<std::jthread> producers;
+    for ( u32 producer = 0; producer < producer_count; ++producer ) {
+        producers.emplace_back( [&, producer] {
+            u32 seed = producer * 7919u + 1u;
+            for ( u32 frame = 0; frame < frame_count; ++frame ) {
+                frame_start.arrive_and_wait();
+                for ( u32 reservation = 0; reservation < reservations_per_frame; ++reservation ) {
+                    seed = seed * 1664525u + 1013904223u;
+                    const u64 size = 1 + ( seed >> 8 ) % 96;
+                    const u64 alignment = u64{ 1 } << ( ( seed >> 4 ) % 5 );
+                    if ( const std::optional<u64> offset = ring.allocate( size, alignment ) ) {
+                        if ( *offset % alignment != 0 ) {
+                            ++failures[producer];
+                        }
+                        produced[producer].push_back( { *offset, size } );
+                    }
+                }
+                frame_end.arrive_and_wait();
+            }
+        } );
+    }
+
+    std::deque<std::vector<Range>> in_flight;
+    u64                            reserved_count = 0;
+    for ( u32 frame = 0; frame < frame_count; ++frame ) {
+        frame_start.arrive_and_wait();
+        frame_end.arrive_and_wait();
+
+        std::vector<Range> frame_ranges;
+        for ( std::vector<Range>& ranges : produced ) {
+            frame_ranges.insert( frame_ranges.end(), ranges.begin(), ranges.end() );
+            ranges.clear();
+        }
+        reserved_count += frame_ranges.size();
+
+        std::vector<Range> live = frame_ranges;
+        for ( const std::vector<Range>& ranges : in_flight ) {
+            live.insert( live.end(), ranges.begin(), ranges.end() );
+        }
+        expect_disjoint( live, capacity );
+        ASSERT_FALSE( HasFatalFailure() ) << "frame " << frame;
+
+        ring.close_batch( frame + 1 );
+        in_flight.push_back( std::move( frame_ranges ) );
+        if ( in_flight.size() == frames_in_flight ) {
+            ring.retire( frame + 2 - frames_in_flight );
+            in_flight.pop_front();
+        }
+    }
+
+    EXPECT_EQ( std::ranges::count( failures, 0u ), producer_count );
+
+    // The ring is sized so that most reservations fit, the test is pointless if they all fail
+    EXPECT_GT( reserved_count, u64{ frame_count } * producer_count * reservations_per_frame / 2 );
+}
+} // namespace
+} // namespace mksv
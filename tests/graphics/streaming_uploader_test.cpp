@@ -0,0 +1,149 @@
+#include "mksv/graphics/streaming_uploader.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/mock_upload_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+auto make_bytes( const u64 size, const u8 first ) -> std::vector<u8>
+{
+    std::vector<u8> bytes( size );
+    std::iota( bytes.begin(), bytes.end(), first );
+    return bytes;
+}
+
+TEST( StreamingUploader, batches_small_requests_until_flush )
+{
+    MockUploadQueue                    queue{ 1024 };
+    std::unique_ptr<StreamingUploader> uploader = StreamingUploader::create( queue, 256 );
+    ASSERT_NE( uploader, nullptr );
+
+    u32                   buffer = 0;
+    const std::vector<u8> data = make_bytes( 48, 0 );
+
+    std::vector<UploadTicket> tickets;
+    for ( u64 offset = 0; offset < data.size(); offset += 16 ) {
+        const std::optional<UploadTicket> ticket = uploader->request( &buffer, offset, data.data() + offset, 16 );
+        ASSERT_TRUE( ticket );
+        tickets.push_back( *ticket );
+    }
+
+    EXPECT_TRUE( queue.get_submissions().empty() );
+    EXPECT_FALSE( uploader->is_complete( tickets.front() ) );
+
+    ASSERT_TRUE( uploader->flush() );
+    ASSERT_EQ( queue.get_submissions().size(), 1u );
+
+    const MockUploadSubmission& submission = queue.get_submissions().front();
+    ASSERT_EQ( submission.copies.size(), 3u );
+    for ( usize i = 0; i < submission.copies.size(); ++i ) {
+        const MockBufferCopy& copy = submission.copies[i];
+        EXPECT_EQ( copy.copy.destination, &buffer );
+        EXPECT_EQ( copy.copy.destination_offset, i * 16 );
+        EXPECT_EQ( copy.data, std::vector<u8>( data.begin() + i * 16, data.begin() + ( i + 1 ) * 16 ) );
+        EXPECT_EQ( tickets[i].batch, 0u );
+    }
+
+    EXPECT_FALSE( uploader->is_complete( tickets.front() ) );
+    queue.get_mock_fence().complete_up_to( submission.fence_value );
+    EXPECT_TRUE( uploader->is_complete( tickets.front() ) );
+}
+
+TEST( StreamingUploader, splits_large_requests_across_batches )
+{
+    MockUploadQueue                    queue{ 1024 };
+    std::unique_ptr<StreamingUploader> uploader = StreamingUploader::create( queue, 64 );
+    ASSERT_NE( uploader, nullptr );
+
+    u32                   buffer = 0;
+    const std::vector<u8> data = make_bytes( 200, 7 );
+
+    const std::optional<UploadTicket> ticket = uploader->request( &buffer, 1000, data.data(), data.size() );
+    ASSERT_TRUE( ticket );
+
+    // The three full batches went out, the 8 byte tail is still open
+    EXPECT_EQ( uploader->get_submitted_batch_count(), 3u );
+    EXPECT_EQ( ticket->batch, 3u );
+    ASSERT_TRUE( uploader->flush() );
+
+    std::vector<u8> received( data.size() );
+    for ( const MockUploadSubmission& submission : queue.get_submissions() ) {
+        ASSERT_EQ( submission.copies.size(), 1u );
+        const MockBufferCopy& copy = submission.copies.front();
+        EXPECT_LE( copy.copy.size, 64u );
+        std::ranges::copy( copy.data, received.begin() + static_cast<isize>( copy.copy.destination_offset - 1000 ) );
+    }
+    EXPECT_EQ( queue.get_submissions().size(), 4u );
+    EXPECT_EQ( received, data );
+}
+
+TEST( StreamingUploader, gpu_waits_submit_the_open_batch_once )
+{
+    MockUploadQueue                    queue{ 1024 };
+    std::unique_ptr<StreamingUploader> uploader = StreamingUploader::create( queue, 256 );
+    ASSERT_NE( uploader, nullptr );
+
+    u32                   buffer = 0;
+    const std::vector<u8> data = make_bytes( 32, 0 );
+
+    const std::optional<UploadTicket> ticket = uploader->request( &buffer, 0, data.data(), data.size() );
+    ASSERT_TRUE( ticket );
+
+    ASSERT_TRUE( uploader->wait_on_gpu( *ticket ) );
+    ASSERT_TRUE( uploader->wait_on_gpu( *ticket ) );
+
+    EXPECT_EQ( queue.get_submissions().size(), 1u );
+    EXPECT_EQ( queue.get_gpu_waits(), std::vector<u64>{ 1 } );
+    EXPECT_EQ( queue.get_mock_fence().get_stall_count(), 0u );
+}
+
+TEST( StreamingUploader, full_staging_memory_stalls_on_the_oldest_batch )
+{
+    MockUploadQueue                    queue{ 256 };
+    std::unique_ptr<StreamingUploader> uploader = StreamingUploader::create( queue, 128 );
+    ASSERT_NE( uploader, nullptr );
+
+    u32                   buffer = 0;
+    const std::vector<u8> data = make_bytes( 128, 0 );
+
+    for ( u64 batch = 0; batch < 2; ++batch ) {
+        const std::optional<UploadTicket> ticket = uploader->request( &buffer, 0, data.data(), data.size() );
+        ASSERT_TRUE( ticket );
+        EXPECT_EQ( ticket->batch, batch );
+    }
+    EXPECT_EQ( uploader->get_stall_count(), 0u );
+
+    // Nothing has completed, the third batch has to wait for the first
+    const std::optional<UploadTicket> ticket = uploader->request( &buffer, 0, data.data(), data.size() );
+    ASSERT_TRUE( ticket );
+    EXPECT_EQ( uploader->get_stall_count(), 1u );
+    EXPECT_EQ( queue.get_mock_fence().get_stall_count(), 1u );
+    EXPECT_EQ( queue.get_mock_fence().get_completed_value(), 1u );
+    EXPECT_EQ( queue.get_submissions().size(), 3u );
+}
+
+TEST( StreamingUploader, rejects_empty_requests )
+{
+    MockUploadQueue                    queue{ 1024 };
+    std::unique_ptr<StreamingUploader> uploader = StreamingUploader::create( queue, 256 );
+    ASSERT_NE( uploader, nullptr );
+
+    u32 buffer = 0;
+    EXPECT_EQ( uploader->request( &buffer, 0, &buffer, 0 ), std::nullopt );
+
+    ASSERT_TRUE( uploader->flush() );
+    EXPECT_TRUE( queue.get_submissions().empty() );
+    EXPECT_EQ( uploader->get_submitted_batch_count(), 0u );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "mksv/common/types.hpp"
+#include "mksv/graphics/tlsf_allocator.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mksv
+{
+// Replays a byte string as allocate and free calls on a TlsfAllocator and checks every result against a model of the
+// live allocations. Shared by the randomized test and the libFuzzer target, returns an empty string on success and a
+// description of the first problem otherwise.
+inline auto run_tlsf_allocator_ops( const std::span<const u8> data ) -> std::string
+{
+    constexpr u64 granularity = 256;
+    constexpr u64 capacity = 1024 * granularity;
+
+    TlsfAllocator allocator{ capacity, granularity };
+
+    // Offset to size of the live allocations, and their blocks in allocation order
+    std::map<u64, u64>          live;
+    std::vector<TlsfAllocation> allocations;
+
+    const auto check_stats = [&]() -> std::string {
+        u64 used = 0;
+        for ( const auto& [offset, size] : live ) {
+            used += size;
+        }
+        if ( allocator.get_used() != used || allocator.get_allocation_count() != live.size() ) {
+            return std::format( "used {} in {} allocations, expected {} in {}", allocator.get_used(),
+                                allocator.get_allocation_count(), used, live.size() );
+        }
+        return {};
+    };
+
+    usize cursor = 0;
+    while ( cursor + 3 <= data.size() ) {
+        const u8  op = data[cursor];
+        const u32 value = u32{ data[cursor + 1] } | ( u32{ data[cursor + 2] } << 8 );
+        cursor += 3;
+
+        if ( op % 3 != 0 || allocations.empty() ) {
+            // Sizes from a single byte up to a quarter of the capacity, alignments up to 16 granules
+            const u64 size = 1 + value % ( capacity / 4 );
+            const u64 alignment = u64{ 1 } << ( op / 3 % 13 );
+
+            const std::optional<TlsfAllocation> allocation = allocator.allocate( size, alignment );
+            if ( !allocation ) {
+                continue;
+            }
+
+            if ( allocation->offset % std::max( alignment, granularity ) != 0 ) {
+                return std::format( "offset {} is not aligned to {}", allocation->offset, alignment );
+            }
+            if ( allocation->size < size || allocation->size % granularity != 0 ||
+                 allocation->offset + allocation->size > capacity ) {
+                return std::format(
+                    "allocation of {} bytes got [{}, +{})", size, allocation->offset, allocation->size
+                );
+            }
+
+            const auto next = live.lower_bound( allocation->offset );
+            if ( next != live.end() && next->first < allocation->offset + allocation->size ) {
+                return std::format( "[{}, +{}) overlaps offset {}", allocation->offset, allocation->size, next->first );
+            }
+            if ( next != live.begin() && std::prev( next )->first + std::prev( next )->second > allocation->offset ) {
+                return std::format(
+                    "[{}, +{}) overlaps the allocation before it", allocation->offset, allocation->size
+                );
+            }
+
+            live.emplace( allocation->offset, allocation->size );
+            allocations.push_back( *allocation );
+        } else {
+            const usize index = value % allocations.size();
+            allocator.free( allocations[index].block );
+            live.erase( allocations[index].offset );
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+        }
+
+        if ( std::string error = check_stats(); !error.empty() ) {
+            return error;
+        }
+    }
+
+    // Freeing everything has to coalesce the range back into a single block
+    for ( const TlsfAllocation& allocation : allocations ) {
+        allocator.free( allocation.block );
+    }
+
+    const TlsfStats stats = allocator.get_stats();
+    if ( !allocator.is_empty() || stats.free_block_count != 1 || stats.largest_free_block != capacity ) {
+        return std::format( "{} free blocks, largest {} after freeing everything", stats.free_block_count,
+                            stats.largest_free_block );
+    }
+    return {};
+}
+} // namespace mksv
@@ -0,0 +1,72 @@
+#include "mksv/graphics/tlsf_allocator.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include "tlsf_allocator_fuzz.hpp"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+TEST( TlsfAllocator, reuses_freed_blocks_and_coalesces )
+{
+    TlsfAllocator allocator{ 4096, 256 };
+
+    const std::optional<TlsfAllocation> first = allocator.allocate( 1000, 256 );
+    const std::optional<TlsfAllocation> second = allocator.allocate( 256, 1024 );
+    ASSERT_TRUE( first && second );
+    EXPECT_EQ( first->size, 1024u );
+    EXPECT_EQ( second->offset % 1024, 0u );
+    EXPECT_EQ( allocator.get_allocation_count(), 2u );
+
+    allocator.free( first->block );
+    const std::optional<TlsfAllocation> third = allocator.allocate( 512, 256 );
+    ASSERT_TRUE( third );
+    EXPECT_EQ( third->offset, 0u );
+
+    allocator.free( second->block );
+    allocator.free( third->block );
+    const TlsfStats stats = allocator.get_stats();
+    EXPECT_TRUE( allocator.is_empty() );
+    EXPECT_EQ( stats.free_block_count, 1u );
+    EXPECT_EQ( stats.largest_free_block, 4096u );
+    EXPECT_EQ( stats.fragmentation, 0.0f );
+}
+
+TEST( TlsfAllocator, fails_when_no_block_fits )
+{
+    TlsfAllocator allocator{ 4096, 256 };
+
+    EXPECT_FALSE( allocator.allocate( 8192, 256 ) );
+    const std::optional<TlsfAllocation> whole = allocator.allocate( 4096, 256 );
+    ASSERT_TRUE( whole );
+    EXPECT_FALSE( allocator.allocate( 1, 256 ) );
+    allocator.free( whole->block );
+    EXPECT_TRUE( allocator.is_empty() );
+}
+
+// Random inputs through the same driver as the libFuzzer target, so plain test runs cover it too
+TEST( TlsfAllocator, random_operations_match_the_model )
+{
+    std::mt19937                    random{ 1234 };
+    std::uniform_int_distribution<> byte{ 0, 255 };
+
+    for ( u32 run = 0; run < 200; ++run ) {
+        std::vector<u8> data( 3 * 2000 );
+        for ( u8& value : data ) {
+            value = static_cast<u8>( byte( random ) );
+        }
+
+        const std::string error = run_tlsf_allocator_ops( data );
+        ASSERT_TRUE( error.empty() ) << "run " << run << ": " << error;
+    }
+}
+} // namespace
+} // namespace mksv
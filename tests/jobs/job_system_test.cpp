@@ -0,0 +1,132 @@
+#include "mksv/jobs/job_system.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_counter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+TEST( JobSystem, wait_returns_after_every_job )
+{
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 3 );
+
+    constexpr u32    job_count = 1000;
+    std::atomic<u32> done_count{ 0 };
+    JobCounter       counter;
+    for ( u32 job = 0; job < job_count; ++job ) {
+        jobs->run( [&] { done_count.fetch_add( 1, std::memory_order_relaxed ); }, &counter );
+    }
+    jobs->wait( counter );
+
+    EXPECT_TRUE( counter.is_done() );
+    EXPECT_EQ( done_count.load(), job_count );
+}
+
+TEST( JobSystem, dependent_job_runs_after_its_dependency )
+{
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 3 );
+
+    constexpr u32    first_count = 64;
+    std::atomic<u32> first_done{ 0 };
+    std::atomic<u32> seen_by_second{ 0 };
+    JobCounter       first;
+    JobCounter       second;
+    for ( u32 job = 0; job < first_count; ++job ) {
+        jobs->run( [&] { first_done.fetch_add( 1, std::memory_order_relaxed ); }, &first );
+    }
+    jobs->run( [&] { seen_by_second = first_done.load( std::memory_order_relaxed ); }, &second, &first );
+    jobs->wait( second );
+    jobs->wait( first );
+
+    EXPECT_EQ( seen_by_second.load(), first_count );
+}
+
+TEST( JobSystem, dependency_that_is_done_does_not_hold_a_job_back )
+{
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 1 );
+
+    bool       ran = false;
+    JobCounter done;
+    JobCounter counter;
+    jobs->run( [&] { ran = true; }, &counter, &done );
+    jobs->wait( counter );
+
+    EXPECT_TRUE( ran );
+}
+
+TEST( JobSystem, parallel_for_covers_every_item_once )
+{
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 3 );
+
+    for ( const u32 count : { 1u, 7u, 64u, 1000u, 100'003u } ) {
+        std::vector<std::atomic<u32>> visits( count );
+        jobs->parallel_for( count, 16, [&]( const u32 first, const u32 range_count ) {
+            for ( u32 item = first; item < first + range_count; ++item ) {
+                visits[item].fetch_add( 1, std::memory_order_relaxed );
+            }
+        } );
+
+        for ( u32 item = 0; item < count; ++item ) {
+            ASSERT_EQ( visits[item].load(), 1u ) << "item " << item << " of " << count;
+        }
+    }
+}
+
+// Jobs that wait for jobs of their own keep the workers busy instead of blocking them, so this cannot deadlock even
+// with more waiting jobs than workers
+TEST( JobSystem, jobs_can_wait_for_nested_jobs )
+{
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 2 );
+
+    constexpr u32    outer_count = 16;
+    constexpr u32    inner_count = 32;
+    std::atomic<u32> inner_done{ 0 };
+    JobCounter       outer;
+    for ( u32 job = 0; job < outer_count; ++job ) {
+        jobs->run(
+            [&] {
+                JobCounter inner;
+                for ( u32 nested = 0; nested < inner_count; ++nested ) {
+                    jobs->run( [&] { inner_done.fetch_add( 1, std::memory_order_relaxed ); }, &inner );
+                }
+                jobs->wait( inner );
+            },
+            &outer
+        );
+    }
+    jobs->wait( outer );
+
+    EXPECT_EQ( inner_done.load(), outer_count * inner_count );
+}
+
+TEST( JobSystem, worker_index_is_only_valid_on_workers )
+{
+    constexpr u32                    worker_count = 3;
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( worker_count );
+
+    EXPECT_EQ( jobs->get_worker_count(), worker_count );
+    EXPECT_EQ( jobs->get_worker_index(), JobSystem::INVALID_WORKER );
+
+    constexpr u32    job_count = 256;
+    std::vector<u32> indices( job_count );
+    JobCounter       counter;
+    for ( u32 job = 0; job < job_count; ++job ) {
+        jobs->run( [&, job] { indices[job] = jobs->get_worker_index(); }, &counter );
+    }
+    jobs->wait( counter );
+
+    // The calling thread helps out in wait(), the jobs it runs see no worker index
+    for ( const u32 index : indices ) {
+        EXPECT_TRUE( index < worker_count || index == JobSystem::INVALID_WORKER ) << "index " << index;
+    }
+}
+
+} // namespace
+} // namespace mksv
@@ -0,0 +1,115 @@
+#include "mksv/jobs/radix_sort.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/jobs/job_system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+// Three workers split this many keys into the most blocks they take, 16, each above the minimum size
+constexpr u32 MANY_BLOCKS_COUNT = RADIX_MIN_BLOCK_SIZE * 20;
+
+// count random keys with only the bits of mask set, or always set when they are in set_bits
+auto make_keys( const u32 count, const u64 mask, const u64 set_bits = 0 ) -> std::vector<u64>
+{
+    std::mt19937_64  random{ count ^ mask };
+    std::vector<u64> keys( count );
+    for ( u64& key : keys ) {
+        key = ( random() & mask ) | set_bits;
+    }
+    return keys;
+}
+
+// Sorts the keys with their positions as values, on the calling thread and on a job system, and checks the result
+// against std::stable_sort
+auto expect_stable_sort( const std::vector<u64>& input ) -> void
+{
+    const u32 count = static_cast<u32>( input.size() );
+
+    std::vector<u32> expected( count );
+    for ( u32 i = 0; i < count; ++i ) {
+        expected[i] = i;
+    }
+    std::ranges::stable_sort( expected, [&]( const u32 a, const u32 b ) { return input[a] < input[b]; } );
+
+    const std::unique_ptr<JobSystem> jobs = JobSystem::create( 3 );
+    for ( JobSystem* const job_system : { static_cast<JobSystem*>( nullptr ), jobs.get() } ) {
+        SCOPED_TRACE( job_system ? "with jobs" : "without jobs" );
+
+        std::vector<u64> keys = input;
+        std::vector<u32> values( count );
+        for ( u32 i = 0; i < count; ++i ) {
+            values[i] = i;
+        }
+        std::vector<u64> key_scratch( count );
+        std::vector<u32> value_scratch( count );
+        radix_sort( keys, values, key_scratch, value_scratch, job_system );
+
+        ASSERT_EQ( values, expected );
+        for ( u32 i = 0; i < count; ++i ) {
+            ASSERT_EQ( keys[i], input[expected[i]] );
+        }
+    }
+}
+
+TEST( RadixSort, sorts_no_one_and_two_keys )
+{
+    expect_stable_sort( {} );
+    expect_stable_sort( { 42 } );
+    expect_stable_sort( { 7, 3 } );
+    expect_stable_sort( { 3, 7 } );
+    expect_stable_sort( { 5, 5 } );
+}
+
+TEST( RadixSort, sorts_fewer_keys_than_a_block )
+{
+    expect_stable_sort( make_keys( RADIX_MIN_BLOCK_SIZE - 1, ~u64{ 0 } ) );
+    expect_stable_sort( make_keys( 1000, 0xFFFF ) );
+}
+
+TEST( RadixSort, sorts_many_blocks )
+{
+    expect_stable_sort( make_keys( MANY_BLOCKS_COUNT, ~u64{ 0 } ) );
+    // Not a multiple of the block size, the last block is shorter
+    expect_stable_sort( make_keys( MANY_BLOCKS_COUNT + 123, 0xFFFF'FFFF ) );
+}
+
+TEST( RadixSort, keeps_equal_keys_in_order )
+{
+    // 16 distinct keys, spread over the lowest and the highest digit
+    expect_stable_sort( make_keys( MANY_BLOCKS_COUNT, 0x0300'0000'0000'0003 ) );
+    expect_stable_sort( std::vector<u64>( MANY_BLOCKS_COUNT, 0x1234 ) );
+}
+
+TEST( RadixSort, skips_digits_every_key_shares )
+{
+    // A digit that is the same non-zero value in every key is skipped like one that is zero everywhere
+    expect_stable_sort( make_keys( MANY_BLOCKS_COUNT, 0xFFFF, 0xAB00'0000'00CD'0000 ) );
+    expect_stable_sort( make_keys( 1000, 0xFF'0000, 0xAB00'0000'0000'00CD ) );
+}
+
+TEST( RadixSort, sorts_with_odd_and_even_pass_counts )
+{
+    // An odd number of passes leaves the keys in the scratch spans until the final copy. The masks vary 1, 2, 3, 5 and
+    // all 8 digits.
+    for ( const u64 mask : {
+              u64{ 0xFF00 },
+              u64{ 0xFF00'0000'0000'00FF },
+              u64{ 0x00FF'0000'FF00'000F },
+              u64{ 0x0F0F'000F'0000'0F0F },
+              ~u64{ 0 },
+          } ) {
+        expect_stable_sort( make_keys( MANY_BLOCKS_COUNT, mask ) );
+        expect_stable_sort( make_keys( 1000, mask ) );
+    }
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,110 @@
+#include "mksv/jobs/work_stealing_deque.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+TEST( WorkStealingDeque, pops_newest_and_steals_oldest )
+{
+    WorkStealingDeque<u32> deque{ 4 };
+    for ( u32 item = 0; item < 3; ++item ) {
+        deque.push( item );
+    }
+
+    EXPECT_EQ( deque.get_size(), 3 );
+    EXPECT_EQ( deque.pop(), 2u );
+    EXPECT_EQ( deque.steal(), 0u );
+    EXPECT_EQ( deque.pop(), 1u );
+    EXPECT_EQ( deque.pop(), std::nullopt );
+    EXPECT_EQ( deque.steal(), std::nullopt );
+    EXPECT_EQ( deque.get_size(), 0 );
+}
+
+TEST( WorkStealingDeque, grows_without_losing_items )
+{
+    WorkStealingDeque<u32> deque{ 2 };
+
+    // Offsets top from zero so that the copy into the grown buffer wraps
+    deque.push( 100 );
+    EXPECT_EQ( deque.steal(), 100u );
+
+    constexpr u32 count = 1000;
+    for ( u32 item = 0; item < count; ++item ) {
+        deque.push( item );
+    }
+
+    EXPECT_EQ( deque.get_size(), i64{ count } );
+    for ( u32 item = 0; item < count / 2; ++item ) {
+        EXPECT_EQ( deque.steal(), item );
+    }
+    for ( u32 item = count; item > count / 2; --item ) {
+        EXPECT_EQ( deque.pop(), item - 1 );
+    }
+    EXPECT_EQ( deque.pop(), std::nullopt );
+}
+
+// The owner pushes and pops while thieves steal, every item has to be taken exactly once
+TEST( WorkStealingDeque, concurrent_steals_take_every_item_once )
+{
+    constexpr u32 item_count = 100'000;
+    constexpr u32 thief_count = 3;
+
+    WorkStealingDeque<u32>              deque{ 16 };
+    std::unique_ptr<std::atomic<u32>[]> taken = std::make_unique<std::atomic<u32>[]>( item_count );
+    std::atomic<u32>                    taken_count{ 0 };
+    std::atomic<bool>                   done{ false };
+
+    const auto take = [&]( const u32 item ) {
+        taken[item].fetch_add( 1, std::memory_order_relaxed );
+        taken_count.fetch_add( 1, std::memory_order_relaxed );
+    };
+
+    std::vector<std::jthread> thieves;
+    for ( u32 thief = 0; thief < thief_count; ++thief ) {
+        thieves.emplace_back( [&] {
+            while ( !done.load( std::memory_order_acquire ) ) {
+                if ( const std::optional<u32> item = deque.steal() ) {
+                    take( *item );
+                }
+            }
+        } );
+    }
+
+    for ( u32 item = 0; item < item_count; ++item ) {
+        deque.push( item );
+        if ( item % 3 == 0 ) {
+            if ( const std::optional<u32> popped = deque.pop() ) {
+                take( *popped );
+            }
+        }
+    }
+    while ( const std::optional<u32> popped = deque.pop() ) {
+        take( *popped );
+    }
+
+    // Items a thief read before the owner's last pop may still be in flight, a lost item fails the test below
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+    while ( taken_count.load() < item_count && std::chrono::steady_clock::now() < deadline ) {
+        std::this_thread::yield();
+    }
+    done.store( true, std::memory_order_release );
+    thieves.clear();
+
+    EXPECT_EQ( taken_count.load(), item_count );
+    for ( u32 item = 0; item < item_count; ++item ) {
+        ASSERT_EQ( taken[item].load(), 1u ) << "item " << item;
+    }
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,94 @@
+#include "mksv/latency_histogram.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+namespace mksv
+{
+namespace
+{
+TEST( LatencyHistogram, is_empty_at_first )
+{
+    const LatencyHistogram histogram;
+    EXPECT_EQ( histogram.get_count(), 0u );
+    EXPECT_EQ( histogram.get_percentile( 50.0 ), 0u );
+    EXPECT_EQ( histogram.get_mean(), 0.0 );
+}
+
+TEST( LatencyHistogram, small_values_are_exact )
+{
+    LatencyHistogram histogram;
+    for ( u32 value = 0; value < LatencyHistogram::SUB_BUCKET_COUNT; ++value ) {
+        histogram.add( value );
+    }
+
+    EXPECT_EQ( histogram.get_count(), LatencyHistogram::SUB_BUCKET_COUNT );
+    EXPECT_EQ( histogram.get_percentile( 0.0 ), 0u );
+    EXPECT_EQ( histogram.get_percentile( 50.0 ), 31u );
+    EXPECT_EQ( histogram.get_percentile( 100.0 ), 63u );
+    EXPECT_DOUBLE_EQ( histogram.get_mean(), 31.5 );
+}
+
+TEST( LatencyHistogram, percentiles_are_within_a_bucket )
+{
+    // A bucket spans at most 1/32 of its values, the percentile is the highest value of the bucket
+    for ( u32 value = 1; value <= LatencyHistogram::MAX_VALUE; value = value * 3 / 2 + 1 ) {
+        LatencyHistogram histogram;
+        histogram.add( value );
+
+        const u32 percentile = histogram.get_percentile( 99.0 );
+        EXPECT_GE( percentile, value );
+        EXPECT_LE( percentile, value + value / 32 ) << "value " << value;
+    }
+}
+
+TEST( LatencyHistogram, percentiles_of_a_uniform_range )
+{
+    LatencyHistogram histogram;
+    for ( u32 value = 1; value <= 1000; ++value ) {
+        histogram.add( value * 100 );
+    }
+
+    const auto expect_near = [&]( const f64 percentile, const u32 expected ) {
+        const u32 actual = histogram.get_percentile( percentile );
+        EXPECT_GE( actual, expected ) << "p" << percentile;
+        EXPECT_LE( actual, expected + expected / 32 ) << "p" << percentile;
+    };
+    expect_near( 50.0, 50'000 );
+    expect_near( 95.0, 95'000 );
+    expect_near( 99.0, 99'000 );
+    expect_near( 100.0, 100'000 );
+    EXPECT_DOUBLE_EQ( histogram.get_mean(), 50'050.0 );
+}
+
+TEST( LatencyHistogram, remove_undoes_add )
+{
+    LatencyHistogram histogram;
+    histogram.add( 1000 );
+    histogram.add( 2000 );
+    histogram.add( 90'000 );
+    EXPECT_GE( histogram.get_percentile( 100.0 ), 90'000u );
+
+    histogram.remove( 90'000 );
+    EXPECT_EQ( histogram.get_count(), 2u );
+    EXPECT_DOUBLE_EQ( histogram.get_mean(), 1500.0 );
+    EXPECT_LT( histogram.get_percentile( 100.0 ), 90'000u );
+
+    histogram.clear();
+    EXPECT_EQ( histogram.get_count(), 0u );
+    EXPECT_EQ( histogram.get_percentile( 100.0 ), 0u );
+}
+
+TEST( LatencyHistogram, clamps_large_values )
+{
+    LatencyHistogram histogram;
+    histogram.add( ~0u );
+    EXPECT_EQ( histogram.get_percentile( 50.0 ), LatencyHistogram::MAX_VALUE );
+    EXPECT_DOUBLE_EQ( histogram.get_mean(), LatencyHistogram::MAX_VALUE );
+
+    histogram.remove( ~0u );
+    EXPECT_EQ( histogram.get_count(), 0u );
+}
+} // namespace
+} // namespace mksv
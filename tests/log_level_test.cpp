@@ -0,0 +1,67 @@
+#include "mksv/log.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/logger.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Built with MKSV_LOG_MIN_LEVEL 2, see CMakeLists.txt
+static_assert( MKSV_LOG_MIN_LEVEL == 2 );
+
+namespace mksv
+{
+namespace
+{
+class CaptureLogSink final : public LogSink
+{
+public:
+    explicit CaptureLogSink( std::vector<std::wstring>& lines )
+        : lines_{ lines }
+    {
+    }
+
+    auto write( [[maybe_unused]] const LogLevel level, const std::wstring& line ) -> void override
+    {
+        lines_.push_back( line );
+    }
+
+    auto flush() -> void override
+    {
+    }
+
+private:
+    std::vector<std::wstring>& lines_;
+};
+
+TEST( LogLevel, calls_below_the_minimum_level_record_nothing )
+{
+    // Only touched by the logger's thread until flush() returns
+    std::vector<std::wstring> lines;
+    {
+        std::vector<std::unique_ptr<LogSink>> sinks;
+        sinks.push_back( std::make_unique<CaptureLogSink>( lines ) );
+        const std::unique_ptr<Logger> logger = Logger::create( std::move( sinks ) );
+        ASSERT_NE( logger, nullptr );
+
+        // The arguments are still evaluated. The argument types are ones the library never logs, which keeps its
+        // instantiations of the log functions, built without stripping, out of this test.
+        i16 evaluated = 0;
+        log_info( L"{}", ++evaluated );
+        log_warning( L"{} {}", ++evaluated, i8{ 1 } );
+        log_error( L"{} {}", ++evaluated, i8{ 2 } );
+        logger->flush();
+
+        EXPECT_EQ( evaluated, 3 );
+        EXPECT_EQ( logger->get_dropped_count(), 0u );
+    }
+
+    ASSERT_EQ( lines.size(), 1u );
+    EXPECT_TRUE( lines[0].starts_with( L"[Error]: 3 2 (" ) );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,296 @@
+#include "mksv/logger.hpp"
+
+#include "mksv/common/types.hpp"
+#include "mksv/log.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+using namespace std::chrono_literals;
+
+// What the sink below received, shared with the test since the logger owns the sink
+struct Capture {
+    std::mutex                mutex;
+    std::vector<std::wstring> lines;
+    u32                       flush_count = 0;
+
+    // Nothing is written before this point in time, which holds the records back in the rings
+    std::chrono::steady_clock::time_point opens_at;
+
+    auto get_lines() -> std::vector<std::wstring>
+    {
+        const std::lock_guard lock{ mutex };
+        return lines;
+    }
+};
+
+class CaptureLogSink final : public LogSink
+{
+public:
+    explicit CaptureLogSink( std::shared_ptr<Capture> capture )
+        : capture_{ std::move( capture ) }
+    {
+    }
+
+    auto write( [[maybe_unused]] const LogLevel level, const std::wstring& line ) -> void override
+    {
+        std::this_thread::sleep_until( capture_->opens_at );
+
+        const std::lock_guard lock{ capture_->mutex };
+        capture_->lines.push_back( line );
+    }
+
+    auto flush() -> void override
+    {
+        const std::lock_guard lock{ capture_->mutex };
+        ++capture_->flush_count;
+    }
+
+private:
+    std::shared_ptr<Capture> capture_;
+};
+
+auto create_logger( const std::shared_ptr<Capture>& capture ) -> std::unique_ptr<Logger>
+{
+    std::vector<std::unique_ptr<LogSink>> sinks;
+    sinks.push_back( std::make_unique<CaptureLogSink>( capture ) );
+    return Logger::create( std::move( sinks ) );
+}
+
+// The start of the line of an info record formatted from L"{} {}"
+auto get_prefix( const u32 index, const std::wstring_view text ) -> std::wstring
+{
+    return std::format( L"[{}]: {} {} (", log_level_str( LogLevel::Info ), index, text );
+}
+
+constexpr u32 HEADER_SIZE = detail::align_log_size( sizeof( detail::LogRecordHeader ) );
+
+// Size in the ring of log_info( L"{} {}", index, text )
+auto get_record_size( const std::wstring_view text ) -> u32
+{
+    return HEADER_SIZE + detail::LogArgument<u32>::get_size( 0 ) +
+           detail::LogArgument<std::wstring_view>::get_size( text );
+}
+
+// Text whose record takes exactly size bytes, records grow in steps of LOG_RECORD_ALIGNMENT
+auto make_text( const u32 size, const u32 index ) -> std::wstring
+{
+    std::wstring text;
+    while ( get_record_size( text ) < size ) {
+        text.push_back( static_cast<wchar_t>( L'a' + index % 26 ) );
+    }
+    EXPECT_EQ( get_record_size( text ), size );
+    return text;
+}
+
+TEST( Logger, only_one_exists_at_a_time )
+{
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    const std::unique_ptr<Logger>  logger = create_logger( capture );
+    ASSERT_NE( logger, nullptr );
+    EXPECT_EQ( create_logger( capture ), nullptr );
+}
+
+TEST( Logger, flush_writes_every_record_before_it )
+{
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    const std::unique_ptr<Logger>  logger = create_logger( capture );
+    ASSERT_NE( logger, nullptr );
+
+    for ( u32 i = 0; i < 100; ++i ) {
+        log_info( L"{} {}", i, std::wstring_view{ L"flushed" } );
+    }
+    log_warning( L"{}", 1.5 );
+    log_error( L"runtime message" );
+    logger->flush();
+
+    const std::vector<std::wstring> lines = capture->get_lines();
+    ASSERT_EQ( lines.size(), 102u );
+    for ( u32 i = 0; i < 100; ++i ) {
+        EXPECT_TRUE( lines[i].starts_with( get_prefix( i, L"flushed" ) ) ) << i;
+        EXPECT_TRUE( lines[i].ends_with( L")\n" ) );
+    }
+    EXPECT_TRUE( lines[100].starts_with( L"[Warning]: 1.5 (" ) );
+    EXPECT_TRUE( lines[101].starts_with( L"[Error]: runtime message (" ) );
+    EXPECT_NE( lines[101].find( L"logger_test.cpp:" ), std::wstring::npos );
+
+    const std::lock_guard lock{ capture->mutex };
+    EXPECT_GT( capture->flush_count, 0u );
+}
+
+TEST( Logger, wraps_around_with_records_of_mixed_sizes )
+{
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    const std::unique_ptr<Logger>  logger = create_logger( capture );
+    ASSERT_NE( logger, nullptr );
+
+    // A new logger gives the thread a new ring, which starts at offset 0. Every lap fills the ring up to a gap before
+    // its end and then logs a record that does not fit the gap: without a gap, with a gap a padding record marks, and
+    // with gaps too small for a full header, which the logger's thread skips on its own.
+    std::vector<std::wstring> texts;
+    u64                       position = 0;
+    for ( const u32 gap : { 0u, HEADER_SIZE + 8, HEADER_SIZE - 8, u32{ detail::LOG_RECORD_ALIGNMENT }, 0u } ) {
+        const u64 end = ( position / Logger::RING_CAPACITY + 1 ) * Logger::RING_CAPACITY - gap;
+        while ( position < end ) {
+            // Large and small records, leaving either nothing or room for at least a small one
+            const u64 left = end - position;
+            const u32 size = left <= 2000 ? static_cast<u32>( left ) : 400 + static_cast<u32>( texts.size() % 7 ) * 88;
+            texts.push_back( make_text( size, static_cast<u32>( texts.size() ) ) );
+            log_info( L"{} {}", static_cast<u32>( texts.size() - 1 ), texts.back() );
+            position += size;
+        }
+
+        const u32 size = gap + HEADER_SIZE + 16;
+        texts.push_back( make_text( size, static_cast<u32>( texts.size() ) ) );
+        log_info( L"{} {}", static_cast<u32>( texts.size() - 1 ), texts.back() );
+        position = end + gap + size;
+    }
+    logger->flush();
+
+    const std::vector<std::wstring> lines = capture->get_lines();
+    ASSERT_EQ( lines.size(), texts.size() );
+    for ( u32 i = 0; i < texts.size(); ++i ) {
+        ASSERT_TRUE( lines[i].starts_with( get_prefix( i, texts[i] ) ) ) << i;
+    }
+    EXPECT_EQ( logger->get_dropped_count(), 0u );
+}
+
+TEST( Logger, waits_instead_of_dropping_when_a_ring_fills )
+{
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    capture->opens_at = std::chrono::steady_clock::now() + 50ms;
+    const std::unique_ptr<Logger> logger = create_logger( capture );
+    ASSERT_NE( logger, nullptr );
+
+    // Three rings worth of records cannot all be in flight before the sink takes any
+    const std::wstring text = make_text( 256, 0 );
+    const u32          count = Logger::RING_CAPACITY / 256 * 3;
+    for ( u32 i = 0; i < count; ++i ) {
+        log_info( L"{} {}", i, text );
+    }
+    EXPECT_GE( std::chrono::steady_clock::now(), capture->opens_at );
+    logger->flush();
+
+    const std::vector<std::wstring> lines = capture->get_lines();
+    ASSERT_EQ( lines.size(), count );
+    for ( u32 i = 0; i < count; ++i ) {
+        ASSERT_TRUE( lines[i].starts_with( get_prefix( i, text ) ) ) << i;
+    }
+    EXPECT_EQ( logger->get_dropped_count(), 0u );
+}
+
+TEST( Logger, drops_records_larger_than_half_a_ring )
+{
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    const std::unique_ptr<Logger>  logger = create_logger( capture );
+    ASSERT_NE( logger, nullptr );
+
+    // Every string is cut off at the maximum length, many of them still make a record too large
+    const std::wstring text( detail::LOG_MAX_STRING_LENGTH, L'x' );
+    const std::wstring t = text;
+    log_info( L"{}{}{}{}{}{}{}{}{}{}", t, t, t, t, t, t, t, t, t, t );
+    log_info( L"{} {}", 0u, std::wstring_view{ L"kept" } );
+    logger->flush();
+
+    EXPECT_EQ( logger->get_dropped_count(), 1u );
+    const std::vector<std::wstring> lines = capture->get_lines();
+    ASSERT_EQ( lines.size(), 1u );
+    EXPECT_TRUE( lines[0].starts_with( get_prefix( 0, L"kept" ) ) );
+}
+
+TEST( Logger, keeps_the_order_of_every_thread )
+{
+    constexpr u32 thread_count = 4;
+    constexpr u32 record_count = 20'000;
+
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    const std::unique_ptr<Logger>  logger = create_logger( capture );
+    ASSERT_NE( logger, nullptr );
+
+    {
+        std::vector<std::jthread> threads;
+        for ( u32 thread = 0; thread < thread_count; ++thread ) {
+            threads.emplace_back( [thread] {
+                for ( u32 i = 0; i < record_count; ++i ) {
+                    log_info( L"{} {}", thread, i );
+                }
+            } );
+        }
+    }
+    logger->flush();
+
+    const std::vector<std::wstring> lines = capture->get_lines();
+    ASSERT_EQ( lines.size(), thread_count * record_count );
+
+    std::vector<u32> next( thread_count, 0 );
+    for ( const std::wstring& line : lines ) {
+        const std::wstring_view message = std::wstring_view{ line }.substr( line.find( L' ' ) + 1 );
+        const u32               thread = static_cast<u32>( message[0] - L'0' );
+        ASSERT_LT( thread, thread_count );
+        ASSERT_EQ( std::stoul( std::wstring{ message.substr( 2 ) } ), next[thread] ) << "thread " << thread;
+        ++next[thread];
+    }
+    EXPECT_EQ( logger->get_dropped_count(), 0u );
+}
+
+TEST( Logger, cuts_strings_off_at_the_maximum_length )
+{
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    const std::unique_ptr<Logger>  logger = create_logger( capture );
+    ASSERT_NE( logger, nullptr );
+
+    const std::wstring longest( detail::LOG_MAX_STRING_LENGTH, L'a' );
+    const std::wstring too_long = longest + L"bcd";
+    log_info( L"{} {}", 0u, longest );
+    log_info( L"{} {}", 1u, too_long );
+    log_info( L"{} {}", 2u, std::wstring_view{ too_long.data(), detail::LOG_MAX_STRING_LENGTH + 1 } );
+    logger->flush();
+
+    const std::vector<std::wstring> lines = capture->get_lines();
+    ASSERT_EQ( lines.size(), 3u );
+    for ( u32 i = 0; i < lines.size(); ++i ) {
+        EXPECT_TRUE( lines[i].starts_with( get_prefix( i, longest ) ) ) << i;
+        EXPECT_EQ( lines[i].find( L'b' ), std::wstring::npos ) << i;
+    }
+}
+
+TEST( Logger, writes_out_on_the_calling_thread_without_a_logger )
+{
+    testing::internal::CaptureStderr();
+    log_info( L"{} {}", 1u, std::wstring_view{ L"before" } );
+    const std::string before = testing::internal::GetCapturedStderr();
+    EXPECT_TRUE( before.starts_with( "[Info]: 1 before (" ) ) << before;
+    EXPECT_TRUE( before.ends_with( ")\n" ) ) << before;
+
+    const std::shared_ptr<Capture> capture = std::make_shared<Capture>();
+    {
+        const std::unique_ptr<Logger> logger = create_logger( capture );
+        ASSERT_NE( logger, nullptr );
+        log_info( L"{} {}", 2u, std::wstring_view{ L"during" } );
+    }
+
+    // The logger wrote out its records when it went away, later ones go to stderr again
+    testing::internal::CaptureStderr();
+    log_warning( L"{} {}", 3u, std::wstring_view{ L"after" } );
+    const std::string after = testing::internal::GetCapturedStderr();
+    EXPECT_TRUE( after.starts_with( "[Warning]: 3 after (" ) ) << after;
+
+    const std::vector<std::wstring> lines = capture->get_lines();
+    ASSERT_EQ( lines.size(), 1u );
+    EXPECT_TRUE( lines[0].starts_with( get_prefix( 2, L"during" ) ) );
+}
+} // namespace
+} // namespace mksv
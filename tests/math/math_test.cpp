@@ -0,0 +1,240 @@
+#include "mksv/common/types.hpp"
+#include "mksv/math/batch.hpp"
+#include "mksv/math/consts.hpp"
+#include "mksv/math/mat.hpp"
+#include "mksv/math/quat.hpp"
+#include "mksv/math/types.hpp"
+#include "mksv/math/vec.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#if __has_include( <DirectXMath.h> )
+#include <DirectXMath.h>
+#define MKSV_HAS_DIRECTXMATH 1
+#endif
+
+namespace mksv
+{
+namespace
+{
+constexpr f32 TOLERANCE = 1e-5f;
+
+auto random_matrix( std::mt19937& rng ) -> mat4
+{
+    std::uniform_real_distribution<f32> value{ -2.0f, 2.0f };
+
+    mat4 m;
+    for ( vec4& row : m.r ) {
+        row = { value( rng ), value( rng ), value( rng ), value( rng ) };
+    }
+    return m;
+}
+
+auto random_trs( std::mt19937& rng ) -> mat4
+{
+    std::uniform_real_distribution<f32> value{ -2.0f, 2.0f };
+    std::uniform_real_distribution<f32> scale{ 0.5f, 2.0f };
+
+    const quat rotation = quat_from_axis_angle( { value( rng ), value( rng ), value( rng ) + 3.0f }, value( rng ) );
+    return trs( { value( rng ), value( rng ), value( rng ) }, rotation, { scale( rng ), scale( rng ), scale( rng ) } );
+}
+
+// Plain row vector times row major matrix, the reference for the SIMD paths
+auto reference_transform( const vec4& v, const mat4& m ) -> vec4
+{
+    return {
+        v.x * m.r[0].x + v.y * m.r[1].x + v.z * m.r[2].x + v.w * m.r[3].x,
+        v.x * m.r[0].y + v.y * m.r[1].y + v.z * m.r[2].y + v.w * m.r[3].y,
+        v.x * m.r[0].z + v.y * m.r[1].z + v.z * m.r[2].z + v.w * m.r[3].z,
+        v.x * m.r[0].w + v.y * m.r[1].w + v.z * m.r[2].w + v.w * m.r[3].w,
+    };
+}
+
+auto reference_mul( const mat4& a, const mat4& b ) -> mat4
+{
+    return { { reference_transform( a.r[0], b ),
+               reference_transform( a.r[1], b ),
+               reference_transform( a.r[2], b ),
+               reference_transform( a.r[3], b ) } };
+}
+
+auto expect_near( const vec4& actual, const vec4& expected, const f32 tolerance = TOLERANCE ) -> void
+{
+    EXPECT_NEAR( actual.x, expected.x, tolerance );
+    EXPECT_NEAR( actual.y, expected.y, tolerance );
+    EXPECT_NEAR( actual.z, expected.z, tolerance );
+    EXPECT_NEAR( actual.w, expected.w, tolerance );
+}
+
+auto expect_near( const mat4& actual, const mat4& expected, const f32 tolerance = TOLERANCE ) -> void
+{
+    for ( u32 row = 0; row < 4; ++row ) {
+        SCOPED_TRACE( row );
+        expect_near( actual.r[row], expected.r[row], tolerance );
+    }
+}
+
+TEST( Math, transform_matches_the_scalar_reference )
+{
+    std::mt19937 rng{ 1 };
+    for ( u32 i = 0; i < 100; ++i ) {
+        const mat4 m = random_matrix( rng );
+        const vec4 v = random_matrix( rng ).r[0];
+        expect_near( transform( v, m ), reference_transform( v, m ) );
+    }
+}
+
+TEST( Math, multiply_matches_the_scalar_reference )
+{
+    std::mt19937 rng{ 2 };
+    for ( u32 i = 0; i < 100; ++i ) {
+        const mat4 a = random_matrix( rng );
+        const mat4 b = random_matrix( rng );
+        expect_near( a * b, reference_mul( a, b ) );
+    }
+}
+
+TEST( Math, inverse_affine_undoes_trs )
+{
+    std::mt19937 rng{ 3 };
+    for ( u32 i = 0; i < 100; ++i ) {
+        const mat4 m = random_trs( rng );
+        expect_near( m * inverse_affine( m ), mat4_identity(), 1e-4f );
+    }
+}
+
+TEST( Math, quaternion_matches_rotation_axis )
+{
+    const vec3 axis = { 1.0f, -2.0f, 0.5f };
+    for ( const f32 angle : { -PI, -1.0f, 0.0f, 0.3f, PI * 0.5f, 2.5f } ) {
+        SCOPED_TRACE( angle );
+        expect_near( to_mat4( quat_from_axis_angle( axis, angle ) ), rotation_axis( axis, angle ) );
+    }
+}
+
+TEST( Math, quaternion_product_matches_matrix_order )
+{
+    const quat a = quat_from_axis_angle( { 0.0f, 1.0f, 0.0f }, 0.7f );
+    const quat b = quat_from_axis_angle( { 1.0f, 0.0f, 1.0f }, -1.3f );
+    expect_near( to_mat4( a * b ), to_mat4( a ) * to_mat4( b ) );
+
+    const vec3 v = { 0.3f, -1.0f, 2.0f };
+    const vec3 rotated = rotate( v, a * b );
+    expect_near( to_vec4( rotated, 1.0f ), transform( to_vec4( v, 1.0f ), to_mat4( a * b ) ) );
+}
+
+TEST( Math, batches_match_single_operations )
+{
+    constexpr usize count = 37;
+
+    std::mt19937      rng{ 4 };
+    const mat4        rhs = random_matrix( rng );
+    std::vector<mat4> lhs( count );
+    for ( mat4& m : lhs ) {
+        m = random_matrix( rng );
+    }
+
+    std::vector<mat4> out( count );
+    mul_batch( lhs, rhs, out );
+    for ( usize i = 0; i < count; ++i ) {
+        SCOPED_TRACE( i );
+        expect_near( out[i], lhs[i] * rhs );
+    }
+
+    // The SoA variant, elements[row * 4 + column][index]
+    std::array<std::vector<f32>, 16> lhs_elements;
+    std::array<std::vector<f32>, 16> out_elements;
+    Mat4SoA                          lhs_soa{};
+    Mat4SoA                          out_soa{};
+    ConstMat4SoA                     const_lhs_soa{};
+    ConstMat4SoA                     const_out_soa{};
+    for ( usize element = 0; element < 16; ++element ) {
+        lhs_elements[element].resize( count );
+        out_elements[element].resize( count );
+        lhs_soa.elements[element] = lhs_elements[element].data();
+        out_soa.elements[element] = out_elements[element].data();
+        const_lhs_soa.elements[element] = lhs_elements[element].data();
+        const_out_soa.elements[element] = out_elements[element].data();
+    }
+    to_soa( lhs, lhs_soa );
+    mul_batch( const_lhs_soa, rhs, out_soa, count );
+
+    std::vector<mat4> soa_out( count );
+    from_soa( const_out_soa, soa_out );
+    for ( usize i = 0; i < count; ++i ) {
+        SCOPED_TRACE( i );
+        expect_near( soa_out[i], lhs[i] * rhs );
+    }
+
+    std::array<std::vector<f32>, 3> points;
+    std::array<std::vector<f32>, 4> transformed;
+    for ( std::vector<f32>& stream : points ) {
+        stream.resize( count );
+        for ( f32& value : stream ) {
+            value = std::uniform_real_distribution<f32>{ -10.0f, 10.0f }( rng );
+        }
+    }
+    for ( std::vector<f32>& stream : transformed ) {
+        stream.resize( count );
+    }
+    transform_points_batch(
+        { points[0].data(), points[1].data(), points[2].data() },
+        rhs,
+        { transformed[0].data(), transformed[1].data(), transformed[2].data(), transformed[3].data() },
+        count
+    );
+    for ( usize i = 0; i < count; ++i ) {
+        SCOPED_TRACE( i );
+        const vec4 expected = transform( { points[0][i], points[1][i], points[2][i], 1.0f }, rhs );
+        expect_near( { transformed[0][i], transformed[1][i], transformed[2][i], transformed[3][i] }, expected, 1e-4f );
+    }
+}
+
+#if defined( MKSV_HAS_DIRECTXMATH )
+auto from_xm( const DirectX::XMMATRIX& xm ) -> mat4
+{
+    DirectX::XMFLOAT4X4 stored;
+    DirectX::XMStoreFloat4x4( &stored, xm );
+
+    mat4 m;
+    for ( u32 row = 0; row < 4; ++row ) {
+        m.r[row] = { stored.m[row][0], stored.m[row][1], stored.m[row][2], stored.m[row][3] };
+    }
+    return m;
+}
+
+// The engine used these from DirectXMath before, the replacements have to give the same matrices
+TEST( Math, matches_directxmath )
+{
+    using namespace DirectX;
+
+    const vec3 axis = { 0.2f, 1.0f, -0.4f };
+    expect_near(
+        rotation_axis( axis, 0.8f ),
+        from_xm( XMMatrixRotationAxis( XMVectorSet( axis.x, axis.y, axis.z, 0.0f ), 0.8f ) )
+    );
+
+    const vec3 eye = { 0.0f, 2.0f, -5.0f };
+    const vec3 focus = { 0.5f, 0.0f, 1.0f };
+    const vec3 up = { 0.0f, 1.0f, 0.0f };
+    expect_near(
+        look_at_lh( eye, focus, up ),
+        from_xm( XMMatrixLookAtLH(
+            XMVectorSet( eye.x, eye.y, eye.z, 1.0f ),
+            XMVectorSet( focus.x, focus.y, focus.z, 1.0f ),
+            XMVectorSet( up.x, up.y, up.z, 0.0f )
+        ) )
+    );
+
+    expect_near(
+        perspective_fov_lh( to_radians( 60.0f ), 16.0f / 9.0f, 0.1f, 100.0f ),
+        from_xm( XMMatrixPerspectiveFovLH( to_radians( 60.0f ), 16.0f / 9.0f, 0.1f, 100.0f ) )
+    );
+}
+#endif
+} // namespace
+} // namespace mksv
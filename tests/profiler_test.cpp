@@ -0,0 +1,96 @@
+#include "mksv/profiler.hpp"
+
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+namespace mksv
+{
+namespace
+{
+auto read_file( const std::filesystem::path& path ) -> std::string
+{
+    std::ifstream file{ path };
+    return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+TEST( Profiler, only_one_exists_at_a_time )
+{
+    const std::unique_ptr<Profiler> profiler = Profiler::create();
+    ASSERT_NE( profiler, nullptr );
+    EXPECT_EQ( Profiler::create(), nullptr );
+}
+
+TEST( Profiler, records_zones_only_while_capturing )
+{
+    const std::unique_ptr<Profiler> profiler = Profiler::create();
+    ASSERT_NE( profiler, nullptr );
+
+    {
+        MKSV_PROFILE_ZONE( "before" );
+    }
+
+    profiler->begin_capture();
+    {
+        MKSV_PROFILE_ZONE( "outer" );
+        {
+            MKSV_PROFILE_ZONE( "inner" );
+        }
+        MKSV_PROFILE_COUNTER( "counter", 42 );
+    }
+    profiler->end_capture();
+
+    {
+        MKSV_PROFILE_ZONE( "after" );
+    }
+
+    EXPECT_EQ( profiler->get_event_count(), 3u );
+    EXPECT_EQ( profiler->get_dropped_count(), 0u );
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "mksv_profiler_test.json";
+    ASSERT_TRUE( profiler->write_chrome_trace( path ) );
+    const std::string trace = read_file( path );
+    std::filesystem::remove( path );
+
+    EXPECT_NE( trace.find( "\"outer\"" ), std::string::npos );
+    EXPECT_NE( trace.find( "\"inner\"" ), std::string::npos );
+    EXPECT_NE( trace.find( "\"counter\"" ), std::string::npos );
+    EXPECT_EQ( trace.find( "\"before\"" ), std::string::npos );
+    EXPECT_EQ( trace.find( "\"after\"" ), std::string::npos );
+}
+
+TEST( Profiler, counts_the_events_past_the_buffers )
+{
+    const std::unique_ptr<Profiler> profiler = Profiler::create();
+    ASSERT_NE( profiler, nullptr );
+
+    constexpr u32 capacity = Profiler::MAX_BLOCKS * Profiler::BLOCK_SIZE;
+    constexpr u32 overflow = 10;
+
+    profiler->begin_capture();
+    for ( u32 i = 0; i < capacity + overflow; ++i ) {
+        MKSV_PROFILE_ZONE( "zone" );
+    }
+    profiler->end_capture();
+
+    EXPECT_EQ( profiler->get_event_count(), capacity );
+    EXPECT_EQ( profiler->get_dropped_count(), overflow );
+
+    // The next capture starts with empty buffers
+    profiler->begin_capture();
+    {
+        MKSV_PROFILE_ZONE( "zone" );
+    }
+    profiler->end_capture();
+
+    EXPECT_EQ( profiler->get_event_count(), 1u );
+    EXPECT_EQ( profiler->get_dropped_count(), 0u );
+}
+} // namespace
+} // namespace mksv
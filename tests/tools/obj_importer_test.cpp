@@ -0,0 +1,89 @@
+#include "obj_importer.hpp"
+
+#include "mksv/assets/mesh_data.hpp"
+#include "mksv/common/types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace mksv
+{
+namespace
+{
+auto get_vertex( const MeshData& mesh, const u32 index ) -> std::vector<f32>
+{
+    std::vector<f32> vertex( 6 );
+    std::memcpy( vertex.data(), mesh.vertices.data() + index * 6 * sizeof( f32 ), 6 * sizeof( f32 ) );
+    return vertex;
+}
+
+TEST( ObjImporter, reads_positions_colors_and_faces )
+{
+    const std::optional<MeshData> mesh = import_obj(
+        "# quad\n"
+        "v 0 0 0 1 0 0\n"
+        "v 1 0 0 0 1 0\n"
+        "v 1 1 0\n"
+        "v 0 1 0\n"
+        "f 1 2 3 4\n"
+    );
+    ASSERT_TRUE( mesh );
+
+    EXPECT_EQ( mesh->indices, ( std::vector<u32>{ 0, 1, 2, 0, 2, 3 } ) );
+    ASSERT_EQ( mesh->vertices.size(), 4 * 6 * sizeof( f32 ) );
+    EXPECT_EQ( get_vertex( *mesh, 0 ), ( std::vector<f32>{ 0, 0, 0, 1, 0, 0 } ) );
+    EXPECT_EQ( get_vertex( *mesh, 1 ), ( std::vector<f32>{ 1, 0, 0, 0, 1, 0 } ) );
+    EXPECT_EQ( get_vertex( *mesh, 2 ), ( std::vector<f32>{ 1, 1, 0, 1, 1, 1 } ) );
+    ASSERT_EQ( mesh->submeshes.size(), 1u );
+    EXPECT_EQ( mesh->submeshes[0].index_count, 6u );
+}
+
+TEST( ObjImporter, ignores_weights_and_alpha )
+{
+    const std::optional<MeshData> mesh = import_obj(
+        "v 0 0 0 1\n"
+        "v 1 0 0 0.5\n"
+        "v 1 1 0 0.25 0.5 0.75 1\n"
+        "f 1 2 3\n"
+    );
+    ASSERT_TRUE( mesh );
+
+    EXPECT_EQ( get_vertex( *mesh, 0 ), ( std::vector<f32>{ 0, 0, 0, 1, 1, 1 } ) );
+    EXPECT_EQ( get_vertex( *mesh, 1 ), ( std::vector<f32>{ 1, 0, 0, 1, 1, 1 } ) );
+    EXPECT_EQ( get_vertex( *mesh, 2 ), ( std::vector<f32>{ 1, 1, 0, 0.25f, 0.5f, 0.75f } ) );
+}
+
+TEST( ObjImporter, rejects_malformed_vertices )
+{
+    EXPECT_FALSE( import_obj( "v 0 0\n" ) );
+    EXPECT_FALSE( import_obj( "v 0 0 0 1 0\n" ) );
+    EXPECT_FALSE( import_obj( "v 0 0 0 1 0 0 1 0\n" ) );
+    EXPECT_FALSE( import_obj( "v 0 0 x\n" ) );
+    EXPECT_FALSE( import_obj( "v 0 0 0\nv 1 0 0\nf 1 2 3\n" ) );
+}
+
+TEST( ObjImporter, groups_start_submeshes )
+{
+    const std::optional<MeshData> mesh = import_obj(
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 1 1 0\n"
+        "v 0 1 0\n"
+        "g first\n"
+        "f 1 2 3\n"
+        "g second\n"
+        "usemtl stone\n"
+        "f -4 -2 -1\n"
+    );
+    ASSERT_TRUE( mesh );
+
+    ASSERT_EQ( mesh->submeshes.size(), 2u );
+    EXPECT_EQ( mesh->submeshes[1].first_index, 3u );
+    EXPECT_EQ( mesh->submeshes[1].index_count, 3u );
+    EXPECT_EQ( mesh->indices, ( std::vector<u32>{ 0, 1, 2, 0, 2, 3 } ) );
+}
+} // namespace
+} // namespace mksv
@@ -0,0 +1,210 @@
+#include "obj_importer.hpp"
+
+#include <mksv/assets/gltf_importer.hpp>
+#include <mksv/assets/mesh_data.hpp>
+#include <mksv/assets/mesh_optimizer.hpp>
+#include <mksv/assets/vertex_quantization.hpp>
+#include <mksv/common/types.hpp>
+#include <mksv/jobs/job_system.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+auto import_obj_file( const std::filesystem::path& path ) -> std::optional<mksv::MeshData>
+{
+    std::ifstream file{ path, std::ios::binary };
+    if ( !file ) {
+        return std::nullopt;
+    }
+
+    const std::string text{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    return import_obj( text );
+}
+
+auto import_gltf_file( const std::filesystem::path& path ) -> std::optional<mksv::MeshData>
+{
+    const auto importer = mksv::GltfImporter::open( path );
+    const auto jobs = mksv::JobSystem::create();
+    if ( !importer || !jobs ) {
+        return std::nullopt;
+    }
+
+    mksv::MeshData mesh{};
+    mesh.vertex_format = mksv::MeshVertexFormat::PositionColor;
+    mesh.vertices.resize( u64{ importer->get_vertex_count() } * mksv::get_vertex_stride( mesh.vertex_format ) );
+    mesh.indices.resize( importer->get_index_count() );
+    mesh.submeshes.resize( importer->get_submesh_count() );
+
+    if ( !importer->decode( *jobs, mesh.vertices, mesh.indices, mesh.submeshes ) ) {
+        return std::nullopt;
+    }
+
+    constexpr f32 MAX = std::numeric_limits<f32>::max();
+    mesh.bounds = { .min = { MAX, MAX, MAX }, .max = { -MAX, -MAX, -MAX } };
+    for ( const mksv::MeshSubmesh& submesh : mesh.submeshes ) {
+        for ( u32 axis = 0; axis < 3; ++axis ) {
+            mesh.bounds.min[axis] = std::min( mesh.bounds.min[axis], submesh.bounds.min[axis] );
+            mesh.bounds.max[axis] = std::max( mesh.bounds.max[axis], submesh.bounds.max[axis] );
+        }
+    }
+
+    return mesh;
+}
+
+auto get_peak_memory() -> u64
+{
+#if defined( _WIN32 )
+    PROCESS_MEMORY_COUNTERS counters{};
+    if ( !K32GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if ( getrusage( RUSAGE_SELF, &usage ) != 0 ) {
+        return 0;
+    }
+    // Reported in KiB
+    return static_cast<u64>( usage.ru_maxrss ) * 1024;
+#endif
+}
+} // namespace
+
+// Cooks a Wavefront OBJ or a glTF 2.0 asset into the binary mesh format read by MeshFile. --quantize stores the
+// vertices as MeshVertexFormat::PositionColorQuantized.
+//
+// usage: mksv_mesh_cooker [--quantize] <input.obj|input.gltf|input.glb> <output.mesh>
+auto main( int argc, char** argv ) -> int
+{
+    const bool quantize = argc == 4 && std::string_view{ argv[1] } == "--quantize";
+    if ( argc != 3 && !quantize ) {
+        std::fprintf( stderr, "usage: mksv_mesh_cooker [--quantize] <input.obj|input.gltf|input.glb> <output.mesh>\n" );
+        return 1;
+    }
+
+    const char* const           input_arg = argv[argc - 2];
+    const char* const           output_arg = argv[argc - 1];
+    const std::filesystem::path input = input_arg;
+    const std::filesystem::path extension = input.extension();
+
+    std::error_code error;
+    const u64       input_size = std::filesystem::file_size( input, error );
+    if ( error ) {
+        std::fprintf( stderr, "Failed to read %s\n", input_arg );
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const bool is_gltf = extension == ".gltf" || extension == ".glb";
+    auto       mesh = is_gltf ? import_gltf_file( input ) : import_obj_file( input );
+    if ( !mesh ) {
+        std::fprintf( stderr, "Failed to import %s\n", input_arg );
+        return 1;
+    }
+
+    const auto                       optimize_start = std::chrono::steady_clock::now();
+    const std::chrono::duration<f64> import_time = optimize_start - start;
+
+    const u32  stride = mksv::get_vertex_stride( mesh->vertex_format );
+    const auto get_vertex_count = [&] { return static_cast<u32>( mesh->vertices.size() / stride ); };
+
+    const mksv::VertexCacheStats before = mksv::analyze_vertex_cache( mesh->indices, get_vertex_count() );
+    mksv::optimize_mesh( *mesh );
+    const mksv::VertexCacheStats after = mksv::analyze_vertex_cache( mesh->indices, get_vertex_count() );
+
+    const auto                                   quantize_start = std::chrono::steady_clock::now();
+    const std::chrono::duration<f64, std::milli> optimize_time = quantize_start - optimize_start;
+
+    const u32             vertex_count = get_vertex_count();
+    const std::vector<u8> float_vertices = quantize ? mesh->vertices : std::vector<u8>{};
+    if ( quantize && !mksv::quantize_mesh( *mesh, mksv::MeshVertexFormat::PositionColorQuantized ) ) {
+        std::fprintf( stderr, "Failed to quantize %s\n", input_arg );
+        return 1;
+    }
+
+    const std::chrono::duration<f64> quantize_time = std::chrono::steady_clock::now() - quantize_start;
+
+    if ( !mksv::write_mesh( output_arg, *mesh ) ) {
+        std::fprintf( stderr, "Failed to write %s\n", output_arg );
+        return 1;
+    }
+
+    const std::chrono::duration<f64, std::milli> time = std::chrono::steady_clock::now() - start;
+    std::printf(
+        "Cooked %s: %u vertices of %u bytes, %zu triangles, %zu submeshes, %u-bit indices in %.1f ms\n",
+        output_arg,
+        vertex_count,
+        mksv::get_vertex_stride( mesh->vertex_format ),
+        mesh->indices.size() / 3,
+        mesh->submeshes.size(),
+        mksv::get_mesh_index_size( *mesh ) * 8,
+        time.count()
+    );
+    std::printf(
+        "Optimized in %.1f ms: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+        optimize_time.count(),
+        before.acmr,
+        after.acmr,
+        before.atvr,
+        after.atvr
+    );
+
+    if ( quantize ) {
+        // Decoded the way the input assembler does, compared with the float positions
+        std::vector<u8> decoded( float_vertices.size() );
+        if ( !mksv::dequantize_vertices( mesh->vertex_format, mesh->bounds, mesh->vertices, decoded ) ) {
+            std::fprintf( stderr, "Failed to dequantize %s\n", output_arg );
+            return 1;
+        }
+
+        f32 max_error = 0.0f;
+        for ( usize i = 0; i < float_vertices.size(); i += sizeof( f32 ) ) {
+            f32 expected;
+            f32 actual;
+            std::memcpy( &expected, float_vertices.data() + i, sizeof( expected ) );
+            std::memcpy( &actual, decoded.data() + i, sizeof( actual ) );
+            max_error = std::max( max_error, std::abs( expected - actual ) );
+        }
+
+        std::printf(
+            "Quantized %.1f MiB in %.2f ms at %.1f MiB/s, largest position or color error %g\n",
+            static_cast<f64>( float_vertices.size() ) / ( 1024.0 * 1024.0 ),
+            quantize_time.count() * 1000.0,
+            static_cast<f64>( float_vertices.size() ) / ( 1024.0 * 1024.0 ) / std::max( quantize_time.count(), 1e-9 ),
+            max_error
+        );
+    }
+
+    // External glTF buffers are not counted in the input size
+    std::printf(
+        "Imported %.1f MiB at %.1f MiB/s, peak memory %.1f MiB\n",
+        static_cast<f64>( input_size ) / ( 1024.0 * 1024.0 ),
+        static_cast<f64>( input_size ) / ( 1024.0 * 1024.0 ) / std::max( import_time.count(), 1e-9 ),
+        static_cast<f64>( get_peak_memory() ) / ( 1024.0 * 1024.0 )
+    );
+
+    return 0;
+}
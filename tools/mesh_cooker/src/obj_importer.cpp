@@ -0,0 +1,161 @@
+#include "obj_importer.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace
+{
+struct ObjVertex {
+    f32 position[3];
+    f32 color[3];
+};
+
+static_assert( sizeof( ObjVertex ) == 6 * sizeof( f32 ) );
+
+constexpr u32 UNUSED = std::numeric_limits<u32>::max();
+
+auto is_space( const char c ) -> bool
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Splits off the next whitespace separated token of line
+auto next_token( std::string_view& line ) -> std::string_view
+{
+    usize start = 0;
+    while ( start < line.size() && is_space( line[start] ) ) {
+        ++start;
+    }
+
+    usize end = start;
+    while ( end < line.size() && !is_space( line[end] ) ) {
+        ++end;
+    }
+
+    const std::string_view token = line.substr( start, end - start );
+    line.remove_prefix( end );
+    return token;
+}
+
+template <typename T>
+auto parse_number( const std::string_view token, T& value ) -> bool
+{
+    const auto [end, error] = std::from_chars( token.data(), token.data() + token.size(), value );
+    return error == std::errc{} && end == token.data() + token.size();
+}
+
+// Position index of a face corner like "7", "7/2", "7//3" or "-1/2/3", zero based
+auto parse_corner( const std::string_view token, const usize position_count ) -> std::optional<u32>
+{
+    i64 index = 0;
+    if ( !parse_number( token.substr( 0, token.find( '/' ) ), index ) || index == 0 ) {
+        return std::nullopt;
+    }
+
+    const i64 resolved = index > 0 ? index - 1 : static_cast<i64>( position_count ) + index;
+    if ( resolved < 0 || resolved >= static_cast<i64>( position_count ) ) {
+        return std::nullopt;
+    }
+
+    return static_cast<u32>( resolved );
+}
+} // namespace
+
+auto import_obj( const std::string_view text ) -> std::optional<mksv::MeshData>
+{
+    mksv::MeshData mesh{};
+    mesh.vertex_format = mksv::MeshVertexFormat::PositionColor;
+
+    std::vector<ObjVertex> positions;
+    // Mesh vertex of every OBJ position, UNUSED until a face refers to it
+    std::vector<u32>       remap;
+    std::vector<u32>       polygon;
+
+    const auto close_submesh = [&mesh] {
+        const u32 first_index = mesh.submeshes.empty()
+                                    ? 0
+                                    : mesh.submeshes.back().first_index + mesh.submeshes.back().index_count;
+        const u32 index_count = static_cast<u32>( mesh.indices.size() ) - first_index;
+        if ( index_count > 0 ) {
+            // Vertex range and bounds are filled in once all faces are read
+            mesh.submeshes.push_back( {
+                .first_index = first_index,
+                .index_count = index_count,
+                .first_vertex = 0,
+                .vertex_count = 0,
+                .bounds = {},
+            } );
+        }
+    };
+
+    usize line_start = 0;
+    while ( line_start < text.size() ) {
+        usize line_end = text.find( '\n', line_start );
+        if ( line_end == std::string_view::npos ) {
+            line_end = text.size();
+        }
+
+        std::string_view       line = text.substr( line_start, line_end - line_start );
+        const std::string_view keyword = next_token( line );
+        line_start = line_end + 1;
+
+        if ( keyword == "v" ) {
+            // x y z, optionally followed by w or by r g b and an alpha, neither of which is kept
+            f32   values[7];
+            usize value_count = 0;
+            for ( std::string_view token = next_token( line ); !token.empty(); token = next_token( line ) ) {
+                if ( value_count == std::size( values ) || !parse_number( token, values[value_count] ) ) {
+                    return std::nullopt;
+                }
+                ++value_count;
+            }
+
+            if ( value_count != 3 && value_count != 4 && value_count != 6 && value_count != 7 ) {
+                return std::nullopt;
+            }
+
+            ObjVertex vertex = {
+                .position = { values[0], values[1], values[2] },
+                .color = { 1.0f, 1.0f, 1.0f },
+            };
+            if ( value_count >= 6 ) {
+                std::memcpy( vertex.color, values + 3, sizeof( vertex.color ) );
+            }
+
+            positions.push_back( vertex );
+            remap.push_back( UNUSED );
+        } else if ( keyword == "f" ) {
+            polygon.clear();
+            for ( std::string_view token = next_token( line ); !token.empty(); token = next_token( line ) ) {
+                const std::optional<u32> position = parse_corner( token, positions.size() );
+                if ( !position ) {
+                    return std::nullopt;
+                }
+
+                if ( remap[*position] == UNUSED ) {
+                    remap[*position] = static_cast<u32>( mesh.vertices.size() / sizeof( ObjVertex ) );
+                    const auto bytes = reinterpret_cast<const u8*>( &positions[*position] );
+                    mesh.vertices.insert( mesh.vertices.end(), bytes, bytes + sizeof( ObjVertex ) );
+                }
+                polygon.push_back( remap[*position] );
+            }
+
+            if ( polygon.size() < 3 ) {
+                return std::nullopt;
+            }
+
+            for ( usize i = 2; i < polygon.size(); ++i ) {
+                mesh.indices.insert( mesh.indices.end(), { polygon[0], polygon[i - 1], polygon[i] } );
+            }
+        } else if ( keyword == "o" || keyword == "g" || keyword == "usemtl" ) {
+            close_submesh();
+        }
+    }
+
+    close_submesh();
+    mksv::update_mesh_bounds( mesh );
+    return mesh;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <mksv/assets/mesh_data.hpp>
+
+#include <optional>
+#include <string_view>
+
+// Reads a Wavefront OBJ into a MeshVertexFormat::PositionColor mesh. Colors come from the common "v x y z r g b"
+// extension and default to white, a "v x y z w" weight is ignored. Texture coordinates and normals are skipped,
+// polygons are triangulated as fans and every object, group or material switch starts a new submesh. Vertices are
+// numbered in the order faces first use them.
+//
+// Nothing if the text is malformed or a face refers to a vertex that does not exist
+auto import_obj( const std::string_view text ) -> std::optional<mksv::MeshData>;
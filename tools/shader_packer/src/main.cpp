@@ -0,0 +1,43 @@
+#include <mksv/assets/shader_archive.hpp>
+#include <mksv/common/types.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// Packs compiled shaders into a ShaderArchive, each named after its file without the extension
+//
+// usage: mksv_shader_packer <output> <shader>...
+auto main( int argc, char** argv ) -> int
+{
+    if ( argc < 2 ) {
+        std::fprintf( stderr, "usage: mksv_shader_packer <output> <shader>...\n" );
+        return 1;
+    }
+
+    mksv::ShaderArchiveWriter writer{};
+    for ( i32 i = 2; i < argc; ++i ) {
+        const std::filesystem::path path = argv[i];
+
+        std::ifstream file{ path, std::ios::binary };
+        if ( !file ) {
+            std::fprintf( stderr, "Failed to read %s\n", argv[i] );
+            return 1;
+        }
+
+        const std::vector<u8> bytecode{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+        if ( !writer.add( path.stem().string(), bytecode ) ) {
+            std::fprintf( stderr, "Duplicate shader name %s\n", path.stem().string().c_str() );
+            return 1;
+        }
+    }
+
+    if ( !writer.write( argv[1] ) ) {
+        std::fprintf( stderr, "Failed to write %s\n", argv[1] );
+        return 1;
+    }
+
+    return 0;
+}